@@ -165,6 +165,7 @@ extern "C" {
 #define OPUS_GET_EXPERT_FRAME_DURATION_REQUEST 4041
 #define OPUS_SET_PREDICTION_DISABLED_REQUEST 4042
 #define OPUS_GET_PREDICTION_DISABLED_REQUEST 4043
+#define OPUS_GET_PROFILE_REQUEST             4046
 
 /* Don't use 4045, it's already taken by OPUS_GET_GAIN_REQUEST */
 
@@ -173,8 +174,39 @@ extern "C" {
 #define __opus_check_int_ptr(ptr) ((ptr) + ((ptr) - (opus_int32*)(ptr)))
 #define __opus_check_uint_ptr(ptr) ((ptr) + ((ptr) - (opus_uint32*)(ptr)))
 #define __opus_check_val16_ptr(ptr) ((ptr) + ((ptr) - (opus_val16*)(ptr)))
+#define __opus_check_profile_ptr(ptr) ((ptr) + ((ptr) - (OpusProfile*)(ptr)))
 /** @endcond */
 
+/** @defgroup opus_profile Profiling counters
+  * Stages timed by an encoder or decoder built with ENABLE_PROFILING,
+  * used as indices into the arrays of #OpusProfile.
+  * @see OPUS_GET_PROFILE
+  * @{
+  */
+#define OPUS_PROFILE_EC_DEC            0 /**< Entropy decoder symbols (counted, not timed) */
+#define OPUS_PROFILE_EC_ENC            1 /**< Entropy encoder symbols (counted, not timed) */
+#define OPUS_PROFILE_COARSE_ENERGY     2 /**< CELT coarse energy quantization */
+#define OPUS_PROFILE_QUANT_BANDS       3 /**< CELT band shape quantization (quant_all_bands()) */
+#define OPUS_PROFILE_MDCT_FORWARD      4 /**< CELT forward MDCTs */
+#define OPUS_PROFILE_MDCT_BACKWARD     5 /**< CELT inverse MDCTs */
+#define OPUS_PROFILE_COMB_FILTER       6 /**< CELT pitch pre-filter and post-filter */
+#define OPUS_PROFILE_PREEMPHASIS       7 /**< CELT pre-emphasis */
+#define OPUS_PROFILE_DEEMPHASIS        8 /**< CELT de-emphasis */
+#define OPUS_PROFILE_SILK_DECODE_CORE  9 /**< SILK excitation and synthesis filters */
+#define OPUS_PROFILE_SILK_NSQ         10 /**< SILK noise shaping quantization */
+#define OPUS_PROFILE_SILK_PITCH       11 /**< SILK pitch analysis */
+#define OPUS_PROFILE_SILK_RESAMPLER   12 /**< SILK resampler */
+#define OPUS_PROFILE_STAGES           16 /**< Size of the #OpusProfile arrays */
+
+/** Per-stage counters of an encoder or decoder.
+  * The ticks are TSC cycles on x86 and nanoseconds elsewhere.
+  */
+typedef struct OpusProfile {
+   opus_uint64 ticks[OPUS_PROFILE_STAGES]; /**< Time spent in each stage */
+   opus_uint32 calls[OPUS_PROFILE_STAGES]; /**< Number of times each stage ran */
+} OpusProfile;
+/**@}*/
+
 /** @defgroup opus_ctlvalues Pre-defined values for CTL interface
   * @see opus_genericctls, opus_encoderctls
   * @{
@@ -649,6 +681,18 @@ extern "C" {
   * @hideinitializer */
 #define OPUS_GET_FINAL_RANGE(x) OPUS_GET_FINAL_RANGE_REQUEST, __opus_check_uint_ptr(x)
 
+/** Gets and clears the per-stage profiling counters of the codec.
+  * This is only implemented when the library is built with
+  * ENABLE_PROFILING defined, and returns #OPUS_UNIMPLEMENTED otherwise.
+  * For multistream instances the counters of all the streams are summed.
+  *
+  * @param[out] x <tt>OpusProfile *</tt>: Counters accumulated since the
+  *                                     codec was created or since the last
+  *                                     call.
+  * @see OpusProfile
+  * @hideinitializer */
+#define OPUS_GET_PROFILE(x) OPUS_GET_PROFILE_REQUEST, __opus_check_profile_ptr(x)
+
 /** Gets the pitch of the last decoded frame, if available.
   * This can be used for any post-processing algorithm requiring the use of pitch,
   * e.g. time stretching/shortening. If the last frame was not voiced, or if the
@@ -129,8 +129,13 @@ typedef struct OpusHead          OpusHead;
 typedef struct OpusTags          OpusTags;
 typedef struct OpusPictureTag    OpusPictureTag;
 typedef struct OpusServerInfo    OpusServerInfo;
+typedef struct OpusHTTPClient    OpusHTTPClient;
 typedef struct OpusFileCallbacks OpusFileCallbacks;
 typedef struct OggOpusFile       OggOpusFile;
+typedef struct OpusFileInfo      OpusFileInfo;
+typedef struct OpusWaveformBin   OpusWaveformBin;
+typedef struct OpusPacketInfo    OpusPacketInfo;
+typedef struct OpusPollFd        OpusPollFd;
 
 /*Warning attributes for libopusfile functions.*/
 # if OP_GNUC_PREREQ(3,4)
@@ -199,6 +204,10 @@ typedef struct OggOpusFile       OggOpusFile;
 #define OP_ENOSEEK       (-138)
 /**The first or last granule position of a link failed basic validity checks.*/
 #define OP_EBADTIMESTAMP (-139)
+/**A non-blocking source had no data available yet.
+   The call that returned this can be repeated once more data has arrived, and
+    will pick up where it left off.*/
+#define OP_EAGAIN        (-140)
 
 /*@}*/
 /*@}*/
@@ -654,6 +663,17 @@ void opus_picture_tag_clear(OpusPictureTag *_pic) OP_ARG_NONNULL(1);
 #define OP_HTTP_PROXY_USER_REQUEST            (6656)
 #define OP_HTTP_PROXY_PASS_REQUEST            (6720)
 #define OP_GET_SERVER_INFO_REQUEST            (6784)
+#define OP_HTTP_CACHE_SIZE_REQUEST            (6848)
+#define OP_HTTP_CACHE_BLOCK_SIZE_REQUEST      (6912)
+#define OP_HTTP_CACHE_FILE_REQUEST            (6976)
+#define OP_HTTP_MAX_CONNECTIONS_REQUEST       (7040)
+#define OP_HTTP_PARALLEL_FETCH_REQUEST        (7104)
+#define OP_HTTP_ADAPTIVE_CHUNKS_REQUEST       (7168)
+#define OP_HTTP_CHUNK_SIZE_MIN_REQUEST        (7232)
+#define OP_HTTP_CHUNK_SIZE_MAX_REQUEST        (7296)
+#define OP_HTTP_READ_AHEAD_MIN_REQUEST        (7360)
+#define OP_HTTP_NONBLOCKING_REQUEST           (7424)
+#define OP_HTTP_CLIENT_REQUEST                (7488)
 
 #define OP_URL_OPT(_request) ((_request)+(char *)0)
 
@@ -662,6 +682,9 @@ void opus_picture_tag_clear(OpusPictureTag *_pic) OP_ARG_NONNULL(1);
 #define OP_CHECK_INT(_x) ((void)((_x)==(opus_int32)0),(opus_int32)(_x))
 #define OP_CHECK_CONST_CHAR_PTR(_x) ((_x)+((_x)-(const char *)(_x)))
 #define OP_CHECK_SERVER_INFO_PTR(_x) ((_x)+((_x)-(OpusServerInfo *)(_x)))
+/*#OpusHTTPClient is opaque, so we can't use pointer arithmetic on it.*/
+#define OP_CHECK_HTTP_CLIENT_PTR(_x) \
+ ((void)((_x)==(OpusHTTPClient *)0),(OpusHTTPClient *)(_x))
 
 /**@endcond*/
 
@@ -720,6 +743,37 @@ void opus_server_info_init(OpusServerInfo *_info) OP_ARG_NONNULL(1);
    \note If you use this function, you must link against <tt>libopusurl</tt>.*/
 void opus_server_info_clear(OpusServerInfo *_info) OP_ARG_NONNULL(1);
 
+/**Creates a client context that can be shared by several http(s) streams.
+   Opening a URL normally resolves the host, opens a TCP connection, and
+    performs a TLS handshake from scratch, and closes every connection when
+    the stream is closed.
+   Streams opened with the same client via #OP_HTTP_CLIENT instead share
+    - the address each server was last reached at (re-resolved at most every
+       10 minutes, as with a single stream),
+    - the TLS context and the most recent TLS session for each server, so that
+       later handshakes can be resumed, and
+    - idle persistent connections, which a stream hands back to the client when
+       it is closed, and which the next stream to the same server picks up
+       instead of connecting again.
+   This makes starting each track of a playlist served from the same host much
+    faster.
+   A client may be used from several threads at once, though each stream
+    opened with it may still only be used by one thread at a time.
+   \return A new client context, which must be released with
+            op_http_client_release(), or <code>NULL</code> if we ran out of
+            memory or http(s) support was not compiled in.
+   \note If you use this function, you must link against <tt>libopusurl</tt>.*/
+OP_WARN_UNUSED_RESULT OpusHTTPClient *op_http_client_create(void);
+
+/**Releases a client context created by op_http_client_create().
+   Streams still using the client keep it alive until they are closed.
+   The idle connections it holds are closed once the last reference to it is
+    released.
+   \param _client The client to release.
+                  This may be <code>NULL</code>, in which case nothing is done.
+   \note If you use this function, you must link against <tt>libopusurl</tt>.*/
+void op_http_client_release(OpusHTTPClient *_client);
+
 /**Skip the certificate check when connecting via TLS/SSL (https).
    \param _b <code>opus_int32</code>: Whether or not to skip the certificate
               check.
@@ -800,6 +854,180 @@ void opus_server_info_clear(OpusServerInfo *_info) OP_ARG_NONNULL(1);
 #define OP_GET_SERVER_INFO(_info) \
  OP_URL_OPT(OP_GET_SERVER_INFO_REQUEST),OP_CHECK_SERVER_INFO_PTR(_info)
 
+/**Set the capacity of the block cache used for seekable http and https URLs.
+   Data is fetched from the server in whole blocks, which are kept until the
+    cache is full and then evicted in least-recently-used order.
+   Seeking into data that is already cached does not touch the network, and
+    runs of adjacent missing blocks are fetched with a single Range request.
+   This makes opening a file (which seeks to the end and bisects to find the
+    links) and repeatedly seeking around in it much cheaper.
+   If this option is not provided, the cache holds 1 MiB.
+   The cache is not used for non-seekable streams, or for non-http and
+    non-https URLs.
+   \param _bytes <code>opus_int32</code>: The size of the cache, in bytes.
+                 This is rounded down to a multiple of the block size.
+                 A value smaller than one block disables the cache, and a
+                  negative value causes the URL function this is passed to
+                  to fail.
+   \hideinitializer*/
+#define OP_HTTP_CACHE_SIZE(_bytes) \
+ OP_URL_OPT(OP_HTTP_CACHE_SIZE_REQUEST),OP_CHECK_INT(_bytes)
+
+/**Set the size of the blocks kept in the block cache.
+   This is the granularity with which data is fetched from the server, so
+    larger blocks mean fewer requests but more data read that will never be
+    used.
+   If this option is not provided, blocks are 32 KiB.
+   \param _bytes <code>opus_int32</code>: The size of a cache block, in bytes.
+                 This must be in the range 512...16777216 (inclusive), or
+                  the URL function this is passed to will fail.
+   \hideinitializer*/
+#define OP_HTTP_CACHE_BLOCK_SIZE(_bytes) \
+ OP_URL_OPT(OP_HTTP_CACHE_BLOCK_SIZE_REQUEST),OP_CHECK_INT(_bytes)
+
+/**Keep the contents of the block cache in a file instead of in memory.
+   This allows a much larger cache (see #OP_HTTP_CACHE_SIZE) without using
+    the corresponding amount of memory.
+   The file is created (or truncated) when the stream is opened, and is
+    left behind when the stream is closed; it is up to the application to
+    choose a suitable temporary location and remove it afterwards.
+   The contents are only meaningful to the stream that wrote them.
+   \param _path <code>const char *</code>: The path of the cache file, in
+                 UTF-8.
+                This may be <code>NULL</code> to keep the cache in memory
+                 (the default).
+                If the file cannot be created, the URL function this is
+                 passed to will fail.
+   \hideinitializer*/
+#define OP_HTTP_CACHE_FILE(_path) \
+ OP_URL_OPT(OP_HTTP_CACHE_FILE_REQUEST),OP_CHECK_CONST_CHAR_PTR(_path)
+
+/**Set the maximum number of simultaneous connections to the server.
+   Without #OP_HTTP_PARALLEL_FETCH, only one connection is read from at a
+    time, and the rest are kept around to make seeking faster.
+   If this option is not provided, up to 4 connections are used.
+   \param _n <code>opus_int32</code>: The maximum number of connections.
+             This must be in the range 1...16 (inclusive), or the URL function
+              this is passed to will fail.
+   \hideinitializer*/
+#define OP_HTTP_MAX_CONNECTIONS(_n) \
+ OP_URL_OPT(OP_HTTP_MAX_CONNECTIONS_REQUEST),OP_CHECK_INT(_n)
+
+/**Fetch data over several connections at once.
+   When enabled, the end of the file is requested on a second connection as
+    soon as the stream is opened, so that it arrives while the headers are
+    being read, and once reading becomes sequential, the blocks ahead of the
+    read position are requested in parallel over the remaining connections.
+   On links with a high bandwidth-delay product, this can be much faster than
+    a single connection.
+   This only has an effect for seekable streams with the block cache enabled
+    (see #OP_HTTP_CACHE_SIZE) and more than one connection allowed (see
+    #OP_HTTP_MAX_CONNECTIONS).
+   \param _b <code>opus_int32</code>: Whether or not to fetch in parallel.
+             Parallel fetching is enabled if \a _b is non-zero, and disabled
+              (the default) if \a _b is zero.
+   \hideinitializer*/
+#define OP_HTTP_PARALLEL_FETCH(_b) \
+ OP_URL_OPT(OP_HTTP_PARALLEL_FETCH_REQUEST),OP_CHECK_INT(_b)
+
+/**Size requests from the measured bandwidth and latency of the connection.
+   After a seek, we only request a limited amount of data from the server, so
+    that the connection can be quickly reused for another seek.
+   With adaptive sizing, we ask for at least the bandwidth-delay product of
+    the path to the server (estimated from the rate at which we have been
+    receiving data and the time it takes to open a connection), so that a long,
+    fast path does not sit idle waiting for the next request.
+   The same estimates decide how far we are willing to read ahead in preference
+    to opening a new connection.
+   Adaptive sizing is enabled by default.
+   \param _b <code>opus_int32</code>: Whether or not to enable adaptive sizing.
+             If this is zero, we always start at #OP_HTTP_CHUNK_SIZE_MIN after
+              a seek.
+   \hideinitializer*/
+#define OP_HTTP_ADAPTIVE_CHUNKS(_b) \
+ OP_URL_OPT(OP_HTTP_ADAPTIVE_CHUNKS_REQUEST),OP_CHECK_INT(_b)
+
+/**Set the smallest amount of data to request from the server after a seek.
+   Each subsequent request on the same connection asks for twice as much as the
+    previous one, until the size passes #OP_HTTP_CHUNK_SIZE_MAX.
+   If this option is not provided, the minimum is 32 kB.
+   This has no effect on servers that do not support persistent connections.
+   \param _bytes <code>opus_int32</code>: The minimum request size, in bytes.
+                 This must be positive, no larger than 512 MB, and no larger
+                  than the maximum request size, or the URL function this is
+                  passed to will fail.
+   \hideinitializer*/
+#define OP_HTTP_CHUNK_SIZE_MIN(_bytes) \
+ OP_URL_OPT(OP_HTTP_CHUNK_SIZE_MIN_REQUEST),OP_CHECK_INT(_bytes)
+
+/**Set the largest amount of data to request from the server at once.
+   Once requests would grow past this size, we ask for the rest of the resource
+    instead.
+   If this option is not provided, the maximum is 1 MB.
+   \param _bytes <code>opus_int32</code>: The maximum request size, in bytes.
+                 This must be positive, no larger than 512 MB, and no smaller
+                  than the minimum request size, or the URL function this is
+                  passed to will fail.
+   \hideinitializer*/
+#define OP_HTTP_CHUNK_SIZE_MAX(_bytes) \
+ OP_URL_OPT(OP_HTTP_CHUNK_SIZE_MAX_REQUEST),OP_CHECK_INT(_bytes)
+
+/**Set the least amount of data we will read and discard to satisfy a seek in
+    preference to opening a new connection.
+   The actual threshold may be larger, depending on the measured bandwidth and
+    latency of the connection.
+   If this option is not provided, the minimum is 32 kB.
+   \param _bytes <code>opus_int32</code>: The minimum read-ahead distance, in
+                  bytes.
+                 This must be non-negative, or the URL function this is passed
+                  to will fail.
+   \hideinitializer*/
+#define OP_HTTP_READ_AHEAD_MIN(_bytes) \
+ OP_URL_OPT(OP_HTTP_READ_AHEAD_MIN_REQUEST),OP_CHECK_INT(_bytes)
+
+/**Return #OP_EAGAIN instead of waiting for data that has not arrived yet.
+   When a read needs a block that is not in the cache, we start fetching it on
+    one of the parallel connections and return immediately, so that an
+    application driving its own event loop can poll the stream again later.
+   Opening the stream, seeking, and decoding all pass #OP_EAGAIN through to
+    the application, and can be retried (see op_test_open()).
+   Before retrying, call op_poll_fds() to get the sockets to wait on and how
+    long to wait, rather than spinning.
+   The parallel connections are opened without blocking, and their response
+    headers are read as they arrive.
+   Creating the stream still blocks while it looks up the server, connects,
+    and reads the response to the first request, as does connecting to an
+    <code>https:</code> server through a proxy, and a read that cannot be
+    started on a spare connection because none is running.
+   A prefetch that makes no progress for as long as a blocking read would
+    wait makes the read that needs it fail with #OP_EREAD.
+   This only has an effect for seekable streams with the block cache and
+    parallel fetching enabled (see #OP_HTTP_PARALLEL_FETCH), and only when
+    passed to op_open_url(), op_test_url(), or their <code>va_list</code>
+    versions, which open the stream with op_open_callbacks_nonblocking() or
+    op_test_callbacks_nonblocking().
+   op_url_stream_create() ignores it.
+   \param _b <code>opus_int32</code>: Whether or not to enable non-blocking
+              reads.
+             Non-blocking reads are disabled by default.
+   \hideinitializer*/
+#define OP_HTTP_NONBLOCKING(_b) \
+ OP_URL_OPT(OP_HTTP_NONBLOCKING_REQUEST),OP_CHECK_INT(_b)
+
+/**Share DNS results, TLS sessions, and idle connections with other streams
+    opened with the same client (see op_http_client_create()).
+   The stream holds its own reference to the client, so the application may
+    release it as soon as the URL function returns.
+   Connections are only shared between streams that reach the same server by
+    the same route (the same proxy, if any, and the same certificate checking
+    policy).
+   \param _client <code>OpusHTTPClient *</code>: The client to use.
+                  This may be <code>NULL</code> to use a private connection set,
+                   which is the default.
+   \hideinitializer*/
+#define OP_HTTP_CLIENT(_client) \
+ OP_URL_OPT(OP_HTTP_CLIENT_REQUEST),OP_CHECK_HTTP_CLIENT_PTR(_client)
+
 /*@}*/
 /*@}*/
 
@@ -821,8 +1049,31 @@ void opus_server_info_clear(OpusServerInfo *_info) OP_ARG_NONNULL(1);
    \param      _nbytes The maximum number of bytes to read.
                        This function may return fewer, though it will not
                         return zero unless it reaches end-of-file.
+                       If the stream cannot seek, this never extends past
+                        the end of the Ogg page being read, so a function
+                        that waits to fill the whole buffer does not hold up
+                        decoding of a live stream.
    \return The number of bytes successfully read, or a negative value on
-            error.*/
+            error.
+   \retval #OP_EAGAIN No data is available yet, but the stream has not ended.
+                      This is only allowed for a stream opened with
+                       op_open_callbacks_nonblocking() or
+                       op_test_callbacks_nonblocking().
+                      Any other stream that returns it is treated as having
+                       failed with a read error.
+                      The function that was reading is interrupted and
+                       returns #OP_EAGAIN to the application, which can call
+                       it again later to resume.
+                      A stream that returns this must guarantee progress:
+                       once whatever its
+                       <code><a href="#op_poll_func">poll()</a></code>
+                       function reports becomes ready (or, without one,
+                       after some finite number of retries), a read at the
+                       same position must return at least one byte,
+                       end-of-file, or an error.
+                      A seekable stream is asked to read the same bytes at
+                       most once while an interrupted open or seek is
+                       retried, so it does not need to keep them.*/
 typedef int (*op_read_func)(void *_stream,unsigned char *_ptr,int _nbytes);
 
 /**Sets the position indicator for \a _stream.
@@ -846,6 +1097,44 @@ typedef opus_int64 (*op_tell_func)(void *_stream);
                <code>errno</code> need not be set.*/
 typedef int (*op_close_func)(void *_stream);
 
+/**\name Events for #OpusPollFd*/
+/*@{*/
+
+/**Wait until the descriptor is readable.*/
+#define OP_POLLIN  (1)
+/**Wait until the descriptor is writable.*/
+#define OP_POLLOUT (2)
+
+/*@}*/
+
+/**A file descriptor (or socket) a non-blocking stream is waiting on.*/
+struct OpusPollFd{
+  /**The file descriptor, or on Windows, the <code>SOCKET</code>.*/
+  opus_int64 fd;
+  /**What to wait for: #OP_POLLIN, #OP_POLLOUT, or both.*/
+  int        events;
+};
+
+/**Reports what \a _stream is waiting on after #op_read_func returned
+    #OP_EAGAIN, so that the application can sleep in <code>poll()</code>,
+    <code>select()</code>, or its own event loop instead of retrying blindly.
+   The application should retry when any of the descriptors is ready, or when
+    the timeout expires, whichever comes first.
+   This must not block or read any data.
+   \param      _stream     The stream to query.
+   \param[out] _fds        Where to store the descriptors.
+   \param      _nfds       The number of entries available in \a _fds.
+   \param[out] _timeout_ms The longest the application should wait before
+                            retrying even if no descriptor is ready, in
+                            milliseconds, or -1 for no limit.
+                           If no descriptors are returned, this is 0 when
+                            a retry can make progress right away.
+   \return The number of descriptors the stream is waiting on, which may be
+            larger than \a _nfds (in which case only the first \a _nfds are
+            stored), or a negative value on error.*/
+typedef int (*op_poll_func)(void *_stream,OpusPollFd *_fds,int _nfds,
+ opus_int32 *_timeout_ms);
+
 /**The callbacks used to access non-<code>FILE</code> stream resources.
    The function prototypes are basically the same as for the stdio functions
     <code>fread()</code>, <code>fseek()</code>, <code>ftell()</code>, and
@@ -1182,6 +1471,12 @@ OP_WARN_UNUSED_RESULT OggOpusFile *op_open_url(const char *_url,
                            <dt>#OP_EBADTIMESTAMP</dt>
                            <dd>The first or last timestamp in a link failed
                             basic validity checks.</dd>
+                           <dt>#OP_EAGAIN</dt>
+                           <dd><code><a href="#op_read_func">read()</a></code>
+                            had no data available yet.
+                           In this case the \c OggOpusFile is returned anyway,
+                            but it is not open: call op_test_open() to resume
+                            opening it, or op_free() to give up.</dd>
                          </dl>
    \return A freshly opened \c OggOpusFile, or <code>NULL</code> on error.
            <tt>libopusfile</tt> does <em>not</em> take ownership of the source
@@ -1192,6 +1487,41 @@ OP_WARN_UNUSED_RESULT OggOpusFile *op_open_callbacks(void *_source,
  const OpusFileCallbacks *_cb,const unsigned char *_initial_data,
  size_t _initial_bytes,int *_error) OP_ARG_NONNULL(2);
 
+/**Open a stream whose
+    <code><a href="#op_read_func">read()</a></code> callback may return
+    #OP_EAGAIN.
+   This behaves like op_open_callbacks(), except that #OP_EAGAIN from the
+    source is passed through to the application instead of being treated as
+    a read error, and opening, seeking, and decoding can all be resumed by
+    calling the same function again.
+   While the stream is being opened or seeked, what has been read from it is
+    kept, so that a seekable source is never asked for the same bytes twice,
+    and an unseekable one does not have to buffer them itself.
+   \see op_open_callbacks
+   \param _source        The stream to read from.
+   \param _cb            The callbacks with which to access the stream.
+   \param _poll          Used to find out what the stream is waiting on (see
+                          op_poll_fds()).
+                         This may be <code>NULL</code> if the stream has
+                          nothing the application can wait on.
+   \param _initial_data  An initial buffer of data from the start of the
+                          stream.
+   \param _initial_bytes The number of bytes in \a _initial_data.
+   \param[out] _error    Returns 0 on success, or a failure code on error.
+                         You may pass in <code>NULL</code> if you don't want
+                          the failure code.
+                         See op_open_callbacks() for a full list of failure
+                          codes.
+   \return A freshly opened \c OggOpusFile, or <code>NULL</code> on error.
+           On #OP_EAGAIN, the \c OggOpusFile is returned anyway, and
+            op_test_open() must be used to finish opening it.
+           The calling application is responsible for closing the source if
+            this call returns <code>NULL</code>.*/
+OP_WARN_UNUSED_RESULT OggOpusFile *op_open_callbacks_nonblocking(
+ void *_source,const OpusFileCallbacks *_cb,op_poll_func _poll,
+ const unsigned char *_initial_data,size_t _initial_bytes,int *_error)
+ OP_ARG_NONNULL(2);
+
 /**Partially open a stream from the given file path.
    \see op_test_callbacks
    \param      _path  The path to the file to open.
@@ -1330,6 +1660,9 @@ OP_WARN_UNUSED_RESULT OggOpusFile *op_test_url(const char *_url,
                           the failure code.
                          See op_open_callbacks() for a full list of failure
                           codes.
+                         On #OP_EAGAIN, the \c OggOpusFile is returned
+                          before it has been partially opened, and
+                          op_test_open() must be used to finish opening it.
    \return A partially opened \c OggOpusFile, or <code>NULL</code> on error.
            <tt>libopusfile</tt> does <em>not</em> take ownership of the source
             if the call fails.
@@ -1339,8 +1672,41 @@ OP_WARN_UNUSED_RESULT OggOpusFile *op_test_callbacks(void *_source,
  const OpusFileCallbacks *_cb,const unsigned char *_initial_data,
  size_t _initial_bytes,int *_error) OP_ARG_NONNULL(2);
 
+/**Partially open a stream whose
+    <code><a href="#op_read_func">read()</a></code> callback may return
+    #OP_EAGAIN.
+   This is to op_test_callbacks() what op_open_callbacks_nonblocking() is to
+    op_open_callbacks().
+   \see op_test_callbacks
+   \see op_open_callbacks_nonblocking
+   \param _source        The stream to read from.
+   \param _cb            The callbacks with which to access the stream.
+   \param _poll          Used to find out what the stream is waiting on (see
+                          op_poll_fds()).
+                         This may be <code>NULL</code> if the stream has
+                          nothing the application can wait on.
+   \param _initial_data  An initial buffer of data from the start of the
+                          stream.
+   \param _initial_bytes The number of bytes in \a _initial_data.
+   \param[out] _error    Returns 0 on success, or a failure code on error.
+                         You may pass in <code>NULL</code> if you don't want
+                          the failure code.
+                         See op_open_callbacks() for a full list of failure
+                          codes.
+   \return A partially opened \c OggOpusFile, or <code>NULL</code> on error.
+           On #OP_EAGAIN, the \c OggOpusFile is returned anyway, and
+            op_test_open() must be used to finish opening it.
+           The calling application is responsible for closing the source if
+            this call returns <code>NULL</code>.*/
+OP_WARN_UNUSED_RESULT OggOpusFile *op_test_callbacks_nonblocking(
+ void *_source,const OpusFileCallbacks *_cb,op_poll_func _poll,
+ const unsigned char *_initial_data,size_t _initial_bytes,int *_error)
+ OP_ARG_NONNULL(2);
+
 /**Finish opening a stream partially opened with op_test_callbacks() or one of
     the associated convenience functions.
+   This also resumes opening a stream that any of the open or test functions
+    returned with the failure code #OP_EAGAIN.
    If this function fails, you are still responsible for freeing the
     \c OggOpusFile with op_free().
    \param _of The \c OggOpusFile to finish opening.
@@ -1364,13 +1730,136 @@ OP_WARN_UNUSED_RESULT OggOpusFile *op_test_callbacks(void *_source,
    \retval #OP_EBADLINK      We failed to find data we had seen before after
                               seeking.
    \retval #OP_EBADTIMESTAMP The first or last timestamp in a link failed basic
-                              validity checks.*/
+                              validity checks.
+   \retval #OP_EAGAIN        The source had no data available yet.
+                             Call this function again later to continue.
+                             Until it succeeds, op_poll_fds() and op_free()
+                              are the only other functions that may be
+                              called on \a _of.*/
 int op_test_open(OggOpusFile *_of) OP_ARG_NONNULL(1);
 
+/**Find out what the source is waiting on after a call returned #OP_EAGAIN.
+   This forwards to the <code><a href="#op_poll_func">poll()</a></code>
+    function the stream was opened with (see
+    op_open_callbacks_nonblocking()), so that the application can wait for the
+    descriptors it returns (e.g., with <code>poll()</code> or
+    <code>select()</code>) before repeating the call, instead of spinning.
+   The streams opened by op_open_url() and op_test_url() with
+    #OP_HTTP_NONBLOCKING enabled implement it.
+   This may also be called on an \c OggOpusFile that is still being opened.
+   \param      _of         The \c OggOpusFile to query.
+   \param[out] _fds        Where to store the descriptors.
+   \param      _nfds       The number of entries available in \a _fds.
+   \param[out] _timeout_ms The longest to wait before repeating the call even
+                            if no descriptor is ready, in milliseconds, or -1
+                            for no limit.
+   \return The number of descriptors the source is waiting on, which may be
+            larger than \a _nfds (in which case only the first \a _nfds are
+            stored), or a negative value on error.
+   \retval #OP_EIMPL The stream was not opened with a
+                      <code><a href="#op_poll_func">poll()</a></code>
+                      function.*/
+int op_poll_fds(OggOpusFile *_of,OpusPollFd *_fds,int _nfds,
+ opus_int32 *_timeout_ms) OP_ARG_NONNULL(1) OP_ARG_NONNULL(4);
+
 /**Release all memory used by an \c OggOpusFile.
    \param _of The \c OggOpusFile to free.*/
 void op_free(OggOpusFile *_of);
 
+/**Returns the parsed structure of a seekable stream, so that it can be
+    shared with other \c OggOpusFile handles opened on the same data.
+   This holds the headers, tags, and seek information of every link, which is
+    everything opening a seekable stream has to scan the file for.
+   Passing it to op_open_callbacks_with_info() or one of the associated
+    convenience functions lets them skip that scan, and the new handle uses
+    the same copy of the information in memory instead of its own.
+   The information is immutable and reference counted, so it can be passed
+    to, used by, and released from any thread.
+   The first call converts the memory \a _of already uses for this into the
+    shared copy, so it does not allocate another copy of the links.
+   \param _of The \c OggOpusFile to get the information from.
+              This must be fully opened and seekable.
+   \return A new reference to the information, which must be released with
+            op_file_info_release(), or <code>NULL</code> if the stream was
+            only partially open, was not seekable, or an internal memory
+            allocation failed.*/
+OP_WARN_UNUSED_RESULT OpusFileInfo *op_file_info(OggOpusFile *_of)
+ OP_ARG_NONNULL(1);
+
+/**Releases a reference to information returned by op_file_info().
+   The memory is freed when the last reference from the application and
+    every \c OggOpusFile using it is gone.
+   \param _info The information to release.
+                This may be <code>NULL</code>.*/
+void op_file_info_release(OpusFileInfo *_info);
+
+/**Open a stream using the given set of callbacks, using previously parsed
+    information about its structure instead of scanning it.
+   This behaves identically to op_open_callbacks(), except that when the
+    source is seekable and its first link and size match those recorded in
+    \a _info, the links of \a _info are used as they are.
+   Only the headers of the first link are read, so opening takes the same few
+    reads as opening an unseekable stream.
+   If the source does not match (or is not seekable), \a _info is ignored and
+    the source is scanned as usual.
+   \param _source        The stream to read from (e.g., a <code>FILE *</code>).
+   \param _cb            The callbacks with which to access the stream.
+                         See op_open_callbacks() for the requirements.
+   \param _initial_data  An initial buffer of data from the start of the
+                          stream.
+   \param _initial_bytes The number of bytes in \a _initial_data.
+   \param _info          Information returned by op_file_info() for another
+                          \c OggOpusFile opened on the same data.
+                         The new \c OggOpusFile takes its own reference, so
+                          the caller may release this as soon as this function
+                          returns.
+                         This may be <code>NULL</code>, in which case this is
+                          identical to op_open_callbacks().
+   \param[out] _error    Returns 0 on success, or a failure code on error.
+                         You may pass in <code>NULL</code> if you don't want
+                          the failure code.
+                         See op_open_callbacks() for a full list of failure
+                          codes.
+   \return A freshly opened \c OggOpusFile, or <code>NULL</code> on error.
+           <tt>libopusfile</tt> does <em>not</em> take ownership of the source
+            if the call fails.*/
+OP_WARN_UNUSED_RESULT OggOpusFile *op_open_callbacks_with_info(void *_source,
+ const OpusFileCallbacks *_cb,const unsigned char *_initial_data,
+ size_t _initial_bytes,OpusFileInfo *_info,int *_error) OP_ARG_NONNULL(2);
+
+/**Open a stream from the given file path, using previously parsed
+    information about its structure.
+   \see op_open_callbacks_with_info
+   \param      _path  The path to the file to open.
+   \param      _info  Information returned by op_file_info() for another
+                       \c OggOpusFile opened on the same file.
+                      This may be <code>NULL</code>.
+   \param[out] _error Returns 0 on success, or a failure code on error.
+                      You may pass in <code>NULL</code> if you don't want the
+                       failure code.
+                      The failure code will be #OP_EFAULT if the file could not
+                       be opened, or one of the other failure codes from
+                       op_open_callbacks() otherwise.
+   \return A freshly opened \c OggOpusFile, or <code>NULL</code> on error.*/
+OP_WARN_UNUSED_RESULT OggOpusFile *op_open_file_with_info(const char *_path,
+ OpusFileInfo *_info,int *_error) OP_ARG_NONNULL(1);
+
+/**Open a stream from a memory buffer, using previously parsed information
+    about its structure.
+   \see op_open_callbacks_with_info
+   \param      _data  The memory buffer to open.
+   \param      _size  The number of bytes in the buffer.
+   \param      _info  Information returned by op_file_info() for another
+                       \c OggOpusFile opened on the same data.
+                      This may be <code>NULL</code>.
+   \param[out] _error Returns 0 on success, or a failure code on error.
+                      You may pass in <code>NULL</code> if you don't want the
+                       failure code.
+                      See op_open_callbacks() for a full list of failure codes.
+   \return A freshly opened \c OggOpusFile, or <code>NULL</code> on error.*/
+OP_WARN_UNUSED_RESULT OggOpusFile *op_open_memory_with_info(
+ const unsigned char *_data,size_t _size,OpusFileInfo *_info,int *_error);
+
 /*@}*/
 /*@}*/
 
@@ -1610,6 +2099,9 @@ ogg_int64_t op_pcm_tell(const OggOpusFile *_of) OP_ARG_NONNULL(1);
    op_pcm_seek() provides sample-accurate seeking.
    The number of physical seeks it requires is still quite small (often 1 or
     2, even in highly variable bitrate streams).
+   op_pcm_seek_approx() uses the same search as op_pcm_seek(), but skips the
+    pre-roll, which makes it the better choice when speed matters more than
+    accuracy, e.g., when scrubbing.
 
    Seeking in Opus requires decoding some pre-roll amount before playback to
     allow the internal state to converge (as if recovering from packet loss).
@@ -1619,7 +2111,13 @@ ogg_int64_t op_pcm_tell(const OggOpusFile *_of) OP_ARG_NONNULL(1);
    It also means that decoding after seeking may not return exactly the same
     values as would be obtained by decoding the stream straight through.
    However, such differences are expected to be smaller than the loss
-    introduced by Opus's lossy compression.*/
+    introduced by Opus's lossy compression.
+
+   If a non-blocking source runs out of data in the middle of a seek, the seek
+    functions return #OP_EAGAIN.
+   The seek is remembered, and the next call to one of the decoding functions
+    finishes it before returning any audio (or returns #OP_EAGAIN again).
+   The application may also simply repeat the seek.*/
 /*@{*/
 
 /**Seek to a byte offset relative to the <b>compressed</b> data.
@@ -1634,7 +2132,9 @@ ogg_int64_t op_pcm_tell(const OggOpusFile *_of) OP_ARG_NONNULL(1);
                          outside the valid range for the stream.
    \retval #OP_ENOSEEK  This stream is not seekable.
    \retval #OP_EBADLINK Failed to initialize a decoder for a stream for an
-                         unknown reason.*/
+                         unknown reason.
+   \retval #OP_EAGAIN   The source had no data available yet.
+                        The seek will be finished by the next read.*/
 int op_raw_seek(OggOpusFile *_of,opus_int64 _byte_offset) OP_ARG_NONNULL(1);
 
 /**Seek to the specified PCM offset, such that decoding will begin at exactly
@@ -1650,9 +2150,60 @@ int op_raw_seek(OggOpusFile *_of,opus_int64 _byte_offset) OP_ARG_NONNULL(1);
    \retval #OP_ENOSEEK  This stream is not seekable.
    \retval #OP_EBADLINK We failed to find data we had seen before, or the
                          bitstream structure was sufficiently malformed that
-                         seeking to the target destination was impossible.*/
+                         seeking to the target destination was impossible.
+   \retval #OP_EAGAIN   The source had no data available yet.
+                        The seek will be finished by the next read.*/
 int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset) OP_ARG_NONNULL(1);
 
+/**Approximate seek flag that lands on the start of the page containing the
+    target.
+   This is the default.*/
+#define OP_SEEK_PAGE    (0)
+/**Approximate seek flag that lands on the start of the packet containing the
+    target, instead of the page.
+   This only parses the packets of the page that was found, so it costs
+    almost nothing extra, and lands within one packet (at most 120 ms, but
+    usually 20 ms) of the target.*/
+#define OP_SEEK_PACKET  (1)
+/**Approximate seek flag that fades the decoded audio in over the first
+    80&nbsp;ms after the seek.
+   This masks the artifacts from starting the decoder without any pre-roll.*/
+#define OP_SEEK_FADE_IN (2)
+
+/**Seek close to the specified PCM offset, without decoding any pre-roll.
+   Unlike op_pcm_seek(), this does not decode and discard 80&nbsp;ms of audio
+    before the target, and does not decode up to the exact target either.
+   Instead, decoding resumes at the start of the page (or, with
+    #OP_SEEK_PACKET, the packet) containing the target, which is never after
+    it.
+   This makes it much faster for scrubbing and generating thumbnails, but the
+    first few tens of milliseconds of audio afterwards will contain artifacts
+    while the decoder state converges (as if recovering from packet loss).
+   Use #OP_SEEK_FADE_IN to mask them.
+   If the seek lands at the start of a link, then no pre-roll is needed, and
+    the output is exactly what it would be after op_pcm_seek().
+   \param _of         The \c OggOpusFile in which to seek.
+   \param _pcm_offset The PCM offset to seek to.
+                      This is in samples at 48 kHz relative to the start of the
+                       stream.
+   \param _flags      A combination of #OP_SEEK_PAGE or #OP_SEEK_PACKET, and,
+                       optionally, #OP_SEEK_FADE_IN.
+   \return The PCM offset at which decoding will resume (which
+            op_pcm_tell() will also report) on success, or a negative value
+            on error.
+   \retval #OP_EREAD    An underlying read or seek operation failed.
+   \retval #OP_EINVAL   The stream was only partially open, the target was
+                         outside the valid range for the stream, or
+                         \a _flags contained an unknown flag.
+   \retval #OP_ENOSEEK  This stream is not seekable.
+   \retval #OP_EBADLINK We failed to find data we had seen before, or the
+                         bitstream structure was sufficiently malformed that
+                         seeking to the target destination was impossible.
+   \retval #OP_EAGAIN   The source had no data available yet.
+                        The seek will be finished by the next read.*/
+ogg_int64_t op_pcm_seek_approx(OggOpusFile *_of,
+ ogg_int64_t _pcm_offset,int _flags) OP_ARG_NONNULL(1);
+
 /*@}*/
 /*@}*/
 
@@ -1694,7 +2245,13 @@ int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset) OP_ARG_NONNULL(1);
     when they reach the end of the file.
    If you are reading from an <https:> URL (particularly if seeking is not
     supported), you should make sure to check for this error and warn the user
-    appropriately.*/
+    appropriately.
+
+   With a non-blocking source, any of these functions may return #OP_EAGAIN
+    when it needs data that has not arrived yet.
+   Nothing is lost: call it again later to continue decoding from the same
+    place.
+   This applies with pipelined decoding (see op_set_pipeline()) as well.*/
 /*@{*/
 
 /**Indicates that the decoding callback should produce signed 16-bit
@@ -1802,6 +2359,65 @@ int op_set_gain_offset(OggOpusFile *_of,
    \param _enabled A non-zero value to enable dithering, or 0 to disable it.*/
 void op_set_dither_enabled(OggOpusFile *_of,int _enabled) OP_ARG_NONNULL(1);
 
+/**Sets whether or not to crossfade between links.
+   A chained stream, such as an Internet radio station that starts a new link
+    for each song, or whenever its encoder is restarted, resets the decoder
+    at the start of each link, which can produce an audible click.
+   When this is enabled and playback runs from the end of one link straight
+    into the next one with the same channel count, the first 10&nbsp;ms of
+    the new link (after its pre-skip) are crossfaded with a continuation of
+    the old link's audio, extrapolated by its decoder's packet loss
+    concealment.
+   This does not change the number of samples or their timestamps.
+   Nothing is crossfaded after a seek.
+   This is disabled by default.
+   \param _of      The \c OggOpusFile on which to enable or disable
+                    crossfading between links.
+   \param _enabled A non-zero value to enable crossfading, or 0 to disable
+                    it.*/
+void op_set_seamless_links(OggOpusFile *_of,int _enabled) OP_ARG_NONNULL(1);
+
+/**Enables or disables pipelined decoding.
+   When enabled, a background thread reads, demuxes, and decodes the stream
+    ahead of the application, and op_read(), op_read_float(),
+    op_read_stereo(), and op_read_float_stereo() only copy already decoded
+    samples out of a queue.
+   This keeps slow reads from the underlying stream off of the calling thread
+    (e.g., a real-time audio callback), as long as the queue does not run dry,
+    in which case the read blocks until more samples are decoded.
+   The values returned by the read functions, op_current_link(),
+    op_pcm_tell(), op_raw_tell(), and op_bitrate_instant() still describe the
+    samples the application has actually read.
+   Seeking discards the queue and restarts the decoder at the new position,
+    except that an op_pcm_seek() a short distance forward skips over samples
+    that are already queued, just as it decodes forward without pipelining,
+    so both produce the same samples.
+   Changes made with op_set_gain_offset() or op_set_decode_callback() only
+    apply after the samples that have already been queued.
+   For unseekable streams, the decoder waits for the application to read all
+    of the samples in one link before parsing the headers of the next one.
+   The \c OggOpusFile is still not thread-safe: all calls on it must come from
+    one thread at a time.
+   Any stream callbacks, however, will be called from the decoding thread.
+   \param _of    The \c OggOpusFile on which to enable or disable pipelined
+                  decoding.
+   \param _depth The number of samples (per channel, at 48 kHz) to decode
+                  ahead, or 0 to disable pipelined decoding.
+                 Larger values ride out longer stalls in the underlying stream.
+                 If pipelined decoding was already enabled, the queue is
+                  resized.
+                 When pipelined decoding is disabled on a seekable stream, the
+                  decoder seeks back to the current playback position.
+                 On an unseekable stream, any queued samples are lost.
+   \return 0 on success, or a negative value on error.
+   \retval #OP_EINVAL The stream was only partially open, or \a _depth was
+                       negative.
+   \retval #OP_EFAULT There was not enough memory, or the decoding thread
+                       could not be started.
+                      Pipelined decoding is disabled.*/
+OP_WARN_UNUSED_RESULT int op_set_pipeline(OggOpusFile *_of,opus_int32 _depth)
+ OP_ARG_NONNULL(1);
+
 /**Reads more samples from the stream.
    \note Although \a _buf_size must indicate the total number of values that
     can be stored in \a _pcm, the return value is the number of samples
@@ -1860,6 +2476,9 @@ void op_set_dither_enabled(OggOpusFile *_of,int _enabled) OP_ARG_NONNULL(1);
                               may have been skipped.
                              Call this function again to continue decoding
                               past the hole.
+   \retval #OP_EAGAIN        The source had no data available yet.
+                             Call this function again later to continue
+                              decoding.
    \retval #OP_EREAD         An underlying read operation failed.
                              This may signal a truncation attack from an
                               <https:> source.
@@ -1941,6 +2560,9 @@ OP_WARN_UNUSED_RESULT int op_read(OggOpusFile *_of,
                               may have been skipped.
                              Call this function again to continue decoding
                               past the hole.
+   \retval #OP_EAGAIN        The source had no data available yet.
+                             Call this function again later to continue
+                              decoding.
    \retval #OP_EREAD         An underlying read operation failed.
                              This may signal a truncation attack from an
                               <https:> source.
@@ -2002,6 +2624,9 @@ OP_WARN_UNUSED_RESULT int op_read_float(OggOpusFile *_of,
                               may have been skipped.
                              Call this function again to continue decoding
                               past the hole.
+   \retval #OP_EAGAIN        The source had no data available yet.
+                             Call this function again later to continue
+                              decoding.
    \retval #OP_EREAD         An underlying read operation failed.
                              This may signal a truncation attack from an
                               <https:> source.
@@ -2063,6 +2688,9 @@ OP_WARN_UNUSED_RESULT int op_read_stereo(OggOpusFile *_of,
                               may have been skipped.
                              Call this function again to continue decoding
                               past the hole.
+   \retval #OP_EAGAIN        The source had no data available yet.
+                             Call this function again later to continue
+                              decoding.
    \retval #OP_EREAD         An underlying read operation failed.
                              This may signal a truncation attack from an
                               <https:> source.
@@ -2088,6 +2716,194 @@ OP_WARN_UNUSED_RESULT int op_read_stereo(OggOpusFile *_of,
 OP_WARN_UNUSED_RESULT int op_read_float_stereo(OggOpusFile *_of,
  float *_pcm,int _buf_size) OP_ARG_NONNULL(1);
 
+/**Decodes an entire seekable stream as floating-point samples, using several
+    threads.
+   The stream is split into segments along its links, and each segment is
+    decoded on its own thread with its own decoder, starting at least 80 ms
+    before the segment so that the decoder state has converged by the time
+    its first sample is produced.
+   The output is the same as calling op_read_float() from the start of the
+    stream until it returns 0, except that the first few samples of each
+    segment other than the first one in each link may differ by a small
+    amount, within the codec's convergence tolerance.
+   Each link is stored in the buffer immediately after the previous one, with
+    its channels interleaved, using that link's channel count.
+   The total number of values required is therefore the sum over all links
+    \a li of <code>op_pcm_total(_of,li)*op_channel_count(_of,li)</code>.
+   Samples missing because of a hole in the data are filled with silence.
+   This reads a copy of the entire source into memory.
+   Afterwards, the position of \a _of, and any decoding in progress with
+    op_read_float() or its associated functions, are unaffected.
+   The gain settings of \a _of are used, but the decode callback, if any, is
+    not called.
+   \param      _of       The \c OggOpusFile from which to read.
+   \param[out] _pcm      A buffer in which to store the output PCM samples, as
+                          signed floats at 48&nbsp;kHz with a nominal range of
+                          <code>[-1.0,1.0]</code>.
+                         This must have room for at least \a _buf_size values.
+   \param      _buf_size The number of values that can be stored in \a _pcm.
+   \param      _nthreads The number of threads to decode with, including the
+                          calling thread.
+                         If this is zero or negative, one thread per
+                          processor is used.
+   \return The total number of samples per channel decoded from all links
+            (i.e., <code>op_pcm_total(_of,-1)</code>) on success, or a
+            negative value on failure.
+   \retval #OP_EINVAL        The stream was only partially open, or \a _pcm
+                              was too small to hold the entire stream.
+   \retval #OP_ENOSEEK       The stream is not seekable.
+   \retval #OP_EFAULT        An internal memory allocation failed, or the
+                              stream was too large to copy into memory.
+   \retval #OP_EREAD         An underlying read or seek operation failed.
+   \retval #OP_EBADPACKET    Failed to properly decode a packet.
+   \retval #OP_EBADTIMESTAMP A link ended earlier than its granule positions
+                              indicated.*/
+OP_WARN_UNUSED_RESULT ogg_int64_t op_read_all_float(OggOpusFile *_of,
+ float *_pcm,ogg_int64_t _buf_size,int _nthreads) OP_ARG_NONNULL(1);
+
+/**A summary of the decoded audio over a short span of time, as returned by
+    op_read_waveform() and op_read_all_waveform().
+   All three values are taken over every channel together, with the same
+    scale as the output of op_read_float().
+   The gain is applied, but soft clipping is not, so these may fall outside
+    the range <code>[-1.0,1.0]</code>.*/
+struct OpusWaveformBin{
+  /**The smallest sample value.*/
+  float min;
+  /**The largest sample value.*/
+  float max;
+  /**The root mean square of the sample values.*/
+  float rms;
+};
+
+/**Decodes samples and summarizes them instead of returning them, for drawing
+    waveform overviews.
+   The samples are summarized as they come out of the decoder, without being
+    converted or copied first.
+   Bins are laid out over the whole stream, starting at PCM offset 0.
+   With <code>len=48000/_bins_per_sec</code>, bin \a i covers the samples
+    with PCM offsets in <code>[i*len,(i+1)*len)</code>, rounding the bounds
+    up to whole samples when \a len is not an integer.
+   The first bin stored in \a _bins is the one containing the current
+    position.
+   It only covers the samples from the current position on, so it is partial
+    if the position is not on a bin boundary, e.g., after a seek.
+   This decodes until it has filled \a _nbins bins or reaches the end of the
+    stream, and leaves the current position at the end of the last bin, so
+    that calling it again continues with the next bin.
+   At the end of the stream, the last bin is partial, and later calls return
+    0.
+   Bins span link boundaries in chained streams.
+   \param      _of           The \c OggOpusFile from which to read.
+   \param[out] _bins         A buffer in which to store the summaries.
+   \param      _nbins        The number of bins that can be stored in
+                              \a _bins.
+   \param      _bins_per_sec The number of bins per second of audio.
+                             This must be between 1 and 48000, inclusive.
+   \return The number of bins stored on success, or a negative value on
+            failure.
+           If an error occurs after some bins have been completed, those are
+            returned instead, and the error is reported by the next call (if
+            it persists).
+           A hole in the data is skipped, and the samples after it are
+            summarized as if they followed on directly.
+           The possible failure codes are the same as those of op_read_float(),
+            as well as the following.
+   \retval #OP_EINVAL The stream was only partially open, or
+                       \a _bins_per_sec was out of range.*/
+OP_WARN_UNUSED_RESULT int op_read_waveform(OggOpusFile *_of,
+ OpusWaveformBin *_bins,int _nbins,opus_int32 _bins_per_sec)
+ OP_ARG_NONNULL(1);
+
+/**Summarizes an entire seekable stream for drawing waveform overviews, using
+    several threads.
+   This splits the stream into segments on bin boundaries and summarizes each
+    one with op_read_waveform() on its own thread, in the same way as
+    op_read_all_float().
+   Bin \a i covers the samples whose PCM offset \a t from the start of the
+    stream satisfies <code>t*_bins_per_sec/48000==i</code>, so the number of
+    bins is <code>(op_pcm_total(_of,-1)*_bins_per_sec+47999)/48000</code>.
+   The last bin may be partial.
+   This reads a copy of the entire source into memory.
+   Afterwards, the position of \a _of, and any decoding in progress, are
+    unaffected.
+   \param      _of           The \c OggOpusFile from which to read.
+   \param[out] _bins         A buffer in which to store the summaries.
+   \param      _nbins        The number of bins that can be stored in
+                              \a _bins.
+   \param      _bins_per_sec The number of bins per second of audio.
+                             This must be between 1 and 48000, inclusive.
+   \param      _nthreads     The number of threads to decode with, including
+                              the calling thread.
+                             If this is zero or negative, one thread per
+                              processor is used.
+   \return The number of bins stored on success, or a negative value on
+            failure.
+   \retval #OP_EINVAL        The stream was only partially open,
+                              \a _bins_per_sec was out of range, or \a _bins
+                              was too small to hold the summary of the
+                              entire stream.
+   \retval #OP_ENOSEEK       The stream is not seekable.
+   \retval #OP_EFAULT        An internal memory allocation failed, or the
+                              stream was too large to copy into memory.
+   \retval #OP_EREAD         An underlying read or seek operation failed.
+   \retval #OP_EBADPACKET    Failed to properly decode a packet.
+   \retval #OP_EBADTIMESTAMP The stream ended earlier than its granule
+                              positions indicated.*/
+OP_WARN_UNUSED_RESULT ogg_int64_t op_read_all_waveform(OggOpusFile *_of,
+ OpusWaveformBin *_bins,ogg_int64_t _nbins,opus_int32 _bins_per_sec,
+ int _nthreads) OP_ARG_NONNULL(1);
+
+/**Timing information for a packet returned by op_read_packet().*/
+struct OpusPacketInfo{
+  /**The PCM offset of the first sample of this packet that would be output
+      after trimming, as op_pcm_tell() would report it before decoding the
+      packet.*/
+  ogg_int64_t pcm_offset;
+  /**The number of samples (per channel) at 48&nbsp;kHz the packet decodes
+      to, before any trimming.*/
+  int         duration;
+  /**The number of samples at the start of the decoded packet that are not
+      output, because of the pre-skip or the pre-roll after a seek.*/
+  int         discard_start;
+  /**The number of samples at the end of the decoded packet that are not
+      output, because of end trimming on the last packet of a link.*/
+  int         discard_end;
+  /**The index of the link the packet belongs to.
+     See op_read() for how this is numbered in unseekable streams.*/
+  int         li;
+};
+
+/**Reads the next Opus packet from the stream without decoding it, for
+    remuxing or forwarding the stream.
+   This returns the same packets, in the same order, that op_read() and its
+    associated functions would decode, along with the timing needed to output
+    them correctly, but no decoder is created or run for them.
+   The granule position in \a _op is that of the end of the packet, computed
+    for every packet, not only the last one on a page.
+   Use op_head() and op_tags() with \a _info->li to get the headers of the
+    link the packet belongs to.
+   Any samples from a packet that was decoded by op_read() or its associated
+    functions and not yet returned are discarded.
+   Because the skipped packets are not decoded, the next samples decoded
+    after calling this function will not be continuous with what came before,
+    until the next seek.
+   \param      _of   The \c OggOpusFile from which to read.
+   \param[out] _op   Returns the packet.
+                     Its data is owned by \a _of, and remains valid only
+                      until the next call to a function that reads from or
+                      seeks in \a _of.
+   \param[out] _info Returns the timing of the packet.
+                     This may be <code>NULL</code>.
+   \return 1 if a packet was returned, 0 at the end of the stream, or a
+            negative value on failure.
+           The failure codes are the same as those of op_read(), except that
+            #OP_EBADPACKET is never returned, as well as the following.
+   \retval #OP_EINVAL The stream was only partially open, or pipelined
+                       decoding is enabled (see op_set_pipeline()).*/
+OP_WARN_UNUSED_RESULT int op_read_packet(OggOpusFile *_of,
+ ogg_packet *_op,OpusPacketInfo *_info) OP_ARG_NONNULL(1) OP_ARG_NONNULL(2);
+
 /*@}*/
 /*@}*/
 
@@ -30,6 +30,7 @@
  */
 
 #include "opusfile.h"
+#include "opuswriter.h"
 #include "internal.h"
 
 namespace Opusfile {
@@ -230,6 +231,76 @@ namespace Opusfile {
 		};
 
 
+		[Platform::Metadata::Flags]
+		public enum class SeekFlags : unsigned int {
+			Page = OP_SEEK_PAGE,
+			Packet = OP_SEEK_PACKET,
+			FadeIn = OP_SEEK_FADE_IN
+		};
+
+
+		public value struct OpusWaveformBin {
+			float Min;
+			float Max;
+			float Rms;
+		};
+
+
+		public ref class OpusFileInfo sealed {
+		public:
+			virtual ~OpusFileInfo() { ::op_file_info_release(src_); }
+
+		internal:
+			OpusFileInfo(::OpusFileInfo *src) : src_(src) { }
+
+			::OpusFileInfo *Get() { return src_; }
+
+		private:
+			::OpusFileInfo *src_;
+		};
+
+
+		public ref class OpusPacket sealed {
+		public:
+			property Windows::Storage::Streams::IBuffer^ Data {
+				Windows::Storage::Streams::IBuffer^ get() { return data_; }
+			}
+
+			property ogg_int64_t GranulePosition {
+				ogg_int64_t get() { return granulepos_; }
+			}
+
+			property ogg_int64_t PcmOffset {
+				ogg_int64_t get() { return info_.pcm_offset; }
+			}
+
+			property int Duration {
+				int get() { return info_.duration; }
+			}
+
+			property int DiscardStart {
+				int get() { return info_.discard_start; }
+			}
+
+			property int DiscardEnd {
+				int get() { return info_.discard_end; }
+			}
+
+			property int Link {
+				int get() { return info_.li; }
+			}
+
+		internal:
+			OpusPacket(Windows::Storage::Streams::IBuffer^ data, ogg_int64_t granulepos, const ::OpusPacketInfo &info)
+				: data_(data), granulepos_(granulepos), info_(info) { }
+
+		private:
+			Windows::Storage::Streams::IBuffer^ data_;
+			ogg_int64_t granulepos_;
+			::OpusPacketInfo info_;
+		};
+
+
 		public ref class OggOpusFile sealed {
 		public:
 			OggOpusFile();
@@ -242,6 +313,7 @@ namespace Opusfile {
 
 			void Open(Windows::Storage::Streams::IRandomAccessStream^ fileStream);
 			void Open(Windows::Storage::Streams::IRandomAccessStream^ fileStream, Windows::Storage::Streams::IBuffer^ initial);
+			void OpenWithInfo(Windows::Storage::Streams::IRandomAccessStream^ fileStream, OpusFileInfo^ info);
 			void Free();
 
 			bool Seekable();
@@ -258,6 +330,7 @@ namespace Opusfile {
 			OpusHead^ Head(int li);
 			OpusTags^ Tags();
 			OpusTags^ Tags(int li);
+			OpusFileInfo^ FileInfo();
 			int CurrentLink();
 			opus_int32 Bitrate();
 			opus_int32 Bitrate(int li);
@@ -267,13 +340,20 @@ namespace Opusfile {
 
 			void SetGainOffset(GainType gainType, opus_int32 gainOffsetQ8);
 			void SetDitherEnabled(bool enabled);
+			void SetSeamlessLinks(bool enabled);
+			void SetPipeline(opus_int32 depth);
 			Windows::Storage::Streams::IBuffer^ Read(int bufSize);
 			[Windows::Foundation::Metadata::DefaultOverloadAttribute]
 			Windows::Storage::Streams::IBuffer^ Read(int bufSize, int *li);
 			Windows::Storage::Streams::IBuffer^ ReadStereo(int bufSize);
+			Windows::Storage::Streams::IBuffer^ ReadAllFloat(int threads);
+			Platform::Array<OpusWaveformBin>^ ReadWaveform(int bins, opus_int32 binsPerSec);
+			Platform::Array<OpusWaveformBin>^ ReadAllWaveform(opus_int32 binsPerSec, int threads);
+			OpusPacket^ ReadPacket();
 
 			void RawSeek(opus_int64 byteOffset);
 			void PcmSeek(ogg_int64_t pcmOffset);
+			ogg_int64_t PcmSeekApprox(ogg_int64_t pcmOffset, SeekFlags flags);
 
 		internal:
 			static int read_func(void *stream, unsigned char *ptr, int nbytes);
@@ -282,11 +362,61 @@ namespace Opusfile {
 			static int close_func(void *stream);
 
 		private:
+			void Open(Windows::Storage::Streams::IRandomAccessStream^ fileStream, Windows::Storage::Streams::IBuffer^ initial, ::OpusFileInfo *info);
+
 			::OggOpusFile *of_;
 			Windows::Storage::Streams::IRandomAccessStream^ file_stream_;
 			Windows::Storage::Streams::DataReader^ file_reader_;
 		};
 
+
+		public enum struct OpusApplication {
+			Voip = OPUS_APPLICATION_VOIP,
+			Audio = OPUS_APPLICATION_AUDIO,
+			RestrictedLowDelay = OPUS_APPLICATION_RESTRICTED_LOWDELAY
+		};
+
+
+		public ref class OggOpusWriter sealed {
+		public:
+			OggOpusWriter();
+			virtual ~OggOpusWriter();
+
+			/* Call after open to check that the object was created
+			 * successfully.  If not, use Open() to try again.
+			 */
+			property bool IsValid { bool get(); }
+
+			void Open(Windows::Storage::Streams::IOutputStream^ outputStream, opus_int32 sampleRate, int channelCount);
+			void Open(Windows::Storage::Streams::IOutputStream^ outputStream, opus_int32 sampleRate, int channelCount, OpusApplication application);
+			void Free();
+
+			/* Bitrate and complexity can be changed at any time, the
+			 * other settings and the comments only before the first
+			 * Write() or Drain().
+			 */
+			void SetBitrate(opus_int32 bitrate);
+			void SetComplexity(int complexity);
+			void SetFrameSize(int frameSize);
+			void SetPageLatency(opus_int32 latencyMs);
+			void SetPageSize(int pageSize);
+			void AddComment(Platform::String^ tag, Platform::String^ value);
+			void Write(Windows::Storage::Streams::IBuffer^ pcm);
+			void Drain();
+
+		internal:
+			static int write_func(void *stream, const unsigned char *header, opus_int32 header_len,
+				const unsigned char *body, opus_int32 body_len);
+
+		private:
+			void Store();
+
+			::OggOpusWriter *ow_;
+			int channels_;
+			Windows::Storage::Streams::IOutputStream^ output_stream_;
+			Windows::Storage::Streams::DataWriter^ output_writer_;
+		};
+
 	}
 
 }
@@ -0,0 +1,265 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#if !defined(_opuswriter_h)
+# define _opuswriter_h (1)
+
+/**\file
+   Encoder-side counterpart of <tt>libopusfile</tt>: takes PCM, runs the
+    multistream encoder on it and muxes the packets into an Ogg Opus stream.
+
+   The ID and comment headers are written on their own pages when the first
+    audio is submitted.
+   Audio pages are granule-stamped as the Ogg Opus mapping requires: the
+    pre-skip is taken from the encoder look-ahead, and the last page is
+    end-trimmed to the exact number of input samples.
+   Pages are handed to the output straight from <tt>libogg</tt>'s stream
+    buffers.
+   A page is closed either once it holds the configured number of bytes or
+    once the oldest packet on it has waited for the configured maximum page
+    latency, whichever comes first.*/
+
+# if defined(__cplusplus)
+extern "C" {
+# endif
+
+# include <opusfile.h>
+
+# if OP_GNUC_PREREQ(4,0)
+#  pragma GCC visibility push(default)
+# endif
+
+typedef struct OpusWriterCallbacks OpusWriterCallbacks;
+typedef struct OpusWriterBuffer    OpusWriterBuffer;
+typedef struct OggOpusWriter       OggOpusWriter;
+
+/**\defgroup writer Writing Ogg Opus streams*/
+/*@{*/
+
+/**The largest page <tt>libogg</tt> can produce, in bytes.
+   A caller-supplied buffer (see opw_create_buffer()) of at least this size can
+    always take the next page once it has been emptied.*/
+#define OPW_PAGE_SIZE_MAX (27+255+255*255)
+
+/**Writes one Ogg page to the output.
+   The header and body are passed separately so that they can go out with a
+    single gathering write, without first being copied into one block.
+   Both pointers are only valid during the call.
+   \param _stream     The stream the writer was created with.
+   \param _header     The page header.
+   \param _header_len The size of the page header, in bytes.
+   \param _body       The page body.
+   \param _body_len   The size of the page body, in bytes.
+   \return 0 if the whole page was written, #OP_FALSE if the output cannot take
+            it right now (the writer keeps the page and offers it again on the
+            next call), or another negative value on a hard error.*/
+typedef int (*opw_write_func)(void *_stream,const unsigned char *_header,
+ opus_int32 _header_len,const unsigned char *_body,opus_int32 _body_len);
+
+/**Closes the output.
+   \param _stream The stream the writer was created with.
+   \return 0 on success, or a negative value on error.*/
+typedef int (*opw_close_func)(void *_stream);
+
+/**The callbacks used to deliver the pages of an Ogg Opus stream.*/
+struct OpusWriterCallbacks{
+  /**Used to write the pages.
+     This must not be <code>NULL</code>.*/
+  opw_write_func write;
+  /**Called by opw_destroy(), may be <code>NULL</code>.
+     It is never called if creating the writer fails.*/
+  opw_close_func close;
+};
+
+/**A caller-supplied block of memory pages are written into.
+   Each page is copied once, from <tt>libogg</tt>'s stream buffers to
+    <code>data+length</code>.
+   The caller consumes the output by reading the first \a length bytes and
+    resetting \a length to 0 between calls.*/
+struct OpusWriterBuffer{
+  /**The block of memory to write to.*/
+  unsigned char *data;
+  /**The size of the block of memory.*/
+  opus_int32     size;
+  /**The number of bytes written so far.*/
+  opus_int32     length;
+};
+
+/**Creates a writer that delivers its pages through the given callbacks.
+   On success, the writer takes ownership of the stream, and opw_destroy()
+    closes it with the \a close callback.
+   If this function fails, the stream is not closed, and you are still
+    responsible for it.
+   \param      _stream         The stream to pass to the callbacks.
+   \param      _cb             The callbacks to use.
+                               They are copied, the structure does not need
+                                to outlive this call.
+   \param      _rate           The input sample rate.
+                               This must be one of 8000, 12000, 16000, 24000,
+                                or 48000.
+   \param      _channels       The number of input channels (1...255).
+   \param      _mapping_family The channel mapping family of the stream: 0 for
+                                mono or stereo, 1 for the Vorbis channel
+                                orders up to 8 channels, or 255 for
+                                independent channels.
+   \param      _application    One of #OPUS_APPLICATION_VOIP,
+                                #OPUS_APPLICATION_AUDIO or
+                                #OPUS_APPLICATION_RESTRICTED_LOWDELAY.
+   \param[out] _error          Returns 0 on success, or a failure code on
+                                error.
+                               You may pass in <code>NULL</code> if you don't
+                                want the failure code.
+   \return A freshly created #OggOpusWriter, or <code>NULL</code> on error.
+   \retval #OP_EINVAL An argument was out of range.
+   \retval #OP_EFAULT An internal memory allocation failed.*/
+OP_WARN_UNUSED_RESULT OggOpusWriter *opw_create_callbacks(void *_stream,
+ const OpusWriterCallbacks *_cb,opus_int32 _rate,int _channels,
+ int _mapping_family,int _application,int *_error) OP_ARG_NONNULL(2);
+
+/**Creates a writer that copies its pages into a caller-supplied buffer.
+   When the next page does not fit in the remaining space, opw_write() and
+    opw_write_float() consume less input than they were given (or return
+    #OP_FALSE if they could not consume any), and opw_drain() returns
+    #OP_FALSE.
+   Empty the buffer and call them again to continue.
+   The buffer structure must stay valid for the life of the writer.
+   See opw_create_callbacks() for the other parameters.
+   \param _buf The buffer to write to.*/
+OP_WARN_UNUSED_RESULT OggOpusWriter *opw_create_buffer(OpusWriterBuffer *_buf,
+ opus_int32 _rate,int _channels,int _mapping_family,int _application,
+ int *_error) OP_ARG_NONNULL(1);
+
+/**Releases the writer and closes its output.
+   Anything not yet drained with opw_drain() is discarded.
+   \param _w The #OggOpusWriter to free.*/
+void opw_destroy(OggOpusWriter *_w);
+
+/**Returns the multistream encoder used by the writer, for encoder CTLs such
+    as #OPUS_SET_BITRATE or #OPUS_SET_COMPLEXITY.
+   \param _w The #OggOpusWriter to query.*/
+OpusMSEncoder *opw_get_encoder(OggOpusWriter *_w) OP_ARG_NONNULL(1);
+
+/**Adds a comment to the comment header.
+   Comments can only be added before the first call to opw_write(),
+    opw_write_float() or opw_drain().
+   \param _w     The #OggOpusWriter to add the comment to.
+   \param _tag   The tag name, e.g. "ARTIST".
+   \param _value The UTF-8 value of the tag.
+   \return 0 on success, or a failure code on error.
+   \retval #OP_EINVAL The headers have already been written.
+   \retval #OP_EFAULT An internal memory allocation failed.*/
+int opw_comment_add(OggOpusWriter *_w,const char *_tag,const char *_value)
+ OP_ARG_NONNULL(1) OP_ARG_NONNULL(2) OP_ARG_NONNULL(3);
+
+/**Sets the serial number of the logical stream.
+   By default a serial number is picked from the clock.
+   This can only be changed before the first call to opw_write(),
+    opw_write_float() or opw_drain().
+   \return 0 on success, or #OP_EINVAL if the headers have already been
+            written.*/
+int opw_set_serialno(OggOpusWriter *_w,opus_uint32 _serialno)
+ OP_ARG_NONNULL(1);
+
+/**Sets the duration of the frames given to the encoder.
+   This can only be changed before the first call to opw_write(),
+    opw_write_float() or opw_drain().
+   \param _w          The #OggOpusWriter to configure.
+   \param _frame_size The number of samples per channel in each frame, at the
+                       input sample rate.
+                      This must correspond to 2.5, 5, 10, 20 (the default),
+                       40 or 60&nbsp;ms.
+   \return 0 on success, or #OP_EINVAL if the size is not valid or the
+            headers have already been written.*/
+int opw_set_frame_size(OggOpusWriter *_w,int _frame_size) OP_ARG_NONNULL(1);
+
+/**Sets the longest time a packet may wait for its page to be completed.
+   Lower values reduce the delay between encoding audio and it reaching the
+    output, at the cost of more, smaller pages.
+   0 puts every packet on a page of its own.
+   \param _w          The #OggOpusWriter to configure.
+   \param _latency_ms The maximum page latency in milliseconds.
+                      The default is 1000.
+   \return 0 on success, or #OP_EINVAL if the value is negative.*/
+int opw_set_page_latency(OggOpusWriter *_w,opus_int32 _latency_ms)
+ OP_ARG_NONNULL(1);
+
+/**Sets the number of bytes after which a page is closed.
+   \param _w         The #OggOpusWriter to configure.
+   \param _page_size The target page body size in bytes.
+                     Pages can be larger when a single packet exceeds it.
+                     The default is 4096.
+   \return 0 on success, or #OP_EINVAL if the value is not positive.*/
+int opw_set_page_size(OggOpusWriter *_w,int _page_size) OP_ARG_NONNULL(1);
+
+/**Encodes and writes interleaved 16-bit PCM.
+   The input does not need to be a multiple of the frame size, the remainder
+    is kept until the next call.
+   \param _w          The #OggOpusWriter to write to.
+   \param _pcm        The interleaved input samples.
+   \param _frame_size The number of samples per channel in \a _pcm.
+   \return The number of samples per channel consumed, or a negative value on
+            error.
+           This is less than \a _frame_size only when the output could not
+            take another page; call again with the rest of the input once it
+            can.
+   \retval #OP_FALSE  The output could not take a page, and none of the input
+                       was consumed.
+                      Retrying before the output can take more fails again.
+   \retval #OP_EINVAL The stream has already been drained.
+   \retval #OP_EFAULT The encoder failed or an internal memory allocation
+                       failed.
+   \retval #OP_EREAD  The output reported an error.*/
+OP_WARN_UNUSED_RESULT int opw_write(OggOpusWriter *_w,const opus_int16 *_pcm,
+ int _frame_size) OP_ARG_NONNULL(1);
+
+/**Encodes and writes interleaved floating-point PCM.
+   This behaves exactly like opw_write(), with samples nominally in the range
+    -1.0...1.0.*/
+OP_WARN_UNUSED_RESULT int opw_write_float(OggOpusWriter *_w,const float *_pcm,
+ int _frame_size) OP_ARG_NONNULL(1);
+
+/**Finishes the stream.
+   Pads the last frame with silence, encodes enough additional audio to flush
+    the encoder look-ahead, marks the final page end-of-stream with a granule
+    position trimmed to the exact input length, and flushes every remaining
+    page.
+   \param _w The #OggOpusWriter to finish.
+   \return 0 once the whole stream has been written, #OP_FALSE if the output
+            could not take another page (call again once it can), or a
+            negative value on error.*/
+int opw_drain(OggOpusWriter *_w) OP_ARG_NONNULL(1);
+
+/*@}*/
+
+# if OP_GNUC_PREREQ(4,0)
+#  pragma GCC visibility pop
+# endif
+
+# if defined(__cplusplus)
+}
+# endif
+
+#endif
@@ -0,0 +1,267 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Range decoder throughput.
+
+   Encodes a long run of symbols for each of the range decoder's entry points
+   (ec_dec_icdf() on SILK tables from 4 to 32 entries, ec_dec_bit_logp(),
+   ec_dec_uint() and the CELT Laplace coder), drawn from the distributions
+   the tables describe, and then times decoding them back in packet-sized
+   chunks.  Every decoded symbol is checked against what was encoded. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "entenc.h"
+#include "entdec.h"
+#include "laplace.h"
+#include "tables.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+static double bench_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+#else
+# include <time.h>
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+#endif
+
+#define PACKET_SIZE 1275
+#define NB_RUNS     5
+
+typedef enum {
+   KIND_ICDF,
+   KIND_BIT_LOGP,
+   KIND_UINT,
+   KIND_LAPLACE
+} symbol_kind;
+
+typedef struct {
+   const char          *name;
+   symbol_kind          kind;
+   /* The table for KIND_ICDF */
+   const unsigned char *icdf;
+   /* logp for KIND_BIT_LOGP, or ft for KIND_UINT */
+   unsigned             param;
+} workload;
+
+typedef struct {
+   unsigned char *data;
+   int           *len;
+   int           *nb_symbols;
+   int           *symbols;
+   int            nb_packets;
+   int            total_symbols;
+} symbol_stream;
+
+static opus_uint32 seed = 42;
+
+static opus_uint32 bench_rand(void)
+{
+   seed = 1664525 * seed + 1013904223;
+   return seed >> 8;
+}
+
+/* Draws a symbol with the probabilities an ICDF table assigns it */
+static int draw_icdf(const unsigned char *icdf)
+{
+   unsigned r;
+   int s;
+   r = bench_rand() & 255;
+   for (s = 0; icdf[s] > r; s++);
+   return s;
+}
+
+/* Draws a value the Laplace coder was tuned for, mostly small */
+static int draw_laplace(void)
+{
+   int v;
+   for (v = 0; v < 12 && (bench_rand() & 3) == 0; v++);
+   return (bench_rand() & 1) ? -v : v;
+}
+
+static void encode_stream(symbol_stream *st, const workload *w, int nb_symbols)
+{
+   unsigned char buf[PACKET_SIZE];
+   int i;
+   st->data = NULL;
+   st->len = (int *)malloc(nb_symbols * sizeof(*st->len));
+   st->nb_symbols = (int *)malloc(nb_symbols * sizeof(*st->nb_symbols));
+   st->symbols = (int *)malloc(nb_symbols * sizeof(*st->symbols));
+   st->nb_packets = 0;
+   st->total_symbols = 0;
+   i = 0;
+   while (i < nb_symbols)
+   {
+      ec_enc enc;
+      int n;
+      ec_enc_init(&enc, buf, PACKET_SIZE);
+      /* Stop well short of the packet size, as an encoder would */
+      for (n = 0; i < nb_symbols && ec_tell(&enc) < (PACKET_SIZE - 8) * 8 && n < 1024; i++, n++)
+      {
+         int s;
+         switch (w->kind)
+         {
+         case KIND_ICDF:
+            s = draw_icdf(w->icdf);
+            ec_enc_icdf(&enc, s, w->icdf, 8);
+            break;
+         case KIND_BIT_LOGP:
+            s = (bench_rand() & ((1 << w->param) - 1)) == 0;
+            ec_enc_bit_logp(&enc, s, w->param);
+            break;
+         case KIND_UINT:
+            s = (int)(bench_rand() % w->param);
+            ec_enc_uint(&enc, s, w->param);
+            break;
+         default:
+            s = draw_laplace();
+            ec_laplace_encode(&enc, &s, 72 << 7, 127 << 6);
+            break;
+         }
+         st->symbols[st->total_symbols + n] = s;
+      }
+      ec_enc_done(&enc);
+      st->data = (unsigned char *)realloc(st->data, (size_t)(st->nb_packets + 1) * PACKET_SIZE);
+      memcpy(st->data + (size_t)st->nb_packets * PACKET_SIZE, buf, PACKET_SIZE);
+      st->len[st->nb_packets] = PACKET_SIZE;
+      st->nb_symbols[st->nb_packets] = n;
+      st->total_symbols += n;
+      st->nb_packets++;
+   }
+}
+
+/* Returns the seconds spent decoding the whole stream, or -1 on a mismatch */
+static double decode_stream(const symbol_stream *st, const workload *w)
+{
+   const int *expected;
+   double start, elapsed;
+   int p, mismatch;
+   mismatch = 0;
+   expected = st->symbols;
+   start = bench_now();
+   for (p = 0; p < st->nb_packets; p++)
+   {
+      ec_dec dec;
+      int n, i;
+      n = st->nb_symbols[p];
+      ec_dec_init(&dec, st->data + (size_t)p * PACKET_SIZE, st->len[p]);
+      switch (w->kind)
+      {
+      case KIND_ICDF:
+         for (i = 0; i < n; i++)
+            mismatch |= ec_dec_icdf(&dec, w->icdf, 8) != expected[i];
+         break;
+      case KIND_BIT_LOGP:
+         for (i = 0; i < n; i++)
+            mismatch |= ec_dec_bit_logp(&dec, w->param) != expected[i];
+         break;
+      case KIND_UINT:
+         for (i = 0; i < n; i++)
+            mismatch |= (int)ec_dec_uint(&dec, w->param) != expected[i];
+         break;
+      default:
+         for (i = 0; i < n; i++)
+            mismatch |= ec_laplace_decode(&dec, 72 << 7, 127 << 6) != expected[i];
+         break;
+      }
+      mismatch |= ec_get_error(&dec);
+      expected += n;
+   }
+   elapsed = bench_now() - start;
+   return mismatch ? -1 : elapsed;
+}
+
+int main(int argc, char **argv)
+{
+   const workload workloads[] = {
+      { "icdf 4 entries",    KIND_ICDF,     silk_type_offset_VAD_iCDF,        0 },
+      { "icdf 8 entries",    KIND_ICDF,     silk_uniform8_iCDF,               0 },
+      { "icdf 18 entries",   KIND_ICDF,     silk_pulses_per_block_iCDF[ 4 ],  0 },
+      { "icdf 32 entries",   KIND_ICDF,     silk_pitch_lag_iCDF,              0 },
+      { "bit_logp 1",        KIND_BIT_LOGP, NULL,                             1 },
+      { "bit_logp 15",       KIND_BIT_LOGP, NULL,                             15 },
+      { "uint 200",          KIND_UINT,     NULL,                             200 },
+      { "uint 70000",        KIND_UINT,     NULL,                             70000 },
+      { "laplace",           KIND_LAPLACE,  NULL,                             0 }
+   };
+   int nb_symbols = 2000000;
+   int i;
+
+   if (argc > 1)
+      nb_symbols = atoi(argv[1]);
+   if (nb_symbols < 1)
+   {
+      fprintf(stderr, "Usage: %s [<symbols per workload>]\n", argv[0]);
+      return 1;
+   }
+
+   printf("%-18s %12s %10s\n", "workload", "Msymbols/s", "ns/symbol");
+   for (i = 0; i < (int)(sizeof(workloads) / sizeof(workloads[0])); i++)
+   {
+      const workload *w = &workloads[i];
+      symbol_stream st;
+      double elapsed;
+      int run;
+      encode_stream(&st, w, nb_symbols);
+      /* Best of a few runs, to keep scheduling noise out of the figures */
+      elapsed = decode_stream(&st, w);
+      for (run = 1; run < NB_RUNS && elapsed >= 0; run++)
+      {
+         double t = decode_stream(&st, w);
+         if (t < 0 || t < elapsed)
+            elapsed = t;
+      }
+      if (elapsed < 0)
+      {
+         fprintf(stderr, "%s: decoded symbols do not match\n", w->name);
+         return 1;
+      }
+      printf("%-18s %12.1f %10.2f\n", w->name,
+            st.total_symbols / elapsed * 1e-6, elapsed * 1e9 / st.total_symbols);
+      free(st.data);
+      free(st.len);
+      free(st.nb_symbols);
+      free(st.symbols);
+   }
+   return 0;
+}
@@ -0,0 +1,658 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Codec benchmark suite.
+
+   Times opus_encode()/opus_decode() over a sweep of modes, channel counts,
+   frame sizes, bitrates and complexities, the 5.1 surround multistream
+   encoder and decoder, and op_read()/op_read_float() on Ogg Opus streams
+   muxed from the packets of a few of those configurations. Every frame is
+   timed on its own so that the report can give tail latencies as well as
+   throughput. The input is a synthetic speech-like signal, or raw 16-bit
+   48 kHz stereo PCM as used by opus_demo, and an Ogg Opus file can be added
+   to the op_read() runs.
+
+   The results are printed as JSON, one object per API and configuration,
+   with the realtime factor, the mean ns per frame (or per op_read() call)
+   and the 50th and 99th percentile per-frame latencies.
+
+   Build it with the Makefile in this directory, or opus_bench.vcxproj on
+   Windows. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opus.h"
+#include "opus_multistream.h"
+#include "opus_private.h"
+#include "opusfile.h"
+#include "cpu_support.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+static double bench_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+#else
+# include <time.h>
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+#endif
+
+#define FS           48000
+#define MAX_CHANNELS 6
+#define MAX_FRAME    2880
+#define MAX_PACKET   (1500 * 3)
+
+typedef struct {
+   const char *name;
+   int         mode;
+   int         bandwidth;
+   int         application;
+   int         bitrates[2];   /* Per channel */
+   int         min_frame;     /* In samples at 48 kHz */
+   int         max_frame;
+} mode_config;
+
+static const mode_config modes[] = {
+   { "silk",   MODE_SILK_ONLY, OPUS_BANDWIDTH_WIDEBAND, OPUS_APPLICATION_VOIP,
+     { 12000, 24000 }, 480, 2880 },
+   { "hybrid", MODE_HYBRID,    OPUS_BANDWIDTH_FULLBAND, OPUS_APPLICATION_AUDIO,
+     { 24000, 40000 }, 480, 960 },
+   { "celt",   MODE_CELT_ONLY, OPUS_BANDWIDTH_FULLBAND, OPUS_APPLICATION_AUDIO,
+     { 48000, 96000 }, 120, 960 }
+};
+
+static const int frame_sizes[] = { 120, 240, 480, 960, 1920, 2880 };
+static const int complexities[] = { 0, 5, 10 };
+
+typedef struct {
+   unsigned char *data;
+   opus_int32    *len;
+   int            nb_frames;
+   int            frame_size;
+   int            channels;
+   int            streams;
+   int            coupled_streams;
+   unsigned char  mapping[MAX_CHANNELS];
+   int            pre_skip;
+} packet_list;
+
+typedef struct {
+   double *ns;
+   int     n;
+   int     size;
+   double  total;
+   double  audio;
+} timings;
+
+typedef struct {
+   FILE *out;
+   int   nb_results;
+} report;
+
+static void timings_reset(timings *t)
+{
+   t->n = 0;
+   t->total = 0;
+   t->audio = 0;
+}
+
+static void timings_add(timings *t, double seconds, int samples)
+{
+   if (t->n == t->size)
+   {
+      t->size = t->size ? 2 * t->size : 1024;
+      t->ns = (double *)realloc(t->ns, t->size * sizeof(*t->ns));
+   }
+   t->ns[t->n++] = 1e9 * seconds;
+   t->total += seconds;
+   t->audio += (double)samples / FS;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+   double x = *(const double *)a;
+   double y = *(const double *)b;
+   return (x > y) - (x < y);
+}
+
+static double percentile(const timings *t, int p)
+{
+   int i = t->n * p / 100;
+   return t->ns[i < t->n ? i : t->n - 1];
+}
+
+/* Appends one result object. A negative bitrate, complexity or frame size
+   means "not applicable" and is written as null. */
+static void report_result(report *r, const char *api, const char *mode,
+      int channels, int frame_size, int bitrate, int complexity, timings *t)
+{
+   if (t->n == 0)
+      return;
+   qsort(t->ns, t->n, sizeof(*t->ns), cmp_double);
+   fprintf(r->out, "%s\n    {\"api\": \"%s\", \"mode\": \"%s\", \"channels\": %d, ",
+         r->nb_results ? "," : "", api, mode, channels);
+   if (frame_size > 0)
+      fprintf(r->out, "\"frame_ms\": %g, ", 1000. * frame_size / FS);
+   else
+      fprintf(r->out, "\"frame_ms\": null, ");
+   if (bitrate > 0)
+      fprintf(r->out, "\"bitrate\": %d, ", bitrate);
+   else
+      fprintf(r->out, "\"bitrate\": null, ");
+   if (complexity >= 0)
+      fprintf(r->out, "\"complexity\": %d, ", complexity);
+   else
+      fprintf(r->out, "\"complexity\": null, ");
+   fprintf(r->out, "\"frames\": %d, \"realtime\": %.1f, \"ns_per_frame\": %.0f, "
+         "\"p50_ns\": %.0f, \"p99_ns\": %.0f}", t->n, t->audio / t->total,
+         1e9 * t->total / t->n, percentile(t, 50), percentile(t, 99));
+   r->nb_results++;
+}
+
+static void gen_speech(opus_int16 *pcm, int len, int stride, unsigned int seed)
+{
+   double phase = 0;
+   double f_base = 120 + (seed % 7) * 15;
+   int i, h;
+   for (i = 0; i < len; i++)
+   {
+      double t = (double)i / FS;
+      double f0 = f_base + 70 * sin(2 * M_PI * 0.9 * t);
+      double v = 0;
+      phase += 2 * M_PI * f0 / FS;
+      seed = 1664525 * seed + 1013904223;
+      if (fmod(t, 1.1) < 0.8)
+      {
+         for (h = 1; h <= 12; h++)
+            v += sin(h * phase) / h;
+         v *= 6000 * (0.5 + 0.5 * sin(2 * M_PI * 2.3 * t));
+      }
+      else
+         v = (double)((int)(seed >> 17) - 16384) * 0.3;
+      pcm[i * stride] = (opus_int16)v;
+   }
+}
+
+/* Fills up to *len samples of MAX_CHANNELS interleaved channels, from the
+   file if there is one (repeating its two channels) and synthetic speech
+   otherwise */
+static opus_int16 *load_input(const char *path, int *len)
+{
+   opus_int16 *pcm;
+   int i, c;
+   if (path != NULL)
+   {
+      FILE *f = fopen(path, "rb");
+      unsigned char buf[4];
+      int size = 0;
+      if (f == NULL)
+         return NULL;
+      fseek(f, 0, SEEK_END);
+      if (ftell(f) / 4 < *len)
+         *len = (int)(ftell(f) / 4);
+      fseek(f, 0, SEEK_SET);
+      pcm = (opus_int16 *)malloc((size_t)*len * MAX_CHANNELS * sizeof(*pcm));
+      while (size < *len && fread(buf, 1, 4, f) == 4)
+      {
+         for (c = 0; c < MAX_CHANNELS; c++)
+            pcm[size * MAX_CHANNELS + c] = (opus_int16)(buf[(c & 1) * 2] | buf[(c & 1) * 2 + 1] << 8);
+         size++;
+      }
+      fclose(f);
+      *len = size;
+      return pcm;
+   }
+   pcm = (opus_int16 *)malloc((size_t)*len * MAX_CHANNELS * sizeof(*pcm));
+   for (c = 0; c < MAX_CHANNELS; c++)
+      gen_speech(pcm + c, *len, MAX_CHANNELS, 42 + c);
+   for (i = 0; i < *len * MAX_CHANNELS; i++)
+      pcm[i] = (opus_int16)(pcm[i] / 2);
+   return pcm;
+}
+
+/* Picks the first channels of each interleaved MAX_CHANNELS input frame */
+static void get_frame(const opus_int16 *in, opus_int16 *out, int frame, int frame_size, int channels)
+{
+   int i, c;
+   in += (size_t)frame * frame_size * MAX_CHANNELS;
+   for (i = 0; i < frame_size; i++)
+      for (c = 0; c < channels; c++)
+         out[i * channels + c] = in[i * MAX_CHANNELS + c];
+}
+
+static void packet_list_alloc(packet_list *pl, int nb_frames, int frame_size, int channels)
+{
+   pl->data = (unsigned char *)malloc((size_t)nb_frames * MAX_PACKET);
+   pl->len = (opus_int32 *)malloc(nb_frames * sizeof(*pl->len));
+   pl->nb_frames = nb_frames;
+   pl->frame_size = frame_size;
+   pl->channels = channels;
+   pl->streams = 1;
+   pl->coupled_streams = channels - 1;
+   pl->mapping[0] = 0;
+   pl->mapping[1] = 1;
+}
+
+static void packet_list_free(packet_list *pl)
+{
+   free(pl->data);
+   free(pl->len);
+}
+
+/* Encodes and decodes the whole input with one configuration, leaving the
+   packets in pl */
+static int run_single(report *r, timings *t, const opus_int16 *input, int input_len,
+      const mode_config *m, int channels, int frame_size, int bitrate, int complexity,
+      packet_list *pl)
+{
+   OpusEncoder *enc;
+   OpusDecoder *dec;
+   opus_int16 in[MAX_FRAME * 2];
+   opus_int16 out[MAX_FRAME * 2];
+   int nb_frames = input_len / frame_size;
+   int err, i;
+   double start;
+
+   enc = opus_encoder_create(FS, channels, m->application, &err);
+   if (err != OPUS_OK)
+      return err;
+   opus_encoder_ctl(enc, OPUS_SET_FORCE_MODE(m->mode));
+   opus_encoder_ctl(enc, OPUS_SET_BANDWIDTH(m->bandwidth));
+   opus_encoder_ctl(enc, OPUS_SET_BITRATE(bitrate));
+   opus_encoder_ctl(enc, OPUS_SET_COMPLEXITY(complexity));
+   opus_encoder_ctl(enc, OPUS_GET_LOOKAHEAD(&pl->pre_skip));
+   packet_list_alloc(pl, nb_frames, frame_size, channels);
+
+   timings_reset(t);
+   for (i = 0; i < nb_frames; i++)
+   {
+      get_frame(input, in, i, frame_size, channels);
+      start = bench_now();
+      pl->len[i] = opus_encode(enc, in, frame_size, pl->data + (size_t)i * MAX_PACKET, MAX_PACKET);
+      timings_add(t, bench_now() - start, frame_size);
+      if (pl->len[i] < 0)
+         return pl->len[i];
+   }
+   opus_encoder_destroy(enc);
+   report_result(r, "opus_encode", m->name, channels, frame_size, bitrate, complexity, t);
+
+   dec = opus_decoder_create(FS, channels, &err);
+   if (err != OPUS_OK)
+      return err;
+   timings_reset(t);
+   for (i = 0; i < nb_frames; i++)
+   {
+      int ret;
+      start = bench_now();
+      ret = opus_decode(dec, pl->data + (size_t)i * MAX_PACKET, pl->len[i], out, MAX_FRAME, 0);
+      timings_add(t, bench_now() - start, frame_size);
+      if (ret < 0)
+         return ret;
+   }
+   opus_decoder_destroy(dec);
+   report_result(r, "opus_decode", m->name, channels, frame_size, bitrate, complexity, t);
+   return OPUS_OK;
+}
+
+/* The same for 5.1 surround with the multistream API */
+static int run_surround(report *r, timings *t, const opus_int16 *input, int input_len,
+      int frame_size, int bitrate, int complexity, packet_list *pl)
+{
+   OpusMSEncoder *enc;
+   OpusMSDecoder *dec;
+   opus_int16 in[MAX_FRAME * MAX_CHANNELS];
+   opus_int16 out[MAX_FRAME * MAX_CHANNELS];
+   int nb_frames = input_len / frame_size;
+   int err, i;
+   double start;
+
+   packet_list_alloc(pl, nb_frames, frame_size, MAX_CHANNELS);
+   enc = opus_multistream_surround_encoder_create(FS, MAX_CHANNELS, 1, &pl->streams,
+         &pl->coupled_streams, pl->mapping, OPUS_APPLICATION_AUDIO, &err);
+   if (err != OPUS_OK)
+      return err;
+   opus_multistream_encoder_ctl(enc, OPUS_SET_BITRATE(bitrate));
+   opus_multistream_encoder_ctl(enc, OPUS_SET_COMPLEXITY(complexity));
+   opus_multistream_encoder_ctl(enc, OPUS_GET_LOOKAHEAD(&pl->pre_skip));
+
+   timings_reset(t);
+   for (i = 0; i < nb_frames; i++)
+   {
+      get_frame(input, in, i, frame_size, MAX_CHANNELS);
+      start = bench_now();
+      pl->len[i] = opus_multistream_encode(enc, in, frame_size,
+            pl->data + (size_t)i * MAX_PACKET, MAX_PACKET);
+      timings_add(t, bench_now() - start, frame_size);
+      if (pl->len[i] < 0)
+         return pl->len[i];
+   }
+   opus_multistream_encoder_destroy(enc);
+   report_result(r, "opus_multistream_encode", "surround", MAX_CHANNELS, frame_size,
+         bitrate, complexity, t);
+
+   dec = opus_multistream_decoder_create(FS, MAX_CHANNELS, pl->streams,
+         pl->coupled_streams, pl->mapping, &err);
+   if (err != OPUS_OK)
+      return err;
+   timings_reset(t);
+   for (i = 0; i < nb_frames; i++)
+   {
+      int ret;
+      start = bench_now();
+      ret = opus_multistream_decode(dec, pl->data + (size_t)i * MAX_PACKET, pl->len[i],
+            out, MAX_FRAME, 0);
+      timings_add(t, bench_now() - start, frame_size);
+      if (ret < 0)
+         return ret;
+   }
+   opus_multistream_decoder_destroy(dec);
+   report_result(r, "opus_multistream_decode", "surround", MAX_CHANNELS, frame_size,
+         bitrate, complexity, t);
+   return OPUS_OK;
+}
+
+static void write_le16(unsigned char *p, int v)
+{
+   p[0] = (unsigned char)(v & 0xFF);
+   p[1] = (unsigned char)(v >> 8 & 0xFF);
+}
+
+static void write_le32(unsigned char *p, opus_uint32 v)
+{
+   write_le16(p, (int)(v & 0xFFFF));
+   write_le16(p + 2, (int)(v >> 16));
+}
+
+static void append_page(unsigned char **buf, size_t *size, const ogg_page *og)
+{
+   *buf = (unsigned char *)realloc(*buf, *size + og->header_len + og->body_len);
+   memcpy(*buf + *size, og->header, og->header_len);
+   memcpy(*buf + *size + og->header_len, og->body, og->body_len);
+   *size += og->header_len + og->body_len;
+}
+
+/* Wraps the packets in an Ogg Opus stream held in memory */
+static unsigned char *mux_ogg(const packet_list *pl, size_t *size)
+{
+   static const char vendor[] = "opus_bench";
+   ogg_stream_state os;
+   ogg_packet op;
+   ogg_page og;
+   unsigned char head[19 + 2 + MAX_CHANNELS];
+   unsigned char tags[8 + 4 + sizeof(vendor) - 1 + 4];
+   unsigned char *buf = NULL;
+   int head_len, i;
+
+   *size = 0;
+   ogg_stream_init(&os, 1);
+   memcpy(head, "OpusHead", 8);
+   head[8] = 1;
+   head[9] = (unsigned char)pl->channels;
+   write_le16(head + 10, pl->pre_skip);
+   write_le32(head + 12, FS);
+   write_le16(head + 16, 0);
+   head[18] = pl->channels > 2;
+   head_len = 19;
+   if (head[18])
+   {
+      head[19] = (unsigned char)pl->streams;
+      head[20] = (unsigned char)pl->coupled_streams;
+      memcpy(head + 21, pl->mapping, pl->channels);
+      head_len += 2 + pl->channels;
+   }
+   memcpy(tags, "OpusTags", 8);
+   write_le32(tags + 8, sizeof(vendor) - 1);
+   memcpy(tags + 12, vendor, sizeof(vendor) - 1);
+   write_le32(tags + 12 + sizeof(vendor) - 1, 0);
+
+   memset(&op, 0, sizeof(op));
+   op.packet = head;
+   op.bytes = head_len;
+   op.b_o_s = 1;
+   ogg_stream_packetin(&os, &op);
+   while (ogg_stream_flush(&os, &og))
+      append_page(&buf, size, &og);
+   op.packet = tags;
+   op.bytes = sizeof(tags);
+   op.b_o_s = 0;
+   op.packetno = 1;
+   ogg_stream_packetin(&os, &op);
+   while (ogg_stream_flush(&os, &og))
+      append_page(&buf, size, &og);
+
+   for (i = 0; i < pl->nb_frames; i++)
+   {
+      op.packet = pl->data + (size_t)i * MAX_PACKET;
+      op.bytes = pl->len[i];
+      op.granulepos = (ogg_int64_t)(i + 1) * pl->frame_size;
+      op.packetno = 2 + i;
+      op.e_o_s = i == pl->nb_frames - 1;
+      ogg_stream_packetin(&os, &op);
+      while (ogg_stream_pageout(&os, &og))
+         append_page(&buf, size, &og);
+   }
+   while (ogg_stream_flush(&os, &og))
+      append_page(&buf, size, &og);
+   ogg_stream_clear(&os);
+   return buf;
+}
+
+/* Times every op_read() and op_read_float() call through the whole stream.
+   The file is opened again for each, so both see the same data. */
+static int run_opusfile(report *r, timings *t, const char *mode, const unsigned char *data,
+      size_t size, const char *path, int bitrate)
+{
+   static opus_int16 pcm[MAX_FRAME * 2 * MAX_CHANNELS];
+   static float pcmf[MAX_FRAME * 2 * MAX_CHANNELS];
+   int pass;
+   for (pass = 0; pass < 2; pass++)
+   {
+      OggOpusFile *of;
+      int err, channels;
+      of = path != NULL ? op_open_file(path, &err) : op_open_memory(data, size, &err);
+      if (of == NULL)
+         return err;
+      channels = op_channel_count(of, -1);
+      timings_reset(t);
+      for (;;)
+      {
+         int ret;
+         double start = bench_now();
+         if (pass == 0)
+            ret = op_read(of, pcm, sizeof(pcm) / sizeof(*pcm), NULL);
+         else
+            ret = op_read_float(of, pcmf, sizeof(pcmf) / sizeof(*pcmf), NULL);
+         if (ret == OP_HOLE)
+            continue;
+         if (ret < 0)
+         {
+            op_free(of);
+            return ret;
+         }
+         if (ret == 0)
+            break;
+         timings_add(t, bench_now() - start, ret);
+      }
+      op_free(of);
+      report_result(r, pass == 0 ? "op_read" : "op_read_float", mode, channels, -1,
+            bitrate, -1, t);
+   }
+   return OPUS_OK;
+}
+
+int main(int argc, char **argv)
+{
+   const char *pcm_path = NULL;
+   const char *opus_path = NULL;
+   const char *out_path = NULL;
+   double seconds = 10;
+   int quick = 0;
+   opus_int16 *input;
+   int input_len;
+   report r;
+   timings t;
+   int i, m, c, f, b, x, err;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (strcmp(argv[i], "-quick") == 0)
+         quick = 1;
+      else if (strcmp(argv[i], "-seconds") == 0 && i + 1 < argc)
+         seconds = atof(argv[++i]);
+      else if (strcmp(argv[i], "-pcm") == 0 && i + 1 < argc)
+         pcm_path = argv[++i];
+      else if (strcmp(argv[i], "-opus") == 0 && i + 1 < argc)
+         opus_path = argv[++i];
+      else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+         out_path = argv[++i];
+      else
+      {
+         fprintf(stderr, "Usage: %s [-quick] [-seconds <n>] [-pcm <48 kHz stereo s16le file>]"
+               " [-opus <Ogg Opus file>] [-o <json file>]\n", argv[0]);
+         return 1;
+      }
+   }
+   if (seconds <= 0)
+      seconds = 10;
+   input_len = (int)(seconds * FS);
+   input = load_input(pcm_path, &input_len);
+   if (input == NULL || input_len < MAX_FRAME)
+   {
+      fprintf(stderr, "cannot read %s\n", pcm_path);
+      return 1;
+   }
+   r.out = stdout;
+   if (out_path != NULL && (r.out = fopen(out_path, "w")) == NULL)
+   {
+      fprintf(stderr, "cannot write %s\n", out_path);
+      return 1;
+   }
+   r.nb_results = 0;
+   memset(&t, 0, sizeof(t));
+
+   fprintf(r.out, "{\n  \"version\": \"%s\",\n  \"arch\": %d,\n  \"input\": \"%s\",\n"
+         "  \"seconds\": %.2f,\n  \"results\": [", opus_get_version_string(),
+         opus_select_arch(), pcm_path != NULL ? "file" : "synthetic", (double)input_len / FS);
+
+   for (m = 0; m < (int)(sizeof(modes) / sizeof(modes[0])); m++)
+   {
+      for (c = 1; c <= 2; c++)
+      {
+         for (f = 0; f < (int)(sizeof(frame_sizes) / sizeof(frame_sizes[0])); f++)
+         {
+            int frame_size = frame_sizes[f];
+            if (frame_size < modes[m].min_frame || frame_size > modes[m].max_frame)
+               continue;
+            if (quick && frame_size != 960)
+               continue;
+            for (b = 0; b < 2; b++)
+            {
+               for (x = 0; x < (int)(sizeof(complexities) / sizeof(complexities[0])); x++)
+               {
+                  packet_list pl;
+                  int bitrate = modes[m].bitrates[b] * c;
+                  if (quick && complexities[x] != 10)
+                     continue;
+                  fprintf(stderr, "%s %d ch %g ms %d b/s complexity %d\n", modes[m].name, c,
+                        1000. * frame_size / FS, bitrate, complexities[x]);
+                  err = run_single(&r, &t, input, input_len, &modes[m], c, frame_size,
+                        bitrate, complexities[x], &pl);
+                  /* One stream per mode for opusfile, at the default settings */
+                  if (err == OPUS_OK && frame_size == 960 && b == 1 && complexities[x] == 10)
+                  {
+                     size_t size;
+                     unsigned char *ogg = mux_ogg(&pl, &size);
+                     err = run_opusfile(&r, &t, modes[m].name, ogg, size, NULL, bitrate);
+                     free(ogg);
+                  }
+                  packet_list_free(&pl);
+                  if (err != OPUS_OK)
+                  {
+                     fprintf(stderr, "%s failed: %d\n", modes[m].name, err);
+                     return 1;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   for (b = 0; b < 2; b++)
+   {
+      packet_list pl;
+      int bitrate = b ? 256000 : 128000;
+      fprintf(stderr, "surround %d b/s\n", bitrate);
+      err = run_surround(&r, &t, input, input_len, 960, bitrate, 10, &pl);
+      if (err == OPUS_OK && b == 1)
+      {
+         size_t size;
+         unsigned char *ogg = mux_ogg(&pl, &size);
+         err = run_opusfile(&r, &t, "surround", ogg, size, NULL, bitrate);
+         free(ogg);
+      }
+      packet_list_free(&pl);
+      if (err != OPUS_OK)
+      {
+         fprintf(stderr, "surround failed: %d\n", err);
+         return 1;
+      }
+   }
+
+   if (opus_path != NULL)
+   {
+      fprintf(stderr, "%s\n", opus_path);
+      err = run_opusfile(&r, &t, "file", NULL, 0, opus_path, -1);
+      if (err != OPUS_OK)
+      {
+         fprintf(stderr, "cannot decode %s: %d\n", opus_path, err);
+         return 1;
+      }
+   }
+
+   fprintf(r.out, "\n  ]\n}\n");
+   if (r.out != stdout)
+      fclose(r.out);
+   free(t.ns);
+   free(input);
+   return 0;
+}
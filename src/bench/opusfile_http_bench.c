@@ -0,0 +1,531 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+/* Startup and seek latency of opusfile over http on a slow network.
+
+   Encodes a few minutes of synthetic audio into memory and serves it from a
+   small HTTP/1.1 server on the loopback interface that supports byte ranges
+   and persistent connections and injects a fixed round-trip time and a
+   per-connection bandwidth limit. For each network profile, the stream is
+   opened with fixed and with adaptive request sizing (OP_HTTP_ADAPTIVE_CHUNKS)
+   and we measure the time from op_open_url() to the first decoded samples
+   and from op_pcm_seek() to the first decoded samples at a series of random
+   positions, along with how many requests and bytes the server saw. The
+   decoded samples are checked against the same file opened from memory.
+
+   The server sends a Server header, as opusfile only pipelines requests to
+   servers that do. The latency is only injected before each response (and
+   once more for the first response on a connection, standing in for the TCP
+   handshake), so pipelined requests are modelled, but TCP slow start is
+   not. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <winsock2.h>
+# include <ws2tcpip.h>
+# include <windows.h>
+typedef SOCKET bench_sock;
+# define bench_closesocket closesocket
+static double bench_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+static void bench_sleep(double seconds)
+{
+   if (seconds > 0)
+      Sleep((DWORD)(seconds * 1000 + 0.5));
+}
+static long bench_add(volatile long *counter, long value)
+{
+   return InterlockedExchangeAdd(counter, value);
+}
+#else
+# include <time.h>
+# include <signal.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sys/select.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+typedef int bench_sock;
+# define INVALID_SOCKET (-1)
+# define bench_closesocket close
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+static void bench_sleep(double seconds)
+{
+   struct timespec ts;
+   if (seconds <= 0)
+      return;
+   ts.tv_sec = (time_t)seconds;
+   ts.tv_nsec = (long)((seconds - ts.tv_sec) * 1e9);
+   nanosleep(&ts, NULL);
+}
+static long bench_add(volatile long *counter, long value)
+{
+   return __sync_fetch_and_add(counter, value);
+}
+#endif
+
+#define FS           48000
+#define CHANNELS     2
+#define DURATION     180
+#define NB_SEEKS     12
+#define READ_SIZE    (5760 * CHANNELS)
+#define MAX_REQUEST  4096
+
+typedef struct {
+   const char *name;
+   int         rtt_ms;
+   long        rate;
+} net_profile;
+
+/* The server state shared by all connections. */
+typedef struct {
+   const unsigned char *data;
+   long                 size;
+   int                  rtt_ms;
+   long                 rate;
+   volatile long        nb_requests;
+   volatile long        nb_bytes;
+   volatile long        nb_conns;
+} bench_server;
+
+typedef struct {
+   bench_server *server;
+   bench_sock    fd;
+} bench_conn;
+
+typedef struct {
+   unsigned char *data;
+   long           size;
+   long           capacity;
+} mem_file;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_file *f = (mem_file *)stream;
+   if (f->size + header_len + body_len > f->capacity)
+   {
+      unsigned char *data;
+      long capacity = 2 * (f->capacity + header_len + body_len);
+      data = (unsigned char *)realloc(f->data, capacity);
+      if (data == NULL)
+         return -1;
+      f->data = data;
+      f->capacity = capacity;
+   }
+   memcpy(f->data + f->size, header, header_len);
+   memcpy(f->data + f->size + header_len, body, body_len);
+   f->size += header_len + body_len;
+   return 0;
+}
+
+/* A slowly sweeping tone with some noise, so the encoder can't starve it of
+   bits. */
+static int encode_file(mem_file *f)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   long i, n, done;
+   int err;
+   n = (long)FS * DURATION;
+   pcm = (opus_int16 *)malloc(n * CHANNELS * sizeof(*pcm));
+   if (pcm == NULL)
+      return -1;
+   srand(42);
+   for (i = 0; i < n; i++)
+   {
+      double t = (double)i / FS;
+      double f0 = 200 + 100 * sin(2 * M_PI * t / 7);
+      pcm[i * CHANNELS] = (opus_int16)(6000 * sin(2 * M_PI * f0 * t) + rand() % 1000 - 500);
+      pcm[i * CHANNELS + 1] = (opus_int16)(6000 * sin(3 * M_PI * f0 * t) + rand() % 1000 - 500);
+   }
+   w = opw_create_callbacks(f, &cb, FS, CHANNELS, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+   {
+      free(pcm);
+      return -1;
+   }
+   /* Only the size of the file matters here, not its quality. */
+   opus_multistream_encoder_ctl(opw_get_encoder(w), OPUS_SET_COMPLEXITY(0));
+   for (done = 0; done < n;)
+   {
+      int ret = opw_write(w, pcm + done * CHANNELS, (int)(n - done < FS ? n - done : FS));
+      if (ret < 0)
+         break;
+      done += ret;
+   }
+   while ((err = opw_drain(w)) == OP_FALSE);
+   opw_destroy(w);
+   free(pcm);
+   return done < n || err < 0 ? -1 : 0;
+}
+
+/* Pull in whatever the client has sent so far without blocking, noting when
+   the first request in an empty buffer arrived. */
+static int conn_poll(bench_sock fd, char *buf, int *len, double *arrival, int block)
+{
+   fd_set set;
+   struct timeval tv;
+   int ret;
+   if (!block)
+   {
+      FD_ZERO(&set);
+      FD_SET(fd, &set);
+      tv.tv_sec = 0;
+      tv.tv_usec = 0;
+      if (select((int)fd + 1, &set, NULL, NULL, &tv) <= 0)
+         return 0;
+   }
+   if (*len >= MAX_REQUEST - 1)
+      return -1;
+   ret = recv(fd, buf + *len, MAX_REQUEST - 1 - *len, 0);
+   if (ret <= 0)
+      return -1;
+   if (*len == 0)
+      *arrival = bench_now();
+   *len += ret;
+   buf[*len] = '\0';
+   return ret;
+}
+
+static int conn_send(bench_sock fd, const char *buf, long len)
+{
+   while (len > 0)
+   {
+      int ret = send(fd, buf, (int)(len < 65536 ? len : 65536), 0);
+      if (ret <= 0)
+         return -1;
+      buf += ret;
+      len -= ret;
+   }
+   return 0;
+}
+
+static void serve_conn(bench_server *server, bench_sock fd)
+{
+   char req[MAX_REQUEST];
+   int len = 0;
+   double arrival = 0;
+   double delay = 2 * server->rtt_ms / 1000.0;
+   req[0] = '\0';
+   bench_add(&server->nb_conns, 1);
+   for (;;)
+   {
+      char header[256];
+      char *range, *end;
+      long start, stop, sent, slice;
+      double t0;
+      int header_len, req_len;
+      while ((end = strstr(req, "\r\n\r\n")) == NULL)
+      {
+         if (conn_poll(fd, req, &len, &arrival, 1) < 0)
+            return;
+      }
+      req_len = (int)(end + 4 - req);
+      start = 0;
+      stop = server->size - 1;
+      range = strstr(req, "Range: bytes=");
+      if (range != NULL && range < end)
+      {
+         range += strlen("Range: bytes=");
+         start = strtol(range, &range, 10);
+         if (*range == '-' && range[1] >= '0' && range[1] <= '9')
+            stop = strtol(range + 1, NULL, 10);
+         if (stop > server->size - 1)
+            stop = server->size - 1;
+         header_len = sprintf(header, "HTTP/1.1 206 Partial Content\r\n"
+               "Content-Range: bytes %ld-%ld/%ld\r\n", start, stop, server->size);
+      }
+      else
+         header_len = sprintf(header, "HTTP/1.1 200 OK\r\n");
+      header_len += sprintf(header + header_len, "Content-Length: %ld\r\n"
+            "Content-Type: audio/ogg\r\nAccept-Ranges: bytes\r\n"
+            "Server: opusfile_http_bench\r\n\r\n", stop - start + 1);
+      len -= req_len;
+      memmove(req, req + req_len, len + 1);
+      bench_add(&server->nb_requests, 1);
+      /* The request and response each take half a round trip. */
+      bench_sleep(arrival + delay - bench_now());
+      delay = server->rtt_ms / 1000.0;
+      if (conn_send(fd, header, header_len) < 0)
+         return;
+      /* Pace the body in 5 ms slices, picking up pipelined requests as they
+         come in. */
+      slice = server->rate / 200 > 1024 ? server->rate / 200 : 1024;
+      t0 = bench_now();
+      for (sent = 0; start + sent <= stop;)
+      {
+         long n = stop + 1 - start - sent < slice ? stop + 1 - start - sent : slice;
+         bench_sleep(t0 + (double)sent / server->rate - bench_now());
+         if (conn_send(fd, (const char *)server->data + start + sent, n) < 0)
+            return;
+         sent += n;
+         bench_add(&server->nb_bytes, n);
+         while (conn_poll(fd, req, &len, &arrival, 0) > 0);
+      }
+   }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI conn_thread(LPVOID arg)
+#else
+static void *conn_thread(void *arg)
+#endif
+{
+   bench_conn *conn = (bench_conn *)arg;
+   serve_conn(conn->server, conn->fd);
+   bench_closesocket(conn->fd);
+   free(conn);
+   return 0;
+}
+
+typedef struct {
+   bench_server *server;
+   bench_sock    fd;
+} bench_listener;
+
+#if defined(_WIN32)
+static DWORD WINAPI accept_thread(LPVOID arg)
+#else
+static void *accept_thread(void *arg)
+#endif
+{
+   bench_listener *listener = (bench_listener *)arg;
+   for (;;)
+   {
+      bench_conn *conn;
+      bench_sock fd = accept(listener->fd, NULL, NULL);
+      if (fd == INVALID_SOCKET)
+         break;
+      conn = (bench_conn *)malloc(sizeof(*conn));
+      conn->server = listener->server;
+      conn->fd = fd;
+      {
+#if defined(_WIN32)
+         HANDLE thread = CreateThread(NULL, 0, conn_thread, conn, 0, NULL);
+         if (thread != NULL)
+            CloseHandle(thread);
+#else
+         pthread_t thread;
+         if (pthread_create(&thread, NULL, conn_thread, conn) == 0)
+            pthread_detach(thread);
+#endif
+      }
+   }
+   return 0;
+}
+
+static int start_server(bench_listener *listener, bench_server *server)
+{
+   struct sockaddr_in addr;
+   socklen_t addr_len = sizeof(addr);
+   listener->server = server;
+   listener->fd = socket(AF_INET, SOCK_STREAM, 0);
+   if (listener->fd == INVALID_SOCKET)
+      return -1;
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   addr.sin_port = 0;
+   if (bind(listener->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0
+         || listen(listener->fd, 16) != 0
+         || getsockname(listener->fd, (struct sockaddr *)&addr, &addr_len) != 0)
+      return -1;
+   {
+#if defined(_WIN32)
+      HANDLE thread = CreateThread(NULL, 0, accept_thread, listener, 0, NULL);
+      if (thread == NULL)
+         return -1;
+      CloseHandle(thread);
+#else
+      pthread_t thread;
+      if (pthread_create(&thread, NULL, accept_thread, listener) != 0)
+         return -1;
+      pthread_detach(thread);
+#endif
+   }
+   return ntohs(addr.sin_port);
+}
+
+/* Decode the first samples at the current position of both files and check
+   that they match. */
+static int read_first(OggOpusFile *of, OggOpusFile *ref, float *pcm, float *ref_pcm)
+{
+   int n = op_read_float_stereo(of, pcm, READ_SIZE);
+   if (n <= 0 || op_read_float_stereo(ref, ref_pcm, n * CHANNELS) != n
+         || memcmp(pcm, ref_pcm, n * CHANNELS * sizeof(*pcm)) != 0)
+      return -1;
+   return n;
+}
+
+/* Open the file over http with the given policy, then seek around in it.
+   Returns -1 on failure, after printing why. */
+static int run_policy(bench_server *server, const char *url, const mem_file *f,
+      const net_profile *profile, int adaptive)
+{
+   OggOpusFile *of, *ref;
+   float pcm[READ_SIZE], ref_pcm[READ_SIZE];
+   double t0, open_time, seek_sum, seek_max;
+   ogg_int64_t total;
+   unsigned int seed;
+   int err, s;
+   server->nb_requests = server->nb_bytes = server->nb_conns = 0;
+   t0 = bench_now();
+   of = op_open_url(url, &err, OP_HTTP_ADAPTIVE_CHUNKS(adaptive), NULL);
+   ref = op_open_memory(f->data, f->size, NULL);
+   if (of == NULL || ref == NULL || read_first(of, ref, pcm, ref_pcm) < 0)
+   {
+      fprintf(stderr, "opening the stream failed (%d)\n", err);
+      return -1;
+   }
+   open_time = bench_now() - t0;
+   total = op_pcm_total(of, -1);
+   seek_sum = seek_max = 0;
+   /* The same positions for both policies. */
+   seed = 1;
+   for (s = 0; s < NB_SEEKS; s++)
+   {
+      ogg_int64_t pos;
+      double elapsed;
+      seed = seed * 1103515245 + 12345;
+      pos = (ogg_int64_t)((seed >> 8) / (double)(1 << 24) * (total - FS));
+      t0 = bench_now();
+      if (op_pcm_seek(of, pos) < 0 || op_pcm_seek(ref, pos) < 0
+            || read_first(of, ref, pcm, ref_pcm) < 0)
+      {
+         fprintf(stderr, "seeking to %ld failed\n", (long)pos);
+         return -1;
+      }
+      elapsed = bench_now() - t0;
+      seek_sum += elapsed;
+      if (elapsed > seek_max)
+         seek_max = elapsed;
+   }
+   op_free(of);
+   op_free(ref);
+   printf("%-10s %5d %8.2f %-8s %9.1f %9.1f %9.1f %8ld %8ld %9.2f\n", profile->name,
+         profile->rtt_ms, profile->rate / 1e6, adaptive ? "adaptive" : "fixed",
+         open_time * 1000, seek_sum / NB_SEEKS * 1000, seek_max * 1000,
+         server->nb_requests, server->nb_conns, server->nb_bytes / 1e6);
+   return 0;
+}
+
+int main(int argc, char **argv)
+{
+   static const net_profile default_profiles[] = {
+      { "lan",         2, 10000000 },
+      { "broadband",  40,  2000000 },
+      { "mobile",    120,   500000 }
+   };
+   const net_profile *profiles = default_profiles;
+   int nb_profiles = sizeof(default_profiles) / sizeof(default_profiles[0]);
+   net_profile custom;
+   bench_server server;
+   bench_listener listener;
+   mem_file f;
+   char url[64];
+   int port, p;
+
+   if (argc == 3)
+   {
+      custom.name = "custom";
+      custom.rtt_ms = atoi(argv[1]);
+      custom.rate = atol(argv[2]);
+      profiles = &custom;
+      nb_profiles = 1;
+   }
+   if (argc != 1 && (argc != 3 || custom.rtt_ms < 0 || custom.rate < 1000))
+   {
+      fprintf(stderr, "Usage: %s [<round trip ms> <bytes per second>]\n", argv[0]);
+      return 1;
+   }
+#if defined(_WIN32)
+   {
+      WSADATA wsa;
+      if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
+         return 1;
+   }
+#else
+   signal(SIGPIPE, SIG_IGN);
+#endif
+   memset(&f, 0, sizeof(f));
+   if (encode_file(&f) < 0)
+   {
+      fprintf(stderr, "encoding failed\n");
+      return 1;
+   }
+   memset(&server, 0, sizeof(server));
+   server.data = f.data;
+   server.size = f.size;
+   port = start_server(&listener, &server);
+   if (port < 0)
+   {
+      fprintf(stderr, "starting the server failed\n");
+      return 1;
+   }
+   sprintf(url, "http://127.0.0.1:%d/bench.opus", port);
+   printf("%ld byte file, %d s, %d seeks per run\n", f.size, DURATION, NB_SEEKS);
+   printf("%-10s %5s %8s %-8s %9s %9s %9s %8s %8s %9s\n", "profile", "rtt", "MB/s",
+         "policy", "open ms", "seek ms", "max ms", "requests", "conns", "MB read");
+   for (p = 0; p < nb_profiles; p++)
+   {
+      int adaptive;
+      server.rtt_ms = profiles[p].rtt_ms;
+      server.rate = profiles[p].rate;
+      for (adaptive = 0; adaptive < 2; adaptive++)
+      {
+         if (run_policy(&server, url, &f, &profiles[p], adaptive) < 0)
+            return 1;
+      }
+   }
+   free(f.data);
+   return 0;
+}
@@ -0,0 +1,465 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+
+
+
+/* Time to first decoded sample for a live, unseekable Ogg Opus stream.
+
+   Encodes a few seconds of synthetic audio into memory for each stream
+   profile and plays it back over a loopback TCP connection as a live source
+   would: the header pages are available right away, and each audio page only
+   once the last sample on it would have been captured, with the bytes trickled
+   out at a fixed link rate. The stream is opened with op_open_callbacks() and
+   no seek callback, and we measure the time until op_open_callbacks() returns
+   and until the first op_read_float() returns samples, along with how many
+   bytes had been read from the connection by then. The earliest the first
+   samples could be decoded is when the first audio page has arrived, which is
+   printed as the ideal.
+
+   Two read callbacks are timed: one that returns whatever a single recv()
+   gives it, like a socket, and one that blocks until the whole request is
+   filled, like fread() on a pipe. The latter is where reading ahead of the
+   page we need costs time. The decoded samples are checked against the same
+   file opened from memory. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <winsock2.h>
+# include <ws2tcpip.h>
+# include <windows.h>
+typedef SOCKET bench_sock;
+# define bench_closesocket closesocket
+static double bench_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+static void bench_sleep(double seconds)
+{
+   if (seconds > 0)
+      Sleep((DWORD)(seconds * 1000 + 0.5));
+}
+#else
+# include <time.h>
+# include <signal.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <arpa/inet.h>
+typedef int bench_sock;
+# define INVALID_SOCKET (-1)
+# define bench_closesocket close
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+static void bench_sleep(double seconds)
+{
+   struct timespec ts;
+   if (seconds <= 0)
+      return;
+   ts.tv_sec = (time_t)seconds;
+   ts.tv_nsec = (long)((seconds - ts.tv_sec) * 1e9);
+   nanosleep(&ts, NULL);
+}
+#endif
+
+#define FS           48000
+#define CHANNELS     2
+#define DURATION     4
+#define NB_RUNS      5
+#define READ_SIZE    (5760 * CHANNELS)
+#define SLICE        256
+#define MAX_PAGES    4096
+
+typedef struct {
+   const char *name;
+   opus_int32  bitrate;
+   int         page_ms;
+   long        link_rate;
+} stream_profile;
+
+typedef struct {
+   unsigned char *data;
+   long           size;
+   long           capacity;
+   /* Where each page starts and when it becomes available, in seconds. */
+   long           page_offset[MAX_PAGES + 1];
+   double         page_time[MAX_PAGES];
+   int            nb_pages;
+   /* The end of the first page with audio on it. */
+   long           first_audio_end;
+} live_file;
+
+typedef struct {
+   const live_file *f;
+   long             link_rate;
+   bench_sock       fd;
+   double           t0;
+   /* When the first audio page was completely sent. */
+   double           first_audio_time;
+} live_sender;
+
+typedef struct {
+   bench_sock fd;
+   int        fill;
+   long       nb_read;
+} live_source;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   live_file *f = (live_file *)stream;
+   if (f->size + header_len + body_len > f->capacity)
+   {
+      unsigned char *data;
+      long capacity = 2 * (f->capacity + header_len + body_len);
+      data = (unsigned char *)realloc(f->data, capacity);
+      if (data == NULL)
+         return -1;
+      f->data = data;
+      f->capacity = capacity;
+   }
+   memcpy(f->data + f->size, header, header_len);
+   memcpy(f->data + f->size + header_len, body, body_len);
+   f->size += header_len + body_len;
+   return 0;
+}
+
+/* Find the pages again and work out when a live encoder would have emitted
+   each one. */
+static int index_pages(live_file *f)
+{
+   ogg_sync_state oy;
+   ogg_page og;
+   long offset = 0;
+   char *buf;
+   ogg_sync_init(&oy);
+   buf = ogg_sync_buffer(&oy, f->size);
+   memcpy(buf, f->data, f->size);
+   ogg_sync_wrote(&oy, f->size);
+   f->nb_pages = 0;
+   f->first_audio_end = -1;
+   while (ogg_sync_pageout(&oy, &og) == 1 && f->nb_pages < MAX_PAGES)
+   {
+      ogg_int64_t gp = ogg_page_granulepos(&og);
+      f->page_offset[f->nb_pages] = offset;
+      f->page_time[f->nb_pages] = gp > 0 ? (double)gp / FS : 0;
+      offset += og.header_len + og.body_len;
+      if (gp > 0 && f->first_audio_end < 0)
+         f->first_audio_end = offset;
+      f->nb_pages++;
+   }
+   f->page_offset[f->nb_pages] = offset;
+   ogg_sync_clear(&oy);
+   return offset == f->size && f->first_audio_end > 0 ? 0 : -1;
+}
+
+/* A slowly sweeping tone with some noise, so the encoder can't starve it of
+   bits. */
+static int encode_file(live_file *f, const stream_profile *profile)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   long i, n, done;
+   int err;
+   n = (long)FS * DURATION;
+   pcm = (opus_int16 *)malloc(n * CHANNELS * sizeof(*pcm));
+   if (pcm == NULL)
+      return -1;
+   srand(42);
+   for (i = 0; i < n; i++)
+   {
+      double t = (double)i / FS;
+      double f0 = 200 + 100 * sin(2 * M_PI * t / 7);
+      pcm[i * CHANNELS] = (opus_int16)(6000 * sin(2 * M_PI * f0 * t) + rand() % 1000 - 500);
+      pcm[i * CHANNELS + 1] = (opus_int16)(6000 * sin(3 * M_PI * f0 * t) + rand() % 1000 - 500);
+   }
+   f->size = 0;
+   w = opw_create_callbacks(f, &cb, FS, CHANNELS, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+   {
+      free(pcm);
+      return -1;
+   }
+   opus_multistream_encoder_ctl(opw_get_encoder(w), OPUS_SET_BITRATE(profile->bitrate));
+   opus_multistream_encoder_ctl(opw_get_encoder(w), OPUS_SET_COMPLEXITY(0));
+   opw_set_page_latency(w, profile->page_ms);
+   for (done = 0; done < n;)
+   {
+      int ret = opw_write(w, pcm + done * CHANNELS, (int)(n - done < FS ? n - done : FS));
+      if (ret < 0)
+         break;
+      done += ret;
+   }
+   while ((err = opw_drain(w)) == OP_FALSE);
+   opw_destroy(w);
+   free(pcm);
+   return done < n || err < 0 ? -1 : index_pages(f);
+}
+
+/* Send each page once it exists, no faster than the link rate. */
+static void send_live(live_sender *s)
+{
+   const live_file *f = s->f;
+   double link_time = 0;
+   int p;
+   for (p = 0; p < f->nb_pages; p++)
+   {
+      long offset;
+      if (link_time < f->page_time[p])
+         link_time = f->page_time[p];
+      for (offset = f->page_offset[p]; offset < f->page_offset[p + 1];)
+      {
+         long n = f->page_offset[p + 1] - offset < SLICE ? f->page_offset[p + 1] - offset : SLICE;
+         bench_sleep(s->t0 + link_time - bench_now());
+         if (send(s->fd, (const char *)f->data + offset, (int)n, 0) != n)
+            return;
+         offset += n;
+         link_time += (double)n / s->link_rate;
+      }
+      if (f->page_offset[p + 1] == f->first_audio_end)
+         s->first_audio_time = bench_now() - s->t0;
+   }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI sender_thread(LPVOID arg)
+#else
+static void *sender_thread(void *arg)
+#endif
+{
+   send_live((live_sender *)arg);
+   return 0;
+}
+
+static int live_read(void *stream, unsigned char *ptr, int nbytes)
+{
+   live_source *s = (live_source *)stream;
+   int total = 0;
+   do {
+      int ret = recv(s->fd, (char *)ptr + total, nbytes - total, 0);
+      if (ret < 0 && total == 0)
+         return -1;
+      if (ret <= 0)
+         break;
+      total += ret;
+   } while (s->fill && total < nbytes);
+   s->nb_read += total;
+   return total;
+}
+
+/* Connect a socket to itself through a loopback listener. */
+static int connect_pair(bench_sock *client, bench_sock *server)
+{
+   struct sockaddr_in addr;
+   socklen_t addr_len = sizeof(addr);
+   bench_sock listener;
+   int one = 1;
+   *client = *server = INVALID_SOCKET;
+   listener = socket(AF_INET, SOCK_STREAM, 0);
+   if (listener == INVALID_SOCKET)
+      return -1;
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   addr.sin_port = 0;
+   if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == 0
+         && listen(listener, 1) == 0
+         && getsockname(listener, (struct sockaddr *)&addr, &addr_len) == 0)
+   {
+      *client = socket(AF_INET, SOCK_STREAM, 0);
+      if (*client != INVALID_SOCKET
+            && connect(*client, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+         *server = accept(listener, NULL, NULL);
+   }
+   bench_closesocket(listener);
+   if (*server == INVALID_SOCKET)
+   {
+      if (*client != INVALID_SOCKET)
+         bench_closesocket(*client);
+      return -1;
+   }
+   /* Don't let Nagle hold back the small slices. */
+   setsockopt(*server, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, sizeof(one));
+   return 0;
+}
+
+typedef struct {
+   double ideal;
+   double open;
+   double first;
+   long   nb_read;
+} run_result;
+
+/* Open the live stream once and decode its first samples.
+   Returns -1 on failure, after printing why. */
+static int run_once(const live_file *f, const stream_profile *profile, int fill,
+      run_result *r)
+{
+   static const OpusFileCallbacks cb = { live_read, NULL, NULL, NULL };
+   live_sender sender;
+   live_source source;
+   OggOpusFile *of, *ref;
+   float pcm[READ_SIZE], ref_pcm[READ_SIZE];
+   int err, n, ret = -1;
+   bench_sock server;
+#if defined(_WIN32)
+   HANDLE thread;
+#else
+   pthread_t thread;
+#endif
+   if (connect_pair(&source.fd, &server) < 0)
+   {
+      fprintf(stderr, "connecting over loopback failed\n");
+      return -1;
+   }
+   source.fill = fill;
+   source.nb_read = 0;
+   sender.f = f;
+   sender.link_rate = profile->link_rate;
+   sender.fd = server;
+   sender.first_audio_time = -1;
+   sender.t0 = bench_now();
+#if defined(_WIN32)
+   thread = CreateThread(NULL, 0, sender_thread, &sender, 0, NULL);
+   if (thread == NULL)
+#else
+   if (pthread_create(&thread, NULL, sender_thread, &sender) != 0)
+#endif
+   {
+      fprintf(stderr, "starting the sender failed\n");
+      bench_closesocket(source.fd);
+      bench_closesocket(server);
+      return -1;
+   }
+   of = op_open_callbacks(&source, &cb, NULL, 0, &err);
+   r->open = bench_now() - sender.t0;
+   n = of != NULL ? op_read_float(of, pcm, READ_SIZE, NULL) : err;
+   r->first = bench_now() - sender.t0;
+   r->nb_read = source.nb_read;
+   ref = op_open_memory(f->data, f->size, NULL);
+   if (n <= 0)
+      fprintf(stderr, "decoding the live stream failed (%d)\n", n);
+   else if (ref == NULL || op_read_float(ref, ref_pcm, n * op_channel_count(of, -1), NULL) != n
+         || memcmp(pcm, ref_pcm, n * op_channel_count(of, -1) * sizeof(*pcm)) != 0)
+      fprintf(stderr, "the live stream decoded differently\n");
+   else
+      ret = 0;
+   op_free(ref);
+   op_free(of);
+   /* Hanging up stops the sender. */
+#if defined(_WIN32)
+   shutdown(source.fd, SD_BOTH);
+   WaitForSingleObject(thread, INFINITE);
+   CloseHandle(thread);
+#else
+   shutdown(source.fd, SHUT_RDWR);
+   pthread_join(thread, NULL);
+#endif
+   bench_closesocket(source.fd);
+   bench_closesocket(server);
+   r->ideal = sender.first_audio_time;
+   return ret;
+}
+
+static int run_profile(live_file *f, const stream_profile *profile)
+{
+   int fill;
+   if (encode_file(f, profile) < 0)
+   {
+      fprintf(stderr, "encoding failed\n");
+      return -1;
+   }
+   for (fill = 0; fill < 2; fill++)
+   {
+      run_result sum, r;
+      int i;
+      memset(&sum, 0, sizeof(sum));
+      for (i = 0; i < NB_RUNS; i++)
+      {
+         if (run_once(f, profile, fill, &r) < 0)
+            return -1;
+         sum.ideal += r.ideal;
+         sum.open += r.open;
+         sum.first += r.first;
+         sum.nb_read += r.nb_read;
+      }
+      printf("%-8s %5.0f %7d %-8s %8ld %9.1f %9.1f %9.1f %8ld\n", profile->name,
+            profile->bitrate / 1000.0, profile->page_ms, fill ? "fill" : "partial",
+            f->first_audio_end, sum.ideal / NB_RUNS * 1000, sum.open / NB_RUNS * 1000,
+            sum.first / NB_RUNS * 1000, sum.nb_read / NB_RUNS);
+   }
+   return 0;
+}
+
+int main(int argc, char **argv)
+{
+   static const stream_profile default_profiles[] = {
+      { "voice",   16000,  100,   8000 },
+      { "radio",   64000,  250,  64000 },
+      { "music",  128000, 1000, 250000 }
+   };
+   const stream_profile *profiles = default_profiles;
+   int nb_profiles = sizeof(default_profiles) / sizeof(default_profiles[0]);
+   stream_profile custom;
+   live_file *f;
+   int p;
+
+   if (argc == 4)
+   {
+      custom.name = "custom";
+      custom.bitrate = atoi(argv[1]);
+      custom.page_ms = atoi(argv[2]);
+      custom.link_rate = atol(argv[3]);
+      profiles = &custom;
+      nb_profiles = 1;
+   }
+   if (argc != 1 && (argc != 4 || custom.bitrate < 6000 || custom.page_ms < 0
+         || custom.link_rate < 1000))
+   {
+      fprintf(stderr, "Usage: %s [<bits per second> <page ms> <link bytes per second>]\n",
+            argv[0]);
+      return 1;
+   }
+#if defined(_WIN32)
+   {
+      WSADATA wsa;
+      if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
+         return 1;
+   }
+#else
+   signal(SIGPIPE, SIG_IGN);
+#endif
+   f = (live_file *)calloc(1, sizeof(*f));
+   if (f == NULL)
+      return 1;
+   printf("%d runs per row, times in ms from the start of the stream\n", NB_RUNS);
+   printf("%-8s %5s %7s %-8s %8s %9s %9s %9s %8s\n", "profile", "kbps", "page ms",
+         "reads", "needed", "ideal ms", "open ms", "first ms", "read");
+   for (p = 0; p < nb_profiles; p++)
+   {
+      if (run_profile(f, &profiles[p]) < 0)
+         return 1;
+   }
+   free(f->data);
+   free(f);
+   return 0;
+}
@@ -0,0 +1,266 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* PVQ band decoder throughput.
+
+   Quantises random unit vectors with alg_quant() for every band of the
+   standard 48 kHz mode at each frame size, using pulse counts drawn from the
+   range the pulse cache allows for that band (or just the largest count),
+   and then times decoding them back with alg_unquant() in packet-sized
+   chunks.  The collapse mask and final position of each packet are checked
+   against what the encoder produced. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "modes.h"
+#include "rate.h"
+#include "vq.h"
+#include "entenc.h"
+#include "entdec.h"
+#include "bands.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+static double bench_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+#else
+# include <time.h>
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+#endif
+
+#define PACKET_SIZE 1275
+#define NB_RUNS     5
+#define MAX_N       176
+
+typedef struct {
+   const char *name;
+   int         LM;
+   /* Always use the largest pulse count the cache allows */
+   int         max_k;
+} workload;
+
+typedef struct {
+   unsigned char *data;
+   int           *nb_vectors;
+   opus_uint32   *tell;
+   /* N, K and the collapse mask of each vector */
+   int           *n;
+   int           *k;
+   unsigned      *mask;
+   int            nb_packets;
+   int            total_vectors;
+} vector_stream;
+
+static opus_uint32 seed = 42;
+
+static opus_uint32 bench_rand(void)
+{
+   seed = 1664525 * seed + 1013904223;
+   return seed >> 8;
+}
+
+static void random_vector(celt_norm *X, int N)
+{
+   float E;
+   float x[MAX_N];
+   int i;
+   E = 0;
+   for (i = 0; i < N; i++)
+   {
+      x[i] = (float)(bench_rand() & 0xFFFF) / 32768.f - 1.f;
+      E += x[i] * x[i];
+   }
+   E = 1.f / (float)sqrt(E + 1e-15f);
+   for (i = 0; i < N; i++)
+   {
+#ifdef FIXED_POINT
+      X[i] = (celt_norm)floor(.5 + 16383 * x[i] * E);
+#else
+      X[i] = x[i] * E;
+#endif
+   }
+}
+
+static void encode_stream(vector_stream *st, const CELTMode *m, const workload *w,
+      int nb_vectors)
+{
+   unsigned char buf[PACKET_SIZE];
+   celt_norm X[MAX_N];
+   int band;
+   int i;
+   st->data = NULL;
+   st->nb_vectors = (int *)malloc(nb_vectors * sizeof(*st->nb_vectors));
+   st->tell = (opus_uint32 *)malloc(nb_vectors * sizeof(*st->tell));
+   st->n = (int *)malloc(nb_vectors * sizeof(*st->n));
+   st->k = (int *)malloc(nb_vectors * sizeof(*st->k));
+   st->mask = (unsigned *)malloc(nb_vectors * sizeof(*st->mask));
+   st->nb_packets = 0;
+   st->total_vectors = 0;
+   band = 0;
+   i = 0;
+   while (i < nb_vectors)
+   {
+      ec_enc enc;
+      int n;
+      ec_enc_init(&enc, buf, PACKET_SIZE);
+      /* Stop well short of the packet size, as an encoder would */
+      for (n = 0; i < nb_vectors && ec_tell(&enc) < (PACKET_SIZE - 16) * 8;)
+      {
+         const unsigned char *cache;
+         int N, K, max_k;
+         /* Cycle through the bands with at least two coefficients */
+         N = (m->eBands[band + 1] - m->eBands[band]) << w->LM;
+         cache = m->cache.bits + m->cache.index[(w->LM + 1) * m->nbEBands + band];
+         if (++band >= m->nbEBands)
+            band = 0;
+         if (N < 2)
+            continue;
+         max_k = get_pulses(cache[0]);
+         K = w->max_k ? max_k : 1 + (int)(bench_rand() % max_k);
+         random_vector(X, N);
+         st->n[i] = N;
+         st->k[i] = K;
+         st->mask[i] = alg_quant(X, N, K, SPREAD_NORMAL, 1, &enc);
+         i++;
+         n++;
+      }
+      st->nb_vectors[st->nb_packets] = n;
+      st->tell[st->nb_packets] = ec_tell_frac(&enc);
+      ec_enc_done(&enc);
+      st->data = (unsigned char *)realloc(st->data, (size_t)(st->nb_packets + 1) * PACKET_SIZE);
+      memcpy(st->data + (size_t)st->nb_packets * PACKET_SIZE, buf, PACKET_SIZE);
+      st->total_vectors += n;
+      st->nb_packets++;
+   }
+}
+
+/* Returns the seconds spent decoding the whole stream, or -1 on a mismatch */
+static double decode_stream(const vector_stream *st)
+{
+   celt_norm X[MAX_N];
+   double start, elapsed;
+   int p, v, mismatch;
+   mismatch = 0;
+   v = 0;
+   start = bench_now();
+   for (p = 0; p < st->nb_packets; p++)
+   {
+      ec_dec dec;
+      int n, i;
+      n = st->nb_vectors[p];
+      ec_dec_init(&dec, st->data + (size_t)p * PACKET_SIZE, PACKET_SIZE);
+      for (i = 0; i < n; i++, v++)
+      {
+         mismatch |= alg_unquant(X, st->n[v], st->k[v], SPREAD_NORMAL, 1,
+               &dec, Q15ONE) != st->mask[v];
+      }
+      mismatch |= ec_tell_frac(&dec) != st->tell[p];
+      mismatch |= ec_get_error(&dec);
+   }
+   elapsed = bench_now() - start;
+   return mismatch ? -1 : elapsed;
+}
+
+int main(int argc, char **argv)
+{
+   const workload workloads[] = {
+      { "2.5 ms",       0, 0 },
+      { "5 ms",         1, 0 },
+      { "10 ms",        2, 0 },
+      { "20 ms",        3, 0 },
+      { "2.5 ms max K", 0, 1 },
+      { "5 ms max K",   1, 1 },
+      { "10 ms max K",  2, 1 },
+      { "20 ms max K",  3, 1 }
+   };
+   const CELTMode *m;
+   int nb_vectors = 500000;
+   int i;
+
+   if (argc > 1)
+      nb_vectors = atoi(argv[1]);
+   if (nb_vectors < 1)
+   {
+      fprintf(stderr, "Usage: %s [<vectors per workload>]\n", argv[0]);
+      return 1;
+   }
+   m = opus_custom_mode_create(48000, 960, NULL);
+   if (m == NULL)
+   {
+      fprintf(stderr, "Could not create the 48 kHz mode\n");
+      return 1;
+   }
+
+   printf("%-18s %12s %10s\n", "workload", "Mvectors/s", "ns/vector");
+   for (i = 0; i < (int)(sizeof(workloads) / sizeof(workloads[0])); i++)
+   {
+      const workload *w = &workloads[i];
+      vector_stream st;
+      double elapsed;
+      int run;
+      encode_stream(&st, m, w, nb_vectors);
+      /* Best of a few runs, to keep scheduling noise out of the figures */
+      elapsed = decode_stream(&st);
+      for (run = 1; run < NB_RUNS && elapsed >= 0; run++)
+      {
+         double t = decode_stream(&st);
+         if (t < 0 || t < elapsed)
+            elapsed = t;
+      }
+      if (elapsed < 0)
+      {
+         fprintf(stderr, "%s: decoded vectors do not match\n", w->name);
+         return 1;
+      }
+      printf("%-18s %12.2f %10.2f\n", w->name,
+            st.total_vectors / elapsed * 1e-6, elapsed * 1e9 / st.total_vectors);
+      free(st.data);
+      free(st.nb_vectors);
+      free(st.tell);
+      free(st.n);
+      free(st.k);
+      free(st.mask);
+   }
+   return 0;
+}
@@ -0,0 +1,233 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Per-stream SILK decoding throughput.
+
+   Encodes a few seconds of synthetic speech once per SILK internal rate and
+   then decodes it with many independent SILK decoder states interleaved frame
+   by frame, the way a conferencing mixer would, once for every run-time
+   selectable architecture up to the one of the host CPU. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opus.h"
+#include "opus_private.h"
+#include "API.h"
+#include "entdec.h"
+#include "cpu_support.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+static double bench_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+#else
+# include <time.h>
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+#endif
+
+#define FS          48000
+#define FRAME_SIZE  960
+#define MAX_PACKET  1500
+#define NB_RUNS     3
+
+typedef struct {
+   unsigned char *data;
+   int           *len;
+   int            nb_frames;
+} packet_list;
+
+static void gen_speech(opus_int16 *pcm, int len)
+{
+   unsigned int seed = 42;
+   double phase = 0;
+   int i, h;
+   for (i = 0; i < len; i++)
+   {
+      double t = (double)i / FS;
+      double f0 = 150 + 70 * sin(2 * M_PI * 0.9 * t);
+      double v = 0;
+      phase += 2 * M_PI * f0 / FS;
+      seed = 1664525 * seed + 1013904223;
+      if (fmod(t, 1.1) < 0.8)
+      {
+         for (h = 1; h <= 12; h++)
+            v += sin(h * phase) / h;
+         v *= 6000 * (0.5 + 0.5 * sin(2 * M_PI * 2.3 * t));
+      }
+      else
+         v = (double)((int)(seed >> 17) - 16384) * 0.3;
+      pcm[i] = (opus_int16)v;
+   }
+}
+
+static int encode_stream(packet_list *pl, int bandwidth, int bitrate, int nb_frames)
+{
+   OpusEncoder *enc;
+   opus_int16 *pcm;
+   int err, i;
+   enc = opus_encoder_create(FS, 1, OPUS_APPLICATION_VOIP, &err);
+   if (err != OPUS_OK)
+      return err;
+   opus_encoder_ctl(enc, OPUS_SET_FORCE_MODE(MODE_SILK_ONLY));
+   opus_encoder_ctl(enc, OPUS_SET_BANDWIDTH(bandwidth));
+   opus_encoder_ctl(enc, OPUS_SET_BITRATE(bitrate));
+   pcm = (opus_int16 *)malloc(nb_frames * FRAME_SIZE * sizeof(*pcm));
+   pl->data = (unsigned char *)malloc(nb_frames * MAX_PACKET);
+   pl->len = (int *)malloc(nb_frames * sizeof(*pl->len));
+   pl->nb_frames = nb_frames;
+   gen_speech(pcm, nb_frames * FRAME_SIZE);
+   for (i = 0; i < nb_frames; i++)
+   {
+      pl->len[i] = opus_encode(enc, pcm + i * FRAME_SIZE, FRAME_SIZE,
+            pl->data + i * MAX_PACKET, MAX_PACKET);
+      if (pl->len[i] < 0)
+         return pl->len[i];
+   }
+   free(pcm);
+   opus_encoder_destroy(enc);
+   return OPUS_OK;
+}
+
+/* Returns the seconds spent decoding every frame of pl on nb_streams states */
+static double decode_streams(const packet_list *pl, int fs_kHz, int nb_streams, int arch)
+{
+   silk_DecControlStruct *ctl;
+   char *states;
+   opus_int16 out[ FRAME_SIZE ];
+   int dec_size, i, s;
+   double start, elapsed;
+
+   silk_Get_Decoder_Size(&dec_size);
+   states = (char *)malloc((size_t)dec_size * nb_streams);
+   ctl = (silk_DecControlStruct *)calloc(nb_streams, sizeof(*ctl));
+   for (s = 0; s < nb_streams; s++)
+   {
+      silk_InitDecoder(states + (size_t)s * dec_size);
+      ctl[s].nChannelsAPI = 1;
+      ctl[s].nChannelsInternal = 1;
+      ctl[s].API_sampleRate = 1000 * fs_kHz;
+      ctl[s].internalSampleRate = 1000 * fs_kHz;
+      ctl[s].payloadSize_ms = 20;
+   }
+
+   start = bench_now();
+   for (i = 0; i < pl->nb_frames; i++)
+   {
+      const unsigned char *data = pl->data + i * MAX_PACKET;
+      for (s = 0; s < nb_streams; s++)
+      {
+         ec_dec range_dec;
+         opus_int32 nsamples;
+         ec_dec_init(&range_dec, (unsigned char *)data + 1, pl->len[i] - 1);
+         silk_Decode(states + (size_t)s * dec_size, &ctl[s], 0, 1, &range_dec,
+               out, &nsamples, arch);
+      }
+   }
+   elapsed = bench_now() - start;
+
+   free(ctl);
+   free(states);
+   return elapsed;
+}
+
+int main(int argc, char **argv)
+{
+   static const struct {
+      int bandwidth;
+      int fs_kHz;
+      int bitrate;
+   } configs[] = {
+      { OPUS_BANDWIDTH_NARROWBAND, 8,  10000 },
+      { OPUS_BANDWIDTH_MEDIUMBAND, 12, 14000 },
+      { OPUS_BANDWIDTH_WIDEBAND,   16, 20000 }
+   };
+   int nb_streams = 200;
+   int nb_frames = 250;
+   int c, arch, max_arch;
+
+   if (argc > 1)
+      nb_streams = atoi(argv[1]);
+   if (argc > 2)
+      nb_frames = atoi(argv[2]);
+   if (nb_streams < 1 || nb_frames < 1)
+   {
+      fprintf(stderr, "Usage: %s [<streams> [<20 ms frames per stream>]]\n", argv[0]);
+      return 1;
+   }
+   max_arch = opus_select_arch();
+
+   printf("%-7s %-5s %12s %12s\n", "rate", "arch", "ns/frame", "x realtime");
+   for (c = 0; c < (int)(sizeof(configs) / sizeof(configs[0])); c++)
+   {
+      packet_list pl;
+      if (encode_stream(&pl, configs[c].bandwidth, configs[c].bitrate, nb_frames) != OPUS_OK)
+      {
+         fprintf(stderr, "encoding failed\n");
+         return 1;
+      }
+      for (arch = 0; arch <= max_arch; arch++)
+      {
+         double elapsed, per_frame;
+         int run;
+         /* Only report the architectures that actually change the code path */
+         if (arch != 0 && arch != max_arch)
+            continue;
+         /* Best of a few runs, to keep scheduling noise out of the figures */
+         elapsed = decode_streams(&pl, configs[c].fs_kHz, nb_streams, arch);
+         for (run = 1; run < NB_RUNS; run++)
+         {
+            double t = decode_streams(&pl, configs[c].fs_kHz, nb_streams, arch);
+            if (t < elapsed)
+               elapsed = t;
+         }
+         per_frame = elapsed / ((double)nb_frames * nb_streams);
+         /* "x realtime" is also how many streams a single core sustains */
+         printf("%3d kHz %-5d %12.0f %12.1f\n", configs[c].fs_kHz, arch,
+               1e9 * per_frame, 0.02 / per_frame);
+      }
+      free(pl.data);
+      free(pl.len);
+   }
+   return 0;
+}
@@ -0,0 +1,187 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* SILK encoding throughput per complexity setting.
+
+   Encodes a few seconds of synthetic speech with the SILK encoder alone, at
+   every complexity from 0 to 10, once with the C code and once with the
+   architecture of the host CPU. Complexities 0 to 3 quantize with
+   silk_NSQ(), the higher ones with silk_NSQ_del_dec(). */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opus.h"
+#include "API.h"
+#include "entenc.h"
+#include "cpu_support.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+static double bench_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+#else
+# include <time.h>
+static double bench_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+#endif
+
+#define MAX_PACKET  1275
+#define NB_RUNS     3
+
+static void gen_speech(opus_int16 *pcm, int len, int fs)
+{
+   unsigned int seed = 42;
+   double phase = 0;
+   int i, h;
+   for (i = 0; i < len; i++)
+   {
+      double t = (double)i / fs;
+      double f0 = 150 + 70 * sin(2 * M_PI * 0.9 * t);
+      double v = 0;
+      phase += 2 * M_PI * f0 / fs;
+      seed = 1664525 * seed + 1013904223;
+      if (fmod(t, 1.1) < 0.8)
+      {
+         for (h = 1; h * f0 < fs / 2 && h <= 12; h++)
+            v += sin(h * phase) / h;
+         v *= 6000 * (0.5 + 0.5 * sin(2 * M_PI * 2.3 * t));
+      }
+      else
+         v = (double)((int)(seed >> 17) - 16384) * 0.3;
+      pcm[i] = (opus_int16)v;
+   }
+}
+
+/* Returns the seconds spent encoding nb_frames 20 ms frames of pcm */
+static double encode_stream(const opus_int16 *pcm, int nb_frames, int fs_kHz,
+      int bitrate, int complexity, int arch)
+{
+   silk_EncControlStruct ctl;
+   unsigned char packet[ MAX_PACKET ];
+   void *enc;
+   int enc_size, frame_size, i;
+   double start, elapsed;
+
+   frame_size = 20 * fs_kHz;
+   silk_Get_Encoder_Size(&enc_size);
+   enc = malloc(enc_size);
+   silk_InitEncoder(enc, arch, &ctl);
+   ctl.nChannelsAPI = 1;
+   ctl.nChannelsInternal = 1;
+   ctl.API_sampleRate = 1000 * fs_kHz;
+   ctl.maxInternalSampleRate = 1000 * fs_kHz;
+   ctl.minInternalSampleRate = 1000 * fs_kHz;
+   ctl.desiredInternalSampleRate = 1000 * fs_kHz;
+   ctl.payloadSize_ms = 20;
+   ctl.bitRate = bitrate;
+   ctl.packetLossPercentage = 0;
+   ctl.complexity = complexity;
+   ctl.useInBandFEC = 0;
+   ctl.useDTX = 0;
+   ctl.useCBR = 0;
+   ctl.maxBits = MAX_PACKET * 8;
+   ctl.toMono = 0;
+   ctl.opusCanSwitch = 0;
+   ctl.reducedDependency = 0;
+
+   start = bench_now();
+   for (i = 0; i < nb_frames; i++)
+   {
+      ec_enc range_enc;
+      opus_int32 nbytes = MAX_PACKET;
+      ec_enc_init(&range_enc, packet, MAX_PACKET);
+      silk_Encode(enc, &ctl, pcm + i * frame_size, frame_size, &range_enc, &nbytes, 0);
+      ec_enc_done(&range_enc);
+   }
+   elapsed = bench_now() - start;
+
+   free(enc);
+   return elapsed;
+}
+
+int main(int argc, char **argv)
+{
+   int fs_kHz = 16;
+   int nb_frames = 500;
+   int bitrate, complexity, max_arch;
+   opus_int16 *pcm;
+
+   if (argc > 1)
+      fs_kHz = atoi(argv[1]);
+   if (argc > 2)
+      nb_frames = atoi(argv[2]);
+   if ((fs_kHz != 8 && fs_kHz != 12 && fs_kHz != 16) || nb_frames < 1)
+   {
+      fprintf(stderr, "Usage: %s [<8|12|16 kHz> [<20 ms frames>]]\n", argv[0]);
+      return 1;
+   }
+   max_arch = opus_select_arch();
+   bitrate = 8000 + 1000 * fs_kHz;
+   pcm = (opus_int16 *)malloc(nb_frames * 20 * fs_kHz * sizeof(*pcm));
+   gen_speech(pcm, nb_frames * 20 * fs_kHz, 1000 * fs_kHz);
+
+   printf("%d kHz, %d bps\n", fs_kHz, bitrate);
+   printf("%-10s %12s %12s %12s %12s\n", "complexity", "C ns/frame",
+         "ns/frame", "x realtime", "speedup");
+   for (complexity = 0; complexity <= 10; complexity++)
+   {
+      double elapsed[ 2 ];
+      int k, run;
+      for (k = 0; k < 2; k++)
+      {
+         /* Best of a few runs, to keep scheduling noise out of the figures */
+         elapsed[ k ] = encode_stream(pcm, nb_frames, fs_kHz, bitrate, complexity, k ? max_arch : 0);
+         for (run = 1; run < NB_RUNS; run++)
+         {
+            double t = encode_stream(pcm, nb_frames, fs_kHz, bitrate, complexity, k ? max_arch : 0);
+            if (t < elapsed[ k ])
+               elapsed[ k ] = t;
+         }
+      }
+      printf("%-10d %12.0f %12.0f %12.1f %12.2f\n", complexity,
+            1e9 * elapsed[ 0 ] / nb_frames, 1e9 * elapsed[ 1 ] / nb_frames,
+            0.02 * nb_frames / elapsed[ 1 ], elapsed[ 0 ] / elapsed[ 1 ]);
+   }
+   free(pcm);
+   return 0;
+}
@@ -50,6 +50,7 @@
 #include <stdarg.h>
 #include "celt_lpc.h"
 #include "vq.h"
+#include "profile.h"
 
 /**********************************************************************/
 /*                                                                    */
@@ -196,7 +197,9 @@ void deemphasis(celt_sig *in[], opus_val16 *pcm, int N, int C, int downsample, c
    int Nd;
    int apply_downsampling=0;
    opus_val16 coef0;
+   OPUS_PROFILE_DECL;
 
+   OPUS_PROFILE_START();
    coef0 = coef[0];
    Nd = N/downsample;
    c=0; do {
@@ -250,6 +253,7 @@ void deemphasis(celt_sig *in[], opus_val16 *pcm, int N, int C, int downsample, c
             y[j*C] = SCALEOUT(SIG2WORD16(scratch[j*downsample]));
       }
    } while (++c<C);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_DEEMPHASIS);
 }
 
 /** Compute the IMDCT and apply window for all sub-frames and
@@ -265,6 +269,7 @@ void compute_inv_mdcts(const CELTMode *mode, int shortBlocks, celt_sig *X,
    int N;
    int shift;
    const int overlap = OVERLAP(mode);
+   OPUS_PROFILE_DECL;
 
    if (shortBlocks)
    {
@@ -276,11 +281,13 @@ void compute_inv_mdcts(const CELTMode *mode, int shortBlocks, celt_sig *X,
       N = mode->shortMdctSize<<LM;
       shift = mode->maxLM-LM;
    }
+   OPUS_PROFILE_START();
    c=0; do {
       /* IMDCT on the interleaved the sub-frames, overlap-add is performed by the IMDCT */
       for (b=0;b<B;b++)
          clt_mdct_backward(&mode->mdct, &X[b+c*N*B], out_mem[c]+N*b, mode->window, overlap, shift, B);
    } while (++c<C);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_MDCT_BACKWARD);
 }
 
 static void tf_decode(int start, int end, int isTransient, int *tf_res, int LM, ec_dec *dec)
@@ -697,6 +704,7 @@ int celt_decode_with_ec(CELTDecoder * OPUS_RESTRICT st, const unsigned char *dat
    int nbEBands;
    int overlap;
    const opus_int16 *eBands;
+   OPUS_PROFILE_DECL;
    ALLOC_STACK;
 
    mode = st->mode;
@@ -826,8 +834,10 @@ int celt_decode_with_ec(CELTDecoder * OPUS_RESTRICT st, const unsigned char *dat
    /* Decode the global flags (first symbols in the stream) */
    intra_ener = tell+3<=total_bits ? ec_dec_bit_logp(dec, 3) : 0;
    /* Get band energies */
+   OPUS_PROFILE_START();
    unquant_coarse_energy(mode, st->start, st->end, oldBandE,
          intra_ener, dec, C, LM);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_COARSE_ENERGY);
 
    ALLOC(tf_res, nbEBands, int);
    tf_decode(st->start, st->end, isTransient, tf_res, LM, dec);
@@ -895,9 +905,11 @@ int celt_decode_with_ec(CELTDecoder * OPUS_RESTRICT st, const unsigned char *dat
    ALLOC(collapse_masks, C*nbEBands, unsigned char);
    ALLOC(X, C*N, celt_norm);   /**< Interleaved normalised MDCTs */
 
+   OPUS_PROFILE_START();
    quant_all_bands(0, mode, st->start, st->end, X, C==2 ? X+N : NULL, collapse_masks,
          NULL, pulses, shortBlocks, spread_decision, dual_stereo, intensity, tf_res,
          len*(8<<BITRES)-anti_collapse_rsv, balance, dec, LM, codedBands, &st->rng);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_QUANT_BANDS);
 
    if (anti_collapse_rsv > 0)
    {
@@ -953,6 +965,7 @@ int celt_decode_with_ec(CELTDecoder * OPUS_RESTRICT st, const unsigned char *dat
    /* Compute inverse MDCTs */
    compute_inv_mdcts(mode, shortBlocks, freq, out_syn, CC, LM);
 
+   OPUS_PROFILE_START();
    c=0; do {
       st->postfilter_period=IMAX(st->postfilter_period, COMBFILTER_MINPERIOD);
       st->postfilter_period_old=IMAX(st->postfilter_period_old, COMBFILTER_MINPERIOD);
@@ -965,6 +978,7 @@ int celt_decode_with_ec(CELTDecoder * OPUS_RESTRICT st, const unsigned char *dat
                mode->window, overlap);
 
    } while (++c<CC);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_COMB_FILTER);
    st->postfilter_period_old = st->postfilter_period;
    st->postfilter_gain_old = st->postfilter_gain;
    st->postfilter_tapset_old = st->postfilter_tapset;
@@ -50,6 +50,7 @@
 #include <stdarg.h>
 #include "celt_lpc.h"
 #include "vq.h"
+#include "profile.h"
 
 
 /** Encoder state
@@ -424,6 +425,9 @@ static void compute_mdcts(const CELTMode *mode, int shortBlocks, celt_sig * OPUS
    int B;
    int shift;
    int i, b, c;
+   OPUS_PROFILE_DECL;
+
+   OPUS_PROFILE_START();
    if (shortBlocks)
    {
       B = shortBlocks;
@@ -457,6 +461,7 @@ static void compute_mdcts(const CELTMode *mode, int shortBlocks, celt_sig * OPUS
             out[c*B*N+i] = 0;
       } while (++c<C);
    }
+   OPUS_PROFILE_STOP(OPUS_PROFILE_MDCT_FORWARD);
 }
 
 
@@ -1016,6 +1021,7 @@ static int run_prefilter(CELTEncoder *st, celt_sig *in, celt_sig *prefilter_mem,
    opus_val16 pf_threshold;
    int pf_on;
    int qg;
+   OPUS_PROFILE_DECL;
    SAVE_STACK;
 
    mode = st->mode;
@@ -1099,6 +1105,7 @@ static int run_prefilter(CELTEncoder *st, celt_sig *in, celt_sig *prefilter_mem,
    }
    /*printf("%d %f\n", pitch_index, gain1);*/
 
+   OPUS_PROFILE_START();
    c=0; do {
       int offset = mode->shortMdctSize-st->overlap;
       st->prefilter_period=IMAX(st->prefilter_period, COMBFILTER_MINPERIOD);
@@ -1121,6 +1128,7 @@ static int run_prefilter(CELTEncoder *st, celt_sig *in, celt_sig *prefilter_mem,
          OPUS_MOVE(prefilter_mem+c*COMBFILTER_MAXPERIOD+COMBFILTER_MAXPERIOD-N, pre[c]+COMBFILTER_MAXPERIOD, N);
       }
    } while (++c<CC);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_COMB_FILTER);
 
    RESTORE_STACK;
    *gain = gain1;
@@ -1310,6 +1318,7 @@ int celt_encode_with_ec(CELTEncoder * OPUS_RESTRICT st, const opus_val16 * pcm,
    opus_val16 surround_trim = 0;
    opus_int32 equiv_rate = 510000;
    VARDECL(opus_val16, surround_dynalloc);
+   OPUS_PROFILE_DECL;
    ALLOC_STACK;
 
    mode = st->mode;
@@ -1473,10 +1482,12 @@ int celt_encode_with_ec(CELTEncoder * OPUS_RESTRICT st, const opus_val16 * pcm,
       tell = nbCompressedBytes*8;
       enc->nbits_total+=tell-ec_tell(enc);
    }
+   OPUS_PROFILE_START();
    c=0; do {
       celt_preemphasis(pcm+c, in+c*(N+st->overlap)+st->overlap, N, CC, st->upsample,
                   mode->preemph, st->preemph_memE+c, st->clip);
    } while (++c<CC);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_PREEMPHASIS);
 
 
 
@@ -1713,10 +1724,12 @@ int celt_encode_with_ec(CELTEncoder * OPUS_RESTRICT st, const opus_val16 * pcm,
    }
 
    ALLOC(error, C*nbEBands, opus_val16);
+   OPUS_PROFILE_START();
    quant_coarse_energy(mode, st->start, st->end, effEnd, bandLogE,
          oldBandE, total_bits, error, enc,
          C, LM, nbAvailableBytes, st->force_intra,
          &st->delayedIntra, st->complexity >= 4, st->loss_rate, st->lfe);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_COARSE_ENERGY);
 
    tf_encode(st->start, st->end, isTransient, tf_res, LM, tf_select, enc);
 
@@ -1962,9 +1975,11 @@ int celt_encode_with_ec(CELTEncoder * OPUS_RESTRICT st, const opus_val16 * pcm,
 
    /* Residual quantisation */
    ALLOC(collapse_masks, C*nbEBands, unsigned char);
+   OPUS_PROFILE_START();
    quant_all_bands(1, mode, st->start, st->end, X, C==2 ? X+N : NULL, collapse_masks,
          bandE, pulses, shortBlocks, st->spread_decision, dual_stereo, st->intensity, tf_res,
          nbCompressedBytes*(8<<BITRES)-anti_collapse_rsv, balance, enc, LM, codedBands, &st->rng);
+   OPUS_PROFILE_STOP(OPUS_PROFILE_QUANT_BANDS);
 
    if (anti_collapse_rsv > 0)
    {
@@ -42,6 +42,20 @@
  */
 #define OPUS_ARCHMASK 3
 
+#elif defined(OPUS_HAVE_RTCD) && \
+  ((defined(OPUS_X86_MAY_HAVE_SSE4_1) && !defined(OPUS_X86_PRESUME_SSE4_1)) || \
+   (defined(OPUS_X86_MAY_HAVE_AVX2) && !defined(OPUS_X86_PRESUME_AVX2)))
+#include "x86/x86cpu.h"
+
+/* We currently support 5 x86 variants:
+ * arch[0] -> non-sse
+ * arch[1] -> sse
+ * arch[2] -> sse2
+ * arch[3] -> sse4.1
+ * arch[4] -> avx2 (with fma)
+ */
+#define OPUS_ARCHMASK 7
+
 #else
 #define OPUS_ARCHMASK 0
 
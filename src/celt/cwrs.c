@@ -460,10 +460,15 @@ void encode_pulses(const int *_y,int _n,int _k,ec_enc *_enc){
   ec_enc_uint(_enc,icwrs(_n,_y),CELT_PVQ_V(_n,_k));
 }
 
-static void cwrsi(int _n,int _k,opus_uint32 _i,int *_y){
+/*Returns the _i'th combination of _k elements chosen from a set of size _n
+   with associated sign bits, and the energy of the resulting vector.
+  _y: Returns the vector of pulses.*/
+static opus_val32 cwrsi(int _n,int _k,opus_uint32 _i,int *_y){
   opus_uint32 p;
   int         s;
   int         k0;
+  opus_int16  val;
+  opus_val32  yy=0;
   celt_assert(_k>0);
   celt_assert(_n>1);
   while(_n>2){
@@ -487,14 +492,59 @@ static void cwrsi(int _n,int _k,opus_uint32 _i,int *_y){
       }
       else for(p=row[_k];p>_i;p=row[_k])_k--;
       _i-=p;
-      *_y++=(k0-_k+s)^s;
+      val=(k0-_k+s)^s;
+      *_y++=val;
+      yy=MAC16_16(yy,val,val);
     }
     /*Lots of dimensions case:*/
     else{
+      const opus_uint32 *row0;
+      const opus_uint32 *row1;
+      row0=CELT_PVQ_U_ROW[_k];
+      row1=CELT_PVQ_U_ROW[_k+1];
       /*Are there any pulses in this dimension at all?*/
-      p=CELT_PVQ_U_ROW[_k][_n];
-      q=CELT_PVQ_U_ROW[_k+1][_n];
+      p=row0[_n];
+      q=row1[_n];
       if(p<=_i&&_i<q){
+        /*All the pulses have been placed.*/
+        if(_k==0){
+          do *_y++=0;
+          while(--_n>2);
+          break;
+        }
+        /*If there are few pulses left for many dimensions, this is likely the
+           start of a long run of zeros, so find where it ends with a binary
+           search instead of stepping through it one dimension at a time.*/
+        if(_n>=16*(_k+1)){
+          opus_uint32 h;
+          opus_uint32 t;
+          opus_int32  e;
+          int         m;
+          int         len;
+          /*The codewords that start with r zeros occupy the middle V(N-r,K)
+             indices of [0,V(N,K)), since those with a positive first entry
+             come before them and the same number with a negative one after.
+            So, with h=V(N,K)/2, there are at least r zeros iff the distance
+             from _i to the midpoint, t=_i-h if _i>=h, or h-1-_i if _i<h, is
+             less than V(N-r,K)/2 (V is even for N>0 and K>0).
+            Note that this distance does not change as we step through the run.
+            We look for the smallest M=N-r in [K+1,N-1] with V(M,K)/2>t.*/
+          h=(p+q)>>1;
+          e=(opus_int32)(_i-h);
+          t=(opus_uint32)(e^-(e<0));
+          m=_k+1;
+          len=_n-1-_k;
+          while(len>1){
+            int half;
+            half=len>>1;
+            m+=(row0[m+half-1]+row1[m+half-1])>>1<=t?half:0;
+            len-=half;
+          }
+          _i-=h-((row0[m]+row1[m])>>1);
+          do *_y++=0;
+          while(--_n>m);
+          continue;
+        }
         _i-=p;
         *_y++=0;
       }
@@ -507,7 +557,9 @@ static void cwrsi(int _n,int _k,opus_uint32 _i,int *_y){
         do p=CELT_PVQ_U_ROW[--_k][_n];
         while(p>_i);
         _i-=p;
-        *_y++=(k0-_k+s)^s;
+        val=(k0-_k+s)^s;
+        *_y++=val;
+        yy=MAC16_16(yy,val,val);
       }
     }
     _n--;
@@ -519,14 +571,19 @@ static void cwrsi(int _n,int _k,opus_uint32 _i,int *_y){
   k0=_k;
   _k=(_i+1)>>1;
   if(_k)_i-=2*_k-1;
-  *_y++=(k0-_k+s)^s;
+  val=(k0-_k+s)^s;
+  *_y++=val;
+  yy=MAC16_16(yy,val,val);
   /*_n==1*/
   s=-(int)_i;
-  *_y=(_k+s)^s;
+  val=(_k+s)^s;
+  *_y=val;
+  yy=MAC16_16(yy,val,val);
+  return yy;
 }
 
-void decode_pulses(int *_y,int _n,int _k,ec_dec *_dec){
-  cwrsi(_n,_k,ec_dec_uint(_dec,CELT_PVQ_V(_n,_k)),_y);
+opus_val32 decode_pulses(int *_y,int _n,int _k,ec_dec *_dec){
+  return cwrsi(_n,_k,ec_dec_uint(_dec,CELT_PVQ_V(_n,_k)),_y);
 }
 
 #else /* SMALL_FOOTPRINT */
@@ -587,12 +644,13 @@ static opus_uint32 ncwrs_urow(unsigned _n,unsigned _k,opus_uint32 *_u){
 }
 
 /*Returns the _i'th combination of _k elements chosen from a set of size _n
-   with associated sign bits.
+   with associated sign bits, and the energy of the resulting vector.
   _y: Returns the vector of pulses.
   _u: Must contain entries [0..._k+1] of row _n of U() on input.
       Its contents will be destructively modified.*/
-static void cwrsi(int _n,int _k,opus_uint32 _i,int *_y,opus_uint32 *_u){
-  int j;
+static opus_val32 cwrsi(int _n,int _k,opus_uint32 _i,int *_y,opus_uint32 *_u){
+  opus_val32 yy=0;
+  int        j;
   celt_assert(_n>0);
   j=0;
   do{
@@ -607,10 +665,13 @@ static void cwrsi(int _n,int _k,opus_uint32 _i,int *_y,opus_uint32 *_u){
     while(p>_i)p=_u[--_k];
     _i-=p;
     yj-=_k;
-    _y[j]=(yj+s)^s;
+    yj=(yj+s)^s;
+    _y[j]=yj;
+    yy=MAC16_16(yy,yj,yj);
     uprev(_u,_k+2,0);
   }
   while(++j<_n);
+  return yy;
 }
 
 /*Returns the index of the given combination of K elements chosen from a set
@@ -685,13 +746,15 @@ void encode_pulses(const int *_y,int _n,int _k,ec_enc *_enc){
   RESTORE_STACK;
 }
 
-void decode_pulses(int *_y,int _n,int _k,ec_dec *_dec){
+opus_val32 decode_pulses(int *_y,int _n,int _k,ec_dec *_dec){
   VARDECL(opus_uint32,u);
+  opus_val32 yy;
   SAVE_STACK;
   celt_assert(_k>0);
   ALLOC(u,_k+2U,opus_uint32);
-  cwrsi(_n,_k,ec_dec_uint(_dec,ncwrs_urow(_n,_k,u)),_y,u);
+  yy=cwrsi(_n,_k,ec_dec_uint(_dec,ncwrs_urow(_n,_k,u)),_y,u);
   RESTORE_STACK;
+  return yy;
 }
 
 #endif /* SMALL_FOOTPRINT */
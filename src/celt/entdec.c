@@ -34,6 +34,7 @@
 #include "arch.h"
 #include "entdec.h"
 #include "mfrngcod.h"
+#include "profile.h"
 
 /*A range decoder.
   This is an entropy decoder based upon \cite{Mar79}, which is itself a
@@ -97,23 +98,45 @@ static int ec_read_byte_from_end(ec_dec *_this){
    _this->buf[_this->storage-++(_this->end_offs)]:0;
 }
 
-/*Normalizes the contents of val and rng so that rng lies entirely in the
-   high-order symbol.*/
-static void ec_dec_normalize(ec_dec *_this){
-  /*If the range is too small, rescale it and input some bits.*/
-  while(_this->rng<=EC_CODE_BOT){
+/*Rescales rng and inputs bits into val until rng lies entirely in the
+   high-order symbol.
+  This is the slow path of ec_dec_normalize(), kept out of line so that the
+   common case, where most symbols need no input at all, costs one well
+   predicted branch and no call.*/
+static void ec_dec_refill(ec_dec *_this){
+  opus_uint32 rng;
+  opus_uint32 val;
+  int         rem;
+  int         nbits_total;
+  rng=_this->rng;
+  val=_this->val;
+  rem=_this->rem;
+  nbits_total=_this->nbits_total;
+  do{
     int sym;
-    _this->nbits_total+=EC_SYM_BITS;
-    _this->rng<<=EC_SYM_BITS;
+    nbits_total+=EC_SYM_BITS;
+    rng<<=EC_SYM_BITS;
     /*Use up the remaining bits from our last symbol.*/
-    sym=_this->rem;
+    sym=rem;
     /*Read the next value from the input.*/
-    _this->rem=ec_read_byte(_this);
+    rem=ec_read_byte(_this);
     /*Take the rest of the bits we need from this new symbol.*/
-    sym=(sym<<EC_SYM_BITS|_this->rem)>>(EC_SYM_BITS-EC_CODE_EXTRA);
+    sym=(sym<<EC_SYM_BITS|rem)>>(EC_SYM_BITS-EC_CODE_EXTRA);
     /*And subtract them from val, capped to be less than EC_CODE_TOP.*/
-    _this->val=((_this->val<<EC_SYM_BITS)+(EC_SYM_MAX&~sym))&(EC_CODE_TOP-1);
+    val=((val<<EC_SYM_BITS)+(EC_SYM_MAX&~sym))&(EC_CODE_TOP-1);
   }
+  while(rng<=EC_CODE_BOT);
+  _this->rng=rng;
+  _this->val=val;
+  _this->rem=rem;
+  _this->nbits_total=nbits_total;
+}
+
+/*Normalizes the contents of val and rng so that rng lies entirely in the
+   high-order symbol.*/
+static OPUS_INLINE void ec_dec_normalize(ec_dec *_this){
+  /*If the range is too small, rescale it and input some bits.*/
+  if(_this->rng<=EC_CODE_BOT)ec_dec_refill(_this);
 }
 
 void ec_dec_init(ec_dec *_this,unsigned char *_buf,opus_uint32 _storage){
@@ -152,6 +175,7 @@ unsigned ec_decode_bin(ec_dec *_this,unsigned _bits){
 
 void ec_dec_update(ec_dec *_this,unsigned _fl,unsigned _fh,unsigned _ft){
   opus_uint32 s;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_DEC);
   s=IMUL32(_this->ext,_ft-_fh);
   _this->val-=s;
   _this->rng=_fl>0?IMUL32(_this->ext,_fh-_fl):_this->rng-s;
@@ -164,6 +188,7 @@ int ec_dec_bit_logp(ec_dec *_this,unsigned _logp){
   opus_uint32 d;
   opus_uint32 s;
   int         ret;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_DEC);
   r=_this->rng;
   d=_this->val;
   s=r>>_logp;
@@ -180,15 +205,21 @@ int ec_dec_icdf(ec_dec *_this,const unsigned char *_icdf,unsigned _ftb){
   opus_uint32 s;
   opus_uint32 t;
   int         ret;
-  s=_this->rng;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_DEC);
+  t=_this->rng;
   d=_this->val;
-  r=s>>_ftb;
-  ret=-1;
-  do{
-    t=s;
-    s=IMUL32(r,_icdf[++ret]);
+  r=t>>_ftb;
+  /*Test the first (usually most probable) symbol on its own, so it gets a
+     branch of its own in the predictor instead of sharing the loop exit.*/
+  s=IMUL32(r,_icdf[0]);
+  ret=0;
+  if(d<s){
+    do{
+      t=s;
+      s=IMUL32(r,_icdf[++ret]);
+    }
+    while(d<s);
   }
-  while(d<s);
   _this->val=d-s;
   _this->rng=t-s;
   ec_dec_normalize(_this);
@@ -226,6 +257,7 @@ opus_uint32 ec_dec_bits(ec_dec *_this,unsigned _bits){
   ec_window   window;
   int         available;
   opus_uint32 ret;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_DEC);
   window=_this->end_window;
   available=_this->nend_bits;
   if((unsigned)available<_bits){
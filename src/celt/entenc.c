@@ -32,6 +32,7 @@
 #include "arch.h"
 #include "entenc.h"
 #include "mfrngcod.h"
+#include "profile.h"
 
 /*A range encoder.
   See entdec.c and the references for implementation details \cite{Mar79,MNW98}.
@@ -127,6 +128,7 @@ void ec_enc_init(ec_enc *_this,unsigned char *_buf,opus_uint32 _size){
 
 void ec_encode(ec_enc *_this,unsigned _fl,unsigned _fh,unsigned _ft){
   opus_uint32 r;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_ENC);
   r=_this->rng/_ft;
   if(_fl>0){
     _this->val+=_this->rng-IMUL32(r,(_ft-_fl));
@@ -138,6 +140,7 @@ void ec_encode(ec_enc *_this,unsigned _fl,unsigned _fh,unsigned _ft){
 
 void ec_encode_bin(ec_enc *_this,unsigned _fl,unsigned _fh,unsigned _bits){
   opus_uint32 r;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_ENC);
   r=_this->rng>>_bits;
   if(_fl>0){
     _this->val+=_this->rng-IMUL32(r,((1U<<_bits)-_fl));
@@ -152,6 +155,7 @@ void ec_enc_bit_logp(ec_enc *_this,int _val,unsigned _logp){
   opus_uint32 r;
   opus_uint32 s;
   opus_uint32 l;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_ENC);
   r=_this->rng;
   l=_this->val;
   s=r>>_logp;
@@ -163,6 +167,7 @@ void ec_enc_bit_logp(ec_enc *_this,int _val,unsigned _logp){
 
 void ec_enc_icdf(ec_enc *_this,int _s,const unsigned char *_icdf,unsigned _ftb){
   opus_uint32 r;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_ENC);
   r=_this->rng>>_ftb;
   if(_s>0){
     _this->val+=_this->rng-IMUL32(r,_icdf[_s-1]);
@@ -193,6 +198,7 @@ void ec_enc_uint(ec_enc *_this,opus_uint32 _fl,opus_uint32 _ft){
 void ec_enc_bits(ec_enc *_this,opus_uint32 _fl,unsigned _bits){
   ec_window window;
   int       used;
+  OPUS_PROFILE_COUNT(OPUS_PROFILE_EC_ENC);
   window=_this->end_window;
   used=_this->nend_bits;
   celt_assert(_bits>0);
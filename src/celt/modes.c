@@ -67,6 +67,14 @@ static const unsigned char band_allocation[] = {
  #else
   #include "static_modes_float.h"
  #endif
+ #ifdef CUSTOM_MODES
+  /* Precomputed Opus Custom modes, see dump_modes/dump_modes.c */
+  #ifdef FIXED_POINT
+   #include "static_custom_modes_fixed.h"
+  #else
+   #include "static_custom_modes_float.h"
+  #endif
+ #endif
 #endif /* CUSTOM_MODES_ONLY */
 
 #ifndef M_PI
@@ -251,6 +259,22 @@ CELTMode *opus_custom_mode_create(opus_int32 Fs, int frame_size, int *error)
          }
       }
    }
+#ifdef CUSTOM_MODES
+   for (i=0;i<TOTAL_CUSTOM_MODES;i++)
+   {
+      int j;
+      for (j=0;j<=static_custom_mode_list[i]->maxLM;j++)
+      {
+         if (Fs == static_custom_mode_list[i]->Fs &&
+               (frame_size<<j) == static_custom_mode_list[i]->shortMdctSize*static_custom_mode_list[i]->nbShortMdcts)
+         {
+            if (error)
+               *error = OPUS_OK;
+            return (CELTMode*)static_custom_mode_list[i];
+         }
+      }
+   }
+#endif /* CUSTOM_MODES */
 #endif /* CUSTOM_MODES_ONLY */
 
 #ifndef CUSTOM_MODES
@@ -420,6 +444,13 @@ void opus_custom_mode_destroy(CELTMode *mode)
            return;
         }
      }
+     for (i=0;i<TOTAL_CUSTOM_MODES;i++)
+     {
+        if (mode == static_custom_mode_list[i])
+        {
+           return;
+        }
+     }
    }
 #endif /* CUSTOM_MODES_ONLY */
    opus_free((opus_int16*)mode->eBands);
@@ -37,7 +37,8 @@
 #include "modes.h"
 #include "cpu_support.h"
 
-#if defined(__SSE__) && !defined(FIXED_POINT)
+#if (defined(__SSE__) && !defined(FIXED_POINT)) || \
+  (defined(OPUS_X86_MAY_HAVE_SSE4_1) && defined(FIXED_POINT))
 #include "x86/pitch_sse.h"
 #endif
 
@@ -151,7 +152,8 @@ celt_pitch_xcorr_c(const opus_val16 *_x, const opus_val16 *_y,
 
 #if !defined(OVERRIDE_PITCH_XCORR)
 /*Is run-time CPU detection enabled on this platform?*/
-# if defined(OPUS_HAVE_RTCD)
+# if defined(OPUS_HAVE_RTCD) && (defined(OPUS_ARM_ASM) || \
+  (defined(OPUS_X86_MAY_HAVE_SSE4_1) && defined(FIXED_POINT)))
 extern
 #  if defined(FIXED_POINT)
 opus_val32
@@ -0,0 +1,101 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "profile.h"
+
+#ifdef ENABLE_PROFILING
+
+#if defined(_MSC_VER)
+# define PROFILE_THREAD __declspec(thread)
+#elif defined(__GNUC__)
+# define PROFILE_THREAD __thread
+#else
+# define PROFILE_THREAD
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+# include <intrin.h>
+# define PROFILE_RDTSC
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+# include <x86intrin.h>
+# define PROFILE_RDTSC
+#elif defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+/* The block of the encoder or decoder running on this thread, if any */
+static PROFILE_THREAD OpusProfile *opus_profile_current;
+
+OpusProfile *opus_profile_enter(OpusProfile *profile)
+{
+   OpusProfile *saved = opus_profile_current;
+   opus_profile_current = profile;
+   return saved;
+}
+
+opus_uint64 opus_profile_ticks(void)
+{
+#if defined(PROFILE_RDTSC)
+   return __rdtsc();
+#elif defined(_WIN32)
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (opus_uint64)(count.QuadPart / freq.QuadPart) * 1000000000
+         + (opus_uint64)(count.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (opus_uint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void opus_profile_add(int stage, opus_uint64 start)
+{
+   OpusProfile *profile = opus_profile_current;
+   if (profile)
+   {
+      profile->ticks[stage] += opus_profile_ticks() - start;
+      profile->calls[stage]++;
+   }
+}
+
+void opus_profile_count(int stage)
+{
+   OpusProfile *profile = opus_profile_current;
+   if (profile)
+      profile->calls[stage]++;
+}
+
+#endif
@@ -0,0 +1,71 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "opus_defines.h"
+
+/* Hot-path profiling counters, compiled in with ENABLE_PROFILING.
+
+   Each encoder and decoder owns an OpusProfile block. While one of them is
+   running, OPUS_PROFILE_ENTER() makes its block the current one for the
+   calling thread and the stages it runs charge their time to it, so the
+   SILK and CELT code does not need a pointer to the top-level state. A
+   stage is bracketed with OPUS_PROFILE_START()/OPUS_PROFILE_STOP(), which
+   need an OPUS_PROFILE_DECL; after the other declarations of the function.
+   Without ENABLE_PROFILING all of these expand to nothing. */
+
+#ifdef ENABLE_PROFILING
+
+OpusProfile *opus_profile_enter(OpusProfile *profile);
+
+opus_uint64 opus_profile_ticks(void);
+
+void opus_profile_add(int stage, opus_uint64 start);
+
+void opus_profile_count(int stage);
+
+#define OPUS_PROFILE_ENTER(profile) OpusProfile *opus_profile_saved = opus_profile_enter(profile)
+#define OPUS_PROFILE_LEAVE() ((void)opus_profile_enter(opus_profile_saved))
+#define OPUS_PROFILE_DECL opus_uint64 opus_profile_start
+#define OPUS_PROFILE_START() (opus_profile_start = opus_profile_ticks())
+#define OPUS_PROFILE_STOP(stage) opus_profile_add(stage, opus_profile_start)
+#define OPUS_PROFILE_COUNT(stage) opus_profile_count(stage)
+
+#else
+
+#define OPUS_PROFILE_ENTER(profile)
+#define OPUS_PROFILE_LEAVE()
+#define OPUS_PROFILE_DECL
+#define OPUS_PROFILE_START()
+#define OPUS_PROFILE_STOP(stage)
+#define OPUS_PROFILE_COUNT(stage)
+
+#endif
+
+#endif /* PROFILE_H */
@@ -0,0 +1,807 @@
+/* The contents of this file was automatically generated by dump_modes.c
+   with arguments: 48000 512 44100 512
+   It contains static definitions for the Opus Custom modes built into
+   CUSTOM_MODES builds. It must be included after static_modes_*.h.
+   To refresh it, or to embed a different set of modes, run make in
+   src/celt/dump_modes, e.g. make MODES="48000 512 44100 512". */
+#include "modes.h"
+#include "rate.h"
+
+static const opus_int16 eBands48000_512[24] = {
+0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 18, 20, 24, 28, 34, 40, 50, 64, 82, 106, 0, };
+
+#ifndef DEF_WINDOW128
+#define DEF_WINDOW128
+static const opus_val16 window128[128] = {
+2, 17, 48, 95, 157,
+234, 327, 435, 558, 696,
+850, 1018, 1201, 1399, 1612,
+1839, 2080, 2336, 2605, 2888,
+3184, 3494, 3817, 4152, 4500,
+4860, 5232, 5615, 6009, 6415,
+6830, 7255, 7690, 8134, 8587,
+9047, 9516, 9991, 10473, 10961,
+11454, 11953, 12456, 12962, 13472,
+13984, 14498, 15014, 15530, 16047,
+16562, 17077, 17590, 18101, 18608,
+19112, 19612, 20107, 20597, 21080,
+21558, 22028, 22491, 22946, 23393,
+23831, 24259, 24678, 25087, 25486,
+25874, 26251, 26617, 26972, 27315,
+27647, 27966, 28274, 28570, 28854,
+29126, 29386, 29634, 29871, 30095,
+30308, 30510, 30701, 30880, 31049,
+31208, 31356, 31494, 31623, 31742,
+31853, 31955, 32048, 32134, 32212,
+32283, 32348, 32406, 32458, 32504,
+32545, 32581, 32613, 32640, 32664,
+32685, 32702, 32716, 32728, 32738,
+32746, 32752, 32757, 32761, 32763,
+32765, 32766, 32767, 32767, 32767,
+32767, 32767, 32767, };
+#endif
+
+static const unsigned char allocVectors48000_512[242] = {
+ 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 
+90, 80, 75, 70, 64, 58, 51, 43, 37, 30, 23, 18, 14,  7,  3,  0,  0,  0,  0,  0,  0,  0, 
+110, 100, 91, 85, 79, 73, 67, 61, 54, 46, 41, 35, 29, 24, 21, 15,  5,  0,  0,  0,  0,  0, 
+118, 110, 103, 94, 87, 81, 76, 72, 67, 60, 55, 49, 43, 38, 33, 26, 18,  7,  1,  0,  0,  0, 
+126, 119, 112, 105, 97, 90, 85, 80, 75, 67, 62, 56, 50, 45, 41, 34, 28, 19, 14,  2,  0,  0, 
+134, 127, 120, 115, 105, 98, 93, 87, 81, 73, 68, 62, 57, 52, 49, 43, 37, 31, 25, 16, 10,  1, 
+144, 137, 130, 125, 115, 108, 103, 97, 91, 83, 78, 72, 67, 62, 59, 53, 47, 41, 35, 26, 15,  1, 
+152, 145, 138, 133, 125, 118, 113, 107, 101, 93, 88, 82, 77, 72, 69, 63, 57, 51, 45, 36, 20,  2, 
+162, 155, 148, 143, 135, 128, 123, 117, 111, 103, 98, 92, 87, 82, 79, 73, 67, 61, 55, 46, 30,  2, 
+172, 165, 158, 153, 145, 138, 133, 127, 121, 113, 108, 102, 97, 92, 89, 83, 77, 71, 65, 56, 45, 21, 
+200, 200, 200, 200, 200, 200, 200, 200, 199, 194, 189, 185, 180, 176, 174, 169, 165, 159, 155, 148, 129, 105, 
+};
+
+#ifndef DEF_LOGN375
+#define DEF_LOGN375
+static const opus_int16 logN375[22] = {
+0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 8, 16, 16, 21, 21, 27, 31, 34, 37, };
+#endif
+
+#ifndef DEF_PULSE_CACHE93
+#define DEF_PULSE_CACHE93
+static const opus_int16 cache_index93[88] = {
+-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 41,
+41, 82, 82, 123, 164, 194, 216, 0, 0, 0, 0, 0, 0, 0, 0,
+41, 41, 41, 41, 41, 41, 233, 233, 274, 274, 310, 330, 344, 356, 41,
+41, 41, 41, 41, 41, 41, 41, 233, 233, 233, 233, 233, 233, 366, 366,
+216, 216, 392, 403, 412, 420, 233, 233, 233, 233, 233, 233, 233, 233, 366,
+366, 366, 366, 366, 366, 427, 427, 356, 356, 440, 448, 455, 461, };
+static const unsigned char cache_bits93[467] = {
+40, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 40, 15, 23, 28,
+31, 34, 36, 38, 39, 41, 42, 43, 44, 45, 46, 47, 47, 49, 50,
+51, 52, 53, 54, 55, 55, 57, 58, 59, 60, 61, 62, 63, 63, 65,
+66, 67, 68, 69, 70, 71, 71, 40, 20, 33, 41, 48, 53, 57, 61,
+64, 66, 69, 71, 73, 75, 76, 78, 80, 82, 85, 87, 89, 91, 92,
+94, 96, 98, 101, 103, 105, 107, 108, 110, 112, 114, 117, 119, 121, 123,
+124, 126, 128, 40, 26, 45, 59, 70, 79, 87, 94, 100, 105, 110, 114,
+118, 122, 125, 128, 131, 136, 141, 146, 150, 153, 157, 160, 163, 168, 173,
+178, 182, 185, 189, 192, 195, 200, 205, 210, 214, 217, 221, 224, 227, 29,
+30, 52, 70, 85, 98, 109, 118, 126, 134, 141, 147, 153, 158, 163, 168,
+172, 180, 188, 194, 200, 205, 211, 215, 220, 228, 235, 242, 248, 253, 21,
+33, 58, 79, 97, 112, 125, 137, 148, 157, 166, 174, 182, 189, 195, 201,
+207, 217, 227, 235, 243, 251, 16, 36, 65, 89, 110, 128, 144, 159, 173,
+185, 196, 207, 217, 226, 234, 242, 250, 40, 23, 39, 51, 60, 67, 73,
+79, 83, 87, 91, 94, 97, 100, 102, 105, 107, 111, 115, 118, 121, 124,
+126, 129, 131, 135, 139, 142, 145, 148, 150, 153, 155, 159, 163, 166, 169,
+172, 174, 177, 179, 35, 28, 49, 65, 78, 89, 99, 107, 114, 120, 126,
+132, 136, 141, 145, 149, 153, 159, 165, 171, 176, 180, 185, 189, 192, 199,
+205, 211, 216, 220, 225, 229, 232, 239, 245, 251, 19, 34, 61, 83, 101,
+118, 132, 145, 157, 167, 177, 186, 194, 202, 209, 216, 222, 234, 245, 254,
+13, 38, 68, 94, 117, 137, 155, 171, 186, 200, 213, 225, 236, 247, 11,
+41, 74, 103, 128, 151, 172, 191, 209, 225, 241, 255, 9, 44, 81, 113,
+142, 168, 192, 214, 235, 255, 25, 31, 55, 75, 91, 105, 117, 128, 138,
+146, 154, 161, 168, 174, 180, 185, 190, 200, 208, 215, 222, 229, 235, 240,
+245, 255, 10, 42, 77, 107, 133, 157, 179, 200, 219, 236, 253, 8, 46,
+84, 118, 149, 177, 202, 227, 249, 7, 49, 90, 127, 160, 191, 220, 247,
+6, 52, 97, 137, 174, 208, 240, 12, 39, 71, 99, 123, 144, 164, 182,
+198, 214, 228, 241, 253, 7, 50, 93, 131, 165, 197, 227, 255, 6, 54,
+100, 142, 181, 217, 250, 5, 57, 106, 151, 192, 231, 5, 60, 113, 161,
+206, 248, };
+static const unsigned char cache_caps93[132] = {
+224, 224, 224, 224, 224, 224, 224, 224, 160, 160, 160, 160, 160, 160, 185,
+185, 178, 178, 159, 105, 61, 28, 224, 224, 224, 224, 224, 224, 224, 224,
+240, 240, 240, 240, 240, 240, 207, 207, 198, 198, 171, 110, 66, 30, 160,
+160, 160, 160, 160, 160, 160, 160, 185, 185, 185, 185, 185, 185, 193, 193,
+183, 183, 163, 106, 64, 29, 240, 240, 240, 240, 240, 240, 240, 240, 207,
+207, 207, 207, 207, 207, 204, 204, 193, 193, 167, 110, 66, 31, 185, 185,
+185, 185, 185, 185, 185, 185, 193, 193, 193, 193, 193, 193, 193, 193, 183,
+183, 163, 107, 65, 30, 207, 207, 207, 207, 207, 207, 207, 207, 204, 204,
+204, 204, 204, 204, 201, 201, 188, 188, 166, 109, 66, 31, };
+#endif
+
+#ifndef FFT_TWIDDLES48000_512
+#define FFT_TWIDDLES48000_512
+static const kiss_twiddle_cpx fft_twiddles48000_512[256] = {
+{32767, 0}, {32758, -804},
+{32729, -1609}, {32679, -2410},
+{32610, -3212}, {32522, -4012},
+{32413, -4809}, {32286, -5602},
+{32138, -6393}, {31972, -7180},
+{31786, -7962}, {31581, -8740},
+{31357, -9512}, {31114, -10278},
+{30853, -11039}, {30573, -11793},
+{30274, -12540}, {29957, -13279},
+{29622, -14010}, {29270, -14733},
+{28899, -15447}, {28511, -16151},
+{28106, -16846}, {27685, -17531},
+{27246, -18205}, {26791, -18868},
+{26320, -19520}, {25833, -20160},
+{25330, -20788}, {24813, -21403},
+{24280, -22006}, {23732, -22595},
+{23171, -23171}, {22595, -23732},
+{22006, -24280}, {21403, -24813},
+{20788, -25330}, {20160, -25833},
+{19520, -26320}, {18868, -26791},
+{18205, -27246}, {17531, -27685},
+{16846, -28106}, {16151, -28511},
+{15447, -28899}, {14733, -29270},
+{14010, -29622}, {13279, -29957},
+{12540, -30274}, {11793, -30573},
+{11039, -30853}, {10278, -31114},
+{9512, -31357}, {8740, -31581},
+{7962, -31786}, {7180, -31972},
+{6393, -32138}, {5602, -32286},
+{4809, -32413}, {4012, -32522},
+{3212, -32610}, {2410, -32679},
+{1609, -32729}, {804, -32758},
+{0, -32767}, {-804, -32758},
+{-1609, -32729}, {-2410, -32679},
+{-3212, -32610}, {-4012, -32522},
+{-4809, -32413}, {-5602, -32286},
+{-6393, -32138}, {-7180, -31972},
+{-7962, -31786}, {-8740, -31581},
+{-9512, -31357}, {-10278, -31114},
+{-11039, -30853}, {-11793, -30573},
+{-12540, -30274}, {-13279, -29957},
+{-14010, -29622}, {-14733, -29270},
+{-15447, -28899}, {-16151, -28511},
+{-16846, -28106}, {-17531, -27685},
+{-18205, -27246}, {-18868, -26791},
+{-19520, -26320}, {-20160, -25833},
+{-20788, -25330}, {-21403, -24813},
+{-22006, -24280}, {-22595, -23732},
+{-23171, -23171}, {-23732, -22595},
+{-24280, -22006}, {-24813, -21403},
+{-25330, -20788}, {-25833, -20160},
+{-26320, -19520}, {-26791, -18868},
+{-27246, -18205}, {-27685, -17531},
+{-28106, -16846}, {-28511, -16151},
+{-28899, -15447}, {-29270, -14733},
+{-29622, -14010}, {-29957, -13279},
+{-30274, -12540}, {-30573, -11793},
+{-30853, -11039}, {-31114, -10278},
+{-31357, -9512}, {-31581, -8740},
+{-31786, -7962}, {-31972, -7180},
+{-32138, -6393}, {-32286, -5602},
+{-32413, -4809}, {-32522, -4012},
+{-32610, -3212}, {-32679, -2410},
+{-32729, -1609}, {-32758, -804},
+{-32767, 0}, {-32758, 804},
+{-32729, 1609}, {-32679, 2410},
+{-32610, 3212}, {-32522, 4012},
+{-32413, 4809}, {-32286, 5602},
+{-32138, 6393}, {-31972, 7180},
+{-31786, 7962}, {-31581, 8740},
+{-31357, 9512}, {-31114, 10278},
+{-30853, 11039}, {-30573, 11793},
+{-30274, 12540}, {-29957, 13279},
+{-29622, 14010}, {-29270, 14733},
+{-28899, 15447}, {-28511, 16151},
+{-28106, 16846}, {-27685, 17531},
+{-27246, 18205}, {-26791, 18868},
+{-26320, 19520}, {-25833, 20160},
+{-25330, 20788}, {-24813, 21403},
+{-24280, 22006}, {-23732, 22595},
+{-23171, 23171}, {-22595, 23732},
+{-22006, 24280}, {-21403, 24813},
+{-20788, 25330}, {-20160, 25833},
+{-19520, 26320}, {-18868, 26791},
+{-18205, 27246}, {-17531, 27685},
+{-16846, 28106}, {-16151, 28511},
+{-15447, 28899}, {-14733, 29270},
+{-14010, 29622}, {-13279, 29957},
+{-12540, 30274}, {-11793, 30573},
+{-11039, 30853}, {-10278, 31114},
+{-9512, 31357}, {-8740, 31581},
+{-7962, 31786}, {-7180, 31972},
+{-6393, 32138}, {-5602, 32286},
+{-4809, 32413}, {-4012, 32522},
+{-3212, 32610}, {-2410, 32679},
+{-1609, 32729}, {-804, 32758},
+{0, 32767}, {804, 32758},
+{1609, 32729}, {2410, 32679},
+{3212, 32610}, {4012, 32522},
+{4809, 32413}, {5602, 32286},
+{6393, 32138}, {7180, 31972},
+{7962, 31786}, {8740, 31581},
+{9512, 31357}, {10278, 31114},
+{11039, 30853}, {11793, 30573},
+{12540, 30274}, {13279, 29957},
+{14010, 29622}, {14733, 29270},
+{15447, 28899}, {16151, 28511},
+{16846, 28106}, {17531, 27685},
+{18205, 27246}, {18868, 26791},
+{19520, 26320}, {20160, 25833},
+{20788, 25330}, {21403, 24813},
+{22006, 24280}, {22595, 23732},
+{23171, 23171}, {23732, 22595},
+{24280, 22006}, {24813, 21403},
+{25330, 20788}, {25833, 20160},
+{26320, 19520}, {26791, 18868},
+{27246, 18205}, {27685, 17531},
+{28106, 16846}, {28511, 16151},
+{28899, 15447}, {29270, 14733},
+{29622, 14010}, {29957, 13279},
+{30274, 12540}, {30573, 11793},
+{30853, 11039}, {31114, 10278},
+{31357, 9512}, {31581, 8740},
+{31786, 7962}, {31972, 7180},
+{32138, 6393}, {32286, 5602},
+{32413, 4809}, {32522, 4012},
+{32610, 3212}, {32679, 2410},
+{32729, 1609}, {32758, 804},
+};
+#ifndef FFT_BITREV256
+#define FFT_BITREV256
+static const opus_int16 fft_bitrev256[256] = {
+0, 64, 128, 192, 16, 80, 144, 208, 32, 96, 160, 224, 48, 112, 176,
+240, 4, 68, 132, 196, 20, 84, 148, 212, 36, 100, 164, 228, 52, 116,
+180, 244, 8, 72, 136, 200, 24, 88, 152, 216, 40, 104, 168, 232, 56,
+120, 184, 248, 12, 76, 140, 204, 28, 92, 156, 220, 44, 108, 172, 236,
+60, 124, 188, 252, 1, 65, 129, 193, 17, 81, 145, 209, 33, 97, 161,
+225, 49, 113, 177, 241, 5, 69, 133, 197, 21, 85, 149, 213, 37, 101,
+165, 229, 53, 117, 181, 245, 9, 73, 137, 201, 25, 89, 153, 217, 41,
+105, 169, 233, 57, 121, 185, 249, 13, 77, 141, 205, 29, 93, 157, 221,
+45, 109, 173, 237, 61, 125, 189, 253, 2, 66, 130, 194, 18, 82, 146,
+210, 34, 98, 162, 226, 50, 114, 178, 242, 6, 70, 134, 198, 22, 86,
+150, 214, 38, 102, 166, 230, 54, 118, 182, 246, 10, 74, 138, 202, 26,
+90, 154, 218, 42, 106, 170, 234, 58, 122, 186, 250, 14, 78, 142, 206,
+30, 94, 158, 222, 46, 110, 174, 238, 62, 126, 190, 254, 3, 67, 131,
+195, 19, 83, 147, 211, 35, 99, 163, 227, 51, 115, 179, 243, 7, 71,
+135, 199, 23, 87, 151, 215, 39, 103, 167, 231, 55, 119, 183, 247, 11,
+75, 139, 203, 27, 91, 155, 219, 43, 107, 171, 235, 59, 123, 187, 251,
+15, 79, 143, 207, 31, 95, 159, 223, 47, 111, 175, 239, 63, 127, 191,
+255, };
+#endif
+
+#ifndef FFT_BITREV128
+#define FFT_BITREV128
+static const opus_int16 fft_bitrev128[128] = {
+0, 32, 64, 96, 8, 40, 72, 104, 16, 48, 80, 112, 24, 56, 88,
+120, 2, 34, 66, 98, 10, 42, 74, 106, 18, 50, 82, 114, 26, 58,
+90, 122, 4, 36, 68, 100, 12, 44, 76, 108, 20, 52, 84, 116, 28,
+60, 92, 124, 6, 38, 70, 102, 14, 46, 78, 110, 22, 54, 86, 118,
+30, 62, 94, 126, 1, 33, 65, 97, 9, 41, 73, 105, 17, 49, 81,
+113, 25, 57, 89, 121, 3, 35, 67, 99, 11, 43, 75, 107, 19, 51,
+83, 115, 27, 59, 91, 123, 5, 37, 69, 101, 13, 45, 77, 109, 21,
+53, 85, 117, 29, 61, 93, 125, 7, 39, 71, 103, 15, 47, 79, 111,
+23, 55, 87, 119, 31, 63, 95, 127, };
+#endif
+
+#ifndef FFT_BITREV64
+#define FFT_BITREV64
+static const opus_int16 fft_bitrev64[64] = {
+0, 16, 32, 48, 4, 20, 36, 52, 8, 24, 40, 56, 12, 28, 44,
+60, 1, 17, 33, 49, 5, 21, 37, 53, 9, 25, 41, 57, 13, 29,
+45, 61, 2, 18, 34, 50, 6, 22, 38, 54, 10, 26, 42, 58, 14,
+30, 46, 62, 3, 19, 35, 51, 7, 23, 39, 55, 11, 27, 43, 59,
+15, 31, 47, 63, };
+#endif
+
+#ifndef FFT_STATE48000_512_0
+#define FFT_STATE48000_512_0
+static const kiss_fft_state fft_state48000_512_0 = {
+256,    /* nfft */
+-1,     /* shift */
+{4, 64, 4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, },   /* factors */
+fft_bitrev256,  /* bitrev */
+fft_twiddles48000_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE48000_512_1
+#define FFT_STATE48000_512_1
+static const kiss_fft_state fft_state48000_512_1 = {
+128,    /* nfft */
+1,      /* shift */
+{4, 32, 4, 8, 4, 2, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev128,  /* bitrev */
+fft_twiddles48000_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE48000_512_2
+#define FFT_STATE48000_512_2
+static const kiss_fft_state fft_state48000_512_2 = {
+64,     /* nfft */
+2,      /* shift */
+{4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev64,   /* bitrev */
+fft_twiddles48000_512,  /* bitrev */
+};
+#endif
+
+#endif
+
+#ifndef MDCT_TWIDDLES512
+#define MDCT_TWIDDLES512
+static const opus_val16 mdct_twiddles512[257] = {
+32767, 32767, 32766, 32762, 32758,
+32752, 32746, 32737, 32729, 32717,
+32706, 32693, 32679, 32663, 32647,
+32629, 32610, 32589, 32568, 32545,
+32522, 32496, 32470, 32442, 32413,
+32383, 32352, 32319, 32286, 32250,
+32214, 32176, 32138, 32098, 32058,
+32015, 31972, 31927, 31881, 31834,
+31786, 31736, 31686, 31634, 31581,
+31526, 31472, 31414, 31357, 31298,
+31238, 31176, 31114, 31050, 30986,
+30919, 30853, 30784, 30715, 30644,
+30573, 30499, 30426, 30350, 30274,
+30196, 30118, 30037, 29957, 29875,
+29792, 29707, 29622, 29535, 29448,
+29359, 29270, 29178, 29087, 28993,
+28899, 28803, 28707, 28609, 28511,
+28411, 28311, 28209, 28106, 28002,
+27898, 27791, 27685, 27576, 27467,
+27357, 27246, 27133, 27020, 26906,
+26791, 26674, 26557, 26439, 26320,
+26199, 26078, 25956, 25833, 25708,
+25584, 25457, 25330, 25202, 25073,
+24943, 24813, 24680, 24548, 24414,
+24280, 24144, 24008, 23870, 23732,
+23593, 23453, 23312, 23171, 23027,
+22885, 22740, 22595, 22449, 22302,
+22154, 22006, 21856, 21706, 21555,
+21403, 21250, 21097, 20943, 20788,
+20632, 20476, 20318, 20160, 20001,
+19842, 19681, 19520, 19358, 19195,
+19032, 18868, 18703, 18538, 18371,
+18205, 18037, 17869, 17700, 17531,
+17360, 17190, 17018, 16846, 16673,
+16500, 16326, 16151, 15975, 15800,
+15623, 15447, 15269, 15091, 14912,
+14733, 14552, 14373, 14191, 14010,
+13828, 13646, 13462, 13279, 13095,
+12910, 12725, 12540, 12353, 12167,
+11980, 11793, 11605, 11417, 11228,
+11039, 10849, 10660, 10469, 10278,
+10088, 9896, 9704, 9512, 9319,
+9127, 8933, 8740, 8545, 8352,
+8156, 7962, 7767, 7572, 7375,
+7180, 6983, 6787, 6589, 6393,
+6195, 5998, 5800, 5602, 5404,
+5206, 5007, 4809, 4609, 4411,
+4210, 4012, 3811, 3612, 3411,
+3212, 3012, 2812, 2611, 2410,
+2210, 2010, 1809, 1609, 1407,
+1206, 1005, 804, 603, 403,
+200, 0, };
+#endif
+
+static const CELTMode mode48000_512_128 = {
+48000,  /* Fs */
+128,    /* overlap */
+22,     /* nbEBands */
+22,     /* effEBands */
+{27853, 0, 4096, 8192, },       /* preemph */
+eBands48000_512,        /* eBands */
+2,      /* maxLM */
+4,      /* nbShortMdcts */
+128,    /* shortMdctSize */
+11,     /* nbAllocVectors */
+allocVectors48000_512,  /* allocVectors */
+logN375,        /* logN */
+window128,      /* window */
+{1024, 2, {&fft_state48000_512_0, &fft_state48000_512_1, &fft_state48000_512_2, }, mdct_twiddles512},   /* mdct */
+{467, cache_index93, cache_bits93, cache_caps93},       /* cache */
+};
+static const opus_int16 eBands44100_512[24] = {
+0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 18, 22, 26, 32, 38, 46, 56, 70, 90, 116, 0, };
+
+#ifndef DEF_WINDOW128
+#define DEF_WINDOW128
+static const opus_val16 window128[128] = {
+2, 17, 48, 95, 157,
+234, 327, 435, 558, 696,
+850, 1018, 1201, 1399, 1612,
+1839, 2080, 2336, 2605, 2888,
+3184, 3494, 3817, 4152, 4500,
+4860, 5232, 5615, 6009, 6415,
+6830, 7255, 7690, 8134, 8587,
+9047, 9516, 9991, 10473, 10961,
+11454, 11953, 12456, 12962, 13472,
+13984, 14498, 15014, 15530, 16047,
+16562, 17077, 17590, 18101, 18608,
+19112, 19612, 20107, 20597, 21080,
+21558, 22028, 22491, 22946, 23393,
+23831, 24259, 24678, 25087, 25486,
+25874, 26251, 26617, 26972, 27315,
+27647, 27966, 28274, 28570, 28854,
+29126, 29386, 29634, 29871, 30095,
+30308, 30510, 30701, 30880, 31049,
+31208, 31356, 31494, 31623, 31742,
+31853, 31955, 32048, 32134, 32212,
+32283, 32348, 32406, 32458, 32504,
+32545, 32581, 32613, 32640, 32664,
+32685, 32702, 32716, 32728, 32738,
+32746, 32752, 32757, 32761, 32763,
+32765, 32766, 32767, 32767, 32767,
+32767, 32767, 32767, };
+#endif
+
+static const unsigned char allocVectors44100_512[242] = {
+ 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 
+90, 81, 76, 71, 66, 60, 54, 48, 40, 32, 27, 19, 18, 11,  2,  0,  0,  0,  0,  0,  0,  0, 
+110, 101, 92, 86, 81, 75, 69, 64, 58, 49, 43, 38, 32, 27, 21, 15,  1,  0,  0,  0,  0,  0, 
+118, 111, 104, 97, 89, 84, 79, 74, 70, 63, 57, 52, 47, 41, 33, 26, 15,  6,  0,  0,  0,  0, 
+126, 119, 113, 107, 99, 93, 87, 82, 78, 70, 64, 59, 54, 48, 41, 34, 25, 18, 12,  0,  0,  0, 
+134, 127, 121, 116, 109, 101, 95, 90, 85, 76, 70, 65, 60, 55, 48, 43, 35, 30, 23, 15,  9,  1, 
+144, 137, 131, 126, 119, 111, 105, 100, 95, 86, 80, 75, 70, 65, 58, 53, 45, 40, 33, 25, 14,  1, 
+152, 145, 139, 134, 127, 121, 115, 110, 105, 96, 90, 85, 80, 75, 68, 63, 55, 50, 43, 35, 19,  1, 
+162, 155, 149, 144, 137, 131, 125, 120, 115, 106, 100, 95, 90, 85, 78, 73, 65, 60, 53, 45, 29,  1, 
+172, 165, 159, 154, 147, 141, 135, 130, 125, 116, 110, 105, 100, 95, 88, 83, 75, 70, 63, 55, 44, 20, 
+200, 200, 200, 200, 200, 200, 200, 200, 200, 196, 192, 187, 183, 179, 174, 170, 163, 159, 153, 147, 128, 104, 
+};
+
+#ifndef DEF_LOGN344
+#define DEF_LOGN344
+static const opus_int16 logN344[22] = {
+0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 16, 16, 21, 21, 24, 27, 31, 35, 38, };
+#endif
+
+#ifndef DEF_PULSE_CACHE86
+#define DEF_PULSE_CACHE86
+static const opus_int16 cache_index86[88] = {
+-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 41, 41,
+82, 82, 123, 164, 205, 235, 255, 0, 0, 0, 0, 0, 0, 0, 0,
+41, 41, 41, 41, 41, 123, 123, 271, 271, 307, 235, 333, 347, 358, 41,
+41, 41, 41, 41, 41, 41, 41, 123, 123, 123, 123, 123, 307, 307, 367,
+367, 384, 347, 397, 406, 414, 123, 123, 123, 123, 123, 123, 123, 123, 307,
+307, 307, 307, 307, 384, 384, 421, 421, 431, 406, 439, 446, 452, };
+static const unsigned char cache_bits86[458] = {
+40, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 40, 15, 23, 28,
+31, 34, 36, 38, 39, 41, 42, 43, 44, 45, 46, 47, 47, 49, 50,
+51, 52, 53, 54, 55, 55, 57, 58, 59, 60, 61, 62, 63, 63, 65,
+66, 67, 68, 69, 70, 71, 71, 40, 20, 33, 41, 48, 53, 57, 61,
+64, 66, 69, 71, 73, 75, 76, 78, 80, 82, 85, 87, 89, 91, 92,
+94, 96, 98, 101, 103, 105, 107, 108, 110, 112, 114, 117, 119, 121, 123,
+124, 126, 128, 40, 23, 39, 51, 60, 67, 73, 79, 83, 87, 91, 94,
+97, 100, 102, 105, 107, 111, 115, 118, 121, 124, 126, 129, 131, 135, 139,
+142, 145, 148, 150, 153, 155, 159, 163, 166, 169, 172, 174, 177, 179, 40,
+26, 45, 59, 70, 79, 87, 94, 100, 105, 110, 114, 118, 122, 125, 128,
+131, 136, 141, 146, 150, 153, 157, 160, 163, 168, 173, 178, 182, 185, 189,
+192, 195, 200, 205, 210, 214, 217, 221, 224, 227, 29, 30, 52, 70, 85,
+98, 109, 118, 126, 134, 141, 147, 153, 158, 163, 168, 172, 180, 188, 194,
+200, 205, 211, 215, 220, 228, 235, 242, 248, 253, 19, 34, 61, 83, 101,
+118, 132, 145, 157, 167, 177, 186, 194, 202, 209, 216, 222, 234, 245, 254,
+15, 37, 67, 92, 113, 133, 150, 165, 180, 193, 205, 216, 227, 237, 246,
+254, 35, 28, 49, 65, 78, 89, 99, 107, 114, 120, 126, 132, 136, 141,
+145, 149, 153, 159, 165, 171, 176, 180, 185, 189, 192, 199, 205, 211, 216,
+220, 225, 229, 232, 239, 245, 251, 25, 31, 55, 75, 91, 105, 117, 128,
+138, 146, 154, 161, 168, 174, 180, 185, 190, 200, 208, 215, 222, 229, 235,
+240, 245, 255, 13, 38, 68, 94, 117, 137, 155, 171, 186, 200, 213, 225,
+236, 247, 10, 42, 77, 107, 133, 157, 179, 200, 219, 236, 253, 8, 45,
+83, 116, 145, 172, 197, 221, 242, 16, 36, 65, 89, 110, 128, 144, 159,
+173, 185, 196, 207, 217, 226, 234, 242, 250, 12, 39, 71, 99, 123, 144,
+164, 182, 198, 214, 228, 241, 253, 8, 46, 84, 118, 149, 177, 202, 227,
+249, 7, 50, 93, 131, 165, 197, 227, 255, 6, 53, 99, 140, 177, 212,
+245, 9, 44, 81, 113, 142, 168, 192, 214, 235, 255, 7, 47, 87, 123,
+155, 184, 212, 237, 6, 54, 100, 142, 181, 217, 250, 5, 58, 109, 155,
+197, 237, 5, 61, 115, 164, 209, 252, };
+static const unsigned char cache_caps86[132] = {
+224, 224, 224, 224, 224, 224, 224, 224, 160, 160, 160, 160, 160, 185, 185,
+178, 178, 168, 159, 105, 49, 21, 224, 224, 224, 224, 224, 224, 224, 224,
+240, 240, 240, 240, 240, 207, 207, 198, 198, 183, 171, 110, 53, 24, 160,
+160, 160, 160, 160, 160, 160, 160, 185, 185, 185, 185, 185, 193, 193, 183,
+183, 172, 163, 106, 51, 23, 240, 240, 240, 240, 240, 240, 240, 240, 207,
+207, 207, 207, 207, 204, 204, 193, 193, 180, 167, 110, 54, 24, 185, 185,
+185, 185, 185, 185, 185, 185, 193, 193, 193, 193, 193, 193, 193, 183, 183,
+172, 163, 107, 52, 23, 207, 207, 207, 207, 207, 207, 207, 207, 204, 204,
+204, 204, 204, 201, 201, 188, 188, 176, 166, 109, 53, 24, };
+#endif
+
+#ifndef FFT_TWIDDLES44100_512
+#define FFT_TWIDDLES44100_512
+static const kiss_twiddle_cpx fft_twiddles44100_512[256] = {
+{32767, 0}, {32758, -804},
+{32729, -1609}, {32679, -2410},
+{32610, -3212}, {32522, -4012},
+{32413, -4809}, {32286, -5602},
+{32138, -6393}, {31972, -7180},
+{31786, -7962}, {31581, -8740},
+{31357, -9512}, {31114, -10278},
+{30853, -11039}, {30573, -11793},
+{30274, -12540}, {29957, -13279},
+{29622, -14010}, {29270, -14733},
+{28899, -15447}, {28511, -16151},
+{28106, -16846}, {27685, -17531},
+{27246, -18205}, {26791, -18868},
+{26320, -19520}, {25833, -20160},
+{25330, -20788}, {24813, -21403},
+{24280, -22006}, {23732, -22595},
+{23171, -23171}, {22595, -23732},
+{22006, -24280}, {21403, -24813},
+{20788, -25330}, {20160, -25833},
+{19520, -26320}, {18868, -26791},
+{18205, -27246}, {17531, -27685},
+{16846, -28106}, {16151, -28511},
+{15447, -28899}, {14733, -29270},
+{14010, -29622}, {13279, -29957},
+{12540, -30274}, {11793, -30573},
+{11039, -30853}, {10278, -31114},
+{9512, -31357}, {8740, -31581},
+{7962, -31786}, {7180, -31972},
+{6393, -32138}, {5602, -32286},
+{4809, -32413}, {4012, -32522},
+{3212, -32610}, {2410, -32679},
+{1609, -32729}, {804, -32758},
+{0, -32767}, {-804, -32758},
+{-1609, -32729}, {-2410, -32679},
+{-3212, -32610}, {-4012, -32522},
+{-4809, -32413}, {-5602, -32286},
+{-6393, -32138}, {-7180, -31972},
+{-7962, -31786}, {-8740, -31581},
+{-9512, -31357}, {-10278, -31114},
+{-11039, -30853}, {-11793, -30573},
+{-12540, -30274}, {-13279, -29957},
+{-14010, -29622}, {-14733, -29270},
+{-15447, -28899}, {-16151, -28511},
+{-16846, -28106}, {-17531, -27685},
+{-18205, -27246}, {-18868, -26791},
+{-19520, -26320}, {-20160, -25833},
+{-20788, -25330}, {-21403, -24813},
+{-22006, -24280}, {-22595, -23732},
+{-23171, -23171}, {-23732, -22595},
+{-24280, -22006}, {-24813, -21403},
+{-25330, -20788}, {-25833, -20160},
+{-26320, -19520}, {-26791, -18868},
+{-27246, -18205}, {-27685, -17531},
+{-28106, -16846}, {-28511, -16151},
+{-28899, -15447}, {-29270, -14733},
+{-29622, -14010}, {-29957, -13279},
+{-30274, -12540}, {-30573, -11793},
+{-30853, -11039}, {-31114, -10278},
+{-31357, -9512}, {-31581, -8740},
+{-31786, -7962}, {-31972, -7180},
+{-32138, -6393}, {-32286, -5602},
+{-32413, -4809}, {-32522, -4012},
+{-32610, -3212}, {-32679, -2410},
+{-32729, -1609}, {-32758, -804},
+{-32767, 0}, {-32758, 804},
+{-32729, 1609}, {-32679, 2410},
+{-32610, 3212}, {-32522, 4012},
+{-32413, 4809}, {-32286, 5602},
+{-32138, 6393}, {-31972, 7180},
+{-31786, 7962}, {-31581, 8740},
+{-31357, 9512}, {-31114, 10278},
+{-30853, 11039}, {-30573, 11793},
+{-30274, 12540}, {-29957, 13279},
+{-29622, 14010}, {-29270, 14733},
+{-28899, 15447}, {-28511, 16151},
+{-28106, 16846}, {-27685, 17531},
+{-27246, 18205}, {-26791, 18868},
+{-26320, 19520}, {-25833, 20160},
+{-25330, 20788}, {-24813, 21403},
+{-24280, 22006}, {-23732, 22595},
+{-23171, 23171}, {-22595, 23732},
+{-22006, 24280}, {-21403, 24813},
+{-20788, 25330}, {-20160, 25833},
+{-19520, 26320}, {-18868, 26791},
+{-18205, 27246}, {-17531, 27685},
+{-16846, 28106}, {-16151, 28511},
+{-15447, 28899}, {-14733, 29270},
+{-14010, 29622}, {-13279, 29957},
+{-12540, 30274}, {-11793, 30573},
+{-11039, 30853}, {-10278, 31114},
+{-9512, 31357}, {-8740, 31581},
+{-7962, 31786}, {-7180, 31972},
+{-6393, 32138}, {-5602, 32286},
+{-4809, 32413}, {-4012, 32522},
+{-3212, 32610}, {-2410, 32679},
+{-1609, 32729}, {-804, 32758},
+{0, 32767}, {804, 32758},
+{1609, 32729}, {2410, 32679},
+{3212, 32610}, {4012, 32522},
+{4809, 32413}, {5602, 32286},
+{6393, 32138}, {7180, 31972},
+{7962, 31786}, {8740, 31581},
+{9512, 31357}, {10278, 31114},
+{11039, 30853}, {11793, 30573},
+{12540, 30274}, {13279, 29957},
+{14010, 29622}, {14733, 29270},
+{15447, 28899}, {16151, 28511},
+{16846, 28106}, {17531, 27685},
+{18205, 27246}, {18868, 26791},
+{19520, 26320}, {20160, 25833},
+{20788, 25330}, {21403, 24813},
+{22006, 24280}, {22595, 23732},
+{23171, 23171}, {23732, 22595},
+{24280, 22006}, {24813, 21403},
+{25330, 20788}, {25833, 20160},
+{26320, 19520}, {26791, 18868},
+{27246, 18205}, {27685, 17531},
+{28106, 16846}, {28511, 16151},
+{28899, 15447}, {29270, 14733},
+{29622, 14010}, {29957, 13279},
+{30274, 12540}, {30573, 11793},
+{30853, 11039}, {31114, 10278},
+{31357, 9512}, {31581, 8740},
+{31786, 7962}, {31972, 7180},
+{32138, 6393}, {32286, 5602},
+{32413, 4809}, {32522, 4012},
+{32610, 3212}, {32679, 2410},
+{32729, 1609}, {32758, 804},
+};
+#ifndef FFT_BITREV256
+#define FFT_BITREV256
+static const opus_int16 fft_bitrev256[256] = {
+0, 64, 128, 192, 16, 80, 144, 208, 32, 96, 160, 224, 48, 112, 176,
+240, 4, 68, 132, 196, 20, 84, 148, 212, 36, 100, 164, 228, 52, 116,
+180, 244, 8, 72, 136, 200, 24, 88, 152, 216, 40, 104, 168, 232, 56,
+120, 184, 248, 12, 76, 140, 204, 28, 92, 156, 220, 44, 108, 172, 236,
+60, 124, 188, 252, 1, 65, 129, 193, 17, 81, 145, 209, 33, 97, 161,
+225, 49, 113, 177, 241, 5, 69, 133, 197, 21, 85, 149, 213, 37, 101,
+165, 229, 53, 117, 181, 245, 9, 73, 137, 201, 25, 89, 153, 217, 41,
+105, 169, 233, 57, 121, 185, 249, 13, 77, 141, 205, 29, 93, 157, 221,
+45, 109, 173, 237, 61, 125, 189, 253, 2, 66, 130, 194, 18, 82, 146,
+210, 34, 98, 162, 226, 50, 114, 178, 242, 6, 70, 134, 198, 22, 86,
+150, 214, 38, 102, 166, 230, 54, 118, 182, 246, 10, 74, 138, 202, 26,
+90, 154, 218, 42, 106, 170, 234, 58, 122, 186, 250, 14, 78, 142, 206,
+30, 94, 158, 222, 46, 110, 174, 238, 62, 126, 190, 254, 3, 67, 131,
+195, 19, 83, 147, 211, 35, 99, 163, 227, 51, 115, 179, 243, 7, 71,
+135, 199, 23, 87, 151, 215, 39, 103, 167, 231, 55, 119, 183, 247, 11,
+75, 139, 203, 27, 91, 155, 219, 43, 107, 171, 235, 59, 123, 187, 251,
+15, 79, 143, 207, 31, 95, 159, 223, 47, 111, 175, 239, 63, 127, 191,
+255, };
+#endif
+
+#ifndef FFT_BITREV128
+#define FFT_BITREV128
+static const opus_int16 fft_bitrev128[128] = {
+0, 32, 64, 96, 8, 40, 72, 104, 16, 48, 80, 112, 24, 56, 88,
+120, 2, 34, 66, 98, 10, 42, 74, 106, 18, 50, 82, 114, 26, 58,
+90, 122, 4, 36, 68, 100, 12, 44, 76, 108, 20, 52, 84, 116, 28,
+60, 92, 124, 6, 38, 70, 102, 14, 46, 78, 110, 22, 54, 86, 118,
+30, 62, 94, 126, 1, 33, 65, 97, 9, 41, 73, 105, 17, 49, 81,
+113, 25, 57, 89, 121, 3, 35, 67, 99, 11, 43, 75, 107, 19, 51,
+83, 115, 27, 59, 91, 123, 5, 37, 69, 101, 13, 45, 77, 109, 21,
+53, 85, 117, 29, 61, 93, 125, 7, 39, 71, 103, 15, 47, 79, 111,
+23, 55, 87, 119, 31, 63, 95, 127, };
+#endif
+
+#ifndef FFT_BITREV64
+#define FFT_BITREV64
+static const opus_int16 fft_bitrev64[64] = {
+0, 16, 32, 48, 4, 20, 36, 52, 8, 24, 40, 56, 12, 28, 44,
+60, 1, 17, 33, 49, 5, 21, 37, 53, 9, 25, 41, 57, 13, 29,
+45, 61, 2, 18, 34, 50, 6, 22, 38, 54, 10, 26, 42, 58, 14,
+30, 46, 62, 3, 19, 35, 51, 7, 23, 39, 55, 11, 27, 43, 59,
+15, 31, 47, 63, };
+#endif
+
+#ifndef FFT_STATE44100_512_0
+#define FFT_STATE44100_512_0
+static const kiss_fft_state fft_state44100_512_0 = {
+256,    /* nfft */
+-1,     /* shift */
+{4, 64, 4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, },   /* factors */
+fft_bitrev256,  /* bitrev */
+fft_twiddles44100_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE44100_512_1
+#define FFT_STATE44100_512_1
+static const kiss_fft_state fft_state44100_512_1 = {
+128,    /* nfft */
+1,      /* shift */
+{4, 32, 4, 8, 4, 2, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev128,  /* bitrev */
+fft_twiddles44100_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE44100_512_2
+#define FFT_STATE44100_512_2
+static const kiss_fft_state fft_state44100_512_2 = {
+64,     /* nfft */
+2,      /* shift */
+{4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev64,   /* bitrev */
+fft_twiddles44100_512,  /* bitrev */
+};
+#endif
+
+#endif
+
+#ifndef MDCT_TWIDDLES512
+#define MDCT_TWIDDLES512
+static const opus_val16 mdct_twiddles512[257] = {
+32767, 32767, 32766, 32762, 32758,
+32752, 32746, 32737, 32729, 32717,
+32706, 32693, 32679, 32663, 32647,
+32629, 32610, 32589, 32568, 32545,
+32522, 32496, 32470, 32442, 32413,
+32383, 32352, 32319, 32286, 32250,
+32214, 32176, 32138, 32098, 32058,
+32015, 31972, 31927, 31881, 31834,
+31786, 31736, 31686, 31634, 31581,
+31526, 31472, 31414, 31357, 31298,
+31238, 31176, 31114, 31050, 30986,
+30919, 30853, 30784, 30715, 30644,
+30573, 30499, 30426, 30350, 30274,
+30196, 30118, 30037, 29957, 29875,
+29792, 29707, 29622, 29535, 29448,
+29359, 29270, 29178, 29087, 28993,
+28899, 28803, 28707, 28609, 28511,
+28411, 28311, 28209, 28106, 28002,
+27898, 27791, 27685, 27576, 27467,
+27357, 27246, 27133, 27020, 26906,
+26791, 26674, 26557, 26439, 26320,
+26199, 26078, 25956, 25833, 25708,
+25584, 25457, 25330, 25202, 25073,
+24943, 24813, 24680, 24548, 24414,
+24280, 24144, 24008, 23870, 23732,
+23593, 23453, 23312, 23171, 23027,
+22885, 22740, 22595, 22449, 22302,
+22154, 22006, 21856, 21706, 21555,
+21403, 21250, 21097, 20943, 20788,
+20632, 20476, 20318, 20160, 20001,
+19842, 19681, 19520, 19358, 19195,
+19032, 18868, 18703, 18538, 18371,
+18205, 18037, 17869, 17700, 17531,
+17360, 17190, 17018, 16846, 16673,
+16500, 16326, 16151, 15975, 15800,
+15623, 15447, 15269, 15091, 14912,
+14733, 14552, 14373, 14191, 14010,
+13828, 13646, 13462, 13279, 13095,
+12910, 12725, 12540, 12353, 12167,
+11980, 11793, 11605, 11417, 11228,
+11039, 10849, 10660, 10469, 10278,
+10088, 9896, 9704, 9512, 9319,
+9127, 8933, 8740, 8545, 8352,
+8156, 7962, 7767, 7572, 7375,
+7180, 6983, 6787, 6589, 6393,
+6195, 5998, 5800, 5602, 5404,
+5206, 5007, 4809, 4609, 4411,
+4210, 4012, 3811, 3612, 3411,
+3212, 3012, 2812, 2611, 2410,
+2210, 2010, 1809, 1609, 1407,
+1206, 1005, 804, 603, 403,
+200, 0, };
+#endif
+
+static const CELTMode mode44100_512_128 = {
+44100,  /* Fs */
+128,    /* overlap */
+22,     /* nbEBands */
+22,     /* effEBands */
+{27853, 0, 4096, 8192, },       /* preemph */
+eBands44100_512,        /* eBands */
+2,      /* maxLM */
+4,      /* nbShortMdcts */
+128,    /* shortMdctSize */
+11,     /* nbAllocVectors */
+allocVectors44100_512,  /* allocVectors */
+logN344,        /* logN */
+window128,      /* window */
+{1024, 2, {&fft_state44100_512_0, &fft_state44100_512_1, &fft_state44100_512_2, }, mdct_twiddles512},   /* mdct */
+{458, cache_index86, cache_bits86, cache_caps86},       /* cache */
+};
+
+/* List of all the available custom modes */
+#define TOTAL_CUSTOM_MODES 2
+static const CELTMode * const static_custom_mode_list[TOTAL_CUSTOM_MODES] = {
+&mode48000_512_128,
+&mode44100_512_128,
+};
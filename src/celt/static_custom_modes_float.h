@@ -0,0 +1,813 @@
+/* The contents of this file was automatically generated by dump_modes.c
+   with arguments: 48000 512 44100 512
+   It contains static definitions for the Opus Custom modes built into
+   CUSTOM_MODES builds. It must be included after static_modes_*.h.
+   To refresh it, or to embed a different set of modes, run make in
+   src/celt/dump_modes, e.g. make MODES="48000 512 44100 512". */
+#include "modes.h"
+#include "rate.h"
+
+static const opus_int16 eBands48000_512[24] = {
+0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 18, 20, 24, 28, 34, 40, 50, 64, 82, 106, 0, };
+
+#ifndef DEF_WINDOW128
+#define DEF_WINDOW128
+static const opus_val16 window128[128] = {
+5.91390381e-05f, 0.000532197882f, 0.00147803011f, 0.00289606350f, 0.00478543621f,
+0.00714499271f, 0.00997327734f, 0.0132685294f, 0.0170286745f, 0.0212513115f,
+0.0259337109f, 0.0310727954f, 0.0366651304f, 0.0427069142f, 0.0491939597f,
+0.0561216921f, 0.0634851083f, 0.0712788031f, 0.0794969127f, 0.0881331414f,
+0.0971807018f, 0.106632352f, 0.116480343f, 0.126716435f, 0.137331858f,
+0.148317337f, 0.159663051f, 0.171358675f, 0.183393300f, 0.195755512f,
+0.208433345f, 0.221414253f, 0.234685227f, 0.248232663f, 0.262042463f,
+0.276100039f, 0.290390283f, 0.304897606f, 0.319605947f, 0.334498882f,
+0.349559516f, 0.364770591f, 0.380114466f, 0.395573229f, 0.411128700f,
+0.426762402f, 0.442455709f, 0.458189756f, 0.473945677f, 0.489704460f,
+0.505447090f, 0.521154583f, 0.536808074f, 0.552388728f, 0.567878008f,
+0.583257556f, 0.598509252f, 0.613615453f, 0.628558755f, 0.643322289f,
+0.657889605f, 0.672244906f, 0.686372936f, 0.700258911f, 0.713888943f,
+0.727249742f, 0.740328789f, 0.753114343f, 0.765595496f, 0.777762115f,
+0.789605021f, 0.801115870f, 0.812287271f, 0.823112726f, 0.833586633f,
+0.843704402f, 0.853462279f, 0.862857580f, 0.871888459f, 0.880554080f,
+0.888854384f, 0.896790385f, 0.904363751f, 0.911577284f, 0.918434441f,
+0.924939454f, 0.931097448f, 0.936914146f, 0.942396164f, 0.947550535f,
+0.952385128f, 0.956908286f, 0.961128891f, 0.965056360f, 0.968700469f,
+0.972071409f, 0.975179851f, 0.978036582f, 0.980652750f, 0.983039618f,
+0.985208690f, 0.987171590f, 0.988939822f, 0.990525067f, 0.991939008f,
+0.993192971f, 0.994298518f, 0.995266736f, 0.996108711f, 0.996835113f,
+0.997456431f, 0.997982800f, 0.998423934f, 0.998789251f, 0.999087632f,
+0.999327600f, 0.999517143f, 0.999663651f, 0.999774158f, 0.999854982f,
+0.999911964f, 0.999950290f, 0.999974489f, 0.999988556f, 0.999995828f,
+0.999998927f, 0.999999881f, 1.00000000f, };
+#endif
+
+static const unsigned char allocVectors48000_512[242] = {
+ 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 
+90, 80, 75, 70, 64, 58, 51, 43, 37, 30, 23, 18, 14,  7,  3,  0,  0,  0,  0,  0,  0,  0, 
+110, 100, 91, 85, 79, 73, 67, 61, 54, 46, 41, 35, 29, 24, 21, 15,  5,  0,  0,  0,  0,  0, 
+118, 110, 103, 94, 87, 81, 76, 72, 67, 60, 55, 49, 43, 38, 33, 26, 18,  7,  1,  0,  0,  0, 
+126, 119, 112, 105, 97, 90, 85, 80, 75, 67, 62, 56, 50, 45, 41, 34, 28, 19, 14,  2,  0,  0, 
+134, 127, 120, 115, 105, 98, 93, 87, 81, 73, 68, 62, 57, 52, 49, 43, 37, 31, 25, 16, 10,  1, 
+144, 137, 130, 125, 115, 108, 103, 97, 91, 83, 78, 72, 67, 62, 59, 53, 47, 41, 35, 26, 15,  1, 
+152, 145, 138, 133, 125, 118, 113, 107, 101, 93, 88, 82, 77, 72, 69, 63, 57, 51, 45, 36, 20,  2, 
+162, 155, 148, 143, 135, 128, 123, 117, 111, 103, 98, 92, 87, 82, 79, 73, 67, 61, 55, 46, 30,  2, 
+172, 165, 158, 153, 145, 138, 133, 127, 121, 113, 108, 102, 97, 92, 89, 83, 77, 71, 65, 56, 45, 21, 
+200, 200, 200, 200, 200, 200, 200, 200, 199, 194, 189, 185, 180, 176, 174, 169, 165, 159, 155, 148, 129, 105, 
+};
+
+#ifndef DEF_LOGN375
+#define DEF_LOGN375
+static const opus_int16 logN375[22] = {
+0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 8, 16, 16, 21, 21, 27, 31, 34, 37, };
+#endif
+
+#ifndef DEF_PULSE_CACHE93
+#define DEF_PULSE_CACHE93
+static const opus_int16 cache_index93[88] = {
+-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 41,
+41, 82, 82, 123, 164, 194, 216, 0, 0, 0, 0, 0, 0, 0, 0,
+41, 41, 41, 41, 41, 41, 233, 233, 274, 274, 310, 330, 344, 356, 41,
+41, 41, 41, 41, 41, 41, 41, 233, 233, 233, 233, 233, 233, 366, 366,
+216, 216, 392, 403, 412, 420, 233, 233, 233, 233, 233, 233, 233, 233, 366,
+366, 366, 366, 366, 366, 427, 427, 356, 356, 440, 448, 455, 461, };
+static const unsigned char cache_bits93[467] = {
+40, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 40, 15, 23, 28,
+31, 34, 36, 38, 39, 41, 42, 43, 44, 45, 46, 47, 47, 49, 50,
+51, 52, 53, 54, 55, 55, 57, 58, 59, 60, 61, 62, 63, 63, 65,
+66, 67, 68, 69, 70, 71, 71, 40, 20, 33, 41, 48, 53, 57, 61,
+64, 66, 69, 71, 73, 75, 76, 78, 80, 82, 85, 87, 89, 91, 92,
+94, 96, 98, 101, 103, 105, 107, 108, 110, 112, 114, 117, 119, 121, 123,
+124, 126, 128, 40, 26, 45, 59, 70, 79, 87, 94, 100, 105, 110, 114,
+118, 122, 125, 128, 131, 136, 141, 146, 150, 153, 157, 160, 163, 168, 173,
+178, 182, 185, 189, 192, 195, 200, 205, 210, 214, 217, 221, 224, 227, 29,
+30, 52, 70, 85, 98, 109, 118, 126, 134, 141, 147, 153, 158, 163, 168,
+172, 180, 188, 194, 200, 205, 211, 215, 220, 228, 235, 242, 248, 253, 21,
+33, 58, 79, 97, 112, 125, 137, 148, 157, 166, 174, 182, 189, 195, 201,
+207, 217, 227, 235, 243, 251, 16, 36, 65, 89, 110, 128, 144, 159, 173,
+185, 196, 207, 217, 226, 234, 242, 250, 40, 23, 39, 51, 60, 67, 73,
+79, 83, 87, 91, 94, 97, 100, 102, 105, 107, 111, 115, 118, 121, 124,
+126, 129, 131, 135, 139, 142, 145, 148, 150, 153, 155, 159, 163, 166, 169,
+172, 174, 177, 179, 35, 28, 49, 65, 78, 89, 99, 107, 114, 120, 126,
+132, 136, 141, 145, 149, 153, 159, 165, 171, 176, 180, 185, 189, 192, 199,
+205, 211, 216, 220, 225, 229, 232, 239, 245, 251, 19, 34, 61, 83, 101,
+118, 132, 145, 157, 167, 177, 186, 194, 202, 209, 216, 222, 234, 245, 254,
+13, 38, 68, 94, 117, 137, 155, 171, 186, 200, 213, 225, 236, 247, 11,
+41, 74, 103, 128, 151, 172, 191, 209, 225, 241, 255, 9, 44, 81, 113,
+142, 168, 192, 214, 235, 255, 25, 31, 55, 75, 91, 105, 117, 128, 138,
+146, 154, 161, 168, 174, 180, 185, 190, 200, 208, 215, 222, 229, 235, 240,
+245, 255, 10, 42, 77, 107, 133, 157, 179, 200, 219, 236, 253, 8, 46,
+84, 118, 149, 177, 202, 227, 249, 7, 49, 90, 127, 160, 191, 220, 247,
+6, 52, 97, 137, 174, 208, 240, 12, 39, 71, 99, 123, 144, 164, 182,
+198, 214, 228, 241, 253, 7, 50, 93, 131, 165, 197, 227, 255, 6, 54,
+100, 142, 181, 217, 250, 5, 57, 106, 151, 192, 231, 5, 60, 113, 161,
+206, 248, };
+static const unsigned char cache_caps93[132] = {
+224, 224, 224, 224, 224, 224, 224, 224, 160, 160, 160, 160, 160, 160, 185,
+185, 178, 178, 159, 105, 61, 28, 224, 224, 224, 224, 224, 224, 224, 224,
+240, 240, 240, 240, 240, 240, 207, 207, 198, 198, 171, 110, 66, 30, 160,
+160, 160, 160, 160, 160, 160, 160, 185, 185, 185, 185, 185, 185, 193, 193,
+183, 183, 163, 106, 64, 29, 240, 240, 240, 240, 240, 240, 240, 240, 207,
+207, 207, 207, 207, 207, 204, 204, 193, 193, 167, 110, 66, 31, 185, 185,
+185, 185, 185, 185, 185, 185, 193, 193, 193, 193, 193, 193, 193, 193, 183,
+183, 163, 107, 65, 30, 207, 207, 207, 207, 207, 207, 207, 207, 204, 204,
+204, 204, 204, 204, 201, 201, 188, 188, 166, 109, 66, 31, };
+#endif
+
+#ifndef FFT_TWIDDLES48000_512
+#define FFT_TWIDDLES48000_512
+static const kiss_twiddle_cpx fft_twiddles48000_512[256] = {
+{1.00000000f, -0.00000000f}, {0.999698818f, -0.0245412290f},
+{0.998795450f, -0.0490676761f}, {0.997290432f, -0.0735645667f},
+{0.995184720f, -0.0980171412f}, {0.992479563f, -0.122410677f},
+{0.989176512f, -0.146730468f}, {0.985277653f, -0.170961887f},
+{0.980785251f, -0.195090324f}, {0.975702107f, -0.219101235f},
+{0.970031261f, -0.242980182f}, {0.963776052f, -0.266712755f},
+{0.956940353f, -0.290284663f}, {0.949528158f, -0.313681751f},
+{0.941544056f, -0.336889863f}, {0.932992816f, -0.359895051f},
+{0.923879504f, -0.382683426f}, {0.914209783f, -0.405241311f},
+{0.903989315f, -0.427555084f}, {0.893224299f, -0.449611336f},
+{0.881921291f, -0.471396744f}, {0.870086968f, -0.492898196f},
+{0.857728601f, -0.514102757f}, {0.844853580f, -0.534997642f},
+{0.831469595f, -0.555570245f}, {0.817584813f, -0.575808167f},
+{0.803207517f, -0.595699310f}, {0.788346410f, -0.615231574f},
+{0.773010433f, -0.634393275f}, {0.757208824f, -0.653172851f},
+{0.740951121f, -0.671558976f}, {0.724247098f, -0.689540565f},
+{0.707106769f, -0.707106769f}, {0.689540565f, -0.724247098f},
+{0.671558976f, -0.740951121f}, {0.653172851f, -0.757208824f},
+{0.634393275f, -0.773010433f}, {0.615231574f, -0.788346410f},
+{0.595699310f, -0.803207517f}, {0.575808167f, -0.817584813f},
+{0.555570245f, -0.831469595f}, {0.534997642f, -0.844853580f},
+{0.514102757f, -0.857728601f}, {0.492898196f, -0.870086968f},
+{0.471396744f, -0.881921291f}, {0.449611336f, -0.893224299f},
+{0.427555084f, -0.903989315f}, {0.405241311f, -0.914209783f},
+{0.382683426f, -0.923879504f}, {0.359895051f, -0.932992816f},
+{0.336889863f, -0.941544056f}, {0.313681751f, -0.949528158f},
+{0.290284663f, -0.956940353f}, {0.266712755f, -0.963776052f},
+{0.242980182f, -0.970031261f}, {0.219101235f, -0.975702107f},
+{0.195090324f, -0.980785251f}, {0.170961887f, -0.985277653f},
+{0.146730468f, -0.989176512f}, {0.122410677f, -0.992479563f},
+{0.0980171412f, -0.995184720f}, {0.0735645667f, -0.997290432f},
+{0.0490676761f, -0.998795450f}, {0.0245412290f, -0.999698818f},
+{6.12323426e-17f, -1.00000000f}, {-0.0245412290f, -0.999698818f},
+{-0.0490676761f, -0.998795450f}, {-0.0735645667f, -0.997290432f},
+{-0.0980171412f, -0.995184720f}, {-0.122410677f, -0.992479563f},
+{-0.146730468f, -0.989176512f}, {-0.170961887f, -0.985277653f},
+{-0.195090324f, -0.980785251f}, {-0.219101235f, -0.975702107f},
+{-0.242980182f, -0.970031261f}, {-0.266712755f, -0.963776052f},
+{-0.290284663f, -0.956940353f}, {-0.313681751f, -0.949528158f},
+{-0.336889863f, -0.941544056f}, {-0.359895051f, -0.932992816f},
+{-0.382683426f, -0.923879504f}, {-0.405241311f, -0.914209783f},
+{-0.427555084f, -0.903989315f}, {-0.449611336f, -0.893224299f},
+{-0.471396744f, -0.881921291f}, {-0.492898196f, -0.870086968f},
+{-0.514102757f, -0.857728601f}, {-0.534997642f, -0.844853580f},
+{-0.555570245f, -0.831469595f}, {-0.575808167f, -0.817584813f},
+{-0.595699310f, -0.803207517f}, {-0.615231574f, -0.788346410f},
+{-0.634393275f, -0.773010433f}, {-0.653172851f, -0.757208824f},
+{-0.671558976f, -0.740951121f}, {-0.689540565f, -0.724247098f},
+{-0.707106769f, -0.707106769f}, {-0.724247098f, -0.689540565f},
+{-0.740951121f, -0.671558976f}, {-0.757208824f, -0.653172851f},
+{-0.773010433f, -0.634393275f}, {-0.788346410f, -0.615231574f},
+{-0.803207517f, -0.595699310f}, {-0.817584813f, -0.575808167f},
+{-0.831469595f, -0.555570245f}, {-0.844853580f, -0.534997642f},
+{-0.857728601f, -0.514102757f}, {-0.870086968f, -0.492898196f},
+{-0.881921291f, -0.471396744f}, {-0.893224299f, -0.449611336f},
+{-0.903989315f, -0.427555084f}, {-0.914209783f, -0.405241311f},
+{-0.923879504f, -0.382683426f}, {-0.932992816f, -0.359895051f},
+{-0.941544056f, -0.336889863f}, {-0.949528158f, -0.313681751f},
+{-0.956940353f, -0.290284663f}, {-0.963776052f, -0.266712755f},
+{-0.970031261f, -0.242980182f}, {-0.975702107f, -0.219101235f},
+{-0.980785251f, -0.195090324f}, {-0.985277653f, -0.170961887f},
+{-0.989176512f, -0.146730468f}, {-0.992479563f, -0.122410677f},
+{-0.995184720f, -0.0980171412f}, {-0.997290432f, -0.0735645667f},
+{-0.998795450f, -0.0490676761f}, {-0.999698818f, -0.0245412290f},
+{-1.00000000f, -1.22464685e-16f}, {-0.999698818f, 0.0245412290f},
+{-0.998795450f, 0.0490676761f}, {-0.997290432f, 0.0735645667f},
+{-0.995184720f, 0.0980171412f}, {-0.992479563f, 0.122410677f},
+{-0.989176512f, 0.146730468f}, {-0.985277653f, 0.170961887f},
+{-0.980785251f, 0.195090324f}, {-0.975702107f, 0.219101235f},
+{-0.970031261f, 0.242980182f}, {-0.963776052f, 0.266712755f},
+{-0.956940353f, 0.290284663f}, {-0.949528158f, 0.313681751f},
+{-0.941544056f, 0.336889863f}, {-0.932992816f, 0.359895051f},
+{-0.923879504f, 0.382683426f}, {-0.914209783f, 0.405241311f},
+{-0.903989315f, 0.427555084f}, {-0.893224299f, 0.449611336f},
+{-0.881921291f, 0.471396744f}, {-0.870086968f, 0.492898196f},
+{-0.857728601f, 0.514102757f}, {-0.844853580f, 0.534997642f},
+{-0.831469595f, 0.555570245f}, {-0.817584813f, 0.575808167f},
+{-0.803207517f, 0.595699310f}, {-0.788346410f, 0.615231574f},
+{-0.773010433f, 0.634393275f}, {-0.757208824f, 0.653172851f},
+{-0.740951121f, 0.671558976f}, {-0.724247098f, 0.689540565f},
+{-0.707106769f, 0.707106769f}, {-0.689540565f, 0.724247098f},
+{-0.671558976f, 0.740951121f}, {-0.653172851f, 0.757208824f},
+{-0.634393275f, 0.773010433f}, {-0.615231574f, 0.788346410f},
+{-0.595699310f, 0.803207517f}, {-0.575808167f, 0.817584813f},
+{-0.555570245f, 0.831469595f}, {-0.534997642f, 0.844853580f},
+{-0.514102757f, 0.857728601f}, {-0.492898196f, 0.870086968f},
+{-0.471396744f, 0.881921291f}, {-0.449611336f, 0.893224299f},
+{-0.427555084f, 0.903989315f}, {-0.405241311f, 0.914209783f},
+{-0.382683426f, 0.923879504f}, {-0.359895051f, 0.932992816f},
+{-0.336889863f, 0.941544056f}, {-0.313681751f, 0.949528158f},
+{-0.290284663f, 0.956940353f}, {-0.266712755f, 0.963776052f},
+{-0.242980182f, 0.970031261f}, {-0.219101235f, 0.975702107f},
+{-0.195090324f, 0.980785251f}, {-0.170961887f, 0.985277653f},
+{-0.146730468f, 0.989176512f}, {-0.122410677f, 0.992479563f},
+{-0.0980171412f, 0.995184720f}, {-0.0735645667f, 0.997290432f},
+{-0.0490676761f, 0.998795450f}, {-0.0245412290f, 0.999698818f},
+{-1.83697015e-16f, 1.00000000f}, {0.0245412290f, 0.999698818f},
+{0.0490676761f, 0.998795450f}, {0.0735645667f, 0.997290432f},
+{0.0980171412f, 0.995184720f}, {0.122410677f, 0.992479563f},
+{0.146730468f, 0.989176512f}, {0.170961887f, 0.985277653f},
+{0.195090324f, 0.980785251f}, {0.219101235f, 0.975702107f},
+{0.242980182f, 0.970031261f}, {0.266712755f, 0.963776052f},
+{0.290284663f, 0.956940353f}, {0.313681751f, 0.949528158f},
+{0.336889863f, 0.941544056f}, {0.359895051f, 0.932992816f},
+{0.382683426f, 0.923879504f}, {0.405241311f, 0.914209783f},
+{0.427555084f, 0.903989315f}, {0.449611336f, 0.893224299f},
+{0.471396744f, 0.881921291f}, {0.492898196f, 0.870086968f},
+{0.514102757f, 0.857728601f}, {0.534997642f, 0.844853580f},
+{0.555570245f, 0.831469595f}, {0.575808167f, 0.817584813f},
+{0.595699310f, 0.803207517f}, {0.615231574f, 0.788346410f},
+{0.634393275f, 0.773010433f}, {0.653172851f, 0.757208824f},
+{0.671558976f, 0.740951121f}, {0.689540565f, 0.724247098f},
+{0.707106769f, 0.707106769f}, {0.724247098f, 0.689540565f},
+{0.740951121f, 0.671558976f}, {0.757208824f, 0.653172851f},
+{0.773010433f, 0.634393275f}, {0.788346410f, 0.615231574f},
+{0.803207517f, 0.595699310f}, {0.817584813f, 0.575808167f},
+{0.831469595f, 0.555570245f}, {0.844853580f, 0.534997642f},
+{0.857728601f, 0.514102757f}, {0.870086968f, 0.492898196f},
+{0.881921291f, 0.471396744f}, {0.893224299f, 0.449611336f},
+{0.903989315f, 0.427555084f}, {0.914209783f, 0.405241311f},
+{0.923879504f, 0.382683426f}, {0.932992816f, 0.359895051f},
+{0.941544056f, 0.336889863f}, {0.949528158f, 0.313681751f},
+{0.956940353f, 0.290284663f}, {0.963776052f, 0.266712755f},
+{0.970031261f, 0.242980182f}, {0.975702107f, 0.219101235f},
+{0.980785251f, 0.195090324f}, {0.985277653f, 0.170961887f},
+{0.989176512f, 0.146730468f}, {0.992479563f, 0.122410677f},
+{0.995184720f, 0.0980171412f}, {0.997290432f, 0.0735645667f},
+{0.998795450f, 0.0490676761f}, {0.999698818f, 0.0245412290f},
+};
+#ifndef FFT_BITREV256
+#define FFT_BITREV256
+static const opus_int16 fft_bitrev256[256] = {
+0, 64, 128, 192, 16, 80, 144, 208, 32, 96, 160, 224, 48, 112, 176,
+240, 4, 68, 132, 196, 20, 84, 148, 212, 36, 100, 164, 228, 52, 116,
+180, 244, 8, 72, 136, 200, 24, 88, 152, 216, 40, 104, 168, 232, 56,
+120, 184, 248, 12, 76, 140, 204, 28, 92, 156, 220, 44, 108, 172, 236,
+60, 124, 188, 252, 1, 65, 129, 193, 17, 81, 145, 209, 33, 97, 161,
+225, 49, 113, 177, 241, 5, 69, 133, 197, 21, 85, 149, 213, 37, 101,
+165, 229, 53, 117, 181, 245, 9, 73, 137, 201, 25, 89, 153, 217, 41,
+105, 169, 233, 57, 121, 185, 249, 13, 77, 141, 205, 29, 93, 157, 221,
+45, 109, 173, 237, 61, 125, 189, 253, 2, 66, 130, 194, 18, 82, 146,
+210, 34, 98, 162, 226, 50, 114, 178, 242, 6, 70, 134, 198, 22, 86,
+150, 214, 38, 102, 166, 230, 54, 118, 182, 246, 10, 74, 138, 202, 26,
+90, 154, 218, 42, 106, 170, 234, 58, 122, 186, 250, 14, 78, 142, 206,
+30, 94, 158, 222, 46, 110, 174, 238, 62, 126, 190, 254, 3, 67, 131,
+195, 19, 83, 147, 211, 35, 99, 163, 227, 51, 115, 179, 243, 7, 71,
+135, 199, 23, 87, 151, 215, 39, 103, 167, 231, 55, 119, 183, 247, 11,
+75, 139, 203, 27, 91, 155, 219, 43, 107, 171, 235, 59, 123, 187, 251,
+15, 79, 143, 207, 31, 95, 159, 223, 47, 111, 175, 239, 63, 127, 191,
+255, };
+#endif
+
+#ifndef FFT_BITREV128
+#define FFT_BITREV128
+static const opus_int16 fft_bitrev128[128] = {
+0, 32, 64, 96, 8, 40, 72, 104, 16, 48, 80, 112, 24, 56, 88,
+120, 2, 34, 66, 98, 10, 42, 74, 106, 18, 50, 82, 114, 26, 58,
+90, 122, 4, 36, 68, 100, 12, 44, 76, 108, 20, 52, 84, 116, 28,
+60, 92, 124, 6, 38, 70, 102, 14, 46, 78, 110, 22, 54, 86, 118,
+30, 62, 94, 126, 1, 33, 65, 97, 9, 41, 73, 105, 17, 49, 81,
+113, 25, 57, 89, 121, 3, 35, 67, 99, 11, 43, 75, 107, 19, 51,
+83, 115, 27, 59, 91, 123, 5, 37, 69, 101, 13, 45, 77, 109, 21,
+53, 85, 117, 29, 61, 93, 125, 7, 39, 71, 103, 15, 47, 79, 111,
+23, 55, 87, 119, 31, 63, 95, 127, };
+#endif
+
+#ifndef FFT_BITREV64
+#define FFT_BITREV64
+static const opus_int16 fft_bitrev64[64] = {
+0, 16, 32, 48, 4, 20, 36, 52, 8, 24, 40, 56, 12, 28, 44,
+60, 1, 17, 33, 49, 5, 21, 37, 53, 9, 25, 41, 57, 13, 29,
+45, 61, 2, 18, 34, 50, 6, 22, 38, 54, 10, 26, 42, 58, 14,
+30, 46, 62, 3, 19, 35, 51, 7, 23, 39, 55, 11, 27, 43, 59,
+15, 31, 47, 63, };
+#endif
+
+#ifndef FFT_STATE48000_512_0
+#define FFT_STATE48000_512_0
+static const kiss_fft_state fft_state48000_512_0 = {
+256,    /* nfft */
+0.00390625000f, /* scale */
+-1,     /* shift */
+{4, 64, 4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, },   /* factors */
+fft_bitrev256,  /* bitrev */
+fft_twiddles48000_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE48000_512_1
+#define FFT_STATE48000_512_1
+static const kiss_fft_state fft_state48000_512_1 = {
+128,    /* nfft */
+0.00781250000f, /* scale */
+1,      /* shift */
+{4, 32, 4, 8, 4, 2, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev128,  /* bitrev */
+fft_twiddles48000_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE48000_512_2
+#define FFT_STATE48000_512_2
+static const kiss_fft_state fft_state48000_512_2 = {
+64,     /* nfft */
+0.0156250000f,  /* scale */
+2,      /* shift */
+{4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev64,   /* bitrev */
+fft_twiddles48000_512,  /* bitrev */
+};
+#endif
+
+#endif
+
+#ifndef MDCT_TWIDDLES512
+#define MDCT_TWIDDLES512
+static const opus_val16 mdct_twiddles512[257] = {
+1.00000000f, 0.999981165f, 0.999924719f, 0.999830604f, 0.999698818f,
+0.999529421f, 0.999322355f, 0.999077737f, 0.998795450f, 0.998475552f,
+0.998118103f, 0.997723043f, 0.997290432f, 0.996820271f, 0.996312618f,
+0.995767415f, 0.995184720f, 0.994564593f, 0.993906975f, 0.993211925f,
+0.992479563f, 0.991709769f, 0.990902662f, 0.990058184f, 0.989176512f,
+0.988257587f, 0.987301409f, 0.986308098f, 0.985277653f, 0.984210074f,
+0.983105481f, 0.981963873f, 0.980785251f, 0.979569793f, 0.978317380f,
+0.977028131f, 0.975702107f, 0.974339366f, 0.972939968f, 0.971503913f,
+0.970031261f, 0.968522072f, 0.966976464f, 0.965394437f, 0.963776052f,
+0.962121427f, 0.960430503f, 0.958703458f, 0.956940353f, 0.955141187f,
+0.953306019f, 0.951435030f, 0.949528158f, 0.947585583f, 0.945607305f,
+0.943593442f, 0.941544056f, 0.939459205f, 0.937339008f, 0.935183525f,
+0.932992816f, 0.930766940f, 0.928506076f, 0.926210225f, 0.923879504f,
+0.921514034f, 0.919113874f, 0.916679084f, 0.914209723f, 0.911706030f,
+0.909167945f, 0.906595707f, 0.903989315f, 0.901348829f, 0.898674488f,
+0.895966232f, 0.893224299f, 0.890448749f, 0.887639642f, 0.884797096f,
+0.881921232f, 0.879012227f, 0.876070082f, 0.873094976f, 0.870086968f,
+0.867046237f, 0.863972843f, 0.860866904f, 0.857728601f, 0.854557991f,
+0.851355195f, 0.848120332f, 0.844853580f, 0.841554999f, 0.838224709f,
+0.834862828f, 0.831469595f, 0.828045011f, 0.824589252f, 0.821102500f,
+0.817584813f, 0.814036310f, 0.810457170f, 0.806847572f, 0.803207517f,
+0.799537241f, 0.795836926f, 0.792106569f, 0.788346410f, 0.784556627f,
+0.780737221f, 0.776888430f, 0.773010433f, 0.769103348f, 0.765167236f,
+0.761202335f, 0.757208824f, 0.753186822f, 0.749136388f, 0.745057762f,
+0.740951121f, 0.736816585f, 0.732654274f, 0.728464365f, 0.724247098f,
+0.720002472f, 0.715730786f, 0.711432219f, 0.707106769f, 0.702754736f,
+0.698376238f, 0.693971455f, 0.689540505f, 0.685083628f, 0.680601001f,
+0.676092684f, 0.671558917f, 0.666999936f, 0.662415743f, 0.657806695f,
+0.653172791f, 0.648514390f, 0.643831551f, 0.639124393f, 0.634393275f,
+0.629638195f, 0.624859452f, 0.620057166f, 0.615231574f, 0.610382795f,
+0.605511010f, 0.600616455f, 0.595699310f, 0.590759695f, 0.585797846f,
+0.580813944f, 0.575808167f, 0.570780694f, 0.565731823f, 0.560661554f,
+0.555570185f, 0.550457954f, 0.545324981f, 0.540171504f, 0.534997642f,
+0.529803634f, 0.524589658f, 0.519355953f, 0.514102697f, 0.508830070f,
+0.503538430f, 0.498227686f, 0.492898196f, 0.487550139f, 0.482183725f,
+0.476799160f, 0.471396655f, 0.465976506f, 0.460538715f, 0.455083579f,
+0.449611306f, 0.444122106f, 0.438616186f, 0.433093756f, 0.427555114f,
+0.422000259f, 0.416429549f, 0.410843134f, 0.405241281f, 0.399624139f,
+0.393991947f, 0.388345063f, 0.382683426f, 0.377007395f, 0.371317148f,
+0.365612954f, 0.359894961f, 0.354163438f, 0.348418683f, 0.342660725f,
+0.336889833f, 0.331106275f, 0.325310230f, 0.319501966f, 0.313681662f,
+0.307849646f, 0.302005947f, 0.296150863f, 0.290284634f, 0.284407467f,
+0.278519601f, 0.272621274f, 0.266712755f, 0.260794103f, 0.254865646f,
+0.248927563f, 0.242980123f, 0.237023532f, 0.231058136f, 0.225083917f,
+0.219101220f, 0.213110283f, 0.207111329f, 0.201104566f, 0.195090234f,
+0.189068690f, 0.183039889f, 0.177004203f, 0.170961857f, 0.164913073f,
+0.158858076f, 0.152797103f, 0.146730497f, 0.140658244f, 0.134580687f,
+0.128498077f, 0.122410625f, 0.116318561f, 0.110222116f, 0.104121648f,
+0.0980171338f, 0.0919089392f, 0.0857972726f, 0.0796823800f, 0.0735644922f,
+0.0674438328f, 0.0613207482f, 0.0551952384f, 0.0490676500f, 0.0429382175f,
+0.0368071645f, 0.0306747276f, 0.0245411359f, 0.0184067376f, 0.0122715291f,
+0.00613585813f, -4.37113883e-08f, };
+#endif
+
+static const CELTMode mode48000_512_128 = {
+48000,  /* Fs */
+128,    /* overlap */
+22,     /* nbEBands */
+22,     /* effEBands */
+{0.850006104f, 0.00000000f, 1.00000000f, 1.00000000f, },        /* preemph */
+eBands48000_512,        /* eBands */
+2,      /* maxLM */
+4,      /* nbShortMdcts */
+128,    /* shortMdctSize */
+11,     /* nbAllocVectors */
+allocVectors48000_512,  /* allocVectors */
+logN375,        /* logN */
+window128,      /* window */
+{1024, 2, {&fft_state48000_512_0, &fft_state48000_512_1, &fft_state48000_512_2, }, mdct_twiddles512},   /* mdct */
+{467, cache_index93, cache_bits93, cache_caps93},       /* cache */
+};
+static const opus_int16 eBands44100_512[24] = {
+0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 18, 22, 26, 32, 38, 46, 56, 70, 90, 116, 0, };
+
+#ifndef DEF_WINDOW128
+#define DEF_WINDOW128
+static const opus_val16 window128[128] = {
+5.91390381e-05f, 0.000532197882f, 0.00147803011f, 0.00289606350f, 0.00478543621f,
+0.00714499271f, 0.00997327734f, 0.0132685294f, 0.0170286745f, 0.0212513115f,
+0.0259337109f, 0.0310727954f, 0.0366651304f, 0.0427069142f, 0.0491939597f,
+0.0561216921f, 0.0634851083f, 0.0712788031f, 0.0794969127f, 0.0881331414f,
+0.0971807018f, 0.106632352f, 0.116480343f, 0.126716435f, 0.137331858f,
+0.148317337f, 0.159663051f, 0.171358675f, 0.183393300f, 0.195755512f,
+0.208433345f, 0.221414253f, 0.234685227f, 0.248232663f, 0.262042463f,
+0.276100039f, 0.290390283f, 0.304897606f, 0.319605947f, 0.334498882f,
+0.349559516f, 0.364770591f, 0.380114466f, 0.395573229f, 0.411128700f,
+0.426762402f, 0.442455709f, 0.458189756f, 0.473945677f, 0.489704460f,
+0.505447090f, 0.521154583f, 0.536808074f, 0.552388728f, 0.567878008f,
+0.583257556f, 0.598509252f, 0.613615453f, 0.628558755f, 0.643322289f,
+0.657889605f, 0.672244906f, 0.686372936f, 0.700258911f, 0.713888943f,
+0.727249742f, 0.740328789f, 0.753114343f, 0.765595496f, 0.777762115f,
+0.789605021f, 0.801115870f, 0.812287271f, 0.823112726f, 0.833586633f,
+0.843704402f, 0.853462279f, 0.862857580f, 0.871888459f, 0.880554080f,
+0.888854384f, 0.896790385f, 0.904363751f, 0.911577284f, 0.918434441f,
+0.924939454f, 0.931097448f, 0.936914146f, 0.942396164f, 0.947550535f,
+0.952385128f, 0.956908286f, 0.961128891f, 0.965056360f, 0.968700469f,
+0.972071409f, 0.975179851f, 0.978036582f, 0.980652750f, 0.983039618f,
+0.985208690f, 0.987171590f, 0.988939822f, 0.990525067f, 0.991939008f,
+0.993192971f, 0.994298518f, 0.995266736f, 0.996108711f, 0.996835113f,
+0.997456431f, 0.997982800f, 0.998423934f, 0.998789251f, 0.999087632f,
+0.999327600f, 0.999517143f, 0.999663651f, 0.999774158f, 0.999854982f,
+0.999911964f, 0.999950290f, 0.999974489f, 0.999988556f, 0.999995828f,
+0.999998927f, 0.999999881f, 1.00000000f, };
+#endif
+
+static const unsigned char allocVectors44100_512[242] = {
+ 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 
+90, 81, 76, 71, 66, 60, 54, 48, 40, 32, 27, 19, 18, 11,  2,  0,  0,  0,  0,  0,  0,  0, 
+110, 101, 92, 86, 81, 75, 69, 64, 58, 49, 43, 38, 32, 27, 21, 15,  1,  0,  0,  0,  0,  0, 
+118, 111, 104, 97, 89, 84, 79, 74, 70, 63, 57, 52, 47, 41, 33, 26, 15,  6,  0,  0,  0,  0, 
+126, 119, 113, 107, 99, 93, 87, 82, 78, 70, 64, 59, 54, 48, 41, 34, 25, 18, 12,  0,  0,  0, 
+134, 127, 121, 116, 109, 101, 95, 90, 85, 76, 70, 65, 60, 55, 48, 43, 35, 30, 23, 15,  9,  1, 
+144, 137, 131, 126, 119, 111, 105, 100, 95, 86, 80, 75, 70, 65, 58, 53, 45, 40, 33, 25, 14,  1, 
+152, 145, 139, 134, 127, 121, 115, 110, 105, 96, 90, 85, 80, 75, 68, 63, 55, 50, 43, 35, 19,  1, 
+162, 155, 149, 144, 137, 131, 125, 120, 115, 106, 100, 95, 90, 85, 78, 73, 65, 60, 53, 45, 29,  1, 
+172, 165, 159, 154, 147, 141, 135, 130, 125, 116, 110, 105, 100, 95, 88, 83, 75, 70, 63, 55, 44, 20, 
+200, 200, 200, 200, 200, 200, 200, 200, 200, 196, 192, 187, 183, 179, 174, 170, 163, 159, 153, 147, 128, 104, 
+};
+
+#ifndef DEF_LOGN344
+#define DEF_LOGN344
+static const opus_int16 logN344[22] = {
+0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 16, 16, 21, 21, 24, 27, 31, 35, 38, };
+#endif
+
+#ifndef DEF_PULSE_CACHE86
+#define DEF_PULSE_CACHE86
+static const opus_int16 cache_index86[88] = {
+-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 41, 41,
+82, 82, 123, 164, 205, 235, 255, 0, 0, 0, 0, 0, 0, 0, 0,
+41, 41, 41, 41, 41, 123, 123, 271, 271, 307, 235, 333, 347, 358, 41,
+41, 41, 41, 41, 41, 41, 41, 123, 123, 123, 123, 123, 307, 307, 367,
+367, 384, 347, 397, 406, 414, 123, 123, 123, 123, 123, 123, 123, 123, 307,
+307, 307, 307, 307, 384, 384, 421, 421, 431, 406, 439, 446, 452, };
+static const unsigned char cache_bits86[458] = {
+40, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 40, 15, 23, 28,
+31, 34, 36, 38, 39, 41, 42, 43, 44, 45, 46, 47, 47, 49, 50,
+51, 52, 53, 54, 55, 55, 57, 58, 59, 60, 61, 62, 63, 63, 65,
+66, 67, 68, 69, 70, 71, 71, 40, 20, 33, 41, 48, 53, 57, 61,
+64, 66, 69, 71, 73, 75, 76, 78, 80, 82, 85, 87, 89, 91, 92,
+94, 96, 98, 101, 103, 105, 107, 108, 110, 112, 114, 117, 119, 121, 123,
+124, 126, 128, 40, 23, 39, 51, 60, 67, 73, 79, 83, 87, 91, 94,
+97, 100, 102, 105, 107, 111, 115, 118, 121, 124, 126, 129, 131, 135, 139,
+142, 145, 148, 150, 153, 155, 159, 163, 166, 169, 172, 174, 177, 179, 40,
+26, 45, 59, 70, 79, 87, 94, 100, 105, 110, 114, 118, 122, 125, 128,
+131, 136, 141, 146, 150, 153, 157, 160, 163, 168, 173, 178, 182, 185, 189,
+192, 195, 200, 205, 210, 214, 217, 221, 224, 227, 29, 30, 52, 70, 85,
+98, 109, 118, 126, 134, 141, 147, 153, 158, 163, 168, 172, 180, 188, 194,
+200, 205, 211, 215, 220, 228, 235, 242, 248, 253, 19, 34, 61, 83, 101,
+118, 132, 145, 157, 167, 177, 186, 194, 202, 209, 216, 222, 234, 245, 254,
+15, 37, 67, 92, 113, 133, 150, 165, 180, 193, 205, 216, 227, 237, 246,
+254, 35, 28, 49, 65, 78, 89, 99, 107, 114, 120, 126, 132, 136, 141,
+145, 149, 153, 159, 165, 171, 176, 180, 185, 189, 192, 199, 205, 211, 216,
+220, 225, 229, 232, 239, 245, 251, 25, 31, 55, 75, 91, 105, 117, 128,
+138, 146, 154, 161, 168, 174, 180, 185, 190, 200, 208, 215, 222, 229, 235,
+240, 245, 255, 13, 38, 68, 94, 117, 137, 155, 171, 186, 200, 213, 225,
+236, 247, 10, 42, 77, 107, 133, 157, 179, 200, 219, 236, 253, 8, 45,
+83, 116, 145, 172, 197, 221, 242, 16, 36, 65, 89, 110, 128, 144, 159,
+173, 185, 196, 207, 217, 226, 234, 242, 250, 12, 39, 71, 99, 123, 144,
+164, 182, 198, 214, 228, 241, 253, 8, 46, 84, 118, 149, 177, 202, 227,
+249, 7, 50, 93, 131, 165, 197, 227, 255, 6, 53, 99, 140, 177, 212,
+245, 9, 44, 81, 113, 142, 168, 192, 214, 235, 255, 7, 47, 87, 123,
+155, 184, 212, 237, 6, 54, 100, 142, 181, 217, 250, 5, 58, 109, 155,
+197, 237, 5, 61, 115, 164, 209, 252, };
+static const unsigned char cache_caps86[132] = {
+224, 224, 224, 224, 224, 224, 224, 224, 160, 160, 160, 160, 160, 185, 185,
+178, 178, 168, 159, 105, 49, 21, 224, 224, 224, 224, 224, 224, 224, 224,
+240, 240, 240, 240, 240, 207, 207, 198, 198, 183, 171, 110, 53, 24, 160,
+160, 160, 160, 160, 160, 160, 160, 185, 185, 185, 185, 185, 193, 193, 183,
+183, 172, 163, 106, 51, 23, 240, 240, 240, 240, 240, 240, 240, 240, 207,
+207, 207, 207, 207, 204, 204, 193, 193, 180, 167, 110, 54, 24, 185, 185,
+185, 185, 185, 185, 185, 185, 193, 193, 193, 193, 193, 193, 193, 183, 183,
+172, 163, 107, 52, 23, 207, 207, 207, 207, 207, 207, 207, 207, 204, 204,
+204, 204, 204, 201, 201, 188, 188, 176, 166, 109, 53, 24, };
+#endif
+
+#ifndef FFT_TWIDDLES44100_512
+#define FFT_TWIDDLES44100_512
+static const kiss_twiddle_cpx fft_twiddles44100_512[256] = {
+{1.00000000f, -0.00000000f}, {0.999698818f, -0.0245412290f},
+{0.998795450f, -0.0490676761f}, {0.997290432f, -0.0735645667f},
+{0.995184720f, -0.0980171412f}, {0.992479563f, -0.122410677f},
+{0.989176512f, -0.146730468f}, {0.985277653f, -0.170961887f},
+{0.980785251f, -0.195090324f}, {0.975702107f, -0.219101235f},
+{0.970031261f, -0.242980182f}, {0.963776052f, -0.266712755f},
+{0.956940353f, -0.290284663f}, {0.949528158f, -0.313681751f},
+{0.941544056f, -0.336889863f}, {0.932992816f, -0.359895051f},
+{0.923879504f, -0.382683426f}, {0.914209783f, -0.405241311f},
+{0.903989315f, -0.427555084f}, {0.893224299f, -0.449611336f},
+{0.881921291f, -0.471396744f}, {0.870086968f, -0.492898196f},
+{0.857728601f, -0.514102757f}, {0.844853580f, -0.534997642f},
+{0.831469595f, -0.555570245f}, {0.817584813f, -0.575808167f},
+{0.803207517f, -0.595699310f}, {0.788346410f, -0.615231574f},
+{0.773010433f, -0.634393275f}, {0.757208824f, -0.653172851f},
+{0.740951121f, -0.671558976f}, {0.724247098f, -0.689540565f},
+{0.707106769f, -0.707106769f}, {0.689540565f, -0.724247098f},
+{0.671558976f, -0.740951121f}, {0.653172851f, -0.757208824f},
+{0.634393275f, -0.773010433f}, {0.615231574f, -0.788346410f},
+{0.595699310f, -0.803207517f}, {0.575808167f, -0.817584813f},
+{0.555570245f, -0.831469595f}, {0.534997642f, -0.844853580f},
+{0.514102757f, -0.857728601f}, {0.492898196f, -0.870086968f},
+{0.471396744f, -0.881921291f}, {0.449611336f, -0.893224299f},
+{0.427555084f, -0.903989315f}, {0.405241311f, -0.914209783f},
+{0.382683426f, -0.923879504f}, {0.359895051f, -0.932992816f},
+{0.336889863f, -0.941544056f}, {0.313681751f, -0.949528158f},
+{0.290284663f, -0.956940353f}, {0.266712755f, -0.963776052f},
+{0.242980182f, -0.970031261f}, {0.219101235f, -0.975702107f},
+{0.195090324f, -0.980785251f}, {0.170961887f, -0.985277653f},
+{0.146730468f, -0.989176512f}, {0.122410677f, -0.992479563f},
+{0.0980171412f, -0.995184720f}, {0.0735645667f, -0.997290432f},
+{0.0490676761f, -0.998795450f}, {0.0245412290f, -0.999698818f},
+{6.12323426e-17f, -1.00000000f}, {-0.0245412290f, -0.999698818f},
+{-0.0490676761f, -0.998795450f}, {-0.0735645667f, -0.997290432f},
+{-0.0980171412f, -0.995184720f}, {-0.122410677f, -0.992479563f},
+{-0.146730468f, -0.989176512f}, {-0.170961887f, -0.985277653f},
+{-0.195090324f, -0.980785251f}, {-0.219101235f, -0.975702107f},
+{-0.242980182f, -0.970031261f}, {-0.266712755f, -0.963776052f},
+{-0.290284663f, -0.956940353f}, {-0.313681751f, -0.949528158f},
+{-0.336889863f, -0.941544056f}, {-0.359895051f, -0.932992816f},
+{-0.382683426f, -0.923879504f}, {-0.405241311f, -0.914209783f},
+{-0.427555084f, -0.903989315f}, {-0.449611336f, -0.893224299f},
+{-0.471396744f, -0.881921291f}, {-0.492898196f, -0.870086968f},
+{-0.514102757f, -0.857728601f}, {-0.534997642f, -0.844853580f},
+{-0.555570245f, -0.831469595f}, {-0.575808167f, -0.817584813f},
+{-0.595699310f, -0.803207517f}, {-0.615231574f, -0.788346410f},
+{-0.634393275f, -0.773010433f}, {-0.653172851f, -0.757208824f},
+{-0.671558976f, -0.740951121f}, {-0.689540565f, -0.724247098f},
+{-0.707106769f, -0.707106769f}, {-0.724247098f, -0.689540565f},
+{-0.740951121f, -0.671558976f}, {-0.757208824f, -0.653172851f},
+{-0.773010433f, -0.634393275f}, {-0.788346410f, -0.615231574f},
+{-0.803207517f, -0.595699310f}, {-0.817584813f, -0.575808167f},
+{-0.831469595f, -0.555570245f}, {-0.844853580f, -0.534997642f},
+{-0.857728601f, -0.514102757f}, {-0.870086968f, -0.492898196f},
+{-0.881921291f, -0.471396744f}, {-0.893224299f, -0.449611336f},
+{-0.903989315f, -0.427555084f}, {-0.914209783f, -0.405241311f},
+{-0.923879504f, -0.382683426f}, {-0.932992816f, -0.359895051f},
+{-0.941544056f, -0.336889863f}, {-0.949528158f, -0.313681751f},
+{-0.956940353f, -0.290284663f}, {-0.963776052f, -0.266712755f},
+{-0.970031261f, -0.242980182f}, {-0.975702107f, -0.219101235f},
+{-0.980785251f, -0.195090324f}, {-0.985277653f, -0.170961887f},
+{-0.989176512f, -0.146730468f}, {-0.992479563f, -0.122410677f},
+{-0.995184720f, -0.0980171412f}, {-0.997290432f, -0.0735645667f},
+{-0.998795450f, -0.0490676761f}, {-0.999698818f, -0.0245412290f},
+{-1.00000000f, -1.22464685e-16f}, {-0.999698818f, 0.0245412290f},
+{-0.998795450f, 0.0490676761f}, {-0.997290432f, 0.0735645667f},
+{-0.995184720f, 0.0980171412f}, {-0.992479563f, 0.122410677f},
+{-0.989176512f, 0.146730468f}, {-0.985277653f, 0.170961887f},
+{-0.980785251f, 0.195090324f}, {-0.975702107f, 0.219101235f},
+{-0.970031261f, 0.242980182f}, {-0.963776052f, 0.266712755f},
+{-0.956940353f, 0.290284663f}, {-0.949528158f, 0.313681751f},
+{-0.941544056f, 0.336889863f}, {-0.932992816f, 0.359895051f},
+{-0.923879504f, 0.382683426f}, {-0.914209783f, 0.405241311f},
+{-0.903989315f, 0.427555084f}, {-0.893224299f, 0.449611336f},
+{-0.881921291f, 0.471396744f}, {-0.870086968f, 0.492898196f},
+{-0.857728601f, 0.514102757f}, {-0.844853580f, 0.534997642f},
+{-0.831469595f, 0.555570245f}, {-0.817584813f, 0.575808167f},
+{-0.803207517f, 0.595699310f}, {-0.788346410f, 0.615231574f},
+{-0.773010433f, 0.634393275f}, {-0.757208824f, 0.653172851f},
+{-0.740951121f, 0.671558976f}, {-0.724247098f, 0.689540565f},
+{-0.707106769f, 0.707106769f}, {-0.689540565f, 0.724247098f},
+{-0.671558976f, 0.740951121f}, {-0.653172851f, 0.757208824f},
+{-0.634393275f, 0.773010433f}, {-0.615231574f, 0.788346410f},
+{-0.595699310f, 0.803207517f}, {-0.575808167f, 0.817584813f},
+{-0.555570245f, 0.831469595f}, {-0.534997642f, 0.844853580f},
+{-0.514102757f, 0.857728601f}, {-0.492898196f, 0.870086968f},
+{-0.471396744f, 0.881921291f}, {-0.449611336f, 0.893224299f},
+{-0.427555084f, 0.903989315f}, {-0.405241311f, 0.914209783f},
+{-0.382683426f, 0.923879504f}, {-0.359895051f, 0.932992816f},
+{-0.336889863f, 0.941544056f}, {-0.313681751f, 0.949528158f},
+{-0.290284663f, 0.956940353f}, {-0.266712755f, 0.963776052f},
+{-0.242980182f, 0.970031261f}, {-0.219101235f, 0.975702107f},
+{-0.195090324f, 0.980785251f}, {-0.170961887f, 0.985277653f},
+{-0.146730468f, 0.989176512f}, {-0.122410677f, 0.992479563f},
+{-0.0980171412f, 0.995184720f}, {-0.0735645667f, 0.997290432f},
+{-0.0490676761f, 0.998795450f}, {-0.0245412290f, 0.999698818f},
+{-1.83697015e-16f, 1.00000000f}, {0.0245412290f, 0.999698818f},
+{0.0490676761f, 0.998795450f}, {0.0735645667f, 0.997290432f},
+{0.0980171412f, 0.995184720f}, {0.122410677f, 0.992479563f},
+{0.146730468f, 0.989176512f}, {0.170961887f, 0.985277653f},
+{0.195090324f, 0.980785251f}, {0.219101235f, 0.975702107f},
+{0.242980182f, 0.970031261f}, {0.266712755f, 0.963776052f},
+{0.290284663f, 0.956940353f}, {0.313681751f, 0.949528158f},
+{0.336889863f, 0.941544056f}, {0.359895051f, 0.932992816f},
+{0.382683426f, 0.923879504f}, {0.405241311f, 0.914209783f},
+{0.427555084f, 0.903989315f}, {0.449611336f, 0.893224299f},
+{0.471396744f, 0.881921291f}, {0.492898196f, 0.870086968f},
+{0.514102757f, 0.857728601f}, {0.534997642f, 0.844853580f},
+{0.555570245f, 0.831469595f}, {0.575808167f, 0.817584813f},
+{0.595699310f, 0.803207517f}, {0.615231574f, 0.788346410f},
+{0.634393275f, 0.773010433f}, {0.653172851f, 0.757208824f},
+{0.671558976f, 0.740951121f}, {0.689540565f, 0.724247098f},
+{0.707106769f, 0.707106769f}, {0.724247098f, 0.689540565f},
+{0.740951121f, 0.671558976f}, {0.757208824f, 0.653172851f},
+{0.773010433f, 0.634393275f}, {0.788346410f, 0.615231574f},
+{0.803207517f, 0.595699310f}, {0.817584813f, 0.575808167f},
+{0.831469595f, 0.555570245f}, {0.844853580f, 0.534997642f},
+{0.857728601f, 0.514102757f}, {0.870086968f, 0.492898196f},
+{0.881921291f, 0.471396744f}, {0.893224299f, 0.449611336f},
+{0.903989315f, 0.427555084f}, {0.914209783f, 0.405241311f},
+{0.923879504f, 0.382683426f}, {0.932992816f, 0.359895051f},
+{0.941544056f, 0.336889863f}, {0.949528158f, 0.313681751f},
+{0.956940353f, 0.290284663f}, {0.963776052f, 0.266712755f},
+{0.970031261f, 0.242980182f}, {0.975702107f, 0.219101235f},
+{0.980785251f, 0.195090324f}, {0.985277653f, 0.170961887f},
+{0.989176512f, 0.146730468f}, {0.992479563f, 0.122410677f},
+{0.995184720f, 0.0980171412f}, {0.997290432f, 0.0735645667f},
+{0.998795450f, 0.0490676761f}, {0.999698818f, 0.0245412290f},
+};
+#ifndef FFT_BITREV256
+#define FFT_BITREV256
+static const opus_int16 fft_bitrev256[256] = {
+0, 64, 128, 192, 16, 80, 144, 208, 32, 96, 160, 224, 48, 112, 176,
+240, 4, 68, 132, 196, 20, 84, 148, 212, 36, 100, 164, 228, 52, 116,
+180, 244, 8, 72, 136, 200, 24, 88, 152, 216, 40, 104, 168, 232, 56,
+120, 184, 248, 12, 76, 140, 204, 28, 92, 156, 220, 44, 108, 172, 236,
+60, 124, 188, 252, 1, 65, 129, 193, 17, 81, 145, 209, 33, 97, 161,
+225, 49, 113, 177, 241, 5, 69, 133, 197, 21, 85, 149, 213, 37, 101,
+165, 229, 53, 117, 181, 245, 9, 73, 137, 201, 25, 89, 153, 217, 41,
+105, 169, 233, 57, 121, 185, 249, 13, 77, 141, 205, 29, 93, 157, 221,
+45, 109, 173, 237, 61, 125, 189, 253, 2, 66, 130, 194, 18, 82, 146,
+210, 34, 98, 162, 226, 50, 114, 178, 242, 6, 70, 134, 198, 22, 86,
+150, 214, 38, 102, 166, 230, 54, 118, 182, 246, 10, 74, 138, 202, 26,
+90, 154, 218, 42, 106, 170, 234, 58, 122, 186, 250, 14, 78, 142, 206,
+30, 94, 158, 222, 46, 110, 174, 238, 62, 126, 190, 254, 3, 67, 131,
+195, 19, 83, 147, 211, 35, 99, 163, 227, 51, 115, 179, 243, 7, 71,
+135, 199, 23, 87, 151, 215, 39, 103, 167, 231, 55, 119, 183, 247, 11,
+75, 139, 203, 27, 91, 155, 219, 43, 107, 171, 235, 59, 123, 187, 251,
+15, 79, 143, 207, 31, 95, 159, 223, 47, 111, 175, 239, 63, 127, 191,
+255, };
+#endif
+
+#ifndef FFT_BITREV128
+#define FFT_BITREV128
+static const opus_int16 fft_bitrev128[128] = {
+0, 32, 64, 96, 8, 40, 72, 104, 16, 48, 80, 112, 24, 56, 88,
+120, 2, 34, 66, 98, 10, 42, 74, 106, 18, 50, 82, 114, 26, 58,
+90, 122, 4, 36, 68, 100, 12, 44, 76, 108, 20, 52, 84, 116, 28,
+60, 92, 124, 6, 38, 70, 102, 14, 46, 78, 110, 22, 54, 86, 118,
+30, 62, 94, 126, 1, 33, 65, 97, 9, 41, 73, 105, 17, 49, 81,
+113, 25, 57, 89, 121, 3, 35, 67, 99, 11, 43, 75, 107, 19, 51,
+83, 115, 27, 59, 91, 123, 5, 37, 69, 101, 13, 45, 77, 109, 21,
+53, 85, 117, 29, 61, 93, 125, 7, 39, 71, 103, 15, 47, 79, 111,
+23, 55, 87, 119, 31, 63, 95, 127, };
+#endif
+
+#ifndef FFT_BITREV64
+#define FFT_BITREV64
+static const opus_int16 fft_bitrev64[64] = {
+0, 16, 32, 48, 4, 20, 36, 52, 8, 24, 40, 56, 12, 28, 44,
+60, 1, 17, 33, 49, 5, 21, 37, 53, 9, 25, 41, 57, 13, 29,
+45, 61, 2, 18, 34, 50, 6, 22, 38, 54, 10, 26, 42, 58, 14,
+30, 46, 62, 3, 19, 35, 51, 7, 23, 39, 55, 11, 27, 43, 59,
+15, 31, 47, 63, };
+#endif
+
+#ifndef FFT_STATE44100_512_0
+#define FFT_STATE44100_512_0
+static const kiss_fft_state fft_state44100_512_0 = {
+256,    /* nfft */
+0.00390625000f, /* scale */
+-1,     /* shift */
+{4, 64, 4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, },   /* factors */
+fft_bitrev256,  /* bitrev */
+fft_twiddles44100_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE44100_512_1
+#define FFT_STATE44100_512_1
+static const kiss_fft_state fft_state44100_512_1 = {
+128,    /* nfft */
+0.00781250000f, /* scale */
+1,      /* shift */
+{4, 32, 4, 8, 4, 2, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev128,  /* bitrev */
+fft_twiddles44100_512,  /* bitrev */
+};
+#endif
+
+#ifndef FFT_STATE44100_512_2
+#define FFT_STATE44100_512_2
+static const kiss_fft_state fft_state44100_512_2 = {
+64,     /* nfft */
+0.0156250000f,  /* scale */
+2,      /* shift */
+{4, 16, 4, 4, 4, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, },    /* factors */
+fft_bitrev64,   /* bitrev */
+fft_twiddles44100_512,  /* bitrev */
+};
+#endif
+
+#endif
+
+#ifndef MDCT_TWIDDLES512
+#define MDCT_TWIDDLES512
+static const opus_val16 mdct_twiddles512[257] = {
+1.00000000f, 0.999981165f, 0.999924719f, 0.999830604f, 0.999698818f,
+0.999529421f, 0.999322355f, 0.999077737f, 0.998795450f, 0.998475552f,
+0.998118103f, 0.997723043f, 0.997290432f, 0.996820271f, 0.996312618f,
+0.995767415f, 0.995184720f, 0.994564593f, 0.993906975f, 0.993211925f,
+0.992479563f, 0.991709769f, 0.990902662f, 0.990058184f, 0.989176512f,
+0.988257587f, 0.987301409f, 0.986308098f, 0.985277653f, 0.984210074f,
+0.983105481f, 0.981963873f, 0.980785251f, 0.979569793f, 0.978317380f,
+0.977028131f, 0.975702107f, 0.974339366f, 0.972939968f, 0.971503913f,
+0.970031261f, 0.968522072f, 0.966976464f, 0.965394437f, 0.963776052f,
+0.962121427f, 0.960430503f, 0.958703458f, 0.956940353f, 0.955141187f,
+0.953306019f, 0.951435030f, 0.949528158f, 0.947585583f, 0.945607305f,
+0.943593442f, 0.941544056f, 0.939459205f, 0.937339008f, 0.935183525f,
+0.932992816f, 0.930766940f, 0.928506076f, 0.926210225f, 0.923879504f,
+0.921514034f, 0.919113874f, 0.916679084f, 0.914209723f, 0.911706030f,
+0.909167945f, 0.906595707f, 0.903989315f, 0.901348829f, 0.898674488f,
+0.895966232f, 0.893224299f, 0.890448749f, 0.887639642f, 0.884797096f,
+0.881921232f, 0.879012227f, 0.876070082f, 0.873094976f, 0.870086968f,
+0.867046237f, 0.863972843f, 0.860866904f, 0.857728601f, 0.854557991f,
+0.851355195f, 0.848120332f, 0.844853580f, 0.841554999f, 0.838224709f,
+0.834862828f, 0.831469595f, 0.828045011f, 0.824589252f, 0.821102500f,
+0.817584813f, 0.814036310f, 0.810457170f, 0.806847572f, 0.803207517f,
+0.799537241f, 0.795836926f, 0.792106569f, 0.788346410f, 0.784556627f,
+0.780737221f, 0.776888430f, 0.773010433f, 0.769103348f, 0.765167236f,
+0.761202335f, 0.757208824f, 0.753186822f, 0.749136388f, 0.745057762f,
+0.740951121f, 0.736816585f, 0.732654274f, 0.728464365f, 0.724247098f,
+0.720002472f, 0.715730786f, 0.711432219f, 0.707106769f, 0.702754736f,
+0.698376238f, 0.693971455f, 0.689540505f, 0.685083628f, 0.680601001f,
+0.676092684f, 0.671558917f, 0.666999936f, 0.662415743f, 0.657806695f,
+0.653172791f, 0.648514390f, 0.643831551f, 0.639124393f, 0.634393275f,
+0.629638195f, 0.624859452f, 0.620057166f, 0.615231574f, 0.610382795f,
+0.605511010f, 0.600616455f, 0.595699310f, 0.590759695f, 0.585797846f,
+0.580813944f, 0.575808167f, 0.570780694f, 0.565731823f, 0.560661554f,
+0.555570185f, 0.550457954f, 0.545324981f, 0.540171504f, 0.534997642f,
+0.529803634f, 0.524589658f, 0.519355953f, 0.514102697f, 0.508830070f,
+0.503538430f, 0.498227686f, 0.492898196f, 0.487550139f, 0.482183725f,
+0.476799160f, 0.471396655f, 0.465976506f, 0.460538715f, 0.455083579f,
+0.449611306f, 0.444122106f, 0.438616186f, 0.433093756f, 0.427555114f,
+0.422000259f, 0.416429549f, 0.410843134f, 0.405241281f, 0.399624139f,
+0.393991947f, 0.388345063f, 0.382683426f, 0.377007395f, 0.371317148f,
+0.365612954f, 0.359894961f, 0.354163438f, 0.348418683f, 0.342660725f,
+0.336889833f, 0.331106275f, 0.325310230f, 0.319501966f, 0.313681662f,
+0.307849646f, 0.302005947f, 0.296150863f, 0.290284634f, 0.284407467f,
+0.278519601f, 0.272621274f, 0.266712755f, 0.260794103f, 0.254865646f,
+0.248927563f, 0.242980123f, 0.237023532f, 0.231058136f, 0.225083917f,
+0.219101220f, 0.213110283f, 0.207111329f, 0.201104566f, 0.195090234f,
+0.189068690f, 0.183039889f, 0.177004203f, 0.170961857f, 0.164913073f,
+0.158858076f, 0.152797103f, 0.146730497f, 0.140658244f, 0.134580687f,
+0.128498077f, 0.122410625f, 0.116318561f, 0.110222116f, 0.104121648f,
+0.0980171338f, 0.0919089392f, 0.0857972726f, 0.0796823800f, 0.0735644922f,
+0.0674438328f, 0.0613207482f, 0.0551952384f, 0.0490676500f, 0.0429382175f,
+0.0368071645f, 0.0306747276f, 0.0245411359f, 0.0184067376f, 0.0122715291f,
+0.00613585813f, -4.37113883e-08f, };
+#endif
+
+static const CELTMode mode44100_512_128 = {
+44100,  /* Fs */
+128,    /* overlap */
+22,     /* nbEBands */
+22,     /* effEBands */
+{0.850006104f, 0.00000000f, 1.00000000f, 1.00000000f, },        /* preemph */
+eBands44100_512,        /* eBands */
+2,      /* maxLM */
+4,      /* nbShortMdcts */
+128,    /* shortMdctSize */
+11,     /* nbAllocVectors */
+allocVectors44100_512,  /* allocVectors */
+logN344,        /* logN */
+window128,      /* window */
+{1024, 2, {&fft_state44100_512_0, &fft_state44100_512_1, &fft_state44100_512_2, }, mdct_twiddles512},   /* mdct */
+{458, cache_index86, cache_bits86, cache_caps86},       /* cache */
+};
+
+/* List of all the available custom modes */
+#define TOTAL_CUSTOM_MODES 2
+static const CELTMode * const static_custom_mode_list[TOTAL_CUSTOM_MODES] = {
+&mode48000_512_128,
+&mode44100_512_128,
+};
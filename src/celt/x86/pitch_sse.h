@@ -32,9 +32,25 @@
 #ifndef PITCH_SSE_H
 #define PITCH_SSE_H
 
-#include <xmmintrin.h>
 #include "arch.h"
 
+#if defined(FIXED_POINT)
+
+# if defined(OPUS_X86_MAY_HAVE_SSE4_1)
+opus_val32 celt_pitch_xcorr_sse4_1(const opus_val16 *_x, const opus_val16 *_y,
+      opus_val32 *xcorr, int len, int max_pitch);
+
+#  if defined(OPUS_X86_PRESUME_SSE4_1)
+#   define OVERRIDE_PITCH_XCORR (1)
+#   define celt_pitch_xcorr(_x, _y, xcorr, len, max_pitch, arch) \
+  ((void)(arch),celt_pitch_xcorr_sse4_1(_x, _y, xcorr, len, max_pitch))
+#  endif
+# endif
+
+#else
+
+#include <xmmintrin.h>
+
 #define OVERRIDE_XCORR_KERNEL
 static OPUS_INLINE void xcorr_kernel(const opus_val16 *x, const opus_val16 *y, opus_val32 sum[4], int len)
 {
@@ -154,3 +170,5 @@ static OPUS_INLINE void comb_filter_const(opus_val32 *y, opus_val32 *x, int T, i
 }
 
 #endif
+
+#endif
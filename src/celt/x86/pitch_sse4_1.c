@@ -0,0 +1,86 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(FIXED_POINT) && defined(OPUS_X86_MAY_HAVE_SSE4_1)
+
+#include <smmintrin.h>
+#include "pitch.h"
+
+/* Integer sums wrap the same way in any order, so this is bit-exact with
+   celt_pitch_xcorr_c(). */
+opus_val32 celt_pitch_xcorr_sse4_1(const opus_val16 *_x, const opus_val16 *_y,
+      opus_val32 *xcorr, int len, int max_pitch)
+{
+   int i, j;
+   opus_val32 maxcorr;
+   __m128i vmax;
+   celt_assert(max_pitch>0);
+   vmax = _mm_set1_epi32(1);
+   for (i=0;i<max_pitch-3;i+=4)
+   {
+      __m128i sum0, sum1, sum2, sum3;
+      const opus_val16 *y = _y+i;
+      sum0 = sum1 = sum2 = sum3 = _mm_setzero_si128();
+      /* Eight taps of four lags at a time */
+      for (j=0;j<len-7;j+=8)
+      {
+         __m128i x0 = _mm_loadu_si128((const __m128i *)(_x+j));
+         sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(x0, _mm_loadu_si128((const __m128i *)(y+j))));
+         sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(x0, _mm_loadu_si128((const __m128i *)(y+j+1))));
+         sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(x0, _mm_loadu_si128((const __m128i *)(y+j+2))));
+         sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(x0, _mm_loadu_si128((const __m128i *)(y+j+3))));
+      }
+      /* One sum per lag */
+      sum0 = _mm_hadd_epi32(_mm_hadd_epi32(sum0, sum1), _mm_hadd_epi32(sum2, sum3));
+      for (;j<len;j++)
+      {
+         sum0 = _mm_add_epi32(sum0, _mm_mullo_epi32(_mm_set1_epi32(_x[j]),
+               _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(y+j)))));
+      }
+      _mm_storeu_si128((__m128i *)(xcorr+i), sum0);
+      vmax = _mm_max_epi32(vmax, sum0);
+   }
+   vmax = _mm_max_epi32(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+   vmax = _mm_max_epi32(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+   maxcorr = _mm_cvtsi128_si32(vmax);
+   /* In case max_pitch isn't a multiple of 4, do non-unrolled version. */
+   for (;i<max_pitch;i++)
+   {
+      opus_val32 sum = 0;
+      for (j=0;j<len;j++)
+         sum = MAC16_16(sum, _x[j],_y[i+j]);
+      xcorr[i] = sum;
+      maxcorr = MAX32(maxcorr, sum);
+   }
+   return maxcorr;
+}
+
+#endif
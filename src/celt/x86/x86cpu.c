@@ -0,0 +1,136 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_HAVE_RTCD) && \
+  ((defined(OPUS_X86_MAY_HAVE_SSE4_1) && !defined(OPUS_X86_PRESUME_SSE4_1)) || \
+   (defined(OPUS_X86_MAY_HAVE_AVX2) && !defined(OPUS_X86_PRESUME_AVX2)))
+
+#include "x86cpu.h"
+#include "opus_types.h"
+
+#define OPUS_CPU_X86_SSE    (1)
+#define OPUS_CPU_X86_SSE2   (1<<1)
+#define OPUS_CPU_X86_SSE4_1 (1<<2)
+#define OPUS_CPU_X86_AVX2   (1<<3)
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+
+static void cpuid(unsigned int CPUInfo[4], unsigned int InfoType)
+{
+    __cpuidex((int*)CPUInfo, InfoType, 0);
+}
+
+static unsigned int xgetbv0(void)
+{
+    return (unsigned int)_xgetbv(0);
+}
+
+#elif defined(__GNUC__)
+# include <cpuid.h>
+
+static void cpuid(unsigned int CPUInfo[4], unsigned int InfoType)
+{
+    if (InfoType > __get_cpuid_max(0, 0))
+    {
+        CPUInfo[0] = CPUInfo[1] = CPUInfo[2] = CPUInfo[3] = 0;
+        return;
+    }
+    __cpuid_count(InfoType, 0, CPUInfo[0], CPUInfo[1], CPUInfo[2], CPUInfo[3]);
+}
+
+static unsigned int xgetbv0(void)
+{
+    unsigned int eax, edx;
+    __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0));
+    return eax;
+}
+
+#else
+# error "Configured to use x86 RTCD but no CPU detection method available for " \
+   "your platform. Undefine OPUS_HAVE_RTCD in config.h (or send patches)."
+#endif
+
+static opus_uint32 opus_cpu_capabilities(void)
+{
+    unsigned int info[4] = {0};
+    unsigned int nIds;
+    opus_uint32 flags = 0;
+
+    cpuid(info, 0);
+    nIds = info[0];
+
+    if (nIds >= 1)
+    {
+        cpuid(info, 1);
+        if (info[3] & (1 << 25))
+            flags |= OPUS_CPU_X86_SSE;
+        if (info[3] & (1 << 26))
+            flags |= OPUS_CPU_X86_SSE2;
+        if (info[2] & (1 << 19))
+            flags |= OPUS_CPU_X86_SSE4_1;
+        /* AVX2 needs FMA, and the OS must save the YMM registers (OSXSAVE) */
+        if ((info[2] & (1 << 12)) && (info[2] & (1 << 27)) && (xgetbv0() & 6) == 6
+              && nIds >= 7)
+        {
+            cpuid(info, 7);
+            if (info[1] & (1 << 5))
+                flags |= OPUS_CPU_X86_AVX2;
+        }
+    }
+    return flags;
+}
+
+int opus_select_arch(void)
+{
+    opus_uint32 flags = opus_cpu_capabilities();
+    int arch = 0;
+
+    if (!(flags & OPUS_CPU_X86_SSE))
+        return arch;
+    arch++;
+
+    if (!(flags & OPUS_CPU_X86_SSE2))
+        return arch;
+    arch++;
+
+    if (!(flags & OPUS_CPU_X86_SSE4_1))
+        return arch;
+    arch++;
+
+    if (!(flags & OPUS_CPU_X86_AVX2))
+        return arch;
+    arch++;
+
+    return arch;
+}
+
+#endif
@@ -35,11 +35,21 @@ POSSIBILITY OF SUCH DAMAGE.
 
 #define OPUS_BUILD            1
 
+/* Uncomment the next line to collect the per-stage OPUS_GET_PROFILE counters */
+/*#define ENABLE_PROFILING      1 */
+
 /* Enable SSE functions, if compiled with SSE/SSE2 (note that AMD64 implies SSE2) */
 #if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
 #define __SSE__               1
 #endif
 
+/* Build the SSE4.1 and AVX2 functions and pick them at run-time on x86/x64 */
+#if defined(_M_IX86) || defined(_M_X64)
+#define OPUS_X86_MAY_HAVE_SSE4_1 1
+#define OPUS_X86_MAY_HAVE_AVX2 1
+#define OPUS_HAVE_RTCD        1
+#endif
+
 #if defined(_M_ARM)
 #define HAVE_LRINTF           1
 #endif
@@ -51,6 +51,7 @@
 #include "define.h"
 #include "mathops.h"
 #include "cpu_support.h"
+#include "profile.h"
 
 struct OpusDecoder {
    int          celt_dec_offset;
@@ -59,6 +60,10 @@ struct OpusDecoder {
    opus_int32   Fs;          /** Sampling rate (at the API level) */
    silk_DecControlStruct DecControl;
    int          decode_gain;
+   int          arch;
+#ifdef ENABLE_PROFILING
+   OpusProfile  profile;
+#endif
 
    /* Everything beyond this point gets cleared on a reset */
 #define OPUS_DECODER_RESET_START stream_channels
@@ -124,6 +129,7 @@ int opus_decoder_init(OpusDecoder *st, opus_int32 Fs, int channels)
    st->Fs = Fs;
    st->DecControl.API_sampleRate = st->Fs;
    st->DecControl.nChannelsAPI      = st->channels;
+   st->arch = opus_select_arch();
 
    /* Reset decoder */
    ret = silk_InitDecoder( silk_dec );
@@ -366,7 +372,7 @@ static int opus_decode_frame(OpusDecoder *st, const unsigned char *data,
         /* Call SILK decoder */
         int first_frame = decoded_samples == 0;
         silk_ret = silk_Decode( silk_dec, &st->DecControl,
-                                lost_flag, first_frame, &dec, pcm_ptr, &silk_frame_size );
+                                lost_flag, first_frame, &dec, pcm_ptr, &silk_frame_size, st->arch );
         if( silk_ret ) {
            if (lost_flag) {
               /* PLC failure should not be fatal */
@@ -581,7 +587,7 @@ static int opus_decode_frame(OpusDecoder *st, const unsigned char *data,
 
 }
 
-int opus_decode_native(OpusDecoder *st, const unsigned char *data,
+static int opus_decode_packet(OpusDecoder *st, const unsigned char *data,
       opus_int32 len, opus_val16 *pcm, int frame_size, int decode_fec,
       int self_delimited, opus_int32 *packet_offset, int soft_clip)
 {
@@ -694,6 +700,18 @@ int opus_decode_native(OpusDecoder *st, const unsigned char *data,
    return nb_samples;
 }
 
+int opus_decode_native(OpusDecoder *st, const unsigned char *data,
+      opus_int32 len, opus_val16 *pcm, int frame_size, int decode_fec,
+      int self_delimited, opus_int32 *packet_offset, int soft_clip)
+{
+   int ret;
+   OPUS_PROFILE_ENTER(&st->profile);
+   ret = opus_decode_packet(st, data, len, pcm, frame_size, decode_fec,
+         self_delimited, packet_offset, soft_clip);
+   OPUS_PROFILE_LEAVE();
+   return ret;
+}
+
 #ifdef FIXED_POINT
 
 int opus_decode(OpusDecoder *st, const unsigned char *data,
@@ -802,6 +820,19 @@ int opus_decoder_ctl(OpusDecoder *st, int request, ...)
       *value = st->rangeFinal;
    }
    break;
+#ifdef ENABLE_PROFILING
+   case OPUS_GET_PROFILE_REQUEST:
+   {
+      OpusProfile *value = va_arg(ap, OpusProfile*);
+      if (!value)
+      {
+         goto bad_arg;
+      }
+      *value = st->profile;
+      OPUS_CLEAR(&st->profile, 1);
+   }
+   break;
+#endif
    case OPUS_RESET_STATE:
    {
       OPUS_CLEAR((char*)&st->OPUS_DECODER_RESET_START,
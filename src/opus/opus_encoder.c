@@ -41,6 +41,7 @@
 #include "opus_private.h"
 #include "os_support.h"
 #include "cpu_support.h"
+#include "profile.h"
 #include "analysis.h"
 #include "mathops.h"
 #include "tuning_parameters.h"
@@ -80,6 +81,9 @@ struct OpusEncoder {
     int          lsb_depth;
     int          encoder_buffer;
     int          lfe;
+#ifdef ENABLE_PROFILING
+    OpusProfile  profile;
+#endif
 
 #define OPUS_ENCODER_RESET_START stream_channels
     int          stream_channels;
@@ -922,7 +926,7 @@ opus_val16 compute_stereo_width(const opus_val16 *pcm, int frame_size, opus_int3
    return EXTRACT16(MIN32(Q15ONE,20*mem->max_follower));
 }
 
-opus_int32 opus_encode_native(OpusEncoder *st, const opus_val16 *pcm, int frame_size,
+static opus_int32 opus_encode_frame(OpusEncoder *st, const opus_val16 *pcm, int frame_size,
                 unsigned char *data, opus_int32 out_data_bytes, int lsb_depth,
                 const void *analysis_pcm, opus_int32 analysis_size, int c1, int c2, int analysis_channels, downmix_func downmix)
 {
@@ -1931,6 +1935,18 @@ opus_int32 opus_encode_native(OpusEncoder *st, const opus_val16 *pcm, int frame_
     return ret;
 }
 
+opus_int32 opus_encode_native(OpusEncoder *st, const opus_val16 *pcm, int frame_size,
+                unsigned char *data, opus_int32 out_data_bytes, int lsb_depth,
+                const void *analysis_pcm, opus_int32 analysis_size, int c1, int c2, int analysis_channels, downmix_func downmix)
+{
+    opus_int32 ret;
+    OPUS_PROFILE_ENTER(&st->profile);
+    ret = opus_encode_frame(st, pcm, frame_size, data, out_data_bytes, lsb_depth,
+          analysis_pcm, analysis_size, c1, c2, analysis_channels, downmix);
+    OPUS_PROFILE_LEAVE();
+    return ret;
+}
+
 #ifdef FIXED_POINT
 
 #ifndef DISABLE_FLOAT_API
@@ -2354,6 +2370,19 @@ int opus_encoder_ctl(OpusEncoder *st, int request, ...)
             *value = st->rangeFinal;
         }
         break;
+#ifdef ENABLE_PROFILING
+        case OPUS_GET_PROFILE_REQUEST:
+        {
+            OpusProfile *value = va_arg(ap, OpusProfile*);
+            if (!value)
+            {
+               goto bad_arg;
+            }
+            *value = st->profile;
+            OPUS_CLEAR(&st->profile, 1);
+        }
+        break;
+#endif
         case OPUS_SET_LSB_DEPTH_REQUEST:
         {
             opus_int32 value = va_arg(ap, opus_int32);
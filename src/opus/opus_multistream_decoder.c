@@ -457,6 +457,36 @@ int opus_multistream_decoder_ctl(OpusMSDecoder *st, int request, ...)
           }
        }
        break;
+#ifdef ENABLE_PROFILING
+       case OPUS_GET_PROFILE_REQUEST:
+       {
+          int s, i;
+          OpusProfile *value = va_arg(ap, OpusProfile*);
+          OpusProfile tmp;
+          if (!value)
+          {
+             goto bad_arg;
+          }
+          OPUS_CLEAR(value, 1);
+          for (s=0;s<st->layout.nb_streams;s++)
+          {
+             OpusDecoder *dec;
+             dec = (OpusDecoder*)ptr;
+             if (s < st->layout.nb_coupled_streams)
+                ptr += align(coupled_size);
+             else
+                ptr += align(mono_size);
+             ret = opus_decoder_ctl(dec, request, &tmp);
+             if (ret != OPUS_OK) break;
+             for (i=0;i<OPUS_PROFILE_STAGES;i++)
+             {
+                value->ticks[i] += tmp.ticks[i];
+                value->calls[i] += tmp.calls[i];
+             }
+          }
+       }
+       break;
+#endif
        case OPUS_RESET_STATE:
        {
           int s;
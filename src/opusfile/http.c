@@ -209,6 +209,87 @@ static const char *op_parse_file_url(const char *_src){
   return path;
 }
 
+/*The default maximum number of simultaneous connections.
+  RFC 2616 says this SHOULD NOT be more than 2, but everyone on the modern web
+   ignores that (e.g., IE 8 bumped theirs up from 2 to 6, Firefox uses 15).
+  If it makes you feel better, unless parallel fetching is enabled, we'll only
+   ever actively read from one of these at a time.
+  The others are kept around mainly to avoid slow-starting a new connection
+   when seeking, and time out rapidly.*/
+#define OP_NCONNS_DEFAULT (4)
+/*The most connections the application may ask for.*/
+#define OP_NCONNS_MAX     (16)
+
+/*The default capacity of the block cache for seekable streams.*/
+#define OP_CACHE_SIZE_DEFAULT       (1024*(opus_int32)1024)
+/*The default size of a block in the cache.
+  This matches OP_PIPELINE_CHUNK_SIZE, so that a single missing block costs a
+   single pipelined request.*/
+#define OP_CACHE_BLOCK_SIZE_DEFAULT (32*(opus_int32)1024)
+/*The range of block sizes we accept from the application.*/
+#define OP_CACHE_BLOCK_SIZE_MIN     (512)
+#define OP_CACHE_BLOCK_SIZE_MAX     (16*1024*(opus_int32)1024)
+
+/*By default, we will always attempt to read ahead at least this much in
+   preference to opening a new connection.*/
+#define OP_READAHEAD_THRESH_MIN (32*(opus_int32)1024)
+
+/*The default amount of data to request after a seek.
+  This is a trade-off between read throughput after a seek vs. the the ability
+   to quickly perform another seek with the same connection.
+  With adaptive chunk sizing, this is only a lower bound.*/
+#define OP_PIPELINE_CHUNK_SIZE     (32*(opus_int32)1024)
+/*Subsequent chunks are requested with larger and larger sizes until they pass
+   this threshold, after which we just ask for the rest of the resource.*/
+#define OP_PIPELINE_CHUNK_SIZE_MAX (1024*(opus_int32)1024)
+/*The largest chunk size the application may ask for.
+  This keeps the doubling of the chunk size from overflowing.*/
+#define OP_PIPELINE_CHUNK_SIZE_LIMIT (512*1024*(opus_int32)1024)
+
+/*The tunable parameters of an http(s) stream, collected from the options
+   passed to op_url_stream_vcreate().*/
+typedef struct OpusHTTPParams OpusHTTPParams;
+
+struct OpusHTTPParams{
+  /*The capacity of the block cache, or 0 to disable it.*/
+  opus_int32  cache_size;
+  /*The size of a block in the cache.*/
+  opus_int32  cache_block_size;
+  /*The file to keep the cache in, or NULL to keep it in memory.*/
+  const char *cache_path;
+  /*The maximum number of simultaneous connections.*/
+  int         nconns;
+  /*Whether or not to fetch blocks over several connections at once.*/
+  int         parallel;
+  /*Whether or not to size requests from the measured bandwidth and latency.*/
+  int         adaptive;
+  /*The smallest amount of data to request after a seek.*/
+  opus_int32  chunk_size_min;
+  /*The largest chunk we'll request before asking for the rest of the
+     resource.*/
+  opus_int32  chunk_size_max;
+  /*The least we'll read ahead in preference to opening a new connection.*/
+  opus_int32  read_ahead_min;
+  /*Whether or not to return OP_EAGAIN instead of waiting for the cache.*/
+  int         nonblocking;
+  /*The client to share connections with, if any.*/
+  OpusHTTPClient *client;
+};
+
+static void op_http_params_init(OpusHTTPParams *_params){
+  _params->cache_size=OP_CACHE_SIZE_DEFAULT;
+  _params->cache_block_size=OP_CACHE_BLOCK_SIZE_DEFAULT;
+  _params->cache_path=NULL;
+  _params->nconns=OP_NCONNS_DEFAULT;
+  _params->parallel=0;
+  _params->adaptive=1;
+  _params->chunk_size_min=OP_PIPELINE_CHUNK_SIZE;
+  _params->chunk_size_max=OP_PIPELINE_CHUNK_SIZE_MAX;
+  _params->read_ahead_min=OP_READAHEAD_THRESH_MIN;
+  _params->nonblocking=0;
+  _params->client=NULL;
+}
+
 #if defined(OP_ENABLE_HTTP)
 # if defined(_WIN32)
 #  include <winsock2.h>
@@ -350,14 +431,12 @@ typedef int op_sock;
 # include <sys/timeb.h>
 # include <openssl/x509v3.h>
 
-/*The maximum number of simultaneous connections.
-  RFC 2616 says this SHOULD NOT be more than 2, but everyone on the modern web
-   ignores that (e.g., IE 8 bumped theirs up from 2 to 6, Firefox uses 15).
-  If it makes you feel better, we'll only ever actively read from one of these
-   at a time.
-  The others are kept around mainly to avoid slow-starting a new connection
-   when seeking, and time out rapidly.*/
-# define OP_NCONNS_MAX (4)
+/*OpenSSL 1.1 made BIO opaque and renamed a few functions.*/
+# if OPENSSL_VERSION_NUMBER<0x10100000L
+#  define BIO_set_data(_b,_ptr) ((_b)->ptr=(_ptr))
+#  define BIO_set_init(_b,_init) ((_b)->init=(_init))
+#  define ASN1_STRING_get0_data ASN1_STRING_data
+# endif
 
 /*The amount of time before we attempt to re-resolve the host.
   This is 10 minutes, as recommended in RFC 6555 for expiring cached connection
@@ -391,17 +470,13 @@ typedef int op_sock;
    up.*/
 # define OP_POLL_TIMEOUT_MS (30*1000)
 
-/*We will always attempt to read ahead at least this much in preference to
-   opening a new connection.*/
-# define OP_READAHEAD_THRESH_MIN (32*(opus_int32)1024)
+/*The states of a connection that op_http_connect_start() is still setting up
+   in the background.*/
+/*Waiting for the TCP connection to be established.*/
+# define OP_HTTP_CONNECTING  (1)
+/*Waiting for the TLS handshake to finish.*/
+# define OP_HTTP_HANDSHAKING (2)
 
-/*The amount of data to request after a seek.
-  This is a trade-off between read throughput after a seek vs. the the ability
-   to quickly perform another seek with the same connection.*/
-# define OP_PIPELINE_CHUNK_SIZE     (32*(opus_int32)1024)
-/*Subsequent chunks are requested with larger and larger sizes until they pass
-   this threshold, after which we just ask for the rest of the resource.*/
-# define OP_PIPELINE_CHUNK_SIZE_MAX (1024*(opus_int32)1024)
 /*This is the maximum number of requests we'll make with a single connection.
   Many servers will simply disconnect after we attempt some number of requests,
    possibly without sending a Connection: close header, meaning we won't
@@ -418,6 +493,16 @@ typedef int op_sock;
    while reading forward afterwards.*/
 # define OP_PIPELINE_MIN_REQUESTS   (7)
 
+/*How far the reads since the last seek must have gone before we start
+   prefetching ahead of them.
+  This keeps the short bursts of sequential reading done while opening a file
+   (e.g., reading back a chunk from the end) from triggering prefetches of data
+   nobody will read.*/
+# define OP_PREFETCH_THRESH    (128*(opus_int32)1024)
+/*How much of the end of the resource to prefetch when a stream is opened.
+  This is enough for the first chunk op_get_last_page() reads.*/
+# define OP_PREFETCH_TAIL_SIZE (64*(opus_int32)1024)
+
 /*Is this an https URL?
   For now we can simply check the last letter of the scheme.*/
 # define OP_URL_IS_SSL(_url) ((_url)->scheme[4]=='s')
@@ -799,6 +884,9 @@ struct OpusHTTPConn{
   int           nrequests_left;
   /*The chunk size to use for pipelining requests.*/
   opus_int32    chunk_size;
+  /*Whether or not the server may keep this connection open after the current
+     request (i.e., we sent it as HTTP/1.1).*/
+  int           keep_alive;
 };
 
 static void op_http_conn_init(OpusHTTPConn *_conn){
@@ -806,6 +894,8 @@ static void op_http_conn_init(OpusHTTPConn *_conn){
   _conn->ssl_conn=NULL;
   _conn->next=NULL;
   _conn->fd=OP_INVALID_SOCKET;
+  _conn->read_rate=0;
+  _conn->keep_alive=0;
 }
 
 static void op_http_conn_clear(OpusHTTPConn *_conn){
@@ -814,10 +904,136 @@ static void op_http_conn_clear(OpusHTTPConn *_conn){
   if(_conn->fd!=OP_INVALID_SOCKET)close(_conn->fd);
 }
 
+/*A slot in the block cache.*/
+typedef struct OpusHTTPCacheSlot OpusHTTPCacheSlot;
+/*A prefetch of a run of blocks using a connection of its own.*/
+typedef struct OpusHTTPFetch     OpusHTTPFetch;
+
+/*A cache of fixed-size blocks of a seekable resource.
+  Opening a file revisits the same few regions over and over (the first page,
+   the last page, the bisection points between links), and so does an
+   application that scrubs back and forth, so without this almost every seek
+   would cost us a new request.
+  When the cache is enabled, the stream callbacks are served entirely from it,
+   and the connections are only used to fill it.*/
+typedef struct OpusHTTPCache     OpusHTTPCache;
+
+struct OpusHTTPCacheSlot{
+  /*The index of the block stored in this slot, or -1 if it is unused.*/
+  opus_int64 block;
+  /*The number of valid bytes in the block.
+    This is only less than the block size for the last block of the
+     resource, or while the block is being prefetched.*/
+  opus_int32 len;
+  /*The index of the prefetch filling this block, or -1 if it is complete.*/
+  int        fetchi;
+  /*The next slot in the same hash chain, or -1.*/
+  int        hash_next;
+  /*The previous (more recently used) and next (less recently used) slots in
+     the LRU list, or -1.*/
+  int        lru_prev;
+  int        lru_next;
+};
+
+struct OpusHTTPFetch{
+  /*The connection this prefetch is reading from, or NULL if it is idle.
+    While a prefetch is running, its connection is on neither the LRU list nor
+     the free list, so nothing else will try to use it.*/
+  OpusHTTPConn  *conn;
+  /*A buffer used to stage blocks on their way into the cache file.*/
+  unsigned char *buf;
+  /*The next block to fill.*/
+  opus_int64     block;
+  /*The end of the range requested.*/
+  opus_int64     end;
+  /*The response headers received so far, in non-blocking mode.*/
+  OpusStringBuf  response;
+  /*The last time the prefetch made progress.*/
+  struct timeb   progress_time;
+  /*OP_HTTP_CONNECTING or OP_HTTP_HANDSHAKING while the connection is still
+     being set up (and the request has not been sent), or 0.*/
+  int            connecting;
+  /*What to poll() for while the connection is being set up.*/
+  short          events;
+  /*Whether or not we've parsed the response headers yet.*/
+  int            started;
+};
+
+struct OpusHTTPCache{
+  /*The slots, or NULL if the cache is disabled.*/
+  OpusHTTPCacheSlot *slots;
+  /*The head of the hash chain for each bucket, or -1.*/
+  int               *buckets;
+  /*The block storage, if it is kept in memory.*/
+  unsigned char     *data;
+  /*The block storage, if it is kept in a file.*/
+  void              *file;
+  OpusFileCallbacks  file_cb;
+  /*A buffer used to stage blocks on their way in or out of the file.*/
+  unsigned char     *file_buf;
+  /*The position indicator exposed through the stream callbacks.*/
+  opus_int64         pos;
+  /*The size of each block.*/
+  opus_int32         block_size;
+  /*The number of slots.*/
+  int                nslots;
+  /*The number of slots that have been used at least once.
+    Slots are handed out in order until this reaches nslots, after which we
+     start evicting.*/
+  int                nused;
+  /*The number of hash buckets, minus one (it is a power of two).*/
+  int                bucket_mask;
+  /*The most and least recently used slots, or -1 if none are in use.*/
+  int                lru_head;
+  int                lru_tail;
+  /*The prefetches, or NULL if parallel fetching is disabled.*/
+  OpusHTTPFetch     *fetches;
+  /*The number of prefetches that can run at once.
+    This is one less than the number of connections, so that there is always
+     one left over for reading directly.*/
+  int                nfetches;
+  /*The number of slots waiting on a prefetch.*/
+  int                npending;
+  /*The position at which the current run of sequential reads started, and
+     the position at which the last read ended.*/
+  opus_int64         seq_start;
+  opus_int64         seq_end;
+};
+
+static void op_http_cache_init(OpusHTTPCache *_cache){
+  _cache->slots=NULL;
+  _cache->buckets=NULL;
+  _cache->data=NULL;
+  _cache->file=NULL;
+  _cache->file_buf=NULL;
+  _cache->fetches=NULL;
+  _cache->nfetches=0;
+}
+
+static void op_http_cache_clear(OpusHTTPCache *_cache){
+  int fi;
+  for(fi=0;fi<_cache->nfetches;fi++){
+    OpusHTTPConn *conn;
+    /*Running prefetches own their connections, so close those here.*/
+    conn=_cache->fetches[fi].conn;
+    if(conn!=NULL)op_http_conn_clear(conn);
+    _ogg_free(_cache->fetches[fi].buf);
+    op_sb_clear(&_cache->fetches[fi].response);
+  }
+  _ogg_free(_cache->fetches);
+  if(_cache->file!=NULL)(*_cache->file_cb.close)(_cache->file);
+  _ogg_free(_cache->file_buf);
+  _ogg_free(_cache->data);
+  _ogg_free(_cache->buckets);
+  _ogg_free(_cache->slots);
+}
+
 /*The global stream state.*/
 struct OpusHTTPStream{
   /*The list of connections.*/
-  OpusHTTPConn     conns[OP_NCONNS_MAX];
+  OpusHTTPConn    *conns;
+  /*The number of connections.*/
+  int              nconns;
   /*The context object used as a framework for TLS/SSL functions.*/
   SSL_CTX         *ssl_ctx;
   /*The cached session to reuse for future connections.*/
@@ -869,26 +1085,235 @@ struct OpusHTTPStream{
   int              request_tail;
   /*The estimated time required to open a new connection, in milliseconds.*/
   opus_int32       connect_rate;
+  /*Whether or not to size requests from the measured bandwidth and latency.*/
+  int              adaptive;
+  /*The smallest amount of data to request after a seek.*/
+  opus_int32       chunk_size_min;
+  /*The largest chunk we'll request before asking for the rest of the
+     resource.*/
+  opus_int32       chunk_size_max;
+  /*The least we'll read ahead in preference to opening a new connection.*/
+  opus_int32       read_ahead_min;
+  /*Whether or not to return OP_EAGAIN instead of waiting for the cache.*/
+  int              nonblocking;
+  /*The block cache.*/
+  OpusHTTPCache    cache;
+  /*The client we share connections with, or NULL.*/
+  OpusHTTPClient  *client;
+};
+
+/*The maximum number of idle connections a client keeps for each route.*/
+# define OP_CLIENT_IDLE_MAX (OP_NCONNS_MAX)
+
+/*An idle persistent connection parked in a client between streams.*/
+typedef struct OpusHTTPIdleConn OpusHTTPIdleConn;
+/*Everything a client remembers about one route to a server.*/
+typedef struct OpusHTTPRoute    OpusHTTPRoute;
+
+struct OpusHTTPIdleConn{
+  /*The next (less recently parked) connection.*/
+  OpusHTTPIdleConn *next;
+  /*The SSL connection, if this is https.*/
+  SSL              *ssl_conn;
+  /*The time the connection was parked.*/
+  struct timeb      idle_time;
+  /*The estimated throughput of the connection, in bytes/s.*/
+  opus_int64        read_rate;
+  /*The socket.*/
+  op_sock           fd;
+  /*The number of remaining requests we are allowed on this connection.*/
+  int               nrequests_left;
+};
+
+/*A route is identified by the server named in the URL and the host we actually
+   connect to (which differ when proxying), along with whether or not we are
+   using TLS and checking certificates.*/
+struct OpusHTTPRoute{
+  /*The next route in the client's list.*/
+  OpusHTTPRoute    *next;
+  /*The host and port from the URL.*/
+  char             *host;
+  unsigned          port;
+  /*The host and port we connect to.*/
+  char             *connect_host;
+  unsigned          connect_port;
+  /*Whether or not this is https.*/
+  int               ssl;
+  /*Whether or not we skip certificate checks (for https).*/
+  int               skip_certificate_check;
+  /*Whether or not we have an address for connect_host.*/
+  int               have_addr;
+  /*The address we last connected to, and when it was resolved.*/
+  struct addrinfo   addr_info;
+  union{
+    struct sockaddr     s;
+    struct sockaddr_in  v4;
+    struct sockaddr_in6 v6;
+  }                 addr;
+  struct timeb      resolve_time;
+  /*The last TLS session established with the server, for resumption.*/
+  SSL_SESSION      *ssl_session;
+  /*The idle connections, most recently parked first.*/
+  OpusHTTPIdleConn *idle;
+  /*The number of idle connections.*/
+  int               nidle;
+};
+
+struct OpusHTTPClient{
+  /*Protects everything below, except refs.*/
+  op_mutex          mutex;
+  /*The number of references to the client (the application's and one per
+     stream).*/
+  opus_uint32       refs;
+  /*The TLS contexts, indexed by whether or not they skip certificate checks.
+    These are created the first time they are needed.*/
+  SSL_CTX          *ssl_ctx[2];
+  /*The routes we have connected over so far.*/
+  OpusHTTPRoute    *routes;
 };
 
-static void op_http_stream_init(OpusHTTPStream *_stream){
+static void op_http_idle_conn_free(OpusHTTPIdleConn *_idle){
+  if(_idle->ssl_conn!=NULL)SSL_free(_idle->ssl_conn);
+  close(_idle->fd);
+  _ogg_free(_idle);
+}
+
+/*Find the route the stream is currently using.
+  The client must be locked.
+  _create: Whether or not to add the route if it is not there.
+  Return: The route, or NULL if it was not found (or we ran out of memory).*/
+static OpusHTTPRoute *op_http_client_route(OpusHTTPClient *_client,
+ const OpusHTTPStream *_stream,int _create){
+  OpusHTTPRoute *route;
+  int            ssl;
+  int            skip_certificate_check;
+  ssl=OP_URL_IS_SSL(&_stream->url);
+  skip_certificate_check=ssl&&_stream->skip_certificate_check;
+  for(route=_client->routes;route!=NULL;route=route->next){
+    if(route->ssl==ssl&&route->skip_certificate_check==skip_certificate_check
+     &&route->port==_stream->url.port
+     &&route->connect_port==_stream->connect_port
+     &&strcmp(route->host,_stream->url.host)==0
+     &&strcmp(route->connect_host,_stream->connect_host)==0){
+      return route;
+    }
+  }
+  if(!_create)return NULL;
+  route=(OpusHTTPRoute *)_ogg_malloc(sizeof(*route));
+  if(OP_UNLIKELY(route==NULL))return NULL;
+  route->host=op_string_dup(_stream->url.host);
+  route->connect_host=op_string_dup(_stream->connect_host);
+  if(OP_UNLIKELY(route->host==NULL)||OP_UNLIKELY(route->connect_host==NULL)){
+    _ogg_free(route->connect_host);
+    _ogg_free(route->host);
+    _ogg_free(route);
+    return NULL;
+  }
+  route->port=_stream->url.port;
+  route->connect_port=_stream->connect_port;
+  route->ssl=ssl;
+  route->skip_certificate_check=skip_certificate_check;
+  route->have_addr=0;
+  route->ssl_session=NULL;
+  route->idle=NULL;
+  route->nidle=0;
+  route->next=_client->routes;
+  _client->routes=route;
+  return route;
+}
+
+/*Can this connection be handed to another stream?
+  It must be between requests, with all of the last response read and nothing
+   more requested, and the server must be willing to take more requests on
+   it.*/
+static int op_http_conn_is_idle(const OpusHTTPStream *_stream,
+ const OpusHTTPConn *_conn){
+  return _stream->pipeline&&_conn->keep_alive&&_conn->fd!=OP_INVALID_SOCKET
+   &&_conn->nrequests_left>0&&_conn->next_pos<0
+   &&_conn->end_pos>=0&&_conn->pos==_conn->end_pos;
+}
+
+/*Hand an idle connection over to the stream's client.
+  On success, the connection's socket and SSL connection belong to the client,
+   and the connection is left empty, to be closed as usual.*/
+static void op_http_client_park(OpusHTTPStream *_stream,OpusHTTPConn *_conn){
+  OpusHTTPClient   *client;
+  OpusHTTPRoute    *route;
+  OpusHTTPIdleConn *idle;
+  client=_stream->client;
+  idle=(OpusHTTPIdleConn *)_ogg_malloc(sizeof(*idle));
+  if(OP_UNLIKELY(idle==NULL))return;
+  op_mutex_lock(&client->mutex);
+  route=op_http_client_route(client,_stream,1);
+  if(OP_UNLIKELY(route==NULL)){
+    op_mutex_unlock(&client->mutex);
+    _ogg_free(idle);
+    return;
+  }
+  idle->ssl_conn=_conn->ssl_conn;
+  idle->fd=_conn->fd;
+  idle->read_rate=_conn->read_rate;
+  idle->nrequests_left=_conn->nrequests_left;
+  ftime(&idle->idle_time);
+  idle->next=route->idle;
+  route->idle=idle;
+  /*If we have too many, drop the one that has been idle the longest.*/
+  if(route->nidle>=OP_CLIENT_IDLE_MAX){
+    OpusHTTPIdleConn **pnext;
+    for(pnext=&route->idle;(*pnext)->next!=NULL;pnext=&(*pnext)->next);
+    idle=*pnext;
+    *pnext=NULL;
+  }
+  else{
+    route->nidle++;
+    idle=NULL;
+  }
+  op_mutex_unlock(&client->mutex);
+  if(idle!=NULL)op_http_idle_conn_free(idle);
+  _conn->ssl_conn=NULL;
+  _conn->fd=OP_INVALID_SOCKET;
+}
+
+/*Initialize the stream.
+  _params: The tunable parameters of the stream.
+  Return: 0 on success, or a negative value if we ran out of memory.
+          The stream must be cleared either way.*/
+static int op_http_stream_init(OpusHTTPStream *_stream,
+ const OpusHTTPParams *_params){
   OpusHTTPConn **pnext;
   int            ci;
+  _stream->conns=(OpusHTTPConn *)_ogg_malloc(
+   sizeof(*_stream->conns)*_params->nconns);
+  _stream->nconns=_stream->conns!=NULL?_params->nconns:0;
   pnext=&_stream->free_head;
-  for(ci=0;ci<OP_NCONNS_MAX;ci++){
+  for(ci=0;ci<_stream->nconns;ci++){
     op_http_conn_init(_stream->conns+ci);
     *pnext=_stream->conns+ci;
     pnext=&_stream->conns[ci].next;
   }
+  *pnext=NULL;
   _stream->ssl_ctx=NULL;
   _stream->ssl_session=NULL;
   _stream->lru_head=NULL;
+  /*We don't know where the host is yet.*/
+  _stream->addr_info.ai_addr=NULL;
   op_parsed_url_init(&_stream->url);
   op_sb_init(&_stream->request);
   op_sb_init(&_stream->proxy_connect);
   op_sb_init(&_stream->response);
   _stream->connect_host=NULL;
   _stream->seekable=0;
+  _stream->adaptive=_params->adaptive;
+  _stream->chunk_size_min=_params->chunk_size_min;
+  _stream->chunk_size_max=_params->chunk_size_max;
+  _stream->read_ahead_min=_params->read_ahead_min;
+  _stream->nonblocking=_params->nonblocking;
+  _stream->pipeline=0;
+  _stream->skip_certificate_check=0;
+  _stream->client=_params->client;
+  if(_stream->client!=NULL)OP_ATOMIC_FETCH_INC(&_stream->client->refs);
+  op_http_cache_init(&_stream->cache);
+  return _stream->conns!=NULL?0:OP_EFAULT;
 }
 
 /*Close the connection and move it to the free list.
@@ -920,15 +1345,26 @@ static void op_http_conn_close(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
 
 static void op_http_stream_clear(OpusHTTPStream *_stream){
   while(_stream->lru_head!=NULL){
+    /*Give any connection another stream could use to our client.*/
+    if(_stream->client!=NULL
+     &&op_http_conn_is_idle(_stream,_stream->lru_head)){
+      op_http_client_park(_stream,_stream->lru_head);
+    }
     op_http_conn_close(_stream,_stream->lru_head,&_stream->lru_head,0);
   }
   if(_stream->ssl_session!=NULL)SSL_SESSION_free(_stream->ssl_session);
-  if(_stream->ssl_ctx!=NULL)SSL_CTX_free(_stream->ssl_ctx);
+  /*The client owns its TLS context.*/
+  if(_stream->ssl_ctx!=NULL&&_stream->client==NULL){
+    SSL_CTX_free(_stream->ssl_ctx);
+  }
   op_sb_clear(&_stream->response);
   op_sb_clear(&_stream->proxy_connect);
   op_sb_clear(&_stream->request);
   if(_stream->connect_host!=_stream->url.host)_ogg_free(_stream->connect_host);
   op_parsed_url_clear(&_stream->url);
+  op_http_cache_clear(&_stream->cache);
+  _ogg_free(_stream->conns);
+  op_http_client_release(_stream->client);
 }
 
 static int op_http_conn_write_fully(OpusHTTPConn *_conn,
@@ -1021,6 +1457,46 @@ static void op_http_conn_read_rate_update(OpusHTTPConn *_conn){
   _conn->read_rate=read_rate;
 }
 
+/*Estimate the rate at which we can read from the given connection, in bytes
+   per second.
+  A connection that was just opened has no estimate of its own yet.
+  With adaptive chunk sizing, we borrow the best estimate from any of the other
+   connections to the same server instead, since they share most of the same
+   path.
+  _conn: The connection to estimate the rate of, or NULL for the stream as a
+          whole.*/
+static opus_int64 op_http_stream_read_rate(const OpusHTTPStream *_stream,
+ const OpusHTTPConn *_conn){
+  opus_int64 read_rate;
+  int        ci;
+  read_rate=_conn!=NULL?_conn->read_rate:0;
+  if(read_rate<=0&&_stream->adaptive){
+    for(ci=0;ci<_stream->nconns;ci++){
+      read_rate=OP_MAX(read_rate,_stream->conns[ci].read_rate);
+    }
+  }
+  return read_rate;
+}
+
+/*Pick the amount of data to request after a seek.
+  With adaptive chunk sizing, we ask for at least the bandwidth-delay product
+   of the path to the server, using the time it takes to open a connection as
+   an estimate of the round-trip time.
+  Asking for less leaves the connection idle for most of the time it takes to
+   make each request, which wastes most of the bandwidth of a long, fast path.
+  Asking for much more commits the connection to data we may never read if we
+   seek again.*/
+static opus_int32 op_http_stream_chunk_size(const OpusHTTPStream *_stream){
+  opus_int64 chunk_size;
+  chunk_size=_stream->chunk_size_min;
+  if(_stream->adaptive){
+    chunk_size=OP_MAX(chunk_size,
+     op_http_stream_read_rate(_stream,NULL)*_stream->connect_rate/1000);
+    chunk_size=OP_MIN(chunk_size,_stream->chunk_size_max);
+  }
+  return (opus_int32)chunk_size;
+}
+
 /*Tries to read from the given connection.
   [out] _buf: Returns the data read.
   _buf_size:  The size of the buffer.
@@ -1102,8 +1578,13 @@ static int op_http_conn_read(OpusHTTPConn *_conn,
 
 /*Tries to look at the pending data for a connection without consuming it.
   [out] _buf: Returns the data at which we're peeking.
-  _buf_size:  The size of the buffer.*/
-static int op_http_conn_peek(OpusHTTPConn *_conn,char *_buf,int _buf_size){
+  _buf_size:  The size of the buffer.
+  _blocking:  Whether or not to block until some data is available.
+  Return: The number of bytes available, 0 if the connection was closed or
+           there was an error, or OP_EAGAIN if there was no data yet and
+           _blocking was not set.*/
+static int op_http_conn_peek(OpusHTTPConn *_conn,
+ char *_buf,int _buf_size,int _blocking){
   struct pollfd   fd;
   SSL            *ssl_conn;
   int             ret;
@@ -1130,6 +1611,7 @@ static int op_http_conn_peek(OpusHTTPConn *_conn,char *_buf,int _buf_size){
       if(err!=EAGAIN&&err!=EWOULDBLOCK)return 0;
       fd.events=POLLIN;
     }
+    if(!_blocking)return OP_EAGAIN;
     /*Need to wait to get any data at all.*/
     if(poll(&fd,1,OP_POLL_TIMEOUT_MS)<=0)return 0;
   }
@@ -1141,13 +1623,18 @@ static int op_http_conn_peek(OpusHTTPConn *_conn,char *_buf,int _buf_size){
 
 /*Reads the entirety of a response to an HTTP request into the response buffer.
   Actual parsing and validation is done later.
+  _blocking: Whether or not to wait for the whole response.
+             If this is not set, whatever has arrived is appended to the
+              response buffer, which the caller must empty before the first
+              call.
   Return: The number of bytes in the response on success, OP_EREAD if the
-           connection was closed before reading any data, or another negative
-           value on any other error.*/
+           connection was closed before reading any data, OP_EAGAIN if
+           _blocking was not set and the rest of the response has not arrived
+           yet, or another negative value on any other error.*/
 static int op_http_conn_read_response(OpusHTTPConn *_conn,
- OpusStringBuf *_response){
+ OpusStringBuf *_response,int _blocking){
   int ret;
-  _response->nbuf=0;
+  if(_blocking)_response->nbuf=0;
   ret=op_sb_ensure_capacity(_response,OP_RESPONSE_SIZE_MIN);
   if(OP_UNLIKELY(ret<0))return ret;
   for(;;){
@@ -1167,7 +1654,8 @@ static int op_http_conn_read_response(OpusHTTPConn *_conn,
       if(OP_UNLIKELY(size>=capacity))return OP_EIMPL;
     }
     buf=_response->buf;
-    ret=op_http_conn_peek(_conn,buf+size,capacity-size);
+    ret=op_http_conn_peek(_conn,buf+size,capacity-size,_blocking);
+    if(ret==OP_EAGAIN)return ret;
     if(OP_UNLIKELY(ret<=0))return size<=0?OP_EREAD:OP_FALSE;
     /*We read some data.*/
     /*Make sure the starting characters are "HTTP".
@@ -1518,9 +2006,11 @@ static long op_bio_retry_ctrl(BIO *_b,int _cmd,long _num,void *_ptr){
 }
 
 static int op_bio_retry_new(BIO *_b){
-  _b->init=1;
+  BIO_set_init(_b,1);
+# if OPENSSL_VERSION_NUMBER<0x10100000L
   _b->num=0;
-  _b->ptr=NULL;
+# endif
+  BIO_set_data(_b,NULL);
   return 1;
 }
 
@@ -1528,6 +2018,7 @@ static int op_bio_retry_free(BIO *_b){
   return _b!=NULL;
 }
 
+# if OPENSSL_VERSION_NUMBER<0x10100000L
 /*This is not const because OpenSSL doesn't allow it, even though it won't
    write to it.*/
 static BIO_METHOD op_bio_retry_method={
@@ -1542,32 +2033,71 @@ static BIO_METHOD op_bio_retry_method={
   op_bio_retry_free,
   NULL
 };
+# endif
+
+/*Get the BIO_METHOD for a BIO that always asks to retry.
+  With OpenSSL 1.1 and later this has to be allocated, and the caller must
+   free it with op_bio_retry_method_free() once the BIO is gone.
+  Return: The method, or NULL if we ran out of memory.*/
+static BIO_METHOD *op_bio_retry_method_create(void){
+# if OPENSSL_VERSION_NUMBER<0x10100000L
+  return &op_bio_retry_method;
+# else
+  BIO_METHOD *method;
+  method=BIO_meth_new(BIO_TYPE_NULL,"retry");
+  if(OP_LIKELY(method!=NULL)){
+    BIO_meth_set_write(method,op_bio_retry_write);
+    BIO_meth_set_read(method,op_bio_retry_read);
+    BIO_meth_set_puts(method,op_bio_retry_puts);
+    BIO_meth_set_ctrl(method,op_bio_retry_ctrl);
+    BIO_meth_set_create(method,op_bio_retry_new);
+    BIO_meth_set_destroy(method,op_bio_retry_free);
+  }
+  return method;
+# endif
+}
+
+static void op_bio_retry_method_free(BIO_METHOD *_method){
+# if OPENSSL_VERSION_NUMBER<0x10100000L
+  (void)_method;
+# else
+  BIO_meth_free(_method);
+# endif
+}
 
 /*Establish a CONNECT tunnel and pipeline the start of the TLS handshake for
    proxying https URL requests.*/
 static int op_http_conn_establish_tunnel(OpusHTTPStream *_stream,
  OpusHTTPConn *_conn,op_sock _fd,SSL *_ssl_conn,BIO *_ssl_bio){
-  BIO  *retry_bio;
-  char *status_code;
-  char *next;
-  int   ret;
+  BIO_METHOD *retry_method;
+  BIO        *retry_bio;
+  char       *status_code;
+  char       *next;
+  int         ret;
   _conn->ssl_conn=NULL;
   _conn->fd=_fd;
   OP_ASSERT(_stream->proxy_connect.nbuf>0);
   ret=op_http_conn_write_fully(_conn,
    _stream->proxy_connect.buf,_stream->proxy_connect.nbuf);
   if(OP_UNLIKELY(ret<0))return ret;
-  retry_bio=BIO_new(&op_bio_retry_method);
-  if(OP_UNLIKELY(retry_bio==NULL))return OP_EFAULT;
+  retry_method=op_bio_retry_method_create();
+  if(OP_UNLIKELY(retry_method==NULL))return OP_EFAULT;
+  retry_bio=BIO_new(retry_method);
+  if(OP_UNLIKELY(retry_bio==NULL)){
+    op_bio_retry_method_free(retry_method);
+    return OP_EFAULT;
+  }
   SSL_set_bio(_ssl_conn,retry_bio,_ssl_bio);
   SSL_set_connect_state(_ssl_conn);
   /*This shouldn't succeed, since we can't read yet.*/
   OP_ALWAYS_TRUE(SSL_connect(_ssl_conn)<0);
+  /*This frees retry_bio, so its method can go too.*/
   SSL_set_bio(_ssl_conn,_ssl_bio,_ssl_bio);
+  op_bio_retry_method_free(retry_method);
   /*Only now do we disable write coalescing, to allow the CONNECT
      request and the start of the TLS handshake to be combined.*/
   op_sock_set_tcp_nodelay(_fd,1);
-  ret=op_http_conn_read_response(_conn,&_stream->response);
+  ret=op_http_conn_read_response(_conn,&_stream->response,1);
   if(OP_UNLIKELY(ret<0))return ret;
   next=op_http_parse_status_line(NULL,&status_code,_stream->response.buf);
   /*According to RFC 2817, "Any successful (2xx) response to a
@@ -1589,7 +2119,7 @@ static int op_http_hostname_match(const char *_host,size_t _host_len,
   size_t      pattern_label_len;
   size_t      pattern_prefix_len;
   size_t      pattern_suffix_len;
-  pattern=(const char *)ASN1_STRING_data(_pattern);
+  pattern=(const char *)ASN1_STRING_get0_data(_pattern);
   pattern_len=strlen(pattern);
   /*Check the pattern for embedded NULs.*/
   if(OP_UNLIKELY(pattern_len!=(size_t)ASN1_STRING_length(_pattern)))return 0;
@@ -1759,7 +2289,7 @@ static int op_http_verify_hostname(OpusHTTPStream *_stream,SSL *_ssl_conn){
         }
       }
       else if(name->type==GEN_IPADD){
-        unsigned char *cert_ip;
+        const unsigned char *cert_ip;
         /*If we do have an IP address, compare it directly.
           RFC 6125: "When the reference identity is an IP address, the identity
            MUST be converted to the 'network byte order' octet string
@@ -1772,7 +2302,7 @@ static int op_http_verify_hostname(OpusHTTPStream *_stream,SSL *_ssl_conn){
            type iPAddress.
           A match occurs if the reference identity octet string and the value
            octet strings are identical."*/
-        cert_ip=ASN1_STRING_data(name->d.iPAddress);
+        cert_ip=ASN1_STRING_get0_data(name->d.iPAddress);
         if(ip_len==ASN1_STRING_length(name->d.iPAddress)
          &&memcmp(ip,cert_ip,ip_len)==0){
           ret=1;
@@ -1813,15 +2343,13 @@ static int op_http_verify_hostname(OpusHTTPStream *_stream,SSL *_ssl_conn){
   return ret;
 }
 
-/*Perform the TLS handshake on a new connection.*/
-static int op_http_conn_start_tls(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
+/*Get ready to start the TLS handshake on a new connection.
+  Return: The BIO for the socket, or NULL on error.*/
+static BIO *op_http_conn_tls_init(OpusHTTPStream *_stream,
  op_sock _fd,SSL *_ssl_conn){
-  SSL_SESSION *ssl_session;
-  BIO         *ssl_bio;
-  int          skip_certificate_check;
-  int          ret;
+  BIO *ssl_bio;
   ssl_bio=BIO_new_socket(_fd,BIO_NOCLOSE);
-  if(OP_LIKELY(ssl_bio==NULL))return OP_FALSE;
+  if(OP_LIKELY(ssl_bio==NULL))return NULL;
 # if !defined(OPENSSL_NO_TLSEXT)
   /*Support for RFC 6066 Server Name Indication.*/
   SSL_set_tlsext_host_name(_ssl_conn,_stream->url.host);
@@ -1830,20 +2358,26 @@ static int op_http_conn_start_tls(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
   if(_stream->ssl_session!=NULL){
     SSL_set_session(_ssl_conn,_stream->ssl_session);
   }
-  /*If we're proxying, establish the CONNECT tunnel.*/
-  if(_stream->proxy_connect.nbuf>0){
-    ret=op_http_conn_establish_tunnel(_stream,_conn,
-     _fd,_ssl_conn,ssl_bio);
-    if(OP_UNLIKELY(ret<0))return ret;
-  }
-  else{
-    /*Otherwise, just use this socket directly.*/
-    op_sock_set_tcp_nodelay(_fd,1);
-    SSL_set_bio(_ssl_conn,ssl_bio,ssl_bio);
-    SSL_set_connect_state(_ssl_conn);
+  /*Failing that, try the last one another stream on the same route used.*/
+  else if(_stream->client!=NULL){
+    OpusHTTPRoute *route;
+    op_mutex_lock(&_stream->client->mutex);
+    route=op_http_client_route(_stream->client,_stream,0);
+    if(route!=NULL&&route->ssl_session!=NULL){
+      SSL_set_session(_ssl_conn,route->ssl_session);
+    }
+    op_mutex_unlock(&_stream->client->mutex);
   }
-  ret=op_do_ssl_step(_ssl_conn,_fd,SSL_connect);
-  if(OP_UNLIKELY(ret<=0))return OP_FALSE;
+  return ssl_bio;
+}
+
+/*Check the peer and save the session once the TLS handshake on a new
+   connection has got as far as SSL_connect() takes it.*/
+static int op_http_conn_tls_finish(OpusHTTPStream *_stream,
+ OpusHTTPConn *_conn,op_sock _fd,SSL *_ssl_conn){
+  SSL_SESSION *ssl_session;
+  int          skip_certificate_check;
+  int          ret;
   ssl_session=_stream->ssl_session;
   skip_certificate_check=_stream->skip_certificate_check;
   if(ssl_session==NULL||!skip_certificate_check){
@@ -1859,6 +2393,17 @@ static int op_http_conn_start_tls(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
     if(ssl_session==NULL){
       /*Save the session for later resumption.*/
       _stream->ssl_session=SSL_get1_session(_ssl_conn);
+      /*And share it with the other streams on this route.*/
+      if(_stream->client!=NULL&&_stream->ssl_session!=NULL){
+        OpusHTTPRoute *route;
+        op_mutex_lock(&_stream->client->mutex);
+        route=op_http_client_route(_stream->client,_stream,1);
+        if(OP_LIKELY(route!=NULL)){
+          if(route->ssl_session!=NULL)SSL_SESSION_free(route->ssl_session);
+          route->ssl_session=SSL_get1_session(_ssl_conn);
+        }
+        op_mutex_unlock(&_stream->client->mutex);
+      }
     }
   }
   _conn->ssl_conn=_ssl_conn;
@@ -1867,6 +2412,30 @@ static int op_http_conn_start_tls(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
   return 0;
 }
 
+/*Perform the TLS handshake on a new connection.*/
+static int op_http_conn_start_tls(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
+ op_sock _fd,SSL *_ssl_conn){
+  BIO *ssl_bio;
+  int  ret;
+  ssl_bio=op_http_conn_tls_init(_stream,_fd,_ssl_conn);
+  if(OP_UNLIKELY(ssl_bio==NULL))return OP_FALSE;
+  /*If we're proxying, establish the CONNECT tunnel.*/
+  if(_stream->proxy_connect.nbuf>0){
+    ret=op_http_conn_establish_tunnel(_stream,_conn,
+     _fd,_ssl_conn,ssl_bio);
+    if(OP_UNLIKELY(ret<0))return ret;
+  }
+  else{
+    /*Otherwise, just use this socket directly.*/
+    op_sock_set_tcp_nodelay(_fd,1);
+    SSL_set_bio(_ssl_conn,ssl_bio,ssl_bio);
+    SSL_set_connect_state(_ssl_conn);
+  }
+  ret=op_do_ssl_step(_ssl_conn,_fd,SSL_connect);
+  if(OP_UNLIKELY(ret<=0))return OP_FALSE;
+  return op_http_conn_tls_finish(_stream,_conn,_fd,_ssl_conn);
+}
+
 /*Try to start a connection to the next address in the given list of a given
    type.
   _fd:           The socket to connect with.
@@ -2033,11 +2602,106 @@ static int op_http_connect_impl(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
   return 0;
 }
 
+/*Pick up an idle connection another stream on the same route left with our
+   client.
+  Return: 1 if we found one (it is moved to the head of the LRU list, just as
+           if we had connected), or 0 if there were none we could use.*/
+static int op_http_client_take(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
+ struct timeb *_start_time){
+  OpusHTTPClient   *client;
+  OpusHTTPRoute    *route;
+  OpusHTTPIdleConn *idle;
+  OpusHTTPIdleConn *dead;
+  client=_stream->client;
+  ftime(_start_time);
+  dead=NULL;
+  op_mutex_lock(&client->mutex);
+  route=op_http_client_route(client,_stream,0);
+  idle=NULL;
+  if(route!=NULL){
+    while((idle=route->idle)!=NULL){
+      struct pollfd fd;
+      route->idle=idle->next;
+      route->nidle--;
+      /*Skip connections the server has probably given up on, and ones it has
+         already closed (or sent something unsolicited on, which we can't
+         make sense of either).*/
+      fd.fd=idle->fd;
+      fd.events=POLLIN;
+      if(op_time_diff_ms(_start_time,&idle->idle_time)
+       <=OP_CONNECTION_IDLE_TIMEOUT_MS&&poll(&fd,1,0)==0
+       &&(idle->ssl_conn==NULL||SSL_pending(idle->ssl_conn)<=0)){
+        break;
+      }
+      idle->next=dead;
+      dead=idle;
+    }
+    /*If this is our first connection, we skipped resolving the host, so learn
+       its address from the stream that connected, or we won't be able to open
+       any more.*/
+    if(idle!=NULL&&_stream->addr_info.ai_addr==NULL&&route->have_addr){
+      memcpy(&_stream->addr_info,&route->addr_info,
+       sizeof(_stream->addr_info));
+      memcpy(&_stream->addr,&route->addr,sizeof(_stream->addr));
+      _stream->addr_info.ai_addr=&_stream->addr.s;
+      *&_stream->resolve_time=*&route->resolve_time;
+    }
+  }
+  op_mutex_unlock(&client->mutex);
+  while(dead!=NULL){
+    OpusHTTPIdleConn *next;
+    next=dead->next;
+    op_http_idle_conn_free(dead);
+    dead=next;
+  }
+  if(idle==NULL)return 0;
+  /*Pop the connection off the free list and put it on the LRU list.*/
+  OP_ASSERT(_stream->free_head==_conn);
+  _stream->free_head=_conn->next;
+  _conn->next=_stream->lru_head;
+  _stream->lru_head=_conn;
+  *&_conn->read_time=*_start_time;
+  _conn->read_bytes=0;
+  /*Keep the throughput estimate, as it describes the same path.*/
+  _conn->read_rate=idle->read_rate;
+  _conn->ssl_conn=idle->ssl_conn;
+  _conn->fd=idle->fd;
+  _conn->nrequests_left=idle->nrequests_left;
+  _ogg_free(idle);
+  return 1;
+}
+
+/*Open a new connection.
+  _reuse: Whether or not we may use an idle connection from our client.
+  Return: 0 on success, 1 if we re-used an idle connection (which might still
+           turn out to have been closed by the server), or a negative value on
+           error.*/
 static int op_http_connect(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
- const struct addrinfo *_addrs,struct timeb *_start_time){
+ const struct addrinfo *_addrs,struct timeb *_start_time,int _reuse){
   struct timeb     resolve_time;
   struct addrinfo *new_addrs;
+  int              shared_addr;
   int              ret;
+  shared_addr=0;
+  if(_stream->client!=NULL){
+    OpusHTTPRoute *route;
+    if(_reuse&&op_http_client_take(_stream,_conn,_start_time))return 1;
+    /*If we haven't resolved the host yet, see if another stream has.*/
+    if(_addrs==NULL){
+      op_mutex_lock(&_stream->client->mutex);
+      route=op_http_client_route(_stream->client,_stream,0);
+      if(route!=NULL&&route->have_addr){
+        memcpy(&_stream->addr_info,&route->addr_info,
+         sizeof(_stream->addr_info));
+        memcpy(&_stream->addr,&route->addr,sizeof(_stream->addr));
+        _stream->addr_info.ai_addr=&_stream->addr.s;
+        *&_stream->resolve_time=*&route->resolve_time;
+        _addrs=&_stream->addr_info;
+        shared_addr=1;
+      }
+      op_mutex_unlock(&_stream->client->mutex);
+    }
+  }
   /*Re-resolve the host if we need to (RFC 6555 says we MUST do so
      occasionally).*/
   new_addrs=NULL;
@@ -2052,10 +2716,140 @@ static int op_http_connect(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
     else if(OP_LIKELY(_addrs==NULL))return OP_FALSE;
   }
   ret=op_http_connect_impl(_stream,_conn,_addrs,_start_time);
+  if(OP_UNLIKELY(ret<0)&&shared_addr&&new_addrs==NULL){
+    /*The address another stream found no longer works.
+      Look the host up again in case it has moved.*/
+    op_http_conn_close(_stream,_conn,&_stream->lru_head,0);
+    new_addrs=op_resolve(_stream->connect_host,_stream->connect_port);
+    if(OP_UNLIKELY(new_addrs==NULL))return ret;
+    *&_stream->resolve_time=*&resolve_time;
+    ret=op_http_connect_impl(_stream,_conn,new_addrs,_start_time);
+  }
   if(new_addrs!=NULL)freeaddrinfo(new_addrs);
+  /*Tell the other streams where we found the host.*/
+  if(OP_LIKELY(ret>=0)&&_stream->client!=NULL){
+    OpusHTTPRoute *route;
+    op_mutex_lock(&_stream->client->mutex);
+    route=op_http_client_route(_stream->client,_stream,1);
+    if(OP_LIKELY(route!=NULL)){
+      memcpy(&route->addr_info,&_stream->addr_info,sizeof(route->addr_info));
+      memcpy(&route->addr,&_stream->addr,sizeof(route->addr));
+      route->addr_info.ai_addr=&route->addr.s;
+      route->addr_info.ai_canonname=NULL;
+      route->addr_info.ai_next=NULL;
+      *&route->resolve_time=*&_stream->resolve_time;
+      route->have_addr=1;
+    }
+    op_mutex_unlock(&_stream->client->mutex);
+  }
   return ret;
 }
 
+/*Continue setting up a connection started by op_http_connect_start(), once
+   its socket is ready for the events that asked for.
+  _state:        What op_http_connect_start() (or the last call to this
+                  function) returned.
+  [out] _events: What to poll() the socket for before calling this again.
+  Return: 0 if the connection is ready to use, OP_HTTP_CONNECTING or
+           OP_HTTP_HANDSHAKING if it is still being set up, or a negative value
+           on error (the caller should close the connection).*/
+static int op_http_connect_continue(OpusHTTPStream *_stream,
+ OpusHTTPConn *_conn,int _state,short *_events){
+  SSL *ssl_conn;
+  int  ret;
+  if(_state==OP_HTTP_CONNECTING){
+    BIO       *ssl_bio;
+    socklen_t  errlen;
+    int        err;
+    errlen=sizeof(err);
+    /*Some platforms will return the pending error in &err and return 0.
+      Others will put it in errno and return -1.*/
+    ret=getsockopt(_conn->fd,SOL_SOCKET,SO_ERROR,&err,&errlen);
+    if(ret<0)err=op_errno();
+    if(err!=0&&err!=EISCONN)return OP_FALSE;
+    op_sock_set_tcp_nodelay(_conn->fd,1);
+    if(!OP_URL_IS_SSL(&_stream->url)){
+      _conn->nrequests_left=OP_PIPELINE_MAX_REQUESTS;
+      return 0;
+    }
+    OP_ASSERT(_stream->ssl_ctx!=NULL);
+    ssl_conn=SSL_new(_stream->ssl_ctx);
+    if(OP_UNLIKELY(ssl_conn==NULL))return OP_FALSE;
+    ssl_bio=op_http_conn_tls_init(_stream,_conn->fd,ssl_conn);
+    if(OP_UNLIKELY(ssl_bio==NULL)){
+      SSL_free(ssl_conn);
+      return OP_FALSE;
+    }
+    SSL_set_bio(ssl_conn,ssl_bio,ssl_bio);
+    SSL_set_connect_state(ssl_conn);
+    /*Closing the connection frees it from here on.*/
+    _conn->ssl_conn=ssl_conn;
+  }
+  ssl_conn=_conn->ssl_conn;
+  OP_ASSERT(ssl_conn!=NULL);
+  ret=SSL_connect(ssl_conn);
+  if(ret<0){
+    int err;
+    err=SSL_get_error(ssl_conn,ret);
+    if(err==SSL_ERROR_WANT_READ)*_events=POLLIN;
+    else if(err==SSL_ERROR_WANT_WRITE)*_events=POLLOUT;
+    else return OP_FALSE;
+    return OP_HTTP_HANDSHAKING;
+  }
+  if(OP_UNLIKELY(ret==0))return OP_FALSE;
+  /*The handshake is done, so this won't block.*/
+  return op_http_conn_tls_finish(_stream,_conn,_conn->fd,ssl_conn);
+}
+
+/*Start opening a new connection without waiting for it.
+  We pick up an idle connection from our client if there is one, and
+   otherwise connect to the address the stream was opened with.
+  Unlike op_http_connect(), we don't race the address families or re-resolve
+   the host, since neither can be done without blocking.
+  [out] _events: What to poll() the socket for before calling
+                  op_http_connect_continue(), if the connection isn't ready.
+  Return: 0 if the connection is ready to use, OP_HTTP_CONNECTING or
+           OP_HTTP_HANDSHAKING if it is still being set up, or a negative value
+           on error.
+          Unless there was an error, the connection is moved to the head of
+           the LRU list.*/
+static int op_http_connect_start(OpusHTTPStream *_stream,OpusHTTPConn *_conn,
+ short *_events){
+  const struct addrinfo *addr;
+  struct timeb           start_time;
+  op_sock                fd;
+  int                    ret;
+  if(_stream->client!=NULL&&op_http_client_take(_stream,_conn,&start_time)){
+    return 0;
+  }
+  addr=&_stream->addr_info;
+  OP_ASSERT(addr->ai_addr!=NULL);
+  fd=socket(addr->ai_family,SOCK_STREAM,addr->ai_protocol);
+  if(OP_UNLIKELY(fd==OP_INVALID_SOCKET))return OP_FALSE;
+  ret=op_sock_set_nonblocking(fd,1);
+  if(OP_LIKELY(ret>=0))ret=op_sock_connect_next(fd,&addr,addr->ai_family);
+  if(OP_UNLIKELY(ret<0)){
+    close(fd);
+    return OP_FALSE;
+  }
+  /*Pop the connection off the free list and put it on the LRU list.*/
+  OP_ASSERT(_stream->free_head==_conn);
+  _stream->free_head=_conn->next;
+  _conn->next=_stream->lru_head;
+  _stream->lru_head=_conn;
+  ftime(&_conn->read_time);
+  _conn->read_bytes=0;
+  _conn->read_rate=0;
+  _conn->ssl_conn=NULL;
+  _conn->fd=fd;
+  if(ret==0){
+    *_events=POLLOUT;
+    return OP_HTTP_CONNECTING;
+  }
+  /*It succeeded right away (technically possible).*/
+  return op_http_connect_continue(_stream,_conn,OP_HTTP_CONNECTING,_events);
+}
+
 # define OP_BASE64_LENGTH(_len) (((_len)+2)/3*4)
 
 static const char BASE64_TABLE[64]={
@@ -2168,11 +2962,48 @@ static int op_http_allow_pipelining(const char *_server){
 # undef NBAD_SERVERS
 }
 
+/*Create a TLS context for a client connection.
+  Return: The new context, or NULL if we ran out of memory.*/
+static SSL_CTX *op_ssl_ctx_create(int _skip_certificate_check){
+  SSL_CTX *ssl_ctx;
+  /*OpenSSL 1.1 and later initialize themselves, safely.*/
+# if OPENSSL_VERSION_NUMBER<0x10100000L
+#  if !defined(OPENSSL_NO_LOCKING)
+  /*The documentation says SSL_library_init() is not reentrant.
+    We don't want to add our own depenencies on a threading library, and it
+     appears that it's safe to call OpenSSL's locking functions before the
+     library is initialized, so that's what we'll do (really OpenSSL should
+     do this for us).
+    This doesn't guarantee that _other_ threads in the application aren't
+     calling SSL_library_init() at the same time, but there's not much we
+     can do about that.*/
+  CRYPTO_w_lock(CRYPTO_LOCK_SSL);
+#  endif
+  SSL_library_init();
+  /*Needed to get SHA2 algorithms with old OpenSSL versions.*/
+  OpenSSL_add_ssl_algorithms();
+#  if !defined(OPENSSL_NO_LOCKING)
+  CRYPTO_w_unlock(CRYPTO_LOCK_SSL);
+#  endif
+# endif
+  ssl_ctx=SSL_CTX_new(SSLv23_client_method());
+  if(ssl_ctx!=NULL&&!_skip_certificate_check){
+    /*We don't do anything if this fails, since it just means we won't load
+       any certificates (and thus all checks will fail).
+      However, as that is probably the result of a system mis-configuration,
+       assert here to make it easier to identify.*/
+    OP_ALWAYS_TRUE(SSL_CTX_set_default_verify_paths(ssl_ctx));
+    SSL_CTX_set_verify(ssl_ctx,SSL_VERIFY_PEER,NULL);
+  }
+  return ssl_ctx;
+}
+
 static int op_http_stream_open(OpusHTTPStream *_stream,const char *_url,
  int _skip_certificate_check,const char *_proxy_host,unsigned _proxy_port,
  const char *_proxy_user,const char *_proxy_pass,OpusServerInfo *_info){
   struct addrinfo *addrs;
   int              nredirs;
+  int              reuse;
   int              ret;
 #if defined(_WIN32)
   op_init_winsock();
@@ -2189,6 +3020,7 @@ static int op_http_stream_open(OpusHTTPStream *_stream,const char *_url,
     _stream->connect_port=_stream->url.port;
   }
   addrs=NULL;
+  reuse=1;
   for(nredirs=0;nredirs<OP_REDIRECT_LIMIT;nredirs++){
     OpusParsedURL  next_url;
     struct timeb   start_time;
@@ -2197,36 +3029,25 @@ static int op_http_stream_open(OpusHTTPStream *_stream,const char *_url,
     char          *status_code;
     int            minor_version_pos;
     int            v1_1_compat;
+    int            reused;
     /*Initialize the SSL library if necessary.*/
     if(OP_URL_IS_SSL(&_stream->url)&&_stream->ssl_ctx==NULL){
       SSL_CTX *ssl_ctx;
-# if !defined(OPENSSL_NO_LOCKING)
-      /*The documentation says SSL_library_init() is not reentrant.
-        We don't want to add our own depenencies on a threading library, and it
-         appears that it's safe to call OpenSSL's locking functions before the
-         library is initialized, so that's what we'll do (really OpenSSL should
-         do this for us).
-        This doesn't guarantee that _other_ threads in the application aren't
-         calling SSL_library_init() at the same time, but there's not much we
-         can do about that.*/
-      CRYPTO_w_lock(CRYPTO_LOCK_SSL);
-# endif
-      SSL_library_init();
-      /*Needed to get SHA2 algorithms with old OpenSSL versions.*/
-      OpenSSL_add_ssl_algorithms();
-# if !defined(OPENSSL_NO_LOCKING)
-      CRYPTO_w_unlock(CRYPTO_LOCK_SSL);
-# endif
-      ssl_ctx=SSL_CTX_new(SSLv23_client_method());
-      if(ssl_ctx==NULL)return OP_EFAULT;
-      if(!_skip_certificate_check){
-        /*We don't do anything if this fails, since it just means we won't load
-           any certificates (and thus all checks will fail).
-          However, as that is probably the result of a system
-           mis-configuration, assert here to make it easier to identify.*/
-        OP_ALWAYS_TRUE(SSL_CTX_set_default_verify_paths(ssl_ctx));
-        SSL_CTX_set_verify(ssl_ctx,SSL_VERIFY_PEER,NULL);
+      if(_stream->client!=NULL){
+        OpusHTTPClient *client;
+        /*Use the client's context, creating it if this is the first https
+           stream to need it.*/
+        client=_stream->client;
+        op_mutex_lock(&client->mutex);
+        ssl_ctx=client->ssl_ctx[!!_skip_certificate_check];
+        if(ssl_ctx==NULL){
+          ssl_ctx=op_ssl_ctx_create(_skip_certificate_check);
+          client->ssl_ctx[!!_skip_certificate_check]=ssl_ctx;
+        }
+        op_mutex_unlock(&client->mutex);
       }
+      else ssl_ctx=op_ssl_ctx_create(_skip_certificate_check);
+      if(ssl_ctx==NULL)return OP_EFAULT;
       _stream->ssl_ctx=ssl_ctx;
       _stream->skip_certificate_check=_skip_certificate_check;
       if(_proxy_host!=NULL){
@@ -2260,8 +3081,9 @@ static int op_http_stream_open(OpusHTTPStream *_stream,const char *_url,
       }
     }
     /*Actually make the connection.*/
-    ret=op_http_connect(_stream,_stream->conns+0,addrs,&start_time);
+    ret=op_http_connect(_stream,_stream->conns+0,addrs,&start_time,reuse);
     if(OP_UNLIKELY(ret<0))return ret;
+    reused=ret;
     /*Build the request to send.*/
     _stream->request.nbuf=0;
     ret=op_sb_append(&_stream->request,"GET ",4);
@@ -2316,11 +3138,24 @@ static int op_http_stream_open(OpusHTTPStream *_stream,const char *_url,
     _stream->request_tail=_stream->request.nbuf-4;
     ret|=op_sb_append(&_stream->request,"\r\n",2);
     if(OP_UNLIKELY(ret<0))return ret;
+    /*This is an HTTP/1.0 request, so the server won't keep the connection
+       open afterwards.*/
+    _stream->conns[0].keep_alive=0;
     ret=op_http_conn_write_fully(_stream->conns+0,
      _stream->request.buf,_stream->request.nbuf);
-    if(OP_UNLIKELY(ret<0))return ret;
-    ret=op_http_conn_read_response(_stream->conns+0,&_stream->response);
-    if(OP_UNLIKELY(ret<0))return ret;
+    if(OP_LIKELY(ret>=0)){
+      ret=op_http_conn_read_response(_stream->conns+0,&_stream->response,1);
+    }
+    if(OP_UNLIKELY(ret<0)){
+      if(!reused)return ret;
+      /*We picked up an idle connection from our client, but the server must
+         have closed it in the meantime.
+        Try again on a new one.*/
+      op_http_conn_close(_stream,_stream->conns+0,&_stream->lru_head,0);
+      reuse=0;
+      nredirs--;
+      continue;
+    }
     ftime(&end_time);
     next=op_http_parse_status_line(&v1_1_compat,&status_code,
      _stream->response.buf);
@@ -2588,7 +3423,7 @@ static int op_http_conn_send_request(OpusHTTPStream *_stream,
     /*Use a larger chunk size for our next request.*/
     _chunk_size<<=1;
     /*But after a while, just request the rest of the resource.*/
-    if(_chunk_size>OP_PIPELINE_CHUNK_SIZE_MAX)_chunk_size=-1;
+    if(_chunk_size>_stream->chunk_size_max)_chunk_size=-1;
   }
   else{
     /*Either this was a non-pipelined request or we were close enough to the
@@ -2620,25 +3455,24 @@ static int op_http_conn_send_request(OpusHTTPStream *_stream,
   /*Save the chunk size to use for the next request.*/
   _conn->chunk_size=_chunk_size;
   _conn->nrequests_left--;
+  /*The request is HTTP/1.1 whenever we're pipelining.*/
+  _conn->keep_alive=_stream->pipeline;
   return ret;
 }
 
-/*Handles the response to all requests after the first one.
-  Return: 1 if the connection was closed or timed out, 0 on success, or a
-           negative value on any other error.*/
-static int op_http_conn_handle_response(OpusHTTPStream *_stream,
- OpusHTTPConn *_conn){
+/*Parses the response to any request after the first one, once it has been
+   read in full.
+  Return: 1 if the request timed out, 0 on success, or a negative value on any
+           other error.*/
+static int op_http_conn_parse_response(OpusHTTPStream *_stream,
+ OpusHTTPConn *_conn,char *_response){
   char       *next;
   char       *status_code;
   opus_int64  range_length;
   opus_int64  next_pos;
   opus_int64  next_end;
   int         ret;
-  ret=op_http_conn_read_response(_conn,&_stream->response);
-  /*If the server just closed the connection on us, we may have just hit a
-     connection re-use limit, so we might want to retry.*/
-  if(OP_UNLIKELY(ret<0))return ret==OP_EREAD?1:ret;
-  next=op_http_parse_status_line(NULL,&status_code,_stream->response.buf);
+  next=op_http_parse_status_line(NULL,&status_code,_response);
   if(OP_UNLIKELY(next==NULL))return OP_FALSE;
   /*We _need_ a 206 Partial Content response.
     Nothing else will do.*/
@@ -2725,6 +3559,19 @@ static int op_http_conn_handle_response(OpusHTTPStream *_stream,
   return 0;
 }
 
+/*Handles the response to all requests after the first one.
+  Return: 1 if the connection was closed or timed out, 0 on success, or a
+           negative value on any other error.*/
+static int op_http_conn_handle_response(OpusHTTPStream *_stream,
+ OpusHTTPConn *_conn){
+  int ret;
+  ret=op_http_conn_read_response(_conn,&_stream->response,1);
+  /*If the server just closed the connection on us, we may have just hit a
+     connection re-use limit, so we might want to retry.*/
+  if(OP_UNLIKELY(ret<0))return ret==OP_EREAD?1:ret;
+  return op_http_conn_parse_response(_stream,_conn,_stream->response.buf);
+}
+
 /*Open a new connection that will start reading at byte offset _pos.
   _pos:        The byte offset to start reading from.
   _chunk_size: The number of bytes to ask for in the initial request, or -1 to
@@ -2737,22 +3584,38 @@ static int op_http_conn_open_pos(OpusHTTPStream *_stream,
   struct timeb  end_time;
   opus_int32    connect_rate;
   opus_int32    connect_time;
+  int           reused;
   int           ret;
-  ret=op_http_connect(_stream,_conn,&_stream->addr_info,&start_time);
-  if(OP_UNLIKELY(ret<0))return ret;
-  ret=op_http_conn_send_request(_stream,_conn,_pos,_chunk_size,0);
+  ret=op_http_connect(_stream,_conn,&_stream->addr_info,&start_time,1);
   if(OP_UNLIKELY(ret<0))return ret;
-  ret=op_http_conn_handle_response(_stream,_conn);
-  if(OP_UNLIKELY(ret!=0))return OP_FALSE;
+  reused=ret;
+  for(;;){
+    ret=op_http_conn_send_request(_stream,_conn,_pos,_chunk_size,0);
+    if(OP_LIKELY(ret>=0)){
+      ret=op_http_conn_handle_response(_stream,_conn);
+      if(OP_LIKELY(ret==0))break;
+      ret=OP_FALSE;
+    }
+    /*If we picked up an idle connection from our client, the server might
+       have closed it in the meantime, so start over on a new one.*/
+    if(!reused)return ret;
+    OP_ASSERT(_stream->lru_head==_conn);
+    op_http_conn_close(_stream,_conn,&_stream->lru_head,0);
+    ret=op_http_connect(_stream,_conn,&_stream->addr_info,&start_time,0);
+    if(OP_UNLIKELY(ret<0))return ret;
+    reused=0;
+  }
   ftime(&end_time);
   _stream->cur_conni=_conn-_stream->conns;
-  OP_ASSERT(_stream->cur_conni>=0&&_stream->cur_conni<OP_NCONNS_MAX);
+  OP_ASSERT(_stream->cur_conni>=0&&_stream->cur_conni<_stream->nconns);
   /*The connection has been successfully opened.
-    Update the connection time estimate.*/
-  connect_time=op_time_diff_ms(&end_time,&start_time);
-  connect_rate=_stream->connect_rate;
-  connect_rate+=OP_MAX(connect_time,1)-connect_rate+8>>4;
-  _stream->connect_rate=connect_rate;
+    Update the connection time estimate (unless we skipped connecting).*/
+  if(!reused){
+    connect_time=op_time_diff_ms(&end_time,&start_time);
+    connect_rate=_stream->connect_rate;
+    connect_rate+=OP_MAX(connect_time,1)-connect_rate+8>>4;
+    _stream->connect_rate=connect_rate;
+  }
   return 0;
 }
 
@@ -2870,7 +3733,8 @@ static int op_http_conn_read_body(OpusHTTPStream *_stream,
     opus_int32 chunk_size;
     /*Are we getting close to the end of the current response body?
       If so, we should request more data.*/
-    request_thresh=_stream->connect_rate*_conn->read_rate>>12;
+    request_thresh=_stream->connect_rate
+     *op_http_stream_read_rate(_stream,_conn)>>12;
     /*But don't commit ourselves too quickly.*/
     chunk_size=_conn->chunk_size;
     if(chunk_size>=0)request_thresh=OP_MIN(chunk_size>>2,request_thresh);
@@ -2882,34 +3746,31 @@ static int op_http_conn_read_body(OpusHTTPStream *_stream,
   return nread;
 }
 
-static int op_http_stream_read(void *_stream,
+/*Read directly from the current connection, bypassing the block cache.*/
+static int op_http_stream_read_impl(OpusHTTPStream *_stream,
  unsigned char *_ptr,int _buf_size){
-  OpusHTTPStream *stream;
   ptrdiff_t       nread;
   opus_int64      size;
   opus_int64      pos;
   int             ci;
-  stream=(OpusHTTPStream *)_stream;
-  /*Check for an empty read.*/
-  if(_buf_size<=0)return 0;
-  ci=stream->cur_conni;
+  ci=_stream->cur_conni;
   /*No current connection => EOF.*/
   if(ci<0)return 0;
-  pos=stream->conns[ci].pos;
-  size=stream->content_length;
+  pos=_stream->conns[ci].pos;
+  size=_stream->content_length;
   /*Check for EOF.*/
   if(size>=0){
     if(pos>=size)return 0;
     /*Check for a short read.*/
     if(_buf_size>size-pos)_buf_size=(int)(size-pos);
   }
-  nread=op_http_conn_read_body(stream,stream->conns+ci,_ptr,_buf_size);
+  nread=op_http_conn_read_body(_stream,_stream->conns+ci,_ptr,_buf_size);
   if(OP_UNLIKELY(nread<=0)){
     /*We hit an error or EOF.
       Either way, we're done with this connection.*/
-    op_http_conn_close(stream,stream->conns+ci,&stream->lru_head,1);
-    stream->cur_conni=-1;
-    stream->pos=pos;
+    op_http_conn_close(_stream,_stream->conns+ci,&_stream->lru_head,1);
+    _stream->cur_conni=-1;
+    _stream->pos=pos;
   }
   return nread;
 }
@@ -2922,9 +3783,12 @@ static int op_http_stream_read(void *_stream,
                      and discard all the data from our current request(s).
                     Otherwise, we should be able to reach _target without
                      issuing any new requests.
-  _target:          The stream position to which to read ahead.*/
+  _target:          The stream position to which to read ahead.
+  _chunk_size:      The number of bytes to ask for in the new request, if one
+                     is needed.*/
 static int op_http_conn_read_ahead(OpusHTTPStream *_stream,
- OpusHTTPConn *_conn,int _just_read_ahead,opus_int64 _target){
+ OpusHTTPConn *_conn,int _just_read_ahead,opus_int64 _target,
+ opus_int32 _chunk_size){
   opus_int64 pos;
   opus_int64 end_pos;
   opus_int64 next_pos;
@@ -2942,8 +3806,7 @@ static int op_http_conn_read_ahead(OpusHTTPStream *_stream,
        did have an outstanding request).*/
     OP_ASSERT(_stream->pipeline);
     _conn->next_pos=-1;
-    ret=op_http_conn_send_request(_stream,_conn,_target,
-     OP_PIPELINE_CHUNK_SIZE,0);
+    ret=op_http_conn_send_request(_stream,_conn,_target,_chunk_size,0);
     if(OP_UNLIKELY(ret<0))return ret;
   }
   /*We can reach the target position by reading forward in the current chunk.*/
@@ -2995,59 +3858,40 @@ static int op_http_conn_read_ahead(OpusHTTPStream *_stream,
   return 0;
 }
 
-static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
+/*Position the connections so that the next read from the current one
+   returns the data at _pos.
+  _pos:        The new stream position.
+  _chunk_size: The number of bytes to ask for if we have to issue a new request
+                on a connection that supports pipelining.*/
+static int op_http_stream_seek_impl(OpusHTTPStream *_stream,opus_int64 _pos,
+ opus_int32 _chunk_size){
   struct timeb     seek_time;
-  OpusHTTPStream  *stream;
   OpusHTTPConn    *conn;
   OpusHTTPConn   **pnext;
   OpusHTTPConn    *close_conn;
   OpusHTTPConn   **close_pnext;
   opus_int64       content_length;
-  opus_int64       pos;
   int              pipeline;
   int              ci;
   int              ret;
-  stream=(OpusHTTPStream *)_stream;
-  if(!stream->seekable)return -1;
-  content_length=stream->content_length;
-  /*If we're seekable, we should have gotten a Content-Length.*/
-  OP_ASSERT(content_length>=0);
-  ci=stream->cur_conni;
-  pos=ci<0?content_length:stream->conns[ci].pos;
-  switch(_whence){
-    case SEEK_SET:{
-      /*Check for overflow:*/
-      if(_offset<0)return -1;
-      pos=_offset;
-    }break;
-    case SEEK_CUR:{
-      /*Check for overflow:*/
-      if(_offset<-pos||_offset>OP_INT64_MAX-pos)return -1;
-      pos+=_offset;
-    }break;
-    case SEEK_END:{
-      /*Check for overflow:*/
-      if(_offset>content_length||_offset<content_length-OP_INT64_MAX)return -1;
-      pos=content_length-_offset;
-    }break;
-    default:return -1;
-  }
+  content_length=_stream->content_length;
+  ci=_stream->cur_conni;
   /*Mark when we deactivated the active connection.*/
   if(ci>=0){
-    op_http_conn_read_rate_update(stream->conns+ci);
-    *&seek_time=*&stream->conns[ci].read_time;
+    op_http_conn_read_rate_update(_stream->conns+ci);
+    *&seek_time=*&_stream->conns[ci].read_time;
   }
   else ftime(&seek_time);
   /*If we seeked past the end of the stream, just disable the active
      connection.*/
-  if(pos>=content_length){
-    stream->cur_conni=-1;
-    stream->pos=pos;
+  if(_pos>=content_length){
+    _stream->cur_conni=-1;
+    _stream->pos=_pos;
     return 0;
   }
   /*First try to find a connection we can use without waiting.*/
-  pnext=&stream->lru_head;
-  conn=stream->lru_head;
+  pnext=&_stream->lru_head;
+  conn=_stream->lru_head;
   while(conn!=NULL){
     opus_int64 conn_pos;
     opus_int64 end_pos;
@@ -3058,7 +3902,7 @@ static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
     if(op_time_diff_ms(&seek_time,&conn->read_time)>
      OP_CONNECTION_IDLE_TIMEOUT_MS
      ||conn->nrequests_left<OP_PIPELINE_MIN_REQUESTS){
-      op_http_conn_close(stream,conn,pnext,1);
+      op_http_conn_close(_stream,conn,pnext,1);
       conn=*pnext;
       continue;
     }
@@ -3076,20 +3920,20 @@ static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
       If we have an oustanding request, we'll over-estimate the amount of data
        it has available (because we'll count the response headers, too), but
        that probably doesn't matter.*/
-    if(conn_pos<=pos&&pos-conn_pos<=available&&(end_pos<0||pos<end_pos)){
+    if(conn_pos<=_pos&&_pos-conn_pos<=available&&(end_pos<0||_pos<end_pos)){
       /*Found a suitable connection to re-use.*/
-      ret=op_http_conn_read_ahead(stream,conn,1,pos);
+      ret=op_http_conn_read_ahead(_stream,conn,1,_pos,_chunk_size);
       if(OP_UNLIKELY(ret<0)){
         /*The connection might have become stale, so close it and keep going.*/
-        op_http_conn_close(stream,conn,pnext,1);
+        op_http_conn_close(_stream,conn,pnext,1);
         conn=*pnext;
         continue;
       }
       /*Sucessfully resurrected this connection.*/
       *pnext=conn->next;
-      conn->next=stream->lru_head;
-      stream->lru_head=conn;
-      stream->cur_conni=conn-stream->conns;
+      conn->next=_stream->lru_head;
+      _stream->lru_head=conn;
+      _stream->cur_conni=conn-_stream->conns;
       return 0;
     }
     pnext=&conn->next;
@@ -3099,9 +3943,9 @@ static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
      ahead a reasonable amount and/or by issuing a new request.*/
   close_pnext=NULL;
   close_conn=NULL;
-  pnext=&stream->lru_head;
-  conn=stream->lru_head;
-  pipeline=stream->pipeline;
+  pnext=&_stream->lru_head;
+  conn=_stream->lru_head;
+  pipeline=_stream->pipeline;
   while(conn!=NULL){
     opus_int64 conn_pos;
     opus_int64 end_pos;
@@ -3113,8 +3957,8 @@ static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
        reopen the TCP window of a connection that's been idle).
       There's no overflow checking here, because it's vanishingly unlikely, and
        all it would do is cause us to make poor decisions.*/
-    read_ahead_thresh=OP_MAX(OP_READAHEAD_THRESH_MIN,
-     stream->connect_rate*conn->read_rate>>11);
+    read_ahead_thresh=OP_MAX(_stream->read_ahead_min,
+     _stream->connect_rate*op_http_stream_read_rate(_stream,conn)>>11);
     available=op_http_conn_estimate_available(conn);
     conn_pos=conn->pos;
     end_pos=conn->end_pos;
@@ -3125,23 +3969,24 @@ static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
     }
     OP_ASSERT(end_pos<0||conn_pos<=end_pos);
     /*Can we quickly read ahead without issuing a new request?*/
-    just_read_ahead=conn_pos<=pos&&pos-conn_pos-available<=read_ahead_thresh
-     &&(end_pos<0||pos<end_pos);
+    just_read_ahead=conn_pos<=_pos&&_pos-conn_pos-available<=read_ahead_thresh
+     &&(end_pos<0||_pos<end_pos);
     if(just_read_ahead||pipeline&&end_pos>=0
      &&end_pos-conn_pos-available<=read_ahead_thresh){
       /*Found a suitable connection to re-use.*/
-      ret=op_http_conn_read_ahead(stream,conn,just_read_ahead,pos);
+      ret=op_http_conn_read_ahead(_stream,conn,just_read_ahead,_pos,
+       _chunk_size);
       if(OP_UNLIKELY(ret<0)){
         /*The connection might have become stale, so close it and keep going.*/
-        op_http_conn_close(stream,conn,pnext,1);
+        op_http_conn_close(_stream,conn,pnext,1);
         conn=*pnext;
         continue;
       }
       /*Sucessfully resurrected this connection.*/
       *pnext=conn->next;
-      conn->next=stream->lru_head;
-      stream->lru_head=conn;
-      stream->cur_conni=conn-stream->conns;
+      conn->next=_stream->lru_head;
+      _stream->lru_head=conn;
+      _stream->cur_conni=conn-_stream->conns;
       return 0;
     }
     close_pnext=pnext;
@@ -3151,16 +3996,16 @@ static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
   }
   /*No suitable connections.
     Open a new one.*/
-  if(stream->free_head==NULL){
+  if(_stream->free_head==NULL){
     /*All connections in use.
       Expire one of them (we should have already picked which one when scanning
        the list).*/
     OP_ASSERT(close_conn!=NULL);
     OP_ASSERT(close_pnext!=NULL);
-    op_http_conn_close(stream,close_conn,close_pnext,1);
+    op_http_conn_close(_stream,close_conn,close_pnext,1);
   }
-  OP_ASSERT(stream->free_head!=NULL);
-  conn=stream->free_head;
+  OP_ASSERT(_stream->free_head!=NULL);
+  conn=_stream->free_head;
   /*If we can pipeline, only request a chunk of data.
     If we're seeking now, there's a good chance we will want to seek again
      soon, and this avoids committing this connection to reading the rest of
@@ -3170,19 +4015,762 @@ static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
     This also limits the amount of data the server will blast at us on this
      connection if we later seek elsewhere and start reading from a different
      connection.*/
-  ret=op_http_conn_open_pos(stream,conn,pos,
-   pipeline?OP_PIPELINE_CHUNK_SIZE:-1);
+  ret=op_http_conn_open_pos(_stream,conn,_pos,pipeline?_chunk_size:-1);
   if(OP_UNLIKELY(ret<0)){
-    op_http_conn_close(stream,conn,&stream->lru_head,1);
+    op_http_conn_close(_stream,conn,&_stream->lru_head,1);
     return -1;
   }
   return 0;
 }
 
+/*Find the slot holding the given block, or return -1 if it isn't cached.*/
+static int op_http_cache_lookup(const OpusHTTPCache *_cache,opus_int64 _block){
+  int si;
+  si=_cache->buckets[(int)(_block&_cache->bucket_mask)];
+  while(si>=0&&_cache->slots[si].block!=_block)si=_cache->slots[si].hash_next;
+  return si;
+}
+
+static void op_http_cache_hash_remove(OpusHTTPCache *_cache,int _si){
+  int *pnext;
+  pnext=_cache->buckets+(int)(_cache->slots[_si].block&_cache->bucket_mask);
+  while(*pnext!=_si)pnext=&_cache->slots[*pnext].hash_next;
+  *pnext=_cache->slots[_si].hash_next;
+}
+
+static void op_http_cache_lru_remove(OpusHTTPCache *_cache,int _si){
+  OpusHTTPCacheSlot *slot;
+  slot=_cache->slots+_si;
+  if(slot->lru_prev>=0)_cache->slots[slot->lru_prev].lru_next=slot->lru_next;
+  else _cache->lru_head=slot->lru_next;
+  if(slot->lru_next>=0)_cache->slots[slot->lru_next].lru_prev=slot->lru_prev;
+  else _cache->lru_tail=slot->lru_prev;
+}
+
+/*Insert a slot at the head (most recently used end) of the LRU list.*/
+static void op_http_cache_lru_insert(OpusHTTPCache *_cache,int _si){
+  OpusHTTPCacheSlot *slot;
+  slot=_cache->slots+_si;
+  slot->lru_prev=-1;
+  slot->lru_next=_cache->lru_head;
+  if(_cache->lru_head>=0)_cache->slots[_cache->lru_head].lru_prev=_si;
+  else _cache->lru_tail=_si;
+  _cache->lru_head=_si;
+}
+
+/*Claim a slot for the given block, which must not already be cached.
+  If every slot is in use, this evicts the least recently used block that
+   isn't still waiting on a prefetch.*/
+static int op_http_cache_alloc(OpusHTTPCache *_cache,opus_int64 _block){
+  OpusHTTPCacheSlot *slot;
+  int               *bucket;
+  int                si;
+  if(_cache->nused<_cache->nslots)si=_cache->nused++;
+  else{
+    /*Prefetches never hold more than half the slots, so this terminates.*/
+    for(si=_cache->lru_tail;_cache->slots[si].fetchi>=0;
+     si=_cache->slots[si].lru_prev);
+    if(_cache->slots[si].block>=0)op_http_cache_hash_remove(_cache,si);
+    op_http_cache_lru_remove(_cache,si);
+  }
+  slot=_cache->slots+si;
+  slot->block=_block;
+  slot->len=0;
+  slot->fetchi=-1;
+  bucket=_cache->buckets+(int)(_block&_cache->bucket_mask);
+  slot->hash_next=*bucket;
+  *bucket=si;
+  op_http_cache_lru_insert(_cache,si);
+  return si;
+}
+
+/*Drop the contents of a slot and make it the next one to be reused.*/
+static void op_http_cache_invalidate(OpusHTTPCache *_cache,int _si){
+  OpusHTTPCacheSlot *slot;
+  slot=_cache->slots+_si;
+  op_http_cache_hash_remove(_cache,_si);
+  slot->block=-1;
+  if(slot->fetchi>=0){
+    slot->fetchi=-1;
+    _cache->npending--;
+  }
+  op_http_cache_lru_remove(_cache,_si);
+  slot->lru_prev=_cache->lru_tail;
+  slot->lru_next=-1;
+  if(_cache->lru_tail>=0)_cache->slots[_cache->lru_tail].lru_next=_si;
+  else _cache->lru_head=_si;
+  _cache->lru_tail=_si;
+}
+
+/*Write a completed block out to the cache file, if there is one.*/
+static int op_http_cache_store(OpusHTTPCache *_cache,int _si,
+ const unsigned char *_buf){
+  opus_int32 len;
+  if(_cache->file==NULL)return 0;
+  len=_cache->slots[_si].len;
+  if(OP_UNLIKELY((*_cache->file_cb.seek)(_cache->file,
+   _si*(opus_int64)_cache->block_size,SEEK_SET)<0)
+   ||OP_UNLIKELY(fwrite(_buf,1,len,(FILE *)_cache->file)!=(size_t)len)){
+    return OP_EREAD;
+  }
+  return 0;
+}
+
+/*Fetch a run of consecutive blocks, none of which may already be cached.
+  The whole run is read from a single position, which (with pipelining)
+   means a single Range request sized to cover it, or, when reading
+   sequentially, simply continuing to read from the current connection.
+  _block:   The index of the first block to fetch.
+  _nblocks: The number of blocks to fetch.
+            This must be no more than half the number of slots in the cache.
+  Return: 0 on success, or a negative value on error.*/
+static int op_http_cache_fill(OpusHTTPStream *_stream,
+ opus_int64 _block,int _nblocks){
+  OpusHTTPCache *cache;
+  opus_int64     pos;
+  opus_int64     end;
+  opus_int64     chunk_size;
+  int            ret;
+  cache=&_stream->cache;
+  pos=_block*cache->block_size;
+  end=OP_MIN(pos+_nblocks*(opus_int64)cache->block_size,
+   _stream->content_length);
+  OP_ASSERT(pos<end);
+  chunk_size=OP_MAX(end-pos,op_http_stream_chunk_size(_stream));
+  ret=op_http_stream_seek_impl(_stream,pos,
+   chunk_size>_stream->chunk_size_max?-1:(opus_int32)chunk_size);
+  if(OP_UNLIKELY(ret<0))return OP_EREAD;
+  while(pos<end){
+    unsigned char *buf;
+    opus_int32     len;
+    opus_int32     nfilled;
+    int            si;
+    si=op_http_cache_alloc(cache,_block++);
+    len=(opus_int32)OP_MIN(cache->block_size,end-pos);
+    buf=cache->file!=NULL?cache->file_buf:
+     cache->data+si*(size_t)cache->block_size;
+    for(nfilled=0;nfilled<len;){
+      int nread;
+      nread=op_http_stream_read_impl(_stream,buf+nfilled,len-nfilled);
+      if(OP_UNLIKELY(nread<=0)){
+        op_http_cache_invalidate(cache,si);
+        return OP_EREAD;
+      }
+      nfilled+=nread;
+    }
+    cache->slots[si].len=len;
+    if(OP_UNLIKELY(op_http_cache_store(cache,si,buf)<0)){
+      op_http_cache_invalidate(cache,si);
+      return OP_EREAD;
+    }
+    pos+=len;
+  }
+  return 0;
+}
+
+/*Take a connection for a prefetch without disturbing the one we're reading
+   from.
+  We reuse an idle connection if there is one, and otherwise open a new one.
+  In non-blocking mode, we only start opening it (unless it needs a CONNECT
+   tunnel through a proxy), and op_http_fetch_pump() finishes the job.
+  Otherwise we connect right away, since nothing would advance the connection
+   between reads and the server would be left waiting on the handshake.
+  [out] _state:  0 if the connection is ready to use, or OP_HTTP_CONNECTING
+                  or OP_HTTP_HANDSHAKING if it is still being set up.
+  [out] _events: What to poll() the socket for if it is still being set up.
+  Return: The connection, which is on neither the LRU list nor the free list,
+           or NULL if none is available.*/
+static OpusHTTPConn *op_http_fetch_conn_acquire(OpusHTTPStream *_stream,
+ int *_state,short *_events){
+  struct timeb   now;
+  struct timeb   start_time;
+  OpusHTTPConn **pnext;
+  OpusHTTPConn  *conn;
+  int            ret;
+  *_state=0;
+  *_events=0;
+  if(_stream->pipeline){
+    ftime(&now);
+    for(pnext=&_stream->lru_head;(conn=*pnext)!=NULL;pnext=&conn->next){
+      /*An idle connection is one that has finished its last request, and can
+         still take more.*/
+      if(conn-_stream->conns!=_stream->cur_conni&&conn->next_pos<0
+       &&conn->end_pos>=0&&conn->pos>=conn->end_pos
+       &&conn->nrequests_left>=OP_PIPELINE_MIN_REQUESTS
+       &&op_time_diff_ms(&now,&conn->read_time)
+       <=OP_CONNECTION_IDLE_TIMEOUT_MS){
+        *pnext=conn->next;
+        conn->next=NULL;
+        return conn;
+      }
+    }
+  }
+  conn=_stream->free_head;
+  if(conn==NULL){
+    OpusHTTPConn **close_pnext;
+    /*Reading ahead in parallel is worth more to us than keeping connections
+       around for seeking, so close the least recently used one (other than
+       the current one) to make room.*/
+    close_pnext=NULL;
+    for(pnext=&_stream->lru_head;*pnext!=NULL;pnext=&(*pnext)->next){
+      if(*pnext-_stream->conns!=_stream->cur_conni)close_pnext=pnext;
+    }
+    if(close_pnext==NULL)return NULL;
+    op_http_conn_close(_stream,*close_pnext,close_pnext,1);
+    conn=_stream->free_head;
+  }
+  /*This moves the connection to the head of the LRU list.*/
+  if(_stream->nonblocking&&_stream->proxy_connect.nbuf<=0){
+    ret=op_http_connect_start(_stream,conn,_events);
+  }
+  else{
+    ret=op_http_connect(_stream,conn,&_stream->addr_info,&start_time,1);
+    if(ret>0)ret=0;
+  }
+  if(OP_UNLIKELY(ret<0)){
+    op_http_conn_close(_stream,conn,&_stream->lru_head,1);
+    return NULL;
+  }
+  _stream->lru_head=conn->next;
+  conn->next=NULL;
+  *_state=ret;
+  return conn;
+}
+
+/*Hand the connection of a prefetch that completed back to the LRU list.
+  It goes right after the current connection (which must stay at the head), so
+   that it's the first one we consider reusing.*/
+static void op_http_fetch_finish(OpusHTTPStream *_stream,
+ OpusHTTPFetch *_fetch){
+  OpusHTTPConn *conn;
+  conn=_fetch->conn;
+  if(_stream->cur_conni>=0){
+    OP_ASSERT(_stream->lru_head==_stream->conns+_stream->cur_conni);
+    conn->next=_stream->lru_head->next;
+    _stream->lru_head->next=conn;
+  }
+  else{
+    conn->next=_stream->lru_head;
+    _stream->lru_head=conn;
+  }
+  _fetch->conn=NULL;
+}
+
+/*Give up on a prefetch, dropping the blocks it hadn't finished.*/
+static void op_http_fetch_abort(OpusHTTPStream *_stream,int _fi){
+  OpusHTTPCache *cache;
+  OpusHTTPFetch *fetch;
+  opus_int64     block;
+  cache=&_stream->cache;
+  fetch=cache->fetches+_fi;
+  for(block=fetch->block;block*cache->block_size<fetch->end;block++){
+    int si;
+    si=op_http_cache_lookup(cache,block);
+    if(si>=0&&cache->slots[si].fetchi==_fi)op_http_cache_invalidate(cache,si);
+  }
+  op_http_conn_close(_stream,fetch->conn,&fetch->conn,0);
+}
+
+/*Send the request for a prefetch, once its connection is ready.
+  Return: 0 on success, or a negative value on error.*/
+static int op_http_fetch_send(OpusHTTPStream *_stream,OpusHTTPFetch *_fetch){
+  opus_int64 pos;
+  pos=_fetch->block*_stream->cache.block_size;
+  /*Without pipelining we can only ask for the rest of the resource, but we'll
+     still only read as far as we need to.*/
+  return op_http_conn_send_request(_stream,_fetch->conn,pos,
+   _stream->pipeline?(opus_int32)(_fetch->end-pos):-1,0);
+}
+
+/*Start prefetching a run of blocks, none of which may already be cached.
+  Return: 1 if the prefetch was started, or 0 if there was no connection to
+           start it on.*/
+static int op_http_fetch_start(OpusHTTPStream *_stream,
+ opus_int64 _block,int _nblocks){
+  OpusHTTPCache *cache;
+  OpusHTTPFetch *fetch;
+  OpusHTTPConn  *conn;
+  opus_int64     pos;
+  opus_int64     block;
+  short          events;
+  int            state;
+  int            fi;
+  cache=&_stream->cache;
+  for(fi=0;fi<cache->nfetches&&cache->fetches[fi].conn!=NULL;fi++);
+  if(fi>=cache->nfetches)return 0;
+  conn=op_http_fetch_conn_acquire(_stream,&state,&events);
+  if(conn==NULL)return 0;
+  fetch=cache->fetches+fi;
+  fetch->conn=conn;
+  pos=_block*cache->block_size;
+  fetch->block=_block;
+  fetch->end=OP_MIN(pos+_nblocks*(opus_int64)cache->block_size,
+   _stream->content_length);
+  OP_ASSERT(pos<fetch->end);
+  fetch->response.nbuf=0;
+  ftime(&fetch->progress_time);
+  fetch->connecting=state;
+  fetch->events=events;
+  fetch->started=0;
+  if(!state&&OP_UNLIKELY(op_http_fetch_send(_stream,fetch)<0)){
+    op_http_conn_close(_stream,conn,&fetch->conn,0);
+    return 0;
+  }
+  for(block=_block;block*cache->block_size<fetch->end;block++){
+    cache->slots[op_http_cache_alloc(cache,block)].fetchi=fi;
+    cache->npending++;
+  }
+  return 1;
+}
+
+/*Carry on setting up the connection for a prefetch, and send its request once
+   the connection is ready.
+  Return: 1 if we made progress, or a negative value if the prefetch failed.*/
+static int op_http_fetch_connect(OpusHTTPStream *_stream,int _fi){
+  OpusHTTPFetch *fetch;
+  int            ret;
+  fetch=_stream->cache.fetches+_fi;
+  ret=op_http_connect_continue(_stream,fetch->conn,fetch->connecting,
+   &fetch->events);
+  if(OP_UNLIKELY(ret<0))return ret;
+  fetch->connecting=ret;
+  if(!ret){
+    ret=op_http_fetch_send(_stream,fetch);
+    if(OP_UNLIKELY(ret<0))return ret;
+  }
+  return 1;
+}
+
+/*Read whatever has arrived for a prefetch without blocking.
+  _hup: Whether poll() said the peer hung up.
+  Return: 1 if we made progress, 0 if there was nothing to read, or a negative
+           value if the prefetch failed.*/
+static int op_http_fetch_read(OpusHTTPStream *_stream,int _fi,int _hup){
+  OpusHTTPCache *cache;
+  OpusHTTPFetch *fetch;
+  OpusHTTPConn  *conn;
+  int            progress;
+  cache=&_stream->cache;
+  fetch=cache->fetches+_fi;
+  conn=fetch->conn;
+  progress=0;
+  if(!fetch->started){
+    int nbuf;
+    int ret;
+    /*The headers may arrive in pieces, so collect them as they come.*/
+    nbuf=fetch->response.nbuf;
+    ret=op_http_conn_read_response(conn,&fetch->response,0);
+    if(ret==OP_EAGAIN){
+      if(_hup)return OP_EREAD;
+      return fetch->response.nbuf>nbuf;
+    }
+    if(OP_UNLIKELY(ret<0))return ret;
+    if(OP_UNLIKELY(op_http_conn_parse_response(_stream,conn,
+     fetch->response.buf)!=0)){
+      return OP_FALSE;
+    }
+    fetch->started=1;
+    /*The body might not have arrived yet.*/
+    progress=1;
+  }
+  while(fetch->block*cache->block_size<fetch->end){
+    OpusHTTPCacheSlot *slot;
+    unsigned char     *buf;
+    opus_int32         len;
+    int                nread;
+    int                si;
+    si=op_http_cache_lookup(cache,fetch->block);
+    OP_ASSERT(si>=0);
+    slot=cache->slots+si;
+    OP_ASSERT(slot->fetchi==_fi);
+    len=(opus_int32)OP_MIN(cache->block_size,
+     fetch->end-fetch->block*cache->block_size);
+    buf=cache->file!=NULL?fetch->buf:cache->data+si*(size_t)cache->block_size;
+    nread=op_http_conn_read(conn,(char *)buf+slot->len,len-slot->len,0);
+    if(OP_UNLIKELY(nread<0))return nread;
+    if(nread==0){
+      /*A plain socket that polled readable but has no data was closed.
+        With TLS, we might just have a partial record.*/
+      if(!progress&&(_hup||conn->ssl_conn==NULL||(SSL_get_shutdown(
+       conn->ssl_conn)&SSL_RECEIVED_SHUTDOWN))){
+        return OP_EREAD;
+      }
+      break;
+    }
+    progress=1;
+    conn->pos+=nread;
+    slot->len+=nread;
+    if(slot->len>=len){
+      if(OP_UNLIKELY(op_http_cache_store(cache,si,buf)<0))return OP_EREAD;
+      slot->fetchi=-1;
+      cache->npending--;
+      fetch->block++;
+    }
+  }
+  if(fetch->block*cache->block_size>=fetch->end){
+    op_http_fetch_finish(_stream,fetch);
+    progress=1;
+  }
+  return progress;
+}
+
+/*Service all the running prefetches at once.
+  _timeout_ms: How long to wait for any of them to have data available.
+               If this is 0, we only collect what has already arrived.
+  Return: The number of prefetches that made progress, finished, or failed.*/
+static int op_http_fetch_pump(OpusHTTPStream *_stream,int _timeout_ms){
+  struct pollfd  fds[OP_NCONNS_MAX];
+  int            fis[OP_NCONNS_MAX];
+  OpusHTTPCache *cache;
+  int            nfds;
+  int            nprogress;
+  int            fi;
+  int            i;
+  cache=&_stream->cache;
+  nfds=0;
+  for(fi=0;fi<cache->nfetches;fi++){
+    OpusHTTPFetch *fetch;
+    OpusHTTPConn  *conn;
+    fetch=cache->fetches+fi;
+    conn=fetch->conn;
+    if(conn==NULL)continue;
+    fds[nfds].fd=conn->fd;
+    if(fetch->connecting)fds[nfds].events=fetch->events;
+    else{
+      /*TLS might already have decrypted data that poll() can't see.*/
+      if(conn->ssl_conn!=NULL&&SSL_pending(conn->ssl_conn)>0)_timeout_ms=0;
+      fds[nfds].events=POLLIN;
+    }
+    fis[nfds++]=fi;
+  }
+  if(nfds<=0||poll(fds,nfds,_timeout_ms)<0)return 0;
+  nprogress=0;
+  for(i=0;i<nfds;i++){
+    OpusHTTPFetch *fetch;
+    OpusHTTPConn  *conn;
+    int            ret;
+    fetch=cache->fetches+fis[i];
+    conn=fetch->conn;
+    if(fetch->connecting){
+      if(!fds[i].revents)continue;
+      ret=op_http_fetch_connect(_stream,fis[i]);
+    }
+    else{
+      if(!fds[i].revents
+       &&(conn->ssl_conn==NULL||SSL_pending(conn->ssl_conn)<=0)){
+        continue;
+      }
+      ret=op_http_fetch_read(_stream,fis[i],
+       fds[i].revents&(POLLHUP|POLLERR));
+    }
+    if(OP_UNLIKELY(ret<0))op_http_fetch_abort(_stream,fis[i]);
+    else if(ret>0)ftime(&fetch->progress_time);
+    nprogress+=ret!=0;
+  }
+  return nprogress;
+}
+
+/*Give up on the prefetches that haven't made any progress for as long as
+   op_http_fetch_wait() would have waited for them.
+  _block: The block the caller needs next.
+  Return: 1 if the prefetch of _block was one of them, or 0 otherwise.*/
+static int op_http_fetch_expire(OpusHTTPStream *_stream,opus_int64 _block){
+  struct timeb   now;
+  OpusHTTPCache *cache;
+  int            expired;
+  int            si;
+  int            fi;
+  cache=&_stream->cache;
+  si=op_http_cache_lookup(cache,_block);
+  expired=0;
+  ftime(&now);
+  for(fi=0;fi<cache->nfetches;fi++){
+    if(cache->fetches[fi].conn!=NULL&&op_time_diff_ms(&now,
+     &cache->fetches[fi].progress_time)>=OP_POLL_TIMEOUT_MS){
+      expired|=si>=0&&cache->slots[si].fetchi==fi;
+      op_http_fetch_abort(_stream,fi);
+    }
+  }
+  return expired;
+}
+
+/*Wait for a block that is being prefetched.
+  Return: The slot holding the block, or -1 if it is no longer cached (because
+           the prefetch failed).*/
+static int op_http_fetch_wait(OpusHTTPStream *_stream,opus_int64 _block){
+  OpusHTTPCache *cache;
+  cache=&_stream->cache;
+  for(;;){
+    int si;
+    si=op_http_cache_lookup(cache,_block);
+    if(si<0||cache->slots[si].fetchi<0)return si;
+    if(op_http_fetch_pump(_stream,OP_POLL_TIMEOUT_MS)<=0){
+      /*Nothing has happened for a long time: give up on this one.*/
+      op_http_fetch_abort(_stream,cache->slots[si].fetchi);
+    }
+  }
+}
+
+/*Start prefetches for the missing blocks from _block onwards, spread over as
+   many connections as we can, while keeping no more than half the cache
+   waiting on them.*/
+static void op_http_fetch_ahead(OpusHTTPStream *_stream,opus_int64 _block){
+  OpusHTTPCache *cache;
+  opus_int64     nblocks_total;
+  opus_int64     last;
+  int            budget;
+  int            run;
+  cache=&_stream->cache;
+  budget=(cache->nslots>>1)-cache->npending;
+  if(budget<=0)return;
+  nblocks_total=(_stream->content_length+cache->block_size-1)/cache->block_size;
+  last=OP_MIN(_block+(cache->nslots>>1),nblocks_total);
+  run=OP_MAX((cache->nslots>>1)/cache->nfetches,1);
+  while(_block<last&&budget>0){
+    int nblocks;
+    if(op_http_cache_lookup(cache,_block)>=0){
+      _block++;
+      continue;
+    }
+    for(nblocks=1;nblocks<OP_MIN(run,budget)&&_block+nblocks<last
+     &&op_http_cache_lookup(cache,_block+nblocks)<0;nblocks++);
+    if(!op_http_fetch_start(_stream,_block,nblocks))break;
+    _block+=nblocks;
+    budget-=nblocks;
+  }
+}
+
+/*Set up the block cache for a seekable stream.
+  _size:       The capacity of the cache, in bytes.
+               If this is less than one block, the cache stays disabled.
+  _block_size: The size of each block.
+  _path:       The file to keep the blocks in, or NULL to keep them in
+                memory.
+  _parallel:   Whether or not to prefetch over multiple connections at once.
+  Return: 0 on success, or a negative value on error.*/
+static int op_http_cache_enable(OpusHTTPStream *_stream,opus_int32 _size,
+ opus_int32 _block_size,const char *_path,int _parallel){
+  OpusHTTPCache *cache;
+  int            nslots;
+  int            nbuckets;
+  int            bi;
+  int            fi;
+  cache=&_stream->cache;
+  nslots=_size/_block_size;
+  if(nslots<1)return 0;
+  for(nbuckets=1;nbuckets<nslots;nbuckets<<=1);
+  cache->slots=(OpusHTTPCacheSlot *)_ogg_malloc(sizeof(*cache->slots)*nslots);
+  cache->buckets=(int *)_ogg_malloc(sizeof(*cache->buckets)*nbuckets);
+  if(_path!=NULL){
+    cache->file=op_fopen(&cache->file_cb,_path,"w+b");
+    cache->file_buf=(unsigned char *)_ogg_malloc(_block_size);
+    if(OP_UNLIKELY(cache->file==NULL))return OP_EFAULT;
+  }
+  else{
+    cache->data=(unsigned char *)_ogg_malloc(nslots*(size_t)_block_size);
+  }
+  if(OP_UNLIKELY(cache->slots==NULL)||OP_UNLIKELY(cache->buckets==NULL)
+   ||OP_UNLIKELY(cache->data==NULL&&cache->file_buf==NULL)){
+    return OP_EFAULT;
+  }
+  for(bi=0;bi<nbuckets;bi++)cache->buckets[bi]=-1;
+  cache->pos=0;
+  cache->block_size=_block_size;
+  cache->nslots=nslots;
+  cache->nused=0;
+  cache->bucket_mask=nbuckets-1;
+  cache->lru_head=cache->lru_tail=-1;
+  cache->npending=0;
+  cache->seq_start=cache->seq_end=0;
+  /*Prefetching needs a spare connection and at least two slots.*/
+  if(!_parallel||_stream->nconns<2||nslots<2)return 0;
+  cache->fetches=(OpusHTTPFetch *)_ogg_malloc(
+   sizeof(*cache->fetches)*(_stream->nconns-1));
+  if(OP_UNLIKELY(cache->fetches==NULL))return OP_EFAULT;
+  cache->nfetches=_stream->nconns-1;
+  for(fi=0;fi<cache->nfetches;fi++){
+    cache->fetches[fi].conn=NULL;
+    cache->fetches[fi].buf=NULL;
+    op_sb_init(&cache->fetches[fi].response);
+  }
+  if(_path!=NULL){
+    for(fi=0;fi<cache->nfetches;fi++){
+      cache->fetches[fi].buf=(unsigned char *)_ogg_malloc(_block_size);
+      if(OP_UNLIKELY(cache->fetches[fi].buf==NULL))return OP_EFAULT;
+    }
+  }
+  /*The first thing opening the file does after reading the headers is look at
+     the last page, so start fetching it now, while the connection we opened
+     the stream with is still delivering the beginning.*/
+  if(_stream->content_length>0){
+    opus_int64 last;
+    int        nblocks;
+    last=(_stream->content_length-1)/_block_size;
+    nblocks=OP_MIN((OP_PREFETCH_TAIL_SIZE+_block_size-1)/_block_size+1,
+     OP_MAX(nslots>>1,1));
+    nblocks=(int)OP_MIN(nblocks,last+1);
+    op_http_fetch_start(_stream,last-nblocks+1,nblocks);
+  }
+  return 0;
+}
+
+/*Read from the block cache, fetching whatever is missing.
+  In non-blocking mode, we stop at the first block that hasn't arrived, and
+   return OP_EAGAIN if that was the first one we needed.*/
+static int op_http_cache_read(OpusHTTPStream *_stream,
+ unsigned char *_ptr,int _buf_size){
+  OpusHTTPCache *cache;
+  opus_int64     size;
+  int            nread;
+  cache=&_stream->cache;
+  /*Collect whatever the prefetches have received in the meantime.
+    This also keeps their TCP windows open.*/
+  if(cache->nfetches>0){
+    op_http_fetch_pump(_stream,0);
+    /*Nothing else will time out a stalled prefetch when we don't wait, and
+       the caller would keep getting OP_EAGAIN forever.*/
+    if(_stream->nonblocking
+     &&op_http_fetch_expire(_stream,cache->pos/cache->block_size)){
+      return OP_EREAD;
+    }
+  }
+  size=_stream->content_length;
+  /*Check for EOF.*/
+  if(cache->pos>=size)return 0;
+  /*Check for a short read.*/
+  if(_buf_size>size-cache->pos)_buf_size=(int)(size-cache->pos);
+  if(cache->pos!=cache->seq_end)cache->seq_start=cache->pos;
+  for(nread=0;nread<_buf_size;){
+    opus_int64 block;
+    opus_int32 off;
+    opus_int32 ncopy;
+    int        si;
+    block=cache->pos/cache->block_size;
+    off=(opus_int32)(cache->pos-block*cache->block_size);
+    si=op_http_cache_lookup(cache,block);
+    if(si>=0&&cache->slots[si].fetchi>=0){
+      if(_stream->nonblocking)break;
+      si=op_http_fetch_wait(_stream,block);
+    }
+    /*If this was the last block and the resource has grown since, the block
+       is short, and we need to fetch it again.*/
+    if(si>=0&&OP_UNLIKELY(off>=cache->slots[si].len)){
+      op_http_cache_invalidate(cache,si);
+      si=-1;
+    }
+    if(si<0){
+      opus_int64 last;
+      int        nblocks;
+      int        nblocks_max;
+      int        ret;
+      /*Coalesce this block with the missing blocks after it that the rest of
+         this read will need, so they all come from a single request.
+        We stop at half the cache, so that a large read can't evict the blocks
+         it is itself fetching, and at the first cached block, since there's
+         no sense fetching it again.*/
+      last=(cache->pos+(_buf_size-nread)-1)/cache->block_size;
+      nblocks_max=OP_MAX(cache->nslots>>1,1);
+      for(nblocks=1;nblocks<nblocks_max&&block+nblocks<=last
+       &&op_http_cache_lookup(cache,block+nblocks)<0;nblocks++);
+      /*In non-blocking mode, start fetching them on a spare connection and
+         come back for them later.
+        If there's no spare connection, we can wait for one to free up, but
+         only if some other fetch is still running.*/
+      if(_stream->nonblocking&&cache->nfetches>0
+       &&(op_http_fetch_start(_stream,block,nblocks)||cache->npending>0)){
+        break;
+      }
+      ret=op_http_cache_fill(_stream,block,nblocks);
+      if(OP_UNLIKELY(ret<0))return nread>0?nread:ret;
+      si=op_http_cache_lookup(cache,block);
+      OP_ASSERT(si>=0);
+    }
+    else{
+      op_http_cache_lru_remove(cache,si);
+      op_http_cache_lru_insert(cache,si);
+    }
+    ncopy=OP_MIN(cache->slots[si].len-off,_buf_size-nread);
+    if(cache->file!=NULL){
+      if(OP_UNLIKELY((*cache->file_cb.seek)(cache->file,
+       si*(opus_int64)cache->block_size+off,SEEK_SET)<0)
+       ||OP_UNLIKELY((*cache->file_cb.read)(cache->file,_ptr+nread,ncopy)
+       !=ncopy)){
+        op_http_cache_invalidate(cache,si);
+        return nread>0?nread:OP_EREAD;
+      }
+    }
+    else memcpy(_ptr+nread,cache->data+si*(size_t)cache->block_size+off,ncopy);
+    nread+=ncopy;
+    cache->pos+=ncopy;
+  }
+  if(_stream->nonblocking&&nread<=0&&_buf_size>0)return OP_EAGAIN;
+  cache->seq_end=cache->pos;
+  /*If we've been reading sequentially for a while, keep the blocks ahead of
+     us coming in over the other connections.*/
+  if(cache->nfetches>0&&cache->pos-cache->seq_start>=OP_PREFETCH_THRESH){
+    op_http_fetch_ahead(_stream,cache->pos/cache->block_size);
+  }
+  return nread;
+}
+
+static int op_http_stream_read(void *_stream,
+ unsigned char *_ptr,int _buf_size){
+  OpusHTTPStream *stream;
+  stream=(OpusHTTPStream *)_stream;
+  /*Check for an empty read.*/
+  if(_buf_size<=0)return 0;
+  if(stream->cache.slots!=NULL){
+    return op_http_cache_read(stream,_ptr,_buf_size);
+  }
+  return op_http_stream_read_impl(stream,_ptr,_buf_size);
+}
+
+static int op_http_stream_seek(void *_stream,opus_int64 _offset,int _whence){
+  OpusHTTPStream *stream;
+  opus_int64      content_length;
+  opus_int64      pos;
+  int             ci;
+  stream=(OpusHTTPStream *)_stream;
+  if(!stream->seekable)return -1;
+  content_length=stream->content_length;
+  /*If we're seekable, we should have gotten a Content-Length.*/
+  OP_ASSERT(content_length>=0);
+  ci=stream->cur_conni;
+  if(stream->cache.slots!=NULL)pos=stream->cache.pos;
+  else pos=ci<0?content_length:stream->conns[ci].pos;
+  switch(_whence){
+    case SEEK_SET:{
+      /*Check for overflow:*/
+      if(_offset<0)return -1;
+      pos=_offset;
+    }break;
+    case SEEK_CUR:{
+      /*Check for overflow:*/
+      if(_offset<-pos||_offset>OP_INT64_MAX-pos)return -1;
+      pos+=_offset;
+    }break;
+    case SEEK_END:{
+      /*Check for overflow:*/
+      if(_offset>content_length||_offset<content_length-OP_INT64_MAX)return -1;
+      pos=content_length-_offset;
+    }break;
+    default:return -1;
+  }
+  /*With the cache, seeking is free: we don't touch the connections until we
+     actually miss.*/
+  if(stream->cache.slots!=NULL){
+    stream->cache.pos=pos;
+    return 0;
+  }
+  return op_http_stream_seek_impl(stream,pos,
+   op_http_stream_chunk_size(stream));
+}
+
 static opus_int64 op_http_stream_tell(void *_stream){
   OpusHTTPStream *stream;
   int             ci;
   stream=(OpusHTTPStream *)_stream;
+  if(stream->cache.slots!=NULL)return stream->cache.pos;
   ci=stream->cur_conni;
   return ci<0?stream->pos:stream->conns[ci].pos;
 }
@@ -3197,6 +4785,55 @@ static int op_http_stream_close(void *_stream){
   return 0;
 }
 
+/*Report the sockets of the running prefetches, which are all a non-blocking
+   read can be waiting on.
+  The timeout is when op_http_fetch_expire() would give up on the oldest
+   stalled one.*/
+static int op_http_stream_poll(void *_stream,OpusPollFd *_fds,int _nfds,
+ opus_int32 *_timeout_ms){
+  struct timeb    now;
+  OpusHTTPStream *stream;
+  OpusHTTPCache  *cache;
+  opus_int32      timeout_ms;
+  int             nfds;
+  int             fi;
+  stream=(OpusHTTPStream *)_stream;
+  cache=&stream->cache;
+  ftime(&now);
+  timeout_ms=-1;
+  nfds=0;
+  for(fi=0;fi<cache->nfetches;fi++){
+    OpusHTTPFetch *fetch;
+    OpusHTTPConn  *conn;
+    opus_int32     left_ms;
+    fetch=cache->fetches+fi;
+    conn=fetch->conn;
+    if(conn==NULL)continue;
+    if(nfds<_nfds){
+      _fds[nfds].fd=(opus_int64)conn->fd;
+      if(fetch->connecting){
+        _fds[nfds].events=(fetch->events&POLLIN?OP_POLLIN:0)
+         |(fetch->events&POLLOUT?OP_POLLOUT:0);
+      }
+      else _fds[nfds].events=OP_POLLIN;
+    }
+    nfds++;
+    /*TLS might already have decrypted data that poll() can't see.*/
+    if(!fetch->connecting&&conn->ssl_conn!=NULL
+     &&SSL_pending(conn->ssl_conn)>0){
+      left_ms=0;
+    }
+    else{
+      left_ms=OP_MAX(OP_POLL_TIMEOUT_MS
+       -op_time_diff_ms(&now,&fetch->progress_time),0);
+    }
+    if(timeout_ms<0||left_ms<timeout_ms)timeout_ms=left_ms;
+  }
+  /*With nothing to wait on, the next read won't return OP_EAGAIN.*/
+  *_timeout_ms=nfds>0?timeout_ms:0;
+  return nfds;
+}
+
 static const OpusFileCallbacks OP_HTTP_CALLBACKS={
   op_http_stream_read,
   op_http_stream_seek,
@@ -3226,13 +4863,61 @@ void opus_server_info_clear(OpusServerInfo *_info){
   _ogg_free(_info->name);
 }
 
+OpusHTTPClient *op_http_client_create(void){
+#if defined(OP_ENABLE_HTTP)
+  OpusHTTPClient *client;
+  client=(OpusHTTPClient *)_ogg_malloc(sizeof(*client));
+  if(OP_UNLIKELY(client==NULL))return NULL;
+  op_mutex_init(&client->mutex);
+  client->refs=1;
+  client->ssl_ctx[0]=client->ssl_ctx[1]=NULL;
+  client->routes=NULL;
+  return client;
+#else
+  return NULL;
+#endif
+}
+
+void op_http_client_release(OpusHTTPClient *_client){
+#if defined(OP_ENABLE_HTTP)
+  if(_client!=NULL&&OP_ATOMIC_FETCH_DEC(&_client->refs)==1){
+    OpusHTTPRoute *route;
+    while((route=_client->routes)!=NULL){
+      OpusHTTPIdleConn *idle;
+      _client->routes=route->next;
+      while((idle=route->idle)!=NULL){
+        route->idle=idle->next;
+        op_http_idle_conn_free(idle);
+      }
+      if(route->ssl_session!=NULL)SSL_SESSION_free(route->ssl_session);
+      _ogg_free(route->connect_host);
+      _ogg_free(route->host);
+      _ogg_free(route);
+    }
+    /*The idle connections had to go first, since they use these.*/
+    if(_client->ssl_ctx[0]!=NULL)SSL_CTX_free(_client->ssl_ctx[0]);
+    if(_client->ssl_ctx[1]!=NULL)SSL_CTX_free(_client->ssl_ctx[1]);
+    op_mutex_clear(&_client->mutex);
+    _ogg_free(_client);
+  }
+#else
+  (void)_client;
+#endif
+}
+
 /*The actual URL stream creation function.
   This one isn't extensible like the application-level interface, but because
-   it isn't public, we're free to change it in the future.*/
-static void *op_url_stream_create_impl(OpusFileCallbacks *_cb,const char *_url,
- int _skip_certificate_check,const char *_proxy_host,unsigned _proxy_port,
- const char *_proxy_user,const char *_proxy_pass,OpusServerInfo *_info){
+   it isn't public, we're free to change it in the future.
+  _poll: Returns the function to pass to op_open_callbacks_nonblocking(), or
+          NULL if the stream will never return OP_EAGAIN.
+         If this is NULL, non-blocking reads are never enabled.*/
+static void *op_url_stream_create_impl(OpusFileCallbacks *_cb,
+ op_poll_func *_poll,const char *_url,int _skip_certificate_check,
+ const char *_proxy_host,unsigned _proxy_port,
+ const char *_proxy_user,const char *_proxy_pass,
+ const OpusHTTPParams *_params,OpusServerInfo *_info){
   const char *path;
+  if(_poll!=NULL)*_poll=NULL;
   /*Check to see if this is a valid file: URL.*/
   path=op_parse_file_url(_url);
   if(path!=NULL){
@@ -3251,15 +4936,26 @@ static void *op_url_stream_create_impl(OpusFileCallbacks *_cb,const char *_url,
     int             ret;
     stream=(OpusHTTPStream *)_ogg_malloc(sizeof(*stream));
     if(OP_UNLIKELY(stream==NULL))return NULL;
-    op_http_stream_init(stream);
-    ret=op_http_stream_open(stream,_url,_skip_certificate_check,
-     _proxy_host,_proxy_port,_proxy_user,_proxy_pass,_info);
+    ret=op_http_stream_init(stream,_params);
+    if(_poll==NULL)stream->nonblocking=0;
+    if(OP_LIKELY(ret>=0)){
+      ret=op_http_stream_open(stream,_url,_skip_certificate_check,
+       _proxy_host,_proxy_port,_proxy_user,_proxy_pass,_info);
+    }
+    if(OP_LIKELY(ret>=0)&&stream->seekable){
+      ret=op_http_cache_enable(stream,_params->cache_size,
+       _params->cache_block_size,_params->cache_path,_params->parallel);
+    }
     if(OP_UNLIKELY(ret<0)){
       op_http_stream_clear(stream);
       _ogg_free(stream);
       return NULL;
     }
     *_cb=*&OP_HTTP_CALLBACKS;
+    /*Only a stream that can return OP_EAGAIN has anything to wait on.*/
+    if(_poll!=NULL&&stream->nonblocking&&stream->cache.nfetches>0){
+      *_poll=op_http_stream_poll;
+    }
     return stream;
   }
 #else
@@ -3268,24 +4964,29 @@ static void *op_url_stream_create_impl(OpusFileCallbacks *_cb,const char *_url,
   (void)_proxy_port;
   (void)_proxy_user;
   (void)_proxy_pass;
+  (void)_params;
   (void)_info;
   return NULL;
 #endif
 }
 
-void *op_url_stream_vcreate(OpusFileCallbacks *_cb,
- const char *_url,va_list _ap){
+/*Parse the options and create the stream.
+  _poll: See op_url_stream_create_impl().*/
+static void *op_url_stream_vcreate_impl(OpusFileCallbacks *_cb,
+ op_poll_func *_poll,const char *_url,va_list _ap){
   int             skip_certificate_check;
   const char     *proxy_host;
   opus_int32      proxy_port;
   const char     *proxy_user;
   const char     *proxy_pass;
+  OpusHTTPParams  params;
   OpusServerInfo *pinfo;
   skip_certificate_check=0;
   proxy_host=NULL;
   proxy_port=8080;
   proxy_user=NULL;
   proxy_pass=NULL;
+  op_http_params_init(&params);
   pinfo=NULL;
   for(;;){
     ptrdiff_t request;
@@ -3312,24 +5013,82 @@ void *op_url_stream_vcreate(OpusFileCallbacks *_cb,
       case OP_GET_SERVER_INFO_REQUEST:{
         pinfo=va_arg(_ap,OpusServerInfo *);
       }break;
+      case OP_HTTP_CACHE_SIZE_REQUEST:{
+        params.cache_size=va_arg(_ap,opus_int32);
+        if(params.cache_size<0)return NULL;
+      }break;
+      case OP_HTTP_CACHE_BLOCK_SIZE_REQUEST:{
+        params.cache_block_size=va_arg(_ap,opus_int32);
+        if(params.cache_block_size<OP_CACHE_BLOCK_SIZE_MIN
+         ||params.cache_block_size>OP_CACHE_BLOCK_SIZE_MAX){
+          return NULL;
+        }
+      }break;
+      case OP_HTTP_CACHE_FILE_REQUEST:{
+        params.cache_path=va_arg(_ap,const char *);
+      }break;
+      case OP_HTTP_MAX_CONNECTIONS_REQUEST:{
+        params.nconns=va_arg(_ap,opus_int32);
+        if(params.nconns<1||params.nconns>OP_NCONNS_MAX)return NULL;
+      }break;
+      case OP_HTTP_PARALLEL_FETCH_REQUEST:{
+        params.parallel=!!va_arg(_ap,opus_int32);
+      }break;
+      case OP_HTTP_ADAPTIVE_CHUNKS_REQUEST:{
+        params.adaptive=!!va_arg(_ap,opus_int32);
+      }break;
+      case OP_HTTP_CHUNK_SIZE_MIN_REQUEST:{
+        params.chunk_size_min=va_arg(_ap,opus_int32);
+        if(params.chunk_size_min<=0
+         ||params.chunk_size_min>OP_PIPELINE_CHUNK_SIZE_LIMIT){
+          return NULL;
+        }
+      }break;
+      case OP_HTTP_CHUNK_SIZE_MAX_REQUEST:{
+        params.chunk_size_max=va_arg(_ap,opus_int32);
+        if(params.chunk_size_max<=0
+         ||params.chunk_size_max>OP_PIPELINE_CHUNK_SIZE_LIMIT){
+          return NULL;
+        }
+      }break;
+      case OP_HTTP_READ_AHEAD_MIN_REQUEST:{
+        params.read_ahead_min=va_arg(_ap,opus_int32);
+        if(params.read_ahead_min<0)return NULL;
+      }break;
+      case OP_HTTP_NONBLOCKING_REQUEST:{
+        params.nonblocking=!!va_arg(_ap,opus_int32);
+      }break;
+      case OP_HTTP_CLIENT_REQUEST:{
+        params.client=va_arg(_ap,OpusHTTPClient *);
+      }break;
       /*Some unknown option.*/
       default:return NULL;
     }
   }
+  /*The options may come in any order, so we can only check that the chunk size
+     range is sensible once we've seen all of them.*/
+  if(params.chunk_size_min>params.chunk_size_max)return NULL;
   /*If the caller has requested server information, proxy it to a local copy to
      simplify error handling.*/
   if(pinfo!=NULL){
     OpusServerInfo  info;
     void           *ret;
     opus_server_info_init(&info);
-    ret=op_url_stream_create_impl(_cb,_url,skip_certificate_check,
-     proxy_host,proxy_port,proxy_user,proxy_pass,&info);
+    ret=op_url_stream_create_impl(_cb,_poll,_url,skip_certificate_check,
+     proxy_host,proxy_port,proxy_user,proxy_pass,&params,&info);
     if(ret!=NULL)*pinfo=*&info;
     else opus_server_info_clear(&info);
     return ret;
   }
-  return op_url_stream_create_impl(_cb,_url,skip_certificate_check,
-   proxy_host,proxy_port,proxy_user,proxy_pass,NULL);
+  return op_url_stream_create_impl(_cb,_poll,_url,skip_certificate_check,
+   proxy_host,proxy_port,proxy_user,proxy_pass,&params,NULL);
+}
+
+void *op_url_stream_vcreate(OpusFileCallbacks *_cb,
+ const char *_url,va_list _ap){
+  /*The caller has no way to hand us back to op_open_callbacks_nonblocking(),
+     so it doesn't get a stream that can return OP_EAGAIN.*/
+  return op_url_stream_vcreate_impl(_cb,NULL,_url,_ap);
 }
 
 void *op_url_stream_create(OpusFileCallbacks *_cb,
@@ -3346,14 +5105,18 @@ void *op_url_stream_create(OpusFileCallbacks *_cb,
 
 OggOpusFile *op_vopen_url(const char *_url,int *_error,va_list _ap){
   OpusFileCallbacks  cb;
+  op_poll_func       poll_func;
   OggOpusFile       *of;
   void              *source;
-  source=op_url_stream_vcreate(&cb,_url,_ap);
+  source=op_url_stream_vcreate_impl(&cb,&poll_func,_url,_ap);
   if(OP_UNLIKELY(source==NULL)){
     if(_error!=NULL)*_error=OP_EFAULT;
     return NULL;
   }
-  of=op_open_callbacks(source,&cb,NULL,0,_error);
+  if(poll_func!=NULL){
+    of=op_open_callbacks_nonblocking(source,&cb,poll_func,NULL,0,_error);
+  }
+  else of=op_open_callbacks(source,&cb,NULL,0,_error);
   if(OP_UNLIKELY(of==NULL))(*cb.close)(source);
   return of;
 }
@@ -3369,14 +5132,18 @@ OggOpusFile *op_open_url(const char *_url,int *_error,...){
 
 OggOpusFile *op_vtest_url(const char *_url,int *_error,va_list _ap){
   OpusFileCallbacks  cb;
+  op_poll_func       poll_func;
   OggOpusFile       *of;
   void              *source;
-  source=op_url_stream_vcreate(&cb,_url,_ap);
+  source=op_url_stream_vcreate_impl(&cb,&poll_func,_url,_ap);
   if(OP_UNLIKELY(source==NULL)){
     if(_error!=NULL)*_error=OP_EFAULT;
     return NULL;
   }
-  of=op_test_callbacks(source,&cb,NULL,0,_error);
+  if(poll_func!=NULL){
+    of=op_test_callbacks_nonblocking(source,&cb,poll_func,NULL,0,_error);
+  }
+  else of=op_test_callbacks(source,&cb,NULL,0,_error);
   if(OP_UNLIKELY(of==NULL))(*cb.close)(source);
   return of;
 }
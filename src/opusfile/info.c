@@ -120,13 +120,15 @@ static int op_tags_ensure_capacity(OpusTags *_tags,size_t _ncomments){
   return 0;
 }
 
-/*Duplicate a (possibly non-NUL terminated) string with a known length.*/
-static char *op_strdup_with_len(const char *_s,size_t _len){
+/*Copy a (possibly non-NUL terminated) string with a known length into the
+   storage of an existing string _dst (which may be NULL), resizing it.
+  On failure, _dst is left unchanged and NULL is returned.*/
+static char *op_strrealloc_with_len(char *_dst,const char *_s,size_t _len){
   size_t  size;
   char   *ret;
   size=sizeof(*ret)*(_len+1);
   if(OP_UNLIKELY(size<_len))return NULL;
-  ret=(char *)_ogg_malloc(size);
+  ret=(char *)_ogg_realloc(_dst,size);
   if(OP_LIKELY(ret!=NULL)){
     ret=(char *)memcpy(ret,_s,sizeof(*ret)*_len);
     ret[_len]='\0';
@@ -134,14 +136,22 @@ static char *op_strdup_with_len(const char *_s,size_t _len){
   return ret;
 }
 
+/*Duplicate a (possibly non-NUL terminated) string with a known length.*/
+static char *op_strdup_with_len(const char *_s,size_t _len){
+  return op_strrealloc_with_len(NULL,_s,_len);
+}
+
 /*The actual implementation of opus_tags_parse().
   Unlike the public API, this function requires _tags to already be
    initialized, modifies its contents before success is guaranteed, and assumes
-   the caller will clear it on error.*/
+   the caller will clear it on error.
+  Any strings _tags already contains are overwritten in place, and any extra
+   comments are freed.*/
 static int opus_tags_parse_impl(OpusTags *_tags,
  const unsigned char *_data,size_t _len){
   opus_uint32 count;
   size_t      len;
+  char       *s;
   int         ncomments;
   int         ci;
   len=_len;
@@ -155,8 +165,9 @@ static int opus_tags_parse_impl(OpusTags *_tags,
   len-=4;
   if(count>len)return OP_EBADHEADER;
   if(_tags!=NULL){
-    _tags->vendor=op_strdup_with_len((char *)_data,count);
-    if(_tags->vendor==NULL)return OP_EFAULT;
+    s=op_strrealloc_with_len(_tags->vendor,(char *)_data,count);
+    if(s==NULL)return OP_EFAULT;
+    _tags->vendor=s;
   }
   _data+=count;
   len-=count;
@@ -170,6 +181,9 @@ static int opus_tags_parse_impl(OpusTags *_tags,
   if(count>(opus_uint32)INT_MAX-1)return OP_EFAULT;
   if(_tags!=NULL){
     int ret;
+    /*Free any old comments we won't reuse before the arrays shrink.*/
+    for(ci=_tags->comments;ci-->(int)count;)_ogg_free(_tags->user_comments[ci]);
+    _tags->comments=OP_MIN(_tags->comments,(int)count);
     ret=op_tags_ensure_capacity(_tags,count);
     if(ret<0)return ret;
   }
@@ -184,10 +198,12 @@ static int opus_tags_parse_impl(OpusTags *_tags,
     /*Check for overflow (the API limits this to an int).*/
     if(count>(opus_uint32)INT_MAX)return OP_EFAULT;
     if(_tags!=NULL){
-      _tags->user_comments[ci]=op_strdup_with_len((char *)_data,count);
-      if(_tags->user_comments[ci]==NULL)return OP_EFAULT;
+      s=op_strrealloc_with_len(ci<_tags->comments?
+       _tags->user_comments[ci]:NULL,(char *)_data,count);
+      if(s==NULL)return OP_EFAULT;
+      _tags->user_comments[ci]=s;
       _tags->comment_lengths[ci]=(int)count;
-      _tags->comments=ci+1;
+      if(ci>=_tags->comments)_tags->comments=ci+1;
     }
     _data+=count;
     len-=count;
@@ -208,6 +224,23 @@ int opus_tags_parse(OpusTags *_tags,const unsigned char *_data,size_t _len){
   else return opus_tags_parse_impl(NULL,_data,_len);
 }
 
+int op_tags_parse_reuse(OpusTags *_tags,OpusTags *_spare,
+ const unsigned char *_data,size_t _len){
+  OpusTags tags;
+  int      ret;
+  if(_tags==NULL)return opus_tags_parse_impl(NULL,_data,_len);
+  /*Validate the header first, so the spare storage is only consumed by a
+     parse that can only fail from running out of memory.*/
+  ret=opus_tags_parse_impl(NULL,_data,_len);
+  if(ret<0)return ret;
+  *&tags=*_spare;
+  opus_tags_init(_spare);
+  ret=opus_tags_parse_impl(&tags,_data,_len);
+  if(OP_UNLIKELY(ret<0))opus_tags_clear(&tags);
+  else *_tags=*&tags;
+  return ret;
+}
+
 /*The actual implementation of opus_tags_copy().
   Unlike the public API, this function requires _dst to already be
    initialized, modifies its contents before success is guaranteed, and assumes
@@ -31,7 +31,9 @@
 # include <stdlib.h>
 # include <opusfile.h>
 
-typedef struct OggOpusLink OggOpusLink;
+typedef struct OggOpusLink  OggOpusLink;
+typedef struct OpusPipe     OpusPipe;
+typedef struct OpusLogRange OpusLogRange;
 
 # if defined(OP_FIXED_POINT)
 
@@ -108,9 +110,74 @@ void op_fatal_impl(const char *_str,const char *_file,int _line);
 #define OP_ADV_OFFSET(_offset,_amount) \
  (OP_MIN(_offset,OP_INT64_MAX-(_amount))+(_amount))
 
+/*Threading primitives, shared by the decoder pipeline and the HTTP client.*/
+# if defined(_WIN32)
+#  if !defined(WIN32_LEAN_AND_MEAN)
+#   define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+
+typedef HANDLE             op_thread;
+typedef SRWLOCK            op_mutex;
+typedef CONDITION_VARIABLE op_cond;
+
+#  define OP_THREAD_MAIN(_name) DWORD WINAPI _name(void *_ctx)
+#  define OP_THREAD_EXIT        (0)
+typedef DWORD (WINAPI *op_thread_func)(void *_ctx);
+
+#  define op_mutex_init(_mutex)    (InitializeSRWLock(_mutex))
+#  define op_mutex_clear(_mutex)   ((void)(_mutex))
+#  define op_mutex_lock(_mutex)    (AcquireSRWLockExclusive(_mutex))
+#  define op_mutex_unlock(_mutex)  (ReleaseSRWLockExclusive(_mutex))
+#  define op_cond_init(_cond)      (InitializeConditionVariable(_cond))
+#  define op_cond_clear(_cond)     ((void)(_cond))
+#  define op_cond_wait(_cond,_mutex) \
+ ((void)SleepConditionVariableSRW(_cond,_mutex,INFINITE,0))
+#  define op_cond_signal(_cond)    (WakeConditionVariable(_cond))
+
+/*The Interlocked functions are full barriers, which is what the wake-up
+   protocol of the decoder pipeline needs.*/
+#  define OP_ATOMIC_LOAD(_p) \
+ ((opus_uint32)InterlockedCompareExchange((volatile LONG *)(_p),0,0))
+#  define OP_ATOMIC_STORE(_p,_v) \
+ ((void)InterlockedExchange((volatile LONG *)(_p),(LONG)(_v)))
+/*Returns the old value.*/
+#  define OP_ATOMIC_FETCH_INC(_p) \
+ ((opus_uint32)InterlockedIncrement((volatile LONG *)(_p))-1)
+#  define OP_ATOMIC_FETCH_DEC(_p) \
+ ((opus_uint32)InterlockedDecrement((volatile LONG *)(_p))+1)
+# else
+#  include <pthread.h>
+
+typedef pthread_t       op_thread;
+typedef pthread_mutex_t op_mutex;
+typedef pthread_cond_t  op_cond;
+
+#  define OP_THREAD_MAIN(_name) void *_name(void *_ctx)
+#  define OP_THREAD_EXIT        (NULL)
+typedef void *(*op_thread_func)(void *_ctx);
+
+#  define op_mutex_init(_mutex)    ((void)pthread_mutex_init(_mutex,NULL))
+#  define op_mutex_clear(_mutex)   ((void)pthread_mutex_destroy(_mutex))
+#  define op_mutex_lock(_mutex)    ((void)pthread_mutex_lock(_mutex))
+#  define op_mutex_unlock(_mutex)  ((void)pthread_mutex_unlock(_mutex))
+#  define op_cond_init(_cond)      ((void)pthread_cond_init(_cond,NULL))
+#  define op_cond_clear(_cond)     ((void)pthread_cond_destroy(_cond))
+#  define op_cond_wait(_cond,_mutex) ((void)pthread_cond_wait(_cond,_mutex))
+#  define op_cond_signal(_cond)    ((void)pthread_cond_signal(_cond))
+
+#  define OP_ATOMIC_LOAD(_p)       (__atomic_load_n(_p,__ATOMIC_SEQ_CST))
+#  define OP_ATOMIC_STORE(_p,_v)   (__atomic_store_n(_p,_v,__ATOMIC_SEQ_CST))
+/*Returns the old value.*/
+#  define OP_ATOMIC_FETCH_INC(_p)  (__atomic_fetch_add(_p,1,__ATOMIC_SEQ_CST))
+#  define OP_ATOMIC_FETCH_DEC(_p)  (__atomic_fetch_sub(_p,1,__ATOMIC_SEQ_CST))
+# endif
+
 /*The maximum channel count for any mapping we'll actually decode.*/
 # define OP_NCHANNELS_MAX (8)
 
+/*Opening was interrupted by a non-blocking source (see op_test_open()).*/
+# define  OP_PENDING   (-1)
 /*Initial state.*/
 # define  OP_NOTOPEN   (0)
 /*We've found the first Opus stream in the first link.*/
@@ -122,6 +189,12 @@ void op_fatal_impl(const char *_str,const char *_file,int _line);
    link.*/
 # define  OP_INITSET   (4)
 
+/*The kinds of seek that can be left pending by a non-blocking source.*/
+# define  OP_SEEK_KIND_NONE   (0)
+# define  OP_SEEK_KIND_RAW    (1)
+# define  OP_SEEK_KIND_PCM    (2)
+# define  OP_SEEK_KIND_APPROX (3)
+
 /*Information cached for a single link in a chained Ogg Opus file.
   We choose the first Opus stream encountered in each link to play back (and
    require at least one).*/
@@ -149,6 +222,31 @@ struct OggOpusLink{
   OpusTags     tags;
 };
 
+/*The parsed structure of a seekable Ogg Opus file, which can be shared by
+   every OggOpusFile opened on the same data.
+  Everything except the reference count is immutable once this is created,
+   so it can be read from any number of threads without locking.*/
+struct OpusFileInfo{
+  /*The number of references held by OggOpusFile handles and the
+     application.*/
+  volatile opus_uint32  refs;
+  /*The number of links.*/
+  int                   nlinks;
+  /*The cached information from each link.*/
+  OggOpusLink          *links;
+  /*The offset of the end of the last page of the last link.*/
+  opus_int64            end;
+};
+
+/*A run of bytes read from a seekable source, kept in the read log.*/
+struct OpusLogRange{
+  /*The offset of the first byte.*/
+  opus_int64     offset;
+  unsigned char *data;
+  size_t         size;
+  size_t         csize;
+};
+
 struct OggOpusFile{
   /*The callbacks used to access the data source.*/
   OpusFileCallbacks  callbacks;
@@ -162,6 +260,9 @@ struct OggOpusFile{
     If source isn't seekable (e.g., it's a pipe), only the current link
      appears.*/
   OggOpusLink       *links;
+  /*The shared information that owns links, or NULL if this handle owns them
+     itself.*/
+  OpusFileInfo      *info;
   /*The number of serial numbers from a single link.*/
   int                nserialnos;
   /*The capacity of the list of serial numbers from a single link.*/
@@ -178,7 +279,8 @@ struct OggOpusFile{
   opus_int64         end;
   /*Used to locate pages in the data source.*/
   ogg_sync_state     oy;
-  /*One of OP_NOTOPEN, OP_PARTOPEN, OP_OPENED, OP_STREAMSET, OP_INITSET.*/
+  /*One of OP_PENDING, OP_NOTOPEN, OP_PARTOPEN, OP_OPENED, OP_STREAMSET,
+     OP_INITSET.*/
   int                ready_state;
   /*The current link being played back.*/
   int                cur_link;
@@ -203,6 +305,10 @@ struct OggOpusFile{
   int                op_count;
   /*Central working state for the packet-to-PCM decoder.*/
   OpusMSDecoder     *od;
+  /*Whether the decoder still has to be created or reset for the current link.
+    This is put off until the first packet is decoded, so that reading packets
+     with op_read_packet() never needs a decoder.*/
+  int                od_pending;
   /*The application-provided packet decode callback.*/
   op_decode_cb_func  decode_cb;
   /*The application-provided packet decode callback context.*/
@@ -215,17 +321,74 @@ struct OggOpusFile{
   int                od_channel_count;
   /*The channel mapping used to initialize the decoder.*/
   unsigned char      od_mapping[OP_NCHANNELS_MAX];
+  /*The number of bytes allocated for the decoder.*/
+  opus_int32         od_size;
   /*The buffered data for one decoded packet.*/
   op_sample         *od_buffer;
   /*The current position in the decoded buffer.*/
   int                od_buffer_pos;
   /*The number of valid samples in the decoded buffer.*/
   int                od_buffer_size;
+  /*The number of decoded samples left to fade in after an approximate seek.*/
+  opus_int32         fade_in_left;
+  /*Whether or not to crossfade from one link into the next.*/
+  int                seamless_links;
+  /*Whether the previous link was decoded through to its end, so that its
+     decoder output can be crossfaded into the next one.*/
+  int                link_xfade_pending;
+  /*The decoder output past the end of the previous link, which is faded out
+     over the start of the current link.*/
+  op_sample         *link_xfade_buffer;
+  /*The number of samples at the start of that buffer that were removed from
+     the end of the previous link by end-trimming.*/
+  int                link_xfade_nsaved;
+  /*The number of decoded samples left to crossfade at the start of a link.*/
+  int                link_xfade_left;
   /*The type of gain offset to apply.
     One of OP_HEADER_GAIN, OP_TRACK_GAIN, or OP_ABSOLUTE_GAIN.*/
   int                gain_type;
   /*The offset to apply to the gain.*/
   opus_int32         gain_offset_q8;
+  /*The background decoder state, if pipelined decoding is enabled.*/
+  OpusPipe          *pipe;
+  /*A copy of everything read from an unseekable source since we last reached
+     a point we can resume from, so that it can be fed back through the
+     ogg_sync_state if a read returns OP_EAGAIN.*/
+  unsigned char     *replay;
+  size_t             nreplay;
+  size_t             creplay;
+  /*Whether or not reads are currently being added to the replay buffer.*/
+  int                replaying;
+  /*Whether or not the source was opened with op_open_callbacks_nonblocking()
+     or op_test_callbacks_nonblocking(), so that its read() may return
+     OP_EAGAIN.*/
+  int                nonblocking;
+  /*What the application passed to those to find out what the source is
+     waiting on, or NULL.*/
+  op_poll_func       poll;
+  /*A copy of the ranges read from a seekable non-blocking source since the
+     open or seek in progress began, so that when OP_EAGAIN makes us start it
+     over, the source is never asked for the same data twice.*/
+  OpusLogRange      *log;
+  int                nlog;
+  int                clog;
+  /*Whether or not reads are currently being added to the log.*/
+  int                logging;
+  /*Whether or not the position of the source is behind op_position(), because
+     the last data we read came from the log.*/
+  int                log_lag;
+  /*For unseekable streams, the tags of a previous link, kept so their storage
+     can be reused for the next link's.*/
+  OpusTags           spare_tags;
+  /*The shared information to attach when an interrupted open is resumed.*/
+  OpusFileInfo      *open_info;
+  /*The seek that was interrupted by OP_EAGAIN, if any.
+    One of OP_SEEK_KIND_NONE, OP_SEEK_KIND_RAW, OP_SEEK_KIND_PCM, or
+     OP_SEEK_KIND_APPROX.*/
+  int                seek_kind;
+  /*The target and flags of the interrupted seek.*/
+  ogg_int64_t        seek_target;
+  int                seek_flags;
   /*Internal state for soft clipping and dithering float->short output.*/
 #if !defined(OP_FIXED_POINT)
 # if defined(OP_SOFT_CLIP)
@@ -246,4 +409,9 @@ struct OggOpusFile{
 
 int op_strncasecmp(const char *_a,const char *_b,int _n);
 
+/*Parse an Opus comment header into _tags, like opus_tags_parse(), but reusing
+   the strings and arrays held by _spare, which is left empty.*/
+int op_tags_parse_reuse(OpusTags *_tags,OpusTags *_spare,
+ const unsigned char *_data,size_t _len);
+
 #endif
@@ -138,18 +138,221 @@ int op_test(OpusHead *_head,
 
 /*The read/seek functions track absolute position within the stream.*/
 
+/*Add some data to the copy we keep of what was read from an unseekable
+   source.
+  Return: 0 on success, or OP_EFAULT if we ran out of memory.*/
+static int op_replay_append(OggOpusFile *_of,
+ const unsigned char *_data,size_t _nbytes){
+  size_t nreplay;
+  /*An empty page body or sync buffer can give us _data==NULL, which memcpy()
+     does not allow even for 0 bytes.*/
+  if(_nbytes<=0)return 0;
+  nreplay=_of->nreplay;
+  if(_nbytes>_of->creplay-nreplay){
+    unsigned char *replay;
+    size_t         creplay;
+    creplay=OP_MAX(2*_of->creplay,nreplay+_nbytes);
+    replay=(unsigned char *)_ogg_realloc(_of->replay,creplay);
+    if(OP_UNLIKELY(replay==NULL))return OP_EFAULT;
+    _of->replay=replay;
+    _of->creplay=creplay;
+  }
+  memcpy(_of->replay+nreplay,_data,_nbytes);
+  _of->nreplay=nreplay+_nbytes;
+  return 0;
+}
+
+/*Start keeping a copy of everything we read, so that we can come back to the
+   current position in an unseekable source if a read returns OP_EAGAIN.
+  _og: The page we're positioned after, which is copied as well (so that we
+        come back to the start of it), or NULL.
+       This must be the last page returned by the ogg_sync_state.
+  Return: 0 on success, or OP_EFAULT if we ran out of memory.*/
+static int op_replay_start(OggOpusFile *_of,const ogg_page *_og){
+  int ret;
+  /*A blocking source never needs to be replayed.*/
+  if(!_of->nonblocking)return 0;
+  _of->nreplay=0;
+  _of->replaying=1;
+  ret=0;
+  if(_og!=NULL){
+    ret=op_replay_append(_of,_og->header,_og->header_len);
+    if(OP_LIKELY(ret>=0))ret=op_replay_append(_of,_og->body,_og->body_len);
+  }
+  /*Anything we've read but the ogg_sync_state hasn't returned yet also has to
+     be fed back in.*/
+  if(OP_LIKELY(ret>=0)){
+    ret=op_replay_append(_of,_of->oy.data+_of->oy.returned,
+     _of->oy.fill-_of->oy.returned);
+  }
+  return ret;
+}
+
+static void op_replay_stop(OggOpusFile *_of){
+  _of->replaying=0;
+  _of->nreplay=0;
+}
+
+/*Go back to where op_replay_start() was called, by feeding everything we've
+   read since then back into a freshly reset ogg_sync_state.
+  _offset: The offset of the start of the replayed data.
+  Return: 0 on success, or OP_EFAULT if we ran out of memory.*/
+static int op_replay_rewind(OggOpusFile *_of,opus_int64 _offset){
+  char   *buffer;
+  size_t  nreplay;
+  nreplay=_of->nreplay;
+  op_replay_stop(_of);
+  ogg_sync_reset(&_of->oy);
+  if(nreplay>0){
+    buffer=ogg_sync_buffer(&_of->oy,(long)nreplay);
+    if(OP_UNLIKELY(buffer==NULL))return OP_EFAULT;
+    memcpy(buffer,_of->replay,nreplay);
+    ogg_sync_wrote(&_of->oy,(long)nreplay);
+  }
+  _of->offset=_offset;
+  return 0;
+}
+
+/*The read log does for a seekable non-blocking source what the replay buffer
+   does for an unseekable one.
+  Opening and seeking jump around the source, and when a read returns OP_EAGAIN
+   part way through, we have to start over from the beginning, so we remember
+   every range we read (by offset) until the open or seek succeeds.
+  Starting over then reads everything it has already seen from the log, and
+   only asks the source for new data, so each attempt gets further than the
+   last one.*/
+
+/*Start logging reads, if the source turns out to need it.*/
+static void op_log_start(OggOpusFile *_of){
+  _of->logging=1;
+}
+
+/*Stop logging reads and throw away the log.*/
+static void op_log_stop(OggOpusFile *_of){
+  int li;
+  for(li=0;li<_of->nlog;li++)_ogg_free(_of->log[li].data);
+  _ogg_free(_of->log);
+  _of->log=NULL;
+  _of->nlog=_of->clog=0;
+  _of->logging=0;
+}
+
+/*Add some data read from the source at the given offset to the log.
+  This must not overlap anything already in it.
+  Return: 0 on success, or OP_EFAULT if we ran out of memory.*/
+static int op_log_append(OggOpusFile *_of,opus_int64 _offset,
+ const unsigned char *_data,size_t _nbytes){
+  OpusLogRange *range;
+  int           li;
+  /*Most reads continue the last one.*/
+  for(li=_of->nlog;li-->0;){
+    if(_of->log[li].offset+(opus_int64)_of->log[li].size==_offset)break;
+  }
+  if(li<0){
+    if(_of->nlog>=_of->clog){
+      OpusLogRange *log;
+      int           clog;
+      clog=OP_MAX(2*_of->clog,8);
+      log=(OpusLogRange *)_ogg_realloc(_of->log,sizeof(*log)*clog);
+      if(OP_UNLIKELY(log==NULL))return OP_EFAULT;
+      _of->log=log;
+      _of->clog=clog;
+    }
+    li=_of->nlog++;
+    range=_of->log+li;
+    range->offset=_offset;
+    range->data=NULL;
+    range->size=range->csize=0;
+  }
+  range=_of->log+li;
+  if(_nbytes>range->csize-range->size){
+    unsigned char *data;
+    size_t         csize;
+    csize=OP_MAX(2*range->csize,range->size+_nbytes);
+    data=(unsigned char *)_ogg_realloc(range->data,csize);
+    if(OP_UNLIKELY(data==NULL))return OP_EFAULT;
+    range->data=data;
+    range->csize=csize;
+  }
+  memcpy(range->data+range->size,_data,_nbytes);
+  range->size+=_nbytes;
+  return 0;
+}
+
+/*Copy whatever the log has at the given offset.
+  [inout] _nbytes: The maximum number of bytes to copy.
+                   If the log has nothing at _offset, this is reduced so that
+                    reading that much from the source will not overlap
+                    anything it does have.
+  Return: The number of bytes copied, or 0 if there were none.*/
+static int op_log_read(const OggOpusFile *_of,opus_int64 _offset,
+ unsigned char *_buf,int *_nbytes){
+  int li;
+  for(li=0;li<_of->nlog;li++){
+    const OpusLogRange *range;
+    range=_of->log+li;
+    if(range->offset<=_offset
+     &&_offset-range->offset<(opus_int64)range->size){
+      int nbytes;
+      nbytes=(int)OP_MIN(*_nbytes,
+       range->offset+(opus_int64)range->size-_offset);
+      memcpy(_buf,range->data+(size_t)(_offset-range->offset),nbytes);
+      return nbytes;
+    }
+    if(range->offset>_offset&&range->offset-_offset<*_nbytes){
+      *_nbytes=(int)(range->offset-_offset);
+    }
+  }
+  return 0;
+}
+
+static opus_int64 op_position(const OggOpusFile *_of);
+
 /*Read a little more data from the file/pipe into the ogg_sync framer.
   _nbytes: The maximum number of bytes to read.
-  Return: A positive number of bytes read on success, 0 on end-of-file, or a
-           negative value on failure.*/
+  Return: A positive number of bytes read on success, 0 on end-of-file,
+           OP_EAGAIN if a non-blocking source has no data available yet, or
+           another negative value on failure.*/
 static int op_get_data(OggOpusFile *_of,int _nbytes){
   unsigned char *buffer;
+  opus_int64     position;
   int            nbytes;
   OP_ASSERT(_nbytes>0);
   buffer=(unsigned char *)ogg_sync_buffer(&_of->oy,_nbytes);
+  position=op_position(_of);
+  if(OP_UNLIKELY(_of->nlog>0)){
+    nbytes=op_log_read(_of,position,buffer,&_nbytes);
+    if(nbytes>0){
+      ogg_sync_wrote(&_of->oy,nbytes);
+      _of->log_lag=1;
+      return nbytes;
+    }
+  }
+  /*Catch the source up with where the log left us.*/
+  if(OP_UNLIKELY(_of->log_lag)){
+    if((*_of->callbacks.seek)(_of->source,position,SEEK_SET))return OP_EREAD;
+    _of->log_lag=0;
+  }
   nbytes=(int)(*_of->callbacks.read)(_of->source,buffer,_nbytes);
   OP_ASSERT(nbytes<=_nbytes);
-  if(OP_LIKELY(nbytes>0))ogg_sync_wrote(&_of->oy,nbytes);
+  if(OP_LIKELY(nbytes>0)){
+    ogg_sync_wrote(&_of->oy,nbytes);
+    if(OP_UNLIKELY(_of->replaying)
+     &&OP_UNLIKELY(op_replay_append(_of,buffer,nbytes)<0)){
+      return OP_EFAULT;
+    }
+    if(OP_UNLIKELY(_of->logging)&&OP_UNLIKELY(_of->nonblocking)
+     &&_of->seekable
+     &&OP_UNLIKELY(op_log_append(_of,position,buffer,nbytes)<0)){
+      return OP_EFAULT;
+    }
+  }
+  /*Only OP_EAGAIN is passed through, so that our callers know the read can be
+     retried, and only if the application said it could handle it.*/
+  else if(OP_UNLIKELY(nbytes<0)
+   &&(nbytes!=OP_EAGAIN||OP_UNLIKELY(!_of->nonblocking))){
+    nbytes=OP_EREAD;
+  }
   return nbytes;
 }
 
@@ -161,6 +364,7 @@ static int op_seek_helper(OggOpusFile *_of,opus_int64 _offset){
     return OP_EREAD;
   }
   _of->offset=_offset;
+  _of->log_lag=0;
   ogg_sync_reset(&_of->oy);
   return 0;
 }
@@ -173,6 +377,24 @@ static opus_int64 op_position(const OggOpusFile *_of){
   return _of->offset+_of->oy.fill-_of->oy.returned;
 }
 
+/*Get the number of bytes the framer still needs before it can finish the page
+   it is in the middle of assembling.
+  This only counts what we can already tell we need: until the segment table
+   has arrived, we don't know the size of the page body, so this stops short at
+   the end of the header (or of its fixed-size part).
+  This must only be called after ogg_sync_pageseek() has returned 0.*/
+static int op_page_bytes_needed(const ogg_sync_state *_oy){
+  const unsigned char *page;
+  long                 nbytes;
+  page=_oy->data+_oy->returned;
+  nbytes=_oy->fill-_oy->returned;
+  if(_oy->headerbytes>0)nbytes=_oy->headerbytes+_oy->bodybytes-nbytes;
+  else if(nbytes<27)nbytes=27-nbytes;
+  else nbytes=27+page[26]-nbytes;
+  OP_ASSERT(nbytes>0);
+  return (int)nbytes;
+}
+
 /*From the head of the stream, get the next page.
   _boundary specifies if the function is allowed to fetch more data from the
    stream (and how much) or only use internally buffered data.
@@ -183,6 +405,9 @@ static opus_int64 op_position(const OggOpusFile *_of){
   Return: n>=0:       Found a page at absolute offset n.
           OP_FALSE:   Hit the _boundary limit.
           OP_EREAD:   An underlying read operation failed.
+          OP_EFAULT:  We ran out of memory.
+          OP_EAGAIN:  A non-blocking source has no data available yet.
+                      Calling this function again resumes the search.
           OP_BADLINK: We hit end-of-file before reaching _boundary.*/
 static opus_int64 op_get_next_page(OggOpusFile *_of,ogg_page *_og,
  opus_int64 _boundary){
@@ -203,8 +428,17 @@ static opus_int64 op_get_next_page(OggOpusFile *_of,ogg_page *_og,
         if(position>=_boundary)return OP_FALSE;
         read_nbytes=(int)OP_MIN(_boundary-position,OP_READ_SIZE);
       }
+      /*An unseekable source is usually a live stream, where data past the end
+         of this page may not exist yet, and a read callback that tries to fill
+         its whole buffer (e.g., fread() on a pipe) would wait for it.
+        So never ask for more than we know we need.
+        This matters most while opening, when the header pages are small and
+         nothing can be decoded until the first audio page is complete.*/
+      if(!_of->seekable){
+        read_nbytes=OP_MIN(read_nbytes,op_page_bytes_needed(&_of->oy));
+      }
       ret=op_get_data(_of,read_nbytes);
-      if(OP_UNLIKELY(ret<0))return OP_EREAD;
+      if(OP_UNLIKELY(ret<0))return ret;
       if(OP_UNLIKELY(ret==0)){
         /*Only fail cleanly on EOF if we didn't have a known boundary.
           Otherwise, we should have been able to reach that boundary, and this
@@ -475,6 +709,7 @@ static int op_fetch_headers_impl(OggOpusFile *_of,OpusHead *_head,
  OpusTags *_tags,ogg_uint32_t **_serialnos,int *_nserialnos,
  int *_cserialnos,ogg_page *_og){
   ogg_packet op;
+  opus_int64 llret;
   int        ret;
   if(_serialnos!=NULL)*_nserialnos=0;
   /*Extract the serialnos of all BOS pages plus the first set of Opus headers
@@ -506,9 +741,10 @@ static int op_fetch_headers_impl(OggOpusFile *_of,OpusHead *_head,
     }
     /*Get the next page.
       No need to clamp the boundary offset against _of->end, as all errors
-       become OP_ENOTFORMAT or OP_EBADHEADER.*/
-    if(OP_UNLIKELY(op_get_next_page(_of,_og,
-     OP_ADV_OFFSET(_of->offset,OP_CHUNK_SIZE))<0)){
+       (except OP_EAGAIN) become OP_ENOTFORMAT or OP_EBADHEADER.*/
+    llret=op_get_next_page(_of,_og,OP_ADV_OFFSET(_of->offset,OP_CHUNK_SIZE));
+    if(OP_UNLIKELY(llret<0)){
+      if(llret==OP_EAGAIN)return OP_EAGAIN;
       return _of->ready_state<OP_STREAMSET?OP_ENOTFORMAT:OP_EBADHEADER;
     }
   }
@@ -522,10 +758,11 @@ static int op_fetch_headers_impl(OggOpusFile *_of,OpusHead *_head,
         /*Loop getting pages.*/
         for(;;){
           /*No need to clamp the boundary offset against _of->end, as all
-             errors become OP_EBADHEADER.*/
-          if(OP_UNLIKELY(op_get_next_page(_of,_og,
-           OP_ADV_OFFSET(_of->offset,OP_CHUNK_SIZE))<0)){
-            return OP_EBADHEADER;
+             errors (except OP_EAGAIN) become OP_EBADHEADER.*/
+          llret=op_get_next_page(_of,_og,
+           OP_ADV_OFFSET(_of->offset,OP_CHUNK_SIZE));
+          if(OP_UNLIKELY(llret<0)){
+            return llret==OP_EAGAIN?OP_EAGAIN:OP_EBADHEADER;
           }
           /*If this page belongs to the correct stream, go parse it.*/
           if(_of->os.serialno==ogg_page_serialno(_og)){
@@ -542,7 +779,7 @@ static int op_fetch_headers_impl(OggOpusFile *_of,OpusHead *_head,
       default:{
         /*Got a packet.
           It should be the comment header.*/
-        ret=opus_tags_parse(_tags,op.packet,op.bytes);
+        ret=op_tags_parse_reuse(_tags,&_of->spare_tags,op.packet,op.bytes);
         if(OP_UNLIKELY(ret<0))return ret;
         /*Make sure the page terminated at the end of the comment header.
           If there is another packet on the page, or part of a packet, then
@@ -568,12 +805,11 @@ static int op_fetch_headers(OggOpusFile *_of,OpusHead *_head,
   ogg_page og;
   int      ret;
   if(!_og){
+    opus_int64 llret;
     /*No need to clamp the boundary offset against _of->end, as all errors
-       become OP_ENOTFORMAT.*/
-    if(OP_UNLIKELY(op_get_next_page(_of,&og,
-     OP_ADV_OFFSET(_of->offset,OP_CHUNK_SIZE))<0)){
-      return OP_ENOTFORMAT;
-    }
+       (except OP_EAGAIN) become OP_ENOTFORMAT.*/
+    llret=op_get_next_page(_of,&og,OP_ADV_OFFSET(_of->offset,OP_CHUNK_SIZE));
+    if(OP_UNLIKELY(llret<0))return llret==OP_EAGAIN?OP_EAGAIN:OP_ENOTFORMAT;
     _og=&og;
   }
   _of->ready_state=OP_OPENED;
@@ -1266,7 +1502,11 @@ static int op_bisect_forward_serialno(OggOpusFile *_of,
     /*This might consume a page from the next link, however the next bisection
        always starts with a seek.*/
     ret=op_find_initial_pcm_offset(_of,links+nlinks,NULL);
-    if(OP_UNLIKELY(ret<0))return ret;
+    if(OP_UNLIKELY(ret<0)){
+      /*This link isn't counted yet, so op_clear() won't free its tags.*/
+      opus_tags_clear(&links[nlinks].tags);
+      return ret;
+    }
     _searched=_of->offset;
     /*Mark the current link count so it can be cleaned up on error.*/
     _of->nlinks=++nlinks;
@@ -1296,7 +1536,7 @@ static void op_update_gain(OggOpusFile *_of){
   int         li;
   /*If decode isn't ready, then we'll apply the gain when we initialize the
      decoder.*/
-  if(_of->ready_state<OP_INITSET)return;
+  if(_of->ready_state<OP_INITSET||_of->od_pending)return;
   gain_q8=_of->gain_offset_q8;
   li=_of->seekable?_of->cur_link:0;
   head=&_of->links[li].head;
@@ -1327,19 +1567,119 @@ static void op_update_gain(OggOpusFile *_of){
 #endif
 }
 
-static int op_make_decode_ready(OggOpusFile *_of){
+#if !defined(OP_FIXED_POINT)
+
+static void op_pipe_decoder_reset(OggOpusFile *_of);
+
+/*Reset the state used to convert decoded samples for output.*/
+static void op_reset_output_state(OggOpusFile *_of,int _li){
+  _of->state_channel_count=0;
+  /*Use the serial number for the PRNG seed to get repeatable output for
+     straight play-throughs.*/
+  _of->dither_seed=_of->links[_li].serialno;
+}
+
+#endif
+
+/*Return the largest channel count we might have to decode.*/
+static int op_get_nchannels_max(const OggOpusFile *_of){
+  const OggOpusLink *links;
+  int                nchannels_max;
+  int                nlinks;
+  int                li;
+  if(!_of->seekable)return OP_NCHANNELS_MAX;
+  links=_of->links;
+  nlinks=_of->nlinks;
+  nchannels_max=1;
+  for(li=0;li<nlinks;li++){
+    nchannels_max=OP_MAX(nchannels_max,links[li].head.channel_count);
+  }
+  return nchannels_max;
+}
+
+/*The number of samples to crossfade between links when seamless links are
+   enabled (10 ms).*/
+#define OP_LINK_XFADE_SIZE (10*48)
+
+/*Return the buffer for the end of the previous link, allocating it if
+   necessary.
+  There is room past OP_LINK_XFADE_SIZE samples for packet loss concealment
+   to be generated in multiples of 2.5 ms.
+  Running out of memory here just means the links get joined without a
+   crossfade, so the caller doesn't report it.*/
+static op_sample *op_link_xfade_get_buffer(OggOpusFile *_of){
+  op_sample *buf;
+  buf=_of->link_xfade_buffer;
+  if(buf==NULL){
+    buf=(op_sample *)_ogg_malloc(sizeof(*buf)
+     *op_get_nchannels_max(_of)*(OP_LINK_XFADE_SIZE+120));
+    _of->link_xfade_buffer=buf;
+  }
+  return buf;
+}
+
+/*Save the samples end-trimming removed from the last packet of a link.
+  They're the decoder's own continuation of the link's audio, and so the best
+   thing to fade out over the start of the next link.*/
+static void op_link_xfade_save(OggOpusFile *_of,const op_sample *_pcm,
+ int _nsamples,int _nchannels){
+  op_sample *buf;
+  buf=op_link_xfade_get_buffer(_of);
+  if(OP_UNLIKELY(buf==NULL))return;
+  _nsamples=OP_MIN(_nsamples,OP_LINK_XFADE_SIZE);
+  memcpy(buf,_pcm,sizeof(*buf)*_nchannels*_nsamples);
+  _of->link_xfade_nsaved=_nsamples;
+}
+
+/*Finish saving the audio to fade out at the start of the next link by asking
+   the previous link's decoder to extrapolate past its last packet, so that the
+   link boundary doesn't cut it off abruptly.
+  This must be called before the decoder is reset.*/
+static void op_link_xfade_start(OggOpusFile *_of,int _nchannels){
+  op_sample *buf;
+  int        nsaved;
+  int        nplc;
+  nsaved=_of->link_xfade_nsaved;
+  _of->link_xfade_nsaved=0;
+  buf=op_link_xfade_get_buffer(_of);
+  if(OP_UNLIKELY(buf==NULL))return;
+  /*A NULL packet asks for packet loss concealment, which must be a multiple
+     of 2.5 ms.*/
+  nplc=(OP_LINK_XFADE_SIZE-nsaved+119)/120*120;
+  if(nplc>0){
+    int ret;
+#if defined(OP_FIXED_POINT)
+    ret=opus_multistream_decode(_of->od,NULL,0,
+     buf+nsaved*_nchannels,nplc,0);
+#else
+    ret=opus_multistream_decode_float(_of->od,NULL,0,
+     buf+nsaved*_nchannels,nplc,0);
+#endif
+    if(OP_UNLIKELY(ret!=nplc))return;
+  }
+  _of->link_xfade_left=OP_LINK_XFADE_SIZE;
+}
+
+/*Create or reset the decoder for the current link.
+  This is done lazily, just before the first packet is decoded.*/
+static int op_init_decoder(OggOpusFile *_of){
   const OpusHead *head;
   int             li;
   int             stream_count;
   int             coupled_count;
   int             channel_count;
-  if(_of->ready_state>OP_STREAMSET)return 0;
-  if(OP_UNLIKELY(_of->ready_state<OP_STREAMSET))return OP_EFAULT;
+  OP_ASSERT(_of->ready_state>=OP_INITSET);
   li=_of->seekable?_of->cur_link:0;
   head=&_of->links[li].head;
   stream_count=head->stream_count;
   coupled_count=head->coupled_count;
   channel_count=head->channel_count;
+  if(_of->link_xfade_pending){
+    _of->link_xfade_pending=0;
+    if(_of->od!=NULL&&_of->od_channel_count==channel_count){
+      op_link_xfade_start(_of,channel_count);
+    }
+  }
   /*Check to see if the current decoder is compatible with the current link.*/
   if(_of->od!=NULL&&_of->od_stream_count==stream_count
    &&_of->od_coupled_count==coupled_count&&_of->od_channel_count==channel_count
@@ -1348,26 +1688,50 @@ static int op_make_decode_ready(OggOpusFile *_of){
     opus_multistream_decoder_ctl(_of->od,OPUS_RESET_STATE);
   }
   else{
-    int err;
-    opus_multistream_decoder_destroy(_of->od);
-    _of->od=opus_multistream_decoder_create(48000,channel_count,
-     stream_count,coupled_count,head->mapping,&err);
-    if(_of->od==NULL)return OP_EFAULT;
+    opus_int32 size;
+    int        err;
+    size=opus_multistream_decoder_get_size(stream_count,coupled_count);
+    /*If the new layout fits in the memory we already have (e.g., a stereo link
+       followed by a mono one), re-initialize the decoder in place.*/
+    if(_of->od!=NULL&&size<=_of->od_size){
+      err=opus_multistream_decoder_init(_of->od,48000,channel_count,
+       stream_count,coupled_count,head->mapping);
+      if(OP_UNLIKELY(err!=OPUS_OK)){
+        opus_multistream_decoder_destroy(_of->od);
+        _of->od=NULL;
+        return OP_EFAULT;
+      }
+    }
+    else{
+      opus_multistream_decoder_destroy(_of->od);
+      _of->od=opus_multistream_decoder_create(48000,channel_count,
+       stream_count,coupled_count,head->mapping,&err);
+      if(_of->od==NULL)return OP_EFAULT;
+      _of->od_size=size;
+    }
     _of->od_stream_count=stream_count;
     _of->od_coupled_count=coupled_count;
     _of->od_channel_count=channel_count;
     memcpy(_of->od_mapping,head->mapping,sizeof(*head->mapping)*channel_count);
   }
+  _of->od_pending=0;
+  op_update_gain(_of);
+  return 0;
+}
+
+static int op_make_decode_ready(OggOpusFile *_of){
+  if(_of->ready_state>OP_STREAMSET)return 0;
+  if(OP_UNLIKELY(_of->ready_state<OP_STREAMSET))return OP_EFAULT;
   _of->ready_state=OP_INITSET;
+  _of->od_pending=1;
   _of->bytes_tracked=0;
   _of->samples_tracked=0;
 #if !defined(OP_FIXED_POINT)
-  _of->state_channel_count=0;
-  /*Use the serial number for the PRNG seed to get repeatable output for
-     straight play-throughs.*/
-  _of->dither_seed=_of->links[li].serialno;
+  /*With pipelined decoding, this state belongs to the reader, which resets it
+     when it gets to the first samples from the new decoder.*/
+  if(_of->pipe!=NULL)op_pipe_decoder_reset(_of);
+  else op_reset_output_state(_of,_of->seekable?_of->cur_link:0);
 #endif
-  op_update_gain(_of);
   return 0;
 }
 
@@ -1382,6 +1746,7 @@ static int op_open_seekable2_impl(OggOpusFile *_of){
   (*_of->callbacks.seek)(_of->source,0,SEEK_END);
   _of->offset=_of->end=(*_of->callbacks.tell)(_of->source);
   if(OP_UNLIKELY(_of->end<0))return OP_EREAD;
+  _of->log_lag=0;
   data_offset=_of->links[0].data_offset;
   if(OP_UNLIKELY(_of->end<data_offset))return OP_EBADLINK;
   /*Get the offset of the last page of the physical bitstream, or, if we're
@@ -1423,7 +1788,8 @@ static int op_open_seekable2(OggOpusFile *_of){
   *&os_start=_of->os;
   start_offset=_of->offset;
   memcpy(op_start,_of->op,sizeof(*op_start)*start_op_count);
-  OP_ASSERT((*_of->callbacks.tell)(_of->source)==op_position(_of));
+  OP_ASSERT(_of->log_lag
+   ||(*_of->callbacks.tell)(_of->source)==op_position(_of));
   ogg_sync_init(&_of->oy);
   ogg_stream_init(&_of->os,-1);
   ret=op_open_seekable2_impl(_of);
@@ -1441,7 +1807,16 @@ static int op_open_seekable2(OggOpusFile *_of){
   if(OP_UNLIKELY(ret<0))return ret;
   /*And restore the position indicator.*/
   ret=(*_of->callbacks.seek)(_of->source,op_position(_of),SEEK_SET);
-  return OP_UNLIKELY(ret<0)?OP_EREAD:0;
+  if(OP_UNLIKELY(ret<0))return OP_EREAD;
+  _of->log_lag=0;
+  return 0;
+}
+
+/*Set aside the tags of the current link of an unseekable stream, so that
+   the next link's tags can be parsed into the same storage.*/
+static void op_recycle_tags(OggOpusFile *_of){
+  opus_tags_clear(&_of->spare_tags);
+  *&_of->spare_tags=*&_of->links[0].tags;
 }
 
 /*Clear out the current logical bitstream decoder.*/
@@ -1450,10 +1825,14 @@ static void op_decode_clear(OggOpusFile *_of){
     We might be able to re-use it for the next link.*/
   _of->op_count=0;
   _of->od_buffer_size=0;
+  _of->fade_in_left=0;
+  _of->link_xfade_pending=0;
+  _of->link_xfade_nsaved=0;
+  _of->link_xfade_left=0;
   _of->prev_packet_gp=-1;
   if(!_of->seekable){
     OP_ASSERT(_of->ready_state>=OP_INITSET);
-    opus_tags_clear(&_of->links[0].tags);
+    op_recycle_tags(_of);
   }
   _of->ready_state=OP_OPENED;
 }
@@ -1461,9 +1840,15 @@ static void op_decode_clear(OggOpusFile *_of){
 static void op_clear(OggOpusFile *_of){
   OggOpusLink *links;
   _ogg_free(_of->od_buffer);
+  _ogg_free(_of->link_xfade_buffer);
   if(_of->od!=NULL)opus_multistream_decoder_destroy(_of->od);
   links=_of->links;
-  if(!_of->seekable){
+  if(_of->info!=NULL){
+    /*The links belong to the shared information.*/
+    op_file_info_release(_of->info);
+    links=NULL;
+  }
+  else if(!_of->seekable){
     if(_of->ready_state>OP_OPENED||_of->ready_state==OP_PARTOPEN){
       opus_tags_clear(&links[0].tags);
     }
@@ -1476,11 +1861,18 @@ static void op_clear(OggOpusFile *_of){
   }
   _ogg_free(links);
   _ogg_free(_of->serialnos);
+  _ogg_free(_of->replay);
+  op_log_stop(_of);
+  opus_tags_clear(&_of->spare_tags);
+  op_file_info_release(_of->open_info);
   ogg_stream_clear(&_of->os);
   ogg_sync_clear(&_of->oy);
   if(_of->callbacks.close!=NULL)(*_of->callbacks.close)(_of->source);
 }
 
+/*Start opening a stream.
+  _of must be cleared to zero beforehand, except for the read log (and whether
+   or not the source is non-blocking) kept from an earlier attempt.*/
 static int op_open1(OggOpusFile *_of,
  void *_source,const OpusFileCallbacks *_cb,
  const unsigned char *_initial_data,size_t _initial_bytes){
@@ -1488,7 +1880,6 @@ static int op_open1(OggOpusFile *_of,
   ogg_page *pog;
   int       seekable;
   int       ret;
-  memset(_of,0,sizeof(*_of));
   _of->end=-1;
   _of->source=_source;
   *&_of->callbacks=*_cb;
@@ -1522,6 +1913,15 @@ static int op_open1(OggOpusFile *_of,
     if(OP_UNLIKELY(pos!=(opus_int64)_initial_bytes))return OP_EINVAL;
   }
   _of->seekable=seekable;
+  /*If a non-blocking source runs dry before we're done, we'll have to start
+     over, and we can't go back to the start of an unseekable one.
+    We can go back to the start of a seekable one, but it might not have the
+     data any more.*/
+  if(!seekable){
+    ret=op_replay_start(_of,NULL);
+    if(OP_UNLIKELY(ret<0))return ret;
+  }
+  else op_log_start(_of);
   /*Don't seek yet.
     Set up a 'single' (current) logical bitstream entry for partial open.*/
   _of->links=(OggOpusLink *)_ogg_malloc(sizeof(*_of->links));
@@ -1545,21 +1945,117 @@ static int op_open1(OggOpusFile *_of,
     /*This link was empty, but we already have the BOS page for the next one in
        og.
       We can't seek, so start processing the next link right now.*/
-    opus_tags_clear(&_of->links[0].tags);
+    op_recycle_tags(_of);
     _of->nlinks=0;
     if(!seekable)_of->cur_link++;
     pog=&og;
   }
+  /*Keep what we've read if we might need to replay it.*/
+  if(ret!=OP_EAGAIN)op_replay_stop(_of);
   if(OP_LIKELY(ret>=0))_of->ready_state=OP_PARTOPEN;
   return ret;
 }
 
-static int op_open2(OggOpusFile *_of){
+static OpusFileInfo *op_file_info_ref(OpusFileInfo *_info);
+
+/*Throw away a partially opened stream after a read returned OP_EAGAIN,
+   keeping only what we need to start over (see op_open_resume()).
+  _info: The shared information to use when we do, or NULL.*/
+static void op_open_suspend(OggOpusFile *_of,OpusFileInfo *_info){
+  OpusFileCallbacks  cb;
+  void              *source;
+  unsigned char     *replay;
+  size_t             nreplay;
+  size_t             creplay;
+  OpusLogRange      *log;
+  int                nlog;
+  int                clog;
+  op_poll_func       poll;
+  int                seekable;
+  int                nonblocking;
+  _info=op_file_info_ref(_info);
+  *&cb=*&_of->callbacks;
+  source=_of->source;
+  poll=_of->poll;
+  seekable=_of->seekable;
+  nonblocking=_of->nonblocking;
+  replay=_of->replay;
+  nreplay=_of->nreplay;
+  creplay=_of->creplay;
+  _of->replay=NULL;
+  log=_of->log;
+  nlog=_of->nlog;
+  clog=_of->clog;
+  _of->log=NULL;
+  _of->nlog=0;
+  /*Don't auto-close the stream.*/
+  _of->callbacks.close=NULL;
+  op_clear(_of);
+  memset(_of,0,sizeof(*_of));
+  *&_of->callbacks=*&cb;
+  _of->source=source;
+  _of->poll=poll;
+  _of->seekable=seekable;
+  _of->nonblocking=nonblocking;
+  _of->replay=replay;
+  _of->nreplay=nreplay;
+  _of->creplay=creplay;
+  _of->log=log;
+  _of->nlog=nlog;
+  _of->clog=clog;
+  _of->open_info=_info;
+  _of->ready_state=OP_PENDING;
+}
+
+/*Start opening a stream suspended by op_open_suspend() over again.
+  A seekable source just goes back to the start (and we read what we already
+   saw from the log), while everything we read from an unseekable one is fed
+   back in as if it were initial data.
+  Return: The result of op_open1().*/
+static int op_open_resume(OggOpusFile *_of){
+  OpusFileCallbacks  cb;
+  void              *source;
+  unsigned char     *replay;
+  size_t             nreplay;
+  OpusLogRange      *log;
+  int                nlog;
+  int                clog;
+  op_poll_func       poll;
+  int                ret;
+  OP_ASSERT(_of->ready_state==OP_PENDING);
+  OP_ASSERT(_of->nonblocking);
+  *&cb=*&_of->callbacks;
+  source=_of->source;
+  poll=_of->poll;
+  replay=_of->replay;
+  nreplay=_of->nreplay;
+  log=_of->log;
+  nlog=_of->nlog;
+  clog=_of->clog;
+  if(_of->seekable&&OP_UNLIKELY((*cb.seek)(source,0,SEEK_SET)<0)){
+    /*Leave everything for op_clear() to free.*/
+    return OP_EREAD;
+  }
+  memset(_of,0,sizeof(*_of));
+  _of->poll=poll;
+  _of->nonblocking=1;
+  _of->log=log;
+  _of->nlog=nlog;
+  _of->clog=clog;
+  ret=op_open1(_of,source,&cb,replay,nreplay);
+  _ogg_free(replay);
+  return ret;
+}
+
+static int op_attach_info(OggOpusFile *_of,OpusFileInfo *_info);
+
+static int op_open2(OggOpusFile *_of,OpusFileInfo *_info){
   int ret;
   OP_ASSERT(_of->ready_state==OP_PARTOPEN);
   if(_of->seekable){
     _of->ready_state=OP_OPENED;
-    ret=op_open_seekable2(_of);
+    ret=_info!=NULL?op_attach_info(_of,_info):0;
+    if(ret==0)ret=op_open_seekable2(_of);
   }
   else ret=0;
   if(OP_LIKELY(ret>=0)){
@@ -1567,26 +2063,44 @@ static int op_open2(OggOpusFile *_of){
       Move to OP_INITSET so we can use them.*/
     _of->ready_state=OP_STREAMSET;
     ret=op_make_decode_ready(_of);
-    if(OP_LIKELY(ret>=0))return 0;
+    if(OP_LIKELY(ret>=0)){
+      op_log_stop(_of);
+      return 0;
+    }
+  }
+  if(ret==OP_EAGAIN)op_open_suspend(_of,_info);
+  else{
+    /*Don't auto-close the stream on failure.*/
+    _of->callbacks.close=NULL;
+    op_clear(_of);
   }
-  /*Don't auto-close the stream on failure.*/
-  _of->callbacks.close=NULL;
-  op_clear(_of);
   return ret;
 }
 
-OggOpusFile *op_test_callbacks(void *_source,const OpusFileCallbacks *_cb,
+/*The common part of op_test_callbacks() and op_test_callbacks_nonblocking().
+  _nonblocking: Whether or not the application can handle OP_EAGAIN.*/
+static OggOpusFile *op_test_callbacks_impl(void *_source,
+ const OpusFileCallbacks *_cb,int _nonblocking,op_poll_func _poll,
  const unsigned char *_initial_data,size_t _initial_bytes,int *_error){
   OggOpusFile *of;
   int          ret;
   of=(OggOpusFile *)_ogg_malloc(sizeof(*of));
   ret=OP_EFAULT;
   if(OP_LIKELY(of!=NULL)){
+    memset(of,0,sizeof(*of));
+    of->nonblocking=_nonblocking;
+    of->poll=_poll;
     ret=op_open1(of,_source,_cb,_initial_data,_initial_bytes);
     if(OP_LIKELY(ret>=0)){
       if(_error!=NULL)*_error=0;
       return of;
     }
+    /*Hand back a handle that op_test_open() can resume.*/
+    if(ret==OP_EAGAIN){
+      op_open_suspend(of,NULL);
+      if(_error!=NULL)*_error=ret;
+      return of;
+    }
     /*Don't auto-close the stream on failure.*/
     of->callbacks.close=NULL;
     op_clear(of);
@@ -1596,44 +2110,98 @@ OggOpusFile *op_test_callbacks(void *_source,const OpusFileCallbacks *_cb,
   return NULL;
 }
 
-OggOpusFile *op_open_callbacks(void *_source,const OpusFileCallbacks *_cb,
+OggOpusFile *op_test_callbacks(void *_source,const OpusFileCallbacks *_cb,
+ const unsigned char *_initial_data,size_t _initial_bytes,int *_error){
+  return op_test_callbacks_impl(_source,_cb,0,NULL,
+   _initial_data,_initial_bytes,_error);
+}
+
+OggOpusFile *op_test_callbacks_nonblocking(void *_source,
+ const OpusFileCallbacks *_cb,op_poll_func _poll,
  const unsigned char *_initial_data,size_t _initial_bytes,int *_error){
+  return op_test_callbacks_impl(_source,_cb,1,_poll,
+   _initial_data,_initial_bytes,_error);
+}
+
+/*The common part of the op_open_callbacks() family.*/
+static OggOpusFile *op_open_callbacks_impl(void *_source,
+ const OpusFileCallbacks *_cb,int _nonblocking,op_poll_func _poll,
+ const unsigned char *_initial_data,size_t _initial_bytes,
+ OpusFileInfo *_info,int *_error){
   OggOpusFile *of;
-  of=op_test_callbacks(_source,_cb,_initial_data,_initial_bytes,_error);
+  of=op_test_callbacks_impl(_source,_cb,_nonblocking,_poll,
+   _initial_data,_initial_bytes,_error);
   if(OP_LIKELY(of!=NULL)){
     int ret;
-    ret=op_open2(of);
+    if(OP_UNLIKELY(of->ready_state==OP_PENDING)){
+      /*op_test_callbacks() was interrupted, and already set *_error.
+        Remember the info for when op_test_open() resumes.*/
+      of->open_info=op_file_info_ref(_info);
+      return of;
+    }
+    ret=op_open2(of,_info);
     if(OP_LIKELY(ret>=0))return of;
     if(_error!=NULL)*_error=ret;
+    if(ret==OP_EAGAIN)return of;
     _ogg_free(of);
   }
   return NULL;
 }
 
+OggOpusFile *op_open_callbacks(void *_source,const OpusFileCallbacks *_cb,
+ const unsigned char *_initial_data,size_t _initial_bytes,int *_error){
+  return op_open_callbacks_impl(_source,_cb,0,NULL,
+   _initial_data,_initial_bytes,NULL,_error);
+}
+
+OggOpusFile *op_open_callbacks_nonblocking(void *_source,
+ const OpusFileCallbacks *_cb,op_poll_func _poll,
+ const unsigned char *_initial_data,size_t _initial_bytes,int *_error){
+  return op_open_callbacks_impl(_source,_cb,1,_poll,
+   _initial_data,_initial_bytes,NULL,_error);
+}
+
+OggOpusFile *op_open_callbacks_with_info(void *_source,
+ const OpusFileCallbacks *_cb,const unsigned char *_initial_data,
+ size_t _initial_bytes,OpusFileInfo *_info,int *_error){
+  return op_open_callbacks_impl(_source,_cb,0,NULL,
+   _initial_data,_initial_bytes,_info,_error);
+}
+
 /*Convenience routine to clean up from failure for the open functions that
    create their own streams.*/
 static OggOpusFile *op_open_close_on_failure(void *_source,
- const OpusFileCallbacks *_cb,int *_error){
+ const OpusFileCallbacks *_cb,OpusFileInfo *_info,int *_error){
   OggOpusFile *of;
   if(OP_UNLIKELY(_source==NULL)){
     if(_error!=NULL)*_error=OP_EFAULT;
     return NULL;
   }
-  of=op_open_callbacks(_source,_cb,NULL,0,_error);
+  of=op_open_callbacks_with_info(_source,_cb,NULL,0,_info,_error);
   if(OP_UNLIKELY(of==NULL))(*_cb->close)(_source);
   return of;
 }
 
 OggOpusFile *op_open_file(const char *_path,int *_error){
+  return op_open_file_with_info(_path,NULL,_error);
+}
+
+OggOpusFile *op_open_file_with_info(const char *_path,
+ OpusFileInfo *_info,int *_error){
   OpusFileCallbacks cb;
-  return op_open_close_on_failure(op_fopen(&cb,_path,"rb"),&cb,_error);
+  return op_open_close_on_failure(op_fopen(&cb,_path,"rb"),&cb,_info,_error);
 }
 
 OggOpusFile *op_open_memory(const unsigned char *_data,size_t _size,
  int *_error){
+  return op_open_memory_with_info(_data,_size,NULL,_error);
+}
+
+OggOpusFile *op_open_memory_with_info(const unsigned char *_data,size_t _size,
+ OpusFileInfo *_info,int *_error){
   OpusFileCallbacks cb;
   return op_open_close_on_failure(op_mem_stream_create(&cb,_data,_size),&cb,
-   _error);
+   _info,_error);
 }
 
 /*Convenience routine to clean up from failure for the open functions that
@@ -1664,109 +2232,656 @@ OggOpusFile *op_test_memory(const unsigned char *_data,size_t _size,
 
 int op_test_open(OggOpusFile *_of){
   int ret;
-  if(OP_UNLIKELY(_of->ready_state!=OP_PARTOPEN))return OP_EINVAL;
-  ret=op_open2(_of);
+  if(OP_UNLIKELY(_of->ready_state==OP_PENDING)){
+    OpusFileInfo *info;
+    /*Take over the reference to the info while we start over.*/
+    info=_of->open_info;
+    _of->open_info=NULL;
+    ret=op_open_resume(_of);
+    if(OP_LIKELY(ret>=0))ret=op_open2(_of,info);
+    else if(ret==OP_EAGAIN)op_open_suspend(_of,info);
+    else{
+      /*Don't auto-close the stream on failure.*/
+      _of->callbacks.close=NULL;
+      op_clear(_of);
+    }
+    op_file_info_release(info);
+  }
+  else{
+    if(OP_UNLIKELY(_of->ready_state!=OP_PARTOPEN))return OP_EINVAL;
+    ret=op_open2(_of,NULL);
+  }
   /*op_open2() will clear this structure on failure.
-    Reset its contents to prevent double-frees in op_free().*/
-  if(OP_UNLIKELY(ret<0))memset(_of,0,sizeof(*_of));
+    Reset its contents to prevent double-frees in op_free().
+    It only keeps what's needed to try again after OP_EAGAIN.*/
+  if(OP_UNLIKELY(ret<0)&&ret!=OP_EAGAIN)memset(_of,0,sizeof(*_of));
   return ret;
 }
 
-void op_free(OggOpusFile *_of){
-  if(OP_LIKELY(_of!=NULL)){
-    op_clear(_of);
-    _ogg_free(_of);
-  }
-}
+/*Threading support for pipelined and parallel decoding.
+  The primitives themselves are in internal.h.*/
 
-int op_seekable(const OggOpusFile *_of){
-  return _of->seekable;
+#if defined(_WIN32)
+static int op_thread_create(op_thread *_thread,
+ op_thread_func _func,void *_ctx){
+  *_thread=CreateThread(NULL,0,_func,_ctx,0,NULL);
+  return *_thread!=NULL?0:OP_EFAULT;
 }
 
-int op_link_count(const OggOpusFile *_of){
-  return _of->nlinks;
+static void op_thread_join(op_thread _thread){
+  WaitForSingleObjectEx(_thread,INFINITE,FALSE);
+  CloseHandle(_thread);
 }
-
-ogg_uint32_t op_serialno(const OggOpusFile *_of,int _li){
-  if(OP_UNLIKELY(_li>=_of->nlinks))_li=_of->nlinks-1;
-  if(!_of->seekable)_li=0;
-  return _of->links[_li<0?_of->cur_link:_li].serialno;
+#else
+static int op_thread_create(op_thread *_thread,
+ op_thread_func _func,void *_ctx){
+  return pthread_create(_thread,NULL,_func,_ctx)?OP_EFAULT:0;
 }
 
-int op_channel_count(const OggOpusFile *_of,int _li){
-  return op_head(_of,_li)->channel_count;
+static void op_thread_join(op_thread _thread){
+  pthread_join(_thread,NULL);
 }
+#endif
 
-opus_int64 op_raw_total(const OggOpusFile *_of,int _li){
-  if(OP_UNLIKELY(_of->ready_state<OP_OPENED)
-   ||OP_UNLIKELY(!_of->seekable)
-   ||OP_UNLIKELY(_li>=_of->nlinks)){
-    return OP_EINVAL;
+/*Shared file information.
+  Opening a seekable file scans it for every link, which is most of the cost
+   of opening it.
+  Once one handle has done that, op_file_info() hands the result out as a
+   reference-counted, immutable object, and handles opened with it attached
+   point their links at it instead of scanning and allocating their own.*/
+
+OpusFileInfo *op_file_info(OggOpusFile *_of){
+  OpusFileInfo *info;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED)||OP_UNLIKELY(!_of->seekable)){
+    return NULL;
   }
-  if(_li<0)return _of->end-_of->links[0].offset;
-  return (_li+1>=_of->nlinks?_of->end:_of->links[_li+1].offset)
-   -_of->links[_li].offset;
+  info=_of->info;
+  if(info==NULL){
+    /*Hand our own links over to the shared copy.
+      They are never modified after a seekable file is opened.*/
+    info=(OpusFileInfo *)_ogg_malloc(sizeof(*info));
+    if(OP_UNLIKELY(info==NULL))return NULL;
+    info->refs=1;
+    info->nlinks=_of->nlinks;
+    info->links=_of->links;
+    info->end=_of->end;
+    _of->info=info;
+  }
+  OP_ATOMIC_FETCH_INC(&info->refs);
+  return info;
 }
 
-ogg_int64_t op_pcm_total(const OggOpusFile *_of,int _li){
-  OggOpusLink *links;
-  ogg_int64_t  diff;
-  int          nlinks;
-  nlinks=_of->nlinks;
-  if(OP_UNLIKELY(_of->ready_state<OP_OPENED)
-   ||OP_UNLIKELY(!_of->seekable)
-   ||OP_UNLIKELY(_li>=nlinks)){
-    return OP_EINVAL;
-  }
-  links=_of->links;
-  /*We verify that the granule position differences are larger than the
-     pre-skip and that the total duration does not overflow during link
-     enumeration, so we don't have to check here.*/
-  if(_li<0){
-    ogg_int64_t pcm_total;
-    int         li;
-    pcm_total=0;
-    for(li=0;li<nlinks;li++){
-      OP_ALWAYS_TRUE(!op_granpos_diff(&diff,
-       links[li].pcm_end,links[li].pcm_start));
-      pcm_total+=diff-links[li].head.pre_skip;
-    }
-    return pcm_total;
+void op_file_info_release(OpusFileInfo *_info){
+  if(_info!=NULL&&OP_ATOMIC_FETCH_DEC(&_info->refs)==1){
+    int nlinks;
+    int li;
+    nlinks=_info->nlinks;
+    for(li=0;li<nlinks;li++)opus_tags_clear(&_info->links[li].tags);
+    _ogg_free(_info->links);
+    _ogg_free(_info);
   }
-  OP_ALWAYS_TRUE(!op_granpos_diff(&diff,
-   links[_li].pcm_end,links[_li].pcm_start));
-  return diff-links[_li].head.pre_skip;
 }
 
-const OpusHead *op_head(const OggOpusFile *_of,int _li){
-  if(OP_UNLIKELY(_li>=_of->nlinks))_li=_of->nlinks-1;
-  if(!_of->seekable)_li=0;
-  return &_of->links[_li<0?_of->cur_link:_li].head;
+/*Add a reference to _info, which may be NULL.*/
+static OpusFileInfo *op_file_info_ref(OpusFileInfo *_info){
+  if(_info!=NULL)OP_ATOMIC_FETCH_INC(&_info->refs);
+  return _info;
 }
 
-const OpusTags *op_tags(const OggOpusFile *_of,int _li){
-  if(OP_UNLIKELY(_li>=_of->nlinks))_li=_of->nlinks-1;
-  if(!_of->seekable){
-    if(_of->ready_state<OP_STREAMSET&&_of->ready_state!=OP_PARTOPEN){
-      return NULL;
-    }
-    _li=0;
+/*Use the links from _info instead of scanning the source for them.
+  We've only read the headers of the first link, so check those and the size
+   of the source to make sure it's the same data.
+  Return: 1 if the links were attached, 0 if the source didn't match and
+           should be scanned as usual, or a negative value on error.*/
+static int op_attach_info(OggOpusFile *_of,OpusFileInfo *_info){
+  const OggOpusLink *link;
+  opus_int64         end;
+  int                ret;
+  link=_info->links;
+  if(_of->links[0].serialno!=link->serialno
+   ||_of->links[0].data_offset!=link->data_offset
+   ||_of->links[0].pcm_start!=link->pcm_start
+   ||_of->links[0].head.channel_count!=link->head.channel_count
+   ||_of->links[0].head.pre_skip!=link->head.pre_skip){
+    return 0;
   }
-  else if(_li<0)_li=_of->ready_state>=OP_STREAMSET?_of->cur_link:0;
-  return &_of->links[_li].tags;
+  OP_ASSERT(_of->log_lag
+   ||(*_of->callbacks.tell)(_of->source)==op_position(_of));
+  (*_of->callbacks.seek)(_of->source,0,SEEK_END);
+  end=(*_of->callbacks.tell)(_of->source);
+  ret=(*_of->callbacks.seek)(_of->source,op_position(_of),SEEK_SET);
+  if(OP_UNLIKELY(end<0)||OP_UNLIKELY(ret<0))return OP_EREAD;
+  _of->log_lag=0;
+  /*Trailing junk is fine, since it was trimmed off _info->end.*/
+  if(end<_info->end)return 0;
+  opus_tags_clear(&_of->links[0].tags);
+  _ogg_free(_of->links);
+  _of->links=_info->links;
+  _of->nlinks=_info->nlinks;
+  _of->end=_info->end;
+  _of->info=_info;
+  OP_ATOMIC_FETCH_INC(&_info->refs);
+  /*A seekable file doesn't keep these after it's been scanned.*/
+  _ogg_free(_of->serialnos);
+  _of->serialnos=NULL;
+  _of->cserialnos=_of->nserialnos=0;
+  return 1;
 }
 
-int op_current_link(const OggOpusFile *_of){
-  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
-  return _of->cur_link;
-}
+/*Pipelined decoding.
+  When enabled with op_set_pipeline(), a worker thread does all of the I/O,
+   demuxing, and decoding that op_read_native() would otherwise do on the
+   caller's thread, and queues the decoded samples in a ring buffer.
+  The op_read() family then only copies samples out of the ring.
+  The ring is single-producer/single-consumer: the worker owns the write
+   indices and the reader owns the read indices, so neither side takes a lock
+   unless the other is asleep waiting on it.
+  Anything that needs to touch the decoder state (seeking, changing the gain,
+   etc.) stops the worker first and restarts it afterwards.*/
 
-/*Compute an average bitrate given a byte and sample count.
-  Return: The bitrate in bits per second.*/
-static opus_int32 op_calc_bitrate(opus_int64 _bytes,ogg_int64_t _samples){
-  /*These rates are absurd, but let's handle them anyway.*/
-  if(OP_UNLIKELY(_bytes>(OP_INT64_MAX-(_samples>>1))/(48000*8))){
-    ogg_int64_t den;
+/*The largest pipeline depth we accept, in samples per channel.*/
+#define OP_PIPE_DEPTH_MAX (1<<21)
+
+/*The status of a chunk that marks a link boundary in an unseekable stream.
+  This is consumed by the reader without being returned.*/
+#define OP_PIPE_LINK_BOUNDARY (1)
+
+typedef struct OpusPipeChunk OpusPipeChunk;
+
+/*A run of decoded samples from a single link (or a read status) queued by the
+   worker, along with the state a synchronous reader would have seen when
+   those samples were returned.*/
+struct OpusPipeChunk{
+  /*The PCM offset of the first sample, as op_pcm_tell() would report it.*/
+  ogg_int64_t pcm_offset;
+  /*The byte offset of the decoder, as op_raw_tell() would report it.*/
+  opus_int64  offset;
+  /*The bitrate tracking counters accumulated while decoding these samples.*/
+  opus_int64  bytes_tracked;
+  ogg_int64_t samples_tracked;
+  /*The link the samples came from.*/
+  int         li;
+  /*The channel count of that link.*/
+  int         nchannels;
+  /*The number of samples per channel, or 0 for a status chunk.*/
+  int         nsamples;
+  /*For a status chunk, what the read should return: 0 at EOF, or a negative
+     error code (or OP_PIPE_LINK_BOUNDARY).*/
+  int         status;
+  /*Whether these are the first samples since the decoder was reset.*/
+  int         decoder_reset;
+};
+
+struct OpusPipe{
+  /*The interleaved sample ring.*/
+  op_sample            *samples;
+  opus_uint32           sample_mask;
+  /*The chunk descriptor ring.*/
+  OpusPipeChunk        *chunks;
+  opus_uint32           chunk_mask;
+  /*Free-running ring indices.
+    The worker only writes the write indices and the reader only writes the
+     read indices.*/
+  volatile opus_uint32  sample_write;
+  volatile opus_uint32  sample_read;
+  volatile opus_uint32  chunk_write;
+  volatile opus_uint32  chunk_read;
+  /*Set to ask the worker to exit.*/
+  volatile opus_uint32  quit;
+  /*Set while the worker is (about to be) asleep waiting for room.*/
+  volatile opus_uint32  worker_waiting;
+  /*Set while the reader is (about to be) asleep waiting for data.*/
+  volatile opus_uint32  reader_waiting;
+  op_mutex              mutex;
+  op_cond               space_cond;
+  op_cond               data_cond;
+  op_thread             thread;
+  int                   running;
+  /*Set when the decoder is reset, until the next samples are queued.*/
+  int                   decoder_reset;
+  /*Everything below belongs to the reader.*/
+  /*The number of samples already read from the chunk at chunk_read.*/
+  int                   chunk_pos;
+  /*The link and channel count of the last samples read from the ring.*/
+  int                   li;
+  int                   nchannels;
+  /*The PCM offset just past the last samples read from the ring.*/
+  ogg_int64_t           pcm_offset;
+  /*The byte offset to report from op_raw_tell().*/
+  opus_int64            offset;
+  /*The bitrate tracking counters for op_bitrate_instant().*/
+  opus_int64            bytes_tracked;
+  ogg_int64_t           samples_tracked;
+  /*Samples read from the ring but not yet filtered.
+    These always come from link li.*/
+  op_sample            *stage;
+  int                   stage_capacity;
+  int                   stage_pos;
+  int                   stage_size;
+};
+
+static int op_read_native(OggOpusFile *_of,
+ op_sample *_pcm,int _buf_size,int *_li);
+static ogg_int64_t op_pcm_tell_impl(const OggOpusFile *_of);
+
+static opus_uint32 op_pipe_free_samples(OpusPipe *_pipe){
+  return _pipe->sample_mask+1
+   -(_pipe->sample_write-OP_ATOMIC_LOAD(&_pipe->sample_read));
+}
+
+static opus_uint32 op_pipe_free_chunks(OpusPipe *_pipe){
+  return _pipe->chunk_mask+1
+   -(_pipe->chunk_write-OP_ATOMIC_LOAD(&_pipe->chunk_read));
+}
+
+/*Wait until the ring has room for the given number of samples and chunks.
+  Return: 0 if the worker was asked to exit, or 1 otherwise.*/
+static int op_pipe_wait_space(OpusPipe *_pipe,
+ opus_uint32 _nsamples,opus_uint32 _nchunks){
+  for(;;){
+    if(OP_UNLIKELY(OP_ATOMIC_LOAD(&_pipe->quit)))return 0;
+    if(op_pipe_free_samples(_pipe)>=_nsamples
+     &&op_pipe_free_chunks(_pipe)>=_nchunks){
+      return 1;
+    }
+    /*Announce that we are going to sleep before checking again, so that a
+       reader that frees up room after our check is guaranteed to see the
+       flag and wake us up.*/
+    op_mutex_lock(&_pipe->mutex);
+    OP_ATOMIC_STORE(&_pipe->worker_waiting,1);
+    if(!OP_ATOMIC_LOAD(&_pipe->quit)
+     &&(op_pipe_free_samples(_pipe)<_nsamples
+     ||op_pipe_free_chunks(_pipe)<_nchunks)){
+      op_cond_wait(&_pipe->space_cond,&_pipe->mutex);
+    }
+    OP_ATOMIC_STORE(&_pipe->worker_waiting,0);
+    op_mutex_unlock(&_pipe->mutex);
+  }
+}
+
+/*Publish a chunk whose samples have already been copied into the ring.*/
+static void op_pipe_publish(OpusPipe *_pipe,opus_uint32 _nsamples){
+  OP_ATOMIC_STORE(&_pipe->sample_write,_pipe->sample_write+_nsamples);
+  OP_ATOMIC_STORE(&_pipe->chunk_write,_pipe->chunk_write+1);
+  if(OP_UNLIKELY(OP_ATOMIC_LOAD(&_pipe->reader_waiting))){
+    op_mutex_lock(&_pipe->mutex);
+    op_cond_signal(&_pipe->data_cond);
+    op_mutex_unlock(&_pipe->mutex);
+  }
+}
+
+/*Wait for the worker to publish a chunk, if there are none queued.*/
+static void op_pipe_wait_data(OpusPipe *_pipe){
+  op_mutex_lock(&_pipe->mutex);
+  OP_ATOMIC_STORE(&_pipe->reader_waiting,1);
+  if(OP_ATOMIC_LOAD(&_pipe->chunk_write)==_pipe->chunk_read){
+    op_cond_wait(&_pipe->data_cond,&_pipe->mutex);
+  }
+  OP_ATOMIC_STORE(&_pipe->reader_waiting,0);
+  op_mutex_unlock(&_pipe->mutex);
+}
+
+/*Wake the worker up if it is waiting for the reader to make room.*/
+static void op_pipe_wake_worker(OpusPipe *_pipe){
+  if(OP_UNLIKELY(OP_ATOMIC_LOAD(&_pipe->worker_waiting))){
+    op_mutex_lock(&_pipe->mutex);
+    op_cond_signal(&_pipe->space_cond);
+    op_mutex_unlock(&_pipe->mutex);
+  }
+}
+
+/*Move the samples left in the decoder's buffer into the ring.
+  These are always queued as a single chunk, so that filtered reads see the
+   same blocks of samples they would have without pipelining (soft clipping
+   depends on them).
+  Return: 0 if the worker was asked to exit, or 1 otherwise.*/
+static int op_pipe_push(OggOpusFile *_of,int _li,int _nchannels){
+  OpusPipe        *pipe;
+  OpusPipeChunk   *chunk;
+  const op_sample *src;
+  opus_uint32      capacity;
+  opus_uint32      start;
+  int              nsamples;
+  int              count;
+  int              first;
+  pipe=_of->pipe;
+  nsamples=_of->od_buffer_size-_of->od_buffer_pos;
+  count=nsamples*_nchannels;
+  if(!op_pipe_wait_space(pipe,count,1))return 0;
+  chunk=pipe->chunks+(pipe->chunk_write&pipe->chunk_mask);
+  chunk->pcm_offset=op_pcm_tell_impl(_of);
+  chunk->offset=_of->offset;
+  chunk->bytes_tracked=_of->bytes_tracked;
+  chunk->samples_tracked=_of->samples_tracked;
+  chunk->li=_li;
+  chunk->nchannels=_nchannels;
+  chunk->nsamples=nsamples;
+  chunk->status=0;
+  chunk->decoder_reset=pipe->decoder_reset;
+  pipe->decoder_reset=0;
+  _of->bytes_tracked=0;
+  _of->samples_tracked=0;
+  src=_of->od_buffer+_nchannels*_of->od_buffer_pos;
+  capacity=pipe->sample_mask+1;
+  start=pipe->sample_write&pipe->sample_mask;
+  first=(int)OP_MIN(capacity-start,(opus_uint32)count);
+  memcpy(pipe->samples+start,src,sizeof(*src)*first);
+  memcpy(pipe->samples,src+first,sizeof(*src)*(count-first));
+  _of->od_buffer_pos=_of->od_buffer_size;
+  op_pipe_publish(pipe,count);
+  return 1;
+}
+
+/*Queue a status chunk and wait for the reader to get to it.
+  Return: 0 if the worker was asked to exit, or 1 otherwise.*/
+static int op_pipe_push_status(OggOpusFile *_of,int _status){
+  OpusPipe      *pipe;
+  OpusPipeChunk *chunk;
+  pipe=_of->pipe;
+  if(!op_pipe_wait_space(pipe,0,1))return 0;
+  chunk=pipe->chunks+(pipe->chunk_write&pipe->chunk_mask);
+  chunk->pcm_offset=op_pcm_tell_impl(_of);
+  chunk->offset=_of->offset;
+  chunk->bytes_tracked=_of->bytes_tracked;
+  chunk->samples_tracked=_of->samples_tracked;
+  chunk->li=_of->cur_link;
+  chunk->nchannels=0;
+  chunk->nsamples=0;
+  chunk->status=_status;
+  chunk->decoder_reset=0;
+  _of->bytes_tracked=0;
+  _of->samples_tracked=0;
+  op_pipe_publish(pipe,0);
+  return op_pipe_wait_space(pipe,pipe->sample_mask+1,pipe->chunk_mask+1);
+}
+
+static void op_pipe_worker(OggOpusFile *_of){
+  for(;;){
+    int ret;
+    int li;
+    /*Decode (at least) one packet into the decoder's buffer.*/
+    ret=op_read_native(_of,NULL,0,&li);
+    if(OP_LIKELY(ret>=0)&&OP_LIKELY(_of->ready_state>=OP_INITSET)
+     &&_of->od_buffer_pos<_of->od_buffer_size){
+      int nchannels;
+      nchannels=_of->links[_of->seekable?_of->cur_link:0].head.channel_count;
+      if(!op_pipe_push(_of,li,nchannels))break;
+      continue;
+    }
+    /*Queue the EOF or the error.
+      Like a synchronous reader, don't try again until the reader has seen it.*/
+    if(!op_pipe_push_status(_of,ret))break;
+  }
+}
+
+static OP_THREAD_MAIN(op_pipe_thread_main){
+  op_pipe_worker((OggOpusFile *)_ctx);
+  return OP_THREAD_EXIT;
+}
+
+/*Stop the worker.
+  Whatever it had decoded but not yet queued stays in the decoder's buffer, so
+   it can pick up exactly where it left off.*/
+static void op_pipe_stop(OpusPipe *_pipe){
+  if(!_pipe->running)return;
+  OP_ATOMIC_STORE(&_pipe->quit,1);
+  op_mutex_lock(&_pipe->mutex);
+  op_cond_signal(&_pipe->space_cond);
+  op_mutex_unlock(&_pipe->mutex);
+  op_thread_join(_pipe->thread);
+  _pipe->running=0;
+}
+
+/*Throw away everything queued and sync the reader's view with the decoder.*/
+static void op_pipe_flush(OggOpusFile *_of){
+  OpusPipe *pipe;
+  pipe=_of->pipe;
+  OP_ASSERT(!pipe->running);
+  pipe->sample_write=pipe->sample_read=0;
+  pipe->chunk_write=pipe->chunk_read=0;
+  pipe->chunk_pos=0;
+  pipe->stage_pos=pipe->stage_size=0;
+  pipe->li=_of->cur_link;
+  pipe->nchannels=0;
+  pipe->pcm_offset=op_pcm_tell_impl(_of);
+  pipe->offset=_of->offset;
+  pipe->bytes_tracked=_of->bytes_tracked;
+  pipe->samples_tracked=_of->samples_tracked;
+  _of->bytes_tracked=0;
+  _of->samples_tracked=0;
+}
+
+static void op_pipe_free(OggOpusFile *_of){
+  OpusPipe *pipe;
+  pipe=_of->pipe;
+  op_pipe_stop(pipe);
+  op_cond_clear(&pipe->data_cond);
+  op_cond_clear(&pipe->space_cond);
+  op_mutex_clear(&pipe->mutex);
+  _ogg_free(pipe->stage);
+  _ogg_free(pipe->chunks);
+  _ogg_free(pipe->samples);
+  _ogg_free(pipe);
+  _of->pipe=NULL;
+}
+
+/*(Re)start the worker.
+  If the thread can't be created, we fall back to synchronous decoding.
+  While a seek is pending, the worker stays stopped until it completes.*/
+static void op_pipe_start(OggOpusFile *_of){
+  OpusPipe *pipe;
+  pipe=_of->pipe;
+  OP_ASSERT(!pipe->running);
+  if(OP_UNLIKELY(_of->seek_kind!=OP_SEEK_KIND_NONE))return;
+  pipe->quit=0;
+  pipe->worker_waiting=0;
+  pipe->reader_waiting=0;
+  if(OP_UNLIKELY(op_thread_create(&pipe->thread,
+   op_pipe_thread_main,_of)<0)){
+    op_pipe_free(_of);
+    return;
+  }
+  pipe->running=1;
+}
+
+static int op_pipe_create(OggOpusFile *_of,opus_int32 _depth){
+  OpusPipe    *pipe;
+  opus_uint32  nsamples;
+  opus_uint32  nchunks;
+  int          nchannels_max;
+  nchannels_max=op_get_nchannels_max(_of);
+  _depth=OP_MIN(_depth,OP_PIPE_DEPTH_MAX);
+  /*We need room for at least one whole packet.*/
+  _depth=OP_MAX(_depth,120*48);
+  for(nsamples=1;nsamples<(opus_uint32)_depth*nchannels_max;nsamples<<=1);
+  /*The shortest packet is 2.5 ms, and we need one more chunk for a status.*/
+  for(nchunks=2;nchunks<(opus_uint32)(_depth/120+2);nchunks<<=1);
+  pipe=(OpusPipe *)_ogg_calloc(1,sizeof(*pipe));
+  if(OP_UNLIKELY(pipe==NULL))return OP_EFAULT;
+  pipe->samples=(op_sample *)_ogg_malloc(sizeof(*pipe->samples)*nsamples);
+  pipe->chunks=(OpusPipeChunk *)_ogg_malloc(sizeof(*pipe->chunks)*nchunks);
+  pipe->stage_capacity=nchannels_max*120*48;
+  pipe->stage=(op_sample *)_ogg_malloc(
+   sizeof(*pipe->stage)*pipe->stage_capacity);
+  if(OP_UNLIKELY(pipe->samples==NULL)||OP_UNLIKELY(pipe->chunks==NULL)
+   ||OP_UNLIKELY(pipe->stage==NULL)){
+    _ogg_free(pipe->stage);
+    _ogg_free(pipe->chunks);
+    _ogg_free(pipe->samples);
+    _ogg_free(pipe);
+    return OP_EFAULT;
+  }
+  pipe->sample_mask=nsamples-1;
+  pipe->chunk_mask=nchunks-1;
+  op_mutex_init(&pipe->mutex);
+  op_cond_init(&pipe->space_cond);
+  op_cond_init(&pipe->data_cond);
+  _of->pipe=pipe;
+  op_pipe_flush(_of);
+  op_pipe_start(_of);
+  return _of->pipe!=NULL?0:OP_EFAULT;
+}
+
+/*Called by the worker when an unseekable stream reaches a new link, before
+   the headers of the old one get replaced.
+  Waiting until the reader asks for more samples after reading everything from
+   the old link keeps op_head() and op_tags() describing the link the
+   application is actually in.*/
+static void op_pipe_drain(OggOpusFile *_of){
+  op_pipe_push_status(_of,OP_PIPE_LINK_BOUNDARY);
+}
+
+#if !defined(OP_FIXED_POINT)
+
+/*Called whenever the decoder is (re)initialized, by whichever thread owns it.*/
+static void op_pipe_decoder_reset(OggOpusFile *_of){
+  _of->pipe->decoder_reset=1;
+}
+
+#endif
+
+/*Catch the reader's view up with a chunk the first time it looks at it.*/
+static void op_pipe_enter_chunk(OggOpusFile *_of,const OpusPipeChunk *_chunk){
+  OpusPipe *pipe;
+  pipe=_of->pipe;
+  pipe->li=_chunk->li;
+  pipe->offset=_chunk->offset;
+  pipe->bytes_tracked+=_chunk->bytes_tracked;
+  pipe->samples_tracked+=_chunk->samples_tracked;
+  if(_chunk->nsamples>0){
+    pipe->nchannels=_chunk->nchannels;
+    pipe->pcm_offset=_chunk->pcm_offset;
+#if !defined(OP_FIXED_POINT)
+    if(_chunk->decoder_reset){
+      op_reset_output_state(_of,_of->seekable?_chunk->li:0);
+    }
+#endif
+  }
+}
+
+void op_free(OggOpusFile *_of){
+  if(OP_LIKELY(_of!=NULL)){
+    if(_of->pipe!=NULL)op_pipe_free(_of);
+    op_clear(_of);
+    _ogg_free(_of);
+  }
+}
+
+int op_poll_fds(OggOpusFile *_of,OpusPollFd *_fds,int _nfds,
+ opus_int32 *_timeout_ms){
+  int running;
+  int ret;
+  if(_of->poll==NULL)return OP_EIMPL;
+  if(OP_UNLIKELY(_nfds<0))return OP_EINVAL;
+  /*The pipeline worker may be reading from the source.*/
+  running=_of->pipe!=NULL&&_of->pipe->running;
+  if(running)op_pipe_stop(_of->pipe);
+  ret=(*_of->poll)(_of->source,_fds,_nfds,_timeout_ms);
+  if(running)op_pipe_start(_of);
+  return ret;
+}
+
+int op_seekable(const OggOpusFile *_of){
+  return _of->seekable;
+}
+
+int op_link_count(const OggOpusFile *_of){
+  return _of->nlinks;
+}
+
+/*Return the link the application is currently reading from.
+  With pipelined decoding, the decoder itself may already be further along.*/
+static int op_get_cur_link(const OggOpusFile *_of){
+  return _of->pipe!=NULL?_of->pipe->li:_of->cur_link;
+}
+
+ogg_uint32_t op_serialno(const OggOpusFile *_of,int _li){
+  if(OP_UNLIKELY(_li>=_of->nlinks))_li=_of->nlinks-1;
+  if(!_of->seekable)_li=0;
+  return _of->links[_li<0?op_get_cur_link(_of):_li].serialno;
+}
+
+int op_channel_count(const OggOpusFile *_of,int _li){
+  return op_head(_of,_li)->channel_count;
+}
+
+opus_int64 op_raw_total(const OggOpusFile *_of,int _li){
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED)
+   ||OP_UNLIKELY(!_of->seekable)
+   ||OP_UNLIKELY(_li>=_of->nlinks)){
+    return OP_EINVAL;
+  }
+  if(_li<0)return _of->end-_of->links[0].offset;
+  return (_li+1>=_of->nlinks?_of->end:_of->links[_li+1].offset)
+   -_of->links[_li].offset;
+}
+
+ogg_int64_t op_pcm_total(const OggOpusFile *_of,int _li){
+  OggOpusLink *links;
+  ogg_int64_t  diff;
+  int          nlinks;
+  nlinks=_of->nlinks;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED)
+   ||OP_UNLIKELY(!_of->seekable)
+   ||OP_UNLIKELY(_li>=nlinks)){
+    return OP_EINVAL;
+  }
+  links=_of->links;
+  /*We verify that the granule position differences are larger than the
+     pre-skip and that the total duration does not overflow during link
+     enumeration, so we don't have to check here.*/
+  if(_li<0){
+    ogg_int64_t pcm_total;
+    int         li;
+    pcm_total=0;
+    for(li=0;li<nlinks;li++){
+      OP_ALWAYS_TRUE(!op_granpos_diff(&diff,
+       links[li].pcm_end,links[li].pcm_start));
+      pcm_total+=diff-links[li].head.pre_skip;
+    }
+    return pcm_total;
+  }
+  OP_ALWAYS_TRUE(!op_granpos_diff(&diff,
+   links[_li].pcm_end,links[_li].pcm_start));
+  return diff-links[_li].head.pre_skip;
+}
+
+const OpusHead *op_head(const OggOpusFile *_of,int _li){
+  if(OP_UNLIKELY(_li>=_of->nlinks))_li=_of->nlinks-1;
+  if(!_of->seekable)_li=0;
+  return &_of->links[_li<0?op_get_cur_link(_of):_li].head;
+}
+
+const OpusTags *op_tags(const OggOpusFile *_of,int _li){
+  if(OP_UNLIKELY(_li>=_of->nlinks))_li=_of->nlinks-1;
+  if(!_of->seekable){
+    if(_of->pipe==NULL&&_of->ready_state<OP_STREAMSET
+     &&_of->ready_state!=OP_PARTOPEN){
+      return NULL;
+    }
+    _li=0;
+  }
+  else if(_li<0){
+    if(_of->pipe!=NULL)_li=_of->pipe->li;
+    else _li=_of->ready_state>=OP_STREAMSET?_of->cur_link:0;
+  }
+  return &_of->links[_li].tags;
+}
+
+int op_current_link(const OggOpusFile *_of){
+  /*The worker may be changing ready_state, but it never goes below
+     OP_OPENED.*/
+  if(_of->pipe!=NULL)return _of->pipe->li;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  return _of->cur_link;
+}
+
+/*Compute an average bitrate given a byte and sample count.
+  Return: The bitrate in bits per second.*/
+static opus_int32 op_calc_bitrate(opus_int64 _bytes,ogg_int64_t _samples){
+  /*These rates are absurd, but let's handle them anyway.*/
+  if(OP_UNLIKELY(_bytes>(OP_INT64_MAX-(_samples>>1))/(48000*8))){
+    ogg_int64_t den;
     if(OP_UNLIKELY(_bytes/(OP_INT32_MAX/(48000*8))>=_samples)){
       return OP_INT32_MAX;
     }
@@ -1794,14 +2909,23 @@ opus_int32 op_bitrate(const OggOpusFile *_of,int _li){
 }
 
 opus_int32 op_bitrate_instant(OggOpusFile *_of){
-  ogg_int64_t samples_tracked;
-  opus_int32  ret;
-  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
-  samples_tracked=_of->samples_tracked;
-  if(OP_UNLIKELY(samples_tracked==0))return OP_FALSE;
-  ret=op_calc_bitrate(_of->bytes_tracked,samples_tracked);
-  _of->bytes_tracked=0;
-  _of->samples_tracked=0;
+  opus_int64  *bytes_tracked;
+  ogg_int64_t *samples_tracked;
+  opus_int32   ret;
+  /*With pipelined decoding, only count what the application has read.*/
+  if(_of->pipe!=NULL){
+    bytes_tracked=&_of->pipe->bytes_tracked;
+    samples_tracked=&_of->pipe->samples_tracked;
+  }
+  else{
+    if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+    bytes_tracked=&_of->bytes_tracked;
+    samples_tracked=&_of->samples_tracked;
+  }
+  if(OP_UNLIKELY(*samples_tracked==0))return OP_FALSE;
+  ret=op_calc_bitrate(*bytes_tracked,*samples_tracked);
+  *bytes_tracked=0;
+  *samples_tracked=0;
   return ret;
 }
 
@@ -1853,7 +2977,19 @@ static int op_fetch_and_process_page(OggOpusFile *_of,
           if(OP_LIKELY(!ogg_page_bos(&og)))continue;
           /* 2) Our decoding just traversed a bitstream boundary.*/
           if(!_spanp)return OP_EOF;
-          if(OP_LIKELY(_of->ready_state>=OP_INITSET))op_decode_clear(_of);
+          /*Don't replace the headers of an unseekable stream while the
+             application may still be reading the old link.*/
+          if(!seekable&&_of->pipe!=NULL)op_pipe_drain(_of);
+          if(OP_LIKELY(_of->ready_state>=OP_INITSET)){
+            int xfade;
+            int nsaved;
+            /*Only crossfade if the old decoder actually played up to here.*/
+            xfade=_of->seamless_links&&!_of->od_pending;
+            nsaved=_of->link_xfade_nsaved;
+            op_decode_clear(_of);
+            _of->link_xfade_pending=xfade;
+            _of->link_xfade_nsaved=nsaved;
+          }
           break;
         }
       }
@@ -1899,18 +3035,51 @@ static int op_fetch_and_process_page(OggOpusFile *_of,
         }
       }
       else{
+        opus_int64 bytes_tracked;
+        /*If we have to come back to this page, its header bytes will get
+           counted again.*/
+        bytes_tracked=_of->bytes_tracked-og.header_len;
         do{
+          opus_int64 replay_offset;
+          /*If the source runs dry part way through the headers, we have to
+             be able to start over from this page, since we can't seek back
+             to it.*/
+          replay_offset=_of->offset-og.header_len-og.body_len;
+          ret=op_replay_start(_of,&og);
+          if(OP_UNLIKELY(ret<0))return ret;
           /*We're streaming.
             Fetch the two header packets, build the info struct.*/
           ret=op_fetch_headers(_of,&links[0].head,&links[0].tags,
            NULL,NULL,NULL,&og);
-          if(OP_UNLIKELY(ret<0))return ret;
-          /*op_find_initial_pcm_offset() will suppress any initial hole for us,
-             so no need to set _ignore_holes.*/
-          ret=op_find_initial_pcm_offset(_of,links,&og);
-          if(OP_UNLIKELY(ret<0))return ret;
+          if(OP_LIKELY(ret>=0)){
+            /*op_find_initial_pcm_offset() will suppress any initial hole for
+               us, so no need to set _ignore_holes.*/
+            ret=op_find_initial_pcm_offset(_of,links,&og);
+            if(OP_UNLIKELY(ret<0)){
+              op_recycle_tags(_of);
+              _of->ready_state=OP_OPENED;
+            }
+          }
+          if(OP_UNLIKELY(ret<0)){
+            if(ret==OP_EAGAIN){
+              /*Put everything back the way it was before we got this page,
+                 so the next call finds it again.*/
+              _of->bytes_tracked=bytes_tracked;
+              ogg_stream_reset(&_of->os);
+              _of->op_count=0;
+              if(OP_UNLIKELY(op_replay_rewind(_of,replay_offset)<0)){
+                return OP_EFAULT;
+              }
+            }
+            else op_replay_stop(_of);
+            return ret;
+          }
+          op_replay_stop(_of);
+          bytes_tracked=_of->bytes_tracked;
           _of->links[0].serialno=cur_serialno=_of->os.serialno;
           _of->cur_link++;
+          /*The headers of an empty link get replaced right away.*/
+          if(OP_UNLIKELY(ret>0))op_recycle_tags(_of);
         }
         /*If the link was empty, keep going, because we already have the
            BOS page of the next one in og.*/
@@ -2076,7 +3245,7 @@ static int op_fetch_and_process_page(OggOpusFile *_of,
   }
 }
 
-int op_raw_seek(OggOpusFile *_of,opus_int64 _pos){
+static int op_raw_seek_impl(OggOpusFile *_of,opus_int64 _pos){
   int ret;
   if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
   /*Don't dump the decoder state if we can't seek.*/
@@ -2153,12 +3322,12 @@ static ogg_int64_t op_get_granulepos(const OggOpusFile *_of,
 /*#define OP_SMALL_FOOTPRINT (1)*/
 
 /*Search within link _li for the page with the highest granule position
-   preceding (or equal to) _target_gp.
+   preceding (or equal to) _target_gp minus _preroll samples.
   There is a danger here: missing pages or incorrect frame number information
    in the bitstream could make our task impossible.
   Account for that (and report it as an error condition).*/
 static int op_pcm_seek_page(OggOpusFile *_of,
- ogg_int64_t _target_gp,int _li){
+ ogg_int64_t _target_gp,int _li,opus_int32 _preroll){
   const OggOpusLink *link;
   ogg_page           og;
   ogg_int64_t        pcm_pre_skip;
@@ -2186,10 +3355,10 @@ static int op_pcm_seek_page(OggOpusFile *_of,
   serialno=link->serialno;
   best=begin=link->data_offset;
   page_offset=-1;
-  /*We discard the first 80 ms of data after a seek, so seek back that much
-     farther.
+  /*Our caller normally discards the first 80 ms of data after a seek, so seek
+     back that much farther.
     If we can't, simply seek to the beginning of the link.*/
-  if(OP_UNLIKELY(op_granpos_add(&_target_gp,_target_gp,-80*48)<0)
+  if(OP_UNLIKELY(op_granpos_add(&_target_gp,_target_gp,-_preroll)<0)
    ||OP_UNLIKELY(op_granpos_cmp(_target_gp,pcm_start)<0)){
     _target_gp=pcm_start;
   }
@@ -2241,8 +3410,10 @@ static int op_pcm_seek_page(OggOpusFile *_of,
               For very small files (with all of the data in a single page,
                generally 1 second or less), we can loop them continuously
                without seeking at all.*/
+            /*The granule position of the first packet is where it ends, so
+               back up by its duration to get the start of the page.*/
             OP_ALWAYS_TRUE(!op_granpos_add(&prev_page_gp,_of->op[0].granulepos,
-             op_get_packet_duration(_of->op[0].packet,_of->op[0].bytes)));
+             -op_get_packet_duration(_of->op[0].packet,_of->op[0].bytes)));
             if(op_granpos_cmp(prev_page_gp,_target_gp)<=0){
               /*Don't call op_decode_clear(), because it will dump our
                  packets.*/
@@ -2389,7 +3560,7 @@ static int op_pcm_seek_page(OggOpusFile *_of,
   _of->prev_packet_gp=best_gp;
   ogg_stream_reset_serialno(&_of->os,serialno);
   ret=op_fetch_and_process_page(_of,page_offset<0?NULL:&og,page_offset,1,0,1);
-  if(OP_UNLIKELY(ret<=0))return OP_EBADLINK;
+  if(OP_UNLIKELY(ret<=0))return ret==OP_EAGAIN?OP_EAGAIN:OP_EBADLINK;
   /*Verify result.*/
   if(OP_UNLIKELY(op_granpos_cmp(_of->prev_packet_gp,_target_gp)>0)){
     return OP_EBADLINK;
@@ -2397,15 +3568,50 @@ static int op_pcm_seek_page(OggOpusFile *_of,
   return 0;
 }
 
-int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset){
+/*Skip (without decoding) the packets that end at or before _skip samples
+   past _pcm_start, leaving the stream positioned at the start of the first
+   packet that ends after it.*/
+static int op_pcm_skip_packets(OggOpusFile *_of,
+ ogg_int64_t _pcm_start,ogg_int64_t _skip){
+  ogg_int64_t prev_packet_gp;
+  ogg_int64_t diff;
+  int         op_count;
+  int         op_pos;
+  int         ret;
+  /*Skip packets until we find one with samples past our skip target.*/
+  for(;;){
+    op_count=_of->op_count;
+    prev_packet_gp=_of->prev_packet_gp;
+    for(op_pos=_of->op_pos;op_pos<op_count;op_pos++){
+      ogg_int64_t cur_packet_gp;
+      cur_packet_gp=_of->op[op_pos].granulepos;
+      if(OP_LIKELY(!op_granpos_diff(&diff,cur_packet_gp,_pcm_start))
+       &&diff>_skip){
+        break;
+      }
+      prev_packet_gp=cur_packet_gp;
+    }
+    _of->prev_packet_gp=prev_packet_gp;
+    _of->op_pos=op_pos;
+    if(op_pos<op_count)break;
+    /*We skipped all the packets on this page.
+      Fetch another.*/
+    ret=op_fetch_and_process_page(_of,NULL,-1,1,0,1);
+    if(OP_UNLIKELY(ret<=0))return ret==OP_EAGAIN?OP_EAGAIN:OP_EBADLINK;
+  }
+  OP_ALWAYS_TRUE(!op_granpos_diff(&diff,prev_packet_gp,_pcm_start));
+  /*We skipped too far.
+    Either the timestamps were illegal or there was a hole in the data.*/
+  if(diff>_skip)return OP_EBADLINK;
+  return 0;
+}
+
+static int op_pcm_seek_impl(OggOpusFile *_of,ogg_int64_t _pcm_offset){
   const OggOpusLink *link;
   ogg_int64_t        pcm_start;
   ogg_int64_t        target_gp;
-  ogg_int64_t        prev_packet_gp;
   ogg_int64_t        skip;
   ogg_int64_t        diff;
-  int                op_count;
-  int                op_pos;
   int                ret;
   int                li;
   if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
@@ -2416,11 +3622,18 @@ int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset){
   link=_of->links+li;
   pcm_start=link->pcm_start;
   OP_ALWAYS_TRUE(!op_granpos_diff(&_pcm_offset,target_gp,pcm_start));
+  /*An exact seek stops any fade-in left over from an approximate one.*/
+  _of->fade_in_left=0;
 #if !defined(OP_SMALL_FOOTPRINT)
   /*For small (90 ms or less) forward seeks within the same link, just decode
      forward.
-    This also optimizes the case of seeking to the current position.*/
-  if(li==_of->cur_link&&_of->ready_state>=OP_INITSET){
+    This also optimizes the case of seeking to the current position.
+    If pipelined decoding has run ahead of the application, op_pipe_skip()
+     already took care of the seeks that are short from where the application
+     is, and whether the decoder happens to be close to the target depends on
+     thread timing, so don't look at it.*/
+  if(li==_of->cur_link&&_of->ready_state>=OP_INITSET
+   &&(_of->pipe==NULL||op_pcm_tell(_of)==op_pcm_tell_impl(_of))){
     ogg_int64_t gp;
     gp=_of->prev_packet_gp;
     if(OP_LIKELY(gp!=-1)){
@@ -2437,14 +3650,19 @@ int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset){
            _minimum_ we would have discarded after a full seek.
           Assuming 20 ms frames (the default), we'd discard 90 ms on average.*/
         if(discard_count>=0&&OP_UNLIKELY(discard_count<90*48)){
-          _of->cur_discard_count=(opus_int32)discard_count;
+          int nskip;
+          /*Skip over the buffered samples first, since they come out before
+             anything cur_discard_count applies to.*/
+          nskip=(int)OP_MIN(nbuffered,discard_count);
+          _of->od_buffer_pos+=nskip;
+          _of->cur_discard_count=(opus_int32)(discard_count-nskip);
           return 0;
         }
       }
     }
   }
 #endif
-  ret=op_pcm_seek_page(_of,target_gp,li);
+  ret=op_pcm_seek_page(_of,target_gp,li,80*48);
   if(OP_UNLIKELY(ret<0))return ret;
   /*Now skip samples until we actually get to our target.*/
   /*Figure out where we should skip to.*/
@@ -2452,31 +3670,9 @@ int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset){
   else skip=OP_MAX(_pcm_offset-80*48,0);
   OP_ASSERT(_pcm_offset-skip>=0);
   OP_ASSERT(_pcm_offset-skip<OP_INT32_MAX-120*48);
-  /*Skip packets until we find one with samples past our skip target.*/
-  for(;;){
-    op_count=_of->op_count;
-    prev_packet_gp=_of->prev_packet_gp;
-    for(op_pos=_of->op_pos;op_pos<op_count;op_pos++){
-      ogg_int64_t cur_packet_gp;
-      cur_packet_gp=_of->op[op_pos].granulepos;
-      if(OP_LIKELY(!op_granpos_diff(&diff,cur_packet_gp,pcm_start))
-       &&diff>skip){
-        break;
-      }
-      prev_packet_gp=cur_packet_gp;
-    }
-    _of->prev_packet_gp=prev_packet_gp;
-    _of->op_pos=op_pos;
-    if(op_pos<op_count)break;
-    /*We skipped all the packets on this page.
-      Fetch another.*/
-    ret=op_fetch_and_process_page(_of,NULL,-1,1,0,1);
-    if(OP_UNLIKELY(ret<=0))return OP_EBADLINK;
-  }
-  OP_ALWAYS_TRUE(!op_granpos_diff(&diff,prev_packet_gp,pcm_start));
-  /*We skipped too far.
-    Either the timestamps were illegal or there was a hole in the data.*/
-  if(diff>skip)return OP_EBADLINK;
+  ret=op_pcm_skip_packets(_of,pcm_start,skip);
+  if(OP_UNLIKELY(ret<0))return ret;
+  OP_ALWAYS_TRUE(!op_granpos_diff(&diff,_of->prev_packet_gp,pcm_start));
   OP_ASSERT(_pcm_offset-diff<OP_INT32_MAX);
   /*TODO: If there are further holes/illegal timestamps, we still won't decode
      to the correct sample.
@@ -2486,21 +3682,181 @@ int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset){
   return 0;
 }
 
-opus_int64 op_raw_tell(const OggOpusFile *_of){
-  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
-  return _of->offset;
-}
+/*The length of the fade-in after an approximate seek with OP_SEEK_FADE_IN.
+  This is the same as the pre-roll an exact seek would have decoded.*/
+#define OP_FADE_IN_SIZE (80*48)
 
-/*Convert a granule position from a given link to a PCM offset relative to the
-   start of the whole stream.
-  For unseekable sources, this gets reset to 0 at the beginning of each link.*/
-static ogg_int64_t op_get_pcm_offset(const OggOpusFile *_of,
- ogg_int64_t _gp,int _li){
-  const OggOpusLink *links;
-  ogg_int64_t        pcm_offset;
-  ogg_int64_t        delta;
+static ogg_int64_t op_pcm_seek_approx_impl(OggOpusFile *_of,
+ ogg_int64_t _pcm_offset,int _flags){
+  const OggOpusLink *link;
+  ogg_int64_t        pcm_start;
+  ogg_int64_t        target_gp;
+  ogg_int64_t        diff;
+  opus_int32         pre_skip;
+  int                ret;
   int                li;
-  links=_of->links;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  if(OP_UNLIKELY(!_of->seekable))return OP_ENOSEEK;
+  if(OP_UNLIKELY(_pcm_offset<0))return OP_EINVAL;
+  if(OP_UNLIKELY(_flags&~(OP_SEEK_PACKET|OP_SEEK_FADE_IN)))return OP_EINVAL;
+  target_gp=op_get_granulepos(_of,_pcm_offset,&li);
+  if(OP_UNLIKELY(target_gp==-1))return OP_EINVAL;
+  link=_of->links+li;
+  pcm_start=link->pcm_start;
+  OP_ALWAYS_TRUE(!op_granpos_diff(&_pcm_offset,target_gp,pcm_start));
+  /*Find the page containing the target, with no pre-roll.
+    This leaves us at the start of that page.*/
+  ret=op_pcm_seek_page(_of,target_gp,li,0);
+  if(OP_UNLIKELY(ret<0))return ret;
+  /*Skip to the start of the packet containing the target, if asked.
+    This costs nothing but parsing the packets we've already read.*/
+  if(_flags&OP_SEEK_PACKET){
+    ret=op_pcm_skip_packets(_of,pcm_start,_pcm_offset);
+    if(OP_UNLIKELY(ret<0))return ret;
+  }
+  OP_ALWAYS_TRUE(!op_granpos_diff(&diff,_of->prev_packet_gp,pcm_start));
+  /*We never land before the start of the link, but we might land inside the
+     pre-skip, which we still have to discard.*/
+  pre_skip=link->head.pre_skip;
+  _of->cur_discard_count=(opus_int32)OP_MAX(pre_skip-diff,0);
+  /*The decoder starts out converged at the start of the link, so only fade in
+     anywhere else.*/
+  if((_flags&OP_SEEK_FADE_IN)&&diff>0)_of->fade_in_left=OP_FADE_IN_SIZE;
+  return op_pcm_tell_impl(_of);
+}
+
+/*Skip a short distance forward through the samples the pipeline worker has
+   already queued.
+  Without pipelining, op_pcm_seek_impl() decodes forward from the current
+   position for such seeks instead of starting over, and the samples it would
+   decode are exactly the ones in the queue.
+  The worker must be stopped.
+  Return: 1 if we got to _pcm_offset, or 0 if we still need to seek.*/
+static int op_pipe_skip(OggOpusFile *_of,ogg_int64_t _pcm_offset){
+  OpusPipe    *pipe;
+  ogg_int64_t  skip;
+  int          nskip;
+  int          li;
+  pipe=_of->pipe;
+  OP_ASSERT(!pipe->running);
+  /*If a seek was interrupted, the queue is already gone.*/
+  if(_of->seek_kind!=OP_SEEK_KIND_NONE)return 0;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED)||OP_UNLIKELY(!_of->seekable)
+   ||OP_UNLIKELY(_pcm_offset<0)){
+    return 0;
+  }
+  if(op_get_granulepos(_of,_pcm_offset,&li)==-1||li!=pipe->li)return 0;
+  skip=_pcm_offset-op_pcm_tell(_of);
+  /*Use the same threshold as op_pcm_seek_impl().*/
+  if(skip<0||skip>=90*48)return 0;
+  /*Staged samples come out first.*/
+  nskip=(int)OP_MIN(skip,pipe->stage_size-pipe->stage_pos);
+  pipe->stage_pos+=nskip;
+  skip-=nskip;
+  while(skip>0&&pipe->chunk_read!=pipe->chunk_write){
+    const OpusPipeChunk *chunk;
+    chunk=pipe->chunks+(pipe->chunk_read&pipe->chunk_mask);
+    /*Leave a status for the next read to return.*/
+    if(chunk->nsamples<=0||chunk->li!=li)break;
+    if(pipe->chunk_pos==0)op_pipe_enter_chunk(_of,chunk);
+    nskip=(int)OP_MIN(skip,chunk->nsamples-pipe->chunk_pos);
+    pipe->sample_read+=nskip*chunk->nchannels;
+    pipe->pcm_offset+=nskip;
+    pipe->chunk_pos+=nskip;
+    if(pipe->chunk_pos>=chunk->nsamples){
+      pipe->chunk_pos=0;
+      pipe->chunk_read++;
+    }
+    skip-=nskip;
+  }
+  /*If we ran out of queued samples first, the decoder is now exactly where the
+     application is, and op_pcm_seek_impl() can decode forward from there.*/
+  return skip<=0;
+}
+
+/*Perform a seek of any kind, stopping the pipeline worker while we do.
+  If the source runs dry part way through, the seek is remembered, so that
+   op_seek_resume() can start it over again before the next read, and so is
+   everything it read (see op_log_start()).
+  Unless the seek was rejected before touching the decoder state, everything
+   that was queued is now stale.*/
+static ogg_int64_t op_seek(OggOpusFile *_of,
+ int _kind,ogg_int64_t _target,int _flags){
+  ogg_int64_t ret;
+  if(_of->pipe!=NULL){
+    op_pipe_stop(_of->pipe);
+    if(_kind==OP_SEEK_KIND_PCM&&op_pipe_skip(_of,_target)){
+      op_pipe_start(_of);
+      return 0;
+    }
+  }
+  op_log_start(_of);
+  switch(_kind){
+    case OP_SEEK_KIND_RAW:ret=op_raw_seek_impl(_of,_target);break;
+    case OP_SEEK_KIND_PCM:ret=op_pcm_seek_impl(_of,_target);break;
+    default:{
+      OP_ASSERT(_kind==OP_SEEK_KIND_APPROX);
+      ret=op_pcm_seek_approx_impl(_of,_target,_flags);
+    }break;
+  }
+  /*Keep the log for the next attempt, but don't add whatever gets read in
+     the meantime to it.*/
+  _of->logging=0;
+  if(ret==OP_EAGAIN){
+    _of->seek_kind=_kind;
+    _of->seek_target=_target;
+    _of->seek_flags=_flags;
+  }
+  /*A rejected seek leaves any earlier one pending.*/
+  else if(ret!=OP_EINVAL&&ret!=OP_ENOSEEK){
+    _of->seek_kind=OP_SEEK_KIND_NONE;
+    op_log_stop(_of);
+  }
+  if(_of->pipe!=NULL){
+    if(ret!=OP_EINVAL&&ret!=OP_ENOSEEK)op_pipe_flush(_of);
+    op_pipe_start(_of);
+  }
+  return ret;
+}
+
+/*Finish a seek that was interrupted by OP_EAGAIN, if there is one.
+  Return: 0 if no seek is pending (any more), or a negative value on error.*/
+static int op_seek_resume(OggOpusFile *_of){
+  ogg_int64_t ret;
+  if(OP_LIKELY(_of->seek_kind==OP_SEEK_KIND_NONE))return 0;
+  ret=op_seek(_of,_of->seek_kind,_of->seek_target,_of->seek_flags);
+  return ret<0?(int)ret:0;
+}
+
+int op_raw_seek(OggOpusFile *_of,opus_int64 _pos){
+  return (int)op_seek(_of,OP_SEEK_KIND_RAW,_pos,0);
+}
+
+int op_pcm_seek(OggOpusFile *_of,ogg_int64_t _pcm_offset){
+  return (int)op_seek(_of,OP_SEEK_KIND_PCM,_pcm_offset,0);
+}
+
+ogg_int64_t op_pcm_seek_approx(OggOpusFile *_of,
+ ogg_int64_t _pcm_offset,int _flags){
+  return op_seek(_of,OP_SEEK_KIND_APPROX,_pcm_offset,_flags);
+}
+
+opus_int64 op_raw_tell(const OggOpusFile *_of){
+  if(_of->pipe!=NULL)return _of->pipe->offset;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  return _of->offset;
+}
+
+/*Convert a granule position from a given link to a PCM offset relative to the
+   start of the whole stream.
+  For unseekable sources, this gets reset to 0 at the beginning of each link.*/
+static ogg_int64_t op_get_pcm_offset(const OggOpusFile *_of,
+ ogg_int64_t _gp,int _li){
+  const OggOpusLink *links;
+  ogg_int64_t        pcm_offset;
+  ogg_int64_t        delta;
+  int                li;
+  links=_of->links;
   pcm_offset=0;
   OP_ASSERT(_li<_of->nlinks);
   for(li=0;li<_li;li++){
@@ -2530,11 +3886,11 @@ static ogg_int64_t op_get_pcm_offset(const OggOpusFile *_of,
   return pcm_offset;
 }
 
-ogg_int64_t op_pcm_tell(const OggOpusFile *_of){
+/*Return the PCM offset of the next sample the decoder will return.*/
+static ogg_int64_t op_pcm_tell_impl(const OggOpusFile *_of){
   ogg_int64_t gp;
   int         nbuffered;
   int         li;
-  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
   gp=_of->prev_packet_gp;
   if(gp==-1)return 0;
   nbuffered=OP_MAX(_of->od_buffer_size-_of->od_buffer_pos,0);
@@ -2546,10 +3902,20 @@ ogg_int64_t op_pcm_tell(const OggOpusFile *_of){
   return op_get_pcm_offset(_of,gp,li);
 }
 
+ogg_int64_t op_pcm_tell(const OggOpusFile *_of){
+  const OpusPipe *pipe;
+  pipe=_of->pipe;
+  if(pipe!=NULL)return pipe->pcm_offset-(pipe->stage_size-pipe->stage_pos);
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  return op_pcm_tell_impl(_of);
+}
+
 void op_set_decode_callback(OggOpusFile *_of,
  op_decode_cb_func _decode_cb,void *_ctx){
+  if(_of->pipe!=NULL)op_pipe_stop(_of->pipe);
   _of->decode_cb=_decode_cb;
   _of->decode_cb_ctx=_ctx;
+  if(_of->pipe!=NULL)op_pipe_start(_of);
 }
 
 int op_set_gain_offset(OggOpusFile *_of,
@@ -2558,12 +3924,16 @@ int op_set_gain_offset(OggOpusFile *_of,
    &&_gain_type!=OP_ABSOLUTE_GAIN){
     return OP_EINVAL;
   }
+  /*The worker keeps decoding with the old gain until we stop it, so the new one
+     only applies after whatever it has already queued.*/
+  if(_of->pipe!=NULL)op_pipe_stop(_of->pipe);
   _of->gain_type=_gain_type;
   /*The sum of header gain and track gain lies in the range [-65536,65534].
     These bounds allow the offset to set the final value to anywhere in the
      range [-32768,32767], which is what we'll clamp it to before applying.*/
   _of->gain_offset_q8=OP_CLAMP(-98302,_gain_offset_q8,98303);
   op_update_gain(_of);
+  if(_of->pipe!=NULL)op_pipe_start(_of);
   return 0;
 }
 
@@ -2574,33 +3944,120 @@ void op_set_dither_enabled(OggOpusFile *_of,int _enabled){
 #endif
 }
 
+void op_set_seamless_links(OggOpusFile *_of,int _enabled){
+  /*The decoding thread is the one that crosses link boundaries.*/
+  if(_of->pipe!=NULL)op_pipe_stop(_of->pipe);
+  _of->seamless_links=!!_enabled;
+  if(!_enabled)_of->link_xfade_pending=0;
+  if(_of->pipe!=NULL)op_pipe_start(_of);
+}
+
+int op_set_pipeline(OggOpusFile *_of,opus_int32 _depth){
+  if(OP_UNLIKELY(_depth<0))return OP_EINVAL;
+  if(_of->pipe!=NULL){
+    ogg_int64_t pcm_offset;
+    op_pipe_stop(_of->pipe);
+    pcm_offset=op_pcm_tell(_of);
+#if !defined(OP_FIXED_POINT)
+    if(_of->pipe->decoder_reset){
+      op_reset_output_state(_of,_of->seekable?_of->cur_link:0);
+    }
+#endif
+    op_pipe_free(_of);
+    /*If the decoder has run ahead of the application, seek back to where the
+       application actually is, if we can.
+      For unseekable streams, whatever was queued is lost.*/
+    if(_of->seekable&&pcm_offset!=op_pcm_tell_impl(_of)){
+      ogg_int64_t ret;
+      ret=op_seek(_of,OP_SEEK_KIND_PCM,pcm_offset,0);
+      /*If the source ran dry, the seek finishes on the next read.*/
+      if(OP_UNLIKELY(ret<0)&&ret!=OP_EAGAIN)return (int)ret;
+    }
+  }
+  else if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  if(_depth<=0)return 0;
+  return op_pipe_create(_of,_depth);
+}
+
 /*Allocate the decoder scratch buffer.
   This is done lazily, since if the user provides large enough buffers, we'll
    never need it.*/
 static int op_init_buffer(OggOpusFile *_of){
   int nchannels_max;
-  if(_of->seekable){
-    const OggOpusLink *links;
-    int                nlinks;
-    int                li;
-    links=_of->links;
-    nlinks=_of->nlinks;
-    nchannels_max=1;
-    for(li=0;li<nlinks;li++){
-      nchannels_max=OP_MAX(nchannels_max,links[li].head.channel_count);
-    }
-  }
-  else nchannels_max=OP_NCHANNELS_MAX;
+  nchannels_max=op_get_nchannels_max(_of);
   _of->od_buffer=(op_sample *)_ogg_malloc(
    sizeof(*_of->od_buffer)*nchannels_max*120*48);
   if(_of->od_buffer==NULL)return OP_EFAULT;
   return 0;
 }
 
+/*Fade in the first samples decoded after an approximate seek, to mask the
+   artifacts from starting the decoder without any pre-roll.*/
+static void op_fade_in(OggOpusFile *_of,op_sample *_pcm,
+ int _nsamples,int _nchannels){
+  opus_int32 fade_in_left;
+  int        nfade;
+  int        i;
+  fade_in_left=_of->fade_in_left;
+  nfade=(int)OP_MIN(_nsamples,fade_in_left);
+  for(i=0;i<nfade;i++){
+    opus_int32 pos;
+    int        ci;
+    pos=OP_FADE_IN_SIZE-fade_in_left+i;
+    for(ci=0;ci<_nchannels;ci++){
+#if defined(OP_FIXED_POINT)
+      _pcm[i*_nchannels+ci]=(op_sample)(_pcm[i*_nchannels+ci]*pos
+       /OP_FADE_IN_SIZE);
+#else
+      _pcm[i*_nchannels+ci]*=pos*(1.0F/OP_FADE_IN_SIZE);
+#endif
+    }
+  }
+  _of->fade_in_left=fade_in_left-nfade;
+}
+
+/*Crossfade the first samples of a link after its pre-skip with the
+   concealment output saved from the previous link.*/
+static void op_link_xfade(OggOpusFile *_of,op_sample *_pcm,
+ int _nsamples,int _nchannels){
+  const op_sample *buf;
+  int              xfade_left;
+  int              skip;
+  int              nxfade;
+  int              i;
+  /*The samples discarded for pre-skip don't count.*/
+  skip=(int)OP_MIN(_nsamples,_of->cur_discard_count);
+  xfade_left=_of->link_xfade_left;
+  nxfade=OP_MIN(_nsamples-skip,xfade_left);
+  buf=_of->link_xfade_buffer
+   +(OP_LINK_XFADE_SIZE-xfade_left)*_nchannels;
+  _pcm+=skip*_nchannels;
+  for(i=0;i<nxfade;i++){
+    int pos;
+    int ci;
+    pos=OP_LINK_XFADE_SIZE-xfade_left+i;
+    for(ci=0;ci<_nchannels;ci++){
+#if defined(OP_FIXED_POINT)
+      _pcm[i*_nchannels+ci]=(op_sample)((_pcm[i*_nchannels+ci]*pos
+       +buf[i*_nchannels+ci]*(OP_LINK_XFADE_SIZE-pos))/OP_LINK_XFADE_SIZE);
+#else
+      _pcm[i*_nchannels+ci]=buf[i*_nchannels+ci]
+       +(_pcm[i*_nchannels+ci]-buf[i*_nchannels+ci])
+       *pos*(1.0F/OP_LINK_XFADE_SIZE);
+#endif
+    }
+  }
+  _of->link_xfade_left=xfade_left-nxfade;
+}
+
 /*Decode a single packet into the target buffer.*/
 static int op_decode(OggOpusFile *_of,op_sample *_pcm,
  const ogg_packet *_op,int _nsamples,int _nchannels){
   int ret;
+  if(OP_UNLIKELY(_of->od_pending)){
+    ret=op_init_decoder(_of);
+    if(OP_UNLIKELY(ret<0))return ret;
+  }
   /*First we try using the application-provided decode callback.*/
   if(_of->decode_cb!=NULL){
 #if defined(OP_FIXED_POINT)
@@ -2627,6 +4084,10 @@ static int op_decode(OggOpusFile *_of,op_sample *_pcm,
      OP_DEC_USE_DEFAULT, fail.*/
   else if(OP_UNLIKELY(ret>0))return OP_EBADPACKET;
   if(OP_UNLIKELY(ret<0))return OP_EBADPACKET;
+  if(OP_UNLIKELY(_of->fade_in_left>0))op_fade_in(_of,_pcm,ret,_nchannels);
+  if(OP_UNLIKELY(_of->link_xfade_left>0)){
+    op_link_xfade(_of,_pcm,ret,_nchannels);
+  }
   return ret;
 }
 
@@ -2648,10 +4109,14 @@ static int op_read_native(OggOpusFile *_of,
       /*If we have buffered samples, return them.*/
       if(nsamples>0){
         if(nsamples*nchannels>_buf_size)nsamples=_buf_size/nchannels;
-        memcpy(_pcm,_of->od_buffer+nchannels*od_buffer_pos,
-         sizeof(*_pcm)*nchannels*nsamples);
-        od_buffer_pos+=nsamples;
-        _of->od_buffer_pos=od_buffer_pos;
+        OP_ASSERT(_pcm!=NULL||nsamples<=0);
+        /*Check nsamples again so we don't pass NULL to memcpy().*/
+        if(OP_LIKELY(nsamples>0)){
+          memcpy(_pcm,_of->od_buffer+nchannels*od_buffer_pos,
+           sizeof(*_pcm)*nchannels*nsamples);
+          od_buffer_pos+=nsamples;
+          _of->od_buffer_pos=od_buffer_pos;
+        }
         if(_li!=NULL)*_li=_of->cur_link;
         return nsamples;
       }
@@ -2693,6 +4158,10 @@ static int op_read_native(OggOpusFile *_of,
           }
           ret=op_decode(_of,buf,pop,duration,nchannels);
           if(OP_UNLIKELY(ret<0))return ret;
+          if(OP_UNLIKELY(trimmed_duration<duration)&&_of->seamless_links){
+            op_link_xfade_save(_of,buf+nchannels*trimmed_duration,
+             duration-trimmed_duration,nchannels);
+          }
           /*Perform pre-skip/pre-roll.*/
           od_buffer_pos=(int)OP_MIN(trimmed_duration,cur_discard_count);
           cur_discard_count-=od_buffer_pos;
@@ -2708,6 +4177,10 @@ static int op_read_native(OggOpusFile *_of,
           /*Otherwise decode directly into the user's buffer.*/
           ret=op_decode(_of,_pcm,pop,duration,nchannels);
           if(OP_UNLIKELY(ret<0))return ret;
+          if(OP_UNLIKELY(trimmed_duration<duration)&&_of->seamless_links){
+            op_link_xfade_save(_of,_pcm+nchannels*trimmed_duration,
+             duration-trimmed_duration,nchannels);
+          }
           if(OP_LIKELY(trimmed_duration>0)){
             /*Perform pre-skip/pre-roll.*/
             od_buffer_pos=(int)OP_MIN(trimmed_duration,cur_discard_count);
@@ -2744,17 +4217,186 @@ static int op_read_native(OggOpusFile *_of,
   }
 }
 
+int op_read_packet(OggOpusFile *_of,ogg_packet *_op,OpusPacketInfo *_info){
+  int ret;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  /*The pipeline worker has already taken the packets it decoded ahead.*/
+  if(OP_UNLIKELY(_of->pipe!=NULL))return OP_EINVAL;
+  ret=op_seek_resume(_of);
+  if(OP_UNLIKELY(ret<0))return ret;
+  /*Drop the rest of any packet that was decoded but not completely read.*/
+  _of->od_buffer_size=_of->od_buffer_pos=0;
+  for(;;){
+    if(OP_LIKELY(_of->ready_state>=OP_INITSET)){
+      int op_pos;
+      op_pos=_of->op_pos;
+      if(OP_LIKELY(op_pos<_of->op_count)){
+        const ogg_packet *pop;
+        ogg_int64_t       pcm_offset;
+        ogg_int64_t       diff;
+        opus_int32        cur_discard_count;
+        int               duration;
+        int               trimmed_duration;
+        int               nskip;
+        pcm_offset=op_pcm_tell_impl(_of);
+        pop=_of->op+op_pos++;
+        _of->op_pos=op_pos;
+        cur_discard_count=_of->cur_discard_count;
+        duration=op_get_packet_duration(pop->packet,pop->bytes);
+        /*We don't buffer packets with an invalid TOC sequence.*/
+        OP_ASSERT(duration>0);
+        trimmed_duration=duration;
+        /*Perform end-trimming, exactly as op_read_native() does.*/
+        if(OP_UNLIKELY(pop->e_o_s)){
+          if(OP_UNLIKELY(op_granpos_cmp(pop->granulepos,
+           _of->prev_packet_gp)<=0)){
+            trimmed_duration=0;
+          }
+          else if(OP_LIKELY(!op_granpos_diff(&diff,
+           pop->granulepos,_of->prev_packet_gp))){
+            trimmed_duration=(int)OP_MIN(diff,trimmed_duration);
+          }
+        }
+        _of->prev_packet_gp=pop->granulepos;
+        /*Perform pre-skip/pre-roll.*/
+        nskip=(int)OP_MIN(trimmed_duration,cur_discard_count);
+        _of->cur_discard_count=cur_discard_count-nskip;
+        _of->bytes_tracked+=pop->bytes;
+        _of->samples_tracked+=trimmed_duration-nskip;
+        *_op=*pop;
+        if(_info!=NULL){
+          _info->pcm_offset=pcm_offset;
+          _info->duration=duration;
+          _info->discard_start=nskip;
+          _info->discard_end=duration-trimmed_duration;
+          _info->li=_of->cur_link;
+        }
+        return 1;
+      }
+    }
+    /*Suck in another page.*/
+    ret=op_fetch_and_process_page(_of,NULL,-1,1,1,0);
+    if(OP_UNLIKELY(ret==OP_EOF))return 0;
+    if(OP_UNLIKELY(ret<0))return ret;
+  }
+}
+
 /*A generic filter to apply to the decoded audio data.
   _src is non-const because we will destructively modify the contents of the
    source buffer that we consume in some cases.*/
 typedef int (*op_read_filter_func)(OggOpusFile *_of,void *_dst,int _dst_sz,
  op_sample *_src,int _nsamples,int _nchannels);
 
+/*Copy samples out of the pipeline's ring, using the same API as
+   op_read_native().*/
+static int op_pipe_read_ring(OggOpusFile *_of,
+ op_sample *_pcm,int _buf_size,int *_li){
+  OpusPipe            *pipe;
+  const OpusPipeChunk *chunk;
+  opus_uint32          capacity;
+  opus_uint32          start;
+  int                  nchannels;
+  int                  nsamples;
+  int                  count;
+  int                  first;
+  pipe=_of->pipe;
+  for(;;){
+    int ret;
+    while(OP_ATOMIC_LOAD(&pipe->chunk_write)==pipe->chunk_read){
+      /*Underrun: the worker hasn't caught up yet.*/
+      op_pipe_wait_data(pipe);
+    }
+    chunk=pipe->chunks+(pipe->chunk_read&pipe->chunk_mask);
+    if(pipe->chunk_pos==0)op_pipe_enter_chunk(_of,chunk);
+    if(OP_LIKELY(chunk->nsamples>0))break;
+    ret=chunk->status;
+    OP_ATOMIC_STORE(&pipe->chunk_read,pipe->chunk_read+1);
+    op_pipe_wake_worker(pipe);
+    if(ret!=OP_PIPE_LINK_BOUNDARY){
+      if(_li!=NULL)*_li=pipe->li;
+      return ret;
+    }
+  }
+  nchannels=chunk->nchannels;
+  nsamples=chunk->nsamples-pipe->chunk_pos;
+  if(nsamples*nchannels>_buf_size)nsamples=_buf_size/nchannels;
+  count=nsamples*nchannels;
+  capacity=pipe->sample_mask+1;
+  start=pipe->sample_read&pipe->sample_mask;
+  first=(int)OP_MIN(capacity-start,(opus_uint32)count);
+  memcpy(_pcm,pipe->samples+start,sizeof(*_pcm)*first);
+  memcpy(_pcm+first,pipe->samples,sizeof(*_pcm)*(count-first));
+  pipe->pcm_offset+=nsamples;
+  pipe->chunk_pos+=nsamples;
+  OP_ATOMIC_STORE(&pipe->sample_read,pipe->sample_read+count);
+  if(pipe->chunk_pos>=chunk->nsamples){
+    pipe->chunk_pos=0;
+    OP_ATOMIC_STORE(&pipe->chunk_read,pipe->chunk_read+1);
+  }
+  op_pipe_wake_worker(pipe);
+  if(_li!=NULL)*_li=pipe->li;
+  return nsamples;
+}
+
+/*Read samples when pipelined decoding is enabled, using the same API as
+   op_read_native().*/
+static int op_pipe_read(OggOpusFile *_of,
+ op_sample *_pcm,int _buf_size,int *_li){
+  OpusPipe *pipe;
+  int       nsamples;
+  pipe=_of->pipe;
+  nsamples=pipe->stage_size-pipe->stage_pos;
+  /*If a filtered read left some samples staged, return them first.*/
+  if(nsamples>0){
+    int nchannels;
+    nchannels=pipe->nchannels;
+    if(nsamples*nchannels>_buf_size)nsamples=_buf_size/nchannels;
+    memcpy(_pcm,pipe->stage+nchannels*pipe->stage_pos,
+     sizeof(*_pcm)*nchannels*nsamples);
+    pipe->stage_pos+=nsamples;
+    if(_li!=NULL)*_li=pipe->li;
+    return nsamples;
+  }
+  return op_pipe_read_ring(_of,_pcm,_buf_size,_li);
+}
+
+/*Decode some samples and then apply a custom filter to them when pipelined
+   decoding is enabled.
+  Since the ring can wrap around, samples are staged in a contiguous buffer
+   first.*/
+static int op_pipe_filter_read(OggOpusFile *_of,void *_dst,int _dst_sz,
+ op_read_filter_func _filter,int *_li){
+  OpusPipe *pipe;
+  int       nchannels;
+  int       ret;
+  pipe=_of->pipe;
+  ret=pipe->stage_size-pipe->stage_pos;
+  if(ret<=0){
+    ret=op_pipe_read_ring(_of,pipe->stage,pipe->stage_capacity,_li);
+    if(OP_UNLIKELY(ret<=0))return ret;
+    pipe->stage_pos=0;
+    pipe->stage_size=ret;
+  }
+  else if(_li!=NULL)*_li=pipe->li;
+  nchannels=pipe->nchannels;
+  ret=(*_filter)(_of,_dst,_dst_sz,
+   pipe->stage+nchannels*pipe->stage_pos,ret,nchannels);
+  OP_ASSERT(ret>=0);
+  OP_ASSERT(ret<=pipe->stage_size-pipe->stage_pos);
+  pipe->stage_pos+=ret;
+  return ret;
+}
+
 /*Decode some samples and then apply a custom filter to them.
   This is used to convert to different output formats.*/
 static int op_filter_read_native(OggOpusFile *_of,void *_dst,int _dst_sz,
  op_read_filter_func _filter,int *_li){
   int ret;
+  /*Finish any seek interrupted by OP_EAGAIN before deciding where the samples
+     come from (the pipeline worker stays stopped until it's done).*/
+  ret=op_seek_resume(_of);
+  if(OP_UNLIKELY(ret<0))return ret;
+  if(_of->pipe!=NULL)return op_pipe_filter_read(_of,_dst,_dst_sz,_filter,_li);
   /*Ensure we have some decoded samples in our buffer.*/
   ret=op_read_native(_of,NULL,0,_li);
   /*Now apply the filter to them.*/
@@ -2854,6 +4496,10 @@ static const opus_int16 OP_STEREO_DOWNMIX_Q14
 };
 
 int op_read(OggOpusFile *_of,opus_int16 *_pcm,int _buf_size,int *_li){
+  int ret;
+  ret=op_seek_resume(_of);
+  if(OP_UNLIKELY(ret<0))return ret;
+  if(_of->pipe!=NULL)return op_pipe_read(_of,_pcm,_buf_size,_li);
   return op_read_native(_of,_pcm,_buf_size,_li);
 }
 
@@ -3091,7 +4737,11 @@ int op_read(OggOpusFile *_of,opus_int16 *_pcm,int _buf_size,int *_li){
 }
 
 int op_read_float(OggOpusFile *_of,float *_pcm,int _buf_size,int *_li){
+  int ret;
   _of->state_channel_count=0;
+  ret=op_seek_resume(_of);
+  if(OP_UNLIKELY(ret<0))return ret;
+  if(_of->pipe!=NULL)return op_pipe_read(_of,_pcm,_buf_size,_li);
   return op_read_native(_of,_pcm,_buf_size,_li);
 }
 
@@ -3156,3 +4806,548 @@ int op_read_float_stereo(OggOpusFile *_of,float *_pcm,int _buf_size){
 }
 
 #endif
+
+#if !defined(OP_FIXED_POINT)||!defined(OP_DISABLE_FLOAT_API)
+
+/*Parallel whole-file decoding.
+  op_read_all_float() and op_read_all_waveform() split a seekable file into
+   segments and decode them on several threads at once.
+  Each thread opens its own OggOpusFile on an in-memory copy of the source, so
+   that it has its own decoder state, and uses op_pcm_seek() to start each
+   segment, which already decodes and discards at least 80 ms of pre-roll
+   before the target.
+  Because segments are placed in the output by their PCM offset, the only
+   difference from a serial decode is the decoder state at the start of each
+   segment, which converges within the pre-roll.*/
+
+/*The shortest segment we will split a link into, in samples.
+  This keeps the pre-roll overhead under a few percent.*/
+#define OP_SEGMENT_MIN (48000*4)
+/*The number of segments we aim to give each thread, so that links of uneven
+   length still balance well.*/
+#define OP_SEGMENTS_PER_THREAD (4)
+
+typedef struct OpusSegment OpusSegment;
+typedef struct OpusReadAll OpusReadAll;
+typedef struct OpusReadAllThread OpusReadAllThread;
+
+struct OpusSegment{
+  /*The absolute PCM offset of the first and one past the last sample.*/
+  ogg_int64_t pcm_start;
+  ogg_int64_t pcm_end;
+  /*The offset of the first output in the output buffer, in values or bins.*/
+  ogg_int64_t dst;
+  int         li;
+  int         nchannels;
+};
+
+/*Decodes a single segment into its place in the output buffer.*/
+typedef int (*op_segment_func)(OggOpusFile *_of,const OpusReadAll *_ctx,
+ const OpusSegment *_seg);
+
+struct OpusReadAll{
+  const unsigned char *data;
+  size_t               size;
+  /*The structure of the file, so the threads don't each have to scan it.*/
+  OpusFileInfo        *info;
+  int                  gain_type;
+  opus_int32           gain_offset_q8;
+  op_segment_func      decode;
+  void                *dst;
+  opus_int32           bins_per_sec;
+  OpusSegment         *segments;
+  opus_uint32          nsegments;
+  /*The index of the next segment to hand out.*/
+  volatile opus_uint32 next;
+};
+
+struct OpusReadAllThread{
+  OpusReadAll *ctx;
+  op_thread    thread;
+  int          ret;
+};
+
+#if defined(_WIN32)
+static int op_get_ncpus(void){
+  SYSTEM_INFO info;
+  GetNativeSystemInfo(&info);
+  return (int)info.dwNumberOfProcessors;
+}
+#else
+# include <unistd.h>
+
+static int op_get_ncpus(void){
+# if defined(_SC_NPROCESSORS_ONLN)
+  return (int)sysconf(_SC_NPROCESSORS_ONLN);
+# else
+  return 1;
+# endif
+}
+#endif
+
+static OP_THREAD_MAIN(op_read_all_thread_main){
+  OpusReadAllThread *thread;
+  OpusReadAll       *ctx;
+  OggOpusFile       *of;
+  int                ret;
+  thread=(OpusReadAllThread *)_ctx;
+  ctx=thread->ctx;
+  of=op_open_memory_with_info(ctx->data,ctx->size,ctx->info,&ret);
+  if(OP_LIKELY(of!=NULL)){
+    ret=op_set_gain_offset(of,ctx->gain_type,ctx->gain_offset_q8);
+    while(OP_LIKELY(ret>=0)){
+      opus_uint32 si;
+      si=OP_ATOMIC_FETCH_INC(&ctx->next);
+      if(si>=ctx->nsegments)break;
+      ret=(*ctx->decode)(of,ctx,ctx->segments+si);
+    }
+    op_free(of);
+  }
+  /*Make sure the other threads stop early if we failed.*/
+  if(OP_UNLIKELY(ret<0))OP_ATOMIC_STORE(&ctx->next,ctx->nsegments);
+  thread->ret=ret;
+  return OP_THREAD_EXIT;
+}
+
+/*Reads the whole source into memory, then restores its position.*/
+static int op_read_source(OggOpusFile *_of,unsigned char **_data,
+ size_t *_size){
+  unsigned char *data;
+  size_t         size;
+  size_t         nread;
+  int            ret;
+  if(OP_UNLIKELY(_of->end<0)||OP_UNLIKELY((opus_uint64)_of->end>(size_t)-1)){
+    return OP_EFAULT;
+  }
+  size=(size_t)_of->end;
+  data=(unsigned char *)_ogg_malloc(OP_MAX(size,1));
+  if(OP_UNLIKELY(data==NULL))return OP_EFAULT;
+  ret=(*_of->callbacks.seek)(_of->source,0,SEEK_SET);
+  for(nread=0;OP_LIKELY(ret>=0)&&nread<size;nread+=ret){
+    ret=(*_of->callbacks.read)(_of->source,data+nread,
+     (int)OP_MIN(size-nread,(size_t)1<<30));
+    if(OP_UNLIKELY(ret<=0)){
+      ret=ret==OP_EAGAIN&&_of->nonblocking?OP_EAGAIN:OP_EREAD;
+    }
+  }
+  if(OP_UNLIKELY((*_of->callbacks.seek)(_of->source,
+   op_position(_of),SEEK_SET)<0)){
+    ret=OP_EREAD;
+  }
+  else _of->log_lag=0;
+  if(OP_UNLIKELY(ret<0)){
+    _ogg_free(data);
+    return ret;
+  }
+  *_data=data;
+  *_size=size;
+  return 0;
+}
+
+/*Returns the number of segments to split _pcm_total samples into.*/
+static ogg_int64_t op_segment_count(ogg_int64_t _pcm_total,
+ ogg_int64_t _file_total,int _nthreads){
+  ogg_int64_t nsegments;
+  nsegments=OP_MIN(_pcm_total/OP_SEGMENT_MIN,
+   (_pcm_total*_nthreads*OP_SEGMENTS_PER_THREAD+_file_total-1)
+   /OP_MAX(_file_total,1));
+  return OP_MAX(nsegments,1);
+}
+
+/*Decodes all of the segments in _ctx, using up to _nthreads threads (including
+   this one).
+  The caller fills in the segments and the output; this fills in the rest.*/
+static int op_decode_segments(OggOpusFile *_of,OpusReadAll *_ctx,
+ int _nthreads){
+  OpusReadAllThread *threads;
+  unsigned char     *data;
+  size_t             size;
+  int                nthreads;
+  int                ti;
+  int                ret;
+  nthreads=(int)OP_MIN((opus_uint32)_nthreads,_ctx->nsegments);
+  threads=(OpusReadAllThread *)_ogg_malloc(sizeof(*threads)*nthreads);
+  if(OP_UNLIKELY(threads==NULL))return OP_EFAULT;
+  /*The worker thread would be reading from the same source, so it has to stay
+     put until we have our copy.*/
+  if(_of->pipe!=NULL)op_pipe_stop(_of->pipe);
+  ret=op_read_source(_of,&data,&size);
+  if(_of->pipe!=NULL)op_pipe_start(_of);
+  if(OP_UNLIKELY(ret<0)){
+    _ogg_free(threads);
+    return ret;
+  }
+  _ctx->data=data;
+  _ctx->size=size;
+  _ctx->info=op_file_info(_of);
+  _ctx->gain_type=_of->gain_type;
+  _ctx->gain_offset_q8=_of->gain_offset_q8;
+  _ctx->next=0;
+  /*If we can't start as many threads as we wanted, the ones we have (including
+     this one) just take more segments each.*/
+  for(ti=1;ti<nthreads;ti++){
+    threads[ti].ctx=_ctx;
+    if(OP_UNLIKELY(op_thread_create(&threads[ti].thread,
+     op_read_all_thread_main,threads+ti)<0)){
+      break;
+    }
+  }
+  nthreads=ti;
+  threads[0].ctx=_ctx;
+  op_read_all_thread_main(threads+0);
+  ret=threads[0].ret;
+  for(ti=1;ti<nthreads;ti++){
+    op_thread_join(threads[ti].thread);
+    if(ret>=0)ret=threads[ti].ret;
+  }
+  op_file_info_release(_ctx->info);
+  _ogg_free(data);
+  _ogg_free(threads);
+  return ret;
+}
+
+/*Decodes a segment of float samples.
+  Any samples missing because of a hole in the data are left as silence.*/
+static int op_read_segment(OggOpusFile *_of,const OpusReadAll *_ctx,
+ const OpusSegment *_seg){
+  float       *pcm;
+  ogg_int64_t  pcm_offset;
+  ogg_int64_t  written;
+  int          ret;
+  if(_seg->pcm_start>=_seg->pcm_end)return 0;
+  ret=op_pcm_seek(_of,_seg->pcm_start);
+  if(OP_UNLIKELY(ret<0))return ret;
+  pcm=(float *)_ctx->dst+_seg->dst;
+  written=0;
+  for(pcm_offset=_seg->pcm_start;pcm_offset<_seg->pcm_end;){
+    ogg_int64_t pos;
+    ogg_int64_t nvalues;
+    int         li;
+    pos=(pcm_offset-_seg->pcm_start)*_seg->nchannels;
+    if(pos>written)memset(pcm+written,0,(size_t)(pos-written)*sizeof(*pcm));
+    nvalues=OP_MIN((_seg->pcm_end-pcm_offset)*_seg->nchannels,
+     120*48*OP_NCHANNELS_MAX);
+    ret=op_read_float(_of,pcm+pos,(int)nvalues,&li);
+    if(ret==OP_HOLE)continue;
+    if(OP_UNLIKELY(ret<0))return ret;
+    /*We ran out of data (or into the next link) before the end of the segment.
+      The link's sample count came from its granule positions, so this means
+       they were wrong.*/
+    if(OP_UNLIKELY(ret==0)||OP_UNLIKELY(li!=_seg->li))return OP_EBADTIMESTAMP;
+    written=pos+ret*(ogg_int64_t)_seg->nchannels;
+    pcm_offset=op_pcm_tell(_of);
+  }
+  return 0;
+}
+
+ogg_int64_t op_read_all_float(OggOpusFile *_of,float *_pcm,
+ ogg_int64_t _buf_size,int _nthreads){
+  OpusReadAll ctx;
+  ogg_int64_t pcm_total;
+  ogg_int64_t nvalues;
+  ogg_int64_t pcm_offset;
+  ogg_int64_t dst;
+  opus_uint32 nsegments;
+  opus_uint32 si;
+  int         nlinks;
+  int         li;
+  int         ret;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  if(OP_UNLIKELY(!_of->seekable))return OP_ENOSEEK;
+  nlinks=_of->nlinks;
+  pcm_total=op_pcm_total(_of,-1);
+  nvalues=0;
+  for(li=0;li<nlinks;li++){
+    nvalues+=op_pcm_total(_of,li)*_of->links[li].head.channel_count;
+  }
+  if(OP_UNLIKELY(_buf_size<nvalues))return OP_EINVAL;
+  if(_nthreads<=0)_nthreads=op_get_ncpus();
+  _nthreads=OP_MAX(_nthreads,1);
+  /*Work out how many segments each link gets, in proportion to its length.*/
+  nsegments=0;
+  for(li=0;li<nlinks;li++){
+    nsegments+=(opus_uint32)op_segment_count(op_pcm_total(_of,li),
+     pcm_total,_nthreads);
+  }
+  ctx.segments=(OpusSegment *)_ogg_malloc(sizeof(*ctx.segments)*nsegments);
+  if(OP_UNLIKELY(ctx.segments==NULL))return OP_EFAULT;
+  si=0;
+  pcm_offset=dst=0;
+  for(li=0;li<nlinks;li++){
+    ogg_int64_t link_total;
+    ogg_int64_t nlink_segments;
+    ogg_int64_t sj;
+    int         nchannels;
+    link_total=op_pcm_total(_of,li);
+    nlink_segments=op_segment_count(link_total,pcm_total,_nthreads);
+    nchannels=_of->links[li].head.channel_count;
+    for(sj=0;sj<nlink_segments;sj++){
+      ogg_int64_t start;
+      start=link_total*sj/nlink_segments;
+      ctx.segments[si].pcm_start=pcm_offset+start;
+      ctx.segments[si].pcm_end=pcm_offset+link_total*(sj+1)/nlink_segments;
+      ctx.segments[si].dst=dst+start*nchannels;
+      ctx.segments[si].li=li;
+      ctx.segments[si].nchannels=nchannels;
+      si++;
+    }
+    pcm_offset+=link_total;
+    dst+=link_total*nchannels;
+  }
+  OP_ASSERT(si==nsegments);
+  ctx.decode=op_read_segment;
+  ctx.dst=_pcm;
+  ctx.bins_per_sec=0;
+  ctx.nsegments=nsegments;
+  ret=op_decode_segments(_of,&ctx,_nthreads);
+  _ogg_free(ctx.segments);
+  return ret<0?ret:pcm_total;
+}
+
+/*Waveform summaries.
+  These reduce the decoded samples straight out of the decoder's buffer (or the
+   pipeline's), without converting or copying them anywhere first.*/
+
+#if defined(OP_FIXED_POINT)
+# if defined(__SSE2__)||defined(_M_X64)||defined(_M_IX86_FP)&&_M_IX86_FP>=2
+#  define OP_WAVEFORM_SSE2 (1)
+#  include <emmintrin.h>
+# endif
+#elif defined(__SSE__)
+# define OP_WAVEFORM_SSE (1)
+# include <xmmintrin.h>
+#endif
+
+typedef struct OpusWaveformAcc OpusWaveformAcc;
+
+/*The running totals for the current bin.*/
+struct OpusWaveformAcc{
+  op_sample   min;
+  op_sample   max;
+  double      sum2;
+  ogg_int64_t count;
+};
+
+static void op_waveform_acc_init(OpusWaveformAcc *_acc){
+#if defined(OP_FIXED_POINT)
+  _acc->min=32767;
+  _acc->max=-32768;
+#else
+  _acc->min=(float)HUGE_VAL;
+  _acc->max=(float)-HUGE_VAL;
+#endif
+  _acc->sum2=0;
+  _acc->count=0;
+}
+
+/*Adds _n values to the totals for the current bin.*/
+static void op_waveform_reduce(OpusWaveformAcc *_acc,
+ const op_sample *_src,int _n){
+  op_sample mn;
+  op_sample mx;
+  int       i;
+  mn=_acc->min;
+  mx=_acc->max;
+  i=0;
+#if defined(OP_WAVEFORM_SSE2)
+  if(_n>=8){
+    __m128i vmin;
+    __m128i vmax;
+    __m128i vsum;
+    __m128i zero;
+    opus_int16  lanes[8];
+    opus_uint32 sums[4];
+    opus_int64  sum2;
+    int         j;
+    vmin=_mm_set1_epi16(mn);
+    vmax=_mm_set1_epi16(mx);
+    vsum=zero=_mm_setzero_si128();
+    for(;i+8<=_n;i+=8){
+      __m128i x;
+      __m128i x2;
+      x=_mm_loadu_si128((const __m128i *)(_src+i));
+      vmin=_mm_min_epi16(vmin,x);
+      vmax=_mm_max_epi16(vmax,x);
+      /*Each pair of squares adds up to at most 2**31, which fits in an
+         unsigned 32-bit lane, so widen them to 64 bits before accumulating.*/
+      x2=_mm_madd_epi16(x,x);
+      vsum=_mm_add_epi64(vsum,_mm_unpacklo_epi32(x2,zero));
+      vsum=_mm_add_epi64(vsum,_mm_unpackhi_epi32(x2,zero));
+    }
+    _mm_storeu_si128((__m128i *)lanes,vmin);
+    for(j=0;j<8;j++)mn=OP_MIN(mn,lanes[j]);
+    _mm_storeu_si128((__m128i *)lanes,vmax);
+    for(j=0;j<8;j++)mx=OP_MAX(mx,lanes[j]);
+    _mm_storeu_si128((__m128i *)sums,vsum);
+    sum2=sums[0]|(opus_int64)sums[1]<<32;
+    sum2+=sums[2]|(opus_int64)sums[3]<<32;
+    _acc->sum2+=(double)sum2;
+  }
+#elif defined(OP_WAVEFORM_SSE)
+  if(_n>=4){
+    __m128 vmin;
+    __m128 vmax;
+    __m128 vsum;
+    float  lanes[4];
+    vmin=_mm_set1_ps(mn);
+    vmax=_mm_set1_ps(mx);
+    vsum=_mm_setzero_ps();
+    for(;i+4<=_n;i+=4){
+      __m128 x;
+      x=_mm_loadu_ps(_src+i);
+      vmin=_mm_min_ps(vmin,x);
+      vmax=_mm_max_ps(vmax,x);
+      vsum=_mm_add_ps(vsum,_mm_mul_ps(x,x));
+    }
+    _mm_storeu_ps(lanes,vmin);
+    mn=OP_MIN(OP_MIN(lanes[0],lanes[1]),OP_MIN(lanes[2],lanes[3]));
+    _mm_storeu_ps(lanes,vmax);
+    mx=OP_MAX(OP_MAX(lanes[0],lanes[1]),OP_MAX(lanes[2],lanes[3]));
+    _mm_storeu_ps(lanes,vsum);
+    _acc->sum2+=(double)lanes[0]+lanes[1]+lanes[2]+lanes[3];
+  }
+#endif
+  for(;i<_n;i++){
+    op_sample x;
+    x=_src[i];
+    mn=OP_MIN(mn,x);
+    mx=OP_MAX(mx,x);
+    _acc->sum2+=(double)x*x;
+  }
+  _acc->min=mn;
+  _acc->max=mx;
+  _acc->count+=_n;
+}
+
+static void op_waveform_acc_store(const OpusWaveformAcc *_acc,
+ OpusWaveformBin *_bin){
+#if defined(OP_FIXED_POINT)
+  _bin->min=(1.0F/32768)*_acc->min;
+  _bin->max=(1.0F/32768)*_acc->max;
+  _bin->rms=(float)((1.0/32768)*sqrt(_acc->sum2/_acc->count));
+#else
+  _bin->min=_acc->min;
+  _bin->max=_acc->max;
+  _bin->rms=(float)sqrt(_acc->sum2/_acc->count);
+#endif
+}
+
+/*A filter that adds samples to an OpusWaveformAcc instead of copying them.
+  _dst_sz is the number of samples per channel left in the current bin.*/
+static int op_waveform_filter(OggOpusFile *_of,void *_dst,int _dst_sz,
+ op_sample *_src,int _nsamples,int _nchannels){
+  (void)_of;
+  _nsamples=OP_MIN(_nsamples,_dst_sz);
+  op_waveform_reduce((OpusWaveformAcc *)_dst,_src,_nsamples*_nchannels);
+  return _nsamples;
+}
+
+/*Returns the first sample of a bin.*/
+static ogg_int64_t op_waveform_bin_start(ogg_int64_t _bi,
+ opus_int32 _bins_per_sec){
+  return (_bi*48000+_bins_per_sec-1)/_bins_per_sec;
+}
+
+int op_read_waveform(OggOpusFile *_of,OpusWaveformBin *_bins,int _nbins,
+ opus_int32 _bins_per_sec){
+  ogg_int64_t pcm_offset;
+  int         nbins;
+  if(OP_UNLIKELY(_bins_per_sec<1)||OP_UNLIKELY(_bins_per_sec>48000)){
+    return OP_EINVAL;
+  }
+  pcm_offset=op_pcm_tell(_of);
+  if(OP_UNLIKELY(pcm_offset<0))return (int)pcm_offset;
+  /*The dither and soft-clipping state only apply to 16-bit output.*/
+#if !defined(OP_FIXED_POINT)
+  _of->state_channel_count=0;
+#endif
+  for(nbins=0;nbins<_nbins;nbins++){
+    OpusWaveformAcc acc;
+    ogg_int64_t     bin_end;
+    int             ret;
+    op_waveform_acc_init(&acc);
+    bin_end=op_waveform_bin_start(pcm_offset*_bins_per_sec/48000+1,
+     _bins_per_sec);
+    for(ret=1;pcm_offset<bin_end;pcm_offset+=ret){
+      ret=op_filter_read_native(_of,&acc,
+       (int)OP_MIN(bin_end-pcm_offset,OP_INT32_MAX),op_waveform_filter,NULL);
+      if(ret==OP_HOLE){
+        ret=0;
+        continue;
+      }
+      /*Return any bins we've finished, and let the next call report the error
+         (if it persists).*/
+      if(OP_UNLIKELY(ret<0))return nbins>0?nbins:ret;
+      if(ret==0)break;
+    }
+    if(acc.count<=0)break;
+    op_waveform_acc_store(&acc,_bins+nbins);
+    if(ret==0)return nbins+1;
+  }
+  return nbins;
+}
+
+/*Summarizes a segment of whole bins.*/
+static int op_waveform_segment(OggOpusFile *_of,const OpusReadAll *_ctx,
+ const OpusSegment *_seg){
+  OpusWaveformBin *bins;
+  ogg_int64_t      nbins;
+  ogg_int64_t      bi;
+  int              ret;
+  if(_seg->pcm_start>=_seg->pcm_end)return 0;
+  ret=op_pcm_seek(_of,_seg->pcm_start);
+  if(OP_UNLIKELY(ret<0))return ret;
+  bins=(OpusWaveformBin *)_ctx->dst+_seg->dst;
+  nbins=(_seg->pcm_end-1)*_ctx->bins_per_sec/48000+1-_seg->dst;
+  for(bi=0;bi<nbins;bi+=ret){
+    ret=op_read_waveform(_of,bins+bi,(int)OP_MIN(nbins-bi,INT_MAX),
+     _ctx->bins_per_sec);
+    if(OP_UNLIKELY(ret<0))return ret;
+    if(OP_UNLIKELY(ret==0))return OP_EBADTIMESTAMP;
+  }
+  return 0;
+}
+
+ogg_int64_t op_read_all_waveform(OggOpusFile *_of,OpusWaveformBin *_bins,
+ ogg_int64_t _nbins,opus_int32 _bins_per_sec,int _nthreads){
+  OpusReadAll ctx;
+  ogg_int64_t pcm_total;
+  ogg_int64_t nbins;
+  opus_uint32 nsegments;
+  opus_uint32 si;
+  int         ret;
+  if(OP_UNLIKELY(_of->ready_state<OP_OPENED))return OP_EINVAL;
+  if(OP_UNLIKELY(!_of->seekable))return OP_ENOSEEK;
+  if(OP_UNLIKELY(_bins_per_sec<1)||OP_UNLIKELY(_bins_per_sec>48000)){
+    return OP_EINVAL;
+  }
+  pcm_total=op_pcm_total(_of,-1);
+  nbins=(pcm_total*_bins_per_sec+47999)/48000;
+  if(OP_UNLIKELY(_nbins<nbins))return OP_EINVAL;
+  if(_nthreads<=0)_nthreads=op_get_ncpus();
+  _nthreads=OP_MAX(_nthreads,1);
+  /*Bins can span links, so segments only need to start on a bin boundary.*/
+  nsegments=(opus_uint32)op_segment_count(pcm_total,pcm_total,_nthreads);
+  nsegments=(opus_uint32)OP_MIN(nsegments,OP_MAX(nbins,1));
+  ctx.segments=(OpusSegment *)_ogg_malloc(sizeof(*ctx.segments)*nsegments);
+  if(OP_UNLIKELY(ctx.segments==NULL))return OP_EFAULT;
+  for(si=0;si<nsegments;si++){
+    ogg_int64_t bi;
+    bi=nbins*si/nsegments;
+    ctx.segments[si].pcm_start=op_waveform_bin_start(bi,_bins_per_sec);
+    ctx.segments[si].pcm_end=OP_MIN(op_waveform_bin_start(
+     nbins*(si+1)/nsegments,_bins_per_sec),pcm_total);
+    ctx.segments[si].dst=bi;
+    ctx.segments[si].li=-1;
+    ctx.segments[si].nchannels=0;
+  }
+  ctx.decode=op_waveform_segment;
+  ctx.dst=_bins;
+  ctx.bins_per_sec=_bins_per_sec;
+  ctx.nsegments=nsegments;
+  ret=op_decode_segments(_of,&ctx,_nthreads);
+  _ogg_free(ctx.segments);
+  return ret<0?ret:nbins;
+}
+
+#endif
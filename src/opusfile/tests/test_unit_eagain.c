@@ -0,0 +1,429 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks a source whose read callback returns OP_EAGAIN the first time
+   it reaches each block of STALL_SIZE bytes.  Opened with
+   op_open_callbacks_nonblocking() or op_test_callbacks_nonblocking(),
+   seekable or not, retrying every call that returns OP_EAGAIN must decode
+   exactly what a blocking handle decodes, and op_pcm_seek() and
+   op_raw_seek() must land in the same place, whether the seek itself is
+   retried or the next read is left to finish it.  The same source opened
+   with op_open_callbacks() must just fail, without returning a handle. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define LINK_LEN    (2 * FS)
+#define NLINKS      3
+#define STALL_SIZE  1000
+#define READ_SIZE   960
+#define NSEEKS      24
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+/* A source that stalls once at the start of every block */
+typedef struct {
+   const unsigned char *data;
+   opus_int64 length;
+   opus_int64 pos;
+   int seekable;
+   unsigned char *stalled;
+   long eagains;
+   int polls;
+} stall_source;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link with its own serial number */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, double f0)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   int i, c, err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   pcm = (opus_int16 *)malloc(LINK_LEN * channels * sizeof(*pcm));
+   for (i = 0; i < LINK_LEN; i++)
+   {
+      double t = (double)i / FS;
+      for (c = 0; c < channels; c++)
+         pcm[channels * i + c] = (opus_int16)(7000 * sin(2 * M_PI * f0 * (c + 1) * t));
+   }
+   if (err == 0)
+      err = opw_write(w, pcm, LINK_LEN);
+   if (err == LINK_LEN)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+static int stall_read(void *stream, unsigned char *ptr, int nbytes)
+{
+   stall_source *s = (stall_source *)stream;
+   opus_int64 block;
+   opus_int64 end;
+   if (s->pos >= s->length)
+      return 0;
+   block = s->pos / STALL_SIZE;
+   if (!s->stalled[block])
+   {
+      s->stalled[block] = 1;
+      s->eagains++;
+      return OP_EAGAIN;
+   }
+   /* Never read past the next block, so every block gets its stall */
+   end = (block + 1) * STALL_SIZE;
+   if (end > s->length)
+      end = s->length;
+   if (nbytes > end - s->pos)
+      nbytes = (int)(end - s->pos);
+   memcpy(ptr, s->data + s->pos, nbytes);
+   s->pos += nbytes;
+   return nbytes;
+}
+
+static int stall_seek(void *stream, opus_int64 offset, int whence)
+{
+   stall_source *s = (stall_source *)stream;
+   if (!s->seekable)
+      return -1;
+   if (whence == SEEK_CUR)
+      offset += s->pos;
+   else if (whence == SEEK_END)
+      offset += s->length;
+   if (offset < 0 || offset > s->length)
+      return -1;
+   s->pos = offset;
+   return 0;
+}
+
+static opus_int64 stall_tell(void *stream)
+{
+   return ((stall_source *)stream)->pos;
+}
+
+/* There is nothing to wait on: a retry always makes progress */
+static int stall_poll(void *stream, OpusPollFd *fds, int nfds, opus_int32 *timeout_ms)
+{
+   (void)fds;
+   (void)nfds;
+   ((stall_source *)stream)->polls++;
+   *timeout_ms = 0;
+   return 0;
+}
+
+static const OpusFileCallbacks stall_cb = { stall_read, stall_seek, stall_tell, NULL };
+
+static void stall_init(stall_source *s, const mem_stream *m, int seekable)
+{
+   s->data = m->data;
+   s->length = m->length;
+   s->pos = 0;
+   s->seekable = seekable;
+   s->stalled = (unsigned char *)calloc(m->length / STALL_SIZE + 1, 1);
+   s->eagains = 0;
+   s->polls = 0;
+}
+
+/* Clears the stalls, so that every block stalls again when it is next
+   read */
+static void stall_reset(stall_source *s)
+{
+   memset(s->stalled, 0, s->length / STALL_SIZE + 1);
+}
+
+/* Opens the source, retrying with op_test_open() until it stops
+   returning OP_EAGAIN */
+static OggOpusFile *open_stalling(stall_source *s, int test)
+{
+   OggOpusFile *of;
+   int err;
+   if (test)
+      of = op_test_callbacks_nonblocking(s, &stall_cb, stall_poll, NULL, 0, &err);
+   else
+      of = op_open_callbacks_nonblocking(s, &stall_cb, stall_poll, NULL, 0, &err);
+   if (of == NULL)
+      return NULL;
+   if (test && err == 0)
+      err = op_test_open(of);
+   while (err == OP_EAGAIN)
+   {
+      OpusPollFd fd;
+      opus_int32 timeout_ms;
+      if (op_poll_fds(of, &fd, 1, &timeout_ms) != 0 || timeout_ms != 0)
+         break;
+      err = op_test_open(of);
+   }
+   if (err != 0)
+   {
+      op_free(of);
+      return NULL;
+   }
+   return of;
+}
+
+static int read_retrying(OggOpusFile *of, float *pcm, int size, int *li)
+{
+   int ret;
+   do
+      ret = op_read_float(of, pcm, size, li);
+   while (ret == OP_EAGAIN);
+   return ret;
+}
+
+/* Decodes everything left, returning the number of values stored or a
+   negative value on error */
+static long decode_rest(OggOpusFile *of, float *out, long size)
+{
+   float pcm[READ_SIZE * 2];
+   long n = 0;
+   for (;;)
+   {
+      int li;
+      int ret = read_retrying(of, pcm, READ_SIZE * 2, &li);
+      if (ret < 0)
+         return ret;
+      if (ret == 0)
+         return n;
+      ret *= op_channel_count(of, li);
+      if (n + ret > size)
+         return OP_EFAULT;
+      memcpy(out + n, pcm, ret * sizeof(*pcm));
+      n += ret;
+   }
+}
+
+static int test_decode(const mem_stream *m, const float *ref, long nref, int seekable, int test)
+{
+   stall_source s;
+   OggOpusFile *of;
+   float *out;
+   long n;
+   int ok = 0;
+   stall_init(&s, m, seekable);
+   of = open_stalling(&s, test);
+   out = (float *)malloc(nref * sizeof(*out));
+   if (of == NULL)
+      fprintf(stderr, "open failed (seekable %d, test %d)\n", seekable, test);
+   else if (op_seekable(of) != seekable)
+      fprintf(stderr, "seekable mismatch\n");
+   else if ((n = decode_rest(of, out, nref)) != nref || memcmp(out, ref, nref * sizeof(*out)) != 0)
+      fprintf(stderr, "decode mismatch (seekable %d, test %d): %ld of %ld values\n",
+            seekable, test, n, nref);
+   else if (s.eagains < m->length / STALL_SIZE || s.polls == 0)
+      fprintf(stderr, "source did not stall: %ld OP_EAGAIN, %d polls\n", s.eagains, s.polls);
+   else if (!seekable && op_pcm_seek(of, 0) != OP_ENOSEEK)
+      fprintf(stderr, "unseekable source seeked\n");
+   else
+      ok = 1;
+   op_free(of);
+   free(out);
+   free(s.stalled);
+   return ok;
+}
+
+/* Seeks a stalling handle and a blocking one to the same places and
+   compares where they land and what they decode from there */
+static int test_seek(const mem_stream *m)
+{
+   stall_source s;
+   OggOpusFile *of;
+   OggOpusFile *ref;
+   ogg_int64_t total;
+   int nstalled = 0;
+   int k;
+   int ok = 1;
+   stall_init(&s, m, 1);
+   of = open_stalling(&s, 0);
+   ref = op_open_memory(m->data, m->length, NULL);
+   if (of == NULL || ref == NULL)
+   {
+      fprintf(stderr, "seek test open failed\n");
+      ok = 0;
+      k = NSEEKS;
+   }
+   else
+   {
+      total = op_pcm_total(ref, -1);
+      k = 0;
+   }
+   for (; k < NSEEKS && ok; k++)
+   {
+      float pcm[READ_SIZE * 2];
+      float ref_pcm[READ_SIZE * 2];
+      int raw = k & 1;
+      int li;
+      int ref_li;
+      int ret;
+      int ref_ret;
+      long eagains;
+      opus_int64 offset = m->length * ((k * 7) % NSEEKS) / NSEEKS;
+      ogg_int64_t target = total * ((k * 7) % NSEEKS) / NSEEKS;
+      stall_reset(&s);
+      eagains = s.eagains;
+      ref_ret = raw ? op_raw_seek(ref, offset) : op_pcm_seek(ref, target);
+      /* Retry every other seek until it finishes, and leave the rest to the
+         next read */
+      do
+         ret = raw ? op_raw_seek(of, offset) : op_pcm_seek(of, target);
+      while (ret == OP_EAGAIN && (k & 2));
+      if (ret != ref_ret && !(ret == OP_EAGAIN && !(k & 2)))
+      {
+         fprintf(stderr, "seek %d returned %d, expected %d\n", k, ret, ref_ret);
+         ok = 0;
+         break;
+      }
+      ref_ret = op_read_float(ref, ref_pcm, READ_SIZE * 2, &ref_li);
+      ret = read_retrying(of, pcm, READ_SIZE * 2, &li);
+      if (ret != ref_ret || li != ref_li || op_pcm_tell(of) != op_pcm_tell(ref)
+            || (ret > 0 && memcmp(pcm, ref_pcm, ret * op_channel_count(ref, li) * sizeof(*pcm)) != 0))
+      {
+         fprintf(stderr, "seek %d (%s) decoded differently\n", k, raw ? "raw" : "pcm");
+         ok = 0;
+      }
+      else if (s.eagains > eagains)
+         nstalled++;
+   }
+   /* A seek near where the last one left off may not need any new data */
+   if (ok && nstalled < NSEEKS / 2)
+   {
+      fprintf(stderr, "only %d of %d seeks stalled\n", nstalled, NSEEKS);
+      ok = 0;
+   }
+   op_free(of);
+   op_free(ref);
+   free(s.stalled);
+   return ok;
+}
+
+/* Without the opt-in, OP_EAGAIN is just a read error, so the open fails
+   like it would on any other source that cannot be read */
+static int test_blocking(const mem_stream *m)
+{
+   stall_source s;
+   OggOpusFile *of;
+   OpusPollFd fd;
+   opus_int32 timeout_ms;
+   int err;
+   int ok = 1;
+   stall_init(&s, m, 1);
+   of = op_open_callbacks(&s, &stall_cb, NULL, 0, &err);
+   if (of != NULL || err >= 0 || err == OP_EAGAIN)
+   {
+      fprintf(stderr, "blocking open of a stalling source returned %d\n", err);
+      ok = 0;
+   }
+   op_free(of);
+   of = op_open_memory(m->data, m->length, NULL);
+   if (of == NULL || op_poll_fds(of, &fd, 1, &timeout_ms) != OP_EIMPL)
+   {
+      fprintf(stderr, "op_poll_fds() worked on a blocking handle\n");
+      ok = 0;
+   }
+   op_free(of);
+   free(s.stalled);
+   return ok;
+}
+
+int main(void)
+{
+   static const int channels[NLINKS] = { 2, 1, 2 };
+   mem_stream m = { NULL, 0, 0 };
+   OggOpusFile *of;
+   float *ref;
+   long nref;
+   int li;
+   int ret = 0;
+   for (li = 0; li < NLINKS; li++)
+   {
+      if (make_link(&m, channels[li], 1000 + li, 220.0 * (li + 1)) != 0)
+      {
+         fprintf(stderr, "encoding failed\n");
+         return 1;
+      }
+   }
+   of = op_open_memory(m.data, m.length, NULL);
+   nref = (long)LINK_LEN * 5;
+   ref = (float *)malloc(nref * sizeof(*ref));
+   nref = of != NULL ? decode_rest(of, ref, nref) : -1;
+   op_free(of);
+   if (nref <= 0)
+   {
+      fprintf(stderr, "reference decode failed\n");
+      return 1;
+   }
+
+   if (!test_decode(&m, ref, nref, 1, 0)
+         || !test_decode(&m, ref, nref, 1, 1)
+         || !test_decode(&m, ref, nref, 0, 0)
+         || !test_decode(&m, ref, nref, 0, 1)
+         || !test_seek(&m)
+         || !test_blocking(&m))
+      ret = 1;
+
+   free(ref);
+   free(m.data);
+   if (ret == 0)
+      fprintf(stdout, "All non-blocking source tests passed\n");
+   return ret;
+}
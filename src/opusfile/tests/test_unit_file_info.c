@@ -0,0 +1,319 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that a handle opened with op_open_callbacks_with_info() on the
+   information from op_file_info() sees the same links, headers, tags and
+   totals as one that scanned the stream itself, decodes and seeks the same
+   way, and reads much less of the source to get there, even once the
+   handle the information came from is gone.  A source that does not match
+   the information (a different stream, or the same first link with another
+   link appended) must be scanned as usual. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define LINK_LEN    (2 * FS)
+#define READ_SIZE   960
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+/* A seekable source that counts what is read from it */
+typedef struct {
+   const unsigned char *data;
+   opus_int64 length;
+   opus_int64 pos;
+   opus_int64 nread;
+} mem_source;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link with its own serial number and tags */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, double f0,
+      const char *title)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   int i, c, err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   if (err == 0)
+      err = opw_comment_add(w, "TITLE", title);
+   if (err == 0)
+      err = opw_comment_add(w, "R128_TRACK_GAIN", "-256");
+   pcm = (opus_int16 *)malloc(LINK_LEN * channels * sizeof(*pcm));
+   for (i = 0; i < LINK_LEN; i++)
+   {
+      double t = (double)i / FS;
+      for (c = 0; c < channels; c++)
+         pcm[channels * i + c] = (opus_int16)(7000 * sin(2 * M_PI * f0 * (c + 1) * t));
+   }
+   if (err == 0)
+      err = opw_write(w, pcm, LINK_LEN);
+   if (err == LINK_LEN)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+static int mem_read(void *stream, unsigned char *ptr, int nbytes)
+{
+   mem_source *s = (mem_source *)stream;
+   if (nbytes > s->length - s->pos)
+      nbytes = (int)(s->length - s->pos);
+   memcpy(ptr, s->data + s->pos, nbytes);
+   s->pos += nbytes;
+   s->nread += nbytes;
+   return nbytes;
+}
+
+static int mem_seek(void *stream, opus_int64 offset, int whence)
+{
+   mem_source *s = (mem_source *)stream;
+   if (whence == SEEK_CUR)
+      offset += s->pos;
+   else if (whence == SEEK_END)
+      offset += s->length;
+   if (offset < 0 || offset > s->length)
+      return -1;
+   s->pos = offset;
+   return 0;
+}
+
+static opus_int64 mem_tell(void *stream)
+{
+   return ((mem_source *)stream)->pos;
+}
+
+static OggOpusFile *open_counted(mem_source *src, const mem_stream *m, OpusFileInfo *info)
+{
+   static const OpusFileCallbacks cb = { mem_read, mem_seek, mem_tell, NULL };
+   src->data = m->data;
+   src->length = m->length;
+   src->pos = 0;
+   src->nread = 0;
+   return op_open_callbacks_with_info(src, &cb, NULL, 0, info, NULL);
+}
+
+static int same_tags(const OpusTags *a, const OpusTags *b)
+{
+   int ci;
+   if (a->comments != b->comments || strcmp(a->vendor, b->vendor) != 0)
+      return 0;
+   for (ci = 0; ci < a->comments; ci++)
+   {
+      if (a->comment_lengths[ci] != b->comment_lengths[ci]
+            || memcmp(a->user_comments[ci], b->user_comments[ci], a->comment_lengths[ci]) != 0)
+         return 0;
+   }
+   return 1;
+}
+
+/* Compares everything the two handles know about the structure of the
+   stream */
+static int same_links(OggOpusFile *a, OggOpusFile *b)
+{
+   int li;
+   if (op_seekable(a) != op_seekable(b) || op_link_count(a) != op_link_count(b)
+         || op_pcm_total(a, -1) != op_pcm_total(b, -1)
+         || op_raw_total(a, -1) != op_raw_total(b, -1))
+      return 0;
+   for (li = 0; li < op_link_count(a); li++)
+   {
+      const OpusHead *ha = op_head(a, li);
+      const OpusHead *hb = op_head(b, li);
+      if (op_serialno(a, li) != op_serialno(b, li)
+            || op_pcm_total(a, li) != op_pcm_total(b, li)
+            || op_raw_total(a, li) != op_raw_total(b, li)
+            || op_bitrate(a, li) != op_bitrate(b, li)
+            || ha->version != hb->version || ha->channel_count != hb->channel_count
+            || ha->pre_skip != hb->pre_skip || ha->input_sample_rate != hb->input_sample_rate
+            || ha->output_gain != hb->output_gain || ha->mapping_family != hb->mapping_family
+            || ha->stream_count != hb->stream_count || ha->coupled_count != hb->coupled_count
+            || memcmp(ha->mapping, hb->mapping, ha->channel_count) != 0
+            || !same_tags(op_tags(a, li), op_tags(b, li)))
+         return 0;
+   }
+   return 1;
+}
+
+/* Decodes a stretch from the given position, with the track gain, on both
+   handles and compares the output */
+static int same_output(OggOpusFile *a, OggOpusFile *b, ogg_int64_t pos)
+{
+   float pa[READ_SIZE * 2], pb[READ_SIZE * 2];
+   int k, na, nb, li;
+   if (op_set_gain_offset(a, OP_TRACK_GAIN, 0) < 0 || op_set_gain_offset(b, OP_TRACK_GAIN, 0) < 0
+         || op_pcm_seek(a, pos) < 0 || op_pcm_seek(b, pos) < 0)
+      return 0;
+   for (k = 0; k < 20; k++)
+   {
+      na = op_read_float(a, pa, READ_SIZE * 2, &li);
+      nb = op_read_float(b, pb, READ_SIZE * 2, NULL);
+      if (na != nb || na < 0 || memcmp(pa, pb, na * op_channel_count(a, li) * sizeof(*pa)) != 0
+            || op_pcm_tell(a) != op_pcm_tell(b) || op_raw_tell(a) != op_raw_tell(b))
+         return 0;
+   }
+   return 1;
+}
+
+/* Opens other with info taken from a handle on m, and checks it ends up
+   exactly like a handle that scanned other on its own */
+static int check_mismatch(const mem_stream *m, const mem_stream *other, const char *what)
+{
+   mem_source src;
+   OggOpusFile *of, *scanned, *shared;
+   OpusFileInfo *info;
+   int ret = 0;
+   of = op_open_memory(m->data, m->length, NULL);
+   info = of != NULL ? op_file_info(of) : NULL;
+   scanned = op_open_memory(other->data, other->length, NULL);
+   shared = open_counted(&src, other, info);
+   if (info == NULL || scanned == NULL || shared == NULL || !same_links(scanned, shared)
+         || !same_output(scanned, shared, op_pcm_total(scanned, -1) - FS))
+   {
+      fprintf(stderr, "%s was not scanned like any other source\n", what);
+      ret = 1;
+   }
+   op_file_info_release(info);
+   op_free(of);
+   op_free(scanned);
+   op_free(shared);
+   return ret;
+}
+
+int main(void)
+{
+   mem_stream m = { NULL, 0, 0 };
+   mem_stream longer = { NULL, 0, 0 };
+   mem_stream other = { NULL, 0, 0 };
+   mem_source full_src, shared_src;
+   OggOpusFile *of, *full, *shared;
+   OpusFileInfo *info;
+   int err, ret = 0;
+
+   err = make_link(&m, 2, 0x1234, 300, "first");
+   if (err == 0)
+      err = make_link(&m, 1, 0x5678, 500, "second");
+   if (err == 0)
+      err = make_link(&m, 2, 0x9abc, 700, "third");
+   /* The same first link, then something else */
+   if (err == 0)
+      err = make_link(&longer, 2, 0x1234, 300, "first");
+   if (err == 0)
+      err = make_link(&longer, 2, 0x4444, 200, "other second");
+   if (err == 0)
+      err = make_link(&other, 1, 0x7777, 400, "other");
+   if (err < 0)
+   {
+      fprintf(stderr, "encoding failed: %d\n", err);
+      return 1;
+   }
+
+   of = op_open_memory(m.data, m.length, &err);
+   if (of == NULL)
+   {
+      fprintf(stderr, "opening failed: %d\n", err);
+      return 1;
+   }
+   info = op_file_info(of);
+   full = open_counted(&full_src, &m, NULL);
+   shared = open_counted(&shared_src, &m, info);
+   /* Both handles keep their own reference */
+   op_file_info_release(info);
+   op_free(of);
+   if (info == NULL || full == NULL || shared == NULL)
+   {
+      fprintf(stderr, "opening with shared information failed\n");
+      return 1;
+   }
+   if (!same_links(full, shared))
+   {
+      fprintf(stderr, "the shared information does not describe the same links\n");
+      ret = 1;
+   }
+   /* Opening should only have read the headers of the first link */
+   if (shared_src.nread * 4 > full_src.nread)
+   {
+      fprintf(stderr, "opening with shared information read %d bytes, a full scan %d\n",
+            (int)shared_src.nread, (int)full_src.nread);
+      ret = 1;
+   }
+   if (!same_output(full, shared, 0) || !same_output(full, shared, LINK_LEN + 1000)
+         || !same_output(full, shared, 3 * LINK_LEN - FS))
+   {
+      fprintf(stderr, "the handle using shared information decodes differently\n");
+      ret = 1;
+   }
+   op_free(full);
+   op_free(shared);
+
+   ret |= check_mismatch(&m, &longer, "a source with another second link");
+   ret |= check_mismatch(&m, &other, "a different source");
+
+   free(m.data);
+   free(longer.data);
+   free(other.data);
+   if (ret == 0)
+      printf("All shared file information tests passed\n");
+   return ret;
+}
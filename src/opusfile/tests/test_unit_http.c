@@ -0,0 +1,743 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks http streams against a Range server on the loopback interface.
+
+   A 14-link chained file is served over HTTP/1.1 with byte ranges and
+   persistent connections, and opened with the block cache off, on, and
+   with tiny (OP_HTTP_CACHE_BLOCK_SIZE(512)) blocks, with parallel fetching,
+   and with parallel fetching in non-blocking mode.  Each stream must see
+   the same links as the file opened from memory, decode the same samples
+   after each of NB_SEEKS random seeks, and decode the whole file the same
+   way.  Two streams sharing an OpusHTTPClient are then read in turns, and
+   a third one opened once they are gone must pick up one of their idle
+   connections instead of making as many new ones, and still be able to
+   open connections of its own when it seeks.
+
+   For each mode it prints how long opening, seeking and decoding took and
+   how many requests, connections and bytes the server saw.  By default
+   the server answers at once; run it as
+     test_unit_http <round trip ms> <bytes per second>
+   to delay every response and limit each connection's bandwidth.
+
+   This must be linked against libopusurl. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <winsock2.h>
+# include <ws2tcpip.h>
+# include <windows.h>
+typedef SOCKET test_sock;
+# define test_closesocket closesocket
+static double test_now(void)
+{
+   LARGE_INTEGER freq, count;
+   QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&count);
+   return (double)count.QuadPart / freq.QuadPart;
+}
+static void test_sleep(double seconds)
+{
+   if (seconds > 0)
+      Sleep((DWORD)(seconds * 1000 + 0.5));
+}
+static long test_add(volatile long *counter, long value)
+{
+   return InterlockedExchangeAdd(counter, value);
+}
+#else
+# include <time.h>
+# include <signal.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sys/select.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+typedef int test_sock;
+# define INVALID_SOCKET (-1)
+# define test_closesocket close
+static double test_now(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+static void test_sleep(double seconds)
+{
+   struct timespec ts;
+   if (seconds <= 0)
+      return;
+   ts.tv_sec = (time_t)seconds;
+   ts.tv_nsec = (long)((seconds - ts.tv_sec) * 1e9);
+   nanosleep(&ts, NULL);
+}
+static long test_add(volatile long *counter, long value)
+{
+   return __sync_fetch_and_add(counter, value);
+}
+#endif
+
+#define FS              48000
+#define NB_SHORT_LINKS  12
+#define NB_SEEKS        60
+#define READ_SIZE       (5760 * 2)
+#define MAX_REQUEST     4096
+
+/* The server state shared by all connections */
+typedef struct {
+   const unsigned char *data;
+   long                 size;
+   int                  rtt_ms;
+   long                 rate;
+   volatile long        nb_requests;
+   volatile long        nb_bytes;
+   volatile long        nb_conns;
+} test_server;
+
+typedef struct {
+   test_server *server;
+   test_sock    fd;
+} test_conn;
+
+typedef struct {
+   test_server *server;
+   test_sock    fd;
+} test_listener;
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+/* How to open the stream for one pass */
+typedef struct {
+   const char *name;
+   opus_int32  cache_size;
+   opus_int32  block_size;
+   int         parallel;
+   int         nconns;
+   int         nonblocking;
+} http_mode;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link of two tones with some noise */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, long length)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   long i, done;
+   int err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   pcm = (opus_int16 *)malloc(length * channels * sizeof(*pcm));
+   for (i = 0; i < length * channels; i++)
+   {
+      double f0 = 300.0 + 100 * (i % channels);
+      pcm[i] = (opus_int16)(8000 * sin(2 * M_PI * f0 * (i / channels) / FS) + rand() % 2000 - 1000);
+   }
+   for (done = 0; err == 0 && done < length;)
+   {
+      int ret = opw_write(w, pcm + done * channels, (int)(length - done < FS ? length - done : FS));
+      if (ret < 0)
+         err = ret;
+      else
+         done += ret;
+   }
+   if (err == 0)
+      while ((err = opw_drain(w)) == OP_FALSE);
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+/* Pulls in whatever the client has sent so far, without blocking unless
+   asked to, noting when the first request in an empty buffer arrived */
+static int conn_poll(test_sock fd, char *buf, int *len, double *arrival, int block)
+{
+   fd_set set;
+   struct timeval tv;
+   int ret;
+   if (!block)
+   {
+      FD_ZERO(&set);
+      FD_SET(fd, &set);
+      tv.tv_sec = 0;
+      tv.tv_usec = 0;
+      if (select((int)fd + 1, &set, NULL, NULL, &tv) <= 0)
+         return 0;
+   }
+   if (*len >= MAX_REQUEST - 1)
+      return -1;
+   ret = recv(fd, buf + *len, MAX_REQUEST - 1 - *len, 0);
+   if (ret <= 0)
+      return -1;
+   if (*len == 0)
+      *arrival = test_now();
+   *len += ret;
+   buf[*len] = '\0';
+   return ret;
+}
+
+static int conn_send(test_sock fd, const char *buf, long len)
+{
+   while (len > 0)
+   {
+      int ret = send(fd, buf, (int)(len < 65536 ? len : 65536), 0);
+      if (ret <= 0)
+         return -1;
+      buf += ret;
+      len -= ret;
+   }
+   return 0;
+}
+
+/* Answers requests on one connection until the client closes it, or until
+   after an HTTP/1.0 request.
+   The Server header is there because opusfile only pipelines requests to
+   servers that send one, and there is no Connection: close header after an
+   HTTP/1.0 request because that would turn pipelining off. */
+static void serve_conn(test_server *server, test_sock fd)
+{
+   char req[MAX_REQUEST];
+   int len = 0;
+   double arrival = 0;
+   double delay = 2 * server->rtt_ms / 1000.0;
+   req[0] = '\0';
+   test_add(&server->nb_conns, 1);
+   for (;;)
+   {
+      char header[256];
+      char *range, *end;
+      long start, stop, sent, slice;
+      double t0;
+      int header_len, req_len, close_after;
+      while ((end = strstr(req, "\r\n\r\n")) == NULL)
+      {
+         if (conn_poll(fd, req, &len, &arrival, 1) < 0)
+            return;
+      }
+      req_len = (int)(end + 4 - req);
+      close_after = strstr(req, "HTTP/1.0") != NULL && strstr(req, "HTTP/1.0") < end;
+      start = 0;
+      stop = server->size - 1;
+      range = strstr(req, "Range: bytes=");
+      if (range != NULL && range < end)
+      {
+         range += strlen("Range: bytes=");
+         start = strtol(range, &range, 10);
+         if (*range == '-' && range[1] >= '0' && range[1] <= '9')
+            stop = strtol(range + 1, NULL, 10);
+         if (stop > server->size - 1)
+            stop = server->size - 1;
+         header_len = sprintf(header, "HTTP/1.1 206 Partial Content\r\n"
+               "Content-Range: bytes %ld-%ld/%ld\r\n", start, stop, server->size);
+      }
+      else
+         header_len = sprintf(header, "HTTP/1.1 200 OK\r\n");
+      header_len += sprintf(header + header_len, "Content-Length: %ld\r\n"
+            "Content-Type: audio/ogg\r\nAccept-Ranges: bytes\r\n"
+            "Server: test_unit_http\r\n\r\n", stop - start + 1);
+      len -= req_len;
+      memmove(req, req + req_len, len + 1);
+      test_add(&server->nb_requests, 1);
+      /* The request and response each take half a round trip */
+      test_sleep(arrival + delay - test_now());
+      delay = server->rtt_ms / 1000.0;
+      if (conn_send(fd, header, header_len) < 0)
+         return;
+      /* Pace the body in 5 ms slices, picking up pipelined requests as they
+         come in */
+      slice = server->rate > 0 ? server->rate / 200 > 1024 ? server->rate / 200 : 1024 : stop + 1;
+      t0 = test_now();
+      for (sent = 0; start + sent <= stop;)
+      {
+         long n = stop + 1 - start - sent < slice ? stop + 1 - start - sent : slice;
+         if (server->rate > 0)
+            test_sleep(t0 + (double)sent / server->rate - test_now());
+         if (conn_send(fd, (const char *)server->data + start + sent, n) < 0)
+            return;
+         sent += n;
+         test_add(&server->nb_bytes, n);
+         while (conn_poll(fd, req, &len, &arrival, 0) > 0);
+      }
+      if (close_after)
+         return;
+   }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI conn_thread(LPVOID arg)
+#else
+static void *conn_thread(void *arg)
+#endif
+{
+   test_conn *conn = (test_conn *)arg;
+   serve_conn(conn->server, conn->fd);
+   test_closesocket(conn->fd);
+   free(conn);
+   return 0;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI accept_thread(LPVOID arg)
+#else
+static void *accept_thread(void *arg)
+#endif
+{
+   test_listener *listener = (test_listener *)arg;
+   for (;;)
+   {
+      test_conn *conn;
+      test_sock fd = accept(listener->fd, NULL, NULL);
+      if (fd == INVALID_SOCKET)
+         break;
+      conn = (test_conn *)malloc(sizeof(*conn));
+      conn->server = listener->server;
+      conn->fd = fd;
+      {
+#if defined(_WIN32)
+         HANDLE thread = CreateThread(NULL, 0, conn_thread, conn, 0, NULL);
+         if (thread != NULL)
+            CloseHandle(thread);
+#else
+         pthread_t thread;
+         if (pthread_create(&thread, NULL, conn_thread, conn) == 0)
+            pthread_detach(thread);
+#endif
+      }
+   }
+   return 0;
+}
+
+static int start_server(test_listener *listener, test_server *server)
+{
+   struct sockaddr_in addr;
+   socklen_t addr_len = sizeof(addr);
+   listener->server = server;
+   listener->fd = socket(AF_INET, SOCK_STREAM, 0);
+   if (listener->fd == INVALID_SOCKET)
+      return -1;
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   addr.sin_port = 0;
+   if (bind(listener->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0
+         || listen(listener->fd, 16) != 0
+         || getsockname(listener->fd, (struct sockaddr *)&addr, &addr_len) != 0)
+      return -1;
+   {
+#if defined(_WIN32)
+      HANDLE thread = CreateThread(NULL, 0, accept_thread, listener, 0, NULL);
+      if (thread == NULL)
+         return -1;
+      CloseHandle(thread);
+#else
+      pthread_t thread;
+      if (pthread_create(&thread, NULL, accept_thread, listener) != 0)
+         return -1;
+      pthread_detach(thread);
+#endif
+   }
+   return ntohs(addr.sin_port);
+}
+
+/* Waits for whatever a non-blocking stream is waiting on */
+static void wait_for(OggOpusFile *of)
+{
+   OpusPollFd fds[16];
+   opus_int32 timeout_ms;
+   fd_set rset, wset;
+   struct timeval tv;
+   int nfds, i;
+   test_sock max_fd = 0;
+   nfds = op_poll_fds(of, fds, 16, &timeout_ms);
+   if (nfds < 0)
+      return;
+   if (nfds > 16)
+      nfds = 16;
+   FD_ZERO(&rset);
+   FD_ZERO(&wset);
+   for (i = 0; i < nfds; i++)
+   {
+      test_sock fd = (test_sock)fds[i].fd;
+      if (fds[i].events & OP_POLLIN)
+         FD_SET(fd, &rset);
+      if (fds[i].events & OP_POLLOUT)
+         FD_SET(fd, &wset);
+      if (fd > max_fd)
+         max_fd = fd;
+   }
+   tv.tv_sec = timeout_ms < 0 ? 1 : timeout_ms / 1000;
+   tv.tv_usec = timeout_ms < 0 ? 0 : timeout_ms % 1000 * 1000;
+   select((int)max_fd + 1, &rset, &wset, NULL, &tv);
+}
+
+static OggOpusFile *open_mode(const char *url, const http_mode *mode,
+      OpusHTTPClient *client, int *err)
+{
+   OggOpusFile *of = op_open_url(url, err, OP_HTTP_CACHE_SIZE(mode->cache_size),
+         OP_HTTP_CACHE_BLOCK_SIZE(mode->block_size), OP_HTTP_PARALLEL_FETCH(mode->parallel),
+         OP_HTTP_MAX_CONNECTIONS(mode->nconns), OP_HTTP_NONBLOCKING(mode->nonblocking),
+         OP_HTTP_CLIENT(client), NULL);
+   while (of != NULL && *err == OP_EAGAIN)
+   {
+      wait_for(of);
+      *err = op_test_open(of);
+   }
+   if (of != NULL && *err != 0)
+   {
+      op_free(of);
+      of = NULL;
+   }
+   return of;
+}
+
+static int read_waiting(OggOpusFile *of, float *pcm, int size)
+{
+   int ret;
+   while ((ret = op_read_float_stereo(of, pcm, size)) == OP_EAGAIN)
+      wait_for(of);
+   return ret;
+}
+
+static int seek_waiting(OggOpusFile *of, ogg_int64_t pos)
+{
+   int ret;
+   while ((ret = op_pcm_seek(of, pos)) == OP_EAGAIN)
+      wait_for(of);
+   return ret;
+}
+
+/* Decodes the same amount from both handles and checks the samples match.
+   Returns the number of samples read, or -1 on a mismatch. */
+static int read_both(OggOpusFile *of, OggOpusFile *ref)
+{
+   static float pcm[READ_SIZE];
+   static float ref_pcm[READ_SIZE];
+   int n = read_waiting(of, pcm, READ_SIZE);
+   int ref_n = op_read_float_stereo(ref, ref_pcm, READ_SIZE);
+   if (n != ref_n || n < 0 || memcmp(pcm, ref_pcm, n * 2 * sizeof(*pcm)) != 0)
+      return -1;
+   return n;
+}
+
+static int same_links(OggOpusFile *of, OggOpusFile *ref)
+{
+   int li;
+   if (!op_seekable(of) || op_link_count(of) != op_link_count(ref)
+         || op_pcm_total(of, -1) != op_pcm_total(ref, -1)
+         || op_raw_total(of, -1) != op_raw_total(ref, -1))
+      return 0;
+   for (li = 0; li < op_link_count(ref); li++)
+   {
+      if (op_serialno(of, li) != op_serialno(ref, li)
+            || op_pcm_total(of, li) != op_pcm_total(ref, li))
+         return 0;
+   }
+   return 1;
+}
+
+/* Seeks both handles to NB_SEEKS random positions (every third one close to
+   the one before), decoding a little from each */
+static int seek_both(OggOpusFile *of, OggOpusFile *ref, unsigned seed)
+{
+   ogg_int64_t total = op_pcm_total(ref, -1);
+   ogg_int64_t pos = 0;
+   int s, j;
+   for (s = 0; s < NB_SEEKS; s++)
+   {
+      seed = seed * 1103515245 + 12345;
+      if (s % 3 == 2)
+         pos += (seed >> 16) % FS;
+      else
+         pos = (ogg_int64_t)((seed >> 8) / (double)(1 << 24) * (total - FS));
+      if (seek_waiting(of, pos) != 0 || op_pcm_seek(ref, pos) != 0)
+      {
+         fprintf(stderr, "seeking to %ld failed\n", (long)pos);
+         return -1;
+      }
+      for (j = 0; j < 3; j++)
+      {
+         if (read_both(of, ref) < 0)
+         {
+            fprintf(stderr, "seek %d to %ld decoded differently\n", s, (long)pos);
+            return -1;
+         }
+      }
+   }
+   return 0;
+}
+
+static int run_mode(test_server *server, const char *url, const mem_stream *m,
+      const http_mode *mode)
+{
+   OggOpusFile *of;
+   OggOpusFile *ref;
+   double t0, open_time, seek_time, full_time;
+   int err, n;
+   server->nb_requests = server->nb_bytes = server->nb_conns = 0;
+   t0 = test_now();
+   of = open_mode(url, mode, NULL, &err);
+   open_time = test_now() - t0;
+   ref = op_open_memory(m->data, m->length, NULL);
+   if (of == NULL || ref == NULL || !same_links(of, ref))
+   {
+      fprintf(stderr, "%s: opening the stream failed (%d)\n", mode->name, err);
+      op_free(of);
+      op_free(ref);
+      return -1;
+   }
+   t0 = test_now();
+   if (seek_both(of, ref, 7) < 0)
+   {
+      fprintf(stderr, "%s: seeking failed\n", mode->name);
+      op_free(of);
+      op_free(ref);
+      return -1;
+   }
+   seek_time = test_now() - t0;
+   while (op_raw_seek(of, 0) == OP_EAGAIN)
+      wait_for(of);
+   op_raw_seek(ref, 0);
+   t0 = test_now();
+   while ((n = read_both(of, ref)) > 0);
+   full_time = test_now() - t0;
+   op_free(of);
+   op_free(ref);
+   if (n < 0)
+   {
+      fprintf(stderr, "%s: decoding the whole stream failed\n", mode->name);
+      return -1;
+   }
+   printf("%-18s %9.1f %9.1f %9.1f %8ld %6ld %9.2f\n", mode->name, open_time * 1000,
+         seek_time * 1000, full_time * 1000, server->nb_requests, server->nb_conns,
+         server->nb_bytes / 1e6);
+   return 0;
+}
+
+/* Two streams sharing a client are read in turns, and a third one opened
+   with it after they are freed must need fewer new connections than the
+   same stream opened on its own */
+static int run_shared(test_server *server, const char *url, const mem_stream *m,
+      const http_mode *mode)
+{
+   OpusHTTPClient *client;
+   OggOpusFile *a, *b, *c;
+   OggOpusFile *ref_a, *ref_b;
+   long shared_conns, alone_conns;
+   int err, s, ret = -1;
+   client = op_http_client_create();
+   if (client == NULL)
+   {
+      fprintf(stderr, "creating the client failed\n");
+      return -1;
+   }
+   a = open_mode(url, mode, client, &err);
+   b = open_mode(url, mode, client, &err);
+   ref_a = op_open_memory(m->data, m->length, NULL);
+   ref_b = op_open_memory(m->data, m->length, NULL);
+   c = NULL;
+   if (a == NULL || b == NULL || ref_a == NULL || ref_b == NULL
+         || !same_links(a, ref_a) || !same_links(b, ref_b))
+   {
+      fprintf(stderr, "opening two streams with a shared client failed\n");
+      goto done;
+   }
+   for (s = 0; s < NB_SEEKS; s++)
+   {
+      if (s % 10 == 0)
+      {
+         ogg_int64_t pos = op_pcm_total(ref_a, -1) * s / NB_SEEKS;
+         if (seek_waiting(a, pos) != 0 || op_pcm_seek(ref_a, pos) != 0
+               || seek_waiting(b, pos / 2) != 0 || op_pcm_seek(ref_b, pos / 2) != 0)
+            break;
+      }
+      if (read_both(a, ref_a) < 0 || read_both(b, ref_b) < 0)
+         break;
+   }
+   if (s < NB_SEEKS)
+   {
+      fprintf(stderr, "streams sharing a client decoded differently\n");
+      goto done;
+   }
+   /* Finish both, so the connections that read the end of the file are
+      left between requests, and hand them back to the client */
+   while ((s = read_both(a, ref_a)) > 0);
+   while (s == 0 && (s = read_both(b, ref_b)) > 0);
+   if (s < 0)
+   {
+      fprintf(stderr, "streams sharing a client decoded differently\n");
+      goto done;
+   }
+   op_free(a);
+   op_free(b);
+   a = b = NULL;
+   server->nb_conns = 0;
+   c = open_mode(url, mode, client, &err);
+   shared_conns = server->nb_conns;
+   /* The stream holds its own reference */
+   op_http_client_release(client);
+   client = NULL;
+   /* It must also be able to open connections of its own once it has used up
+      the idle ones */
+   if (c == NULL || seek_both(c, ref_a, 11) < 0)
+   {
+      fprintf(stderr, "reusing the client's connections failed\n");
+      goto done;
+   }
+   op_free(c);
+   server->nb_conns = 0;
+   c = open_mode(url, mode, NULL, &err);
+   alone_conns = server->nb_conns;
+   if (c == NULL || seek_both(c, ref_a, 11) < 0)
+   {
+      fprintf(stderr, "opening the stream on its own failed\n");
+      goto done;
+   }
+   printf("shared client: opening made %ld new connections, %ld without it\n",
+         shared_conns, alone_conns);
+   if (shared_conns >= alone_conns)
+      fprintf(stderr, "the shared client did not reuse any connections\n");
+   else
+      ret = 0;
+done:
+   op_free(a);
+   op_free(b);
+   op_free(c);
+   op_free(ref_a);
+   op_free(ref_b);
+   op_http_client_release(client);
+   return ret;
+}
+
+int main(int argc, char **argv)
+{
+   static const http_mode modes[] = {
+      { "no cache",                  0, 32768, 0, 4, 0 },
+      { "cache",               1 << 20, 32768, 0, 4, 0 },
+      { "cache, 512 B blocks",  64 << 10,  512, 0, 4, 0 },
+      { "parallel",            1 << 20, 32768, 1, 4, 0 },
+      { "parallel, 512 B",     256 << 10,  512, 1, 8, 0 },
+      { "parallel, nonblock",  1 << 20, 16384, 1, 8, 1 }
+   };
+   test_server server;
+   test_listener listener;
+   mem_stream m = { NULL, 0, 0 };
+   char url[64];
+   int port, i, ret;
+   memset(&server, 0, sizeof(server));
+   if (argc == 3)
+   {
+      server.rtt_ms = atoi(argv[1]);
+      server.rate = atol(argv[2]);
+   }
+   if (argc != 1 && (argc != 3 || server.rtt_ms < 0 || server.rate < 1000))
+   {
+      fprintf(stderr, "Usage: %s [<round trip ms> <bytes per second>]\n", argv[0]);
+      return 1;
+   }
+#if defined(_WIN32)
+   {
+      WSADATA wsa;
+      if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
+         return 1;
+   }
+#else
+   signal(SIGPIPE, SIG_IGN);
+#endif
+   srand(1);
+   for (i = 0; i < NB_SHORT_LINKS; i++)
+   {
+      if (make_link(&m, 2, i + 1, 2 * FS + 7 * i) != 0)
+         break;
+   }
+   if (i < NB_SHORT_LINKS || make_link(&m, 2, 100, 60 * FS + 123) != 0
+         || make_link(&m, 1, 200, 20 * FS + 77) != 0)
+   {
+      fprintf(stderr, "encoding failed\n");
+      return 1;
+   }
+   server.data = m.data;
+   server.size = m.length;
+   port = start_server(&listener, &server);
+   if (port < 0)
+   {
+      fprintf(stderr, "starting the server failed\n");
+      return 1;
+   }
+   sprintf(url, "http://127.0.0.1:%d/test.opus", port);
+   printf("%ld byte file, %d links, %d seeks per run\n", (long)m.length,
+         NB_SHORT_LINKS + 2, NB_SEEKS);
+   printf("%-18s %9s %9s %9s %8s %6s %9s\n", "mode", "open ms", "seek ms", "full ms",
+         "requests", "conns", "MB read");
+   for (i = 0; i < (int)(sizeof(modes) / sizeof(*modes)); i++)
+   {
+      if (run_mode(&server, url, &m, &modes[i]) < 0)
+         return 1;
+   }
+   ret = run_shared(&server, url, &m, &modes[0]);
+   /* The server only touches the file while answering a request */
+   free(m.data);
+   if (ret < 0)
+      return 1;
+   fprintf(stdout, "All http stream tests passed\n");
+   return 0;
+}
@@ -0,0 +1,389 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that pipelined decoding (op_set_pipeline()) produces exactly the
+   samples a serial decode does, on a chained stream whose links have
+   different channel counts, with the smallest possible queue and with a
+   deep one: reading straight through, reading from an unseekable source,
+   seeking during playback (including short forward seeks that land inside
+   the queue), and changing the gain while the decoder runs ahead, which
+   must switch from the old gain to the new one at a single point at or
+   after the current playback position. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define LINK_LEN    (3 * FS)
+#define MAX_LEN     (2 * LINK_LEN)
+#define DEPTH       (FS / 2)
+#define MAX_READ    2000
+#define GAIN_Q8     (-1536)
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+typedef struct {
+   const unsigned char *data;
+   opus_int32 length;
+   opus_int32 pos;
+} mem_source;
+
+/* Decoded audio, flattened: links with different channel counts are simply
+   concatenated, which is enough to compare two decodes */
+typedef struct {
+   float *pcm;
+   opus_int32 nfloats;
+   /* Where each sample starts in pcm */
+   opus_int32 *offset;
+   opus_int32 nsamples;
+} decoded;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link with its own serial number */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, double f0)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   int i, c, err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   pcm = (opus_int16 *)malloc(LINK_LEN * channels * sizeof(*pcm));
+   for (i = 0; i < LINK_LEN; i++)
+   {
+      double t = (double)i / FS;
+      for (c = 0; c < channels; c++)
+         pcm[channels * i + c] = (opus_int16)(7000
+               * sin(2 * M_PI * (f0 * (c + 1) + 50 * sin(2 * M_PI * t)) * t));
+   }
+   if (err == 0)
+      err = opw_write(w, pcm, LINK_LEN);
+   if (err == LINK_LEN)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+static int mem_read(void *stream, unsigned char *ptr, int nbytes)
+{
+   mem_source *s = (mem_source *)stream;
+   if (nbytes > s->length - s->pos)
+      nbytes = s->length - s->pos;
+   memcpy(ptr, s->data + s->pos, nbytes);
+   s->pos += nbytes;
+   return nbytes;
+}
+
+static void decoded_init(decoded *d)
+{
+   d->pcm = (float *)malloc((MAX_LEN + 2 * MAX_READ) * 2 * sizeof(*d->pcm));
+   d->offset = (opus_int32 *)malloc((MAX_LEN + 2 * MAX_READ + 1) * sizeof(*d->offset));
+   d->nfloats = 0;
+   d->nsamples = 0;
+   d->offset[0] = 0;
+}
+
+static void decoded_clear(decoded *d)
+{
+   free(d->pcm);
+   free(d->offset);
+}
+
+/* Reads up to n samples per channel, with a read size that changes from one
+   call to the next so that reads end at all sorts of places in the queue.
+   Returns the number of samples read, or a negative value on error. */
+static opus_int32 read_some(OggOpusFile *of, decoded *d, opus_int32 n, unsigned *seed)
+{
+   opus_int32 total = 0;
+   while (total < n && d->nsamples < MAX_LEN)
+   {
+      int size, ret, li, channels, i;
+      *seed = *seed * 1103515245u + 12345u;
+      size = 1 + (int)((*seed >> 16) % MAX_READ);
+      if (size > n - total)
+         size = n - total;
+      ret = op_read_float(of, d->pcm + d->nfloats, 2 * size, &li);
+      if (ret < 0)
+         return ret;
+      if (ret == 0)
+         break;
+      channels = op_channel_count(of, li);
+      for (i = 0; i < ret; i++)
+      {
+         d->nfloats += channels;
+         d->offset[++d->nsamples] = d->nfloats;
+      }
+      total += ret;
+   }
+   return total;
+}
+
+/* Returns the index of the first sample that differs, or -1 */
+static opus_int32 first_diff(const decoded *a, opus_int32 a0, const decoded *b,
+      opus_int32 b0, opus_int32 n)
+{
+   opus_int32 i;
+   for (i = 0; i < n; i++)
+   {
+      opus_int32 na = a->offset[a0 + i + 1] - a->offset[a0 + i];
+      if (na != b->offset[b0 + i + 1] - b->offset[b0 + i]
+            || memcmp(a->pcm + a->offset[a0 + i], b->pcm + b->offset[b0 + i],
+               na * sizeof(*a->pcm)) != 0)
+         return i;
+   }
+   return -1;
+}
+
+static int check_equal(const decoded *ref, const decoded *d, const char *what,
+      opus_int32 depth)
+{
+   opus_int32 diff;
+   if (d->nsamples != ref->nsamples)
+   {
+      fprintf(stderr, "%s with depth %d: got %d samples instead of %d\n",
+            what, (int)depth, (int)d->nsamples, (int)ref->nsamples);
+      return 1;
+   }
+   diff = first_diff(ref, 0, d, 0, ref->nsamples);
+   if (diff >= 0)
+   {
+      fprintf(stderr, "%s with depth %d: sample %d differs\n", what, (int)depth, (int)diff);
+      return 1;
+   }
+   return 0;
+}
+
+/* Plays the stream, seeking around between reads, with the same sequence of
+   reads and seeks for any depth (0 meaning no pipelining) */
+static int play_with_seeks(const mem_stream *m, opus_int32 depth, decoded *d)
+{
+   OggOpusFile *of;
+   ogg_int64_t total;
+   unsigned seed = 1;
+   int k, ret = 0;
+   of = op_open_memory(m->data, m->length, NULL);
+   if (of == NULL)
+      return 1;
+   if (depth > 0 && op_set_pipeline(of, depth) < 0)
+      ret = 1;
+   total = op_pcm_total(of, -1);
+   for (k = 0; k < 24 && ret == 0; k++)
+   {
+      ogg_int64_t target;
+      if (read_some(of, d, 3000 + 997 * (k % 5), &seed) < 0)
+         ret = 1;
+      if (k % 3 == 0)
+         /* A short hop forward, possibly still inside the queue */
+         target = op_pcm_tell(of) + 100 + 331 * k;
+      else
+         /* Anywhere, including across the link boundary */
+         target = (k * 7919 * 53) % total;
+      if (target >= total)
+         target = total - 1;
+      if (op_pcm_seek(of, target) < 0 || op_pcm_tell(of) != target)
+         ret = 1;
+   }
+   if (ret == 0 && read_some(of, d, MAX_LEN, &seed) < 0)
+      ret = 1;
+   op_free(of);
+   return ret;
+}
+
+/* Plays the whole stream, optionally from an unseekable source, optionally
+   changing the gain partway through.  Returns the playback position at the
+   time of the change in *changed_at. */
+static int play(const mem_stream *m, opus_int32 depth, int seekable, opus_int32 gain_at,
+      opus_int32 gain_q8, decoded *d, opus_int32 *changed_at)
+{
+   static const OpusFileCallbacks cb = { mem_read, NULL, NULL, NULL };
+   mem_source src;
+   OggOpusFile *of;
+   unsigned seed = 2;
+   int ret = 0;
+   src.data = m->data;
+   src.length = m->length;
+   src.pos = 0;
+   if (seekable)
+      of = op_open_memory(m->data, m->length, NULL);
+   else
+      of = op_open_callbacks(&src, &cb, NULL, 0, NULL);
+   if (of == NULL)
+      return 1;
+   if (depth > 0 && op_set_pipeline(of, depth) < 0)
+      ret = 1;
+   if (gain_at < 0 && gain_q8 != 0 && op_set_gain_offset(of, OP_HEADER_GAIN, gain_q8) < 0)
+      ret = 1;
+   if (gain_at >= 0)
+   {
+      if (read_some(of, d, gain_at, &seed) < 0)
+         ret = 1;
+      *changed_at = d->nsamples;
+      if (op_set_gain_offset(of, OP_HEADER_GAIN, gain_q8) < 0)
+         ret = 1;
+   }
+   if (ret == 0 && read_some(of, d, MAX_LEN, &seed) < 0)
+      ret = 1;
+   op_free(of);
+   return ret;
+}
+
+/* The output has to follow the old gain, then the new one, switching no
+   earlier than where the change was made, and no later than what was already
+   decoded at that point.  The queue holds at least one maximum-size packet
+   for the widest possible link (any link of a seekable stream, or 8 channels
+   for an unseekable one), rounded up to a power of two, which the mono link
+   fills with that many samples, and the decoder holds one more packet. */
+static int check_gain_switch(const decoded *old_gain, const decoded *new_gain,
+      const decoded *d, opus_int32 changed_at, opus_int32 depth, int nchannels_max)
+{
+   opus_int32 split, diff, limit;
+   for (limit = 1; limit < (depth > 5760 ? depth : 5760) * nchannels_max; limit <<= 1);
+   limit += 5760;
+   if (d->nsamples != old_gain->nsamples)
+   {
+      fprintf(stderr, "gain change with depth %d: got %d samples instead of %d\n",
+            (int)depth, (int)d->nsamples, (int)old_gain->nsamples);
+      return 1;
+   }
+   split = first_diff(old_gain, 0, d, 0, d->nsamples);
+   if (split < 0 || split < changed_at || split > changed_at + limit)
+   {
+      fprintf(stderr, "gain change with depth %d at %d took effect at %d\n",
+            (int)depth, (int)changed_at, (int)split);
+      return 1;
+   }
+   diff = first_diff(new_gain, split, d, split, d->nsamples - split);
+   if (diff >= 0)
+   {
+      fprintf(stderr, "gain change with depth %d: sample %d matches neither gain\n",
+            (int)depth, (int)(split + diff));
+      return 1;
+   }
+   return 0;
+}
+
+int main(void)
+{
+   static const opus_int32 depths[2] = { 1, DEPTH };
+   mem_stream m = { NULL, 0, 0 };
+   decoded ref, ref_gain, ref_seek, d;
+   opus_int32 changed_at;
+   int i, err, ret = 0;
+
+   err = make_link(&m, 2, 0x1234, 300);
+   if (err == 0)
+      err = make_link(&m, 1, 0x5678, 500);
+   if (err < 0)
+   {
+      fprintf(stderr, "encoding failed: %d\n", err);
+      return 1;
+   }
+
+   decoded_init(&ref);
+   decoded_init(&ref_gain);
+   decoded_init(&ref_seek);
+   ret |= play(&m, 0, 1, -1, 0, &ref, &changed_at);
+   ret |= play(&m, 0, 1, -1, GAIN_Q8, &ref_gain, &changed_at);
+   ret |= play_with_seeks(&m, 0, &ref_seek);
+   if (ret || ref.nsamples != 2 * LINK_LEN)
+   {
+      fprintf(stderr, "serial decoding failed\n");
+      return 1;
+   }
+
+   for (i = 0; i < 2; i++)
+   {
+      decoded_init(&d);
+      ret |= play(&m, depths[i], 1, -1, 0, &d, &changed_at);
+      ret |= check_equal(&ref, &d, "seekable", depths[i]);
+      decoded_clear(&d);
+
+      decoded_init(&d);
+      ret |= play(&m, depths[i], 0, -1, 0, &d, &changed_at);
+      ret |= check_equal(&ref, &d, "unseekable", depths[i]);
+      decoded_clear(&d);
+
+      decoded_init(&d);
+      ret |= play_with_seeks(&m, depths[i], &d);
+      ret |= check_equal(&ref_seek, &d, "seeking", depths[i]);
+      decoded_clear(&d);
+
+      /* Change the gain in each link, on both kinds of source */
+      decoded_init(&d);
+      ret |= play(&m, depths[i], 1, FS, GAIN_Q8, &d, &changed_at);
+      ret |= check_gain_switch(&ref, &ref_gain, &d, changed_at, depths[i], 2);
+      decoded_clear(&d);
+
+      decoded_init(&d);
+      ret |= play(&m, depths[i], 0, LINK_LEN + FS, GAIN_Q8, &d, &changed_at);
+      ret |= check_gain_switch(&ref, &ref_gain, &d, changed_at, depths[i], 8);
+      decoded_clear(&d);
+   }
+
+   decoded_clear(&ref);
+   decoded_clear(&ref_gain);
+   decoded_clear(&ref_seek);
+   free(m.data);
+   if (ret == 0)
+      printf("All pipelined decoding tests passed\n");
+   return ret;
+}
@@ -0,0 +1,232 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks op_read_all_float() against a serial decode with op_read_float() on
+   a chained stream whose links have different channel counts: with one
+   thread the output must be bit-exact, with several it must have the same
+   layout and only differ slightly where a segment starts mid-link, and
+   either way the position of the handle must be left alone. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define LINK_LEN    (10 * FS)
+#define MAX_LEN     (2 * LINK_LEN)
+#define READ_SIZE   960
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link with its own serial number.
+   The tones have some noise mixed in: after a seek, SILK's long-term
+   predictor can take far longer than the pre-roll to settle on a pure tone. */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, double f0)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   opus_uint32 seed = serialno;
+   int i, c, err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   pcm = (opus_int16 *)malloc(LINK_LEN * channels * sizeof(*pcm));
+   for (i = 0; i < LINK_LEN; i++)
+   {
+      double t = (double)i / FS;
+      for (c = 0; c < channels; c++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         pcm[channels * i + c] = (opus_int16)(7000
+               * sin(2 * M_PI * (f0 * (c + 1) + 50 * sin(2 * M_PI * t)) * t)
+               + (int)(seed >> 20) - 2048);
+      }
+   }
+   if (err == 0)
+      err = opw_write(w, pcm, LINK_LEN);
+   if (err == LINK_LEN)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+/* Reads to the end with op_read_float(), appending to pcm.
+   Returns the number of values stored, or a negative value on error. */
+static opus_int32 read_to_end(OggOpusFile *of, float *pcm, opus_int32 size)
+{
+   opus_int32 n = 0;
+   int ret, li;
+   while (n + READ_SIZE * 2 <= size
+         && (ret = op_read_float(of, pcm + n, READ_SIZE * 2, &li)) > 0)
+      n += ret * op_channel_count(of, li);
+   return ret < 0 ? ret : n;
+}
+
+int main(void)
+{
+   mem_stream m = { NULL, 0, 0 };
+   OggOpusFile *of, *seeked;
+   float *ref, *all;
+   opus_int32 nref, size, nvalues, part, i;
+   ogg_int64_t ret;
+   double err2, sig2;
+   int li, err, fail = 0;
+
+   err = make_link(&m, 2, 0x1234, 300);
+   if (err == 0)
+      err = make_link(&m, 1, 0x5678, 500);
+   if (err < 0)
+   {
+      fprintf(stderr, "encoding failed: %d\n", err);
+      return 1;
+   }
+   of = op_open_memory(m.data, m.length, &err);
+   if (of == NULL)
+   {
+      fprintf(stderr, "opening failed: %d\n", err);
+      return 1;
+   }
+   nvalues = 0;
+   for (li = 0; li < op_link_count(of); li++)
+      nvalues += (opus_int32)op_pcm_total(of, li) * op_channel_count(of, li);
+   size = MAX_LEN * 2;
+   ref = (float *)malloc(size * sizeof(*ref));
+   all = (float *)malloc(size * sizeof(*all));
+   nref = read_to_end(of, ref, size);
+   if (nref != nvalues)
+   {
+      fprintf(stderr, "serial decoding gave %d values instead of %d\n", (int)nref, (int)nvalues);
+      return 1;
+   }
+
+   /* Start from the middle of the first link, to check the position is left
+      alone */
+   if (op_pcm_seek(of, LINK_LEN / 2) < 0)
+      fail = 1;
+
+   /* One thread decodes each link from its start, just like op_read_float() */
+   memset(all, 0, size * sizeof(*all));
+   ret = op_read_all_float(of, all, size, 1);
+   if (ret != op_pcm_total(of, -1) || memcmp(all, ref, nvalues * sizeof(*all)) != 0)
+   {
+      fprintf(stderr, "decoding with one thread differs from op_read_float()\n");
+      fail = 1;
+   }
+
+   /* Several threads start some segments mid-link, with pre-roll, which only
+      converges to the serial decode */
+   memset(all, 0, size * sizeof(*all));
+   ret = op_read_all_float(of, all, size, 4);
+   err2 = sig2 = 0;
+   for (i = 0; i < nvalues; i++)
+   {
+      err2 += (all[i] - ref[i]) * (double)(all[i] - ref[i]);
+      sig2 += ref[i] * (double)ref[i];
+   }
+   if (ret != op_pcm_total(of, -1) || err2 > sig2 * 1e-4)
+   {
+      fprintf(stderr, "decoding with four threads returned %d, error/signal %g\n",
+            (int)ret, sig2 > 0 ? err2 / sig2 : 0);
+      fail = 1;
+   }
+   /* The first segment always starts with the stream */
+   if (memcmp(all, ref, FS / 10 * 2 * sizeof(*all)) != 0)
+   {
+      fprintf(stderr, "decoding with four threads changed the start of the stream\n");
+      fail = 1;
+   }
+
+   /* A buffer that is one value short is refused */
+   if (op_read_all_float(of, all, nvalues - 1, 1) != OP_EINVAL)
+   {
+      fprintf(stderr, "a short buffer was not refused\n");
+      fail = 1;
+   }
+
+   /* Reading carries on from where it was */
+   if (op_pcm_tell(of) != LINK_LEN / 2)
+   {
+      fprintf(stderr, "op_read_all_float() moved the position to %d\n", (int)op_pcm_tell(of));
+      fail = 1;
+   }
+   /* Decoding after a seek starts with pre-roll, so compare with another
+      handle that made the same seek */
+   part = read_to_end(of, all, size);
+   seeked = op_open_memory(m.data, m.length, NULL);
+   if (seeked == NULL || op_pcm_seek(seeked, LINK_LEN / 2) < 0
+         || read_to_end(seeked, ref, size) != part
+         || part != nvalues - LINK_LEN / 2 * 2
+         || memcmp(all, ref, part * sizeof(*all)) != 0)
+   {
+      fprintf(stderr, "reading after op_read_all_float() did not carry on correctly\n");
+      fail = 1;
+   }
+
+   op_free(seeked);
+   op_free(of);
+   free(ref);
+   free(all);
+   free(m.data);
+   if (fail == 0)
+      printf("All whole-file decoding tests passed\n");
+   return fail;
+}
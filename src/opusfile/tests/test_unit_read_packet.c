@@ -0,0 +1,331 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that the packets op_read_packet() returns, decoded with a decoder
+   of our own and trimmed by the discard_start and discard_end it reports,
+   reproduce exactly what op_read_float() outputs: from the start of a
+   chained stream (pre-skip and end trimming in each link), from an
+   unseekable source, and after seeks (pre-roll).  The reported PCM offsets,
+   link indices and granule positions have to line up as well. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define LINK_LEN    (2 * FS + 777)
+#define MAX_LEN     (2 * LINK_LEN)
+#define READ_SIZE   960
+#define MAX_FRAME   5760
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+typedef struct {
+   const unsigned char *data;
+   opus_int32 length;
+   opus_int32 pos;
+} mem_source;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link with its own serial number, a length that is not a
+   whole number of frames (so the last packet is trimmed) and a non-zero
+   output gain */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, double f0)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   opus_uint32 seed = serialno;
+   int i, c, err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   if (err == 0)
+      err = opw_set_frame_size(w, channels == 1 ? FS / 100 : FS / 25);
+   pcm = (opus_int16 *)malloc(LINK_LEN * channels * sizeof(*pcm));
+   for (i = 0; i < LINK_LEN; i++)
+   {
+      double t = (double)i / FS;
+      for (c = 0; c < channels; c++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         pcm[channels * i + c] = (opus_int16)(7000
+               * sin(2 * M_PI * (f0 * (c + 1) + 50 * sin(2 * M_PI * t)) * t)
+               + (int)(seed >> 20) - 2048);
+      }
+   }
+   if (err == 0)
+      err = opw_write(w, pcm, LINK_LEN);
+   if (err == LINK_LEN)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+static int mem_read(void *stream, unsigned char *ptr, int nbytes)
+{
+   mem_source *s = (mem_source *)stream;
+   if (nbytes > s->length - s->pos)
+      nbytes = s->length - s->pos;
+   memcpy(ptr, s->data + s->pos, nbytes);
+   s->pos += nbytes;
+   return nbytes;
+}
+
+static OggOpusFile *open_stream(const mem_stream *m, mem_source *src, int seekable)
+{
+   static const OpusFileCallbacks cb = { mem_read, NULL, NULL, NULL };
+   if (seekable)
+      return op_open_memory(m->data, m->length, NULL);
+   src->data = m->data;
+   src->length = m->length;
+   src->pos = 0;
+   return op_open_callbacks(src, &cb, NULL, 0, NULL);
+}
+
+/* Reads to the end with op_read_float().
+   Returns the number of values stored, or a negative value on error. */
+static opus_int32 read_to_end(OggOpusFile *of, float *pcm, opus_int32 size)
+{
+   opus_int32 n = 0;
+   int ret, li;
+   while (n + READ_SIZE * 2 <= size
+         && (ret = op_read_float(of, pcm + n, READ_SIZE * 2, &li)) > 0)
+      n += ret * op_channel_count(of, li);
+   return ret < 0 ? ret : n;
+}
+
+/* Reads to the end with op_read_packet() and decodes the packets, with a new
+   decoder for every link, as an application relaying them would.
+   Returns the number of values stored, or a negative value on error. */
+static opus_int32 relay_to_end(OggOpusFile *of, float *pcm, opus_int32 size)
+{
+   static float buf[MAX_FRAME * 2];
+   OpusMSDecoder *dec = NULL;
+   const OpusHead *head = NULL;
+   ogg_packet op;
+   OpusPacketInfo info;
+   ogg_int64_t pcm_offset, prev_gp = -1;
+   opus_int32 n = 0;
+   int li = -1, ret, err;
+   for (;;)
+   {
+      pcm_offset = op_pcm_tell(of);
+      ret = op_read_packet(of, &op, &info);
+      if (ret <= 0)
+         break;
+      int nsamples, nout;
+      if (info.li != li)
+      {
+         /* An unseekable stream counts the position from the start of each
+            link */
+         if (li >= 0 && !op_seekable(of))
+            pcm_offset = 0;
+         li = info.li;
+         head = op_head(of, li);
+         opus_multistream_decoder_destroy(dec);
+         dec = opus_multistream_decoder_create(FS, head->channel_count, head->stream_count,
+               head->coupled_count, head->mapping, &err);
+         if (dec == NULL)
+            return err;
+         opus_multistream_decoder_ctl(dec, OPUS_SET_GAIN(head->output_gain));
+         prev_gp = -1;
+      }
+      if (info.pcm_offset != pcm_offset)
+      {
+         fprintf(stderr, "packet said it starts at %d instead of %d\n",
+               (int)info.pcm_offset, (int)pcm_offset);
+         ret = OP_EINVAL;
+         break;
+      }
+      nsamples = opus_multistream_decode_float(dec, op.packet, op.bytes, buf, MAX_FRAME, 0);
+      if (nsamples != info.duration || info.discard_start < 0 || info.discard_end < 0
+            || info.discard_start + info.discard_end > nsamples)
+      {
+         fprintf(stderr, "packet of %d samples decoded to %d, discarding %d and %d\n",
+               info.duration, nsamples, info.discard_start, info.discard_end);
+         ret = OP_EINVAL;
+         break;
+      }
+      /* Every packet carries the granule position of its end, so it moves on
+         by the duration of the packet, less any end trimming */
+      if (prev_gp >= 0 && op.granulepos - prev_gp != nsamples - info.discard_end)
+      {
+         fprintf(stderr, "packet at %d has granule position %d after %d\n",
+               (int)pcm_offset, (int)op.granulepos, (int)prev_gp);
+         ret = OP_EINVAL;
+         break;
+      }
+      prev_gp = op.granulepos;
+      nout = (nsamples - info.discard_start - info.discard_end) * head->channel_count;
+      if (n + nout > size)
+         break;
+      memcpy(pcm + n, buf + info.discard_start * head->channel_count, nout * sizeof(*pcm));
+      n += nout;
+      /* The position moves on past the samples the packet outputs */
+      if (op_pcm_tell(of) != info.pcm_offset + nsamples - info.discard_start - info.discard_end)
+      {
+         fprintf(stderr, "the position moved from %d to %d over a packet of %d samples\n",
+               (int)info.pcm_offset, (int)op_pcm_tell(of), nsamples);
+         ret = OP_EINVAL;
+         break;
+      }
+   }
+   opus_multistream_decoder_destroy(dec);
+   return ret < 0 ? ret : n;
+}
+
+static int compare(const float *ref, opus_int32 nref, const float *pcm, opus_int32 n,
+      const char *what)
+{
+   opus_int32 i;
+   if (n != nref)
+   {
+      fprintf(stderr, "%s: got %d values instead of %d\n", what, (int)n, (int)nref);
+      return 1;
+   }
+   for (i = 0; i < n && pcm[i] == ref[i]; i++);
+   if (i < n)
+   {
+      fprintf(stderr, "%s: value %d differs\n", what, (int)i);
+      return 1;
+   }
+   return 0;
+}
+
+int main(void)
+{
+   mem_stream m = { NULL, 0, 0 };
+   mem_source src_ref, src;
+   OggOpusFile *ref_of, *of;
+   ogg_packet op;
+   float *ref, *pcm;
+   opus_int32 size, nref, n;
+   int seekable, k, err, ret = 0;
+
+   err = make_link(&m, 2, 0x1234, 300);
+   if (err == 0)
+      err = make_link(&m, 1, 0x5678, 500);
+   if (err < 0)
+   {
+      fprintf(stderr, "encoding failed: %d\n", err);
+      return 1;
+   }
+   size = MAX_LEN * 2;
+   ref = (float *)malloc(size * sizeof(*ref));
+   pcm = (float *)malloc(size * sizeof(*pcm));
+
+   /* Straight through, with pre-skip and end trimming in both links */
+   for (seekable = 0; seekable < 2; seekable++)
+   {
+      ref_of = open_stream(&m, &src_ref, seekable);
+      of = open_stream(&m, &src, seekable);
+      if (ref_of == NULL || of == NULL)
+      {
+         fprintf(stderr, "opening failed\n");
+         return 1;
+      }
+      nref = read_to_end(ref_of, ref, size);
+      n = relay_to_end(of, pcm, size);
+      ret |= compare(ref, nref, pcm, n, seekable ? "seekable" : "unseekable");
+      if (op_read_packet(of, &op, NULL) != 0)
+      {
+         fprintf(stderr, "op_read_packet() did not return 0 at the end\n");
+         ret = 1;
+      }
+      op_free(ref_of);
+      op_free(of);
+   }
+
+   /* After seeks, with pre-roll, into either link and close to the end */
+   for (k = 0; k < 8; k++)
+   {
+      ogg_int64_t target = (ogg_int64_t)(2 * LINK_LEN - 100) * k * k / 49;
+      ref_of = op_open_memory(m.data, m.length, NULL);
+      of = op_open_memory(m.data, m.length, NULL);
+      if (ref_of == NULL || of == NULL || op_pcm_seek(ref_of, target) < 0
+            || op_pcm_seek(of, target) < 0)
+      {
+         fprintf(stderr, "seeking to %d failed\n", (int)target);
+         return 1;
+      }
+      nref = read_to_end(ref_of, ref, size);
+      n = relay_to_end(of, pcm, size);
+      ret |= compare(ref, nref, pcm, n, "after a seek");
+      op_free(ref_of);
+      op_free(of);
+   }
+
+   /* Packets can't be taken from under the pipelined decoder */
+   of = op_open_memory(m.data, m.length, NULL);
+   if (of == NULL || op_set_pipeline(of, FS) < 0 || op_read_packet(of, &op, NULL) != OP_EINVAL)
+   {
+      fprintf(stderr, "op_read_packet() did not refuse to run with pipelined decoding\n");
+      ret = 1;
+   }
+   op_free(of);
+
+   free(ref);
+   free(pcm);
+   free(m.data);
+   if (ret == 0)
+      printf("All packet relaying tests passed\n");
+   return ret;
+}
@@ -0,0 +1,259 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that op_set_seamless_links() only changes the first 10 ms of each
+   link that follows a link with the same channel count, and nothing else:
+   not the length of the stream, not a link that changes the channel count,
+   and not the samples right after a seek into the crossfade.  Unseekable
+   sources have to be crossfaded the same way. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define LINK_LEN    (FS + 555)
+#define NLINKS      4
+#define MAX_LEN     (NLINKS * LINK_LEN)
+#define XFADE       (FS / 100)
+#define READ_SIZE   960
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+typedef struct {
+   const unsigned char *data;
+   opus_int32 length;
+   opus_int32 pos;
+} mem_source;
+
+/* Decoded audio, with the channel count and the offset of each sample */
+typedef struct {
+   float pcm[(MAX_LEN + READ_SIZE) * 2];
+   opus_int32 offset[MAX_LEN + 2 * READ_SIZE + 1];
+   int channels[MAX_LEN + 2 * READ_SIZE];
+   opus_int32 nsamples;
+} decoded;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link with its own serial number */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, double f0)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   int i, c, err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   pcm = (opus_int16 *)malloc(LINK_LEN * channels * sizeof(*pcm));
+   for (i = 0; i < LINK_LEN; i++)
+   {
+      double t = (double)i / FS;
+      for (c = 0; c < channels; c++)
+         pcm[channels * i + c] = (opus_int16)(7000 * sin(2 * M_PI * f0 * (c + 1) * t));
+   }
+   if (err == 0)
+      err = opw_write(w, pcm, LINK_LEN);
+   if (err == LINK_LEN)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+static int mem_read(void *stream, unsigned char *ptr, int nbytes)
+{
+   mem_source *s = (mem_source *)stream;
+   if (nbytes > s->length - s->pos)
+      nbytes = s->length - s->pos;
+   memcpy(ptr, s->data + s->pos, nbytes);
+   s->pos += nbytes;
+   return nbytes;
+}
+
+/* Decodes from the given position (or the start of an unseekable source)
+   to the end */
+static int decode(const mem_stream *m, int seekable, int seamless, ogg_int64_t start,
+      decoded *d)
+{
+   static const OpusFileCallbacks cb = { mem_read, NULL, NULL, NULL };
+   mem_source src;
+   OggOpusFile *of;
+   int ret, li, i;
+   src.data = m->data;
+   src.length = m->length;
+   src.pos = 0;
+   of = seekable ? op_open_memory(m->data, m->length, NULL)
+         : op_open_callbacks(&src, &cb, NULL, 0, NULL);
+   if (of == NULL || (start > 0 && op_pcm_seek(of, start) < 0))
+      return 1;
+   op_set_seamless_links(of, seamless);
+   d->nsamples = 0;
+   d->offset[0] = 0;
+   while (d->nsamples <= MAX_LEN
+         && (ret = op_read_float(of, d->pcm + d->offset[d->nsamples], READ_SIZE * 2, &li)) > 0)
+   {
+      for (i = 0; i < ret; i++)
+      {
+         d->channels[d->nsamples] = op_channel_count(of, li);
+         d->offset[d->nsamples + 1] = d->offset[d->nsamples] + d->channels[d->nsamples];
+         d->nsamples++;
+      }
+   }
+   op_free(of);
+   return ret < 0;
+}
+
+static int same_sample(const decoded *a, const decoded *b, opus_int32 i)
+{
+   return a->channels[i] == b->channels[i] && memcmp(a->pcm + a->offset[i],
+         b->pcm + b->offset[i], a->channels[i] * sizeof(*a->pcm)) == 0;
+}
+
+int main(void)
+{
+   static const int channels[NLINKS] = { 2, 2, 1, 1 };
+   static decoded plain, seamless, d;
+   mem_stream m = { NULL, 0, 0 };
+   int li, err, ret = 0;
+   opus_int32 i, ndiff;
+
+   for (li = 0, err = 0; li < NLINKS && err == 0; li++)
+      err = make_link(&m, channels[li], 0x1000 + li, 300 + 100 * li);
+   if (err < 0)
+   {
+      fprintf(stderr, "encoding failed: %d\n", err);
+      return 1;
+   }
+
+   if (decode(&m, 1, 0, 0, &plain) || decode(&m, 1, 1, 0, &seamless)
+         || plain.nsamples != MAX_LEN || seamless.nsamples != MAX_LEN)
+   {
+      fprintf(stderr, "decoding failed\n");
+      return 1;
+   }
+   for (li = 0; li < NLINKS; li++)
+   {
+      opus_int32 start = li * LINK_LEN;
+      opus_int32 end = li > 0 && channels[li] == channels[li - 1] ? start + XFADE : start;
+      ndiff = 0;
+      for (i = start; i < (li + 1) * LINK_LEN; i++)
+      {
+         if (!same_sample(&plain, &seamless, i))
+         {
+            if (i >= end)
+            {
+               fprintf(stderr, "sample %d in link %d changed outside the crossfade\n",
+                     (int)i, li);
+               ret = 1;
+               break;
+            }
+            ndiff++;
+         }
+      }
+      if (end > start && ndiff == 0)
+      {
+         fprintf(stderr, "the start of link %d was not crossfaded\n", li);
+         ret = 1;
+      }
+   }
+
+   /* An unseekable source is crossfaded the same way */
+   if (decode(&m, 0, 1, 0, &d) || d.nsamples != MAX_LEN)
+   {
+      fprintf(stderr, "unseekable decoding failed\n");
+      ret = 1;
+   }
+   else
+   {
+      for (i = 0; i < MAX_LEN && same_sample(&seamless, &d, i); i++);
+      if (i < MAX_LEN)
+      {
+         fprintf(stderr, "unseekable sample %d differs\n", (int)i);
+         ret = 1;
+      }
+   }
+
+   /* Right after a seek into a crossfade there is nothing to crossfade with */
+   for (li = 1; li < NLINKS; li += 2)
+   {
+      decoded *seek_plain = &d;
+      static decoded seek_seamless;
+      ogg_int64_t start = li * LINK_LEN + XFADE / 2;
+      if (decode(&m, 1, 0, start, seek_plain) || decode(&m, 1, 1, start, &seek_seamless)
+            || seek_plain->nsamples != seek_seamless.nsamples)
+      {
+         fprintf(stderr, "decoding after a seek to %d failed\n", (int)start);
+         ret = 1;
+         continue;
+      }
+      /* Up to the next link boundary, which is crossfaded again */
+      for (i = 0; i < LINK_LEN - XFADE / 2 && same_sample(seek_plain, &seek_seamless, i); i++);
+      if (i < LINK_LEN - XFADE / 2)
+      {
+         fprintf(stderr, "sample %d after a seek to %d was crossfaded\n", (int)i, (int)start);
+         ret = 1;
+      }
+   }
+
+   free(m.data);
+   if (ret == 0)
+      printf("All seamless link tests passed\n");
+   return ret;
+}
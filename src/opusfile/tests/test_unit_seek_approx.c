@@ -0,0 +1,220 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that op_pcm_seek_approx() returns the position decoding actually
+   resumes from, with and without OP_SEEK_PACKET and OP_SEEK_FADE_IN, when
+   seeking twice in a row: the position it returns must match op_pcm_tell()
+   before and after a read, decoding from there to the end must produce
+   exactly the rest of the stream, and OP_SEEK_FADE_IN must not change where
+   it lands. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define CHANNELS    2
+#define NB_SAMPLES  (10 * FS)
+#define READ_SIZE   480
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Encodes a few seconds of a wobbling two-tone signal with 20 ms packets,
+   so that every page holds a good number of packets */
+static int make_stream(mem_stream *m)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   int i, err;
+   w = opw_create_callbacks(m, &cb, FS, CHANNELS, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   pcm = (opus_int16 *)malloc(NB_SAMPLES * CHANNELS * sizeof(*pcm));
+   for (i = 0; i < NB_SAMPLES; i++)
+   {
+      double t = (double)i / FS;
+      pcm[2 * i] = (opus_int16)(8000 * sin(2 * M_PI * (440 + 60 * sin(2 * M_PI * t)) * t));
+      pcm[2 * i + 1] = (opus_int16)(6000 * sin(2 * M_PI * 660 * t));
+   }
+   err = opw_write(w, pcm, NB_SAMPLES);
+   if (err == NB_SAMPLES)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+/* Returns the number of samples per channel left in the stream, by decoding
+   them */
+static ogg_int64_t count_to_end(OggOpusFile *of)
+{
+   float buf[READ_SIZE * CHANNELS];
+   ogg_int64_t total = 0;
+   int ret;
+   while ((ret = op_read_float(of, buf, READ_SIZE * CHANNELS, NULL)) > 0)
+      total += ret;
+   return ret < 0 ? ret : total;
+}
+
+static int check_seek(OggOpusFile *of, ogg_int64_t target, int flags, ogg_int64_t total,
+      int verify_end)
+{
+   float buf[READ_SIZE * CHANNELS];
+   ogg_int64_t pos, rest;
+   int n;
+   pos = op_pcm_seek_approx(of, target, flags);
+   if (pos < 0 || pos > target)
+   {
+      fprintf(stderr, "seek to %d with flags %d returned %d\n",
+            (int)target, flags, (int)pos);
+      return 1;
+   }
+   if (op_pcm_tell(of) != pos)
+   {
+      fprintf(stderr, "seek to %d with flags %d returned %d, but op_pcm_tell() says %d\n",
+            (int)target, flags, (int)pos, (int)op_pcm_tell(of));
+      return 1;
+   }
+   n = op_read_float(of, buf, READ_SIZE * CHANNELS, NULL);
+   if (n <= 0 || op_pcm_tell(of) != pos + n)
+   {
+      fprintf(stderr, "seek to %d with flags %d returned %d, but after reading %d samples "
+            "op_pcm_tell() says %d\n", (int)target, flags, (int)pos, n, (int)op_pcm_tell(of));
+      return 1;
+   }
+   if (verify_end)
+   {
+      rest = count_to_end(of);
+      if (pos + n + rest != total)
+      {
+         fprintf(stderr, "seek to %d with flags %d returned %d, but decoding resumed at %d\n",
+               (int)target, flags, (int)pos, (int)(total - rest - n));
+         return 1;
+      }
+   }
+   return 0;
+}
+
+int main(void)
+{
+   static const int flags[4] = { 0, OP_SEEK_FADE_IN, OP_SEEK_PACKET,
+         OP_SEEK_PACKET | OP_SEEK_FADE_IN };
+   mem_stream m = { NULL, 0, 0 };
+   OggOpusFile *of;
+   ogg_int64_t total;
+   int f, i, err, ret = 0;
+
+   err = make_stream(&m);
+   if (err < 0)
+   {
+      fprintf(stderr, "encoding failed: %d\n", err);
+      return 1;
+   }
+   of = op_open_memory(m.data, m.length, &err);
+   if (of == NULL)
+   {
+      fprintf(stderr, "opening failed: %d\n", err);
+      return 1;
+   }
+   total = op_pcm_total(of, -1);
+
+   for (f = 0; f < 4; f++)
+   {
+      /* Two seeks in a row, the second one landing on the page the first one
+         left buffered as well as on other pages */
+      for (i = 0; i < 40; i++)
+      {
+         ogg_int64_t target = (i * 7919 * 37) % (total - FS);
+         ret |= check_seek(of, target, flags[f], total, 0);
+         ret |= check_seek(of, target + (i % 5) * 4000, flags[f], total, 1);
+      }
+      ret |= check_seek(of, 0, flags[f], total, 1);
+      ret |= check_seek(of, total - 1, flags[f], total, 1);
+   }
+
+   /* Fading in must not move the landing position */
+   for (i = 0; i < 40; i++)
+   {
+      ogg_int64_t target = (i * 7919 * 37) % (total - FS);
+      for (f = 0; f < 4; f += 2)
+      {
+         ogg_int64_t pos[2];
+         int k;
+         for (k = 0; k < 2; k++)
+         {
+            if (op_pcm_seek(of, target / 2) < 0)
+               ret = 1;
+            pos[k] = op_pcm_seek_approx(of, target, flags[f + k]);
+         }
+         if (pos[0] != pos[1])
+         {
+            fprintf(stderr, "seek to %d landed at %d with flags %d but %d with flags %d\n",
+                  (int)target, (int)pos[0], flags[f], (int)pos[1], flags[f + 1]);
+            ret = 1;
+         }
+      }
+   }
+
+   op_free(of);
+   free(m.data);
+   if (ret == 0)
+      printf("All approximate seek tests passed\n");
+   return ret;
+}
@@ -0,0 +1,293 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks the bins from op_read_waveform() against a plain scalar reference
+   computed from the output of op_read_float() on the same positions, on a
+   chained stream whose links have different channel counts: bin i must
+   cover the samples whose absolute PCM offset t has t*bins_per_sec/48000
+   equal to i, including for rates that do not divide 48000, across calls,
+   across the link boundary, and after a seek, where the first bin is only
+   partial.  op_read_all_waveform() must lay out the same bins. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define LINK_LEN    (5 * FS + 1234)
+#define MAX_BINS    (2 * LINK_LEN + 2)
+#define READ_SIZE   960
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+} mem_stream;
+
+typedef struct {
+   float min;
+   float max;
+   double sum2;
+   opus_int32 count;
+} ref_bin;
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->length + header_len + body_len > m->size)
+   {
+      opus_int32 size = 2 * m->size + header_len + body_len;
+      unsigned char *data = (unsigned char *)realloc(m->data, size);
+      if (data == NULL)
+         return OP_EFAULT;
+      m->data = data;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, header, header_len);
+   memcpy(m->data + m->length + header_len, body, body_len);
+   m->length += header_len + body_len;
+   return 0;
+}
+
+/* Appends one link with its own serial number, slowly changing in level so
+   that neighbouring bins differ */
+static int make_link(mem_stream *m, int channels, opus_uint32 serialno, double f0)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   opus_uint32 seed = serialno;
+   int i, c, err;
+   w = opw_create_callbacks(m, &cb, FS, channels, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+      return err;
+   err = opw_set_serialno(w, serialno);
+   pcm = (opus_int16 *)malloc(LINK_LEN * channels * sizeof(*pcm));
+   for (i = 0; i < LINK_LEN; i++)
+   {
+      double t = (double)i / FS;
+      for (c = 0; c < channels; c++)
+      {
+         seed = seed * 1103515245u + 12345u;
+         pcm[channels * i + c] = (opus_int16)((4000 + 3000 * sin(2 * M_PI * 1.3 * t))
+               * sin(2 * M_PI * f0 * (c + 1) * t) + (int)(seed >> 21) - 1024);
+      }
+   }
+   if (err == 0)
+      err = opw_write(w, pcm, LINK_LEN);
+   if (err == LINK_LEN)
+      err = opw_drain(w);
+   else if (err >= 0)
+      err = OP_EFAULT;
+   free(pcm);
+   opw_destroy(w);
+   return err;
+}
+
+/* Summarizes everything op_read_float() returns from the current position
+   to the end, one sample at a time.
+   Returns the index of the last bin, or -1 on error. */
+static int make_ref(OggOpusFile *of, opus_int32 bins_per_sec, ref_bin *bins)
+{
+   float pcm[READ_SIZE * 2];
+   ogg_int64_t t;
+   int ret, li, i, c, channels, last = -1;
+   for (i = 0; i < MAX_BINS; i++)
+   {
+      bins[i].min = (float)HUGE_VAL;
+      bins[i].max = (float)-HUGE_VAL;
+      bins[i].sum2 = 0;
+      bins[i].count = 0;
+   }
+   t = op_pcm_tell(of);
+   while ((ret = op_read_float(of, pcm, READ_SIZE * 2, &li)) > 0)
+   {
+      channels = op_channel_count(of, li);
+      for (i = 0; i < ret; i++, t++)
+      {
+         ref_bin *bin = bins + t * bins_per_sec / FS;
+         for (c = 0; c < channels; c++)
+         {
+            float x = pcm[channels * i + c];
+            bin->min = x < bin->min ? x : bin->min;
+            bin->max = x > bin->max ? x : bin->max;
+            bin->sum2 += (double)x * x;
+            bin->count++;
+         }
+      }
+      last = (int)((t - 1) * bins_per_sec / FS);
+   }
+   return ret < 0 ? -1 : last;
+}
+
+/* The extremes are exact, but the RMS may be summed in a different order */
+static int same_bin(const OpusWaveformBin *bin, const ref_bin *ref, float tol)
+{
+   double rms;
+   if (ref->count <= 0)
+      return 0;
+   rms = sqrt(ref->sum2 / ref->count);
+   return fabs(bin->min - ref->min) <= tol && fabs(bin->max - ref->max) <= tol
+         && fabs(bin->rms - rms) <= 1e-4 * rms + tol;
+}
+
+/* Reads bins a few at a time from the current position of of, and compares
+   them with a reference decoded by another handle from the same position */
+static int check_read(const mem_stream *m, opus_int32 bins_per_sec, ogg_int64_t start)
+{
+   OpusWaveformBin bins[7];
+   OggOpusFile *of, *ref_of;
+   ref_bin *ref;
+   int first, last, bi, n, i, j, ret = 0;
+   of = op_open_memory(m->data, m->length, NULL);
+   ref_of = op_open_memory(m->data, m->length, NULL);
+   ref = (ref_bin *)malloc(MAX_BINS * sizeof(*ref));
+   if (of == NULL || ref_of == NULL || op_pcm_seek(of, start) < 0
+         || op_pcm_seek(ref_of, start) < 0 || (last = make_ref(ref_of, bins_per_sec, ref)) < 0)
+   {
+      fprintf(stderr, "could not set up the reference\n");
+      return 1;
+   }
+   first = (int)(start * bins_per_sec / FS);
+   for (bi = first, i = 0; ret == 0; i++)
+   {
+      n = op_read_waveform(of, bins, 1 + i % 7, bins_per_sec);
+      if (n < 0)
+      {
+         fprintf(stderr, "op_read_waveform() failed: %d\n", n);
+         ret = 1;
+         break;
+      }
+      if (n == 0)
+         break;
+      for (j = 0; j < n; j++)
+      {
+         if (bi > last || !same_bin(bins + j, ref + bi, 0))
+         {
+            fprintf(stderr, "bin %d at %d bins/s from %d does not match\n",
+                  bi, (int)bins_per_sec, (int)start);
+            ret = 1;
+         }
+         bi++;
+      }
+      /* Each call leaves the position at the end of its last bin */
+      if (bi <= last && op_pcm_tell(of) != (bi * (ogg_int64_t)FS + bins_per_sec - 1) / bins_per_sec)
+      {
+         fprintf(stderr, "op_read_waveform() left the position at %d before bin %d\n",
+               (int)op_pcm_tell(of), bi);
+         ret = 1;
+      }
+   }
+   if (ret == 0 && bi != last + 1)
+   {
+      fprintf(stderr, "got %d bins at %d bins/s from %d instead of %d\n",
+            bi - first, (int)bins_per_sec, (int)start, last + 1 - first);
+      ret = 1;
+   }
+   free(ref);
+   op_free(of);
+   op_free(ref_of);
+   return ret;
+}
+
+/* Segments after the first one start with pre-roll, so their bins only
+   agree with a serial decode to within the codec's convergence */
+static int check_read_all(const mem_stream *m, opus_int32 bins_per_sec, int nthreads)
+{
+   OggOpusFile *of;
+   OpusWaveformBin *bins;
+   ref_bin *ref;
+   ogg_int64_t nbins, expected;
+   int last, bi, ret = 0;
+   of = op_open_memory(m->data, m->length, NULL);
+   bins = (OpusWaveformBin *)malloc(MAX_BINS * sizeof(*bins));
+   ref = (ref_bin *)malloc(MAX_BINS * sizeof(*ref));
+   if (of == NULL || (last = make_ref(of, bins_per_sec, ref)) < 0)
+   {
+      fprintf(stderr, "could not set up the reference\n");
+      return 1;
+   }
+   expected = (op_pcm_total(of, -1) * bins_per_sec + FS - 1) / FS;
+   nbins = op_read_all_waveform(of, bins, MAX_BINS, bins_per_sec, nthreads);
+   if (nbins != expected || nbins != last + 1)
+   {
+      fprintf(stderr, "op_read_all_waveform() at %d bins/s returned %d bins instead of %d\n",
+            (int)bins_per_sec, (int)nbins, (int)expected);
+      ret = 1;
+   }
+   for (bi = 0; ret == 0 && bi < nbins; bi++)
+   {
+      if (!same_bin(bins + bi, ref + bi, nthreads > 1 ? 0.02f : 0))
+      {
+         fprintf(stderr, "op_read_all_waveform() bin %d at %d bins/s with %d threads "
+               "does not match\n", bi, (int)bins_per_sec, nthreads);
+         ret = 1;
+      }
+   }
+   free(bins);
+   free(ref);
+   op_free(of);
+   return ret;
+}
+
+int main(void)
+{
+   static const opus_int32 rates[5] = { 1, 7, 10, 441, 48000 };
+   mem_stream m = { NULL, 0, 0 };
+   int i, err, ret = 0;
+
+   err = make_link(&m, 2, 0x1234, 300);
+   if (err == 0)
+      err = make_link(&m, 1, 0x5678, 500);
+   if (err < 0)
+   {
+      fprintf(stderr, "encoding failed: %d\n", err);
+      return 1;
+   }
+
+   for (i = 0; i < 5; i++)
+   {
+      ret |= check_read(&m, rates[i], 0);
+      /* Off a bin boundary for every rate but 48000, and in the second link */
+      ret |= check_read(&m, rates[i], LINK_LEN + 4321);
+      ret |= check_read_all(&m, rates[i], 1);
+      ret |= check_read_all(&m, rates[i], 4);
+   }
+
+   free(m.data);
+   if (ret == 0)
+      printf("All waveform tests passed\n");
+   return ret;
+}
@@ -0,0 +1,275 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that opw_write() never returns 0 for a non-empty frame: when the
+   output refuses a page before any input was consumed it must return
+   OP_FALSE, so that a caller retrying on a short count cannot spin.  Stalls
+   must also not change the stream: writing through an output that refuses
+   every page once, and through a buffer holding a single page, has to
+   decode to exactly what an output that always takes the page produces. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opusfile.h"
+#include "opuswriter.h"
+
+#define FS          48000
+#define CHANNELS    2
+#define NB_SAMPLES  (4 * FS)
+#define CHUNK       (FS / 10)
+#define READ_SIZE   960
+
+typedef struct {
+   unsigned char *data;
+   opus_int32 size;
+   opus_int32 length;
+   /* Refuse every page the first time it is offered */
+   int stalls;
+   int refused;
+   /* Refuse every page */
+   int blocked;
+} mem_stream;
+
+static int mem_append(mem_stream *m, const unsigned char *data, opus_int32 len)
+{
+   if (m->length + len > m->size)
+   {
+      opus_int32 size = 2 * m->size + len;
+      unsigned char *buf = (unsigned char *)realloc(m->data, size);
+      if (buf == NULL)
+         return OP_EFAULT;
+      m->data = buf;
+      m->size = size;
+   }
+   memcpy(m->data + m->length, data, len);
+   m->length += len;
+   return 0;
+}
+
+static int mem_write(void *stream, const unsigned char *header, opus_int32 header_len,
+      const unsigned char *body, opus_int32 body_len)
+{
+   mem_stream *m = (mem_stream *)stream;
+   if (m->blocked)
+      return OP_FALSE;
+   if (m->stalls && !m->refused)
+   {
+      m->refused = 1;
+      return OP_FALSE;
+   }
+   m->refused = 0;
+   if (mem_append(m, header, header_len) < 0 || mem_append(m, body, body_len) < 0)
+      return OP_EFAULT;
+   return 0;
+}
+
+static opus_int16 *make_pcm(void)
+{
+   opus_int16 *pcm;
+   int i;
+   pcm = (opus_int16 *)malloc(NB_SAMPLES * CHANNELS * sizeof(*pcm));
+   for (i = 0; i < NB_SAMPLES; i++)
+   {
+      double t = (double)i / FS;
+      pcm[2 * i] = (opus_int16)(8000 * sin(2 * M_PI * (440 + 60 * sin(2 * M_PI * t)) * t));
+      pcm[2 * i + 1] = (opus_int16)(6000 * sin(2 * M_PI * 660 * t));
+   }
+   return pcm;
+}
+
+/* Feeds the whole input in chunks, retrying whatever was not consumed.
+   flush() is called whenever opw_write() stops short and must make room for
+   at least one more page. */
+static int feed(OggOpusWriter *w, const opus_int16 *pcm, void (*flush)(void *), void *ctx)
+{
+   int done, ret, n;
+   for (done = 0; done < NB_SAMPLES;)
+   {
+      n = NB_SAMPLES - done < CHUNK ? NB_SAMPLES - done : CHUNK;
+      ret = opw_write(w, pcm + done * CHANNELS, n);
+      if (ret == 0)
+      {
+         fprintf(stderr, "opw_write() returned 0 for %d samples\n", n);
+         return 1;
+      }
+      if (ret == OP_FALSE)
+         ret = 0;
+      else if (ret < 0 || ret > n)
+      {
+         fprintf(stderr, "opw_write() returned %d for %d samples\n", ret, n);
+         return 1;
+      }
+      done += ret;
+      if (ret < n)
+         (*flush)(ctx);
+   }
+   while ((ret = opw_drain(w)) == OP_FALSE)
+      (*flush)(ctx);
+   if (ret < 0)
+   {
+      fprintf(stderr, "opw_drain() failed: %d\n", ret);
+      return 1;
+   }
+   return 0;
+}
+
+static void no_flush(void *ctx)
+{
+   (void)ctx;
+}
+
+typedef struct {
+   OpusWriterBuffer buf;
+   mem_stream *out;
+} buf_sink;
+
+static void buf_flush(void *ctx)
+{
+   buf_sink *s = (buf_sink *)ctx;
+   mem_append(s->out, s->buf.data, s->buf.length);
+   s->buf.length = 0;
+}
+
+/* Decodes the whole stream, returning NULL on failure */
+static float *decode(const mem_stream *m, ogg_int64_t *total)
+{
+   OggOpusFile *of;
+   float *pcm;
+   int ret;
+   of = op_open_memory(m->data, m->length, NULL);
+   if (of == NULL)
+      return NULL;
+   pcm = (float *)malloc((NB_SAMPLES + READ_SIZE) * CHANNELS * sizeof(*pcm));
+   *total = 0;
+   while (*total <= NB_SAMPLES
+         && (ret = op_read_float(of, pcm + *total * CHANNELS, READ_SIZE * CHANNELS, NULL)) > 0)
+      *total += ret;
+   op_free(of);
+   return pcm;
+}
+
+static int compare(const mem_stream *ref, const mem_stream *m, const char *what)
+{
+   float *a, *b;
+   ogg_int64_t na, nb;
+   int ret = 0;
+   a = decode(ref, &na);
+   b = decode(m, &nb);
+   if (a == NULL || b == NULL || na != NB_SAMPLES || nb != NB_SAMPLES
+         || memcmp(a, b, NB_SAMPLES * CHANNELS * sizeof(*a)) != 0)
+   {
+      fprintf(stderr, "%s: output differs from a writer that never stalls\n", what);
+      ret = 1;
+   }
+   free(a);
+   free(b);
+   return ret;
+}
+
+int main(void)
+{
+   static const OpusWriterCallbacks cb = { mem_write, NULL };
+   static const opus_int16 silence[CHANNELS * 960];
+   mem_stream ref = { NULL, 0, 0, 0, 0, 0 };
+   mem_stream stalled = { NULL, 0, 0, 1, 0, 0 };
+   mem_stream blocked = { NULL, 0, 0, 0, 0, 1 };
+   mem_stream buffered = { NULL, 0, 0, 0, 0, 0 };
+   buf_sink sink;
+   OggOpusWriter *w;
+   opus_int16 *pcm;
+   int err, ret = 0;
+
+   pcm = make_pcm();
+
+   /* The reference: an output that always takes the page */
+   w = opw_create_callbacks(&ref, &cb, FS, CHANNELS, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+   {
+      fprintf(stderr, "creating the writer failed: %d\n", err);
+      return 1;
+   }
+   ret |= feed(w, pcm, no_flush, NULL);
+   opw_destroy(w);
+
+   /* Every page is refused once; retrying right away gets it through */
+   w = opw_create_callbacks(&stalled, &cb, FS, CHANNELS, 0, OPUS_APPLICATION_AUDIO, &err);
+   ret |= feed(w, pcm, no_flush, NULL);
+   opw_destroy(w);
+   ret |= compare(&ref, &stalled, "stalling output");
+
+   /* An output that takes nothing must get OP_FALSE, not 0, every time */
+   w = opw_create_callbacks(&blocked, &cb, FS, CHANNELS, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (opw_write(w, silence, 960) != OP_FALSE || opw_write(w, silence, 960) != OP_FALSE)
+   {
+      fprintf(stderr, "opw_write() to a blocked output did not return OP_FALSE\n");
+      ret = 1;
+   }
+   if (opw_write(w, silence, 0) != 0)
+   {
+      fprintf(stderr, "opw_write() of an empty frame did not return 0\n");
+      ret = 1;
+   }
+   blocked.blocked = 0;
+   if (opw_write(w, silence, 960) != 960)
+   {
+      fprintf(stderr, "opw_write() did not resume once the output took pages\n");
+      ret = 1;
+   }
+   opw_destroy(w);
+
+   /* A buffer that only holds a single page */
+   sink.buf.size = OPW_PAGE_SIZE_MAX;
+   sink.buf.data = (unsigned char *)malloc(sink.buf.size);
+   sink.buf.length = 0;
+   sink.out = &buffered;
+   w = opw_create_buffer(&sink.buf, FS, CHANNELS, 0, OPUS_APPLICATION_AUDIO, &err);
+   if (w == NULL)
+   {
+      fprintf(stderr, "creating the buffer writer failed: %d\n", err);
+      return 1;
+   }
+   ret |= feed(w, pcm, buf_flush, &sink);
+   buf_flush(&sink);
+   opw_destroy(w);
+   ret |= compare(&ref, &buffered, "single page buffer");
+
+   free(sink.buf.data);
+   free(ref.data);
+   free(stalled.data);
+   free(blocked.data);
+   free(buffered.data);
+   free(pcm);
+   if (ret == 0)
+      printf("All writer stall tests passed\n");
+   return ret;
+}
@@ -0,0 +1,511 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "internal.h"
+#include <string.h>
+#include <time.h>
+#include <opuswriter.h>
+
+/*The largest packet a single stream can produce for 60 ms of audio (three
+   1275-byte frames plus the code 3 header and self-delimiting length).*/
+#define OPW_STREAM_PACKET_MAX (3*1275+8)
+
+/*The states the header packets go through.*/
+/*Nothing written yet, comments and settings can still change.*/
+#define OPW_HEADERS_NONE    (0)
+/*The ID header has been submitted.*/
+#define OPW_HEADERS_HEAD    (1)
+/*Both headers have been submitted.*/
+#define OPW_HEADERS_TAGS    (2)
+/*Both header pages have been written out.*/
+#define OPW_HEADERS_FLUSHED (3)
+
+struct OggOpusWriter{
+  /*The output.*/
+  OpusWriterCallbacks  callbacks;
+  void                *stream;
+  /*The buffer when writing to caller memory, so it can be told apart from
+     callbacks that happen to use the same function.*/
+  OpusWriterBuffer    *buf;
+  OpusMSEncoder       *enc;
+  ogg_stream_state     os;
+  /*The page produced by libogg and not yet accepted by the output.
+    Its pointers refer to libogg's stream buffers, and stay valid until the
+     next packet is submitted.*/
+  ogg_page             og;
+  int                  og_pending;
+  /*The first hard error, reported again by every later call.*/
+  int                  error;
+  opus_int32           rate;
+  int                  channels;
+  int                  mapping_family;
+  int                  nb_streams;
+  int                  nb_coupled;
+  unsigned char        mapping[OPUS_CHANNEL_COUNT_MAX];
+  /*The number of 48 kHz samples per input sample.*/
+  int                  rate_scale;
+  int                  frame_size;
+  int                  pre_skip;
+  int                  page_size;
+  ogg_int64_t          page_latency;
+  /*The granule position of the last packet submitted, and of the last page
+     that ended a packet.*/
+  ogg_int64_t          granulepos;
+  ogg_int64_t          page_granulepos;
+  ogg_int64_t          packetno;
+  /*The number of input samples per channel received, without padding.*/
+  ogg_int64_t          nsamples;
+  /*Samples waiting for the rest of their frame.*/
+  float               *pcm;
+  int                  pcm_fill;
+  unsigned char       *packet;
+  opus_int32           packet_max;
+  /*The comment header, built as comments are added.*/
+  unsigned char       *tags;
+  opus_int32           tags_size;
+  opus_int32           tags_storage;
+  /*Where the comment count is stored in the comment header.*/
+  opus_int32           tags_count_offset;
+  opus_uint32          ncomments;
+  int                  headers;
+  int                  eos;
+  int                  drained;
+};
+
+static void op_put_le16(unsigned char *_p,int _v){
+  _p[0]=(unsigned char)(_v&0xFF);
+  _p[1]=(unsigned char)(_v>>8&0xFF);
+}
+
+static void op_put_le32(unsigned char *_p,opus_uint32 _v){
+  _p[0]=(unsigned char)(_v&0xFF);
+  _p[1]=(unsigned char)(_v>>8&0xFF);
+  _p[2]=(unsigned char)(_v>>16&0xFF);
+  _p[3]=(unsigned char)(_v>>24&0xFF);
+}
+
+static int opw_tags_append(OggOpusWriter *_w,const char *_data,
+ opus_int32 _len){
+  if(_len>_w->tags_storage-_w->tags_size){
+    unsigned char *tags;
+    opus_int32     storage;
+    storage=OP_MAX(2*_w->tags_storage,_w->tags_size+_len);
+    tags=(unsigned char *)_ogg_realloc(_w->tags,storage);
+    if(OP_UNLIKELY(tags==NULL))return OP_EFAULT;
+    _w->tags=tags;
+    _w->tags_storage=storage;
+  }
+  memcpy(_w->tags+_w->tags_size,_data,_len);
+  _w->tags_size+=_len;
+  return 0;
+}
+
+static int opw_mem_write(void *_stream,const unsigned char *_header,
+ opus_int32 _header_len,const unsigned char *_body,opus_int32 _body_len){
+  OpusWriterBuffer *buf;
+  buf=(OpusWriterBuffer *)_stream;
+  if(_header_len+_body_len>buf->size-buf->length){
+    /*A page that does not even fit an empty buffer would stall forever.*/
+    return buf->length>0?OP_FALSE:OP_EFAULT;
+  }
+  memcpy(buf->data+buf->length,_header,_header_len);
+  memcpy(buf->data+buf->length+_header_len,_body,_body_len);
+  buf->length+=_header_len+_body_len;
+  return 0;
+}
+
+static const OpusWriterCallbacks OPW_MEM_CALLBACKS={
+  opw_mem_write,
+  NULL
+};
+
+OggOpusWriter *opw_create_callbacks(void *_stream,
+ const OpusWriterCallbacks *_cb,opus_int32 _rate,int _channels,
+ int _mapping_family,int _application,int *_error){
+  OggOpusWriter *w;
+  const char    *vendor;
+  unsigned char  hdr[8];
+  opus_int32     lookahead;
+  int            ret;
+  if(OP_UNLIKELY(_cb->write==NULL)
+   ||OP_UNLIKELY(_rate!=8000&&_rate!=12000&&_rate!=16000
+   &&_rate!=24000&&_rate!=48000)
+   ||OP_UNLIKELY(_channels<1)||OP_UNLIKELY(_channels>OPUS_CHANNEL_COUNT_MAX)
+   ||OP_UNLIKELY(_mapping_family==0&&_channels>2)
+   ||OP_UNLIKELY(_mapping_family==1&&_channels>8)
+   ||OP_UNLIKELY(_mapping_family!=0&&_mapping_family!=1
+   &&_mapping_family!=255)){
+    if(_error!=NULL)*_error=OP_EINVAL;
+    return NULL;
+  }
+  w=(OggOpusWriter *)_ogg_calloc(1,sizeof(*w));
+  if(OP_UNLIKELY(w==NULL)){
+    if(_error!=NULL)*_error=OP_EFAULT;
+    return NULL;
+  }
+  w->callbacks=*_cb;
+  w->stream=_stream;
+  w->rate=_rate;
+  w->channels=_channels;
+  w->mapping_family=_mapping_family;
+  w->rate_scale=(int)(48000/_rate);
+  w->frame_size=(int)(_rate/50);
+  w->page_size=4096;
+  w->page_latency=48000;
+  ret=OP_EFAULT;
+  w->enc=opus_multistream_surround_encoder_create(_rate,_channels,
+   _mapping_family,&w->nb_streams,&w->nb_coupled,w->mapping,_application,
+   &ret);
+  if(OP_UNLIKELY(w->enc==NULL)){
+    ret=ret==OPUS_BAD_ARG?OP_EINVAL:OP_EFAULT;
+    goto fail;
+  }
+  ret=OP_EFAULT;
+  if(OP_UNLIKELY(opus_multistream_encoder_ctl(w->enc,
+   OPUS_GET_LOOKAHEAD(&lookahead))!=OPUS_OK))goto fail;
+  w->pre_skip=(int)lookahead*w->rate_scale;
+  w->packet_max=OPW_STREAM_PACKET_MAX*w->nb_streams;
+  w->packet=(unsigned char *)_ogg_malloc(w->packet_max);
+  /*Room for the longest frame, 60 ms.*/
+  w->pcm=(float *)_ogg_malloc(sizeof(*w->pcm)*(_rate/1000*60)*_channels);
+  if(OP_UNLIKELY(w->packet==NULL)||OP_UNLIKELY(w->pcm==NULL))goto fail;
+  if(OP_UNLIKELY(ogg_stream_init(&w->os,
+   (int)((opus_uint32)time(NULL)*2654435761U^(opus_uint32)(size_t)w))<0)){
+    goto fail;
+  }
+  /*The comment header starts with the vendor string and an empty list, the
+     count is patched as comments are added.*/
+  vendor=opus_get_version_string();
+  memcpy(hdr,"OpusTags",8);
+  if(OP_UNLIKELY(opw_tags_append(w,(const char *)hdr,8)<0))goto fail;
+  op_put_le32(hdr,(opus_uint32)strlen(vendor));
+  op_put_le32(hdr+4,0);
+  if(OP_UNLIKELY(opw_tags_append(w,(const char *)hdr,4)<0)
+   ||OP_UNLIKELY(opw_tags_append(w,vendor,(opus_int32)strlen(vendor))<0)){
+    goto fail;
+  }
+  w->tags_count_offset=w->tags_size;
+  if(OP_UNLIKELY(opw_tags_append(w,(const char *)hdr+4,4)<0))goto fail;
+  if(_error!=NULL)*_error=0;
+  return w;
+fail:
+  /*The caller still owns the stream if we fail, so don't close it.*/
+  w->callbacks.close=NULL;
+  opw_destroy(w);
+  if(_error!=NULL)*_error=ret;
+  return NULL;
+}
+
+OggOpusWriter *opw_create_buffer(OpusWriterBuffer *_buf,opus_int32 _rate,
+ int _channels,int _mapping_family,int _application,int *_error){
+  OggOpusWriter *w;
+  w=opw_create_callbacks(_buf,&OPW_MEM_CALLBACKS,_rate,_channels,
+   _mapping_family,_application,_error);
+  if(w!=NULL)w->buf=_buf;
+  return w;
+}
+
+void opw_destroy(OggOpusWriter *_w){
+  if(_w==NULL)return;
+  if(_w->callbacks.close!=NULL)(*_w->callbacks.close)(_w->stream);
+  if(_w->enc!=NULL)opus_multistream_encoder_destroy(_w->enc);
+  ogg_stream_clear(&_w->os);
+  _ogg_free(_w->pcm);
+  _ogg_free(_w->packet);
+  _ogg_free(_w->tags);
+  _ogg_free(_w);
+}
+
+OpusMSEncoder *opw_get_encoder(OggOpusWriter *_w){
+  return _w->enc;
+}
+
+int opw_comment_add(OggOpusWriter *_w,const char *_tag,const char *_value){
+  unsigned char len[4];
+  size_t        tag_len;
+  size_t        value_len;
+  int           ret;
+  if(OP_UNLIKELY(_w->headers!=OPW_HEADERS_NONE))return OP_EINVAL;
+  tag_len=strlen(_tag);
+  value_len=strlen(_value);
+  if(OP_UNLIKELY(tag_len+value_len>(size_t)OP_INT32_MAX-_w->tags_size-5)){
+    return OP_EFAULT;
+  }
+  op_put_le32(len,(opus_uint32)(tag_len+1+value_len));
+  ret=opw_tags_append(_w,(const char *)len,4);
+  if(OP_LIKELY(ret>=0))ret=opw_tags_append(_w,_tag,(opus_int32)tag_len);
+  if(OP_LIKELY(ret>=0))ret=opw_tags_append(_w,"=",1);
+  if(OP_LIKELY(ret>=0))ret=opw_tags_append(_w,_value,(opus_int32)value_len);
+  if(OP_UNLIKELY(ret<0))return ret;
+  op_put_le32(_w->tags+_w->tags_count_offset,++_w->ncomments);
+  return 0;
+}
+
+int opw_set_serialno(OggOpusWriter *_w,opus_uint32 _serialno){
+  if(OP_UNLIKELY(_w->headers!=OPW_HEADERS_NONE))return OP_EINVAL;
+  return ogg_stream_reset_serialno(&_w->os,(int)_serialno)<0?OP_EFAULT:0;
+}
+
+int opw_set_frame_size(OggOpusWriter *_w,int _frame_size){
+  opus_int32 n;
+  if(OP_UNLIKELY(_w->headers!=OPW_HEADERS_NONE))return OP_EINVAL;
+  /*In units of 2.5 ms.*/
+  n=_frame_size*400;
+  if(OP_UNLIKELY(_frame_size<=0)||OP_UNLIKELY(n%_w->rate!=0))return OP_EINVAL;
+  n/=_w->rate;
+  if(n!=1&&n!=2&&n!=4&&n!=8&&n!=16&&n!=24)return OP_EINVAL;
+  _w->frame_size=_frame_size;
+  return 0;
+}
+
+int opw_set_page_latency(OggOpusWriter *_w,opus_int32 _latency_ms){
+  if(OP_UNLIKELY(_latency_ms<0))return OP_EINVAL;
+  _w->page_latency=(ogg_int64_t)_latency_ms*48;
+  return 0;
+}
+
+int opw_set_page_size(OggOpusWriter *_w,int _page_size){
+  if(OP_UNLIKELY(_page_size<=0))return OP_EINVAL;
+  _w->page_size=_page_size;
+  return 0;
+}
+
+/*Hands the pending page to the output.
+  Return: 0 if there is no pending page left, OP_FALSE if the output cannot
+   take it yet, or a negative error code.*/
+static int opw_page_write(OggOpusWriter *_w){
+  int ret;
+  if(!_w->og_pending)return 0;
+  ret=(*_w->callbacks.write)(_w->stream,_w->og.header,
+   (opus_int32)_w->og.header_len,_w->og.body,(opus_int32)_w->og.body_len);
+  if(ret==OP_FALSE)return OP_FALSE;
+  if(OP_UNLIKELY(ret<0)){
+    /*The buffer writer uses OP_EFAULT for pages that can never fit.*/
+    _w->error=_w->buf!=NULL?OP_EFAULT:OP_EREAD;
+    return _w->error;
+  }
+  _w->og_pending=0;
+  return 0;
+}
+
+/*Moves every page libogg is ready to produce to the output.
+  _flush: Close the current page even if it is neither full nor late.
+  Return: 0 if nothing is left pending, OP_FALSE if the output stopped taking
+   pages, or a negative error code.*/
+static int opw_pages_out(OggOpusWriter *_w,int _flush){
+  for(;;){
+    int ret;
+    ret=opw_page_write(_w);
+    if(ret<0)return ret;
+    /*A packet has waited too long when the page would span more than the
+       allowed latency.*/
+    if(_flush||_w->granulepos-_w->page_granulepos>=_w->page_latency){
+      ret=ogg_stream_flush_fill(&_w->os,&_w->og,_w->page_size);
+    }
+    else ret=ogg_stream_pageout_fill(&_w->os,&_w->og,_w->page_size);
+    if(ret==0)return 0;
+    if(ogg_page_granulepos(&_w->og)>=0){
+      _w->page_granulepos=ogg_page_granulepos(&_w->og);
+    }
+    _w->og_pending=1;
+  }
+}
+
+/*Submits one packet.
+  There must not be a pending page, since libogg moves its buffers around.*/
+static int opw_packet_in(OggOpusWriter *_w,unsigned char *_data,
+ opus_int32 _len,ogg_int64_t _granulepos,int _eos){
+  ogg_packet op;
+  OP_ASSERT(!_w->og_pending);
+  op.packet=_data;
+  op.bytes=_len;
+  op.b_o_s=_w->packetno==0;
+  op.e_o_s=_eos;
+  op.granulepos=_granulepos;
+  op.packetno=_w->packetno++;
+  if(OP_UNLIKELY(ogg_stream_packetin(&_w->os,&op)<0)){
+    return _w->error=OP_EFAULT;
+  }
+  return 0;
+}
+
+/*Submits the ID and comment headers, each on a page of its own.
+  Return: 0 once both have been written out, OP_FALSE if the output stopped
+   taking pages, or a negative error code.*/
+static int opw_headers_out(OggOpusWriter *_w){
+  int ret;
+  while(_w->headers!=OPW_HEADERS_FLUSHED){
+    ret=opw_pages_out(_w,1);
+    if(ret<0)return ret;
+    if(_w->headers==OPW_HEADERS_TAGS)ret=0;
+    else if(_w->headers==OPW_HEADERS_NONE){
+      unsigned char head[21+OPUS_CHANNEL_COUNT_MAX];
+      opus_int32    head_len;
+      memcpy(head,"OpusHead",8);
+      head[8]=1;
+      head[9]=(unsigned char)_w->channels;
+      op_put_le16(head+10,_w->pre_skip);
+      op_put_le32(head+12,(opus_uint32)_w->rate);
+      op_put_le16(head+16,0);
+      head[18]=(unsigned char)_w->mapping_family;
+      head_len=19;
+      if(_w->mapping_family!=0){
+        head[19]=(unsigned char)_w->nb_streams;
+        head[20]=(unsigned char)_w->nb_coupled;
+        memcpy(head+21,_w->mapping,_w->channels);
+        head_len=21+_w->channels;
+      }
+      ret=opw_packet_in(_w,head,head_len,0,0);
+    }
+    else ret=opw_packet_in(_w,_w->tags,_w->tags_size,0,0);
+    if(OP_UNLIKELY(ret<0))return ret;
+    _w->headers++;
+  }
+  return 0;
+}
+
+/*Encodes one frame.
+  _pcm: A whole frame of float samples, or NULL for _pcm16.*/
+static int opw_encode(OggOpusWriter *_w,const float *_pcm,
+ const opus_int16 *_pcm16,int _eos){
+  ogg_int64_t granulepos;
+  opus_int32  ret;
+  if(_pcm!=NULL){
+    ret=opus_multistream_encode_float(_w->enc,_pcm,_w->frame_size,
+     _w->packet,_w->packet_max);
+  }
+  else{
+    ret=opus_multistream_encode(_w->enc,_pcm16,_w->frame_size,
+     _w->packet,_w->packet_max);
+  }
+  if(OP_UNLIKELY(ret<0))return _w->error=OP_EFAULT;
+  granulepos=_w->granulepos+_w->frame_size*_w->rate_scale;
+  _w->granulepos=granulepos;
+  if(_eos){
+    /*End trimming: the decoder discards whatever lies past the last input
+       sample.*/
+    granulepos=_w->pre_skip+_w->nsamples*_w->rate_scale;
+  }
+  return opw_packet_in(_w,_w->packet,ret,granulepos,_eos);
+}
+
+static int opw_write_impl(OggOpusWriter *_w,const float *_pcm,
+ const opus_int16 *_pcm16,int _frame_size){
+  int nconsumed;
+  int ret;
+  if(OP_UNLIKELY(_w->error<0))return _w->error;
+  if(OP_UNLIKELY(_w->eos))return OP_EINVAL;
+  if(OP_UNLIKELY(_frame_size<0))return OP_EINVAL;
+  ret=opw_headers_out(_w);
+  if(ret==OP_FALSE)return _frame_size>0?OP_FALSE:0;
+  if(OP_UNLIKELY(ret<0))return ret;
+  nconsumed=0;
+  while(nconsumed<_frame_size){
+    int navail;
+    ret=opw_pages_out(_w,0);
+    if(ret==OP_FALSE)break;
+    if(OP_UNLIKELY(ret<0))return ret;
+    navail=_frame_size-nconsumed;
+    if(_w->pcm_fill==0&&navail>=_w->frame_size){
+      /*Whole frames are encoded straight from the caller's buffer.*/
+      if(_pcm!=NULL){
+        ret=opw_encode(_w,_pcm+nconsumed*_w->channels,NULL,0);
+      }
+      else ret=opw_encode(_w,NULL,_pcm16+nconsumed*_w->channels,0);
+      if(OP_UNLIKELY(ret<0))return ret;
+      nconsumed+=_w->frame_size;
+      _w->nsamples+=_w->frame_size;
+    }
+    else{
+      float *dst;
+      int    ncopy;
+      int    i;
+      ncopy=OP_MIN(navail,_w->frame_size-_w->pcm_fill);
+      dst=_w->pcm+_w->pcm_fill*_w->channels;
+      if(_pcm!=NULL)memcpy(dst,_pcm+nconsumed*_w->channels,
+       sizeof(*dst)*ncopy*_w->channels);
+      else{
+        const opus_int16 *src;
+        src=_pcm16+nconsumed*_w->channels;
+        for(i=0;i<ncopy*_w->channels;i++)dst[i]=(1.0F/32768)*src[i];
+      }
+      _w->pcm_fill+=ncopy;
+      nconsumed+=ncopy;
+      _w->nsamples+=ncopy;
+      if(_w->pcm_fill==_w->frame_size){
+        ret=opw_encode(_w,_w->pcm,NULL,0);
+        if(OP_UNLIKELY(ret<0))return ret;
+        _w->pcm_fill=0;
+      }
+    }
+  }
+  ret=opw_pages_out(_w,0);
+  if(OP_UNLIKELY(ret<0)&&ret!=OP_FALSE)return ret;
+  /*We only stop short when the output refused a page, and if that left all
+     of the input untouched, say so, rather than return 0 to a caller that
+     might just try again straight away.*/
+  return nconsumed>0||_frame_size<=0?nconsumed:OP_FALSE;
+}
+
+int opw_write(OggOpusWriter *_w,const opus_int16 *_pcm,int _frame_size){
+  return opw_write_impl(_w,NULL,_pcm,_frame_size);
+}
+
+int opw_write_float(OggOpusWriter *_w,const float *_pcm,int _frame_size){
+  return opw_write_impl(_w,_pcm,NULL,_frame_size);
+}
+
+int opw_drain(OggOpusWriter *_w){
+  ogg_int64_t end_granulepos;
+  int         ret;
+  if(OP_UNLIKELY(_w->error<0))return _w->error;
+  if(_w->drained)return 0;
+  ret=opw_headers_out(_w);
+  if(ret<0)return ret;
+  /*Every input sample has come out of the decoder once the granule position
+     covers the pre-skip plus the input length.*/
+  end_granulepos=_w->pre_skip+_w->nsamples*_w->rate_scale;
+  while(!_w->eos){
+    int eos;
+    ret=opw_pages_out(_w,0);
+    if(ret<0)return ret;
+    memset(_w->pcm+_w->pcm_fill*_w->channels,0,
+     sizeof(*_w->pcm)*(_w->frame_size-_w->pcm_fill)*_w->channels);
+    _w->pcm_fill=0;
+    eos=_w->granulepos+_w->frame_size*_w->rate_scale>=end_granulepos;
+    ret=opw_encode(_w,_w->pcm,NULL,eos);
+    if(OP_UNLIKELY(ret<0))return ret;
+    _w->eos=eos;
+  }
+  ret=opw_pages_out(_w,1);
+  if(ret<0)return ret;
+  _w->drained=1;
+  return 0;
+}
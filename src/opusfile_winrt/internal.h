@@ -32,6 +32,7 @@
 #if !defined(_opusfile_winrt_internal_h)
 # define _opusfile_winrt_internal_h (1)
 
+#include <string>
 #include <robuffer.h>
 #include <concrt.h>
 #include <ppltasks.h>
@@ -82,6 +83,26 @@ Platform::String^ string_from_utf8(const char *str, int len = -1)
 }
 
 
+/* convert String to UTF-8 */
+static
+std::string utf8_from_string(Platform::String^ str)
+{
+	if (!str || str->IsEmpty()) return std::string();
+
+	int len = WideCharToMultiByte(CP_UTF8, 0, str->Data(), (int)str->Length(), NULL, 0, NULL, NULL);
+	if (0 == len) {
+		throw ref new Platform::InvalidArgumentException();
+	}
+
+	std::string ret((size_t)len, '\0');
+	if (WideCharToMultiByte(CP_UTF8, 0, str->Data(), (int)str->Length(), &ret[0], len, NULL, NULL) == 0) {
+		throw ref new Platform::InvalidArgumentException();
+	}
+
+	return ret;
+}
+
+
 /* convert int16 array to IBuffer */
 static
 Windows::Storage::Streams::IBuffer^ pack_sample(const opus_int16 *pcm, int size)
@@ -42,6 +42,11 @@ namespace Opusfile {
 			&OggOpusFile::close_func
 		};
 
+		const ::OpusWriterCallbacks opw_winrt_callbacks = {
+			&OggOpusWriter::write_func,
+			nullptr
+		};
+
 
 		OggOpusFile::OggOpusFile()
 			: of_(nullptr), file_stream_(nullptr), file_reader_(nullptr)
@@ -64,6 +69,16 @@ namespace Opusfile {
 		}
 
 		void OggOpusFile::Open(Windows::Storage::Streams::IRandomAccessStream^ fileStream, Windows::Storage::Streams::IBuffer^ initial)
+		{
+			Open(fileStream, initial, nullptr);
+		}
+
+		void OggOpusFile::OpenWithInfo(Windows::Storage::Streams::IRandomAccessStream^ fileStream, OpusFileInfo^ info)
+		{
+			Open(fileStream, nullptr, info ? info->Get() : nullptr);
+		}
+
+		void OggOpusFile::Open(Windows::Storage::Streams::IRandomAccessStream^ fileStream, Windows::Storage::Streams::IBuffer^ initial, ::OpusFileInfo *info)
 		{
 			file_stream_ = fileStream;
 			file_reader_ = ref new Windows::Storage::Streams::DataReader(file_stream_);
@@ -76,7 +91,7 @@ namespace Opusfile {
 			}
 
 			int error = 0;
-			of_ = ::op_open_callbacks((void *)this, &op_winrt_callbacks, initial_data, initial_size, &error);
+			of_ = ::op_open_callbacks_with_info((void *)this, &op_winrt_callbacks, initial_data, initial_size, info, &error);
 
 			if (0 != error) {
 				Free();
@@ -190,6 +205,15 @@ namespace Opusfile {
 			return ref new OpusTags(tags);
 		}
 
+		OpusFileInfo^ OggOpusFile::FileInfo()
+		{
+			_ASSERTE(IsValid);
+			::OpusFileInfo *info = ::op_file_info(of_);
+			if (!info)
+				throw ref new Platform::FailureException();
+			return ref new OpusFileInfo(info);
+		}
+
 		int OggOpusFile::CurrentLink()
 		{
 			_ASSERTE(IsValid);
@@ -242,6 +266,25 @@ namespace Opusfile {
 			::op_set_dither_enabled(of_, enabled ? TRUE : FALSE);
 		}
 
+		void OggOpusFile::SetSeamlessLinks(bool enabled)
+		{
+			_ASSERTE(IsValid);
+			::op_set_seamless_links(of_, enabled ? TRUE : FALSE);
+		}
+
+		void OggOpusFile::SetPipeline(opus_int32 depth)
+		{
+			_ASSERTE(IsValid);
+			int ret = ::op_set_pipeline(of_, depth);
+			if (ret < 0) {
+				if (OP_EINVAL == ret)
+					throw ref new Platform::InvalidArgumentException("depth");
+				if (OP_EFAULT == ret)
+					throw ref new Platform::FailureException();
+				throw ref new Platform::COMException(ret);
+			}
+		}
+
 		Windows::Storage::Streams::IBuffer^ OggOpusFile::Read(int bufSize)
 		{
 			return Read(bufSize, NULL);
@@ -291,6 +334,107 @@ namespace Opusfile {
 			return pack_sample(&pcm.front(), ret * channels);
 		}
 
+		Windows::Storage::Streams::IBuffer^ OggOpusFile::ReadAllFloat(int threads)
+		{
+			_ASSERTE(IsValid);
+
+			ogg_int64_t size = 0;
+			if (::op_seekable(of_)) {
+				int links = ::op_link_count(of_);
+				for (int li = 0; li < links; li++)
+					size += ::op_pcm_total(of_, li) * ::op_channel_count(of_, li);
+			}
+			if (size > UINT_MAX / sizeof(float))
+				throw ref new Platform::OutOfMemoryException();
+
+			Windows::Storage::Streams::IBuffer^ buffer = ref new Windows::Storage::Streams::Buffer((unsigned)size * sizeof(float));
+			ogg_int64_t ret = ::op_read_all_float(of_, reinterpret_cast<float *>(get_array(buffer)), size, threads);
+
+			if (ret < 0) {
+				if (OP_EFAULT == ret)
+					throw ref new Platform::FailureException();
+				throw ref new Platform::COMException((int)ret);
+			}
+
+			buffer->Length = (unsigned)size * sizeof(float);
+			return buffer;
+		}
+
+		Platform::Array<OpusWaveformBin>^ OggOpusFile::ReadWaveform(int bins, opus_int32 binsPerSec)
+		{
+			_ASSERTE(IsValid);
+
+			if (bins < 0)
+				throw ref new Platform::InvalidArgumentException("bins");
+
+			std::vector<::OpusWaveformBin> summary(bins);
+			int ret = ::op_read_waveform(of_, summary.data(), bins, binsPerSec);
+
+			if (ret < 0) {
+				if (OP_EINVAL == ret)
+					throw ref new Platform::InvalidArgumentException("binsPerSec");
+				if (OP_EFAULT == ret)
+					throw ref new Platform::FailureException();
+				if (OP_EIMPL == ret)
+					throw ref new Platform::NotImplementedException();
+				throw ref new Platform::COMException(ret);
+			}
+
+			return ref new Platform::Array<OpusWaveformBin>(reinterpret_cast<OpusWaveformBin *>(summary.data()), (unsigned)ret);
+		}
+
+		Platform::Array<OpusWaveformBin>^ OggOpusFile::ReadAllWaveform(opus_int32 binsPerSec, int threads)
+		{
+			_ASSERTE(IsValid);
+
+			if (binsPerSec < 1 || binsPerSec > 48000)
+				throw ref new Platform::InvalidArgumentException("binsPerSec");
+
+			ogg_int64_t bins = 0;
+			if (::op_seekable(of_))
+				bins = (::op_pcm_total(of_, -1) * binsPerSec + 47999) / 48000;
+			if (bins > UINT_MAX / sizeof(OpusWaveformBin))
+				throw ref new Platform::OutOfMemoryException();
+
+			Platform::Array<OpusWaveformBin>^ summary = ref new Platform::Array<OpusWaveformBin>((unsigned)bins);
+			ogg_int64_t ret = ::op_read_all_waveform(of_, reinterpret_cast<::OpusWaveformBin *>(summary->Data), bins, binsPerSec, threads);
+
+			if (ret < 0) {
+				if (OP_EFAULT == ret)
+					throw ref new Platform::FailureException();
+				throw ref new Platform::COMException((int)ret);
+			}
+
+			return summary;
+		}
+
+		OpusPacket^ OggOpusFile::ReadPacket()
+		{
+			_ASSERTE(IsValid);
+
+			::ogg_packet op;
+			::OpusPacketInfo info;
+			int ret = ::op_read_packet(of_, &op, &info);
+
+			if (ret < 0) {
+				if (OP_EINVAL == ret)
+					throw ref new Platform::InvalidArgumentException();
+				if (OP_EFAULT == ret)
+					throw ref new Platform::FailureException();
+				if (OP_EIMPL == ret)
+					throw ref new Platform::NotImplementedException();
+				throw ref new Platform::COMException(ret);
+			}
+			if (0 == ret)
+				return nullptr;
+
+			Windows::Storage::Streams::IBuffer^ data = ref new Windows::Storage::Streams::Buffer((unsigned)op.bytes);
+			memcpy(get_array(data), op.packet, (size_t)op.bytes);
+			data->Length = (unsigned)op.bytes;
+
+			return ref new OpusPacket(data, op.granulepos, info);
+		}
+
 		void OggOpusFile::RawSeek(opus_int64 byteOffset)
 		{
 			_ASSERTE(IsValid);
@@ -315,6 +459,19 @@ namespace Opusfile {
 			}
 		}
 
+		ogg_int64_t OggOpusFile::PcmSeekApprox(ogg_int64_t pcmOffset, SeekFlags flags)
+		{
+			_ASSERTE(IsValid);
+
+			ogg_int64_t ret = ::op_pcm_seek_approx(of_, pcmOffset, (int)flags);
+			if (ret < 0) {
+				if (OP_EINVAL == ret)
+					throw ref new Platform::InvalidArgumentException();
+				throw ref new Platform::COMException((int)ret);
+			}
+			return ret;
+		}
+
 
 		int OggOpusFile::read_func(void *stream, unsigned char *ptr, int nbytes)
 		{
@@ -368,6 +525,165 @@ namespace Opusfile {
 		}
 
 
+		static void throw_writer_error(int error)
+		{
+			switch (error) {
+			case OP_EFAULT:
+				throw ref new Platform::FailureException();
+			case OP_EINVAL:
+				throw ref new Platform::InvalidArgumentException();
+			default:
+				throw ref new Platform::COMException(error);
+			}
+		}
+
+
+		OggOpusWriter::OggOpusWriter()
+			: ow_(nullptr), channels_(0), output_stream_(nullptr), output_writer_(nullptr)
+		{
+		}
+
+		OggOpusWriter::~OggOpusWriter()
+		{
+			Free();
+		}
+
+		bool OggOpusWriter::IsValid::get()
+		{
+			return nullptr != ow_ && nullptr != output_stream_ && nullptr != output_writer_;
+		}
+
+		void OggOpusWriter::Open(Windows::Storage::Streams::IOutputStream^ outputStream, opus_int32 sampleRate, int channelCount)
+		{
+			Open(outputStream, sampleRate, channelCount, OpusApplication::Audio);
+		}
+
+		void OggOpusWriter::Open(Windows::Storage::Streams::IOutputStream^ outputStream, opus_int32 sampleRate, int channelCount, OpusApplication application)
+		{
+			output_stream_ = outputStream;
+			output_writer_ = ref new Windows::Storage::Streams::DataWriter(output_stream_);
+			channels_ = channelCount;
+
+			int error = 0;
+			ow_ = ::opw_create_callbacks((void *)this, &opw_winrt_callbacks, sampleRate, channelCount,
+				channelCount > 2 ? 1 : 0, (int)application, &error);
+
+			if (0 != error) {
+				Free();
+				throw_writer_error(error);
+			}
+		}
+
+		void OggOpusWriter::Free()
+		{
+			if (ow_) {
+				::opw_destroy(ow_);
+				ow_ = nullptr;
+			}
+
+			if (output_writer_) {
+				(void)output_writer_->DetachStream();
+				delete output_writer_;
+			}
+
+			output_writer_ = nullptr;
+			output_stream_ = nullptr;
+		}
+
+		void OggOpusWriter::SetBitrate(opus_int32 bitrate)
+		{
+			_ASSERTE(IsValid);
+			if (OPUS_OK != ::opus_multistream_encoder_ctl(::opw_get_encoder(ow_), OPUS_SET_BITRATE(bitrate)))
+				throw ref new Platform::InvalidArgumentException("bitrate");
+		}
+
+		void OggOpusWriter::SetComplexity(int complexity)
+		{
+			_ASSERTE(IsValid);
+			if (OPUS_OK != ::opus_multistream_encoder_ctl(::opw_get_encoder(ow_), OPUS_SET_COMPLEXITY(complexity)))
+				throw ref new Platform::InvalidArgumentException("complexity");
+		}
+
+		void OggOpusWriter::SetFrameSize(int frameSize)
+		{
+			_ASSERTE(IsValid);
+			if (0 != ::opw_set_frame_size(ow_, frameSize))
+				throw ref new Platform::InvalidArgumentException("frameSize");
+		}
+
+		void OggOpusWriter::SetPageLatency(opus_int32 latencyMs)
+		{
+			_ASSERTE(IsValid);
+			if (0 != ::opw_set_page_latency(ow_, latencyMs))
+				throw ref new Platform::InvalidArgumentException("latencyMs");
+		}
+
+		void OggOpusWriter::SetPageSize(int pageSize)
+		{
+			_ASSERTE(IsValid);
+			if (0 != ::opw_set_page_size(ow_, pageSize))
+				throw ref new Platform::InvalidArgumentException("pageSize");
+		}
+
+		void OggOpusWriter::AddComment(Platform::String^ tag, Platform::String^ value)
+		{
+			_ASSERTE(IsValid);
+			std::string tag_utf8 = utf8_from_string(tag);
+			std::string value_utf8 = utf8_from_string(value);
+			int ret = ::opw_comment_add(ow_, tag_utf8.c_str(), value_utf8.c_str());
+			if (0 != ret)
+				throw_writer_error(ret);
+		}
+
+		void OggOpusWriter::Write(Windows::Storage::Streams::IBuffer^ pcm)
+		{
+			_ASSERTE(IsValid);
+
+			/* The samples are encoded in place, straight from the buffer */
+			const opus_int16 *samples = reinterpret_cast<const opus_int16 *>(get_array(pcm));
+			int frame_size = (int)(pcm->Length / (2 * channels_));
+
+			while (frame_size > 0) {
+				int ret = ::opw_write(ow_, samples, frame_size);
+				if (ret < 0)
+					throw_writer_error(ret);
+				samples += ret * channels_;
+				frame_size -= ret;
+			}
+
+			Store();
+		}
+
+		void OggOpusWriter::Drain()
+		{
+			_ASSERTE(IsValid);
+
+			int ret = ::opw_drain(ow_);
+			if (0 != ret)
+				throw_writer_error(ret);
+
+			Store();
+			(void)perform_synchronously(output_writer_->FlushAsync());
+		}
+
+		void OggOpusWriter::Store()
+		{
+			if (output_writer_->UnstoredBufferLength > 0)
+				(void)perform_synchronously(output_writer_->StoreAsync());
+		}
+
+
+		int OggOpusWriter::write_func(void *stream, const unsigned char *header, opus_int32 header_len,
+			const unsigned char *body, opus_int32 body_len)
+		{
+			OggOpusWriter^ instance = reinterpret_cast<OggOpusWriter^>(stream);
+			_ASSERTE(instance && instance->output_writer_);
+			/* DataWriter keeps the page until the next Store() */
+			instance->output_writer_->WriteBytes(Platform::ArrayReference<uint8>(const_cast<uint8 *>(header), header_len));
+			instance->output_writer_->WriteBytes(Platform::ArrayReference<uint8>(const_cast<uint8 *>(body), body_len));
+			return 0;
+		}
+
 		Platform::Array<OpusPictureTag^>^ OpusPictureTag::Parse(OpusTags^ opusTags)
 		{
 			std::vector<OpusPictureTag^> pics;
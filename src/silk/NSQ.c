@@ -68,7 +68,7 @@ static OPUS_INLINE void silk_noise_shape_quantizer(
     opus_int            predictLPCOrder         /* I    Prediction filter order         */
 );
 
-void silk_NSQ(
+void silk_NSQ_c(
     const silk_encoder_state    *psEncC,                                    /* I/O  Encoder State                   */
     silk_nsq_state              *NSQ,                                       /* I/O  NSQ state                       */
     SideInfoIndices             *psIndices,                                 /* I/O  Quantization Indices            */
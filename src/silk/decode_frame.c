@@ -32,6 +32,7 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "main.h"
 #include "stack_alloc.h"
 #include "PLC.h"
+#include "profile.h"
 
 /****************/
 /* Decode frame */
@@ -42,12 +43,14 @@ opus_int silk_decode_frame(
     opus_int16                  pOut[],                         /* O    Pointer to output speech frame              */
     opus_int32                  *pN,                            /* O    Pointer to size of output frame             */
     opus_int                    lostFlag,                       /* I    0: no loss, 1 loss, 2 decode fec            */
-    opus_int                    condCoding                      /* I    The type of conditional coding to use       */
+    opus_int                    condCoding,                     /* I    The type of conditional coding to use       */
+    int                         arch                            /* I    Run-time architecture                       */
 )
 {
     VARDECL( silk_decoder_control, psDecCtrl );
     opus_int         L, mv_len, ret = 0;
     VARDECL( opus_int, pulses );
+    OPUS_PROFILE_DECL;
     SAVE_STACK;
 
     L = psDec->frame_length;
@@ -81,7 +84,9 @@ opus_int silk_decode_frame(
         /********************************************************/
         /* Run inverse NSQ                                      */
         /********************************************************/
-        silk_decode_core( psDec, psDecCtrl, pOut, pulses );
+        OPUS_PROFILE_START();
+        silk_decode_core( psDec, psDecCtrl, pOut, pulses, arch );
+        OPUS_PROFILE_STOP( OPUS_PROFILE_SILK_DECODE_CORE );
 
         /********************************************************/
         /* Update PLC state                                     */
@@ -97,7 +97,7 @@ opus_int silk_pitch_analysis_core(                  /* O    Voicing estimate: 0
     VARDECL( opus_int16, frame_4kHz );
     opus_int32 filt_state[ 6 ];
     const opus_int16 *input_frame_ptr;
-    opus_int   i, k, d, j;
+    opus_int   i, k, d, j, j_end, d_max;
     VARDECL( opus_int16, C );
     VARDECL( opus_int32, xcorr32 );
     const opus_int16 *target_ptr, *basis_ptr;
@@ -177,7 +177,8 @@ opus_int silk_pitch_analysis_core(                  /* O    Voicing estimate: 0
     * FIRST STAGE, operating in 4 khz
     ******************************************************************************/
     ALLOC( C, nb_subfr * CSTRIDE_8KHZ, opus_int16 );
-    ALLOC( xcorr32, MAX_LAG_4KHZ-MIN_LAG_4KHZ+1, opus_int32 );
+    /* Also holds the second stage correlations of a run of lags */
+    ALLOC( xcorr32, CSTRIDE_8KHZ, opus_int32 );
     silk_memset( C, 0, (nb_subfr >> 1) * CSTRIDE_4KHZ * sizeof( opus_int16 ) );
     target_ptr = &frame_4kHz[ silk_LSHIFT( SF_LENGTH_4KHZ, 2 ) ];
     for( k = 0; k < nb_subfr >> 1; k++ ) {
@@ -335,24 +336,41 @@ opus_int silk_pitch_analysis_core(                  /* O    Voicing estimate: 0
         silk_assert( target_ptr + SF_LENGTH_8KHZ <= frame_8kHz + frame_length_8kHz );
 
         energy_target = silk_ADD32( silk_inner_prod_aligned( target_ptr, target_ptr, SF_LENGTH_8KHZ ), 1 );
-        for( j = 0; j < length_d_comp; j++ ) {
-            d = d_comp[ j ];
-            basis_ptr = target_ptr - d;
+        for( j = 0; j < length_d_comp; j = j_end ) {
+            /* Find the run of consecutive lags starting at this one */
+            j_end = j + 1;
+            while( j_end < length_d_comp && d_comp[ j_end ] == d_comp[ j_end - 1 ] + 1 ) {
+                j_end++;
+            }
+            d_max = d_comp[ j_end - 1 ];
 
             /* Check that we are within range of the array */
-            silk_assert( basis_ptr >= frame_8kHz );
-            silk_assert( basis_ptr + SF_LENGTH_8KHZ <= frame_8kHz + frame_length_8kHz );
-
-            cross_corr = silk_inner_prod_aligned( target_ptr, basis_ptr, SF_LENGTH_8KHZ );
-            if( cross_corr > 0 ) {
-                energy_basis = silk_inner_prod_aligned( basis_ptr, basis_ptr, SF_LENGTH_8KHZ );
-                matrix_ptr( C, k, d - ( MIN_LAG_8KHZ - 2 ), CSTRIDE_8KHZ ) =
-                    (opus_int16)silk_DIV32_varQ( cross_corr,
-                                                 silk_ADD32( energy_target,
-                                                             energy_basis ),
-                                                 13 + 1 );                                      /* Q13 */
-            } else {
-                matrix_ptr( C, k, d - ( MIN_LAG_8KHZ - 2 ), CSTRIDE_8KHZ ) = 0;
+            silk_assert( target_ptr - d_max >= frame_8kHz );
+            silk_assert( target_ptr - d_comp[ j ] + SF_LENGTH_8KHZ <= frame_8kHz + frame_length_8kHz );
+
+            /* Correlate the whole run at once */
+            celt_pitch_xcorr( target_ptr, target_ptr - d_max, xcorr32, SF_LENGTH_8KHZ, d_max - d_comp[ j ] + 1, arch );
+
+            /* Energy of the first lag, from then on computed recursively */
+            basis_ptr = target_ptr - d_comp[ j ];
+            energy_basis = silk_inner_prod_aligned( basis_ptr, basis_ptr, SF_LENGTH_8KHZ );
+            for( d = d_comp[ j ]; d <= d_max; d++ ) {
+                if( d > d_comp[ j ] ) {
+                    basis_ptr--;
+                    energy_basis = silk_ADD32( energy_basis,
+                        silk_SMULBB( basis_ptr[ 0 ], basis_ptr[ 0 ] ) -
+                        silk_SMULBB( basis_ptr[ SF_LENGTH_8KHZ ], basis_ptr[ SF_LENGTH_8KHZ ] ) );
+                }
+                cross_corr = xcorr32[ d_max - d ];
+                if( cross_corr > 0 ) {
+                    matrix_ptr( C, k, d - ( MIN_LAG_8KHZ - 2 ), CSTRIDE_8KHZ ) =
+                        (opus_int16)silk_DIV32_varQ( cross_corr,
+                                                     silk_ADD32( energy_target,
+                                                                 energy_basis ),
+                                                     13 + 1 );                                  /* Q13 */
+                } else {
+                    matrix_ptr( C, k, d - ( MIN_LAG_8KHZ - 2 ), CSTRIDE_8KHZ ) = 0;
+                }
             }
         }
         target_ptr += SF_LENGTH_8KHZ;
@@ -30,6 +30,7 @@ POSSIBILITY OF SUCH DAMAGE.
 
 #include "SigProc_FIX.h"
 #include "float_cast.h"
+#include "x86/SigProc_FLP_avx2.h"
 #include <math.h>
 
 #ifdef  __cplusplus
@@ -76,13 +77,18 @@ silk_float silk_levinsondurbin_FLP(         /* O    prediction error energy
 );
 
 /* compute autocorrelation */
-void silk_autocorrelation_FLP(
+void silk_autocorrelation_FLP_c(
     silk_float          *results,           /* O    result (length correlationCount)                            */
     const silk_float    *inputData,         /* I    input data to correlate                                     */
     opus_int            inputDataSize,      /* I    length of input                                             */
     opus_int            correlationCount    /* I    number of correlation taps to compute                       */
 );
 
+#if !defined(OVERRIDE_silk_autocorrelation_FLP)
+#define silk_autocorrelation_FLP(results, inputData, inputDataSize, correlationCount, arch) \
+    ((void)(arch),silk_autocorrelation_FLP_c(results, inputData, inputDataSize, correlationCount))
+#endif
+
 opus_int silk_pitch_analysis_core_FLP(      /* O    Voicing estimate: 0 voiced, 1 unvoiced                      */
     const silk_float    *frame,             /* I    Signal of length PE_FRAME_LENGTH_MS*Fs_kHz                  */
     opus_int            *pitch_out,         /* O    Pitch lag values [nb_subfr]                                 */
@@ -106,7 +112,7 @@ void silk_insertion_sort_decreasing_FLP(
 );
 
 /* Compute reflection coefficients from input signal */
-silk_float silk_burg_modified_FLP(          /* O    returns residual energy                                     */
+silk_float silk_burg_modified_FLP_c(        /* O    returns residual energy                                     */
     silk_float          A[],                /* O    prediction coefficients (length order)                      */
     const silk_float    x[],                /* I    input signal, length: nb_subfr*(D+L_sub)                    */
     const silk_float    minInvGain,         /* I    minimum inverse prediction gain                             */
@@ -115,6 +121,11 @@ silk_float silk_burg_modified_FLP(          /* O    returns residual energy
     const opus_int      D                   /* I    order                                                       */
 );
 
+#if !defined(OVERRIDE_silk_burg_modified_FLP)
+#define silk_burg_modified_FLP(A, x, minInvGain, subfr_length, nb_subfr, D, arch) \
+    ((void)(arch),silk_burg_modified_FLP_c(A, x, minInvGain, subfr_length, nb_subfr, D))
+#endif
+
 /* multiply a vector by a constant */
 void silk_scale_vector_FLP(
     silk_float          *data1,
@@ -131,18 +142,42 @@ void silk_scale_copy_vector_FLP(
 );
 
 /* inner product of two silk_float arrays, with result as double */
-double silk_inner_product_FLP(
+double silk_inner_product_FLP_c(
     const silk_float    *data1,
     const silk_float    *data2,
     opus_int            dataSize
 );
 
+#if !defined(OVERRIDE_silk_inner_product_FLP)
+#define silk_inner_product_FLP(data1, data2, dataSize, arch) \
+    ((void)(arch),silk_inner_product_FLP_c(data1, data2, dataSize))
+#endif
+
+/* inner products of x with y at max_pitch consecutive lags: xcorr[ i ] = x . y[ i .. i + len - 1 ] */
+void silk_pitch_xcorr_FLP_c(
+    const silk_float    *x,
+    const silk_float    *y,
+    double              *xcorr,
+    opus_int            len,
+    opus_int            max_pitch
+);
+
+#if !defined(OVERRIDE_silk_pitch_xcorr_FLP)
+#define silk_pitch_xcorr_FLP(x, y, xcorr, len, max_pitch, arch) \
+    ((void)(arch),silk_pitch_xcorr_FLP_c(x, y, xcorr, len, max_pitch))
+#endif
+
 /* sum of squares of a silk_float array, with result as double */
-double silk_energy_FLP(
+double silk_energy_FLP_c(
     const silk_float    *data,
     opus_int            dataSize
 );
 
+#if !defined(OVERRIDE_silk_energy_FLP)
+#define silk_energy_FLP(data, dataSize, arch) \
+    ((void)(arch),silk_energy_FLP_c(data, dataSize))
+#endif
+
 /********************************************************************/
 /*                                MACROS                            */
 /********************************************************************/
@@ -41,7 +41,8 @@ void silk_find_LTP_FLP(
     const silk_float                Wght[ MAX_NB_SUBFR ],               /* I    Weights                                     */
     const opus_int                  subfr_length,                       /* I    Subframe length                             */
     const opus_int                  nb_subfr,                           /* I    number of subframes                         */
-    const opus_int                  mem_offset                          /* I    Number of samples in LTP memory             */
+    const opus_int                  mem_offset,                         /* I    Number of samples in LTP memory             */
+    int                             arch                                /* I    Run-time architecture                       */
 )
 {
     opus_int   i, k;
@@ -58,10 +59,10 @@ void silk_find_LTP_FLP(
     for( k = 0; k < nb_subfr; k++ ) {
         lag_ptr = r_ptr - ( lag[ k ] + LTP_ORDER / 2 );
 
-        silk_corrMatrix_FLP( lag_ptr, subfr_length, LTP_ORDER, WLTP_ptr );
-        silk_corrVector_FLP( lag_ptr, r_ptr, subfr_length, LTP_ORDER, Rr );
+        silk_corrMatrix_FLP( lag_ptr, subfr_length, LTP_ORDER, WLTP_ptr, arch );
+        silk_corrVector_FLP( lag_ptr, r_ptr, subfr_length, LTP_ORDER, Rr, arch );
 
-        rr[ k ] = ( silk_float )silk_energy_FLP( r_ptr, subfr_length );
+        rr[ k ] = ( silk_float )silk_energy_FLP( r_ptr, subfr_length, arch );
         regu = 1.0f + rr[ k ] +
             matrix_ptr( WLTP_ptr, 0, 0, LTP_ORDER ) +
             matrix_ptr( WLTP_ptr, LTP_ORDER-1, LTP_ORDER-1, LTP_ORDER );
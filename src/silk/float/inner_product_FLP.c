@@ -32,7 +32,7 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "SigProc_FLP.h"
 
 /* inner product of two silk_float arrays, with result as double */
-double silk_inner_product_FLP(
+double silk_inner_product_FLP_c(
     const silk_float    *data1,
     const silk_float    *data2,
     opus_int            dataSize
@@ -58,3 +58,19 @@ double silk_inner_product_FLP(
 
     return result;
 }
+
+/* inner products of x with y at max_pitch consecutive lags */
+void silk_pitch_xcorr_FLP_c(
+    const silk_float    *x,
+    const silk_float    *y,
+    double              *xcorr,
+    opus_int            len,
+    opus_int            max_pitch
+)
+{
+    opus_int i;
+
+    for( i = 0; i < max_pitch; i++ ) {
+        xcorr[ i ] = silk_inner_product_FLP_c( y + i, x, len );
+    }
+}
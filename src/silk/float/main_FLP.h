@@ -107,7 +107,7 @@ void silk_noise_shape_analysis_FLP(
 );
 
 /* Autocorrelations for a warped frequency axis */
-void silk_warped_autocorrelation_FLP(
+void silk_warped_autocorrelation_FLP_c(
     silk_float                      *corr,                              /* O    Result [order + 1]                          */
     const silk_float                *input,                             /* I    Input data to correlate                     */
     const silk_float                warping,                            /* I    Warping coefficient                         */
@@ -115,6 +115,11 @@ void silk_warped_autocorrelation_FLP(
     const opus_int                  order                               /* I    Correlation order (even)                    */
 );
 
+#if !defined(OVERRIDE_silk_warped_autocorrelation_FLP)
+#define silk_warped_autocorrelation_FLP(corr, input, warping, length, order, arch) \
+    ((void)(arch),silk_warped_autocorrelation_FLP_c(corr, input, warping, length, order))
+#endif
+
 /* Calculation of LTP state scaling */
 void silk_LTP_scale_ctrl_FLP(
     silk_encoder_state_FLP          *psEnc,                             /* I/O  Encoder state FLP                           */
@@ -161,7 +166,8 @@ void silk_find_LTP_FLP(
     const silk_float                Wght[ MAX_NB_SUBFR ],               /* I    Weights                                     */
     const opus_int                  subfr_length,                       /* I    Subframe length                             */
     const opus_int                  nb_subfr,                           /* I    number of subframes                         */
-    const opus_int                  mem_offset                          /* I    Number of samples in LTP memory             */
+    const opus_int                  mem_offset,                         /* I    Number of samples in LTP memory             */
+    int                             arch                                /* I    Run-time architecture                       */
 );
 
 void silk_LTP_analysis_filter_FLP(
@@ -184,7 +190,8 @@ void silk_residual_energy_FLP(
     const silk_float                gains[],                            /* I    Quantization gains                          */
     const opus_int                  subfr_length,                       /* I    Subframe length                             */
     const opus_int                  nb_subfr,                           /* I    number of subframes                         */
-    const opus_int                  LPC_order                           /* I    LPC order                                   */
+    const opus_int                  LPC_order,                          /* I    LPC order                                   */
+    int                             arch                                /* I    Run-time architecture                       */
 );
 
 /* 16th order LPC analysis filter */
@@ -232,7 +239,8 @@ void silk_corrMatrix_FLP(
     const silk_float                *x,                                 /* I    x vector [ L+order-1 ] used to create X     */
     const opus_int                  L,                                  /* I    Length of vectors                           */
     const opus_int                  Order,                              /* I    Max lag for correlation                     */
-    silk_float                      *XX                                 /* O    X'*X correlation matrix [order x order]     */
+    silk_float                      *XX,                                /* O    X'*X correlation matrix [order x order]     */
+    int                             arch                                /* I    Run-time architecture                       */
 );
 
 /* Calculates correlation vector X'*t */
@@ -241,7 +249,8 @@ void silk_corrVector_FLP(
     const silk_float                *t,                                 /* I    Target vector [L]                           */
     const opus_int                  L,                                  /* I    Length of vecors                            */
     const opus_int                  Order,                              /* I    Max lag for correlation                     */
-    silk_float                      *Xt                                 /* O    X'*t correlation vector [order]             */
+    silk_float                      *Xt,                                /* O    X'*t correlation vector [order]             */
+    int                             arch                                /* I    Run-time architecture                       */
 );
 
 /* Add noise to matrix diagonal */
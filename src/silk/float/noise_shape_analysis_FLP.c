@@ -184,7 +184,7 @@ void silk_noise_shape_analysis_FLP(
         log_energy_prev  = 0.0f;
         pitch_res_ptr = pitch_res;
         for( k = 0; k < silk_SMULBB( SUB_FRAME_LENGTH_MS, psEnc->sCmn.nb_subfr ) / 2; k++ ) {
-            nrg = ( silk_float )nSamples + ( silk_float )silk_energy_FLP( pitch_res_ptr, nSamples );
+            nrg = ( silk_float )nSamples + ( silk_float )silk_energy_FLP( pitch_res_ptr, nSamples, psEnc->sCmn.arch );
             log_energy = silk_log2( nrg );
             if( k > 0 ) {
                 energy_variation += silk_abs_float( log_energy - log_energy_prev );
@@ -245,10 +245,10 @@ void silk_noise_shape_analysis_FLP(
         if( psEnc->sCmn.warping_Q16 > 0 ) {
             /* Calculate warped auto correlation */
             silk_warped_autocorrelation_FLP( auto_corr, x_windowed, warping,
-                psEnc->sCmn.shapeWinLength, psEnc->sCmn.shapingLPCOrder );
+                psEnc->sCmn.shapeWinLength, psEnc->sCmn.shapingLPCOrder, psEnc->sCmn.arch );
         } else {
             /* Calculate regular auto correlation */
-            silk_autocorrelation_FLP( auto_corr, x_windowed, psEnc->sCmn.shapeWinLength, psEnc->sCmn.shapingLPCOrder + 1 );
+            silk_autocorrelation_FLP( auto_corr, x_windowed, psEnc->sCmn.shapeWinLength, psEnc->sCmn.shapingLPCOrder + 1, psEnc->sCmn.arch );
         }
 
         /* Add white noise, as a fraction of energy */
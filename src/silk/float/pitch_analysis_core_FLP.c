@@ -58,7 +58,8 @@ static void silk_P_Ana_calc_energy_st3(
     opus_int            start_lag,          /* I start lag                                                      */
     opus_int            sf_length,          /* I sub frame length                                               */
     opus_int            nb_subfr,           /* I number of subframes                                            */
-    opus_int            complexity          /* I Complexity setting                                             */
+    opus_int            complexity,         /* I Complexity setting                                             */
+    int                 arch                /* I Run-time architecture                                          */
 );
 
 /************************************************************/
@@ -79,7 +80,7 @@ opus_int silk_pitch_analysis_core_FLP(      /* O    Voicing estimate: 0 voiced,
     int                 arch                /* I    Run-time architecture                                       */
 )
 {
-    opus_int   i, k, d, j;
+    opus_int   i, k, d, j, j_end, d_max;
     silk_float frame_8kHz[  PE_MAX_FRAME_LENGTH_MS * 8 ];
     silk_float frame_4kHz[  PE_MAX_FRAME_LENGTH_MS * 4 ];
     opus_int16 frame_8_FIX[ PE_MAX_FRAME_LENGTH_MS * 8 ];
@@ -88,6 +89,7 @@ opus_int silk_pitch_analysis_core_FLP(      /* O    Voicing estimate: 0 voiced,
     silk_float threshold, contour_bias;
     silk_float C[ PE_MAX_NB_SUBFR][ (PE_MAX_LAG >> 1) + 5 ];
     opus_val32 xcorr[ PE_MAX_LAG_MS * 4 - PE_MIN_LAG_MS * 4 + 1 ];
+    double     xcorr_st2[ (PE_MAX_LAG >> 1) + 5 ];
     silk_float CC[ PE_NB_CBKS_STAGE2_EXT ];
     const silk_float *target_ptr, *basis_ptr;
     double    cross_corr, normalizer, energy, energy_tmp;
@@ -182,8 +184,8 @@ opus_int silk_pitch_analysis_core_FLP(      /* O    Voicing estimate: 0 voiced,
 
         /* Calculate first vector products before loop */
         cross_corr = xcorr[ max_lag_4kHz - min_lag_4kHz ];
-        normalizer = silk_energy_FLP( target_ptr, sf_length_8kHz ) + 
-                     silk_energy_FLP( basis_ptr,  sf_length_8kHz ) + 
+        normalizer = silk_energy_FLP( target_ptr, sf_length_8kHz, arch ) + 
+                     silk_energy_FLP( basis_ptr,  sf_length_8kHz, arch ) + 
                      sf_length_8kHz * 4000.0f;
 
         C[ 0 ][ min_lag_4kHz ] += (silk_float)( 2 * cross_corr / normalizer );
@@ -287,16 +289,33 @@ opus_int silk_pitch_analysis_core_FLP(      /* O    Voicing estimate: 0 voiced,
         target_ptr = &frame_8kHz[ PE_LTP_MEM_LENGTH_MS * 8 ];
     }
     for( k = 0; k < nb_subfr; k++ ) {
-        energy_tmp = silk_energy_FLP( target_ptr, sf_length_8kHz ) + 1.0;
-        for( j = 0; j < length_d_comp; j++ ) {
-            d = d_comp[ j ];
-            basis_ptr = target_ptr - d;
-            cross_corr = silk_inner_product_FLP( basis_ptr, target_ptr, sf_length_8kHz );
-            if( cross_corr > 0.0f ) {
-                energy = silk_energy_FLP( basis_ptr, sf_length_8kHz );
-                C[ k ][ d ] = (silk_float)( 2 * cross_corr / ( energy + energy_tmp ) );
-            } else {
-                C[ k ][ d ] = 0.0f;
+        energy_tmp = silk_energy_FLP( target_ptr, sf_length_8kHz, arch ) + 1.0;
+        for( j = 0; j < length_d_comp; j = j_end ) {
+            /* Find the run of consecutive lags starting at this one */
+            j_end = j + 1;
+            while( j_end < length_d_comp && d_comp[ j_end ] == d_comp[ j_end - 1 ] + 1 ) {
+                j_end++;
+            }
+            d_max = d_comp[ j_end - 1 ];
+
+            /* Correlate the whole run at once */
+            silk_pitch_xcorr_FLP( target_ptr, target_ptr - d_max, xcorr_st2, sf_length_8kHz, d_max - d_comp[ j ] + 1, arch );
+
+            /* Energy of the first lag, from then on computed recursively */
+            basis_ptr = target_ptr - d_comp[ j ];
+            energy = silk_energy_FLP( basis_ptr, sf_length_8kHz, arch );
+            for( d = d_comp[ j ]; d <= d_max; d++ ) {
+                if( d > d_comp[ j ] ) {
+                    basis_ptr--;
+                    energy += basis_ptr[ 0 ] * (double)basis_ptr[ 0 ] -
+                              basis_ptr[ sf_length_8kHz ] * (double)basis_ptr[ sf_length_8kHz ];
+                }
+                cross_corr = xcorr_st2[ d_max - d ];
+                if( cross_corr > 0.0f ) {
+                    C[ k ][ d ] = (silk_float)( 2 * cross_corr / ( energy + energy_tmp ) );
+                } else {
+                    C[ k ][ d ] = 0.0f;
+                }
             }
         }
         target_ptr += sf_length_8kHz;
@@ -412,7 +431,7 @@ opus_int silk_pitch_analysis_core_FLP(      /* O    Voicing estimate: 0 voiced,
 
         /* Calculate the correlations and energies needed in stage 3 */
         silk_P_Ana_calc_corr_st3( cross_corr_st3, frame, start_lag, sf_length, nb_subfr, complexity, arch );
-        silk_P_Ana_calc_energy_st3( energies_st3, frame, start_lag, sf_length, nb_subfr, complexity );
+        silk_P_Ana_calc_energy_st3( energies_st3, frame, start_lag, sf_length, nb_subfr, complexity, arch );
 
         lag_counter = 0;
         silk_assert( lag == silk_SAT16( lag ) );
@@ -430,7 +449,7 @@ opus_int silk_pitch_analysis_core_FLP(      /* O    Voicing estimate: 0 voiced,
         }
 
         target_ptr = &frame[ PE_LTP_MEM_LENGTH_MS * Fs_kHz ];
-        energy_tmp = silk_energy_FLP( target_ptr, nb_subfr * sf_length ) + 1.0;
+        energy_tmp = silk_energy_FLP( target_ptr, nb_subfr * sf_length, arch ) + 1.0;
         for( d = start_lag; d <= end_lag; d++ ) {
             for( j = 0; j < nb_cbk_search; j++ ) {
                 cross_corr = 0.0;
@@ -562,7 +581,8 @@ static void silk_P_Ana_calc_energy_st3(
     opus_int            start_lag,          /* I start lag                                                      */
     opus_int            sf_length,          /* I sub frame length                                               */
     opus_int            nb_subfr,           /* I number of subframes                                            */
-    opus_int            complexity          /* I Complexity setting                                             */
+    opus_int            complexity,         /* I Complexity setting                                             */
+    int                 arch                /* I Run-time architecture                                          */
 )
 {
     const silk_float *target_ptr, *basis_ptr;
@@ -594,7 +614,7 @@ static void silk_P_Ana_calc_energy_st3(
 
         /* Calculate the energy for first lag */
         basis_ptr = target_ptr - ( start_lag + matrix_ptr( Lag_range_ptr, k, 0, 2 ) );
-        energy = silk_energy_FLP( basis_ptr, sf_length ) + 1e-3;
+        energy = silk_energy_FLP( basis_ptr, sf_length, arch ) + 1e-3;
         silk_assert( energy >= 0.0 );
         scratch_mem[lag_counter] = (silk_float)energy;
         lag_counter++;
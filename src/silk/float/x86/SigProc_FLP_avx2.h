@@ -0,0 +1,167 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef SIGPROC_FLP_AVX2_H
+#define SIGPROC_FLP_AVX2_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cpu_support.h"
+
+# if defined(OPUS_X86_MAY_HAVE_AVX2)
+
+double silk_inner_product_FLP_avx2(
+    const silk_float    *data1,
+    const silk_float    *data2,
+    opus_int            dataSize
+);
+
+void silk_pitch_xcorr_FLP_avx2(
+    const silk_float    *x,
+    const silk_float    *y,
+    double              *xcorr,
+    opus_int            len,
+    opus_int            max_pitch
+);
+
+double silk_energy_FLP_avx2(
+    const silk_float    *data,
+    opus_int            dataSize
+);
+
+void silk_autocorrelation_FLP_avx2(
+    silk_float          *results,           /* O    result (length correlationCount)                            */
+    const silk_float    *inputData,         /* I    input data to correlate                                     */
+    opus_int            inputDataSize,      /* I    length of input                                             */
+    opus_int            correlationCount    /* I    number of correlation taps to compute                       */
+);
+
+silk_float silk_burg_modified_FLP_avx2(     /* O    returns residual energy                                     */
+    silk_float          A[],                /* O    prediction coefficients (length order)                      */
+    const silk_float    x[],                /* I    input signal, length: nb_subfr*(D+L_sub)                    */
+    const silk_float    minInvGain,         /* I    minimum inverse prediction gain                             */
+    const opus_int      subfr_length,       /* I    input signal subframe length (incl. D preceding samples)    */
+    const opus_int      nb_subfr,           /* I    number of subframes stacked in x                            */
+    const opus_int      D                   /* I    order                                                       */
+);
+
+void silk_warped_autocorrelation_FLP_avx2(
+    silk_float          *corr,              /* O    Result [order + 1]                                          */
+    const silk_float    *input,             /* I    Input data to correlate                                     */
+    const silk_float    warping,            /* I    Warping coefficient                                         */
+    const opus_int      length,             /* I    Length of input                                             */
+    const opus_int      order               /* I    Correlation order (even)                                    */
+);
+
+#  if defined(OPUS_X86_PRESUME_AVX2)
+#   define OVERRIDE_silk_inner_product_FLP
+#   define silk_inner_product_FLP(data1, data2, dataSize, arch) \
+    ((void)(arch),silk_inner_product_FLP_avx2(data1, data2, dataSize))
+#   define OVERRIDE_silk_pitch_xcorr_FLP
+#   define silk_pitch_xcorr_FLP(x, y, xcorr, len, max_pitch, arch) \
+    ((void)(arch),silk_pitch_xcorr_FLP_avx2(x, y, xcorr, len, max_pitch))
+#   define OVERRIDE_silk_energy_FLP
+#   define silk_energy_FLP(data, dataSize, arch) \
+    ((void)(arch),silk_energy_FLP_avx2(data, dataSize))
+#   define OVERRIDE_silk_autocorrelation_FLP
+#   define silk_autocorrelation_FLP(results, inputData, inputDataSize, correlationCount, arch) \
+    ((void)(arch),silk_autocorrelation_FLP_avx2(results, inputData, inputDataSize, correlationCount))
+#   define OVERRIDE_silk_burg_modified_FLP
+#   define silk_burg_modified_FLP(A, x, minInvGain, subfr_length, nb_subfr, D, arch) \
+    ((void)(arch),silk_burg_modified_FLP_avx2(A, x, minInvGain, subfr_length, nb_subfr, D))
+#   define OVERRIDE_silk_warped_autocorrelation_FLP
+#   define silk_warped_autocorrelation_FLP(corr, input, warping, length, order, arch) \
+    ((void)(arch),silk_warped_autocorrelation_FLP_avx2(corr, input, warping, length, order))
+
+#  elif defined(OPUS_HAVE_RTCD)
+#   define OVERRIDE_silk_inner_product_FLP
+extern double (*const SILK_INNER_PRODUCT_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_float    *data1,
+    const silk_float    *data2,
+    opus_int            dataSize
+);
+#   define silk_inner_product_FLP(data1, data2, dataSize, arch) \
+    ((*SILK_INNER_PRODUCT_FLP_IMPL[(arch) & OPUS_ARCHMASK])(data1, data2, dataSize))
+
+#   define OVERRIDE_silk_pitch_xcorr_FLP
+extern void (*const SILK_PITCH_XCORR_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_float    *x,
+    const silk_float    *y,
+    double              *xcorr,
+    opus_int            len,
+    opus_int            max_pitch
+);
+#   define silk_pitch_xcorr_FLP(x, y, xcorr, len, max_pitch, arch) \
+    ((*SILK_PITCH_XCORR_FLP_IMPL[(arch) & OPUS_ARCHMASK])(x, y, xcorr, len, max_pitch))
+
+#   define OVERRIDE_silk_energy_FLP
+extern double (*const SILK_ENERGY_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_float    *data,
+    opus_int            dataSize
+);
+#   define silk_energy_FLP(data, dataSize, arch) \
+    ((*SILK_ENERGY_FLP_IMPL[(arch) & OPUS_ARCHMASK])(data, dataSize))
+
+#   define OVERRIDE_silk_autocorrelation_FLP
+extern void (*const SILK_AUTOCORRELATION_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    silk_float          *results,
+    const silk_float    *inputData,
+    opus_int            inputDataSize,
+    opus_int            correlationCount
+);
+#   define silk_autocorrelation_FLP(results, inputData, inputDataSize, correlationCount, arch) \
+    ((*SILK_AUTOCORRELATION_FLP_IMPL[(arch) & OPUS_ARCHMASK])(results, inputData, inputDataSize, correlationCount))
+
+#   define OVERRIDE_silk_burg_modified_FLP
+extern silk_float (*const SILK_BURG_MODIFIED_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    silk_float          A[],
+    const silk_float    x[],
+    const silk_float    minInvGain,
+    const opus_int      subfr_length,
+    const opus_int      nb_subfr,
+    const opus_int      D
+);
+#   define silk_burg_modified_FLP(A, x, minInvGain, subfr_length, nb_subfr, D, arch) \
+    ((*SILK_BURG_MODIFIED_FLP_IMPL[(arch) & OPUS_ARCHMASK])(A, x, minInvGain, subfr_length, nb_subfr, D))
+
+#   define OVERRIDE_silk_warped_autocorrelation_FLP
+extern void (*const SILK_WARPED_AUTOCORRELATION_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    silk_float          *corr,
+    const silk_float    *input,
+    const silk_float    warping,
+    const opus_int      length,
+    const opus_int      order
+);
+#   define silk_warped_autocorrelation_FLP(corr, input, warping, length, order, arch) \
+    ((*SILK_WARPED_AUTOCORRELATION_FLP_IMPL[(arch) & OPUS_ARCHMASK])(corr, input, warping, length, order))
+
+#  endif
+# endif
+
+#endif
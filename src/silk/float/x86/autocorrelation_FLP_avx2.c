@@ -0,0 +1,90 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_X86_MAY_HAVE_AVX2)
+
+#include <immintrin.h>
+#include "SigProc_FLP.h"
+
+/* compute autocorrelation */
+/* Four lags at a time: each input sample is broadcast and multiplied with the */
+/* four samples it pairs with, so the lags share their loads                   */
+void silk_autocorrelation_FLP_avx2(
+    silk_float          *results,           /* O    result (length correlationCount)                            */
+    const silk_float    *inputData,         /* I    input data to correlate                                     */
+    opus_int            inputDataSize,      /* I    length of input                                             */
+    opus_int            correlationCount    /* I    number of correlation taps to compute                       */
+)
+{
+    opus_int i, j, k, len;
+    double   r[ 4 ];
+    __m256d  acc0, acc1, acc2, acc3, x;
+
+    if( correlationCount > inputDataSize ) {
+        correlationCount = inputDataSize;
+    }
+
+    for( k = 0; k < correlationCount - 3; k += 4 ) {
+        /* All four lags have products for the first inputDataSize - k - 3 samples */
+        len = inputDataSize - k - 3;
+        acc0 = acc1 = acc2 = acc3 = _mm256_setzero_pd();
+        for( i = 0; i < len - 3; i += 4 ) {
+            x    = _mm256_cvtps_pd( _mm_loadu_ps( &inputData[ i ] ) );
+            acc0 = _mm256_fmadd_pd( _mm256_permute4x64_pd( x, 0x00 ),
+                                    _mm256_cvtps_pd( _mm_loadu_ps( &inputData[ i + k + 0 ] ) ), acc0 );
+            acc1 = _mm256_fmadd_pd( _mm256_permute4x64_pd( x, 0x55 ),
+                                    _mm256_cvtps_pd( _mm_loadu_ps( &inputData[ i + k + 1 ] ) ), acc1 );
+            acc2 = _mm256_fmadd_pd( _mm256_permute4x64_pd( x, 0xAA ),
+                                    _mm256_cvtps_pd( _mm_loadu_ps( &inputData[ i + k + 2 ] ) ), acc2 );
+            acc3 = _mm256_fmadd_pd( _mm256_permute4x64_pd( x, 0xFF ),
+                                    _mm256_cvtps_pd( _mm_loadu_ps( &inputData[ i + k + 3 ] ) ), acc3 );
+        }
+        for( ; i < len; i++ ) {
+            acc0 = _mm256_fmadd_pd( _mm256_set1_pd( inputData[ i ] ),
+                                    _mm256_cvtps_pd( _mm_loadu_ps( &inputData[ i + k ] ) ), acc0 );
+        }
+        _mm256_storeu_pd( r, _mm256_add_pd( _mm256_add_pd( acc0, acc1 ), _mm256_add_pd( acc2, acc3 ) ) );
+
+        /* The shorter lags have up to three products left */
+        for( j = 0; j < 4; j++ ) {
+            for( i = len; i < inputDataSize - k - j; i++ ) {
+                r[ j ] += inputData[ i ] * (double)inputData[ i + k + j ];
+            }
+            results[ k + j ] = (silk_float)r[ j ];
+        }
+    }
+
+    for( ; k < correlationCount; k++ ) {
+        results[ k ] = (silk_float)silk_inner_product_FLP_avx2( inputData, inputData + k, inputDataSize - k );
+    }
+}
+
+#endif
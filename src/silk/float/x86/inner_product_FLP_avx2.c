@@ -0,0 +1,156 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_X86_MAY_HAVE_AVX2)
+
+#include <immintrin.h>
+#include "SigProc_FLP.h"
+
+/* Sums the four lanes of a vector */
+static OPUS_INLINE double silk_hsum_pd( __m256d x )
+{
+    __m128d y;
+    y = _mm_add_pd( _mm256_castpd256_pd128( x ), _mm256_extractf128_pd( x, 1 ) );
+    y = _mm_add_sd( y, _mm_unpackhi_pd( y, y ) );
+    return _mm_cvtsd_f64( y );
+}
+
+/* inner product of two silk_float arrays, with result as double */
+/* The products are exact in double precision; only the order in which they */
+/* are summed differs from the C version                                     */
+double silk_inner_product_FLP_avx2(
+    const silk_float    *data1,
+    const silk_float    *data2,
+    opus_int            dataSize
+)
+{
+    opus_int  i;
+    double    result;
+    __m256d   acc0, acc1, acc2, acc3;
+
+    acc0 = acc1 = acc2 = acc3 = _mm256_setzero_pd();
+    for( i = 0; i < dataSize - 15; i += 16 ) {
+        acc0 = _mm256_fmadd_pd( _mm256_cvtps_pd( _mm_loadu_ps( &data1[ i +  0 ] ) ),
+                                _mm256_cvtps_pd( _mm_loadu_ps( &data2[ i +  0 ] ) ), acc0 );
+        acc1 = _mm256_fmadd_pd( _mm256_cvtps_pd( _mm_loadu_ps( &data1[ i +  4 ] ) ),
+                                _mm256_cvtps_pd( _mm_loadu_ps( &data2[ i +  4 ] ) ), acc1 );
+        acc2 = _mm256_fmadd_pd( _mm256_cvtps_pd( _mm_loadu_ps( &data1[ i +  8 ] ) ),
+                                _mm256_cvtps_pd( _mm_loadu_ps( &data2[ i +  8 ] ) ), acc2 );
+        acc3 = _mm256_fmadd_pd( _mm256_cvtps_pd( _mm_loadu_ps( &data1[ i + 12 ] ) ),
+                                _mm256_cvtps_pd( _mm_loadu_ps( &data2[ i + 12 ] ) ), acc3 );
+    }
+    for( ; i < dataSize - 3; i += 4 ) {
+        acc0 = _mm256_fmadd_pd( _mm256_cvtps_pd( _mm_loadu_ps( &data1[ i ] ) ),
+                                _mm256_cvtps_pd( _mm_loadu_ps( &data2[ i ] ) ), acc0 );
+    }
+    result = silk_hsum_pd( _mm256_add_pd( _mm256_add_pd( acc0, acc1 ), _mm256_add_pd( acc2, acc3 ) ) );
+
+    /* add any remaining products */
+    for( ; i < dataSize; i++ ) {
+        result += data1[ i ] * (double)data2[ i ];
+    }
+
+    return result;
+}
+
+/* inner products of x with y at max_pitch consecutive lags */
+/* Like xcorr_kernel(), each sample of x is broadcast and multiplied with the */
+/* samples of y it pairs with at eight lags, so the lags share their loads    */
+void silk_pitch_xcorr_FLP_avx2(
+    const silk_float    *x,
+    const silk_float    *y,
+    double              *xcorr,
+    opus_int            len,
+    opus_int            max_pitch
+)
+{
+    opus_int  i, j;
+    __m256d   acc0, acc1, xj;
+
+    for( i = 0; i < max_pitch - 7; i += 8 ) {
+        acc0 = acc1 = _mm256_setzero_pd();
+        for( j = 0; j < len; j++ ) {
+            xj   = _mm256_set1_pd( x[ j ] );
+            acc0 = _mm256_fmadd_pd( xj, _mm256_cvtps_pd( _mm_loadu_ps( &y[ i + j + 0 ] ) ), acc0 );
+            acc1 = _mm256_fmadd_pd( xj, _mm256_cvtps_pd( _mm_loadu_ps( &y[ i + j + 4 ] ) ), acc1 );
+        }
+        _mm256_storeu_pd( &xcorr[ i + 0 ], acc0 );
+        _mm256_storeu_pd( &xcorr[ i + 4 ], acc1 );
+    }
+    for( ; i < max_pitch - 3; i += 4 ) {
+        acc0 = _mm256_setzero_pd();
+        for( j = 0; j < len; j++ ) {
+            acc0 = _mm256_fmadd_pd( _mm256_set1_pd( x[ j ] ), _mm256_cvtps_pd( _mm_loadu_ps( &y[ i + j ] ) ), acc0 );
+        }
+        _mm256_storeu_pd( &xcorr[ i ], acc0 );
+    }
+    for( ; i < max_pitch; i++ ) {
+        xcorr[ i ] = silk_inner_product_FLP_avx2( y + i, x, len );
+    }
+}
+
+/* sum of squares of a silk_float array, with result as double */
+double silk_energy_FLP_avx2(
+    const silk_float    *data,
+    opus_int            dataSize
+)
+{
+    opus_int  i;
+    double    result;
+    __m256d   acc0, acc1, acc2, acc3, x;
+
+    acc0 = acc1 = acc2 = acc3 = _mm256_setzero_pd();
+    for( i = 0; i < dataSize - 15; i += 16 ) {
+        x    = _mm256_cvtps_pd( _mm_loadu_ps( &data[ i +  0 ] ) );
+        acc0 = _mm256_fmadd_pd( x, x, acc0 );
+        x    = _mm256_cvtps_pd( _mm_loadu_ps( &data[ i +  4 ] ) );
+        acc1 = _mm256_fmadd_pd( x, x, acc1 );
+        x    = _mm256_cvtps_pd( _mm_loadu_ps( &data[ i +  8 ] ) );
+        acc2 = _mm256_fmadd_pd( x, x, acc2 );
+        x    = _mm256_cvtps_pd( _mm_loadu_ps( &data[ i + 12 ] ) );
+        acc3 = _mm256_fmadd_pd( x, x, acc3 );
+    }
+    for( ; i < dataSize - 3; i += 4 ) {
+        x    = _mm256_cvtps_pd( _mm_loadu_ps( &data[ i ] ) );
+        acc0 = _mm256_fmadd_pd( x, x, acc0 );
+    }
+    result = silk_hsum_pd( _mm256_add_pd( _mm256_add_pd( acc0, acc1 ), _mm256_add_pd( acc2, acc3 ) ) );
+
+    /* add any remaining products */
+    for( ; i < dataSize; i++ ) {
+        result += data[ i ] * (double)data[ i ];
+    }
+
+    silk_assert( result >= 0.0 );
+    return result;
+}
+
+#endif
@@ -0,0 +1,109 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_X86_MAY_HAVE_AVX2)
+
+#include <immintrin.h>
+#include "main_FLP.h"
+
+#define NB_SECTION_VECS     ( ( MAX_SHAPE_LPC_ORDER + 4 ) / 4 )
+#define INPUT_PAD           ( MAX_SHAPE_LPC_ORDER + 4 )
+
+/* Autocorrelations for a warped frequency axis */
+/* In the C version every allpass section waits for the previous one within   */
+/* the same sample. Section i of sample n only needs sections i - 1 and i of   */
+/* sample n - 1, though, so section i runs for sample W - i at step W. Each    */
+/* step then updates all sections at once, one per lane, from the two previous */
+/* steps shifted by one section.                                               */
+void silk_warped_autocorrelation_FLP_avx2(
+    silk_float          *corr,              /* O    Result [order + 1]                                          */
+    const silk_float    *input,             /* I    Input data to correlate                                     */
+    const silk_float    warping,            /* I    Warping coefficient                                         */
+    const opus_int      length,             /* I    Length of input                                             */
+    const opus_int      order               /* I    Correlation order (even)                                    */
+)
+{
+    opus_int    n, g, nb_vecs;
+    double      C[ NB_SECTION_VECS * 4 ];
+    silk_float  buf[ INPUT_PAD + SHAPE_LPC_WIN_MAX + INPUT_PAD ];
+    __m256d     state[ NB_SECTION_VECS ], prev[ NB_SECTION_VECS ], acc[ NB_SECTION_VECS ];
+    __m256d     rot[ NB_SECTION_VECS ], shifted, w, x;
+
+    /* Order must be even */
+    silk_assert( ( order & 1 ) == 0 );
+
+    if( length > SHAPE_LPC_WIN_MAX || order > MAX_SHAPE_LPC_ORDER ) {
+        silk_warped_autocorrelation_FLP_c( corr, input, warping, length, order );
+        return;
+    }
+
+    /* Zeros before and after the input feed the sections that are not in their */
+    /* first or last sample yet                                                  */
+    silk_memset( buf, 0, sizeof( buf ) );
+    silk_memcpy( &buf[ INPUT_PAD ], input, length * sizeof( silk_float ) );
+
+    nb_vecs = ( order + 4 ) >> 2;
+    w = _mm256_set1_pd( warping );
+    for( g = 0; g < nb_vecs; g++ ) {
+        state[ g ] = prev[ g ] = acc[ g ] = _mm256_setzero_pd();
+    }
+
+    for( n = 0; n < length + order; n++ ) {
+        /* Shift the sections of the previous step up by one */
+        for( g = 0; g < nb_vecs; g++ ) {
+            rot[ g ] = _mm256_permute4x64_pd( state[ g ], 0x93 );
+        }
+        for( g = nb_vecs - 1; g >= 0; g-- ) {
+            shifted = g > 0 ? _mm256_blend_pd( rot[ g ], rot[ g - 1 ], 1 ) : rot[ 0 ];
+            /* Output of allpass section */
+            state[ g ] = _mm256_fmadd_pd( w, _mm256_sub_pd( state[ g ], shifted ), prev[ g ] );
+            prev[ g ]  = shifted;
+        }
+        /* The first section is the input itself */
+        state[ 0 ] = _mm256_blend_pd( state[ 0 ], _mm256_set1_pd( buf[ INPUT_PAD + n ] ), 1 );
+
+        /* Correlate with the input sample each section is at */
+        for( g = 0; g < nb_vecs; g++ ) {
+            x = _mm256_cvtps_pd( _mm_loadu_ps( &buf[ INPUT_PAD + n - 4 * g - 3 ] ) );
+            acc[ g ] = _mm256_fmadd_pd( _mm256_permute4x64_pd( x, 0x1B ), state[ g ], acc[ g ] );
+        }
+    }
+
+    /* Copy correlations in silk_float output format */
+    for( g = 0; g < nb_vecs; g++ ) {
+        _mm256_storeu_pd( &C[ 4 * g ], acc[ g ] );
+    }
+    for( n = 0; n < order + 1; n++ ) {
+        corr[ n ] = ( silk_float )C[ n ];
+    }
+}
+
+#endif
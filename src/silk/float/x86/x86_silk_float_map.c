@@ -0,0 +1,116 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "main_FLP.h"
+
+#if defined(OPUS_HAVE_RTCD) && \
+  (defined(OPUS_X86_MAY_HAVE_AVX2) && !defined(OPUS_X86_PRESUME_AVX2))
+
+double (*const SILK_INNER_PRODUCT_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_float    *data1,
+    const silk_float    *data2,
+    opus_int            dataSize
+) = {
+  silk_inner_product_FLP_c,                  /* non-sse */
+  silk_inner_product_FLP_c,
+  silk_inner_product_FLP_c,
+  silk_inner_product_FLP_c,
+  MAY_HAVE_AVX2( silk_inner_product_FLP ),   /* avx2 */
+};
+
+void (*const SILK_PITCH_XCORR_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_float    *x,
+    const silk_float    *y,
+    double              *xcorr,
+    opus_int            len,
+    opus_int            max_pitch
+) = {
+  silk_pitch_xcorr_FLP_c,                    /* non-sse */
+  silk_pitch_xcorr_FLP_c,
+  silk_pitch_xcorr_FLP_c,
+  silk_pitch_xcorr_FLP_c,
+  MAY_HAVE_AVX2( silk_pitch_xcorr_FLP ),     /* avx2 */
+};
+
+double (*const SILK_ENERGY_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_float    *data,
+    opus_int            dataSize
+) = {
+  silk_energy_FLP_c,                         /* non-sse */
+  silk_energy_FLP_c,
+  silk_energy_FLP_c,
+  silk_energy_FLP_c,
+  MAY_HAVE_AVX2( silk_energy_FLP ),          /* avx2 */
+};
+
+void (*const SILK_AUTOCORRELATION_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    silk_float          *results,
+    const silk_float    *inputData,
+    opus_int            inputDataSize,
+    opus_int            correlationCount
+) = {
+  silk_autocorrelation_FLP_c,                /* non-sse */
+  silk_autocorrelation_FLP_c,
+  silk_autocorrelation_FLP_c,
+  silk_autocorrelation_FLP_c,
+  MAY_HAVE_AVX2( silk_autocorrelation_FLP ), /* avx2 */
+};
+
+silk_float (*const SILK_BURG_MODIFIED_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    silk_float          A[],
+    const silk_float    x[],
+    const silk_float    minInvGain,
+    const opus_int      subfr_length,
+    const opus_int      nb_subfr,
+    const opus_int      D
+) = {
+  silk_burg_modified_FLP_c,                  /* non-sse */
+  silk_burg_modified_FLP_c,
+  silk_burg_modified_FLP_c,
+  silk_burg_modified_FLP_c,
+  MAY_HAVE_AVX2( silk_burg_modified_FLP ),   /* avx2 */
+};
+
+void (*const SILK_WARPED_AUTOCORRELATION_FLP_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    silk_float          *corr,
+    const silk_float    *input,
+    const silk_float    warping,
+    const opus_int      length,
+    const opus_int      order
+) = {
+  silk_warped_autocorrelation_FLP_c,                /* non-sse */
+  silk_warped_autocorrelation_FLP_c,
+  silk_warped_autocorrelation_FLP_c,
+  silk_warped_autocorrelation_FLP_c,
+  MAY_HAVE_AVX2( silk_warped_autocorrelation_FLP ), /* avx2 */
+};
+
+#endif
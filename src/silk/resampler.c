@@ -48,6 +48,7 @@ POSSIBILITY OF SUCH DAMAGE.
  */
 
 #include "resampler_private.h"
+#include "profile.h"
 
 /* Tables with delay compensation values to equalize total delay for different modes */
 static const opus_int8 delay_matrix_enc[ 5 ][ 3 ] = {
@@ -179,6 +180,9 @@ opus_int silk_resampler(
 )
 {
     opus_int nSamples;
+    OPUS_PROFILE_DECL;
+
+    OPUS_PROFILE_START();
 
     /* Need at least 1 ms of input data */
     silk_assert( inLen >= S->Fs_in_kHz );
@@ -211,5 +215,6 @@ opus_int silk_resampler(
     /* Copy to delay buffer */
     silk_memcpy( S->delayBuf, &in[ inLen - S->inputDelay ], S->inputDelay * sizeof( opus_int16 ) );
 
+    OPUS_PROFILE_STOP( OPUS_PROFILE_SILK_RESAMPLER );
     return 0;
 }
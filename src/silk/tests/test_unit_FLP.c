@@ -0,0 +1,312 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks the run-time selectable float SILK analysis kernels against the C
+   versions. They add up their products in a different order, so they are
+   not bit-exact: each kernel has to stay within a small relative error, and
+   the encoder has to keep the same quality at every complexity. For the
+   latter both bitstreams are decoded and their segmental SNR against the
+   input is compared. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opus.h"
+#include "API.h"
+#include "entenc.h"
+#include "entdec.h"
+#include "cpu_support.h"
+
+#ifndef FIXED_POINT
+
+#include "main_FLP.h"
+
+#define NB_FRAMES       150
+#define MAX_PACKET      1275
+#define MAX_DELAY       480
+#define MAX_SNR_LOSS    0.2
+
+static unsigned int rng_seed = 12345;
+
+static int fast_rand(void)
+{
+   rng_seed = 1664525 * rng_seed + 1013904223;
+   return (int)( rng_seed >> 17 ) - 16384;
+}
+
+/* Voiced harmonics with a sweeping pitch, interrupted by noise bursts */
+static void gen_speech(opus_int16 *pcm, int len, int fs)
+{
+   int i, h;
+   double phase = 0;
+   for (i = 0; i < len; i++)
+   {
+      double t = (double)i / fs;
+      double f0 = 150 + 70 * sin(2 * M_PI * 0.9 * t);
+      double env = 0.5 + 0.5 * sin(2 * M_PI * 2.3 * t);
+      double v = 0;
+      phase += 2 * M_PI * f0 / fs;
+      if (fmod(t, 1.1) < 0.8)
+      {
+         for (h = 1; h * f0 < fs / 2 && h <= 12; h++)
+            v += sin(h * phase) / h;
+         v *= 6000 * env;
+      }
+      else
+         v = fast_rand() * 0.3;
+      pcm[i] = (opus_int16)v;
+   }
+}
+
+static int check_close(const char *name, double ref, double val, double tol, int arch, int len)
+{
+   if (fabs(val - ref) > tol * (fabs(ref) + 1e-3))
+   {
+      fprintf(stderr, "%s: arch %d, length %d: %.9g instead of %.9g\n", name, arch, len, val, ref);
+      return 1;
+   }
+   return 0;
+}
+
+static int test_kernels(int arch)
+{
+   silk_float x[ 384 ], y[ 384 ], A_ref[ 16 ], A[ 16 ], c_ref[ 25 ], c[ 25 ];
+   silk_float nrg_ref, nrg;
+   int len, i, ret = 0;
+
+   for (i = 0; i < 384; i++)
+   {
+      x[ i ] = (silk_float)fast_rand();
+      y[ i ] = (silk_float)fast_rand();
+   }
+   for (len = 0; len <= 240; len++)
+   {
+      ret |= check_close("silk_inner_product_FLP", silk_inner_product_FLP(x, y, len, 0),
+            silk_inner_product_FLP(x, y, len, arch), 1e-9, arch, len);
+      ret |= check_close("silk_energy_FLP", silk_energy_FLP(x, len, 0),
+            silk_energy_FLP(x, len, arch), 1e-12, arch, len);
+      if (len >= 1)
+      {
+         int count = len < 25 ? len : 25;
+         silk_autocorrelation_FLP(c_ref, x, len, 25, 0);
+         silk_autocorrelation_FLP(c, x, len, 25, arch);
+         for (i = 0; i < count; i++)
+            ret |= check_close("silk_autocorrelation_FLP", c_ref[ i ], c[ i ], 1e-6, arch, len);
+      }
+      if (len >= MAX_SHAPE_LPC_ORDER)
+      {
+         silk_warped_autocorrelation_FLP(c_ref, x, 0.3f, len, MAX_SHAPE_LPC_ORDER, 0);
+         silk_warped_autocorrelation_FLP(c, x, 0.3f, len, MAX_SHAPE_LPC_ORDER, arch);
+         for (i = 0; i <= MAX_SHAPE_LPC_ORDER; i++)
+            ret |= check_close("silk_warped_autocorrelation_FLP", c_ref[ i ], c[ i ], 1e-4, arch, len);
+      }
+   }
+   /* Four subframes of 5 ms plus the order, at each internal rate */
+   for (len = 40 + 10; len <= 80 + 16; len += 23)
+   {
+      int order = len < 80 ? 10 : 16;
+      nrg_ref = silk_burg_modified_FLP(A_ref, x, 1e-3f, len, 4, order, 0);
+      nrg = silk_burg_modified_FLP(A, x, 1e-3f, len, 4, order, arch);
+      ret |= check_close("silk_burg_modified_FLP", nrg_ref, nrg, 1e-4, arch, len);
+      for (i = 0; i < order; i++)
+         ret |= check_close("silk_burg_modified_FLP", A_ref[ i ], A[ i ], 1e-4, arch, len);
+   }
+   return ret;
+}
+
+/* Segmental SNR of out against in, in 20 ms segments with the silent ones skipped */
+static double seg_snr(const opus_int16 *in, const opus_int16 *out, int len, int seg)
+{
+   double sum = 0;
+   int i, j, nb_segs = 0;
+   for (i = 0; i + seg <= len; i += seg)
+   {
+      double sig = 0, err = 0;
+      for (j = i; j < i + seg; j++)
+      {
+         sig += (double)in[ j ] * in[ j ];
+         err += (double)( in[ j ] - out[ j ] ) * ( in[ j ] - out[ j ] );
+      }
+      if (sig < 1e2 * seg)
+         continue;
+      sum += 10 * log10(sig / ( err + 1 ));
+      nb_segs++;
+   }
+   return nb_segs ? sum / nb_segs : 0;
+}
+
+/* Encodes pcm with the given arch and decodes it again with the C decoder */
+static int encode_decode(const opus_int16 *pcm, opus_int16 *out, unsigned char *packets,
+      opus_int32 *nbytes, int fs_kHz, int complexity, int arch)
+{
+   silk_EncControlStruct enc_ctl;
+   silk_DecControlStruct dec_ctl;
+   void *enc, *dec;
+   int enc_size, dec_size, frame_size, i, ret = 0;
+
+   frame_size = 20 * fs_kHz;
+   silk_Get_Encoder_Size(&enc_size);
+   silk_Get_Decoder_Size(&dec_size);
+   enc = malloc(enc_size);
+   dec = malloc(dec_size);
+   silk_InitEncoder(enc, arch, &enc_ctl);
+   silk_InitDecoder(dec);
+   enc_ctl.nChannelsAPI = 1;
+   enc_ctl.nChannelsInternal = 1;
+   enc_ctl.API_sampleRate = 1000 * fs_kHz;
+   enc_ctl.maxInternalSampleRate = 1000 * fs_kHz;
+   enc_ctl.minInternalSampleRate = 1000 * fs_kHz;
+   enc_ctl.desiredInternalSampleRate = 1000 * fs_kHz;
+   enc_ctl.payloadSize_ms = 20;
+   enc_ctl.bitRate = 8000 + 1000 * fs_kHz;
+   enc_ctl.packetLossPercentage = 0;
+   enc_ctl.complexity = complexity;
+   enc_ctl.useInBandFEC = 0;
+   enc_ctl.useDTX = 0;
+   enc_ctl.useCBR = 0;
+   enc_ctl.maxBits = MAX_PACKET * 8;
+   enc_ctl.toMono = 0;
+   enc_ctl.opusCanSwitch = 0;
+   enc_ctl.reducedDependency = 0;
+   dec_ctl.nChannelsAPI = 1;
+   dec_ctl.nChannelsInternal = 1;
+   dec_ctl.API_sampleRate = 1000 * fs_kHz;
+   dec_ctl.internalSampleRate = 1000 * fs_kHz;
+   dec_ctl.payloadSize_ms = 20;
+
+   for (i = 0; i < NB_FRAMES && !ret; i++)
+   {
+      unsigned char *packet = packets + i * MAX_PACKET;
+      ec_enc range_enc;
+      ec_dec range_dec;
+      opus_int32 nsamples;
+      ec_enc_init(&range_enc, packet, MAX_PACKET);
+      nbytes[ i ] = MAX_PACKET;
+      if (silk_Encode(enc, &enc_ctl, pcm + i * frame_size, frame_size, &range_enc, &nbytes[ i ], 0) != 0)
+         ret = 1;
+      ec_enc_done(&range_enc);
+      ec_dec_init(&range_dec, packet, nbytes[ i ]);
+      if (silk_Decode(dec, &dec_ctl, 0, 1, &range_dec, out + i * frame_size, &nsamples, 0) != 0)
+         ret = 1;
+   }
+
+   free(enc);
+   free(dec);
+   return ret;
+}
+
+static int test_encoder(int fs_kHz, int complexity, int arch)
+{
+   opus_int16 *pcm, *out[ 2 ];
+   unsigned char *packets[ 2 ];
+   opus_int32 nbytes[ 2 ][ NB_FRAMES ];
+   double snr[ 2 ], best = -1;
+   int len, delay = 0, d, i, k, nb_same = 0, ret = 0;
+
+   len = NB_FRAMES * 20 * fs_kHz;
+   pcm = (opus_int16 *)malloc(len * sizeof(*pcm));
+   gen_speech(pcm, len, 1000 * fs_kHz);
+   for (k = 0; k < 2; k++)
+   {
+      out[ k ] = (opus_int16 *)malloc(len * sizeof(*out[ k ]));
+      packets[ k ] = (unsigned char *)malloc(NB_FRAMES * MAX_PACKET);
+      ret |= encode_decode(pcm, out[ k ], packets[ k ], nbytes[ k ], fs_kHz, complexity, k == 0 ? 0 : arch);
+   }
+   if (ret)
+   {
+      fprintf(stderr, "codec error at %d kHz, complexity %d, arch %d\n", fs_kHz, complexity, arch);
+      goto done;
+   }
+
+   /* Align the decoded signal with the input */
+   for (d = 0; d < MAX_DELAY; d++)
+   {
+      double xcorr = 0;
+      for (i = 0; i + d < len; i++)
+         xcorr += (double)pcm[ i ] * out[ 0 ][ i + d ];
+      if (xcorr > best)
+      {
+         best = xcorr;
+         delay = d;
+      }
+   }
+   for (k = 0; k < 2; k++)
+      snr[ k ] = seg_snr(pcm, out[ k ] + delay, len - delay, 20 * fs_kHz);
+   for (i = 0; i < NB_FRAMES; i++)
+      nb_same += nbytes[ 0 ][ i ] == nbytes[ 1 ][ i ]
+            && memcmp(packets[ 0 ] + i * MAX_PACKET, packets[ 1 ] + i * MAX_PACKET, nbytes[ 0 ][ i ]) == 0;
+
+   printf("%2d kHz, complexity %2d, arch %d: %3d%% identical packets, segSNR %6.2f dB (C: %6.2f dB)\n",
+         fs_kHz, complexity, arch, 100 * nb_same / NB_FRAMES, snr[ 1 ], snr[ 0 ]);
+   if (snr[ 1 ] < snr[ 0 ] - MAX_SNR_LOSS)
+   {
+      fprintf(stderr, "quality loss at %d kHz, complexity %d, arch %d\n", fs_kHz, complexity, arch);
+      ret = 1;
+   }
+
+done:
+   for (k = 0; k < 2; k++)
+   {
+      free(out[ k ]);
+      free(packets[ k ]);
+   }
+   free(pcm);
+   return ret;
+}
+
+int main(void)
+{
+   int arch, complexity, ret = 0;
+   for (arch = 1; arch <= opus_select_arch(); arch++)
+   {
+      ret |= test_kernels(arch);
+      for (complexity = 0; complexity <= 10; complexity++)
+      {
+         ret |= test_encoder(8, complexity, arch);
+         ret |= test_encoder(12, complexity, arch);
+         ret |= test_encoder(16, complexity, arch);
+      }
+   }
+   if (ret == 0)
+      printf("All FLP tests passed\n");
+   return ret;
+}
+
+#else
+
+int main(void)
+{
+   printf("The float SILK kernels are not part of a fixed-point build\n");
+   return 0;
+}
+
+#endif
@@ -0,0 +1,159 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that every run-time selectable silk_NSQ() and silk_NSQ_del_dec()
+   produce exactly the same bitstream as the C versions, at all internal
+   rates and encoder complexities, with in-band FEC enabled. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opus.h"
+#include "API.h"
+#include "entenc.h"
+#include "cpu_support.h"
+
+#define NB_FRAMES   100
+#define MAX_PACKET  1275
+
+static unsigned int rng_seed = 12345;
+
+static int fast_rand(void)
+{
+   rng_seed = 1664525 * rng_seed + 1013904223;
+   return (int)( rng_seed >> 17 ) - 16384;
+}
+
+/* Voiced harmonics with a sweeping pitch, interrupted by noise bursts */
+static void gen_speech(opus_int16 *pcm, int len, int fs)
+{
+   int i, h;
+   double phase = 0;
+   for (i = 0; i < len; i++)
+   {
+      double t = (double)i / fs;
+      double f0 = 150 + 70 * sin(2 * M_PI * 0.9 * t);
+      double env = 0.5 + 0.5 * sin(2 * M_PI * 2.3 * t);
+      double v = 0;
+      phase += 2 * M_PI * f0 / fs;
+      if (fmod(t, 1.1) < 0.8)
+      {
+         for (h = 1; h * f0 < fs / 2 && h <= 12; h++)
+            v += sin(h * phase) / h;
+         v *= 6000 * env;
+      }
+      else
+         v = fast_rand() * 0.3;
+      pcm[i] = (opus_int16)v;
+   }
+}
+
+static int test_complexity(int fs_kHz, int complexity, int arch)
+{
+   silk_EncControlStruct ctl[ 2 ];
+   void *enc[ 2 ];
+   int enc_size;
+   opus_int16 *pcm;
+   unsigned char packet[ 2 ][ MAX_PACKET ];
+   opus_int32 nbytes[ 2 ];
+   int frame_size, i, k, ret = 0;
+
+   frame_size = 20 * fs_kHz;
+   silk_Get_Encoder_Size(&enc_size);
+   for (k = 0; k < 2; k++)
+   {
+      enc[ k ] = malloc(enc_size);
+      silk_InitEncoder(enc[ k ], k == 0 ? 0 : arch, &ctl[ k ]);
+      ctl[ k ].nChannelsAPI = 1;
+      ctl[ k ].nChannelsInternal = 1;
+      ctl[ k ].API_sampleRate = 1000 * fs_kHz;
+      ctl[ k ].maxInternalSampleRate = 1000 * fs_kHz;
+      ctl[ k ].minInternalSampleRate = 1000 * fs_kHz;
+      ctl[ k ].desiredInternalSampleRate = 1000 * fs_kHz;
+      ctl[ k ].payloadSize_ms = 20;
+      ctl[ k ].bitRate = 8000 + 1000 * fs_kHz;
+      ctl[ k ].packetLossPercentage = 10;
+      ctl[ k ].complexity = complexity;
+      ctl[ k ].useInBandFEC = 1;
+      ctl[ k ].useDTX = 0;
+      ctl[ k ].useCBR = 0;
+      ctl[ k ].maxBits = MAX_PACKET * 8;
+      ctl[ k ].toMono = 0;
+      ctl[ k ].opusCanSwitch = 0;
+      ctl[ k ].reducedDependency = 0;
+   }
+
+   pcm = (opus_int16 *)malloc(NB_FRAMES * frame_size * sizeof(*pcm));
+   gen_speech(pcm, NB_FRAMES * frame_size, 1000 * fs_kHz);
+
+   for (i = 0; i < NB_FRAMES && !ret; i++)
+   {
+      for (k = 0; k < 2; k++)
+      {
+         ec_enc range_enc;
+         ec_enc_init(&range_enc, packet[ k ], MAX_PACKET);
+         nbytes[ k ] = MAX_PACKET;
+         if (silk_Encode(enc[ k ], &ctl[ k ], pcm + i * frame_size, frame_size,
+               &range_enc, &nbytes[ k ], 0) != 0)
+            ret = 1;
+         ec_enc_done(&range_enc);
+      }
+      if (nbytes[ 0 ] != nbytes[ 1 ] || memcmp(packet[ 0 ], packet[ 1 ], nbytes[ 0 ]) != 0)
+      {
+         fprintf(stderr, "mismatch at %d kHz, complexity %d, arch %d, frame %d\n",
+               fs_kHz, complexity, arch, i);
+         ret = 1;
+      }
+   }
+
+   free(pcm);
+   free(enc[ 0 ]);
+   free(enc[ 1 ]);
+   return ret;
+}
+
+int main(void)
+{
+   int arch, complexity, ret = 0;
+   for (arch = 1; arch <= opus_select_arch(); arch++)
+   {
+      for (complexity = 0; complexity <= 10; complexity++)
+      {
+         ret |= test_complexity(8, complexity, arch);
+         ret |= test_complexity(12, complexity, arch);
+         ret |= test_complexity(16, complexity, arch);
+      }
+   }
+   if (ret == 0)
+      printf("All NSQ tests passed\n");
+   return ret;
+}
@@ -0,0 +1,163 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that every run-time selectable silk_decode_core() produces exactly
+   the same output as the C version on SILK streams at all internal rates,
+   including frames following a packet loss. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "opus.h"
+#include "opus_private.h"
+#include "API.h"
+#include "entdec.h"
+#include "cpu_support.h"
+
+#define FS          48000
+#define FRAME_SIZE  960
+#define NB_FRAMES   250
+#define MAX_PACKET  1500
+
+static unsigned int rng_seed = 12345;
+
+static int fast_rand(void)
+{
+   rng_seed = 1664525 * rng_seed + 1013904223;
+   return (int)( rng_seed >> 17 ) - 16384;
+}
+
+/* Voiced harmonics with a sweeping pitch, interrupted by noise bursts */
+static void gen_speech(opus_int16 *pcm, int len)
+{
+   int i, h;
+   double phase = 0;
+   for (i = 0; i < len; i++)
+   {
+      double t = (double)i / FS;
+      double f0 = 150 + 70 * sin(2 * M_PI * 0.9 * t);
+      double env = 0.5 + 0.5 * sin(2 * M_PI * 2.3 * t);
+      double v = 0;
+      phase += 2 * M_PI * f0 / FS;
+      if (fmod(t, 1.1) < 0.8)
+      {
+         for (h = 1; h <= 12; h++)
+            v += sin(h * phase) / h;
+         v *= 6000 * env;
+      }
+      else
+         v = fast_rand() * 0.3;
+      pcm[i] = (opus_int16)v;
+   }
+}
+
+static int test_bandwidth(int bandwidth, int fs_kHz, int arch)
+{
+   OpusEncoder *enc;
+   silk_DecControlStruct ctl[ 2 ];
+   void *dec[ 2 ];
+   int dec_size;
+   opus_int16 *pcm;
+   opus_int16 out[ 2 ][ FRAME_SIZE ];
+   unsigned char packet[ MAX_PACKET ];
+   int err, i, k, ret = 0;
+
+   enc = opus_encoder_create(FS, 1, OPUS_APPLICATION_VOIP, &err);
+   if (err != OPUS_OK)
+      return 1;
+   opus_encoder_ctl(enc, OPUS_SET_FORCE_MODE(MODE_SILK_ONLY));
+   opus_encoder_ctl(enc, OPUS_SET_BANDWIDTH(bandwidth));
+   opus_encoder_ctl(enc, OPUS_SET_BITRATE(8000 + 1000 * fs_kHz));
+   opus_encoder_ctl(enc, OPUS_SET_COMPLEXITY(10));
+
+   silk_Get_Decoder_Size(&dec_size);
+   for (k = 0; k < 2; k++)
+   {
+      dec[ k ] = malloc(dec_size);
+      silk_InitDecoder(dec[ k ]);
+      memset(&ctl[ k ], 0, sizeof(ctl[ k ]));
+      ctl[ k ].nChannelsAPI = 1;
+      ctl[ k ].nChannelsInternal = 1;
+      ctl[ k ].API_sampleRate = 1000 * fs_kHz;
+      ctl[ k ].internalSampleRate = 1000 * fs_kHz;
+      ctl[ k ].payloadSize_ms = 20;
+   }
+
+   pcm = (opus_int16 *)malloc(NB_FRAMES * FRAME_SIZE * sizeof(*pcm));
+   gen_speech(pcm, NB_FRAMES * FRAME_SIZE);
+
+   for (i = 0; i < NB_FRAMES && !ret; i++)
+   {
+      int len, lost;
+      len = opus_encode(enc, pcm + i * FRAME_SIZE, FRAME_SIZE, packet, MAX_PACKET);
+      if (len < 2)
+      {
+         ret = 1;
+         break;
+      }
+      lost = i % 17 == 16;
+      for (k = 0; k < 2; k++)
+      {
+         ec_dec range_dec;
+         opus_int32 nsamples;
+         ec_dec_init(&range_dec, packet + 1, len - 1);
+         if (silk_Decode(dec[ k ], &ctl[ k ], lost, 1, &range_dec, out[ k ], &nsamples,
+               k == 0 ? 0 : arch) != 0 || nsamples != 20 * fs_kHz)
+            ret = 1;
+      }
+      if (memcmp(out[ 0 ], out[ 1 ], 20 * fs_kHz * sizeof(opus_int16)) != 0)
+      {
+         fprintf(stderr, "mismatch at %d kHz, arch %d, frame %d\n", fs_kHz, arch, i);
+         ret = 1;
+      }
+   }
+
+   free(pcm);
+   free(dec[ 0 ]);
+   free(dec[ 1 ]);
+   opus_encoder_destroy(enc);
+   return ret;
+}
+
+int main(void)
+{
+   int arch, ret = 0;
+   for (arch = 1; arch <= opus_select_arch(); arch++)
+   {
+      ret |= test_bandwidth(OPUS_BANDWIDTH_NARROWBAND, 8, arch);
+      ret |= test_bandwidth(OPUS_BANDWIDTH_MEDIUMBAND, 12, arch);
+      ret |= test_bandwidth(OPUS_BANDWIDTH_WIDEBAND, 16, arch);
+   }
+   if (ret == 0)
+      printf("All decode core tests passed\n");
+   return ret;
+}
@@ -0,0 +1,157 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/* Checks that every run-time selectable version of the pitch analysis core
+   takes the same pitch decisions as the C version: voicing, lags, lag index
+   and contour index, at all internal rates, both frame lengths and all
+   complexities. In fixed-point the correlations are exact, so the returned
+   normalized correlation has to match too. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "SigProc_FIX.h"
+#include "pitch_est_defines.h"
+#include "cpu_support.h"
+#ifndef FIXED_POINT
+#include "SigProc_FLP.h"
+#endif
+
+#define NB_FRAMES       200
+#define MAX_FRAME       ( ( PE_LTP_MEM_LENGTH_MS + PE_MAX_NB_SUBFR * PE_SUBFR_LENGTH_MS ) * 16 )
+
+static unsigned int rng_seed = 12345;
+
+static int fast_rand(void)
+{
+   rng_seed = 1664525 * rng_seed + 1013904223;
+   return (int)( rng_seed >> 17 ) - 16384;
+}
+
+/* Voiced harmonics with a pitch that sweeps over the whole search range,
+   with a varying amount of noise on top */
+static void gen_frame(opus_int16 *x, int len, int fs_kHz, int frame)
+{
+   int i, h;
+   double f0 = 60 + 340 * ( frame % 37 ) / 36.;
+   double noise = ( frame % 5 ) * 0.25;
+   double gain = frame % 11 == 0 ? 30 : 3000;
+   for (i = 0; i < len; i++)
+   {
+      double v = 0;
+      double phase = 2 * M_PI * f0 * i / ( 1000. * fs_kHz );
+      for (h = 1; h * f0 < 500 * fs_kHz && h <= 10; h++)
+         v += sin(h * phase) / h;
+      v = gain * v + noise * fast_rand() * gain / 16384;
+      x[i] = (opus_int16)v;
+   }
+}
+
+typedef struct {
+   int        voicing;
+   opus_int   pitch[ PE_MAX_NB_SUBFR ];
+   opus_int16 lagIndex;
+   opus_int8  contourIndex;
+   opus_int   LTPCorr_Q15;
+} pitch_result;
+
+static void analyze(pitch_result *res, const opus_int16 *x, int fs_kHz, int nb_subfr,
+      int complexity, int prevLag, int arch)
+{
+#ifdef FIXED_POINT
+   res->LTPCorr_Q15 = 1 << 14;
+   res->voicing = silk_pitch_analysis_core(x, res->pitch, &res->lagIndex, &res->contourIndex,
+         &res->LTPCorr_Q15, prevLag, SILK_FIX_CONST( 0.6, 16 ), SILK_FIX_CONST( 0.3, 13 ),
+         fs_kHz, complexity, nb_subfr, arch);
+#else
+   silk_float frame[ MAX_FRAME ], LTPCorr = 0.5f;
+   int i;
+   for (i = 0; i < ( PE_LTP_MEM_LENGTH_MS + nb_subfr * PE_SUBFR_LENGTH_MS ) * fs_kHz; i++)
+      frame[ i ] = x[ i ];
+   res->voicing = silk_pitch_analysis_core_FLP(frame, res->pitch, &res->lagIndex, &res->contourIndex,
+         &LTPCorr, prevLag, 0.6f, 0.3f, fs_kHz, complexity, nb_subfr, arch);
+   /* Not bit-exact in float: only the decisions have to match */
+   res->LTPCorr_Q15 = 0;
+#endif
+}
+
+static int test_config(int fs_kHz, int nb_subfr, int complexity, int arch)
+{
+   opus_int16 x[ MAX_FRAME ];
+   pitch_result ref, res;
+   int frame, len, prevLag = 0, nb_voiced = 0, ret = 0;
+
+   len = ( PE_LTP_MEM_LENGTH_MS + nb_subfr * PE_SUBFR_LENGTH_MS ) * fs_kHz;
+   for (frame = 0; frame < NB_FRAMES && !ret; frame++)
+   {
+      gen_frame(x, len, fs_kHz, frame);
+      memset(&ref, 0, sizeof(ref));
+      memset(&res, 0, sizeof(res));
+      analyze(&ref, x, fs_kHz, nb_subfr, complexity, prevLag, 0);
+      analyze(&res, x, fs_kHz, nb_subfr, complexity, prevLag, arch);
+      if (memcmp(&ref, &res, sizeof(ref)) != 0)
+      {
+         fprintf(stderr, "mismatch at %d kHz, %d subframes, complexity %d, arch %d, frame %d\n",
+               fs_kHz, nb_subfr, complexity, arch, frame);
+         ret = 1;
+      }
+      nb_voiced += ref.voicing == 0;
+      prevLag = ref.voicing == 0 ? ref.pitch[ nb_subfr - 1 ] : 0;
+   }
+   /* Make sure the signal exercised the later stages */
+   if (nb_voiced < NB_FRAMES / 2)
+   {
+      fprintf(stderr, "only %d voiced frames at %d kHz, complexity %d\n", nb_voiced, fs_kHz, complexity);
+      ret = 1;
+   }
+   return ret;
+}
+
+int main(void)
+{
+   int arch, complexity, nb_subfr, ret = 0;
+   for (arch = 1; arch <= opus_select_arch(); arch++)
+   {
+      for (nb_subfr = PE_MAX_NB_SUBFR >> 1; nb_subfr <= PE_MAX_NB_SUBFR; nb_subfr <<= 1)
+      {
+         for (complexity = SILK_PE_MIN_COMPLEX; complexity <= SILK_PE_MAX_COMPLEX; complexity++)
+         {
+            ret |= test_config(8, nb_subfr, complexity, arch);
+            ret |= test_config(12, nb_subfr, complexity, arch);
+            ret |= test_config(16, nb_subfr, complexity, arch);
+         }
+      }
+   }
+   if (ret == 0)
+      printf("All pitch analysis tests passed\n");
+   return ret;
+}
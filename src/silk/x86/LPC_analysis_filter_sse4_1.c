@@ -0,0 +1,96 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_X86_MAY_HAVE_SSE4_1)
+
+#include <smmintrin.h>
+#include "SigProc_FIX.h"
+#include "SigProc_FIX_sse.h"
+
+/* The inner products run over the 16 taps, zero-padded past the filter order */
+void silk_LPC_analysis_filter_sse4_1(
+    opus_int16                  *out,               /* O    Output signal                                               */
+    const opus_int16            *in,                /* I    Input signal                                                */
+    const opus_int16            *B,                 /* I    MA prediction coefficients, Q12 [order]                     */
+    const opus_int32            len,                /* I    Signal length                                               */
+    const opus_int32            d                   /* I    Filter order                                                */
+)
+{
+    opus_int   ix, j;
+    opus_int32 out32_Q12;
+    opus_int16 B_rev[ SILK_MAX_ORDER_LPC ];
+    __m128i    B_lo, B_hi, sum0, sum1, sum2, sum3, x;
+
+    silk_assert( d <= SILK_MAX_ORDER_LPC );
+
+    /* Time-reversed coefficients, applied to in[ ix - 16 .. ix - 1 ] */
+    for( j = 0; j < SILK_MAX_ORDER_LPC; j++ ) {
+        B_rev[ j ] = SILK_MAX_ORDER_LPC - 1 - j < d ? B[ SILK_MAX_ORDER_LPC - 1 - j ] : 0;
+    }
+    B_lo = _mm_loadu_si128( (__m128i *)&B_rev[ 0 ] );
+    B_hi = _mm_loadu_si128( (__m128i *)&B_rev[ 8 ] );
+
+    for( ix = d; ix < len; ix++ ) {
+        /* Four outputs at a time, once the window does not reach before the input */
+        if( ix >= SILK_MAX_ORDER_LPC && ix < len - 3 ) {
+            sum0 = _mm_add_epi32( _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix - 16 ] ), B_lo ),
+                                  _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix -  8 ] ), B_hi ) );
+            sum1 = _mm_add_epi32( _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix - 15 ] ), B_lo ),
+                                  _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix -  7 ] ), B_hi ) );
+            sum2 = _mm_add_epi32( _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix - 14 ] ), B_lo ),
+                                  _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix -  6 ] ), B_hi ) );
+            sum3 = _mm_add_epi32( _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix - 13 ] ), B_lo ),
+                                  _mm_madd_epi16( _mm_loadu_si128( (__m128i *)&in[ ix -  5 ] ), B_hi ) );
+            sum0 = _mm_hadd_epi32( _mm_hadd_epi32( sum0, sum1 ), _mm_hadd_epi32( sum2, sum3 ) );
+
+            /* Subtract prediction */
+            x = _mm_slli_epi32( _mm_cvtepi16_epi32( _mm_loadl_epi64( (__m128i *)&in[ ix ] ) ), 12 );
+            x = _mm_sub_epi32( x, sum0 );
+
+            /* Scale to Q0 and saturate */
+            x = _mm_srai_epi32( _mm_add_epi32( _mm_srai_epi32( x, 11 ), _mm_set1_epi32( 1 ) ), 1 );
+            _mm_storel_epi64( (__m128i *)&out[ ix ], _mm_packs_epi32( x, x ) );
+            ix += 3;
+            continue;
+        }
+        out32_Q12 = 0;
+        for( j = 0; j < d; j++ ) {
+            out32_Q12 = silk_SMLABB_ovflw( out32_Q12, in[ ix - j - 1 ], B[ j ] );
+        }
+        out32_Q12 = silk_SUB32_ovflw( silk_LSHIFT( (opus_int32)in[ ix ], 12 ), out32_Q12 );
+        out[ ix ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND( out32_Q12, 12 ) );
+    }
+
+    /* Set first d output samples to zero */
+    silk_memset( out, 0, d * sizeof( opus_int16 ) );
+}
+
+#endif
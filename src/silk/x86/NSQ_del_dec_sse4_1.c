@@ -0,0 +1,751 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_X86_MAY_HAVE_SSE4_1)
+
+#include <smmintrin.h>
+#include "main.h"
+#include "stack_alloc.h"
+#include "SigProc_FIX_sse.h"
+
+#if MAX_DEL_DEC_STATES != 4
+#error "The SSE4.1 delayed decision quantizer keeps one state per 32-bit vector lane"
+#endif
+
+/* The delayed decision states, transposed so that lane k of every row */
+/* belongs to state k                                                  */
+typedef struct {
+    opus_int32 sLPC_Q14[ MAX_SUB_FRAME_LENGTH + NSQ_LPC_BUF_LENGTH ][ MAX_DEL_DEC_STATES ];
+    opus_int32 RandState[ DECISION_DELAY ][ MAX_DEL_DEC_STATES ];
+    opus_int32 Q_Q10[     DECISION_DELAY ][ MAX_DEL_DEC_STATES ];
+    opus_int32 Xq_Q14[    DECISION_DELAY ][ MAX_DEL_DEC_STATES ];
+    opus_int32 Pred_Q15[  DECISION_DELAY ][ MAX_DEL_DEC_STATES ];
+    opus_int32 Shape_Q14[ DECISION_DELAY ][ MAX_DEL_DEC_STATES ];
+    opus_int32 sAR2_Q14[ MAX_SHAPE_LPC_ORDER ][ MAX_DEL_DEC_STATES ];
+    opus_int32 LF_AR_Q14[ MAX_DEL_DEC_STATES ];
+    opus_int32 Seed[      MAX_DEL_DEC_STATES ];
+    opus_int32 SeedInit[  MAX_DEL_DEC_STATES ];
+    opus_int32 RD_Q10[    MAX_DEL_DEC_STATES ];
+} NSQ_del_decs_struct;
+
+typedef struct {
+    opus_int32 Q_Q10[        MAX_DEL_DEC_STATES ];
+    opus_int32 RD_Q10[       MAX_DEL_DEC_STATES ];
+    opus_int32 xq_Q14[       MAX_DEL_DEC_STATES ];
+    opus_int32 LF_AR_Q14[    MAX_DEL_DEC_STATES ];
+    opus_int32 sLTP_shp_Q14[ MAX_DEL_DEC_STATES ];
+    opus_int32 LPC_exc_Q14[  MAX_DEL_DEC_STATES ];
+} NSQ_samples_struct;
+
+/* Four silk_SMULWB()s against a multiplier in [ 0, 32767 ], given both as   */
+/* b << 16 and as b: the upper halves are multiplied by _mm_madd_epi16() and */
+/* the unsigned lower halves by _mm_mulhi_epu16().                           */
+static OPUS_INLINE __m128i silk_SMULWB_u15_epi32( __m128i a, __m128i b_Q16, __m128i b )
+{
+    return _mm_add_epi32( _mm_madd_epi16( a, b_Q16 ), _mm_mulhi_epu16( a, b ) );
+}
+
+/* Copies state from into state to, from sample i of the short-term state onwards */
+static OPUS_INLINE void silk_nsq_del_dec_copy_state(
+    NSQ_del_decs_struct *psDelDec,              /* I/O  Delayed decision states             */
+    opus_int            to,                     /* I    State to overwrite                  */
+    opus_int            from,                   /* I    State to copy                       */
+    opus_int            i                       /* I    Sample index                        */
+)
+{
+    opus_int j;
+
+    for( j = i; j < NSQ_LPC_BUF_LENGTH + i; j++ ) {
+        psDelDec->sLPC_Q14[ j ][ to ] = psDelDec->sLPC_Q14[ j ][ from ];
+    }
+    for( j = 0; j < DECISION_DELAY; j++ ) {
+        psDelDec->RandState[ j ][ to ] = psDelDec->RandState[ j ][ from ];
+        psDelDec->Q_Q10[     j ][ to ] = psDelDec->Q_Q10[     j ][ from ];
+        psDelDec->Xq_Q14[    j ][ to ] = psDelDec->Xq_Q14[    j ][ from ];
+        psDelDec->Pred_Q15[  j ][ to ] = psDelDec->Pred_Q15[  j ][ from ];
+        psDelDec->Shape_Q14[ j ][ to ] = psDelDec->Shape_Q14[ j ][ from ];
+    }
+    for( j = 0; j < MAX_SHAPE_LPC_ORDER; j++ ) {
+        psDelDec->sAR2_Q14[ j ][ to ] = psDelDec->sAR2_Q14[ j ][ from ];
+    }
+    psDelDec->LF_AR_Q14[ to ] = psDelDec->LF_AR_Q14[ from ];
+    psDelDec->Seed[      to ] = psDelDec->Seed[      from ];
+    psDelDec->SeedInit[  to ] = psDelDec->SeedInit[  from ];
+    psDelDec->RD_Q10[    to ] = psDelDec->RD_Q10[    from ];
+}
+
+static OPUS_INLINE void silk_nsq_del_dec_scale_states_sse4_1(
+    const silk_encoder_state *psEncC,               /* I    Encoder State                       */
+    silk_nsq_state      *NSQ,                       /* I/O  NSQ state                           */
+    NSQ_del_decs_struct *psDelDec,                  /* I/O  Delayed decision states             */
+    const opus_int32    x_Q3[],                     /* I    Input in Q3                         */
+    opus_int32          x_sc_Q10[],                 /* O    Input scaled with 1/Gain in Q10     */
+    const opus_int16    sLTP[],                     /* I    Re-whitened LTP state in Q0         */
+    opus_int32          sLTP_Q15[],                 /* O    LTP state matching scaled input     */
+    opus_int            subfr,                      /* I    Subframe number                     */
+    const opus_int      LTP_scale_Q14,              /* I    LTP state scaling                   */
+    const opus_int32    Gains_Q16[ MAX_NB_SUBFR ],  /* I                                        */
+    const opus_int      pitchL[ MAX_NB_SUBFR ],     /* I    Pitch lag                           */
+    const opus_int      signal_type,                /* I    Signal type                         */
+    const opus_int      decisionDelay               /* I    Decision delay                      */
+);
+
+/******************************************/
+/* Noise shape quantizer for one subframe */
+/******************************************/
+static OPUS_INLINE void silk_noise_shape_quantizer_del_dec_sse4_1(
+    silk_nsq_state      *NSQ,                   /* I/O  NSQ state                           */
+    NSQ_del_decs_struct *psDelDec,              /* I/O  Delayed decision states             */
+    opus_int            signalType,             /* I    Signal type                         */
+    const opus_int32    x_Q10[],                /* I                                        */
+    opus_int8           pulses[],               /* O                                        */
+    opus_int16          xq[],                   /* O                                        */
+    opus_int32          sLTP_Q15[],             /* I/O  LTP filter state                    */
+    opus_int32          delayedGain_Q10[],      /* I/O  Gain delay buffer                   */
+    const opus_int16    a_Q12[],                /* I    Short term prediction coefs         */
+    const opus_int16    b_Q14[],                /* I    Long term prediction coefs          */
+    const opus_int16    AR_shp_Q13[],           /* I    Noise shaping coefs                 */
+    opus_int            lag,                    /* I    Pitch lag                           */
+    opus_int32          HarmShapeFIRPacked_Q14, /* I                                        */
+    opus_int            Tilt_Q14,               /* I    Spectral tilt                       */
+    opus_int32          LF_shp_Q14,             /* I                                        */
+    opus_int32          Gain_Q16,               /* I                                        */
+    opus_int            Lambda_Q10,             /* I                                        */
+    opus_int            offset_Q10,             /* I                                        */
+    opus_int            length,                 /* I    Input length                        */
+    opus_int            subfr,                  /* I    Subframe number                     */
+    opus_int            shapingLPCOrder,        /* I    Shaping LPC filter order            */
+    opus_int            predictLPCOrder,        /* I    Prediction filter order             */
+    opus_int            warping_Q16,            /* I                                        */
+    opus_int            nStatesDelayedDecision, /* I    Number of states in decision tree   */
+    opus_int            *smpl_buf_idx,          /* I    Index to newest samples in buffers  */
+    opus_int            decisionDelay           /* I                                        */
+);
+
+/* Same as silk_NSQ_del_dec_c(), with the delayed decision states quantized */
+/* side by side in the four lanes of the vector registers                   */
+void silk_NSQ_del_dec_sse4_1(
+    const silk_encoder_state    *psEncC,                                    /* I/O  Encoder State                   */
+    silk_nsq_state              *NSQ,                                       /* I/O  NSQ state                       */
+    SideInfoIndices             *psIndices,                                 /* I/O  Quantization Indices            */
+    const opus_int32            x_Q3[],                                     /* I    Prefiltered input signal        */
+    opus_int8                   pulses[],                                   /* O    Quantized pulse signal          */
+    const opus_int16            PredCoef_Q12[ 2 * MAX_LPC_ORDER ],          /* I    Short term prediction coefs     */
+    const opus_int16            LTPCoef_Q14[ LTP_ORDER * MAX_NB_SUBFR ],    /* I    Long term prediction coefs      */
+    const opus_int16            AR2_Q13[ MAX_NB_SUBFR * MAX_SHAPE_LPC_ORDER ], /* I Noise shaping coefs             */
+    const opus_int              HarmShapeGain_Q14[ MAX_NB_SUBFR ],          /* I    Long term shaping coefs         */
+    const opus_int              Tilt_Q14[ MAX_NB_SUBFR ],                   /* I    Spectral tilt                   */
+    const opus_int32            LF_shp_Q14[ MAX_NB_SUBFR ],                 /* I    Low frequency shaping coefs     */
+    const opus_int32            Gains_Q16[ MAX_NB_SUBFR ],                  /* I    Quantization step sizes         */
+    const opus_int              pitchL[ MAX_NB_SUBFR ],                     /* I    Pitch lags                      */
+    const opus_int              Lambda_Q10,                                 /* I    Rate/distortion tradeoff        */
+    const opus_int              LTP_scale_Q14                               /* I    LTP state scaling               */
+)
+{
+    opus_int            i, k, lag, start_idx, LSF_interpolation_flag, Winner_ind, subfr;
+    opus_int            last_smple_idx, smpl_buf_idx, decisionDelay;
+    const opus_int16    *A_Q12, *B_Q14, *AR_shp_Q13;
+    opus_int16          *pxq;
+    VARDECL( opus_int32, sLTP_Q15 );
+    VARDECL( opus_int16, sLTP );
+    opus_int32          HarmShapeFIRPacked_Q14;
+    opus_int            offset_Q10;
+    opus_int32          RDmin_Q10, Gain_Q10;
+    VARDECL( opus_int32, x_sc_Q10 );
+    VARDECL( opus_int32, delayedGain_Q10 );
+    VARDECL( NSQ_del_decs_struct, psDelDec );
+    SAVE_STACK;
+
+    /* The shaping filter multiplies by the warping factor as a 16-bit value */
+    if( psEncC->warping_Q16 < 0 || psEncC->warping_Q16 > silk_int16_MAX ) {
+        silk_NSQ_del_dec_c( psEncC, NSQ, psIndices, x_Q3, pulses, PredCoef_Q12, LTPCoef_Q14, AR2_Q13,
+            HarmShapeGain_Q14, Tilt_Q14, LF_shp_Q14, Gains_Q16, pitchL, Lambda_Q10, LTP_scale_Q14 );
+        return;
+    }
+
+    /* Set unvoiced lag to the previous one, overwrite later for voiced */
+    lag = NSQ->lagPrev;
+
+    silk_assert( NSQ->prev_gain_Q16 != 0 );
+
+    /* Initialize delayed decision states; unused lanes run along on zeros */
+    ALLOC( psDelDec, 1, NSQ_del_decs_struct );
+    silk_memset( psDelDec, 0, sizeof( NSQ_del_decs_struct ) );
+    for( k = 0; k < psEncC->nStatesDelayedDecision; k++ ) {
+        psDelDec->Seed[ k ]           = ( k + psIndices->Seed ) & 3;
+        psDelDec->SeedInit[ k ]       = psDelDec->Seed[ k ];
+        psDelDec->RD_Q10[ k ]         = 0;
+        psDelDec->LF_AR_Q14[ k ]      = NSQ->sLF_AR_shp_Q14;
+        psDelDec->Shape_Q14[ 0 ][ k ] = NSQ->sLTP_shp_Q14[ psEncC->ltp_mem_length - 1 ];
+        for( i = 0; i < NSQ_LPC_BUF_LENGTH; i++ ) {
+            psDelDec->sLPC_Q14[ i ][ k ] = NSQ->sLPC_Q14[ i ];
+        }
+        for( i = 0; i < MAX_SHAPE_LPC_ORDER; i++ ) {
+            psDelDec->sAR2_Q14[ i ][ k ] = NSQ->sAR2_Q14[ i ];
+        }
+    }
+
+    offset_Q10   = silk_Quantization_Offsets_Q10[ psIndices->signalType >> 1 ][ psIndices->quantOffsetType ];
+    smpl_buf_idx = 0; /* index of oldest samples */
+
+    decisionDelay = silk_min_int( DECISION_DELAY, psEncC->subfr_length );
+
+    /* For voiced frames limit the decision delay to lower than the pitch lag */
+    if( psIndices->signalType == TYPE_VOICED ) {
+        for( k = 0; k < psEncC->nb_subfr; k++ ) {
+            decisionDelay = silk_min_int( decisionDelay, pitchL[ k ] - LTP_ORDER / 2 - 1 );
+        }
+    } else {
+        if( lag > 0 ) {
+            decisionDelay = silk_min_int( decisionDelay, lag - LTP_ORDER / 2 - 1 );
+        }
+    }
+
+    if( psIndices->NLSFInterpCoef_Q2 == 4 ) {
+        LSF_interpolation_flag = 0;
+    } else {
+        LSF_interpolation_flag = 1;
+    }
+
+    ALLOC( sLTP_Q15,
+           psEncC->ltp_mem_length + psEncC->frame_length, opus_int32 );
+    ALLOC( sLTP, psEncC->ltp_mem_length + psEncC->frame_length, opus_int16 );
+    ALLOC( x_sc_Q10, psEncC->subfr_length, opus_int32 );
+    ALLOC( delayedGain_Q10, DECISION_DELAY, opus_int32 );
+    /* Set up pointers to start of sub frame */
+    pxq                   = &NSQ->xq[ psEncC->ltp_mem_length ];
+    NSQ->sLTP_shp_buf_idx = psEncC->ltp_mem_length;
+    NSQ->sLTP_buf_idx     = psEncC->ltp_mem_length;
+    subfr = 0;
+    for( k = 0; k < psEncC->nb_subfr; k++ ) {
+        A_Q12      = &PredCoef_Q12[ ( ( k >> 1 ) | ( 1 - LSF_interpolation_flag ) ) * MAX_LPC_ORDER ];
+        B_Q14      = &LTPCoef_Q14[ k * LTP_ORDER           ];
+        AR_shp_Q13 = &AR2_Q13[     k * MAX_SHAPE_LPC_ORDER ];
+
+        /* Noise shape parameters */
+        silk_assert( HarmShapeGain_Q14[ k ] >= 0 );
+        HarmShapeFIRPacked_Q14  =                          silk_RSHIFT( HarmShapeGain_Q14[ k ], 2 );
+        HarmShapeFIRPacked_Q14 |= silk_LSHIFT( (opus_int32)silk_RSHIFT( HarmShapeGain_Q14[ k ], 1 ), 16 );
+
+        NSQ->rewhite_flag = 0;
+        if( psIndices->signalType == TYPE_VOICED ) {
+            /* Voiced */
+            lag = pitchL[ k ];
+
+            /* Re-whitening */
+            if( ( k & ( 3 - silk_LSHIFT( LSF_interpolation_flag, 1 ) ) ) == 0 ) {
+                if( k == 2 ) {
+                    /* RESET DELAYED DECISIONS */
+                    /* Find winner */
+                    RDmin_Q10 = psDelDec->RD_Q10[ 0 ];
+                    Winner_ind = 0;
+                    for( i = 1; i < psEncC->nStatesDelayedDecision; i++ ) {
+                        if( psDelDec->RD_Q10[ i ] < RDmin_Q10 ) {
+                            RDmin_Q10 = psDelDec->RD_Q10[ i ];
+                            Winner_ind = i;
+                        }
+                    }
+                    for( i = 0; i < psEncC->nStatesDelayedDecision; i++ ) {
+                        if( i != Winner_ind ) {
+                            psDelDec->RD_Q10[ i ] += ( silk_int32_MAX >> 4 );
+                            silk_assert( psDelDec->RD_Q10[ i ] >= 0 );
+                        }
+                    }
+
+                    /* Copy final part of signals from winner state to output and long-term filter states */
+                    last_smple_idx = smpl_buf_idx + decisionDelay;
+                    for( i = 0; i < decisionDelay; i++ ) {
+                        last_smple_idx = ( last_smple_idx - 1 ) & DECISION_DELAY_MASK;
+                        pulses[   i - decisionDelay ] = (opus_int8)silk_RSHIFT_ROUND( psDelDec->Q_Q10[ last_smple_idx ][ Winner_ind ], 10 );
+                        pxq[ i - decisionDelay ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND(
+                            silk_SMULWW( psDelDec->Xq_Q14[ last_smple_idx ][ Winner_ind ], Gains_Q16[ 1 ] ), 14 ) );
+                        NSQ->sLTP_shp_Q14[ NSQ->sLTP_shp_buf_idx - decisionDelay + i ] = psDelDec->Shape_Q14[ last_smple_idx ][ Winner_ind ];
+                    }
+
+                    subfr = 0;
+                }
+
+                /* Rewhiten with new A coefs */
+                start_idx = psEncC->ltp_mem_length - lag - psEncC->predictLPCOrder - LTP_ORDER / 2;
+                silk_assert( start_idx > 0 );
+
+                silk_LPC_analysis_filter_sse4_1( &sLTP[ start_idx ], &NSQ->xq[ start_idx + k * psEncC->subfr_length ],
+                    A_Q12, psEncC->ltp_mem_length - start_idx, psEncC->predictLPCOrder );
+
+                NSQ->sLTP_buf_idx = psEncC->ltp_mem_length;
+                NSQ->rewhite_flag = 1;
+            }
+        }
+
+        silk_nsq_del_dec_scale_states_sse4_1( psEncC, NSQ, psDelDec, x_Q3, x_sc_Q10, sLTP, sLTP_Q15, k,
+            LTP_scale_Q14, Gains_Q16, pitchL, psIndices->signalType, decisionDelay );
+
+        silk_noise_shape_quantizer_del_dec_sse4_1( NSQ, psDelDec, psIndices->signalType, x_sc_Q10, pulses, pxq, sLTP_Q15,
+            delayedGain_Q10, A_Q12, B_Q14, AR_shp_Q13, lag, HarmShapeFIRPacked_Q14, Tilt_Q14[ k ], LF_shp_Q14[ k ],
+            Gains_Q16[ k ], Lambda_Q10, offset_Q10, psEncC->subfr_length, subfr++, psEncC->shapingLPCOrder,
+            psEncC->predictLPCOrder, psEncC->warping_Q16, psEncC->nStatesDelayedDecision, &smpl_buf_idx, decisionDelay );
+
+        x_Q3   += psEncC->subfr_length;
+        pulses += psEncC->subfr_length;
+        pxq    += psEncC->subfr_length;
+    }
+
+    /* Find winner */
+    RDmin_Q10 = psDelDec->RD_Q10[ 0 ];
+    Winner_ind = 0;
+    for( k = 1; k < psEncC->nStatesDelayedDecision; k++ ) {
+        if( psDelDec->RD_Q10[ k ] < RDmin_Q10 ) {
+            RDmin_Q10 = psDelDec->RD_Q10[ k ];
+            Winner_ind = k;
+        }
+    }
+
+    /* Copy final part of signals from winner state to output and long-term filter states */
+    psIndices->Seed = psDelDec->SeedInit[ Winner_ind ];
+    last_smple_idx = smpl_buf_idx + decisionDelay;
+    Gain_Q10 = silk_RSHIFT32( Gains_Q16[ psEncC->nb_subfr - 1 ], 6 );
+    for( i = 0; i < decisionDelay; i++ ) {
+        last_smple_idx = ( last_smple_idx - 1 ) & DECISION_DELAY_MASK;
+        pulses[   i - decisionDelay ] = (opus_int8)silk_RSHIFT_ROUND( psDelDec->Q_Q10[ last_smple_idx ][ Winner_ind ], 10 );
+        pxq[ i - decisionDelay ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND(
+            silk_SMULWW( psDelDec->Xq_Q14[ last_smple_idx ][ Winner_ind ], Gain_Q10 ), 8 ) );
+        NSQ->sLTP_shp_Q14[ NSQ->sLTP_shp_buf_idx - decisionDelay + i ] = psDelDec->Shape_Q14[ last_smple_idx ][ Winner_ind ];
+    }
+    for( i = 0; i < NSQ_LPC_BUF_LENGTH; i++ ) {
+        NSQ->sLPC_Q14[ i ] = psDelDec->sLPC_Q14[ psEncC->subfr_length + i ][ Winner_ind ];
+    }
+    for( i = 0; i < MAX_SHAPE_LPC_ORDER; i++ ) {
+        NSQ->sAR2_Q14[ i ] = psDelDec->sAR2_Q14[ i ][ Winner_ind ];
+    }
+
+    /* Update states */
+    NSQ->sLF_AR_shp_Q14 = psDelDec->LF_AR_Q14[ Winner_ind ];
+    NSQ->lagPrev        = pitchL[ psEncC->nb_subfr - 1 ];
+
+    /* Save quantized speech signal */
+    silk_memmove( NSQ->xq,           &NSQ->xq[           psEncC->frame_length ], psEncC->ltp_mem_length * sizeof( opus_int16 ) );
+    silk_memmove( NSQ->sLTP_shp_Q14, &NSQ->sLTP_shp_Q14[ psEncC->frame_length ], psEncC->ltp_mem_length * sizeof( opus_int32 ) );
+    RESTORE_STACK;
+}
+
+/******************************************/
+/* Noise shape quantizer for one subframe */
+/******************************************/
+/* The filters, the quantization and the rate-distortion measures run in   */
+/* vector lanes, one state per lane, with the branches of the quantization */
+/* turned into selects. Picking winners and replacing states stays scalar. */
+static OPUS_INLINE void silk_noise_shape_quantizer_del_dec_sse4_1(
+    silk_nsq_state      *NSQ,                   /* I/O  NSQ state                           */
+    NSQ_del_decs_struct *psDelDec,              /* I/O  Delayed decision states             */
+    opus_int            signalType,             /* I    Signal type                         */
+    const opus_int32    x_Q10[],                /* I                                        */
+    opus_int8           pulses[],               /* O                                        */
+    opus_int16          xq[],                   /* O                                        */
+    opus_int32          sLTP_Q15[],             /* I/O  LTP filter state                    */
+    opus_int32          delayedGain_Q10[],      /* I/O  Gain delay buffer                   */
+    const opus_int16    a_Q12[],                /* I    Short term prediction coefs         */
+    const opus_int16    b_Q14[],                /* I    Long term prediction coefs          */
+    const opus_int16    AR_shp_Q13[],           /* I    Noise shaping coefs                 */
+    opus_int            lag,                    /* I    Pitch lag                           */
+    opus_int32          HarmShapeFIRPacked_Q14, /* I                                        */
+    opus_int            Tilt_Q14,               /* I    Spectral tilt                       */
+    opus_int32          LF_shp_Q14,             /* I                                        */
+    opus_int32          Gain_Q16,               /* I                                        */
+    opus_int            Lambda_Q10,             /* I                                        */
+    opus_int            offset_Q10,             /* I                                        */
+    opus_int            length,                 /* I    Input length                        */
+    opus_int            subfr,                  /* I    Subframe number                     */
+    opus_int            shapingLPCOrder,        /* I    Shaping LPC filter order            */
+    opus_int            predictLPCOrder,        /* I    Prediction filter order             */
+    opus_int            warping_Q16,            /* I                                        */
+    opus_int            nStatesDelayedDecision, /* I    Number of states in decision tree   */
+    opus_int            *smpl_buf_idx,          /* I    Index to newest samples in buffers  */
+    opus_int            decisionDelay           /* I                                        */
+)
+{
+    opus_int     i, j, k, Winner_ind, RDmin_ind, RDmax_ind, last_smple_idx;
+    opus_int32   Winner_rand_state;
+    opus_int32   LTP_pred_Q14, n_LTP_Q14, RDmin_Q10, RDmax_Q10, Gain_Q10;
+    opus_int32   *pred_lag_ptr, *shp_lag_ptr;
+    opus_int32   (*psLPC_Q14)[ MAX_DEL_DEC_STATES ];
+    NSQ_samples_struct psSampleState[ 2 ];
+    __m128i      A_Q28[ MAX_LPC_ORDER ], AR_Q29[ MAX_SHAPE_LPC_ORDER ];
+    __m128i      warping, warping_Q32, Tilt_Q30, LF_shp_B, LF_shp_T, Lambda, offset;
+    __m128i      seed, LPC_pred_Q14, n_AR_Q14, n_LF_Q14, r_Q10, q1_Q0, q1_Q10, q2_Q10, rd1_Q10, rd2_Q10;
+    __m128i      acc_even, acc_odd, tmp1, tmp2, x, sign, mask;
+
+    silk_assert( nStatesDelayedDecision > 0 );
+    silk_assert( predictLPCOrder == 10 || predictLPCOrder == 16 );
+    silk_assert( ( shapingLPCOrder & 1 ) == 0 );   /* check that order is even */
+
+    shp_lag_ptr  = &NSQ->sLTP_shp_Q14[ NSQ->sLTP_shp_buf_idx - lag + HARM_SHAPE_FIR_TAPS / 2 ];
+    pred_lag_ptr = &sLTP_Q15[ NSQ->sLTP_buf_idx - lag + LTP_ORDER / 2 ];
+    Gain_Q10     = silk_RSHIFT( Gain_Q16, 6 );
+
+    for( j = 0; j < predictLPCOrder; j++ ) {
+        A_Q28[ j ] = _mm_set1_epi32( silk_LSHIFT32( (opus_int32)a_Q12[ j ], 16 ) );
+    }
+    for( j = 0; j < shapingLPCOrder; j++ ) {
+        AR_Q29[ j ] = _mm_set1_epi32( silk_LSHIFT32( (opus_int32)AR_shp_Q13[ j ], 16 ) );
+    }
+    warping     = _mm_set1_epi32( warping_Q16 );
+    warping_Q32 = _mm_set1_epi32( silk_LSHIFT32( warping_Q16, 16 ) );
+    Tilt_Q30    = _mm_set1_epi32( silk_LSHIFT32( (opus_int32)(opus_int16)Tilt_Q14, 16 ) );
+    LF_shp_B    = _mm_set1_epi32( silk_LSHIFT32( (opus_int32)(opus_int16)LF_shp_Q14, 16 ) );
+    LF_shp_T    = _mm_set1_epi32( LF_shp_Q14 & (opus_int32)0xFFFF0000 );
+    Lambda      = _mm_set1_epi32( Lambda_Q10 & 0xFFFF );
+    offset      = _mm_set1_epi32( offset_Q10 );
+
+    for( i = 0; i < length; i++ ) {
+        /* Perform common calculations used in all states */
+
+        /* Long-term prediction */
+        if( signalType == TYPE_VOICED ) {
+            /* Unrolled loop */
+            /* Avoids introducing a bias because silk_SMLAWB() always rounds to -inf */
+            LTP_pred_Q14 = 2;
+            LTP_pred_Q14 = silk_SMLAWB( LTP_pred_Q14, pred_lag_ptr[  0 ], b_Q14[ 0 ] );
+            LTP_pred_Q14 = silk_SMLAWB( LTP_pred_Q14, pred_lag_ptr[ -1 ], b_Q14[ 1 ] );
+            LTP_pred_Q14 = silk_SMLAWB( LTP_pred_Q14, pred_lag_ptr[ -2 ], b_Q14[ 2 ] );
+            LTP_pred_Q14 = silk_SMLAWB( LTP_pred_Q14, pred_lag_ptr[ -3 ], b_Q14[ 3 ] );
+            LTP_pred_Q14 = silk_SMLAWB( LTP_pred_Q14, pred_lag_ptr[ -4 ], b_Q14[ 4 ] );
+            LTP_pred_Q14 = silk_LSHIFT( LTP_pred_Q14, 1 );                          /* Q13 -> Q14 */
+            pred_lag_ptr++;
+        } else {
+            LTP_pred_Q14 = 0;
+        }
+
+        /* Long-term shaping */
+        if( lag > 0 ) {
+            /* Symmetric, packed FIR coefficients */
+            n_LTP_Q14 = silk_SMULWB( silk_ADD32( shp_lag_ptr[ 0 ], shp_lag_ptr[ -2 ] ), HarmShapeFIRPacked_Q14 );
+            n_LTP_Q14 = silk_SMLAWT( n_LTP_Q14, shp_lag_ptr[ -1 ],                      HarmShapeFIRPacked_Q14 );
+            n_LTP_Q14 = silk_SUB_LSHIFT32( LTP_pred_Q14, n_LTP_Q14, 2 );            /* Q12 -> Q14 */
+            shp_lag_ptr++;
+        } else {
+            n_LTP_Q14 = 0;
+        }
+
+        /* Generate dither */
+        seed = _mm_loadu_si128( (__m128i *)psDelDec->Seed );
+        seed = _mm_add_epi32( _mm_mullo_epi32( seed, _mm_set1_epi32( 196314165 ) ), _mm_set1_epi32( 907633515 ) );
+        _mm_storeu_si128( (__m128i *)psDelDec->Seed, seed );
+        sign = _mm_srai_epi32( seed, 31 );
+
+        /* Pointer used in short term prediction and shaping */
+        psLPC_Q14 = &psDelDec->sLPC_Q14[ NSQ_LPC_BUF_LENGTH - 1 + i ];
+
+        /* Short-term prediction */
+        x        = _mm_loadu_si128( (__m128i *)psLPC_Q14[ 0 ] );
+        acc_even = _mm_mul_epi32( x, A_Q28[ 0 ] );
+        acc_odd  = _mm_mul_epi32( _mm_srli_epi64( x, 32 ), A_Q28[ 0 ] );
+        for( j = 1; j < predictLPCOrder; j++ ) {
+            x        = _mm_loadu_si128( (__m128i *)psLPC_Q14[ -j ] );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( x, A_Q28[ j ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( _mm_srli_epi64( x, 32 ), A_Q28[ j ] ) );
+        }
+        /* Avoids introducing a bias because silk_SMLAWB() always rounds to -inf */
+        LPC_pred_Q14 = _mm_add_epi32( silk_combine_epi32( acc_even, acc_odd ), _mm_set1_epi32( silk_RSHIFT( predictLPCOrder, 1 ) ) );
+        LPC_pred_Q14 = _mm_slli_epi32( LPC_pred_Q14, 4 );                               /* Q10 -> Q14 */
+
+        /* Noise shape feedback */
+        /* Output of lowpass section */
+        x    = _mm_loadu_si128( (__m128i *)psDelDec->sAR2_Q14[ 0 ] );
+        tmp2 = _mm_add_epi32( _mm_loadu_si128( (__m128i *)psLPC_Q14[ 0 ] ), silk_SMULWB_u15_epi32( x, warping_Q32, warping ) );
+        acc_even = _mm_mul_epi32( tmp2, AR_Q29[ 0 ] );
+        acc_odd  = _mm_mul_epi32( _mm_srli_epi64( tmp2, 32 ), AR_Q29[ 0 ] );
+        /* Loop over allpass sections */
+        for( j = 1; j < shapingLPCOrder; j++ ) {
+            /* Output of allpass section */
+            tmp1 = _mm_loadu_si128( (__m128i *)psDelDec->sAR2_Q14[ j ] );
+            tmp1 = _mm_add_epi32( x, silk_SMULWB_u15_epi32( _mm_sub_epi32( tmp1, tmp2 ), warping_Q32, warping ) );
+            x    = _mm_loadu_si128( (__m128i *)psDelDec->sAR2_Q14[ j ] );
+            _mm_storeu_si128( (__m128i *)psDelDec->sAR2_Q14[ j - 1 ], tmp2 );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp1, AR_Q29[ j ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( _mm_srli_epi64( tmp1, 32 ), AR_Q29[ j ] ) );
+            tmp2 = tmp1;
+        }
+        _mm_storeu_si128( (__m128i *)psDelDec->sAR2_Q14[ shapingLPCOrder - 1 ], tmp2 );
+
+        x        = _mm_loadu_si128( (__m128i *)psDelDec->LF_AR_Q14 );
+        n_AR_Q14 = _mm_add_epi32( silk_combine_epi32( acc_even, acc_odd ), _mm_set1_epi32( silk_RSHIFT( shapingLPCOrder, 1 ) ) );
+        n_AR_Q14 = _mm_slli_epi32( n_AR_Q14, 1 );                                       /* Q11 -> Q12 */
+        n_AR_Q14 = _mm_add_epi32( n_AR_Q14, silk_SMULWB_epi32( x, Tilt_Q30 ) );         /* Q12 */
+        n_AR_Q14 = _mm_slli_epi32( n_AR_Q14, 2 );                                       /* Q12 -> Q14 */
+
+        tmp1     = _mm_loadu_si128( (__m128i *)psDelDec->Shape_Q14[ *smpl_buf_idx ] );
+        acc_even = _mm_add_epi32( _mm_mul_epi32( tmp1, LF_shp_B ), _mm_mul_epi32( x, LF_shp_T ) );
+        acc_odd  = _mm_add_epi32( _mm_mul_epi32( _mm_srli_epi64( tmp1, 32 ), LF_shp_B ),
+                                  _mm_mul_epi32( _mm_srli_epi64( x, 32 ), LF_shp_T ) );
+        n_LF_Q14 = _mm_slli_epi32( silk_combine_epi32( acc_even, acc_odd ), 2 );        /* Q12 -> Q14 */
+
+        /* Input minus prediction plus noise feedback                       */
+        /* r = x[ i ] - LTP_pred - LPC_pred + n_AR + n_Tilt + n_LF + n_LTP  */
+        tmp1 = _mm_add_epi32( n_AR_Q14, n_LF_Q14 );                                     /* Q14 */
+        tmp2 = _mm_add_epi32( _mm_set1_epi32( n_LTP_Q14 ), LPC_pred_Q14 );              /* Q13 */
+        tmp1 = _mm_sub_epi32( tmp2, tmp1 );                                             /* Q13 */
+        tmp1 = _mm_srai_epi32( _mm_add_epi32( _mm_srai_epi32( tmp1, 3 ), _mm_set1_epi32( 1 ) ), 1 ); /* Q10 */
+
+        r_Q10 = _mm_sub_epi32( _mm_set1_epi32( x_Q10[ i ] ), tmp1 );                    /* residual error Q10 */
+
+        /* Flip sign depending on dither */
+        r_Q10 = _mm_sub_epi32( _mm_xor_si128( r_Q10, sign ), sign );
+        r_Q10 = _mm_min_epi32( _mm_max_epi32( r_Q10, _mm_set1_epi32( -(31 << 10) ) ), _mm_set1_epi32( 30 << 10 ) );
+
+        /* Find two quantization level candidates and measure their rate-distortion. */
+        /* Both levels are 1024 apart, except around zero where they are closer.     */
+        q1_Q10 = _mm_sub_epi32( r_Q10, offset );
+        q1_Q0  = _mm_srai_epi32( q1_Q10, 10 );
+        mask   = _mm_cmpgt_epi32( q1_Q0, _mm_setzero_si128() );
+        x      = _mm_andnot_si128( _mm_cmpeq_epi32( q1_Q0, _mm_setzero_si128() ), _mm_set1_epi32( QUANT_LEVEL_ADJUST_Q10 ) );
+        x      = _mm_blendv_epi8( x, _mm_set1_epi32( -QUANT_LEVEL_ADJUST_Q10 ), mask );
+        q1_Q10 = _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( q1_Q0, 10 ), offset ), x );
+        mask   = _mm_or_si128( mask, _mm_cmplt_epi32( q1_Q0, _mm_set1_epi32( -1 ) ) );
+        q2_Q10 = _mm_add_epi32( q1_Q10, _mm_set1_epi32( 1024 ) );
+        q2_Q10 = _mm_sub_epi32( q2_Q10, _mm_andnot_si128( mask, _mm_set1_epi32( QUANT_LEVEL_ADJUST_Q10 ) ) );
+        /* The rate term uses the level magnitudes */
+        rd1_Q10 = _mm_madd_epi16( _mm_abs_epi32( q1_Q10 ), Lambda );
+        rd2_Q10 = _mm_madd_epi16( _mm_abs_epi32( q2_Q10 ), Lambda );
+        x       = _mm_sub_epi32( r_Q10, q1_Q10 );
+        rd1_Q10 = _mm_srai_epi32( _mm_add_epi32( rd1_Q10, _mm_madd_epi16( x, _mm_and_si128( x, _mm_set1_epi32( 0xFFFF ) ) ) ), 10 );
+        x       = _mm_sub_epi32( r_Q10, q2_Q10 );
+        rd2_Q10 = _mm_srai_epi32( _mm_add_epi32( rd2_Q10, _mm_madd_epi16( x, _mm_and_si128( x, _mm_set1_epi32( 0xFFFF ) ) ) ), 10 );
+
+        /* The better level goes to the first sample state */
+        mask = _mm_cmplt_epi32( rd1_Q10, rd2_Q10 );
+        x    = _mm_loadu_si128( (__m128i *)psDelDec->RD_Q10 );
+        _mm_storeu_si128( (__m128i *)psSampleState[ 0 ].RD_Q10, _mm_add_epi32( x, _mm_blendv_epi8( rd2_Q10, rd1_Q10, mask ) ) );
+        _mm_storeu_si128( (__m128i *)psSampleState[ 1 ].RD_Q10, _mm_add_epi32( x, _mm_blendv_epi8( rd1_Q10, rd2_Q10, mask ) ) );
+        tmp1 = _mm_blendv_epi8( q2_Q10, q1_Q10, mask );
+        tmp2 = _mm_blendv_epi8( q1_Q10, q2_Q10, mask );
+
+        /* Update states for both quantization levels */
+        for( k = 0; k < 2; k++ ) {
+            x = k == 0 ? tmp1 : tmp2;
+            _mm_storeu_si128( (__m128i *)psSampleState[ k ].Q_Q10, x );
+
+            /* Quantized excitation */
+            x = _mm_sub_epi32( _mm_xor_si128( _mm_slli_epi32( x, 4 ), sign ), sign );
+
+            /* Add predictions */
+            x = _mm_add_epi32( x, _mm_set1_epi32( LTP_pred_Q14 ) );
+            _mm_storeu_si128( (__m128i *)psSampleState[ k ].LPC_exc_Q14, x );
+            x = _mm_add_epi32( x, LPC_pred_Q14 );
+            _mm_storeu_si128( (__m128i *)psSampleState[ k ].xq_Q14, x );
+
+            /* Update states */
+            x = _mm_sub_epi32( x, n_AR_Q14 );
+            _mm_storeu_si128( (__m128i *)psSampleState[ k ].LF_AR_Q14, x );
+            _mm_storeu_si128( (__m128i *)psSampleState[ k ].sLTP_shp_Q14, _mm_sub_epi32( x, n_LF_Q14 ) );
+        }
+
+        *smpl_buf_idx  = ( *smpl_buf_idx - 1 ) & DECISION_DELAY_MASK;                   /* Index to newest samples              */
+        last_smple_idx = ( *smpl_buf_idx + decisionDelay ) & DECISION_DELAY_MASK;       /* Index to decisionDelay old samples   */
+
+        /* Find winner */
+        RDmin_Q10 = psSampleState[ 0 ].RD_Q10[ 0 ];
+        Winner_ind = 0;
+        for( k = 1; k < nStatesDelayedDecision; k++ ) {
+            if( psSampleState[ 0 ].RD_Q10[ k ] < RDmin_Q10 ) {
+                RDmin_Q10  = psSampleState[ 0 ].RD_Q10[ k ];
+                Winner_ind = k;
+            }
+        }
+
+        /* Increase RD values of expired states */
+        Winner_rand_state = psDelDec->RandState[ last_smple_idx ][ Winner_ind ];
+        mask = _mm_cmpeq_epi32( _mm_loadu_si128( (__m128i *)psDelDec->RandState[ last_smple_idx ] ), _mm_set1_epi32( Winner_rand_state ) );
+        mask = _mm_andnot_si128( mask, _mm_set1_epi32( silk_int32_MAX >> 4 ) );
+        for( k = 0; k < 2; k++ ) {
+            x = _mm_loadu_si128( (__m128i *)psSampleState[ k ].RD_Q10 );
+            _mm_storeu_si128( (__m128i *)psSampleState[ k ].RD_Q10, _mm_add_epi32( x, mask ) );
+        }
+
+        /* Find worst in first set and best in second set */
+        RDmax_Q10  = psSampleState[ 0 ].RD_Q10[ 0 ];
+        RDmin_Q10  = psSampleState[ 1 ].RD_Q10[ 0 ];
+        RDmax_ind = 0;
+        RDmin_ind = 0;
+        for( k = 1; k < nStatesDelayedDecision; k++ ) {
+            /* find worst in first set */
+            if( psSampleState[ 0 ].RD_Q10[ k ] > RDmax_Q10 ) {
+                RDmax_Q10  = psSampleState[ 0 ].RD_Q10[ k ];
+                RDmax_ind = k;
+            }
+            /* find best in second set */
+            if( psSampleState[ 1 ].RD_Q10[ k ] < RDmin_Q10 ) {
+                RDmin_Q10  = psSampleState[ 1 ].RD_Q10[ k ];
+                RDmin_ind = k;
+            }
+        }
+
+        /* Replace a state if best from second set outperforms worst in first set */
+        if( RDmin_Q10 < RDmax_Q10 ) {
+            silk_nsq_del_dec_copy_state( psDelDec, RDmax_ind, RDmin_ind, i );
+            psSampleState[ 0 ].Q_Q10[        RDmax_ind ] = psSampleState[ 1 ].Q_Q10[        RDmin_ind ];
+            psSampleState[ 0 ].RD_Q10[       RDmax_ind ] = psSampleState[ 1 ].RD_Q10[       RDmin_ind ];
+            psSampleState[ 0 ].xq_Q14[       RDmax_ind ] = psSampleState[ 1 ].xq_Q14[       RDmin_ind ];
+            psSampleState[ 0 ].LF_AR_Q14[    RDmax_ind ] = psSampleState[ 1 ].LF_AR_Q14[    RDmin_ind ];
+            psSampleState[ 0 ].sLTP_shp_Q14[ RDmax_ind ] = psSampleState[ 1 ].sLTP_shp_Q14[ RDmin_ind ];
+            psSampleState[ 0 ].LPC_exc_Q14[  RDmax_ind ] = psSampleState[ 1 ].LPC_exc_Q14[  RDmin_ind ];
+        }
+
+        /* Write samples from winner to output and long-term filter states */
+        if( subfr > 0 || i >= decisionDelay ) {
+            pulses[  i - decisionDelay ] = (opus_int8)silk_RSHIFT_ROUND( psDelDec->Q_Q10[ last_smple_idx ][ Winner_ind ], 10 );
+            xq[ i - decisionDelay ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND(
+                silk_SMULWW( psDelDec->Xq_Q14[ last_smple_idx ][ Winner_ind ], delayedGain_Q10[ last_smple_idx ] ), 8 ) );
+            NSQ->sLTP_shp_Q14[ NSQ->sLTP_shp_buf_idx - decisionDelay ] = psDelDec->Shape_Q14[ last_smple_idx ][ Winner_ind ];
+            sLTP_Q15[          NSQ->sLTP_buf_idx     - decisionDelay ] = psDelDec->Pred_Q15[  last_smple_idx ][ Winner_ind ];
+        }
+        NSQ->sLTP_shp_buf_idx++;
+        NSQ->sLTP_buf_idx++;
+
+        /* Update states */
+        x = _mm_loadu_si128( (__m128i *)psSampleState[ 0 ].xq_Q14 );
+        _mm_storeu_si128( (__m128i *)psDelDec->LF_AR_Q14, _mm_loadu_si128( (__m128i *)psSampleState[ 0 ].LF_AR_Q14 ) );
+        _mm_storeu_si128( (__m128i *)psDelDec->sLPC_Q14[ NSQ_LPC_BUF_LENGTH + i ], x );
+        _mm_storeu_si128( (__m128i *)psDelDec->Xq_Q14[ *smpl_buf_idx ], x );
+        x = _mm_loadu_si128( (__m128i *)psSampleState[ 0 ].Q_Q10 );
+        _mm_storeu_si128( (__m128i *)psDelDec->Q_Q10[ *smpl_buf_idx ], x );
+        _mm_storeu_si128( (__m128i *)psDelDec->Pred_Q15[ *smpl_buf_idx ],
+            _mm_slli_epi32( _mm_loadu_si128( (__m128i *)psSampleState[ 0 ].LPC_exc_Q14 ), 1 ) );
+        _mm_storeu_si128( (__m128i *)psDelDec->Shape_Q14[ *smpl_buf_idx ], _mm_loadu_si128( (__m128i *)psSampleState[ 0 ].sLTP_shp_Q14 ) );
+        x = _mm_srai_epi32( _mm_add_epi32( _mm_srai_epi32( x, 9 ), _mm_set1_epi32( 1 ) ), 1 );
+        seed = _mm_add_epi32( _mm_loadu_si128( (__m128i *)psDelDec->Seed ), x );
+        _mm_storeu_si128( (__m128i *)psDelDec->Seed, seed );
+        _mm_storeu_si128( (__m128i *)psDelDec->RandState[ *smpl_buf_idx ], seed );
+        _mm_storeu_si128( (__m128i *)psDelDec->RD_Q10, _mm_loadu_si128( (__m128i *)psSampleState[ 0 ].RD_Q10 ) );
+        delayedGain_Q10[ *smpl_buf_idx ] = Gain_Q10;
+    }
+    /* Update LPC states */
+    silk_memcpy( psDelDec->sLPC_Q14, psDelDec->sLPC_Q14[ length ], NSQ_LPC_BUF_LENGTH * sizeof( psDelDec->sLPC_Q14[ 0 ] ) );
+}
+
+static OPUS_INLINE void silk_nsq_del_dec_scale_states_sse4_1(
+    const silk_encoder_state *psEncC,               /* I    Encoder State                       */
+    silk_nsq_state      *NSQ,                       /* I/O  NSQ state                           */
+    NSQ_del_decs_struct *psDelDec,                  /* I/O  Delayed decision states             */
+    const opus_int32    x_Q3[],                     /* I    Input in Q3                         */
+    opus_int32          x_sc_Q10[],                 /* O    Input scaled with 1/Gain in Q10     */
+    const opus_int16    sLTP[],                     /* I    Re-whitened LTP state in Q0         */
+    opus_int32          sLTP_Q15[],                 /* O    LTP state matching scaled input     */
+    opus_int            subfr,                      /* I    Subframe number                     */
+    const opus_int      LTP_scale_Q14,              /* I    LTP state scaling                   */
+    const opus_int32    Gains_Q16[ MAX_NB_SUBFR ],  /* I                                        */
+    const opus_int      pitchL[ MAX_NB_SUBFR ],     /* I    Pitch lag                           */
+    const opus_int      signal_type,                /* I    Signal type                         */
+    const opus_int      decisionDelay               /* I    Decision delay                      */
+)
+{
+    opus_int            i, lag;
+    opus_int32          gain_adj_Q16, inv_gain_Q31, inv_gain_Q23;
+    __m128i             gain;
+
+    lag          = pitchL[ subfr ];
+    inv_gain_Q31 = silk_INVERSE32_varQ( silk_max( Gains_Q16[ subfr ], 1 ), 47 );
+    silk_assert( inv_gain_Q31 != 0 );
+
+    /* Calculate gain adjustment factor */
+    if( Gains_Q16[ subfr ] != NSQ->prev_gain_Q16 ) {
+        gain_adj_Q16 =  silk_DIV32_varQ( NSQ->prev_gain_Q16, Gains_Q16[ subfr ], 16 );
+    } else {
+        gain_adj_Q16 = (opus_int32)1 << 16;
+    }
+
+    /* Scale input */
+    inv_gain_Q23 = silk_RSHIFT_ROUND( inv_gain_Q31, 8 );
+    gain = _mm_set1_epi32( inv_gain_Q23 );
+    for( i = 0; i < psEncC->subfr_length - 3; i += 4 ) {
+        _mm_storeu_si128( (__m128i *)&x_sc_Q10[ i ], silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)&x_Q3[ i ] ), gain ) );
+    }
+    for( ; i < psEncC->subfr_length; i++ ) {
+        x_sc_Q10[ i ] = silk_SMULWW( x_Q3[ i ], inv_gain_Q23 );
+    }
+
+    /* Save inverse gain */
+    NSQ->prev_gain_Q16 = Gains_Q16[ subfr ];
+
+    /* After rewhitening the LTP state is un-scaled, so scale with inv_gain_Q16 */
+    if( NSQ->rewhite_flag ) {
+        if( subfr == 0 ) {
+            /* Do LTP downscaling */
+            inv_gain_Q31 = silk_LSHIFT( silk_SMULWB( inv_gain_Q31, LTP_scale_Q14 ), 2 );
+        }
+        for( i = NSQ->sLTP_buf_idx - lag - LTP_ORDER / 2; i < NSQ->sLTP_buf_idx; i++ ) {
+            silk_assert( i < MAX_FRAME_LENGTH );
+            sLTP_Q15[ i ] = silk_SMULWB( inv_gain_Q31, sLTP[ i ] );
+        }
+    }
+
+    /* Adjust for changing gain */
+    if( gain_adj_Q16 != (opus_int32)1 << 16 ) {
+        gain = _mm_set1_epi32( gain_adj_Q16 );
+
+        /* Scale long-term shaping state */
+        for( i = NSQ->sLTP_shp_buf_idx - psEncC->ltp_mem_length; i < NSQ->sLTP_shp_buf_idx - 3; i += 4 ) {
+            _mm_storeu_si128( (__m128i *)&NSQ->sLTP_shp_Q14[ i ],
+                silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)&NSQ->sLTP_shp_Q14[ i ] ), gain ) );
+        }
+        for( ; i < NSQ->sLTP_shp_buf_idx; i++ ) {
+            NSQ->sLTP_shp_Q14[ i ] = silk_SMULWW( gain_adj_Q16, NSQ->sLTP_shp_Q14[ i ] );
+        }
+
+        /* Scale long-term prediction state */
+        if( signal_type == TYPE_VOICED && NSQ->rewhite_flag == 0 ) {
+            for( i = NSQ->sLTP_buf_idx - lag - LTP_ORDER / 2; i < NSQ->sLTP_buf_idx - decisionDelay; i++ ) {
+                sLTP_Q15[ i ] = silk_SMULWW( gain_adj_Q16, sLTP_Q15[ i ] );
+            }
+        }
+
+        /* Scale scalar states */
+        _mm_storeu_si128( (__m128i *)psDelDec->LF_AR_Q14,
+            silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)psDelDec->LF_AR_Q14 ), gain ) );
+
+        /* Scale short-term prediction and shaping states, all states at once */
+        for( i = 0; i < NSQ_LPC_BUF_LENGTH; i++ ) {
+            _mm_storeu_si128( (__m128i *)psDelDec->sLPC_Q14[ i ],
+                silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)psDelDec->sLPC_Q14[ i ] ), gain ) );
+        }
+        for( i = 0; i < MAX_SHAPE_LPC_ORDER; i++ ) {
+            _mm_storeu_si128( (__m128i *)psDelDec->sAR2_Q14[ i ],
+                silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)psDelDec->sAR2_Q14[ i ] ), gain ) );
+        }
+        for( i = 0; i < DECISION_DELAY; i++ ) {
+            _mm_storeu_si128( (__m128i *)psDelDec->Pred_Q15[ i ],
+                silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)psDelDec->Pred_Q15[ i ] ), gain ) );
+            _mm_storeu_si128( (__m128i *)psDelDec->Shape_Q14[ i ],
+                silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)psDelDec->Shape_Q14[ i ] ), gain ) );
+        }
+    }
+}
+
+#endif
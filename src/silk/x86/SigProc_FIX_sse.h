@@ -0,0 +1,77 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef SIGPROC_FIX_SSE_H
+#define SIGPROC_FIX_SSE_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_X86_MAY_HAVE_SSE4_1)
+
+#include <smmintrin.h>
+#include "SigProc_FIX.h"
+
+/* Four silk_SMULWW()s against the same 32-bit multiplier */
+static OPUS_INLINE __m128i silk_SMULWW_epi32( __m128i a, __m128i b )
+{
+    __m128i even, odd;
+    even = _mm_mul_epi32( a, b );
+    odd  = _mm_mul_epi32( _mm_shuffle_epi32( a, _MM_SHUFFLE( 3, 3, 1, 1 ) ), b );
+    return _mm_blend_epi16( _mm_srli_epi64( even, 16 ), _mm_slli_epi64( odd, 16 ), 0xCC );
+}
+
+/* The SSE4.1 filters compute silk_SMULWB( x, b ) as the upper word of the    */
+/* 64-bit product of x and b << 16, which is exact. _mm_mul_epi32() does this */
+/* for lanes 0 and 2, and summing the products with 32-bit adds keeps the     */
+/* sums of their upper words in lanes 1 and 3. Lanes 1 and 3 are accumulated  */
+/* in a second register from the input shifted down by one lane, and the two  */
+/* are recombined by silk_combine_epi32().                                    */
+static OPUS_INLINE __m128i silk_combine_epi32( __m128i acc_even, __m128i acc_odd )
+{
+    return _mm_blend_epi16( _mm_srli_epi64( acc_even, 32 ), acc_odd, 0xCC );
+}
+
+/* Four silk_SMULWB()s against the same multiplier, given as b << 16 */
+static OPUS_INLINE __m128i silk_SMULWB_epi32( __m128i a, __m128i b_Q16 )
+{
+    return silk_combine_epi32( _mm_mul_epi32( a, b_Q16 ), _mm_mul_epi32( _mm_srli_epi64( a, 32 ), b_Q16 ) );
+}
+
+/* silk_LPC_analysis_filter() with the inner products done by _mm_madd_epi16() */
+void silk_LPC_analysis_filter_sse4_1(
+    opus_int16                  *out,               /* O    Output signal                                               */
+    const opus_int16            *in,                /* I    Input signal                                                */
+    const opus_int16            *B,                 /* I    MA prediction coefficients, Q12 [order]                     */
+    const opus_int32            len,                /* I    Signal length                                               */
+    const opus_int32            d                   /* I    Filter order                                                */
+);
+
+#endif
+
+#endif
@@ -0,0 +1,326 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#if defined(OPUS_X86_MAY_HAVE_SSE4_1)
+
+#include <smmintrin.h>
+#include "main.h"
+#include "stack_alloc.h"
+#include "SigProc_FIX_sse.h"
+
+/**********************************************************/
+/* Core decoder. Performs inverse NSQ operation LTP + LPC */
+/**********************************************************/
+/* Same as silk_decode_core_c(), but filtering four output samples at a time. */
+/* The LTP filter only reads samples at least one pitch lag back, so a block  */
+/* is computed entirely in vector lanes. The LPC synthesis filter sums the    */
+/* taps reaching back before the block in vector lanes and adds the few taps  */
+/* within the block sample by sample. Integer sums do not depend on their     */
+/* order, so the output is bit-exact with the C version. The same holds for   */
+/* the re-whitening filter.                                                   */
+void silk_decode_core_sse4_1(
+    silk_decoder_state          *psDec,                         /* I/O  Decoder state                               */
+    silk_decoder_control        *psDecCtrl,                     /* I    Decoder control                             */
+    opus_int16                  xq[],                           /* O    Decoded speech                              */
+    const opus_int              pulses[ MAX_FRAME_LENGTH ]      /* I    Pulse signal                                */
+)
+{
+    opus_int   i, j, k, lag = 0, start_idx, sLTP_buf_idx, NLSF_interpolation_flag, signalType;
+    opus_int16 *A_Q12, *B_Q14, *pxq;
+    VARDECL( opus_int16, sLTP );
+    VARDECL( opus_int32, sLTP_Q15 );
+    opus_int32 LTP_pred_Q13, LPC_pred_Q10, Gain_Q10, inv_gain_Q31, gain_adj_Q16, rand_seed, offset_Q10;
+    opus_int32 *pred_lag_ptr, *pexc_Q14, *pres_Q14, *psLPC_Q14, pred_Q10[ 4 ], s_Q14[ 4 ];
+    VARDECL( opus_int32, res_Q14 );
+    VARDECL( opus_int32, sLPC_Q14 );
+    __m128i A_Q28[ MAX_LPC_ORDER ], B_Q30[ LTP_ORDER ];
+    __m128i acc_even, acc_odd, tmp, cur, prev;
+    SAVE_STACK;
+
+    silk_assert( psDec->prev_gain_Q16 != 0 );
+
+    ALLOC( sLTP, psDec->ltp_mem_length, opus_int16 );
+    ALLOC( sLTP_Q15, psDec->ltp_mem_length + psDec->frame_length, opus_int32 );
+    ALLOC( res_Q14, psDec->subfr_length, opus_int32 );
+    ALLOC( sLPC_Q14, psDec->subfr_length + MAX_LPC_ORDER, opus_int32 );
+
+    offset_Q10 = silk_Quantization_Offsets_Q10[ psDec->indices.signalType >> 1 ][ psDec->indices.quantOffsetType ];
+
+    if( psDec->indices.NLSFInterpCoef_Q2 < 1 << 2 ) {
+        NLSF_interpolation_flag = 1;
+    } else {
+        NLSF_interpolation_flag = 0;
+    }
+
+    /* Decode excitation */
+    rand_seed = psDec->indices.Seed;
+    for( i = 0; i < psDec->frame_length; i++ ) {
+        rand_seed = silk_RAND( rand_seed );
+        psDec->exc_Q14[ i ] = silk_LSHIFT( (opus_int32)pulses[ i ], 14 );
+        if( psDec->exc_Q14[ i ] > 0 ) {
+            psDec->exc_Q14[ i ] -= QUANT_LEVEL_ADJUST_Q10 << 4;
+        } else
+        if( psDec->exc_Q14[ i ] < 0 ) {
+            psDec->exc_Q14[ i ] += QUANT_LEVEL_ADJUST_Q10 << 4;
+        }
+        psDec->exc_Q14[ i ] += offset_Q10 << 4;
+        if( rand_seed < 0 ) {
+           psDec->exc_Q14[ i ] = -psDec->exc_Q14[ i ];
+        }
+
+        rand_seed = silk_ADD32_ovflw( rand_seed, pulses[ i ] );
+    }
+
+    /* Copy LPC state */
+    silk_memcpy( sLPC_Q14, psDec->sLPC_Q14_buf, MAX_LPC_ORDER * sizeof( opus_int32 ) );
+
+    pexc_Q14 = psDec->exc_Q14;
+    pxq      = xq;
+    sLTP_buf_idx = psDec->ltp_mem_length;
+    /* Loop over subframes */
+    for( k = 0; k < psDec->nb_subfr; k++ ) {
+        pres_Q14 = res_Q14;
+        A_Q12 = psDecCtrl->PredCoef_Q12[ k >> 1 ];
+
+        for( j = 0; j < psDec->LPC_order; j++ ) {
+            A_Q28[ j ] = _mm_set1_epi32( silk_LSHIFT32( (opus_int32)A_Q12[ j ], 16 ) );
+        }
+        B_Q14        = &psDecCtrl->LTPCoef_Q14[ k * LTP_ORDER ];
+        signalType   = psDec->indices.signalType;
+
+        Gain_Q10     = silk_RSHIFT( psDecCtrl->Gains_Q16[ k ], 6 );
+        inv_gain_Q31 = silk_INVERSE32_varQ( psDecCtrl->Gains_Q16[ k ], 47 );
+
+        /* Calculate gain adjustment factor */
+        if( psDecCtrl->Gains_Q16[ k ] != psDec->prev_gain_Q16 ) {
+            gain_adj_Q16 =  silk_DIV32_varQ( psDec->prev_gain_Q16, psDecCtrl->Gains_Q16[ k ], 16 );
+
+            /* Scale short term state */
+            for( i = 0; i < MAX_LPC_ORDER; i++ ) {
+                sLPC_Q14[ i ] = silk_SMULWW( gain_adj_Q16, sLPC_Q14[ i ] );
+            }
+        } else {
+            gain_adj_Q16 = (opus_int32)1 << 16;
+        }
+
+        /* Save inv_gain */
+        silk_assert( inv_gain_Q31 != 0 );
+        psDec->prev_gain_Q16 = psDecCtrl->Gains_Q16[ k ];
+
+        /* Avoid abrupt transition from voiced PLC to unvoiced normal decoding */
+        if( psDec->lossCnt && psDec->prevSignalType == TYPE_VOICED &&
+            psDec->indices.signalType != TYPE_VOICED && k < MAX_NB_SUBFR/2 ) {
+
+            silk_memset( B_Q14, 0, LTP_ORDER * sizeof( opus_int16 ) );
+            B_Q14[ LTP_ORDER/2 ] = SILK_FIX_CONST( 0.25, 14 );
+
+            signalType = TYPE_VOICED;
+            psDecCtrl->pitchL[ k ] = psDec->lagPrev;
+        }
+
+        if( signalType == TYPE_VOICED ) {
+            /* Voiced */
+            lag = psDecCtrl->pitchL[ k ];
+
+            /* Re-whitening */
+            if( k == 0 || ( k == 2 && NLSF_interpolation_flag ) ) {
+                /* Rewhiten with new A coefs */
+                start_idx = psDec->ltp_mem_length - lag - psDec->LPC_order - LTP_ORDER / 2;
+                silk_assert( start_idx > 0 );
+
+                if( k == 2 ) {
+                    silk_memcpy( &psDec->outBuf[ psDec->ltp_mem_length ], xq, 2 * psDec->subfr_length * sizeof( opus_int16 ) );
+                }
+
+                silk_LPC_analysis_filter_sse4_1( &sLTP[ start_idx ], &psDec->outBuf[ start_idx + k * psDec->subfr_length ],
+                    A_Q12, psDec->ltp_mem_length - start_idx, psDec->LPC_order );
+
+                /* After rewhitening the LTP state is unscaled */
+                if( k == 0 ) {
+                    /* Do LTP downscaling to reduce inter-packet dependency */
+                    inv_gain_Q31 = silk_LSHIFT( silk_SMULWB( inv_gain_Q31, psDecCtrl->LTP_scale_Q14 ), 2 );
+                }
+                for( i = 0; i < lag + LTP_ORDER/2; i++ ) {
+                    sLTP_Q15[ sLTP_buf_idx - i - 1 ] = silk_SMULWB( inv_gain_Q31, sLTP[ psDec->ltp_mem_length - i - 1 ] );
+                }
+            } else {
+                /* Update LTP state when Gain changes */
+                if( gain_adj_Q16 != (opus_int32)1 << 16 ) {
+                    for( i = 0; i < lag + LTP_ORDER/2; i++ ) {
+                        sLTP_Q15[ sLTP_buf_idx - i - 1 ] = silk_SMULWW( gain_adj_Q16, sLTP_Q15[ sLTP_buf_idx - i - 1 ] );
+                    }
+                }
+            }
+        }
+
+        /* Long-term prediction */
+        if( signalType == TYPE_VOICED ) {
+            /* Set up pointer */
+            pred_lag_ptr = &sLTP_Q15[ sLTP_buf_idx - lag + LTP_ORDER / 2 ];
+            i = 0;
+            /* A block of four samples only reads LTP state written before the block */
+            if( lag > LTP_ORDER / 2 + 3 ) {
+                for( j = 0; j < LTP_ORDER; j++ ) {
+                    B_Q30[ j ] = _mm_set1_epi32( silk_LSHIFT32( (opus_int32)B_Q14[ j ], 16 ) );
+                }
+                for( ; i < psDec->subfr_length - 3; i += 4 ) {
+                    acc_even = _mm_setzero_si128();
+                    acc_odd  = _mm_setzero_si128();
+                    for( j = 0; j < LTP_ORDER; j++ ) {
+                        acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( _mm_loadu_si128( (__m128i *)&pred_lag_ptr[ i - j     ] ), B_Q30[ j ] ) );
+                        acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( _mm_loadu_si128( (__m128i *)&pred_lag_ptr[ i - j + 1 ] ), B_Q30[ j ] ) );
+                    }
+                    /* Avoids introducing a bias because silk_SMLAWB() always rounds to -inf */
+                    tmp = _mm_add_epi32( silk_combine_epi32( acc_even, acc_odd ), _mm_set1_epi32( 2 ) );
+
+                    /* Generate LPC excitation */
+                    tmp = _mm_add_epi32( _mm_loadu_si128( (__m128i *)&pexc_Q14[ i ] ), _mm_slli_epi32( tmp, 1 ) );
+                    _mm_storeu_si128( (__m128i *)&pres_Q14[ i ], tmp );
+
+                    /* Update states */
+                    _mm_storeu_si128( (__m128i *)&sLTP_Q15[ sLTP_buf_idx ], _mm_slli_epi32( tmp, 1 ) );
+                    sLTP_buf_idx += 4;
+                }
+            }
+            for( ; i < psDec->subfr_length; i++ ) {
+                /* Avoids introducing a bias because silk_SMLAWB() always rounds to -inf */
+                LTP_pred_Q13 = 2;
+                LTP_pred_Q13 = silk_SMLAWB( LTP_pred_Q13, pred_lag_ptr[ i     ], B_Q14[ 0 ] );
+                LTP_pred_Q13 = silk_SMLAWB( LTP_pred_Q13, pred_lag_ptr[ i - 1 ], B_Q14[ 1 ] );
+                LTP_pred_Q13 = silk_SMLAWB( LTP_pred_Q13, pred_lag_ptr[ i - 2 ], B_Q14[ 2 ] );
+                LTP_pred_Q13 = silk_SMLAWB( LTP_pred_Q13, pred_lag_ptr[ i - 3 ], B_Q14[ 3 ] );
+                LTP_pred_Q13 = silk_SMLAWB( LTP_pred_Q13, pred_lag_ptr[ i - 4 ], B_Q14[ 4 ] );
+
+                /* Generate LPC excitation */
+                pres_Q14[ i ] = silk_ADD_LSHIFT32( pexc_Q14[ i ], LTP_pred_Q13, 1 );
+
+                /* Update states */
+                sLTP_Q15[ sLTP_buf_idx ] = silk_LSHIFT( pres_Q14[ i ], 1 );
+                sLTP_buf_idx++;
+            }
+        } else {
+            pres_Q14 = pexc_Q14;
+        }
+
+        /* Short-term prediction */
+        silk_assert( psDec->LPC_order == 10 || psDec->LPC_order == 16 );
+        /* The last two blocks are kept in registers, the filter state included */
+        prev = _mm_loadu_si128( (__m128i *)&sLPC_Q14[ MAX_LPC_ORDER - 8 ] );
+        cur  = _mm_loadu_si128( (__m128i *)&sLPC_Q14[ MAX_LPC_ORDER - 4 ] );
+        for( i = 0; i < psDec->subfr_length - 3; i += 4 ) {
+            psLPC_Q14 = &sLPC_Q14[ MAX_LPC_ORDER + i ];
+
+            /* Taps reaching back before the block. The input advanced by m     */
+            /* samples, psLPC_Q14[ -m .. 3 - m ] with the samples of the block  */
+            /* still to be computed set to zero, goes to tap m - 1 for outputs  */
+            /* 0 and 2 and to tap m for outputs 1 and 3.                        */
+            tmp      = _mm_srli_si128( cur, 12 );
+            acc_even = _mm_mul_epi32( tmp, A_Q28[ 0 ] );
+            acc_odd  = _mm_mul_epi32( tmp, A_Q28[ 1 ] );
+            tmp      = _mm_srli_si128( cur, 8 );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp, A_Q28[ 1 ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( tmp, A_Q28[ 2 ] ) );
+            tmp      = _mm_srli_si128( cur, 4 );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp, A_Q28[ 2 ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( tmp, A_Q28[ 3 ] ) );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( cur, A_Q28[ 3 ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( cur, A_Q28[ 4 ] ) );
+            tmp      = _mm_alignr_epi8( cur, prev, 12 );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp, A_Q28[ 4 ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( tmp, A_Q28[ 5 ] ) );
+            tmp      = _mm_alignr_epi8( cur, prev, 8 );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp, A_Q28[ 5 ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( tmp, A_Q28[ 6 ] ) );
+            tmp      = _mm_alignr_epi8( cur, prev, 4 );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp, A_Q28[ 6 ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( tmp, A_Q28[ 7 ] ) );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( prev, A_Q28[ 7 ] ) );
+            acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( prev, A_Q28[ 8 ] ) );
+            for( j = 9; j < psDec->LPC_order; j++ ) {
+                tmp      = _mm_loadu_si128( (__m128i *)&psLPC_Q14[ -j ] );
+                acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp, A_Q28[ j - 1 ] ) );
+                acc_odd  = _mm_add_epi32( acc_odd,  _mm_mul_epi32( tmp, A_Q28[ j ] ) );
+            }
+            tmp      = _mm_loadu_si128( (__m128i *)&psLPC_Q14[ -j ] );
+            acc_even = _mm_add_epi32( acc_even, _mm_mul_epi32( tmp, A_Q28[ j - 1 ] ) );
+
+            /* Avoids introducing a bias because silk_SMLAWB() always rounds to -inf */
+            tmp = _mm_add_epi32( silk_combine_epi32( acc_even, acc_odd ), _mm_set1_epi32( silk_RSHIFT( psDec->LPC_order, 1 ) ) );
+            _mm_storeu_si128( (__m128i *)pred_Q10, tmp );
+
+            /* Taps within the block, and addition of the prediction to the LPC excitation */
+            s_Q14[ 0 ] = silk_ADD_LSHIFT32( pres_Q14[ i ], pred_Q10[ 0 ], 4 );
+            pred_Q10[ 1 ] = silk_SMLAWB( pred_Q10[ 1 ], s_Q14[ 0 ], A_Q12[ 0 ] );
+            s_Q14[ 1 ] = silk_ADD_LSHIFT32( pres_Q14[ i + 1 ], pred_Q10[ 1 ], 4 );
+            pred_Q10[ 2 ] = silk_SMLAWB( pred_Q10[ 2 ], s_Q14[ 1 ], A_Q12[ 0 ] );
+            pred_Q10[ 2 ] = silk_SMLAWB( pred_Q10[ 2 ], s_Q14[ 0 ], A_Q12[ 1 ] );
+            s_Q14[ 2 ] = silk_ADD_LSHIFT32( pres_Q14[ i + 2 ], pred_Q10[ 2 ], 4 );
+            pred_Q10[ 3 ] = silk_SMLAWB( pred_Q10[ 3 ], s_Q14[ 2 ], A_Q12[ 0 ] );
+            pred_Q10[ 3 ] = silk_SMLAWB( pred_Q10[ 3 ], s_Q14[ 1 ], A_Q12[ 1 ] );
+            pred_Q10[ 3 ] = silk_SMLAWB( pred_Q10[ 3 ], s_Q14[ 0 ], A_Q12[ 2 ] );
+            s_Q14[ 3 ] = silk_ADD_LSHIFT32( pres_Q14[ i + 3 ], pred_Q10[ 3 ], 4 );
+
+            prev = cur;
+            cur  = _mm_loadu_si128( (__m128i *)s_Q14 );
+            _mm_storeu_si128( (__m128i *)psLPC_Q14, cur );
+        }
+        for( ; i < psDec->subfr_length; i++ ) {
+            LPC_pred_Q10 = silk_RSHIFT( psDec->LPC_order, 1 );
+            for( j = 0; j < psDec->LPC_order; j++ ) {
+                LPC_pred_Q10 = silk_SMLAWB( LPC_pred_Q10, sLPC_Q14[ MAX_LPC_ORDER + i - j - 1 ], A_Q12[ j ] );
+            }
+            sLPC_Q14[ MAX_LPC_ORDER + i ] = silk_ADD_LSHIFT32( pres_Q14[ i ], LPC_pred_Q10, 4 );
+        }
+
+        /* Scale with gain */
+        tmp = _mm_set1_epi32( Gain_Q10 );
+        for( i = 0; i < psDec->subfr_length - 3; i += 4 ) {
+            cur = silk_SMULWW_epi32( _mm_loadu_si128( (__m128i *)&sLPC_Q14[ MAX_LPC_ORDER + i ] ), tmp );
+            /* silk_RSHIFT_ROUND( x, 8 ) */
+            cur = _mm_srai_epi32( _mm_add_epi32( _mm_srai_epi32( cur, 7 ), _mm_set1_epi32( 1 ) ), 1 );
+            _mm_storel_epi64( (__m128i *)&pxq[ i ], _mm_packs_epi32( cur, cur ) );
+        }
+        for( ; i < psDec->subfr_length; i++ ) {
+            pxq[ i ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND( silk_SMULWW( sLPC_Q14[ MAX_LPC_ORDER + i ], Gain_Q10 ), 8 ) );
+        }
+
+        /* Update LPC filter state */
+        silk_memcpy( sLPC_Q14, &sLPC_Q14[ psDec->subfr_length ], MAX_LPC_ORDER * sizeof( opus_int32 ) );
+        pexc_Q14 += psDec->subfr_length;
+        pxq      += psDec->subfr_length;
+    }
+
+    /* Save LPC state */
+    silk_memcpy( psDec->sLPC_Q14_buf, sLPC_Q14, MAX_LPC_ORDER * sizeof( opus_int32 ) );
+    RESTORE_STACK;
+}
+
+#endif
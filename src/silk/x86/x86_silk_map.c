@@ -0,0 +1,98 @@
+/* Copyright (c) 2016 opus-winrt contributors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "main.h"
+
+#if defined(OPUS_HAVE_RTCD) && \
+  (defined(OPUS_X86_MAY_HAVE_SSE4_1) && !defined(OPUS_X86_PRESUME_SSE4_1))
+
+void (*const SILK_DECODE_CORE_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    silk_decoder_state          *psDec,
+    silk_decoder_control        *psDecCtrl,
+    opus_int16                  xq[],
+    const opus_int              pulses[ MAX_FRAME_LENGTH ]
+) = {
+  silk_decode_core_c,                  /* non-sse */
+  silk_decode_core_c,
+  silk_decode_core_c,
+  MAY_HAVE_SSE4_1( silk_decode_core ), /* sse4.1 */
+  MAY_HAVE_SSE4_1( silk_decode_core ), /* avx2 */
+};
+
+void (*const SILK_NSQ_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_encoder_state    *psEncC,
+    silk_nsq_state              *NSQ,
+    SideInfoIndices             *psIndices,
+    const opus_int32            x_Q3[],
+    opus_int8                   pulses[],
+    const opus_int16            PredCoef_Q12[ 2 * MAX_LPC_ORDER ],
+    const opus_int16            LTPCoef_Q14[ LTP_ORDER * MAX_NB_SUBFR ],
+    const opus_int16            AR2_Q13[ MAX_NB_SUBFR * MAX_SHAPE_LPC_ORDER ],
+    const opus_int              HarmShapeGain_Q14[ MAX_NB_SUBFR ],
+    const opus_int              Tilt_Q14[ MAX_NB_SUBFR ],
+    const opus_int32            LF_shp_Q14[ MAX_NB_SUBFR ],
+    const opus_int32            Gains_Q16[ MAX_NB_SUBFR ],
+    const opus_int              pitchL[ MAX_NB_SUBFR ],
+    const opus_int              Lambda_Q10,
+    const opus_int              LTP_scale_Q14
+) = {
+  silk_NSQ_c,                          /* non-sse */
+  silk_NSQ_c,
+  silk_NSQ_c,
+  MAY_HAVE_SSE4_1( silk_NSQ ),         /* sse4.1 */
+  MAY_HAVE_SSE4_1( silk_NSQ ),         /* avx2 */
+};
+
+void (*const SILK_NSQ_DEL_DEC_IMPL[ OPUS_ARCHMASK + 1 ] )(
+    const silk_encoder_state    *psEncC,
+    silk_nsq_state              *NSQ,
+    SideInfoIndices             *psIndices,
+    const opus_int32            x_Q3[],
+    opus_int8                   pulses[],
+    const opus_int16            PredCoef_Q12[ 2 * MAX_LPC_ORDER ],
+    const opus_int16            LTPCoef_Q14[ LTP_ORDER * MAX_NB_SUBFR ],
+    const opus_int16            AR2_Q13[ MAX_NB_SUBFR * MAX_SHAPE_LPC_ORDER ],
+    const opus_int              HarmShapeGain_Q14[ MAX_NB_SUBFR ],
+    const opus_int              Tilt_Q14[ MAX_NB_SUBFR ],
+    const opus_int32            LF_shp_Q14[ MAX_NB_SUBFR ],
+    const opus_int32            Gains_Q16[ MAX_NB_SUBFR ],
+    const opus_int              pitchL[ MAX_NB_SUBFR ],
+    const opus_int              Lambda_Q10,
+    const opus_int              LTP_scale_Q14
+) = {
+  silk_NSQ_del_dec_c,                  /* non-sse */
+  silk_NSQ_del_dec_c,
+  silk_NSQ_del_dec_c,
+  MAY_HAVE_SSE4_1( silk_NSQ_del_dec ), /* sse4.1 */
+  MAY_HAVE_SSE4_1( silk_NSQ_del_dec ), /* avx2 */
+};
+
+#endif